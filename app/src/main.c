@@ -1,13 +1,29 @@
 #include "waitui/version.h"
 
 #include <waitui/log.h>
+#include <waitui/log_async.h>
+#include <waitui/ast_binary.h>
+#include <waitui/ast_optimizer.h>
 #include <waitui/ast_printer.h>
+#include <waitui/build_cache.h>
+#include <waitui/module_cache.h>
 #include <waitui/parser.h>
 #include <waitui/str.h>
+#include <waitui/threadpool.h>
+#include <waitui/type_checker.h>
+#include <waitui/vm.h>
+#include <waitui/vm_natives.h>
 
+#include <dirent.h>
 #include <getopt.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 
 // -----------------------------------------------------------------------------
@@ -18,54 +34,485 @@
 #define WAITUI_FAILURE 1
 #define WAITUI_OTHER_ERROR 2
 
+/**
+ * @brief The extension of the source files collected from directories.
+ */
+#define WAITUI_SOURCE_EXTENSION ".wai"
+
+/**
+ * @brief The maximal number of search paths for imported modules.
+ */
+#define WAITUI_MAX_SEARCH_PATHS 64
+
+/**
+ * @brief The number of log records the asynchronous log can hold.
+ */
+#define WAITUI_LOG_ASYNC_CAPACITY 4096
+
 
 // -----------------------------------------------------------------------------
-//  Local variables
+//  Local types
 // -----------------------------------------------------------------------------
 
-static str sourceFileName   = STR_STATIC_INIT("stdin");
-static str currentDirectory = STR_NULL_INIT;
-static str graphFileName    = STR_NULL_INIT;
-static int parserDebug      = PARSER_DEBUG_NONE;
+/**
+ * @brief Type for one input file compiled by a worker.
+ * @note The diagnostics are collected per job and written in input order once
+ *       all jobs are done, so the output does not depend on the scheduling.
+ */
+typedef struct waitui_job {
+    str sourceFileName;
+    int result;
+    char *diagnostics;
+    size_t diagnosticsLength;
+} waitui_job;
+
+/**
+ * @brief Type for the canonical paths of the modules a source file depends on.
+ * @note The paths are owned by the Module cache.
+ */
+typedef struct waitui_dependencies {
+    str *paths;
+    unsigned long int length;
+    unsigned long int capacity;
+} waitui_dependencies;
+
+/**
+ * @brief Type for all input files of a run.
+ */
+typedef struct waitui_jobs {
+    waitui_job *jobs;
+    unsigned long int length;
+    unsigned long int capacity;
+} waitui_jobs;
 
 
 // -----------------------------------------------------------------------------
-//  Local functions
+//  Local variables
 // -----------------------------------------------------------------------------
 
+static str sourceStdin                          = STR_STATIC_INIT("stdin");
+static str currentDirectory                     = STR_NULL_INIT;
+static int parserDebug                          = PARSER_DEBUG_NONE;
+static str searchPaths[WAITUI_MAX_SEARCH_PATHS] = {0};
+static unsigned long int searchPathCount        = 0;
+static parser_module_cache *moduleCache         = NULL;
+static bool writeBinary                         = false;
+static bool optimize                            = false;
+static bool typeCheck                           = false;
+static waitui_build_cache *buildCache           = NULL;
+static waitui_threadpool *printerThreadpool     = NULL;
+static pthread_mutex_t printerMutex             = PTHREAD_MUTEX_INITIALIZER;
+static str runClassName                         = STR_NULL_INIT;
+static str runFunctionName                      = STR_NULL_INIT;
+
 
 // -----------------------------------------------------------------------------
-//  Main function
+//  Local functions
 // -----------------------------------------------------------------------------
 
-int main(int argc, char **argv) {
-    int result = WAITUI_SUCCESS;
+/**
+ * @brief The locking callback serializing the log of the workers.
+ * @param[in] lock Whether to lock or unlock
+ * @param[in,out] userData The mutex to lock
+ */
+static void waitui_log_mutex(bool lock, void *userData) {
+    if (lock) {
+        pthread_mutex_lock(userData);
+    } else {
+        pthread_mutex_unlock(userData);
+    }
+}
 
-    parser *waituiParser = NULL;
-    waitui_ast *waituiAst       = NULL;
-    FILE *graphFile      = NULL;
+/**
+ * @brief Add a job for the source file.
+ * @param[in,out] this The jobs to add to
+ * @param[in] sourceFileName The source file of the job
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ */
+static int waitui_jobs_add(waitui_jobs *this, const char *sourceFileName) {
+    waitui_job *job = NULL;
 
-    if (argc == 2) {
-        sourceFileName.len = strlen(argv[1]);
-        sourceFileName.s   = argv[1];
+    if (this->length == this->capacity) {
+        unsigned long int capacity = this->capacity ? this->capacity * 2 : 16;
+        waitui_job *jobs = realloc(this->jobs, capacity * sizeof(*jobs));
+        if (!jobs) { return 0; }
+
+        this->jobs     = jobs;
+        this->capacity = capacity;
     }
 
-    waitui_log_setLevel(WAITUI_LOG_DEBUG);
-    waitui_log_setQuiet(false);
+    job = &this->jobs[this->length];
+    memset(job, 0, sizeof(*job));
 
-    parserDebug = PARSER_DEBUG_NONE | PARSER_DEBUG_LEXER | PARSER_DEBUG_PARSER;
+    job->sourceFileName.len = strlen(sourceFileName);
+    job->sourceFileName.s   = strdup(sourceFileName);
+    if (!job->sourceFileName.s) { return 0; }
 
-    waitui_log_debug("waitui start execution");
+    this->length++;
+
+    return 1;
+}
+
+/**
+ * @brief Compare two directory entries by name for qsort.
+ * @param[in] a The first directory entry
+ * @param[in] b The second directory entry
+ * @return The order of the names
+ */
+static int waitui_jobs_compareNames(const void *a, const void *b) {
+    return strcmp(*(char *const *) a, *(char *const *) b);
+}
+
+/**
+ * @brief Add a job for every source file in the directory and below.
+ * @param[in,out] this The jobs to add to
+ * @param[in] directoryName The directory to search
+ * @retval 1 Ok
+ * @retval 0 Reading the directory or memory allocation failed
+ * @note The entries are sorted by name, so the jobs are always in the same
+ *       order.
+ */
+static int waitui_jobs_addDirectory(waitui_jobs *this,
+                                    const char *directoryName) {
+    DIR *directory             = NULL;
+    struct dirent *entry       = NULL;
+    char **names               = NULL;
+    unsigned long int length   = 0;
+    unsigned long int capacity = 0;
+    size_t directoryNameLength = strlen(directoryName);
+    int result                 = 1;
+
+    directory = opendir(directoryName);
+    if (!directory) {
+        waitui_log_error("could not open directory: '%s'", directoryName);
+        return 0;
+    }
+
+    while ((entry = readdir(directory))) {
+        char *name = NULL;
+
+        if (strcmp(entry->d_name, ".") == 0 ||
+            strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+
+        if (length == capacity) {
+            unsigned long int newCapacity = capacity ? capacity * 2 : 16;
+            char **newNames = realloc(names, newCapacity * sizeof(*names));
+            if (!newNames) {
+                result = 0;
+                break;
+            }
+            names    = newNames;
+            capacity = newCapacity;
+        }
+
+        name = malloc(directoryNameLength + strlen(entry->d_name) + 2);
+        if (!name) {
+            result = 0;
+            break;
+        }
+        sprintf(name, "%s/%s", directoryName, entry->d_name);
+        names[length++] = name;
+    }
+    closedir(directory);
+
+    if (result) {
+        qsort(names, length, sizeof(*names), waitui_jobs_compareNames);
+    }
+
+    for (unsigned long int i = 0; result && i < length; ++i) {
+        struct stat entryStat;
+        size_t nameLength = strlen(names[i]);
+
+        if (stat(names[i], &entryStat) != 0) { continue; }
+
+        if (S_ISDIR(entryStat.st_mode)) {
+            result = waitui_jobs_addDirectory(this, names[i]);
+        } else if (S_ISREG(entryStat.st_mode) &&
+                   nameLength > sizeof(WAITUI_SOURCE_EXTENSION) - 1 &&
+                   strcmp(names[i] + nameLength -
+                                  (sizeof(WAITUI_SOURCE_EXTENSION) - 1),
+                          WAITUI_SOURCE_EXTENSION) == 0) {
+            result = waitui_jobs_add(this, names[i]);
+        }
+    }
+
+    for (unsigned long int i = 0; i < length; ++i) { free(names[i]); }
+    free(names);
+
+    return result;
+}
+
+/**
+ * @brief Add a job for the input, directories are searched for source files.
+ * @param[in,out] this The jobs to add to
+ * @param[in] input The file or directory given on the command line
+ * @retval 1 Ok
+ * @retval 0 Reading the directory or memory allocation failed
+ */
+static int waitui_jobs_addInput(waitui_jobs *this, const char *input) {
+    struct stat inputStat;
+
+    if (stat(input, &inputStat) == 0 && S_ISDIR(inputStat.st_mode)) {
+        return waitui_jobs_addDirectory(this, input);
+    }
+
+    return waitui_jobs_add(this, input);
+}
+
+/**
+ * @brief Release the jobs and their diagnostics.
+ * @param[in,out] this The jobs to release
+ */
+static void waitui_jobs_destroy(waitui_jobs *this) {
+    for (unsigned long int i = 0; i < this->length; ++i) {
+        free(this->jobs[i].sourceFileName.s);
+        free(this->jobs[i].diagnostics);
+    }
+    free(this->jobs);
+}
+
+/**
+ * @brief Add the module to the dependencies, called by the Module cache.
+ * @param[in,out] args The dependencies to add to
+ * @param[in] canonicalPath The canonical path of the module
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ */
+static int waitui_dependencies_add(void *args, str canonicalPath) {
+    waitui_dependencies *this = args;
+
+    if (this->length == this->capacity) {
+        unsigned long int capacity = this->capacity ? this->capacity * 2 : 16;
+        str *paths = realloc(this->paths, capacity * sizeof(*paths));
+        if (!paths) { return 0; }
+
+        this->paths    = paths;
+        this->capacity = capacity;
+    }
+
+    this->paths[this->length++] = canonicalPath;
+
+    return 1;
+}
+
+/**
+ * @brief Write the output into the file named after the source file.
+ * @param[in] sourceFileName The source file the output belongs to
+ * @param[in] extension The extension appended to the source file name
+ * @param[in] output The content of the output file
+ * @param[in] diagnostics The file to write the errors to
+ * @retval 1 Ok
+ * @retval 0 The output file could not be written
+ */
+static int waitui_compile_writeOutput(str sourceFileName, const char *extension,
+                                      str output, FILE *diagnostics) {
+    str outputFileName = STR_NULL_INIT;
+    FILE *outputFile   = NULL;
+    int result         = 1;
+
+    outputFileName.len = sourceFileName.len + strlen(extension) + 1;
+    outputFileName.s   = calloc(outputFileName.len, sizeof(*outputFileName.s));
+    if (!outputFileName.s) { return 0; }
+    memcpy(outputFileName.s, sourceFileName.s, sourceFileName.len);
+    snprintf(outputFileName.s + sourceFileName.len,
+             outputFileName.len - sourceFileName.len, "%s", extension);
+
+    outputFile = fopen(outputFileName.s, "wb");
+    if (!outputFile) {
+        fprintf(diagnostics, "could not open '%s'\n", outputFileName.s);
+        free(outputFileName.s);
+        return 0;
+    }
+
+    if (output.len > 0 &&
+        fwrite(output.s, 1, output.len, outputFile) != output.len) {
+        result = 0;
+    }
+    if (fclose(outputFile) != 0) { result = 0; }
+
+    if (!result) {
+        fprintf(diagnostics, "could not write '%s'\n", outputFileName.s);
+    }
+    free(outputFileName.s);
+
+    return result;
+}
+
+/**
+ * @brief Write the graph file and, if asked for, the binary AST file.
+ * @param[in] sourceFileName The source file the outputs belong to
+ * @param[in] outputs The outputs of the source file
+ * @param[in] diagnostics The file to write the errors to
+ * @return The exit code for the source file
+ */
+static int waitui_compile_writeOutputs(str sourceFileName,
+                                       const waitui_build_cache_entry *outputs,
+                                       FILE *diagnostics) {
+    if (!waitui_compile_writeOutput(sourceFileName, ".dot", outputs->graph,
+                                    diagnostics)) {
+        return WAITUI_OTHER_ERROR;
+    }
+
+    if (writeBinary && !waitui_compile_writeOutput(sourceFileName, ".wast",
+                                                   outputs->binary,
+                                                   diagnostics)) {
+        return WAITUI_OTHER_ERROR;
+    }
+
+    return WAITUI_SUCCESS;
+}
+
+/**
+ * @brief The native function Console.log, print the value on its own line.
+ * @param[in,out] vm The VM executing the native function
+ * @param[in,out] registers This followed by the value to print
+ * @retval 1 Always
+ */
+static int waitui_native_consoleLog(waitui_vm *vm, waitui_vm_value *registers) {
+    (void) vm;
+
+    flockfile(stdout);
+    waitui_vm_value_print(&registers[1], stdout);
+    fputc('\n', stdout);
+    funlockfile(stdout);
+
+    registers[0].type = WAITUI_VM_VALUE_TYPE_NULL;
+
+    return 1;
+}
+
+/**
+ * @brief Compile the AST for the VM and run the function given on the command
+ *        line.
+ * @param[in] sourceFileName The source file the AST belongs to
+ * @param[in] ast The AST to run
+ * @param[in] diagnostics The file to write the result to
+ * @return The exit code for the source file
+ */
+static int waitui_compile_run(str sourceFileName, waitui_ast *ast,
+                              FILE *diagnostics) {
+    waitui_vm_natives *natives = NULL;
+    waitui_vm_program *program = NULL;
+    waitui_vm *vm              = NULL;
+    waitui_vm_value value      = {0};
+    int result                 = WAITUI_FAILURE;
+
+    natives = waitui_vm_natives_new();
+    if (!natives ||
+        !waitui_vm_natives_register(natives,
+                                    (str) STR_STATIC_INIT("Console.log"), 1,
+                                    waitui_native_consoleLog)) {
+        waitui_vm_natives_destroy(&natives);
+        return WAITUI_OTHER_ERROR;
+    }
+
+    program = waitui_vm_program_compile(ast, natives, diagnostics);
+    waitui_vm_natives_destroy(&natives);
+    if (!program) {
+        fprintf(diagnostics, "compiling '%.*s' for the vm failed\n",
+                STR_FMT(&sourceFileName));
+        return WAITUI_FAILURE;
+    }
+
+    vm = waitui_vm_new(program);
+    if (!vm) {
+        waitui_vm_program_destroy(&program);
+        return WAITUI_OTHER_ERROR;
+    }
+
+    if (waitui_vm_run(vm, runClassName, runFunctionName, &value,
+                      diagnostics)) {
+        fprintf(diagnostics, "%.*s.%.*s = ", STR_FMT(&runClassName),
+                STR_FMT(&runFunctionName));
+        waitui_vm_value_print(&value, diagnostics);
+        fputc('\n', diagnostics);
+        result = WAITUI_SUCCESS;
+    } else {
+        fprintf(diagnostics, "running '%.*s' failed\n",
+                STR_FMT(&sourceFileName));
+    }
+
+    waitui_vm_destroy(&vm);
+    waitui_vm_program_destroy(&program);
+
+    return result;
+}
+
+/**
+ * @brief Print the graph of the AST, on the printer Thread pool when it is
+ *        free.
+ * @param[in] ast The AST to print the graph of
+ * @param[in,out] output The file to print the graph to
+ * @note The jobs already run on their own Thread pool, which cannot run the
+ *       classes of a job, so one job at a time prints on the printer Thread
+ *       pool and the others print on their own thread. The graph is the same.
+ */
+static void waitui_compile_generateGraph(waitui_ast *ast, FILE *output) {
+    if (printerThreadpool && pthread_mutex_trylock(&printerMutex) == 0) {
+        waitui_ast_printer_generateGraphParallel(ast, output,
+                                                 printerThreadpool);
+        pthread_mutex_unlock(&printerMutex);
+        return;
+    }
+
+    waitui_ast_printer_generateGraph(ast, output);
+}
+
+/**
+ * @brief Compile the source file of the job into its graph and binary AST.
+ * @param[in,out] job The job with the source file to compile
+ * @param[in] diagnostics The file to write the errors to
+ * @return The exit code for the source file
+ * @note With a Build cache the outputs of an unchanged source file are taken
+ *       from the cache. A compiled source file is only stored when it and all
+ *       of its modules compiled without errors, so the errors of a run do not
+ *       depend on the state of the cache. A source file to run is always
+ *       parsed, so the Build cache is skipped.
+ */
+static int waitui_compile_file(waitui_job *job, FILE *diagnostics) {
+    int result = WAITUI_SUCCESS;
+
+    parser *waituiParser             = NULL;
+    waitui_ast *waituiAst            = NULL;
+    waitui_build_cache_entry outputs = {0};
+    waitui_dependencies dependencies = {0};
+    FILE *output                     = NULL;
+    size_t outputLength              = 0;
+    uint64_t key                     = 0;
+
+    if (buildCache && !runClassName.s &&
+        strcmp(job->sourceFileName.s, sourceStdin.s) != 0 &&
+        waitui_build_cache_load(buildCache, job->sourceFileName, &key,
+                                &outputs)) {
+        waitui_log_debug("'%.*s' taken from the build cache",
+                         STR_FMT(&job->sourceFileName));
+        if (outputs.diagnostics.len > 0) {
+            fwrite(outputs.diagnostics.s, 1, outputs.diagnostics.len,
+                   diagnostics);
+        }
+        result = waitui_compile_writeOutputs(job->sourceFileName, &outputs,
+                                             diagnostics);
+        goto done;
+    }
 
-    waituiParser = parser_new(sourceFileName, currentDirectory, parserDebug);
+    waituiParser = parser_new(job->sourceFileName, currentDirectory,
+                              parserDebug);
     if (!waituiParser) {
+        fprintf(diagnostics, "could not create parser for '%.*s'\n",
+                STR_FMT(&job->sourceFileName));
         result = WAITUI_OTHER_ERROR;
         goto done;
     }
+    parser_set_diagnostics(waituiParser, diagnostics);
+    parser_set_module_cache(waituiParser, moduleCache);
 
     waitui_log_trace("start parsing input");
     if (!parser_parse(waituiParser)) {
-        waitui_log_fatal("parsing input failed");
+        fprintf(diagnostics, "parsing '%.*s' failed\n",
+                STR_FMT(&job->sourceFileName));
         result = WAITUI_FAILURE;
         goto done;
     }
@@ -79,30 +526,336 @@ int main(int argc, char **argv) {
 
     parser_destroy(&waituiParser);
 
-    graphFileName.len = sourceFileName.len + sizeof(".dot");
-    graphFileName.s   = calloc(graphFileName.len, sizeof(*graphFileName.s));
-    if (!graphFileName.s) {
+    if (optimize) {
+        unsigned long int foldCount = 0;
+
+        if (!waitui_ast_optimizer_fold(waituiAst, &foldCount)) {
+            fprintf(diagnostics, "could not optimize '%.*s'\n",
+                    STR_FMT(&job->sourceFileName));
+            result = WAITUI_OTHER_ERROR;
+            goto done;
+        }
+        waitui_log_debug("%lu expressions of '%.*s' were folded", foldCount,
+                         STR_FMT(&job->sourceFileName));
+    }
+
+    if (typeCheck) {
+        unsigned long int errorCount = 0;
+
+        if (!waitui_type_checker_check(waituiAst, job->sourceFileName,
+                                       &errorCount, diagnostics)) {
+            result = WAITUI_OTHER_ERROR;
+            goto done;
+        }
+        if (errorCount > 0) {
+            fprintf(diagnostics, "type checking '%.*s' failed with %lu "
+                                 "errors\n",
+                    STR_FMT(&job->sourceFileName), errorCount);
+            result = WAITUI_FAILURE;
+            goto done;
+        }
+    }
+
+    if (runClassName.s) {
+        result = waitui_compile_run(job->sourceFileName, waituiAst,
+                                    diagnostics);
+        if (result != WAITUI_SUCCESS) { goto done; }
+    }
+
+    output = open_memstream(&outputs.graph.s, &outputLength);
+    if (!output) {
         result = WAITUI_OTHER_ERROR;
         goto done;
     }
-    memcpy(graphFileName.s, sourceFileName.s, sourceFileName.len);
-    snprintf(graphFileName.s + sourceFileName.len, graphFileName.len, "%s",
-             ".dot");
+    waitui_compile_generateGraph(waituiAst, output);
+    fclose(output);
+    outputs.graph.len = outputLength;
 
-    graphFile = fopen(graphFileName.s, "w");
-    if (!graphFile) {
-        result = WAITUI_OTHER_ERROR;
+    if (writeBinary || key) {
+        output = open_memstream(&outputs.binary.s, &outputLength);
+        if (!output) {
+            result = WAITUI_OTHER_ERROR;
+            goto done;
+        }
+        if (!waitui_ast_binary_write(waituiAst, output)) {
+            fprintf(diagnostics, "could not write the binary AST of '%.*s'\n",
+                    STR_FMT(&job->sourceFileName));
+            result = WAITUI_OTHER_ERROR;
+        }
+        fclose(output);
+        outputs.binary.len = outputLength;
+        if (result != WAITUI_SUCCESS) { goto done; }
+    }
+
+    result = waitui_compile_writeOutputs(job->sourceFileName, &outputs,
+                                         diagnostics);
+    if (result != WAITUI_SUCCESS || !key || runClassName.s) { goto done; }
+
+    if (!parser_module_cache_forEachDependency(moduleCache, waituiAst,
+                                               waitui_dependencies_add,
+                                               &dependencies)) {
         goto done;
     }
-    waitui_ast_printer_generateGraph(waituiAst, graphFile);
 
-    waitui_log_debug("waitui execution done");
+    // the diagnostics so far are the warnings of the source file
+    fflush(diagnostics);
+    outputs.diagnostics.s   = job->diagnostics;
+    outputs.diagnostics.len = job->diagnostics ? job->diagnosticsLength : 0;
+
+    if (!waitui_build_cache_store(buildCache, key, dependencies.paths,
+                                  dependencies.length, &outputs)) {
+        waitui_log_warn("could not store '%.*s' in the build cache",
+                        STR_FMT(&job->sourceFileName));
+    }
+    outputs.diagnostics.s   = NULL;
+    outputs.diagnostics.len = 0;
 
 done:
-    if (graphFile) { fclose(graphFile); }
-    if (graphFileName.s) { free(graphFileName.s); }
+    free(dependencies.paths);
+    waitui_build_cache_entry_free(&outputs);
     ast_destroy(&waituiAst);
     parser_destroy(&waituiParser);
 
     return result;
 }
+
+/**
+ * @brief Create the Build cache for the directory.
+ * @param[in] directory The directory of the Build cache
+ * @return A pointer to waitui_build_cache or NULL if creation failed
+ * @note The version, the working directory and the search paths decide which
+ *       modules the imports resolve to, so they are part of every key, just
+ *       like the optimization and the type check that change the outputs.
+ */
+static waitui_build_cache *
+waitui_compile_openBuildCache(const char *directory) {
+    char workingDirectory[PATH_MAX];
+    waitui_build_cache *cache = NULL;
+    str cacheDirectory        = STR_NULL_INIT;
+    str options               = STR_NULL_INIT;
+    size_t optionsLength      = 0;
+    FILE *optionsFile         = NULL;
+
+    if (!getcwd(workingDirectory, sizeof(workingDirectory))) { return NULL; }
+
+    optionsFile = open_memstream(&options.s, &optionsLength);
+    if (!optionsFile) { return NULL; }
+
+    fprintf(optionsFile, "waitui %s\nast %d\ncwd %s\n", WAITUI_VERSION,
+            WAITUI_AST_BINARY_VERSION, workingDirectory);
+    for (unsigned long int i = 0; i < searchPathCount; ++i) {
+        fprintf(optionsFile, "-I%.*s\n", STR_FMT(&searchPaths[i]));
+    }
+    if (optimize) { fprintf(optionsFile, "-O\n"); }
+    if (typeCheck) { fprintf(optionsFile, "-t\n"); }
+    fclose(optionsFile);
+    options.len = optionsLength;
+
+    cacheDirectory.s   = (char *) directory;
+    cacheDirectory.len = strlen(directory);
+
+    cache = waitui_build_cache_new(cacheDirectory, options);
+    STR_FREE(&options);
+
+    return cache;
+}
+
+/**
+ * @brief Compile the job with the index, called by the Thread pool.
+ * @param[in,out] args The jobs of the run
+ * @param[in] index The index of the job to compile
+ */
+static void waitui_compile_job(void *args, unsigned long int index) {
+    waitui_job *job   = &((waitui_jobs *) args)->jobs[index];
+    FILE *diagnostics = NULL;
+
+    diagnostics = open_memstream(&job->diagnostics, &job->diagnosticsLength);
+
+    job->result = waitui_compile_file(job, diagnostics ? diagnostics : stderr);
+
+    if (diagnostics) { fclose(diagnostics); }
+}
+
+/**
+ * @brief Print the usage of waitui.
+ * @param[in] name The name of the program
+ */
+static void waitui_usage(const char *name) {
+    fprintf(stderr,
+            "usage: %s [-a] [-b] [-O] [-t] [-c cache directory] [-j threads] "
+            "[-I search path]... [-r class.function] "
+            "[file|directory]...\n",
+            name);
+}
+
+
+// -----------------------------------------------------------------------------
+//  Main function
+// -----------------------------------------------------------------------------
+
+int main(int argc, char **argv) {
+    int result = WAITUI_SUCCESS;
+
+    pthread_mutex_t logMutex       = PTHREAD_MUTEX_INITIALIZER;
+    waitui_threadpool *threadpool  = NULL;
+    waitui_log_async *logAsync     = NULL;
+    waitui_jobs jobs               = {0};
+    unsigned long int threads      = 0;
+    unsigned long int printThreads = 0;
+    const char *cacheDirectory     = NULL;
+    int option                     = 0;
+    char *separator                = NULL;
+    bool asyncLog                  = false;
+
+    while ((option = getopt(argc, argv, "abOtc:j:I:r:")) != -1) {
+        switch (option) {
+            case 'a':
+                asyncLog = true;
+                break;
+            case 'b':
+                writeBinary = true;
+                break;
+            case 'O':
+                optimize = true;
+                break;
+            case 't':
+                typeCheck = true;
+                break;
+            case 'c':
+                cacheDirectory = optarg;
+                break;
+            case 'j':
+                threads = strtoul(optarg, NULL, 10);
+                break;
+            case 'I':
+                if (searchPathCount == WAITUI_MAX_SEARCH_PATHS) {
+                    waitui_usage(argv[0]);
+                    return WAITUI_OTHER_ERROR;
+                }
+                searchPaths[searchPathCount].s     = optarg;
+                searchPaths[searchPathCount++].len = strlen(optarg);
+                break;
+            case 'r':
+                separator = strchr(optarg, '.');
+                if (!separator || separator == optarg || !separator[1]) {
+                    waitui_usage(argv[0]);
+                    return WAITUI_OTHER_ERROR;
+                }
+                runClassName.s      = optarg;
+                runClassName.len    = separator - optarg;
+                runFunctionName.s   = separator + 1;
+                runFunctionName.len = strlen(separator + 1);
+                break;
+            default:
+                waitui_usage(argv[0]);
+                return WAITUI_OTHER_ERROR;
+        }
+    }
+
+    waitui_log_setLevel(WAITUI_LOG_DEBUG);
+    waitui_log_setQuiet(false);
+    waitui_log_set_lock(waitui_log_mutex, &logMutex);
+
+    // the workers then only format their logs, a writer thread writes them
+    if (asyncLog) {
+        logAsync = waitui_log_async_new(STDERR_FILENO,
+                                        WAITUI_LOG_ASYNC_CAPACITY);
+        if (!logAsync || !waitui_log_addAsync(logAsync, WAITUI_LOG_DEBUG)) {
+            result = WAITUI_OTHER_ERROR;
+            goto done;
+        }
+        waitui_log_setQuiet(true);
+    }
+
+    waitui_log_debug("waitui start execution");
+
+    for (int i = optind; i < argc; ++i) {
+        if (!waitui_jobs_addInput(&jobs, argv[i])) {
+            result = WAITUI_OTHER_ERROR;
+            goto done;
+        }
+    }
+    if (optind == argc && !waitui_jobs_add(&jobs, sourceStdin.s)) {
+        result = WAITUI_OTHER_ERROR;
+        goto done;
+    }
+
+    // the graph of a single input is still printed on all threads
+    printThreads = threads;
+
+    // the lexer and parser traces are only readable for a single input
+    if (jobs.length == 1) {
+        parserDebug = PARSER_DEBUG_NONE | PARSER_DEBUG_LEXER |
+                      PARSER_DEBUG_PARSER;
+        threads     = 1;
+    }
+
+    moduleCache = parser_module_cache_new(searchPaths, searchPathCount);
+    if (!moduleCache) {
+        result = WAITUI_OTHER_ERROR;
+        goto done;
+    }
+
+    if (cacheDirectory) {
+        buildCache = waitui_compile_openBuildCache(cacheDirectory);
+        if (!buildCache) {
+            result = WAITUI_OTHER_ERROR;
+            goto done;
+        }
+    }
+
+    threadpool = waitui_threadpool_new(threads);
+    if (!threadpool) {
+        result = WAITUI_OTHER_ERROR;
+        goto done;
+    }
+
+    if (printThreads != 1) {
+        printerThreadpool = waitui_threadpool_new(printThreads);
+        if (!printerThreadpool) {
+            result = WAITUI_OTHER_ERROR;
+            goto done;
+        }
+    }
+
+    waitui_log_debug("compiling %lu inputs on %lu threads", jobs.length,
+                     waitui_threadpool_getThreadCount(threadpool));
+
+    waitui_threadpool_run(threadpool, jobs.length, waitui_compile_job, &jobs);
+
+    for (unsigned long int i = 0; i < jobs.length; ++i) {
+        if (jobs.jobs[i].diagnosticsLength > 0) {
+            fwrite(jobs.jobs[i].diagnostics, 1, jobs.jobs[i].diagnosticsLength,
+                   stderr);
+        }
+        if (jobs.jobs[i].result > result) { result = jobs.jobs[i].result; }
+    }
+
+    if (parser_module_cache_writeDiagnostics(moduleCache, stderr) > 0 &&
+        result < WAITUI_FAILURE) {
+        result = WAITUI_FAILURE;
+    }
+
+    waitui_log_debug("%lu imported modules parsed",
+                     parser_module_cache_getParsedCount(moduleCache));
+
+    if (buildCache) {
+        waitui_log_debug("%lu of %lu inputs taken from the build cache",
+                         waitui_build_cache_getHitCount(buildCache),
+                         jobs.length);
+    }
+
+    waitui_log_debug("waitui execution done");
+
+done:
+    waitui_threadpool_destroy(&printerThreadpool);
+    waitui_threadpool_destroy(&threadpool);
+    waitui_build_cache_destroy(&buildCache);
+    parser_module_cache_destroy(&moduleCache);
+    waitui_jobs_destroy(&jobs);
+    waitui_log_async_destroy(&logAsync);
+    waitui_log_setQuiet(false);
+    waitui_log_set_lock(NULL, NULL);
+
+    return result;
+}
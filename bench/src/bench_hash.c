@@ -0,0 +1,332 @@
+/**
+ * @file bench_hash.c
+ * @author rick
+ * @date 17.10.26
+ * @brief Benchmark comparing the old additive hash with hashtable_hash
+ */
+
+#include <waitui/hashtable.h>
+#include <waitui/str.h>
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+
+// -----------------------------------------------------------------------------
+//  Local defines
+// -----------------------------------------------------------------------------
+
+#define BENCH_SUCCESS 0
+#define BENCH_FAILURE 1
+
+/**
+ * @brief How often every key is hashed for the timing.
+ */
+#define BENCH_HASH_ROUNDS 64
+
+/**
+ * @brief The number of keys of the synthetic corpus per pattern.
+ */
+#define BENCH_SYNTHETIC_COUNT 4096
+
+
+// -----------------------------------------------------------------------------
+//  Local types
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Type for the compared hash functions.
+ */
+typedef uint64_t (*bench_hash_function)(str key);
+
+/**
+ * @brief Struct representing the distinct keys of a corpus.
+ */
+typedef struct bench_corpus {
+    str *keys;
+    unsigned long int length;
+    unsigned long int capacity;
+    hashtable *seen;
+} bench_corpus;
+
+/**
+ * @brief Struct representing the bucket statistics of a hash function.
+ */
+typedef struct bench_result {
+    unsigned long int buckets;
+    unsigned long int usedBuckets;
+    unsigned long int maxChain;
+    double avgProbes;
+    double nsPerHash;
+} bench_result;
+
+
+// -----------------------------------------------------------------------------
+//  Local functions
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The additive hash hashtable_hash used before, without the modulo.
+ * @param[in] key The key to hash
+ * @return The hash value of the key
+ */
+static uint64_t bench_hash_additive(str key) {
+    unsigned long int hashValue = 0;
+
+    if (key.len < 1 || !key.s) { return 0; }
+
+    for (unsigned long int i = 0; i < key.len; ++i) { hashValue += key.s[i]; }
+    hashValue += key.s[0] % 11 + (((unsigned char) key.s[0]) << 3U) - key.s[0];
+
+    return hashValue;
+}
+
+/**
+ * @brief Add the key to the corpus if it is not yet part of it.
+ * @param[in,out] this The corpus to add the key to
+ * @param[in] key The key to add
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ */
+static int bench_corpus_add(bench_corpus *this, str key) {
+    str copy = STR_NULL_INIT;
+
+    if (hashtable_has(this->seen, key)) { return 1; }
+
+    if (this->length == this->capacity) {
+        unsigned long int capacity = this->capacity ? this->capacity * 2
+                                                    : 1024;
+        str *keys                  = realloc(this->keys,
+                                             capacity * sizeof(*keys));
+        if (!keys) { return 0; }
+
+        this->keys     = keys;
+        this->capacity = capacity;
+    }
+
+    STR_COPY(&copy, &key);
+    if (!copy.s) { return 0; }
+
+    if (!hashtable_insert(this->seen, copy, this)) {
+        STR_FREE(&copy);
+        return 0;
+    }
+
+    this->keys[this->length++] = copy;
+
+    return 1;
+}
+
+/**
+ * @brief Add every identifier of the file to the corpus.
+ * @param[in,out] this The corpus to add the identifiers to
+ * @param[in] fileName The name of the file to read
+ * @retval 1 Ok
+ * @retval 0 Reading the file or memory allocation failed
+ */
+static int bench_corpus_addFile(bench_corpus *this, const char *fileName) {
+    char buffer[256];
+    unsigned long int length = 0;
+    int c                    = 0;
+    int result               = 1;
+    FILE *file               = NULL;
+
+    file = fopen(fileName, "r");
+    if (!file) {
+        fprintf(stderr, "could not open %s\n", fileName);
+        return 0;
+    }
+
+    do {
+        c = fgetc(file);
+        if (c == '_' || isalpha(c) || (length > 0 && isdigit(c))) {
+            if (length < sizeof(buffer)) { buffer[length++] = (char) c; }
+            continue;
+        }
+
+        if (length > 0) {
+            str identifier = {.s = buffer, .len = length};
+            if (!bench_corpus_add(this, identifier)) {
+                result = 0;
+                break;
+            }
+            length = 0;
+        }
+    } while (c != EOF);
+
+    fclose(file);
+
+    return result;
+}
+
+/**
+ * @brief Fill the corpus with identifiers that collide for additive hashes.
+ * @param[in,out] this The corpus to fill
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ */
+static int bench_corpus_addSynthetic(bench_corpus *this) {
+    static const char *prefixes[] = {"get", "set", "is", "has", "on"};
+    static const unsigned long int prefixCount =
+            sizeof(prefixes) / sizeof(*prefixes);
+    char buffer[64];
+
+    for (unsigned long int i = 0; i < BENCH_SYNTHETIC_COUNT; ++i) {
+        const char *prefix = prefixes[i % prefixCount];
+        char letter        = (char) ('a' + i % 26);
+        int length         = 0;
+        str key            = {.s = buffer, .len = 0};
+
+        // getX / getY style accessors
+        length = snprintf(buffer, sizeof(buffer), "%s%c%lu", prefix,
+                          toupper(letter), i / 26);
+        key.len = (unsigned long int) length;
+        if (!bench_corpus_add(this, key)) { return 0; }
+
+        // a1 / 1a style permutations
+        length  = snprintf(buffer, sizeof(buffer), "%c%lu", letter, i);
+        key.len = (unsigned long int) length;
+        if (!bench_corpus_add(this, key)) { return 0; }
+        length  = snprintf(buffer, sizeof(buffer), "_%lu%c", i, letter);
+        key.len = (unsigned long int) length;
+        if (!bench_corpus_add(this, key)) { return 0; }
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Release the keys of the corpus.
+ * @param[in,out] this The corpus to release
+ */
+static void bench_corpus_destroy(bench_corpus *this) {
+    for (unsigned long int i = 0; i < this->length; ++i) {
+        STR_FREE(&this->keys[i]);
+    }
+    free(this->keys);
+    hashtable_destroy(&this->seen);
+}
+
+/**
+ * @brief Get the current time in nanoseconds.
+ * @return The time in nanoseconds
+ */
+static double bench_now(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double) now.tv_sec * 1e9 + (double) now.tv_nsec;
+}
+
+/**
+ * @brief Distribute the corpus over power of two buckets with the function.
+ * @param[in] corpus The corpus to distribute
+ * @param[in] hashFunction The hash function to use
+ * @param[out] result The statistics of the distribution
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ */
+static int bench_run(const bench_corpus *corpus,
+                     bench_hash_function hashFunction, bench_result *result) {
+    unsigned long int *chains = NULL;
+    unsigned long int probes  = 0;
+    volatile uint64_t sink    = 0;
+    double start              = 0;
+
+    result->buckets = 1;
+    while (result->buckets < corpus->length) { result->buckets <<= 1U; }
+
+    chains = calloc(result->buckets, sizeof(*chains));
+    if (!chains) { return 0; }
+
+    for (unsigned long int i = 0; i < corpus->length; ++i) {
+        uint64_t hash            = hashFunction(corpus->keys[i]);
+        unsigned long int *chain = &chains[hash & (result->buckets - 1)];
+
+        if (*chain == 0) { result->usedBuckets++; }
+        (*chain)++;
+        probes += *chain;
+        if (*chain > result->maxChain) { result->maxChain = *chain; }
+    }
+    result->avgProbes = (double) probes / (double) corpus->length;
+
+    start = bench_now();
+    for (int round = 0; round < BENCH_HASH_ROUNDS; ++round) {
+        for (unsigned long int i = 0; i < corpus->length; ++i) {
+            sink ^= hashFunction(corpus->keys[i]);
+        }
+    }
+    result->nsPerHash = (bench_now() - start) /
+                        ((double) corpus->length * BENCH_HASH_ROUNDS);
+
+    free(chains);
+
+    return 1;
+}
+
+/**
+ * @brief Print the statistics of a hash function.
+ * @param[in] name The name of the hash function
+ * @param[in] result The statistics to print
+ */
+static void bench_print(const char *name, const bench_result *result) {
+    printf("%-10s %10lu %10lu %10lu %12.2f %10.2f\n", name, result->buckets,
+           result->usedBuckets, result->maxChain, result->avgProbes,
+           result->nsPerHash);
+}
+
+
+// -----------------------------------------------------------------------------
+//  Main function
+// -----------------------------------------------------------------------------
+
+int main(int argc, char **argv) {
+    int result            = BENCH_SUCCESS;
+    bench_corpus corpus   = {0};
+    bench_result additive = {0};
+    bench_result current  = {0};
+
+    corpus.seen = hashtable_new(1024, NULL);
+    if (!corpus.seen) { return BENCH_FAILURE; }
+
+    for (int i = 1; i < argc; ++i) {
+        if (!bench_corpus_addFile(&corpus, argv[i])) {
+            result = BENCH_FAILURE;
+            goto done;
+        }
+    }
+
+    if (argc < 2 && !bench_corpus_addSynthetic(&corpus)) {
+        result = BENCH_FAILURE;
+        goto done;
+    }
+
+    if (corpus.length == 0) {
+        fprintf(stderr, "no identifiers found\n");
+        result = BENCH_FAILURE;
+        goto done;
+    }
+
+    if (!bench_run(&corpus, bench_hash_additive, &additive) ||
+        !bench_run(&corpus, hashtable_hash, &current)) {
+        result = BENCH_FAILURE;
+        goto done;
+    }
+
+    printf("%lu distinct identifiers from %s\n\n", corpus.length,
+           argc < 2 ? "the synthetic corpus" : "the given files");
+    printf("%-10s %10s %10s %10s %12s %10s\n", "hash", "buckets", "used",
+           "max chain", "avg probes", "ns/hash");
+    bench_print("additive", &additive);
+    bench_print("current", &current);
+
+done:
+    bench_corpus_destroy(&corpus);
+
+    return result;
+}
@@ -0,0 +1,792 @@
+/**
+ * @file bench_parser.c
+ * @author rick
+ * @date 17.10.26
+ * @brief Benchmark measuring the throughput of the parser pipeline
+ */
+
+#include <waitui/ast.h>
+#include <waitui/ast_printer.h>
+#include <waitui/log.h>
+#include <waitui/parser.h>
+#include <waitui/str.h>
+#include <waitui/symboltable.h>
+#include <waitui/threadpool.h>
+
+#include <getopt.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+
+// -----------------------------------------------------------------------------
+//  Local defines
+// -----------------------------------------------------------------------------
+
+#define BENCH_SUCCESS 0
+#define BENCH_FAILURE 1
+
+
+// -----------------------------------------------------------------------------
+//  Local types
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The stages of the pipeline a benchmark runs through.
+ */
+typedef enum bench_mode {
+    BENCH_MODE_LEX,
+    BENCH_MODE_PARSE,
+    BENCH_MODE_SYMBOLTABLE,
+    BENCH_MODE_FULL,
+    BENCH_MODE_ALL,
+} bench_mode;
+
+/**
+ * @brief Struct representing the shape of the generated program.
+ */
+typedef struct bench_shape {
+    unsigned long int classes;
+    unsigned long int functions;
+    unsigned long int depth;
+    unsigned long int identifiers;
+    unsigned long int literalDensity;
+    uint64_t seed;
+} bench_shape;
+
+/**
+ * @brief Struct representing the state of walking the AST.
+ */
+typedef struct bench_walker {
+    symboltable *symtable;
+    unsigned long int nodes;
+    unsigned long int declared;
+    unsigned long int resolved;
+    unsigned long int unresolved;
+} bench_walker;
+
+/**
+ * @brief Struct representing where and how the graph is printed in full mode.
+ */
+typedef struct bench_graph {
+    FILE *file;
+    waitui_threadpool *threadpool;
+} bench_graph;
+
+/**
+ * @brief Struct representing the numbers of the generated program.
+ */
+typedef struct bench_corpus {
+    str fileName;
+    unsigned long int bytes;
+    unsigned long int tokens;
+    unsigned long int nodes;
+} bench_corpus;
+
+
+// -----------------------------------------------------------------------------
+//  Local variables
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The names of the benchmark modes.
+ */
+static const char *benchModeNames[] = {
+        [BENCH_MODE_LEX]         = "lex",
+        [BENCH_MODE_PARSE]       = "parse",
+        [BENCH_MODE_SYMBOLTABLE] = "symboltable",
+        [BENCH_MODE_FULL]        = "full",
+        [BENCH_MODE_ALL]         = "all",
+};
+
+/**
+ * @brief The binary operators used for the generated expressions.
+ */
+static const char *benchBinaryOperators[] = {"+",  "-",  "*",  "/", "<",
+                                             "==", "&&", "||", "%", "&"};
+
+
+// -----------------------------------------------------------------------------
+//  Local functions
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Return the next pseudo random number of the xorshift generator.
+ * @param[in,out] state The state of the generator
+ * @return The next pseudo random number
+ */
+static uint64_t bench_random(uint64_t *state) {
+    uint64_t x = *state;
+
+    x ^= x << 13U;
+    x ^= x >> 7U;
+    x ^= x << 17U;
+    *state = x;
+
+    return x;
+}
+
+/**
+ * @brief Write a literal or an identifier reference.
+ * @param[in] file The file to write to
+ * @param[in] shape The shape of the generated program
+ * @param[in,out] state The state of the random generator
+ */
+static void bench_generate_leaf(FILE *file, const bench_shape *shape,
+                                uint64_t *state) {
+    if (bench_random(state) % 100 >= shape->literalDensity) {
+        fprintf(file, "id%llu",
+                (unsigned long long) (bench_random(state) %
+                                      shape->identifiers));
+        return;
+    }
+
+    switch (bench_random(state) % 7) {
+        case 0:
+            fprintf(file, "%llu",
+                    (unsigned long long) (bench_random(state) % 100000));
+            break;
+        case 1:
+            fprintf(file, "%llu.%llu",
+                    (unsigned long long) (bench_random(state) % 1000),
+                    (unsigned long long) (bench_random(state) % 1000));
+            break;
+        case 2:
+            fprintf(file, "\"s%llu\"",
+                    (unsigned long long) (bench_random(state) % 1000));
+            break;
+        case 3:
+            fprintf(file, "true");
+            break;
+        case 4:
+            fprintf(file, "false");
+            break;
+        case 5:
+            fprintf(file, "null");
+            break;
+        default:
+            fprintf(file, "this");
+            break;
+    }
+}
+
+/**
+ * @brief Write an expression nested up to depth levels.
+ * @param[in] file The file to write to
+ * @param[in] shape The shape of the generated program
+ * @param[in,out] state The state of the random generator
+ * @param[in] depth The remaining nesting depth
+ * @note Every expression ends with a literal, an identifier, ')' or '}', so a
+ *       newline after it is a statement end for the lexer.
+ */
+static void bench_generate_expression(FILE *file, const bench_shape *shape,
+                                      uint64_t *state,
+                                      unsigned long int depth) {
+    static const unsigned long int operatorCount =
+            sizeof(benchBinaryOperators) / sizeof(*benchBinaryOperators);
+
+    if (depth == 0) {
+        bench_generate_leaf(file, shape, state);
+        return;
+    }
+
+    switch (bench_random(state) % 10) {
+        case 0:
+            fprintf(file, "-(");
+            bench_generate_expression(file, shape, state, depth - 1);
+            fprintf(file, ")");
+            break;
+        case 1:
+            fprintf(file, "if (");
+            bench_generate_expression(file, shape, state, depth - 1);
+            fprintf(file, ") ");
+            bench_generate_expression(file, shape, state, depth - 1);
+            fprintf(file, " else ");
+            bench_generate_expression(file, shape, state, depth - 1);
+            break;
+        case 2:
+            fprintf(file, "let id%llu : Int = ",
+                    (unsigned long long) (bench_random(state) %
+                                          shape->identifiers));
+            bench_generate_expression(file, shape, state, depth - 1);
+            fprintf(file, " in ");
+            bench_generate_expression(file, shape, state, depth - 1);
+            break;
+        case 3:
+            fprintf(file, "{ ");
+            bench_generate_expression(file, shape, state, depth - 1);
+            fprintf(file, "; ");
+            bench_generate_expression(file, shape, state, depth - 1);
+            fprintf(file, "; }");
+            break;
+        case 4:
+            fprintf(file, "(");
+            bench_generate_expression(file, shape, state, depth - 1);
+            fprintf(file, ").f%llu(",
+                    (unsigned long long) (bench_random(state) %
+                                          shape->functions));
+            bench_generate_expression(file, shape, state, depth - 1);
+            fprintf(file, ")");
+            break;
+        case 5:
+            fprintf(file, "new C%llu(",
+                    (unsigned long long) (bench_random(state) %
+                                          shape->classes));
+            bench_generate_expression(file, shape, state, depth - 1);
+            fprintf(file, ")");
+            break;
+        default:
+            fprintf(file, "(");
+            bench_generate_expression(file, shape, state, depth - 1);
+            fprintf(file, " %s ",
+                    benchBinaryOperators[bench_random(state) % operatorCount]);
+            bench_generate_expression(file, shape, state, depth - 1);
+            fprintf(file, ")");
+            break;
+    }
+}
+
+/**
+ * @brief Write a program of the given shape.
+ * @param[in] file The file to write to
+ * @param[in] shape The shape of the generated program
+ */
+static void bench_generate_program(FILE *file, const bench_shape *shape) {
+    uint64_t state = shape->seed ? shape->seed : 1;
+
+    fprintf(file, "namespace bench.generated\n\n");
+
+    for (unsigned long int c = 0; c < shape->classes; ++c) {
+        fprintf(file, "class C%lu(id%llu : Int) {\n", c,
+                (unsigned long long) (bench_random(&state) %
+                                      shape->identifiers));
+
+        fprintf(file, "    var id%llu = ",
+                (unsigned long long) (bench_random(&state) %
+                                      shape->identifiers));
+        bench_generate_leaf(file, shape, &state);
+        fprintf(file, "\n");
+
+        for (unsigned long int f = 0; f < shape->functions; ++f) {
+            fprintf(file, "    func f%lu(id%llu : Int) = ", f,
+                    (unsigned long long) (bench_random(&state) %
+                                          shape->identifiers));
+            bench_generate_expression(file, shape, &state, shape->depth);
+            fprintf(file, "\n");
+        }
+
+        fprintf(file, "}\n\n");
+    }
+}
+
+/**
+ * @brief Declare the symbol in the current scope of the walked SymbolTable.
+ * @param[in,out] walker The walker holding the SymbolTable
+ * @param[in] name The symbol to declare
+ */
+static void bench_walk_declare(bench_walker *walker, symbol *name) {
+    if (!walker->symtable || !name) { return; }
+
+    symboltable_enter_declaration_mode(walker->symtable);
+    if (symboltable_add_symbol(walker->symtable, name->identifier, &name)) {
+        walker->declared++;
+    }
+    symboltable_leave_declaration_mode(walker->symtable);
+}
+
+/**
+ * @brief Resolve the referenced symbol in the walked SymbolTable.
+ * @param[in,out] walker The walker holding the SymbolTable
+ * @param[in] name The symbol to resolve
+ */
+static void bench_walk_resolve(bench_walker *walker, symbol *name) {
+    if (!walker->symtable || !name) { return; }
+
+    if (symboltable_lookup(walker->symtable, name->identifier)) {
+        walker->resolved++;
+    } else {
+        walker->unresolved++;
+    }
+}
+
+static void bench_walk_expression(bench_walker *walker,
+                                  waitui_ast_expression *expression);
+
+/**
+ * @brief Walk all expressions of the list.
+ * @param[in,out] walker The walker state
+ * @param[in] expressions The expressions to walk
+ */
+static void bench_walk_expressions(bench_walker *walker,
+                                   waitui_ast_expression_vector *expressions) {
+    WAITUI_VECTOR_FOREACH(waitui_ast_expression, expression, expressions) {
+        bench_walk_expression(walker, expression);
+    }
+}
+
+/**
+ * @brief Walk the formals of a class or function and declare them.
+ * @param[in,out] walker The walker state
+ * @param[in] formals The formals to walk
+ */
+static void bench_walk_formals(bench_walker *walker,
+                               waitui_ast_formal_vector *formals) {
+    WAITUI_VECTOR_FOREACH(waitui_ast_formal, formal, formals) {
+        walker->nodes++;
+        bench_walk_declare(walker, waitui_ast_formal_getIdentifier(formal));
+    }
+}
+
+/**
+ * @brief Walk the let expression in its own scope.
+ * @param[in,out] walker The walker state
+ * @param[in] let The let expression to walk
+ */
+static void bench_walk_let(bench_walker *walker, waitui_ast_let *let) {
+    if (walker->symtable) { symboltable_enter_scope(walker->symtable); }
+
+    WAITUI_VECTOR_FOREACH(waitui_ast_initialization, initialization,
+                          waitui_ast_let_getInitializations(let)) {
+        walker->nodes++;
+        bench_walk_expression(walker, waitui_ast_initialization_getValue(
+                                              initialization));
+        bench_walk_declare(walker, waitui_ast_initialization_getIdentifier(
+                                           initialization));
+    }
+
+    bench_walk_expression(walker, waitui_ast_let_getBody(let));
+
+    if (walker->symtable) { symboltable_exit_scope(walker->symtable); }
+}
+
+/**
+ * @brief Walk the expression and its children.
+ * @param[in,out] walker The walker state
+ * @param[in] expression The expression to walk
+ */
+static void bench_walk_expression(bench_walker *walker,
+                                  waitui_ast_expression *expression) {
+    if (!expression) { return; }
+
+    walker->nodes++;
+
+    switch (waitui_ast_expression_getExpressionType(expression)) {
+        case WAITUI_AST_EXPRESSION_TYPE_ASSIGNMENT: {
+            waitui_ast_assignment *assignment =
+                    (waitui_ast_assignment *) expression;
+            bench_walk_expression(walker,
+                                  waitui_ast_assignment_getValue(assignment));
+            bench_walk_resolve(walker, waitui_ast_assignment_getIdentifier(
+                                               assignment));
+            break;
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_REFERENCE:
+            bench_walk_resolve(walker,
+                               waitui_ast_reference_getValue(
+                                       (waitui_ast_reference *) expression));
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_CAST:
+            bench_walk_expression(walker,
+                                  waitui_ast_cast_getObject(
+                                          (waitui_ast_cast *) expression));
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_LET:
+            bench_walk_let(walker, (waitui_ast_let *) expression);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_BLOCK:
+            if (walker->symtable) { symboltable_enter_scope(walker->symtable); }
+            bench_walk_expressions(walker,
+                                   waitui_ast_block_getExpressions(
+                                           (waitui_ast_block *) expression));
+            if (walker->symtable) { symboltable_exit_scope(walker->symtable); }
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_CONSTRUCTOR_CALL:
+            bench_walk_expressions(
+                    walker, waitui_ast_constructor_call_getArgs(
+                                    (waitui_ast_constructor_call *) expression));
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_FUNCTION_CALL: {
+            waitui_ast_function_call *call =
+                    (waitui_ast_function_call *) expression;
+            bench_walk_expression(walker,
+                                  waitui_ast_function_call_getObject(call));
+            bench_walk_expressions(walker,
+                                   waitui_ast_function_call_getArgs(call));
+            break;
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_SUPER_FUNCTION_CALL:
+            bench_walk_expressions(
+                    walker,
+                    waitui_ast_super_function_call_getArgs(
+                            (waitui_ast_super_function_call *) expression));
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_BINARY_EXPRESSION: {
+            waitui_ast_binary_expression *binary =
+                    (waitui_ast_binary_expression *) expression;
+            bench_walk_expression(walker,
+                                  waitui_ast_binary_expression_getLeft(binary));
+            bench_walk_expression(
+                    walker, waitui_ast_binary_expression_getRight(binary));
+            break;
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_UNARY_EXPRESSION:
+            bench_walk_expression(
+                    walker, waitui_ast_unary_expression_getExpression(
+                                    (waitui_ast_unary_expression *) expression));
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_IF_ELSE: {
+            waitui_ast_if_else *ifElse = (waitui_ast_if_else *) expression;
+            bench_walk_expression(walker,
+                                  waitui_ast_if_else_getCondition(ifElse));
+            bench_walk_expression(walker,
+                                  waitui_ast_if_else_getThenBranch(ifElse));
+            bench_walk_expression(walker,
+                                  waitui_ast_if_else_getElseBranch(ifElse));
+            break;
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_WHILE: {
+            waitui_ast_while *whileNode = (waitui_ast_while *) expression;
+            bench_walk_expression(walker,
+                                  waitui_ast_while_getCondition(whileNode));
+            bench_walk_expression(walker, waitui_ast_while_getBody(whileNode));
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Walk the class with its members in its own scope.
+ * @param[in,out] walker The walker state
+ * @param[in] class The class to walk
+ */
+static void bench_walk_class(bench_walker *walker, waitui_ast_class *class) {
+    walker->nodes++;
+
+    if (walker->symtable) { symboltable_enter_scope(walker->symtable); }
+
+    bench_walk_formals(walker, waitui_ast_class_getParameters(class));
+    bench_walk_expressions(walker, waitui_ast_class_getSuperClassArgs(class));
+
+    WAITUI_VECTOR_FOREACH(waitui_ast_property, property,
+                          waitui_ast_class_getProperties(class)) {
+        walker->nodes++;
+        bench_walk_expression(walker, waitui_ast_property_getValue(property));
+        bench_walk_declare(walker, waitui_ast_property_getName(property));
+    }
+
+    WAITUI_VECTOR_FOREACH(waitui_ast_function, function,
+                          waitui_ast_class_getFunctions(class)) {
+        walker->nodes++;
+        if (walker->symtable) { symboltable_enter_scope(walker->symtable); }
+        bench_walk_formals(walker, waitui_ast_function_getParameters(function));
+        bench_walk_expression(walker, waitui_ast_function_getBody(function));
+        if (walker->symtable) { symboltable_exit_scope(walker->symtable); }
+    }
+
+    if (walker->symtable) { symboltable_exit_scope(walker->symtable); }
+}
+
+/**
+ * @brief Walk the whole AST.
+ * @param[in,out] walker The walker state
+ * @param[in] ast The AST to walk
+ */
+static void bench_walk_ast(bench_walker *walker, waitui_ast *ast) {
+    waitui_ast_program *program = NULL;
+
+    program = waitui_ast_getProgram(ast);
+    if (!program) { return; }
+
+    walker->nodes++;
+
+    WAITUI_VECTOR_FOREACH(waitui_ast_namespace, namespace,
+                          waitui_ast_program_getNamespaces(program)) {
+        walker->nodes++;
+
+        walker->nodes += waitui_ast_import_vector_getLength(
+                waitui_ast_namespace_getImports(namespace));
+
+        WAITUI_VECTOR_FOREACH(waitui_ast_class, class,
+                              waitui_ast_namespace_getClasses(namespace)) {
+            bench_walk_class(walker, class);
+        }
+    }
+}
+
+/**
+ * @brief Get the current time in nanoseconds.
+ * @return The time in nanoseconds
+ */
+static double bench_now(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double) now.tv_sec * 1e9 + (double) now.tv_nsec;
+}
+
+/**
+ * @brief Get the peak resident set size of the process.
+ * @return The peak resident set size in KiB
+ */
+static long int bench_peak_rss(void) {
+    struct rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) != 0) { return 0; }
+
+    return usage.ru_maxrss;
+}
+
+/**
+ * @brief Run the pipeline up to the stage of the mode once.
+ * @param[in] corpus The generated program to run
+ * @param[in] mode The last stage of the pipeline to run
+ * @param[out] walker The walker state after walking the AST, may be NULL
+ * @param[out] tokens The number of tokens in lex mode, may be NULL
+ * @param[in] graph Where and how to print the graph in full mode
+ * @retval 1 Ok
+ * @retval 0 Running the pipeline failed
+ */
+static int bench_run_once(const bench_corpus *corpus, bench_mode mode,
+                          bench_walker *walker, unsigned long int *tokens,
+                          const bench_graph *graph) {
+    parser *waituiParser  = NULL;
+    waitui_ast *waituiAst = NULL;
+    bench_walker state    = {0};
+    str workingDirectory  = STR_STATIC_INIT(".");
+    int result            = 0;
+
+    waituiParser = parser_new(corpus->fileName, workingDirectory,
+                              PARSER_DEBUG_NONE);
+    if (!waituiParser) { return 0; }
+
+    if (mode == BENCH_MODE_LEX) {
+        result = parser_lex(waituiParser, tokens);
+        goto done;
+    }
+
+    if (!parser_parse(waituiParser)) { goto done; }
+
+    waituiAst = parser_get_ast(waituiParser);
+    if (!waituiAst) { goto done; }
+
+    if (mode >= BENCH_MODE_SYMBOLTABLE) {
+        state.symtable = waituiParser->extraParser.symtable;
+    }
+    bench_walk_ast(&state, waituiAst);
+    if (walker) { *walker = state; }
+
+    parser_destroy(&waituiParser);
+
+    if (mode == BENCH_MODE_FULL) {
+        waitui_ast_printer_generateGraphParallel(waituiAst, graph->file,
+                                                 graph->threadpool);
+    }
+
+    result = 1;
+
+done:
+    parser_destroy(&waituiParser);
+    ast_destroy(&waituiAst);
+
+    return result;
+}
+
+/**
+ * @brief Run and report one benchmark mode.
+ * @param[in] corpus The generated program to run
+ * @param[in] mode The mode to run
+ * @param[in] repetitions How often the pipeline is run
+ * @param[in] graph Where and how to print the graph in full mode
+ * @retval 1 Ok
+ * @retval 0 Running the pipeline failed
+ */
+static int bench_run(const bench_corpus *corpus, bench_mode mode,
+                     unsigned long int repetitions, const bench_graph *graph) {
+    double start   = 0;
+    double seconds = 0;
+
+    start = bench_now();
+    for (unsigned long int i = 0; i < repetitions; ++i) {
+        if (!bench_run_once(corpus, mode, NULL, NULL, graph)) {
+            fprintf(stderr, "running %s failed\n", benchModeNames[mode]);
+            return 0;
+        }
+    }
+    seconds = (bench_now() - start) / 1e9;
+
+    printf("%-12s %10.2f %14.0f %14.0f %12ld\n", benchModeNames[mode],
+           (double) corpus->bytes * repetitions / seconds / (1024.0 * 1024.0),
+           (double) corpus->tokens * repetitions / seconds,
+           mode == BENCH_MODE_LEX
+                   ? 0.0
+                   : (double) corpus->nodes * repetitions / seconds,
+           bench_peak_rss());
+
+    return 1;
+}
+
+/**
+ * @brief Print the usage of the benchmark.
+ * @param[in] name The name of the program
+ */
+static void bench_usage(const char *name) {
+    fprintf(stderr,
+            "usage: %s [-c classes] [-f functions] [-d depth] "
+            "[-i identifiers] [-l literal%%] [-r repetitions] [-s seed] "
+            "[-m lex|parse|symboltable|full|all] [-o corpus.wai] "
+            "[-j threads]\n",
+            name);
+}
+
+
+// -----------------------------------------------------------------------------
+//  Main function
+// -----------------------------------------------------------------------------
+
+int main(int argc, char **argv) {
+    int result                    = BENCH_SUCCESS;
+    bench_shape shape             = {.classes        = 50,
+                                     .functions      = 10,
+                                     .depth          = 4,
+                                     .identifiers    = 64,
+                                     .literalDensity = 50,
+                                     .seed           = 42};
+    bench_mode mode               = BENCH_MODE_ALL;
+    bench_corpus corpus           = {0};
+    bench_walker walker           = {0};
+    unsigned long int repetitions = 5;
+    char tempFileName[]           = "/tmp/waitui-bench-XXXXXX";
+    const char *corpusFileName    = NULL;
+    FILE *corpusFile              = NULL;
+    bench_graph graph             = {0};
+    unsigned long int threads     = 1;
+    int option                    = 0;
+
+    while ((option = getopt(argc, argv, "c:f:d:i:l:r:s:m:o:j:")) != -1) {
+        switch (option) {
+            case 'c':
+                shape.classes = strtoul(optarg, NULL, 10);
+                break;
+            case 'f':
+                shape.functions = strtoul(optarg, NULL, 10);
+                break;
+            case 'd':
+                shape.depth = strtoul(optarg, NULL, 10);
+                break;
+            case 'i':
+                shape.identifiers = strtoul(optarg, NULL, 10);
+                break;
+            case 'l':
+                shape.literalDensity = strtoul(optarg, NULL, 10);
+                break;
+            case 'r':
+                repetitions = strtoul(optarg, NULL, 10);
+                break;
+            case 's':
+                shape.seed = strtoull(optarg, NULL, 10);
+                break;
+            case 'm':
+                for (mode = BENCH_MODE_LEX; mode < BENCH_MODE_ALL; ++mode) {
+                    if (strcmp(optarg, benchModeNames[mode]) == 0) { break; }
+                }
+                if (mode == BENCH_MODE_ALL &&
+                    strcmp(optarg, benchModeNames[mode]) != 0) {
+                    bench_usage(argv[0]);
+                    return BENCH_FAILURE;
+                }
+                break;
+            case 'o':
+                corpusFileName = optarg;
+                break;
+            case 'j':
+                threads = strtoul(optarg, NULL, 10);
+                break;
+            default:
+                bench_usage(argv[0]);
+                return BENCH_FAILURE;
+        }
+    }
+
+    if (shape.classes == 0 || shape.functions == 0 || shape.identifiers == 0 ||
+        shape.literalDensity > 100 || repetitions == 0) {
+        bench_usage(argv[0]);
+        return BENCH_FAILURE;
+    }
+
+    waitui_log_setLevel(WAITUI_LOG_FATAL);
+    waitui_log_setQuiet(true);
+
+    if (corpusFileName) {
+        corpusFile = fopen(corpusFileName, "w");
+    } else {
+        int fd = mkstemps(tempFileName, 0);
+        if (fd >= 0) { corpusFile = fdopen(fd, "w"); }
+        corpusFileName = tempFileName;
+    }
+    if (!corpusFile) {
+        fprintf(stderr, "could not create %s\n", corpusFileName);
+        return BENCH_FAILURE;
+    }
+
+    bench_generate_program(corpusFile, &shape);
+    corpus.bytes = (unsigned long int) ftell(corpusFile);
+    fclose(corpusFile);
+
+    corpus.fileName.s   = (char *) corpusFileName;
+    corpus.fileName.len = strlen(corpusFileName);
+
+    graph.file = fopen("/dev/null", "w");
+    if (!graph.file) {
+        result = BENCH_FAILURE;
+        goto done;
+    }
+
+    if (threads != 1) {
+        graph.threadpool = waitui_threadpool_new(threads);
+        if (!graph.threadpool) {
+            fprintf(stderr, "could not create the thread pool\n");
+            result = BENCH_FAILURE;
+            goto done;
+        }
+    }
+
+    if (!bench_run_once(&corpus, BENCH_MODE_LEX, NULL, &corpus.tokens, NULL) ||
+        !bench_run_once(&corpus, BENCH_MODE_SYMBOLTABLE, &walker, NULL,
+                        NULL)) {
+        fprintf(stderr, "the generated program could not be processed\n");
+        result = BENCH_FAILURE;
+        goto done;
+    }
+    corpus.nodes = walker.nodes;
+
+    printf("corpus: %lu bytes, %lu tokens, %lu nodes, %lu declared, "
+           "%lu resolved, %lu unresolved\n\n",
+           corpus.bytes, corpus.tokens, corpus.nodes, walker.declared,
+           walker.resolved, walker.unresolved);
+    printf("%-12s %10s %14s %14s %12s\n", "mode", "MB/s", "tokens/s",
+           "nodes/s", "peak RSS KiB");
+
+    for (bench_mode current = BENCH_MODE_LEX; current < BENCH_MODE_ALL;
+         ++current) {
+        if (mode != BENCH_MODE_ALL && mode != current) { continue; }
+
+        if (!bench_run(&corpus, current, repetitions, &graph)) {
+            result = BENCH_FAILURE;
+            goto done;
+        }
+    }
+
+done:
+    if (graph.file) { fclose(graph.file); }
+    waitui_threadpool_destroy(&graph.threadpool);
+    if (corpusFileName == tempFileName) { unlink(tempFileName); }
+
+    return result;
+}
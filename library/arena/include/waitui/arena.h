@@ -0,0 +1,83 @@
+/**
+ * @file arena.h
+ * @author rick
+ * @date 17.10.26
+ * @brief File for the Arena implementation
+ */
+
+#ifndef WAITUI_ARENA_H
+#define WAITUI_ARENA_H
+
+#include <waitui/str.h>
+
+#include <stddef.h>
+
+
+// -----------------------------------------------------------------------------
+//  Public types
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Type representing an Arena.
+ */
+typedef struct waitui_arena waitui_arena;
+
+/**
+ * @brief Type for cleanup functions run when the Arena gets destroyed.
+ */
+typedef void (*waitui_arena_cleanup)(void **data);
+
+
+// -----------------------------------------------------------------------------
+//  Public functions
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Create an Arena.
+ * @return A pointer to waitui_arena or NULL if memory allocation failed
+ */
+extern waitui_arena *waitui_arena_new(void);
+
+/**
+ * @brief Destroy an Arena and everything allocated from it.
+ * @param[in,out] this The Arena to destroy
+ * @note The registered cleanups are called in reverse order of registration
+ *       before the memory of the Arena is released.
+ */
+extern void waitui_arena_destroy(waitui_arena **this);
+
+/**
+ * @brief Allocate zeroed memory from the Arena.
+ * @param[in,out] this The Arena to allocate from
+ * @param[in] size The size of the memory to allocate
+ * @return A pointer to the memory or NULL if memory allocation failed
+ * @note The memory is suitably aligned for any type and is only released
+ *       together with the Arena.
+ */
+extern void *waitui_arena_alloc(waitui_arena *this, size_t size);
+
+/**
+ * @brief Copy the string into the Arena.
+ * @param[in,out] this The Arena to copy the string into
+ * @param[out] destination The str to store the copy in
+ * @param[in] source The str to copy
+ * @note The copy is NUL terminated.
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ */
+extern int waitui_arena_copyStr(waitui_arena *this, str *destination,
+                                const str *source);
+
+/**
+ * @brief Register a cleanup to be called when the Arena gets destroyed.
+ * @param[in,out] this The Arena to register the cleanup at
+ * @param[in] cleanupCallback The function to call on destruction
+ * @param[in] data The data to pass to the cleanupCallback
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ */
+extern int waitui_arena_addCleanup(waitui_arena *this,
+                                   waitui_arena_cleanup cleanupCallback,
+                                   void *data);
+
+#endif//WAITUI_ARENA_H
@@ -0,0 +1,216 @@
+/**
+ * @file arena.c
+ * @author rick
+ * @date 17.10.26
+ * @brief File for the Arena implementation
+ */
+
+#include "waitui/arena.h"
+
+#include <stdalign.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+// -----------------------------------------------------------------------------
+//  Local defines
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The size of the regular blocks the Arena allocates from.
+ */
+#define WAITUI_ARENA_BLOCK_SIZE (64 * 1024)
+
+/**
+ * @brief The alignment of every allocation of the Arena.
+ */
+#define WAITUI_ARENA_ALIGNMENT alignof(max_align_t)
+
+/**
+ * @brief Round the size up to the alignment of the Arena.
+ */
+#define WAITUI_ARENA_ALIGN(size)                                               \
+    (((size) + WAITUI_ARENA_ALIGNMENT - 1) & ~(WAITUI_ARENA_ALIGNMENT - 1))
+
+
+// -----------------------------------------------------------------------------
+//  Local types
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Type representing an Arena block.
+ */
+typedef struct waitui_arena_block waitui_arena_block;
+
+/**
+ * @brief Type representing an Arena cleanup entry.
+ */
+typedef struct waitui_arena_cleanup_entry waitui_arena_cleanup_entry;
+
+/**
+ * @brief Struct representing an Arena block.
+ */
+struct waitui_arena_block {
+    waitui_arena_block *next;
+    size_t size;
+    size_t used;
+    alignas(max_align_t) unsigned char data[];
+};
+
+/**
+ * @brief Struct representing an Arena cleanup entry.
+ */
+struct waitui_arena_cleanup_entry {
+    waitui_arena_cleanup cleanupCallback;
+    void *data;
+    waitui_arena_cleanup_entry *next;
+};
+
+/**
+ * @brief Struct representing an Arena.
+ */
+struct waitui_arena {
+    waitui_arena_block *current;
+    waitui_arena_block *full;
+    waitui_arena_cleanup_entry *cleanups;
+};
+
+
+// -----------------------------------------------------------------------------
+//  Local functions
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Create an Arena block.
+ * @param[in] size The usable size of the block
+ * @return A pointer to waitui_arena_block or NULL if memory allocation failed
+ * @note The blocks are allocated zeroed, so the memory handed out by the Arena
+ *       needs no clearing as it is never reused.
+ */
+static waitui_arena_block *waitui_arena_block_new(size_t size) {
+    waitui_arena_block *this = NULL;
+
+    this = calloc(1, sizeof(*this) + size);
+    if (!this) { return NULL; }
+
+    this->size = size;
+
+    return this;
+}
+
+/**
+ * @brief Destroy a chain of Arena blocks.
+ * @param[in,out] this The first Arena block of the chain to destroy
+ */
+static void waitui_arena_block_destroy(waitui_arena_block **this) {
+    if (!this) { return; }
+
+    while (*this) {
+        waitui_arena_block *temp = *this;
+        *this                    = (*this)->next;
+        free(temp);
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+//  Public functions
+// -----------------------------------------------------------------------------
+
+waitui_arena *waitui_arena_new(void) {
+    waitui_arena *this = NULL;
+
+    this = calloc(1, sizeof(*this));
+    if (!this) { return NULL; }
+
+    this->current = waitui_arena_block_new(WAITUI_ARENA_BLOCK_SIZE);
+    if (!this->current) {
+        free(this);
+        return NULL;
+    }
+
+    return this;
+}
+
+void waitui_arena_destroy(waitui_arena **this) {
+    if (!this || !(*this)) { return; }
+
+    for (waitui_arena_cleanup_entry *entry = (*this)->cleanups; entry;
+         entry                             = entry->next) {
+        entry->cleanupCallback(&entry->data);
+    }
+
+    waitui_arena_block_destroy(&(*this)->current);
+    waitui_arena_block_destroy(&(*this)->full);
+
+    free(*this);
+    *this = NULL;
+}
+
+void *waitui_arena_alloc(waitui_arena *this, size_t size) {
+    waitui_arena_block *block = NULL;
+    void *memory              = NULL;
+
+    if (!this || size == 0) { return NULL; }
+
+    size = WAITUI_ARENA_ALIGN(size);
+
+    if (size > WAITUI_ARENA_BLOCK_SIZE / 4) {
+        block = waitui_arena_block_new(size);
+        if (!block) { return NULL; }
+
+        block->used = size;
+        block->next = this->full;
+        this->full  = block;
+
+        return block->data;
+    }
+
+    if (this->current->size - this->current->used < size) {
+        block = waitui_arena_block_new(WAITUI_ARENA_BLOCK_SIZE);
+        if (!block) { return NULL; }
+
+        this->current->next = this->full;
+        this->full          = this->current;
+        this->current       = block;
+    }
+
+    memory = this->current->data + this->current->used;
+    this->current->used += size;
+
+    return memory;
+}
+
+int waitui_arena_copyStr(waitui_arena *this, str *destination,
+                         const str *source) {
+    char *s = NULL;
+
+    if (!this || !destination || !source) { return 0; }
+
+    s = waitui_arena_alloc(this, source->len + 1);
+    if (!s) { return 0; }
+
+    if (source->len) { memcpy(s, source->s, source->len); }
+
+    destination->s   = s;
+    destination->len = source->len;
+
+    return 1;
+}
+
+int waitui_arena_addCleanup(waitui_arena *this,
+                            waitui_arena_cleanup cleanupCallback, void *data) {
+    waitui_arena_cleanup_entry *entry = NULL;
+
+    if (!this || !cleanupCallback) { return 0; }
+
+    entry = waitui_arena_alloc(this, sizeof(*entry));
+    if (!entry) { return 0; }
+
+    entry->cleanupCallback = cleanupCallback;
+    entry->data            = data;
+    entry->next            = this->cleanups;
+    this->cleanups         = entry;
+
+    return 1;
+}
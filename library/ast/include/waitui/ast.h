@@ -52,6 +52,132 @@ typedef struct waitui_ast_callbacks {
     waitui_ast_node_callback postNodeCallback;
 } waitui_ast_callbacks;
 
+/**
+ * @brief The fields of the AST nodes per node kind.
+ * @note A field holds a node, a list of nodes, a symbol or a value. The
+ *       visitor only descends into the fields holding nodes. The binary AST
+ *       format stores the fields by these numbers, so they must not change.
+ */
+typedef enum waitui_ast_field {
+    WAITUI_AST_FIELD_PROGRAM_NAMESPACES                = 0,
+    WAITUI_AST_FIELD_NAMESPACE_NAME                    = 0,
+    WAITUI_AST_FIELD_NAMESPACE_IMPORTS                 = 1,
+    WAITUI_AST_FIELD_NAMESPACE_CLASSES                 = 2,
+    WAITUI_AST_FIELD_IMPORT_NAME                       = 0,
+    WAITUI_AST_FIELD_IMPORT_ALIAS                      = 1,
+    WAITUI_AST_FIELD_CLASS_NAME                        = 0,
+    WAITUI_AST_FIELD_CLASS_PARAMETERS                  = 1,
+    WAITUI_AST_FIELD_CLASS_SUPER_CLASS                 = 2,
+    WAITUI_AST_FIELD_CLASS_SUPER_CLASS_ARGS            = 3,
+    WAITUI_AST_FIELD_CLASS_PROPERTIES                  = 4,
+    WAITUI_AST_FIELD_CLASS_FUNCTIONS                   = 5,
+    WAITUI_AST_FIELD_FORMAL_IDENTIFIER                 = 0,
+    WAITUI_AST_FIELD_FORMAL_TYPE                       = 1,
+    WAITUI_AST_FIELD_PROPERTY_NAME                     = 0,
+    WAITUI_AST_FIELD_PROPERTY_TYPE                     = 1,
+    WAITUI_AST_FIELD_PROPERTY_VALUE                    = 2,
+    WAITUI_AST_FIELD_FUNCTION_NAME                     = 0,
+    WAITUI_AST_FIELD_FUNCTION_PARAMETERS               = 1,
+    WAITUI_AST_FIELD_FUNCTION_RETURN_TYPE              = 2,
+    WAITUI_AST_FIELD_FUNCTION_BODY                     = 3,
+    WAITUI_AST_FIELD_BLOCK_EXPRESSIONS                 = 0,
+    WAITUI_AST_FIELD_LET_INITIALIZATIONS               = 0,
+    WAITUI_AST_FIELD_LET_BODY                          = 1,
+    WAITUI_AST_FIELD_INITIALIZATION_IDENTIFIER         = 0,
+    WAITUI_AST_FIELD_INITIALIZATION_TYPE               = 1,
+    WAITUI_AST_FIELD_INITIALIZATION_VALUE              = 2,
+    WAITUI_AST_FIELD_ASSIGNMENT_IDENTIFIER             = 0,
+    WAITUI_AST_FIELD_ASSIGNMENT_VALUE                  = 1,
+    WAITUI_AST_FIELD_CAST_TYPE                         = 0,
+    WAITUI_AST_FIELD_CAST_OBJECT                       = 1,
+    WAITUI_AST_FIELD_IF_ELSE_CONDITION                 = 0,
+    WAITUI_AST_FIELD_IF_ELSE_THEN_BRANCH               = 1,
+    WAITUI_AST_FIELD_IF_ELSE_ELSE_BRANCH               = 2,
+    WAITUI_AST_FIELD_WHILE_CONDITION                   = 0,
+    WAITUI_AST_FIELD_WHILE_BODY                        = 1,
+    WAITUI_AST_FIELD_BINARY_EXPRESSION_LEFT            = 0,
+    WAITUI_AST_FIELD_BINARY_EXPRESSION_RIGHT           = 1,
+    WAITUI_AST_FIELD_UNARY_EXPRESSION_EXPRESSION       = 0,
+    WAITUI_AST_FIELD_LAZY_EXPRESSION_EXPRESSION        = 0,
+    WAITUI_AST_FIELD_CONSTRUCTOR_CALL_NAME             = 0,
+    WAITUI_AST_FIELD_CONSTRUCTOR_CALL_ARGS             = 1,
+    WAITUI_AST_FIELD_FUNCTION_CALL_OBJECT              = 0,
+    WAITUI_AST_FIELD_FUNCTION_CALL_FUNCTION_NAME       = 1,
+    WAITUI_AST_FIELD_FUNCTION_CALL_ARGS                = 2,
+    WAITUI_AST_FIELD_SUPER_FUNCTION_CALL_FUNCTION_NAME = 0,
+    WAITUI_AST_FIELD_SUPER_FUNCTION_CALL_ARGS          = 1,
+    WAITUI_AST_FIELD_REFERENCE_VALUE                   = 0,
+    WAITUI_AST_FIELD_LITERAL_VALUE                     = 0,
+} waitui_ast_field;
+
+/**
+ * @brief The order a node is visited in.
+ */
+typedef enum waitui_ast_visit_order {
+    WAITUI_AST_VISIT_ORDER_PRE,
+    WAITUI_AST_VISIT_ORDER_POST,
+} waitui_ast_visit_order;
+
+/**
+ * @brief The actions a visitor callback can ask for.
+ */
+typedef enum waitui_ast_visit_action {
+    WAITUI_AST_VISIT_ACTION_CONTINUE,
+    WAITUI_AST_VISIT_ACTION_SKIP,
+    WAITUI_AST_VISIT_ACTION_STOP,
+} waitui_ast_visit_action;
+
+/**
+ * @brief Type for a node visited by the AST visitor.
+ * @note The parent is NULL for the node the visit started at, else the field
+ *       is the field of the parent holding the node and, for a field holding a
+ *       list of nodes, the index is the position of the node in the list.
+ */
+typedef struct waitui_ast_visit {
+    waitui_ast_node *node;
+    waitui_ast_node *parent;
+    waitui_ast_field field;
+    unsigned long int index;
+    unsigned long int depth;
+    waitui_ast_visit_order order;
+} waitui_ast_visit;
+
+/**
+ * @brief Callback type for nodes visited by the AST visitor.
+ * @param[in] visit The visited node and where it is in the AST
+ * @param[in,out] args The extra argument for the callback
+ * @return What the AST visitor should do next, skipping is only possible in
+ *         pre order and skips the children of the node
+ */
+typedef waitui_ast_visit_action (*waitui_ast_visit_callback)(
+        const waitui_ast_visit *visit, void *args);
+
+/**
+ * @brief Type for AST visitor callbacks, either one may be NULL.
+ */
+typedef struct waitui_ast_visit_callbacks {
+    waitui_ast_visit_callback preVisitCallback;
+    waitui_ast_visit_callback postVisitCallback;
+} waitui_ast_visit_callbacks;
+
+/**
+ * @brief Callback type for the modules of waitui_ast_forEachModule.
+ * @param[in,out] module The AST of the module
+ * @param[in,out] args The extra argument for the callback
+ * @retval 1 Ok, continue with the next module
+ * @retval 0 Stop, waitui_ast_forEachModule fails
+ */
+typedef int (*waitui_ast_module_callback)(waitui_ast *module, void *args);
+
+/**
+ * @brief Type representing an AST visitor.
+ * @note The AST visitor walks the nodes with an explicit stack instead of
+ *       recursion, so the depth of the AST is only limited by memory. The stack
+ *       is kept between visits, so visiting many ASTs with one AST visitor
+ *       allocates only until the deepest AST was seen.
+ */
+typedef struct waitui_ast_visitor waitui_ast_visitor;
+
 
 // -----------------------------------------------------------------------------
 //  Public functions
@@ -59,14 +185,18 @@ typedef struct waitui_ast_callbacks {
 
 /**
  * @brief Create the AST.
+ * @param[in] arena The arena the nodes of the AST are allocated from
  * @param[in] program The program node for the AST
+ * @note On success the AST takes ownership of the arena.
  * @return On success a pointer to AST, else NULL
  */
-extern waitui_ast *waitui_ast_new(waitui_ast_program *program);
+extern waitui_ast *waitui_ast_new(waitui_arena *arena,
+                                  waitui_ast_program *program);
 
 /**
  * @brief Destroy the AST and its content.
  * @param[in,out] this The AST to destroy
+ * @note All nodes are released at once by destroying the arena of the AST.
  */
 extern void ast_destroy(waitui_ast **this);
 
@@ -77,13 +207,83 @@ extern void ast_destroy(waitui_ast **this);
  */
 extern waitui_ast_program *waitui_ast_getProgram(waitui_ast *this);
 
+/**
+ * @brief Get the arena the nodes of the AST are allocated from.
+ * @param[in] this The AST to get the arena from
+ * @return On success a pointer to waitui_arena, else NULL
+ */
+extern waitui_arena *waitui_ast_getArena(waitui_ast *this);
+
 /**
  * @brief Walk the AST with waitui_ast_callbacks and args.
  * @param[in,out] this The AST to walk
  * @param[in] callbacks The struct with the callbacks for the AST nodes.
  * @param[in] args The extra argument for the callbacks for the AST nodes
+ * @note Every node is walked, the pre node and node callbacks are called
+ *       before the children of the node and the post node callback after them.
  */
 extern void waitui_ast_walk(waitui_ast *this, waitui_ast_callbacks *callbacks,
                             void *args);
 
+/**
+ * @brief Call the callback for the AST and every module it imports.
+ * @param[in,out] this The AST to start at
+ * @param[in] callback The callback for the modules
+ * @param[in,out] args The extra argument for the callback
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed or the callback failed
+ * @note The imported modules are passed before the AST importing them and
+ *       every AST only once, even if it is imported many times.
+ */
+extern int waitui_ast_forEachModule(waitui_ast *this,
+                                    waitui_ast_module_callback callback,
+                                    void *args);
+
+/**
+ * @brief Replace the expression in the field of the parent node.
+ * @param[in,out] parent The node holding the expression
+ * @param[in] field The field of the parent holding the expression
+ * @param[in] index The position in the list, if the field holds a list
+ * @param[in] expression The expression to put in its place
+ * @retval 1 Ok
+ * @retval 0 The field of the parent does not hold expressions or the index is
+ *           out of range
+ * @note Together with the field and index of a waitui_ast_visit this rewrites
+ *       the AST during a visit. The replaced expression is not destroyed, so
+ *       it may still be part of the replacement.
+ */
+extern int waitui_ast_node_replaceChild(waitui_ast_node *parent,
+                                        waitui_ast_field field,
+                                        unsigned long int index,
+                                        waitui_ast_expression *expression);
+
+/**
+ * @brief Create an AST visitor.
+ * @return A pointer to waitui_ast_visitor or NULL if memory allocation failed
+ */
+extern waitui_ast_visitor *waitui_ast_visitor_new(void);
+
+/**
+ * @brief Destroy an AST visitor.
+ * @param[in,out] this The AST visitor to destroy
+ */
+extern void waitui_ast_visitor_destroy(waitui_ast_visitor **this);
+
+/**
+ * @brief Visit the node and all nodes below it.
+ * @param[in,out] this The AST visitor to visit with
+ * @param[in] node The node to start at
+ * @param[in] callbacks The callbacks for the visited nodes
+ * @param[in,out] args The extra argument for the callbacks
+ * @retval 1 Ok, also when a callback stopped the visit
+ * @retval 0 Memory allocation for the stack failed
+ * @note The children are visited in the order of their fields and lists. A
+ *       node skipped in pre order still gets its post order visit, a stop ends
+ *       the visit without any further callback.
+ */
+extern int waitui_ast_visitor_visit(waitui_ast_visitor *this,
+                                    waitui_ast_node *node,
+                                    const waitui_ast_visit_callbacks *callbacks,
+                                    void *args);
+
 #endif// WAITUI_AST_H
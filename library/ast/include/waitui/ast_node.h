@@ -8,9 +8,10 @@
 #ifndef WAITUI_AST_NODE_H
 #define WAITUI_AST_NODE_H
 
-#include <waitui/list.h>
+#include <waitui/arena.h>
 #include <waitui/str.h>
 #include <waitui/symbol.h>
+#include <waitui/vector.h>
 
 #include <stdbool.h>
 
@@ -75,6 +76,17 @@ typedef enum waitui_ast_expression_type {
  */
 typedef struct waitui_ast_node waitui_ast_node;
 
+/**
+ * @brief Type for the AST, see ast.h.
+ */
+typedef struct waitui_ast waitui_ast;
+
+/**
+ * @brief Type for the type of the value of an expression, see
+ *        type_checker.h.
+ */
+typedef struct waitui_type waitui_type;
+
 /**
  * @brief Callback type for executing actions on an AST node.
  */
@@ -239,6 +251,9 @@ typedef struct waitui_ast_lazy_expression waitui_ast_lazy_expression;
 
 /**
  * @brief Type representing a native expression.
+ * @note A native expression is the body of a function the embedding
+ *       application implements in C, it is bound by the qualified name of the
+ *       function, like Console.log, when the program is linked.
  */
 typedef struct waitui_ast_native_expression waitui_ast_native_expression;
 
@@ -292,14 +307,14 @@ typedef struct waitui_ast_null_literal waitui_ast_null_literal;
  */
 typedef struct waitui_ast_string_literal waitui_ast_string_literal;
 
-CREATE_LIST_TYPE(INTERFACE, waitui_ast_namespace)
-CREATE_LIST_TYPE(INTERFACE, waitui_ast_import)
-CREATE_LIST_TYPE(INTERFACE, waitui_ast_class)
-CREATE_LIST_TYPE(INTERFACE, waitui_ast_expression)
-CREATE_LIST_TYPE(INTERFACE, waitui_ast_formal)
-CREATE_LIST_TYPE(INTERFACE, waitui_ast_property)
-CREATE_LIST_TYPE(INTERFACE, waitui_ast_function)
-CREATE_LIST_TYPE(INTERFACE, waitui_ast_initialization)
+CREATE_VECTOR_TYPE(INTERFACE, waitui_ast_namespace)
+CREATE_VECTOR_TYPE(INTERFACE, waitui_ast_import)
+CREATE_VECTOR_TYPE(INTERFACE, waitui_ast_class)
+CREATE_VECTOR_TYPE(INTERFACE, waitui_ast_expression)
+CREATE_VECTOR_TYPE(INTERFACE, waitui_ast_formal)
+CREATE_VECTOR_TYPE(INTERFACE, waitui_ast_property)
+CREATE_VECTOR_TYPE(INTERFACE, waitui_ast_function)
+CREATE_VECTOR_TYPE(INTERFACE, waitui_ast_initialization)
 
 
 // -----------------------------------------------------------------------------
@@ -317,6 +332,8 @@ waitui_ast_node_getNodeType(const waitui_ast_node *this);
 /**
  * @brief Destroy a node from the AST.
  * @param[in,out] this The node to destroy
+ * @note The nodes live in the arena they were created in, so destroying a node
+ *       only resets the pointer, the memory is released with the arena.
  */
 extern void waitui_ast_node_destroy(waitui_ast_node **this);
 
@@ -342,6 +359,22 @@ extern void waitui_ast_definition_destroy(waitui_ast_definition **this);
 extern waitui_ast_expression_type
 waitui_ast_expression_getExpressionType(const waitui_ast_expression *this);
 
+/**
+ * @brief Return the type of the value of the expression.
+ * @param[in] this The expression to get the value type from
+ * @return The value type or NULL if the expression was not type checked
+ */
+extern const waitui_type *
+waitui_ast_expression_getValueType(const waitui_ast_expression *this);
+
+/**
+ * @brief Set the type of the value of the expression.
+ * @param[in,out] this The expression to set the value type for
+ * @param[in] valueType The value type to set for the expression
+ */
+extern void waitui_ast_expression_setValueType(waitui_ast_expression *this,
+                                               const waitui_type *valueType);
+
 /**
  * @brief Destroy a expression node from the AST.
  * @param[in,out] this The expression node to destroy
@@ -350,18 +383,20 @@ extern void waitui_ast_expression_destroy(waitui_ast_expression **this);
 
 /**
  * @brief Create a program node for the AST.
+ * @param[in,out] arena The arena to allocate the node from
  * @param[in] namespaces The list of namespaces for the program
  * @return On success a pointer to waitui_ast_program, else NULL
  */
 extern waitui_ast_program *
-waitui_ast_program_new(waitui_ast_namespace_list *namespaces);
+waitui_ast_program_new(waitui_arena *arena,
+                       waitui_ast_namespace_vector *namespaces);
 
 /**
  * @brief Return the namespaces for the program node.
  * @param[in] this The program node to get the namespaces from
- * @return A pointer to waitui_ast_namespace_list, else NULL
+ * @return A pointer to waitui_ast_namespace_vector, else NULL
  */
-extern waitui_ast_namespace_list *
+extern waitui_ast_namespace_vector *
 waitui_ast_program_getNamespaces(waitui_ast_program *this);
 
 /**
@@ -372,14 +407,16 @@ extern void waitui_ast_program_destroy(waitui_ast_program **this);
 
 /**
  * @brief Create a namespace node for the AST.
+ * @param[in,out] arena The arena to allocate the node from
  * @param[in] name The namespace name
  * @param[in] imports The list of imports for the namespace
  * @param[in] classes The list of classes for the namespace
  * @return On success a pointer to waitui_ast_namespace, else NULL
  */
 extern waitui_ast_namespace *
-waitui_ast_namespace_new(symbol *name, waitui_ast_import_list *imports,
-                         waitui_ast_class_list *classes);
+waitui_ast_namespace_new(waitui_arena *arena, symbol *name,
+                         waitui_ast_import_vector *imports,
+                         waitui_ast_class_vector *classes);
 
 /**
  * @brief Return the name for the namespace node.
@@ -391,17 +428,17 @@ extern symbol *waitui_ast_namespace_getName(waitui_ast_namespace *this);
 /**
  * @brief Return the imports for the namespace node.
  * @param[in] this The namespace node to get the imports from
- * @return A pointer to waitui_ast_import_list, else NULL
+ * @return A pointer to waitui_ast_import_vector, else NULL
  */
-extern waitui_ast_import_list *
+extern waitui_ast_import_vector *
 waitui_ast_namespace_getImports(waitui_ast_namespace *this);
 
 /**
  * @brief Return the classes for the namespace node.
  * @param[in] this The namespace node to get the classes from
- * @return A pointer to waitui_ast_class_list, else NULL
+ * @return A pointer to waitui_ast_class_vector, else NULL
  */
-extern waitui_ast_class_list *
+extern waitui_ast_class_vector *
 waitui_ast_namespace_getClasses(waitui_ast_namespace *this);
 
 /**
@@ -412,11 +449,13 @@ extern void waitui_ast_namespace_destroy(waitui_ast_namespace **this);
 
 /**
  * @brief Create a import node for the AST.
+ * @param[in,out] arena The arena to allocate the node from
  * @param[in] name The import name
  * @param[in] alias The import alias
  * @return On success a pointer to waitui_ast_import, else NULL
  */
-extern waitui_ast_import *waitui_ast_import_new(symbol *name, symbol *alias);
+extern waitui_ast_import *waitui_ast_import_new(waitui_arena *arena,
+                                                symbol *name, symbol *alias);
 
 /**
  * @brief Return the name for the import node.
@@ -432,6 +471,22 @@ extern symbol *waitui_ast_import_getName(waitui_ast_import *this);
  */
 extern symbol *waitui_ast_import_getAlias(waitui_ast_import *this);
 
+/**
+ * @brief Return the AST of the module the import node was resolved to.
+ * @param[in] this The import node to get the module from
+ * @return A pointer to waitui_ast, else NULL if the import is not resolved
+ */
+extern waitui_ast *waitui_ast_import_getModule(waitui_ast_import *this);
+
+/**
+ * @brief Set the AST of the module the import node was resolved to.
+ * @param[in,out] this The import node to set the module for
+ * @param[in] module The AST of the imported module
+ * @note The module AST is shared and not owned by the import node.
+ */
+extern void waitui_ast_import_setModule(waitui_ast_import *this,
+                                        waitui_ast *module);
+
 /**
  * @brief Destroy a import node and its content.
  * @param[in,out] this The import node to destroy
@@ -440,6 +495,7 @@ extern void waitui_ast_import_destroy(waitui_ast_import **this);
 
 /**
  * @brief Create a class node for the AST.
+ * @param[in,out] arena The arena to allocate the node from
  * @param[in] name The name of the class
  * @param[in] parameters The list of the formals for the class
  * @param[in] superClass The name of the super class
@@ -449,11 +505,11 @@ extern void waitui_ast_import_destroy(waitui_ast_import **this);
  * @return On success a pointer to waitui_ast_class, else NULL
  */
 extern waitui_ast_class *
-waitui_ast_class_new(symbol *name, waitui_ast_formal_list *parameters,
-                     symbol *superClass,
-                     waitui_ast_expression_list *superClassArgs,
-                     waitui_ast_property_list *properties,
-                     waitui_ast_function_list *functions);
+waitui_ast_class_new(waitui_arena *arena, symbol *name,
+                     waitui_ast_formal_vector *parameters, symbol *superClass,
+                     waitui_ast_expression_vector *superClassArgs,
+                     waitui_ast_property_vector *properties,
+                     waitui_ast_function_vector *functions);
 
 /**
  * @brief Return the name for the class node.
@@ -472,9 +528,9 @@ extern void waitui_ast_class_setName(waitui_ast_class *this, symbol *name);
 /**
  * @brief Return the parameters for the class node.
  * @param[in] this The class node to get the parameters from
- * @return A pointer to waitui_ast_formal_list, else NULL
+ * @return A pointer to waitui_ast_formal_vector, else NULL
  */
-extern waitui_ast_formal_list *
+extern waitui_ast_formal_vector *
 waitui_ast_class_getParameters(waitui_ast_class *this);
 
 /**
@@ -482,8 +538,9 @@ waitui_ast_class_getParameters(waitui_ast_class *this);
  * @param[in,out] this The class node to set the name
  * @param[in] parameters The parameters to set for the class node
  */
-extern void waitui_ast_class_setParameters(waitui_ast_class *this,
-                                           waitui_ast_formal_list *parameters);
+extern void
+waitui_ast_class_setParameters(waitui_ast_class *this,
+                               waitui_ast_formal_vector *parameters);
 
 /**
  * @brief Return the superClass for the class node.
@@ -503,9 +560,9 @@ extern void waitui_ast_class_setSuperClass(waitui_ast_class *this,
 /**
  * @brief Return the superClassArgs for the class node.
  * @param[in] this The class node to get the superClassArgs from
- * @return A pointer to waitui_ast_expression_list, else NULL
+ * @return A pointer to waitui_ast_expression_vector, else NULL
  */
-extern waitui_ast_expression_list *
+extern waitui_ast_expression_vector *
 waitui_ast_class_getSuperClassArgs(waitui_ast_class *this);
 
 /**
@@ -513,24 +570,23 @@ waitui_ast_class_getSuperClassArgs(waitui_ast_class *this);
  * @param[in,out] this The class node to set the name
  * @param[in] superClassArgs The super class args to set for the class node
  */
-extern void
-waitui_ast_class_setSuperClassArgs(waitui_ast_class *this,
-                                   waitui_ast_expression_list *superClassArgs);
+extern void waitui_ast_class_setSuperClassArgs(
+        waitui_ast_class *this, waitui_ast_expression_vector *superClassArgs);
 
 /**
  * @brief Return the properties for the class node.
  * @param[in] this The class node to get the properties from
- * @return A pointer to waitui_ast_property_list, else NULL
+ * @return A pointer to waitui_ast_property_vector, else NULL
  */
-extern waitui_ast_property_list *
+extern waitui_ast_property_vector *
 waitui_ast_class_getProperties(waitui_ast_class *this);
 
 /**
  * @brief Return the functions for the class node.
  * @param[in] this The class node to get the functions from
- * @return A pointer to waitui_ast_function_list, else NULL
+ * @return A pointer to waitui_ast_function_vector, else NULL
  */
-extern waitui_ast_function_list *
+extern waitui_ast_function_vector *
 waitui_ast_class_getFunctions(waitui_ast_class *this);
 
 /**
@@ -541,13 +597,15 @@ extern void waitui_ast_class_destroy(waitui_ast_class **this);
 
 /**
  * @brief Create a formal node for the AST.
+ * @param[in,out] arena The arena to allocate the node from
  * @param[in] identifier The name of the formal
  * @param[in] type The Type for the formal
  * @param[in] isLazy If this formal is a lazy one
  * @note Will steal the pointer for the identifier symbol.
  * @return On success a pointer to waitui_ast_formal, else NULL
  */
-extern waitui_ast_formal *waitui_ast_formal_new(symbol *identifier,
+extern waitui_ast_formal *waitui_ast_formal_new(waitui_arena *arena,
+                                                symbol *identifier,
                                                 symbol *type, bool isLazy);
 
 /**
@@ -580,6 +638,7 @@ extern void waitui_ast_formal_destroy(waitui_ast_formal **this);
 
 /**
  * @brief Create a function node for the AST.
+ * @param[in,out] arena The arena to allocate the node from
  * @param[in] functionName The name for the function
  * @param[in] parameters The list of the formals for the function
  * @param[in] returnType The return type for the function
@@ -591,9 +650,9 @@ extern void waitui_ast_formal_destroy(waitui_ast_formal **this);
  * @return On success a pointer to waitui_ast_function, else NULL
  */
 extern waitui_ast_function *
-waitui_ast_function_new(symbol *functionName,
-                        waitui_ast_formal_list *parameters, symbol *returnType,
-                        waitui_ast_expression *body,
+waitui_ast_function_new(waitui_arena *arena, symbol *functionName,
+                        waitui_ast_formal_vector *parameters,
+                        symbol *returnType, waitui_ast_expression *body,
                         waitui_ast_function_visibility visibility,
                         bool isAbstract, bool isFinal, bool isOverwrite);
 
@@ -609,7 +668,7 @@ extern symbol *waitui_ast_function_getFunctionName(waitui_ast_function *this);
  * @param[in] this The function node to get the parameters from
  * @return A pointer to symbol, else NULL
  */
-extern waitui_ast_formal_list *
+extern waitui_ast_formal_vector *
 waitui_ast_function_getParameters(waitui_ast_function *this);
 
 /**
@@ -708,13 +767,14 @@ extern void waitui_ast_function_destroy(waitui_ast_function **this);
 
 /**
  * @brief Create a property node for the AST.
+ * @param[in,out] arena The arena to allocate the node from
  * @param[in] name The name of the property
  * @param[in] type The type of the property
  * @param[in] value The value of the property
  * @return On success a pointer to waitui_ast_function, else NULL
  */
 extern waitui_ast_property *
-waitui_ast_property_new(symbol *name, symbol *type,
+waitui_ast_property_new(waitui_arena *arena, symbol *name, symbol *type,
                         waitui_ast_expression *value);
 
 /**
@@ -739,6 +799,15 @@ extern symbol *waitui_ast_property_getType(waitui_ast_property *this);
 extern waitui_ast_expression *
 waitui_ast_property_getValue(waitui_ast_property *this);
 
+/**
+ * @brief Set the value for the property node for the AST.
+ * @param[in,out] this The property node to set the value
+ * @param[in] value The value for the property
+ * @note The previous value is not destroyed.
+ */
+extern void waitui_ast_property_setValue(waitui_ast_property *this,
+                                         waitui_ast_expression *value);
+
 /**
  * @brief Destroy a property node and its content.
  * @param[in,out] this The property node to destroy
@@ -747,18 +816,20 @@ extern void waitui_ast_property_destroy(waitui_ast_property **this);
 
 /**
  * @brief Create a block node for the AST.
+ * @param[in,out] arena The arena to allocate the node from
  * @param[in] expressions The list of the expressions for the block
  * @return On success a pointer to waitui_ast_block, else NULL
  */
 extern waitui_ast_block *
-waitui_ast_block_new(waitui_ast_expression_list *expressions);
+waitui_ast_block_new(waitui_arena *arena,
+                     waitui_ast_expression_vector *expressions);
 
 /**
  * @brief Return the expressions for the block node.
  * @param[in] this The block node to get the expressions from
- * @return A pointer to waitui_ast_expression_list, else NULL
+ * @return A pointer to waitui_ast_expression_vector, else NULL
  */
-extern waitui_ast_expression_list *
+extern waitui_ast_expression_vector *
 waitui_ast_block_getExpressions(waitui_ast_block *this);
 
 /**
@@ -769,20 +840,22 @@ extern void waitui_ast_block_destroy(waitui_ast_block **this);
 
 /**
  * @brief Create a let node for the AST.
+ * @param[in,out] arena The arena to allocate the node from
  * @param[in] initializations The list of the initializations for the let
  * @param[in] body The body for the let
  * @return On success a pointer to waitui_ast_let, else NULL
  */
 extern waitui_ast_let *
-waitui_ast_let_new(waitui_ast_initialization_list *initializations,
+waitui_ast_let_new(waitui_arena *arena,
+                   waitui_ast_initialization_vector *initializations,
                    waitui_ast_expression *body);
 
 /**
  * @brief Return the initializations for the let node.
  * @param[in] this The let node to get the initializations from
- * @return A pointer to waitui_ast_initialization_list, else NULL
+ * @return A pointer to waitui_ast_initialization_vector, else NULL
  */
-extern waitui_ast_initialization_list *
+extern waitui_ast_initialization_vector *
 waitui_ast_let_getInitializations(waitui_ast_let *this);
 
 /**
@@ -792,6 +865,15 @@ waitui_ast_let_getInitializations(waitui_ast_let *this);
  */
 extern waitui_ast_expression *waitui_ast_let_getBody(waitui_ast_let *this);
 
+/**
+ * @brief Set the body for the let node for the AST.
+ * @param[in,out] this The let node to set the body
+ * @param[in] body The body for the let
+ * @note The previous body is not destroyed.
+ */
+extern void waitui_ast_let_setBody(waitui_ast_let *this,
+                                   waitui_ast_expression *body);
+
 /**
  * @brief Destroy a let node and its content.
  * @param[in,out] this The let node to destroy
@@ -800,14 +882,15 @@ extern void waitui_ast_let_destroy(waitui_ast_let **this);
 
 /**
  * @brief Create an initialization node for the AST.
+ * @param[in,out] arena The arena to allocate the node from
  * @param[in] identifier The identifier of the initialization
  * @param[in] type The type of the initialization
  * @param[in] value The value of the initialization
  * @return On success a pointer to waitui_ast_initialization, else NULL
  */
 extern waitui_ast_initialization *
-waitui_ast_initialization_new(symbol *identifier, symbol *type,
-                              waitui_ast_expression *value);
+waitui_ast_initialization_new(waitui_arena *arena, symbol *identifier,
+                              symbol *type, waitui_ast_expression *value);
 
 /**
  * @brief Get the identifier for the initialization node for the AST.
@@ -833,6 +916,15 @@ waitui_ast_initialization_getType(waitui_ast_initialization *this);
 extern waitui_ast_expression *
 waitui_ast_initialization_getValue(waitui_ast_initialization *this);
 
+/**
+ * @brief Set the value for the initialization node for the AST.
+ * @param[in,out] this The initialization node to set the value
+ * @param[in] value The value for the initialization
+ * @note The previous value is not destroyed.
+ */
+extern void waitui_ast_initialization_setValue(waitui_ast_initialization *this,
+                                               waitui_ast_expression *value);
+
 /**
  * @brief Destroy an initialization node and its content.
  * @param[in,out] this The initialization node to destroy
@@ -841,13 +933,14 @@ extern void waitui_ast_initialization_destroy(waitui_ast_initialization **this);
 
 /**
  * @brief Create an assignment node for the AST.
+ * @param[in,out] arena The arena to allocate the node from
  * @param[in] identifier The identifier of the assignment
  * @param[in] operator The operator of the assignment
  * @param[in] value The value of the assignment
  * @return On success a pointer to waitui_ast_assignment, else NULL
  */
 extern waitui_ast_assignment *
-waitui_ast_assignment_new(symbol *identifier,
+waitui_ast_assignment_new(waitui_arena *arena, symbol *identifier,
                           waitui_ast_assignment_operator operator,
                           waitui_ast_expression * value);
 
@@ -874,6 +967,15 @@ waitui_ast_assignment_getOperator(waitui_ast_assignment *this);
 extern waitui_ast_expression *
 waitui_ast_assignment_getValue(waitui_ast_assignment *this);
 
+/**
+ * @brief Set the value for the assignment node for the AST.
+ * @param[in,out] this The assignment node to set the value
+ * @param[in] value The value for the assignment
+ * @note The previous value is not destroyed.
+ */
+extern void waitui_ast_assignment_setValue(waitui_ast_assignment *this,
+                                           waitui_ast_expression *value);
+
 /**
  * @brief Destroy an assignment node and its content.
  * @param[in,out] this The assignment node to destroy
@@ -882,11 +984,13 @@ extern void waitui_ast_assignment_destroy(waitui_ast_assignment **this);
 
 /**
  * @brief Create a cast node for the AST.
+ * @param[in,out] arena The arena to allocate the node from
  * @param[in] object The object of the cast
  * @param[in] type The type of the cast
  * @return On success a pointer to waitui_ast_cast, else NULL
  */
-extern waitui_ast_cast *waitui_ast_cast_new(waitui_ast_expression *object,
+extern waitui_ast_cast *waitui_ast_cast_new(waitui_arena *arena,
+                                            waitui_ast_expression *object,
                                             symbol *type);
 
 /**
@@ -896,6 +1000,15 @@ extern waitui_ast_cast *waitui_ast_cast_new(waitui_ast_expression *object,
  */
 extern waitui_ast_expression *waitui_ast_cast_getObject(waitui_ast_cast *this);
 
+/**
+ * @brief Set the object for the cast node for the AST.
+ * @param[in,out] this The cast node to set the object
+ * @param[in] object The object for the cast
+ * @note The previous object is not destroyed.
+ */
+extern void waitui_ast_cast_setObject(waitui_ast_cast *this,
+                                      waitui_ast_expression *object);
+
 /**
  * @brief Get the type for the cast node for the AST.
  * @param[in] this The cast node to get the type from
@@ -911,13 +1024,14 @@ extern void waitui_ast_cast_destroy(waitui_ast_cast **this);
 
 /**
  * @brief Create a if_else node for the AST.
+ * @param[in,out] arena The arena to allocate the node from
  * @param[in] condition The condition for the if_else node
  * @param thenBranch The thenBranch for the if_else node
  * @param elseBranch The elseBranch for the if_else node or NULL
  * @return On success a pointer to waitui_ast_if_else, else NULL
  */
 extern waitui_ast_if_else *
-waitui_ast_if_else_new(waitui_ast_expression *condition,
+waitui_ast_if_else_new(waitui_arena *arena, waitui_ast_expression *condition,
                        waitui_ast_expression *thenBranch,
                        waitui_ast_expression *elseBranch);
 
@@ -929,6 +1043,15 @@ waitui_ast_if_else_new(waitui_ast_expression *condition,
 extern waitui_ast_expression *
 waitui_ast_if_else_getCondition(waitui_ast_if_else *this);
 
+/**
+ * @brief Set the condition expression for the if else node for the AST.
+ * @param[in,out] this The if else node to set the condition expression
+ * @param[in] condition The condition expression for the if else
+ * @note The previous condition expression is not destroyed.
+ */
+extern void waitui_ast_if_else_setCondition(waitui_ast_if_else *this,
+                                            waitui_ast_expression *condition);
+
 /**
  * @brief Get the then expression for the if else node for the AST.
  * @param[in] this The if else node to get the then expression from
@@ -937,6 +1060,15 @@ waitui_ast_if_else_getCondition(waitui_ast_if_else *this);
 extern waitui_ast_expression *
 waitui_ast_if_else_getThenBranch(waitui_ast_if_else *this);
 
+/**
+ * @brief Set the then expression for the if else node for the AST.
+ * @param[in,out] this The if else node to set the then expression
+ * @param[in] thenBranch The then expression for the if else
+ * @note The previous then expression is not destroyed.
+ */
+extern void waitui_ast_if_else_setThenBranch(waitui_ast_if_else *this,
+                                             waitui_ast_expression *thenBranch);
+
 /**
  * @brief Get the else expression for the if else node for the AST.
  * @param[in] this The if else node to get the else expression from
@@ -945,6 +1077,15 @@ waitui_ast_if_else_getThenBranch(waitui_ast_if_else *this);
 extern waitui_ast_expression *
 waitui_ast_if_else_getElseBranch(waitui_ast_if_else *this);
 
+/**
+ * @brief Set the else expression for the if else node for the AST.
+ * @param[in,out] this The if else node to set the else expression
+ * @param[in] elseBranch The else expression for the if else
+ * @note The previous else expression is not destroyed.
+ */
+extern void waitui_ast_if_else_setElseBranch(waitui_ast_if_else *this,
+                                             waitui_ast_expression *elseBranch);
+
 /**
  * @brief Destroy a if_else node and its content.
  * @param[in,out] this The if_else node to destroy
@@ -953,11 +1094,13 @@ extern void waitui_ast_if_else_destroy(waitui_ast_if_else **this);
 
 /**
  * @brief Create a while node for the AST.
+ * @param[in,out] arena The arena to allocate the node from
  * @param[in] condition The condition for the while node
  * @param[in] body The body for the while node
  * @return On success a pointer to waitui_ast_while, else NULL
  */
-extern waitui_ast_while *waitui_ast_while_new(waitui_ast_expression *condition,
+extern waitui_ast_while *waitui_ast_while_new(waitui_arena *arena,
+                                              waitui_ast_expression *condition,
                                               waitui_ast_expression *body);
 
 /**
@@ -968,6 +1111,15 @@ extern waitui_ast_while *waitui_ast_while_new(waitui_ast_expression *condition,
 extern waitui_ast_expression *
 waitui_ast_while_getCondition(waitui_ast_while *this);
 
+/**
+ * @brief Set the condition expression for the while node for the AST.
+ * @param[in,out] this The while node to set the condition expression
+ * @param[in] condition The condition expression for the while
+ * @note The previous condition expression is not destroyed.
+ */
+extern void waitui_ast_while_setCondition(waitui_ast_while *this,
+                                          waitui_ast_expression *condition);
+
 /**
  * @brief Get the body for the while node for the AST.
  * @param[in] this The while node to get the body from
@@ -975,6 +1127,15 @@ waitui_ast_while_getCondition(waitui_ast_while *this);
  */
 extern waitui_ast_expression *waitui_ast_while_getBody(waitui_ast_while *this);
 
+/**
+ * @brief Set the body for the while node for the AST.
+ * @param[in,out] this The while node to set the body
+ * @param[in] body The body for the while
+ * @note The previous body is not destroyed.
+ */
+extern void waitui_ast_while_setBody(waitui_ast_while *this,
+                                     waitui_ast_expression *body);
+
 /**
  * @brief Destroy a while node and its content.
  * @param[in,out] this The while node to destroy
@@ -983,13 +1144,15 @@ extern void waitui_ast_while_destroy(waitui_ast_while **this);
 
 /**
  * @brief Create a binary expression node for the AST.
+ * @param[in,out] arena The arena to allocate the node from
  * @param[in] left The left expression to use for the binary expression node
  * @param[in] operator The operator to use for the binary expression node
  * @param[in] right The right expression to use for the binary expression node
  * @return On success a pointer to waitui_ast_binary_expression, else NULL
  */
 extern waitui_ast_binary_expression *
-waitui_ast_binary_expression_new(waitui_ast_expression *left,
+waitui_ast_binary_expression_new(waitui_arena *arena,
+                                 waitui_ast_expression *left,
                                  waitui_ast_binary_operator operator,
                                  waitui_ast_expression * right);
 
@@ -1001,6 +1164,16 @@ waitui_ast_binary_expression_new(waitui_ast_expression *left,
 extern waitui_ast_expression *
 waitui_ast_binary_expression_getLeft(waitui_ast_binary_expression *this);
 
+/**
+ * @brief Set the left expression for the binary expression node for the AST.
+ * @param[in,out] this The binary expression node to set the left expression
+ * @param[in] left The left expression for the binary expression
+ * @note The previous left expression is not destroyed.
+ */
+extern void
+waitui_ast_binary_expression_setLeft(waitui_ast_binary_expression *this,
+                                     waitui_ast_expression *left);
+
 /**
  * @brief Get the binary operator for the binary expression node for the AST.
  * @param[in] this The binary expression node to get the right expression from
@@ -1017,6 +1190,16 @@ waitui_ast_binary_expression_getOperator(waitui_ast_binary_expression *this);
 extern waitui_ast_expression *
 waitui_ast_binary_expression_getRight(waitui_ast_binary_expression *this);
 
+/**
+ * @brief Set the right expression for the binary expression node for the AST.
+ * @param[in,out] this The binary expression node to set the right expression
+ * @param[in] right The right expression for the binary expression
+ * @note The previous right expression is not destroyed.
+ */
+extern void
+waitui_ast_binary_expression_setRight(waitui_ast_binary_expression *this,
+                                      waitui_ast_expression *right);
+
 /**
  * @brief Destroy a binary expression node and its content.
  * @param[in,out] this The binary expression node to destroy
@@ -1026,13 +1209,15 @@ waitui_ast_binary_expression_destroy(waitui_ast_binary_expression **this);
 
 /**
  * @brief Create a unary expression node for the AST.
+ * @param[in,out] arena The arena to allocate the node from
  * @param[in] operator The operator to use for the unary expression node
  * @param[in] expression The expression to use for the unary expression node
  * @return On success a pointer to waitui_ast_unary_expression, else NULL
  */
 extern waitui_ast_unary_expression *
-        waitui_ast_unary_expression_new(waitui_ast_unary_operator operator,
-                                        waitui_ast_expression * expression);
+waitui_ast_unary_expression_new(waitui_arena *arena,
+                                waitui_ast_unary_operator operator,
+                                waitui_ast_expression * expression);
 
 /**
  * @brief Get the unary operator for the unary expression node for the AST.
@@ -1050,6 +1235,16 @@ waitui_ast_unary_expression_getOperator(waitui_ast_unary_expression *this);
 extern waitui_ast_expression *
 waitui_ast_unary_expression_getExpression(waitui_ast_unary_expression *this);
 
+/**
+ * @brief Set the expression for the unary expression node for the AST.
+ * @param[in,out] this The unary expression node to set the expression
+ * @param[in] expression The expression for the unary expression
+ * @note The previous expression is not destroyed.
+ */
+extern void
+waitui_ast_unary_expression_setExpression(waitui_ast_unary_expression *this,
+                                          waitui_ast_expression *expression);
+
 /**
  * @brief Destroy a unary expression node and its content.
  * @param[in,out] this The unary expression node to destroy
@@ -1058,45 +1253,67 @@ extern void
 waitui_ast_unary_expression_destroy(waitui_ast_unary_expression **this);
 
 /**
- * @brief TODO
- * @param expression TODO
- * @param context TODO
- * @return TODO
+ * @brief Create a lazy expression node for the AST.
+ * @param[in,out] arena The arena to allocate the node from
+ * @param[in] expression The expression to use for the lazy expression node
+ * @param[in] context The context of the lazy expression, not interpreted yet
+ * @return On success a pointer to waitui_ast_lazy_expression, else NULL
  */
 extern waitui_ast_lazy_expression *
-waitui_ast_lazy_expression_new(waitui_ast_expression *expression,
+waitui_ast_lazy_expression_new(waitui_arena *arena,
+                               waitui_ast_expression *expression,
                                void *context);
 
 /**
- * @brief TODO
- * @param this TODO
+ * @brief Get the expression of the lazy expression node for the AST.
+ * @param[in] this The lazy expression node to get the expression from
+ * @return A pointer to waitui_ast_expression, else NULL
+ */
+extern waitui_ast_expression *
+waitui_ast_lazy_expression_getExpression(waitui_ast_lazy_expression *this);
+
+/**
+ * @brief Set the expression for the lazy expression node for the AST.
+ * @param[in,out] this The lazy expression node to set the expression
+ * @param[in] expression The expression for the lazy expression
+ * @note The previous expression is not destroyed.
+ */
+extern void
+waitui_ast_lazy_expression_setExpression(waitui_ast_lazy_expression *this,
+                                         waitui_ast_expression *expression);
+
+/**
+ * @brief Destroy a lazy expression node and its content.
+ * @param[in,out] this The lazy expression node to destroy
  */
 extern void
 waitui_ast_lazy_expression_destroy(waitui_ast_lazy_expression **this);
 
 /**
- * @brief TODO
- * @param func TODO
- * @return TODO
+ * @brief Create a native expression node for the AST.
+ * @param[in,out] arena The arena to allocate the node from
+ * @return On success a pointer to waitui_ast_native_expression, else NULL
  */
 extern waitui_ast_native_expression *
-waitui_ast_native_expression_new(void *func);
+waitui_ast_native_expression_new(waitui_arena *arena);
 
 /**
- * @brief TODO
- * @param this TODO
+ * @brief Destroy a native expression node.
+ * @param[in,out] this The native expression node to destroy
  */
 extern void
 waitui_ast_native_expression_destroy(waitui_ast_native_expression **this);
 
 /**
  * @brief Create a constructor call node for the AST.
+ * @param[in,out] arena The arena to allocate the node from
  * @param[in] name The name to use for the constructor call node
  * @param[in] args The args to use for the constructor call node
  * @return On success a pointer to waitui_ast_constructor_call, else NULL
  */
 extern waitui_ast_constructor_call *
-waitui_ast_constructor_call_new(symbol *name, waitui_ast_expression_list *args);
+waitui_ast_constructor_call_new(waitui_arena *arena, symbol *name,
+                                waitui_ast_expression_vector *args);
 
 /**
  * @brief Get the functionName for the constructor call node for the AST.
@@ -1109,9 +1326,9 @@ waitui_ast_constructor_call_getName(waitui_ast_constructor_call *this);
 /**
  * @brief Get the args for the constructor call node for the AST.
  * @param[in] this The constructor call node to get the args from
- * @return A pointer to waitui_ast_expression_list, else NULL
+ * @return A pointer to waitui_ast_expression_vector, else NULL
  */
-extern waitui_ast_expression_list *
+extern waitui_ast_expression_vector *
 waitui_ast_constructor_call_getArgs(waitui_ast_constructor_call *this);
 
 /**
@@ -1123,15 +1340,16 @@ waitui_ast_constructor_call_destroy(waitui_ast_constructor_call **this);
 
 /**
  * @brief Create a function call node for the AST.
+ * @param[in,out] arena The arena to allocate the node from
  * @param[in] object The object to use for the function call node
  * @param[in] functionName The functionName to use for the function call node
  * @param[in] args The args to use for the function call node
  * @return On success a pointer to waitui_ast_function_call, else NULL
  */
 extern waitui_ast_function_call *
-waitui_ast_function_call_new(waitui_ast_expression *object,
+waitui_ast_function_call_new(waitui_arena *arena, waitui_ast_expression *object,
                              symbol *functionName,
-                             waitui_ast_expression_list *args);
+                             waitui_ast_expression_vector *args);
 
 /**
  * @brief Get the object for the function call node for the AST.
@@ -1141,6 +1359,15 @@ waitui_ast_function_call_new(waitui_ast_expression *object,
 extern waitui_ast_expression *
 waitui_ast_function_call_getObject(waitui_ast_function_call *this);
 
+/**
+ * @brief Set the object for the function call node for the AST.
+ * @param[in,out] this The function call node to set the object
+ * @param[in] object The object for the function call
+ * @note The previous object is not destroyed.
+ */
+extern void waitui_ast_function_call_setObject(waitui_ast_function_call *this,
+                                               waitui_ast_expression *object);
+
 /**
  * @brief Get the functionName for the function call node for the AST.
  * @param[in] this The function call node to get the functionName from
@@ -1152,9 +1379,9 @@ waitui_ast_function_call_getFunctionName(waitui_ast_function_call *this);
 /**
  * @brief Get the args for the function call node for the AST.
  * @param[in] this The function call node to get the args from
- * @return A pointer to waitui_ast_expression_list, else NULL
+ * @return A pointer to waitui_ast_expression_vector, else NULL
  */
-extern waitui_ast_expression_list *
+extern waitui_ast_expression_vector *
 waitui_ast_function_call_getArgs(waitui_ast_function_call *this);
 
 /**
@@ -1165,13 +1392,14 @@ extern void waitui_ast_function_call_destroy(waitui_ast_function_call **this);
 
 /**
  * @brief Create a super function call node for the AST.
+ * @param[in,out] arena The arena to allocate the node from
  * @param[in] functionName The functionName to use for the super function call node
  * @param[in] args The args to use for the super function call node
  * @return On success a pointer to waitui_ast_super_function_call, else NULL
  */
 extern waitui_ast_super_function_call *
-waitui_ast_super_function_call_new(symbol *functionName,
-                                   waitui_ast_expression_list *args);
+waitui_ast_super_function_call_new(waitui_arena *arena, symbol *functionName,
+                                   waitui_ast_expression_vector *args);
 
 /**
  * @brief Get the functionName for the super function call node for the AST.
@@ -1184,9 +1412,9 @@ extern symbol *waitui_ast_super_function_call_getFunctionName(
 /**
  * @brief Get the args for the super function call node for the AST.
  * @param[in] this The super function call node to get the args from
- * @return A pointer to waitui_ast_expression_list, else NULL
+ * @return A pointer to waitui_ast_expression_vector, else NULL
  */
-extern waitui_ast_expression_list *
+extern waitui_ast_expression_vector *
 waitui_ast_super_function_call_getArgs(waitui_ast_super_function_call *this);
 
 /**
@@ -1198,10 +1426,12 @@ waitui_ast_super_function_call_destroy(waitui_ast_super_function_call **this);
 
 /**
  * @brief Create a reference node for the AST.
+ * @param[in,out] arena The arena to allocate the node from
  * @param[in] value The value to use for the reference node
  * @return On success a pointer to waitui_ast_reference, else NULL
  */
-extern waitui_ast_reference *waitui_ast_reference_new(symbol *value);
+extern waitui_ast_reference *waitui_ast_reference_new(waitui_arena *arena,
+                                                      symbol *value);
 
 /**
  * @brief Return the value for the reference node.
@@ -1218,9 +1448,11 @@ extern void waitui_ast_reference_destroy(waitui_ast_reference **this);
 
 /**
  * @brief Create a this literal node for the AST.
+ * @param[in,out] arena The arena to allocate the node from
  * @return On success a pointer to waitui_ast_this_literal, else NULL
  */
-extern waitui_ast_this_literal *waitui_ast_this_literal_new(void);
+extern waitui_ast_this_literal *
+waitui_ast_this_literal_new(waitui_arena *arena);
 
 /**
  * @brief Destroy a this literal node and its content.
@@ -1230,10 +1462,13 @@ extern void waitui_ast_this_literal_destroy(waitui_ast_this_literal **this);
 
 /**
  * @brief Create a integer literal node for the AST.
+ * @param[in,out] arena The arena to allocate the node from
  * @param[in] value The value for the integer literal node
+ * @note The value is not copied, it has to live as long as the arena.
  * @return On success a pointer to waitui_ast_integer_literal, else NULL
  */
-extern waitui_ast_integer_literal *waitui_ast_integer_literal_new(str value);
+extern waitui_ast_integer_literal *
+waitui_ast_integer_literal_new(waitui_arena *arena, str value);
 
 /**
  * @brief Return the value for the integer literal node.
@@ -1252,10 +1487,12 @@ waitui_ast_integer_literal_destroy(waitui_ast_integer_literal **this);
 
 /**
  * @brief Create a boolean literal node for the AST.
+ * @param[in,out] arena The arena to allocate the node from
  * @param[in] value The value for the boolean literal node
  * @return On success a pointer to waitui_ast_boolean_literal, else NULL
  */
-extern waitui_ast_boolean_literal *waitui_ast_boolean_literal_new(bool value);
+extern waitui_ast_boolean_literal *
+waitui_ast_boolean_literal_new(waitui_arena *arena, bool value);
 
 /**
  * @brief Return the value for the boolean literal node.
@@ -1274,10 +1511,13 @@ waitui_ast_boolean_literal_destroy(waitui_ast_boolean_literal **this);
 
 /**
  * @brief Create a decimal literal node for the AST.
+ * @param[in,out] arena The arena to allocate the node from
  * @param[in] value The value for the decimal literal node
+ * @note The value is not copied, it has to live as long as the arena.
  * @return On success a pointer to waitui_ast_decimal_literal, else NULL
  */
-extern waitui_ast_decimal_literal *waitui_ast_decimal_literal_new(str value);
+extern waitui_ast_decimal_literal *
+waitui_ast_decimal_literal_new(waitui_arena *arena, str value);
 
 /**
  * @brief Return the value for the decimal literal node.
@@ -1296,9 +1536,11 @@ waitui_ast_decimal_literal_destroy(waitui_ast_decimal_literal **this);
 
 /**
  * @brief Create a null literal node for the AST.
+ * @param[in,out] arena The arena to allocate the node from
  * @return On success a pointer to waitui_ast_null_literal, else NULL
  */
-extern waitui_ast_null_literal *waitui_ast_null_literal_new(void);
+extern waitui_ast_null_literal *
+waitui_ast_null_literal_new(waitui_arena *arena);
 
 /**
  * @brief Destroy a null literal node and its content.
@@ -1308,10 +1550,13 @@ extern void waitui_ast_null_literal_destroy(waitui_ast_null_literal **this);
 
 /**
  * @brief Create a string literal node for the AST.
+ * @param[in,out] arena The arena to allocate the node from
  * @param[in] value The value for the string literal node
+ * @note The value is not copied, it has to live as long as the arena.
  * @return On success a pointer to waitui_ast_string_literal, else NULL
  */
-extern waitui_ast_string_literal *waitui_ast_string_literal_new(str value);
+extern waitui_ast_string_literal *
+waitui_ast_string_literal_new(waitui_arena *arena, str value);
 
 /**
  * @brief Return the value for the string literal node.
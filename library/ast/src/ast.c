@@ -7,6 +7,7 @@
 
 #include "waitui/ast.h"
 
+#include <waitui/hashtable.h>
 #include <waitui/log.h>
 
 #include <stdlib.h>
@@ -21,14 +22,428 @@
  */
 struct waitui_ast {
     waitui_ast_program *program;
+    waitui_arena *arena;
 };
 
+/**
+ * @brief Type for a node on the stack of the AST visitor.
+ * @note The frame remembers the next field of the node to look at and, while
+ *       inside a list, the list and the index of its next node, so no iterator
+ *       is allocated. The field and position locate the node in its parent.
+ */
+typedef struct waitui_ast_visitor_frame {
+    waitui_ast_node *node;
+    waitui_ast_field field;
+    unsigned long int position;
+    unsigned int nextField;
+    waitui_vector *list;
+    unsigned long int index;
+} waitui_ast_visitor_frame;
+
+/**
+ * @brief Type for the callbacks of waitui_ast_walk and their extra argument.
+ */
+typedef struct waitui_ast_walk_args {
+    waitui_ast_callbacks *callbacks;
+    void *args;
+} waitui_ast_walk_args;
+
+/**
+ * @brief Struct representing an AST visitor.
+ */
+struct waitui_ast_visitor {
+    waitui_ast_visitor_frame *frames;
+    unsigned long int length;
+    unsigned long int size;
+};
+
+CREATE_HASHTABLE_TYPE_CUSTOM(INTERFACE, waitui_ast, waitui_ast, NULL)
+
+
+// -----------------------------------------------------------------------------
+//  Local functions
+// -----------------------------------------------------------------------------
+
+CREATE_HASHTABLE_TYPE_CUSTOM(IMPLEMENTATION, waitui_ast, waitui_ast, NULL)
+
+/**
+ * @brief Get the field of the definition node.
+ * @param[in] definition The definition node to get the field from
+ * @param[in] field The field to get
+ * @param[out] child The node of the field, if the field holds a node
+ * @param[out] list The list of the field, if the field holds a list of nodes
+ * @retval 1 The definition node has the field
+ * @retval 0 The definition node has no more fields
+ */
+static int waitui_ast_visitor_getDefinitionField(
+        waitui_ast_definition *definition, unsigned int field,
+        waitui_ast_node **child, waitui_vector **list) {
+    switch (waitui_ast_definition_getDefinitionType(definition)) {
+        case WAITUI_AST_DEFINITION_TYPE_PROGRAM:
+            if (field != WAITUI_AST_FIELD_PROGRAM_NAMESPACES) { return 0; }
+            *list = waitui_ast_program_getNamespaces(
+                    (waitui_ast_program *) definition);
+            return 1;
+        case WAITUI_AST_DEFINITION_TYPE_NAMESPACE: {
+            waitui_ast_namespace *namespace =
+                    (waitui_ast_namespace *) definition;
+
+            if (field == WAITUI_AST_FIELD_NAMESPACE_IMPORTS) {
+                *list = waitui_ast_namespace_getImports(namespace);
+            } else if (field == WAITUI_AST_FIELD_NAMESPACE_CLASSES) {
+                *list = waitui_ast_namespace_getClasses(namespace);
+            }
+            return field <= WAITUI_AST_FIELD_NAMESPACE_CLASSES;
+        }
+        case WAITUI_AST_DEFINITION_TYPE_CLASS: {
+            waitui_ast_class *class = (waitui_ast_class *) definition;
+
+            if (field == WAITUI_AST_FIELD_CLASS_PARAMETERS) {
+                *list = waitui_ast_class_getParameters(class);
+            } else if (field == WAITUI_AST_FIELD_CLASS_SUPER_CLASS_ARGS) {
+                *list = waitui_ast_class_getSuperClassArgs(class);
+            } else if (field == WAITUI_AST_FIELD_CLASS_PROPERTIES) {
+                *list = waitui_ast_class_getProperties(class);
+            } else if (field == WAITUI_AST_FIELD_CLASS_FUNCTIONS) {
+                *list = waitui_ast_class_getFunctions(class);
+            }
+            return field <= WAITUI_AST_FIELD_CLASS_FUNCTIONS;
+        }
+        case WAITUI_AST_DEFINITION_TYPE_PROPERTY:
+            if (field == WAITUI_AST_FIELD_PROPERTY_VALUE) {
+                *child = (waitui_ast_node *) waitui_ast_property_getValue(
+                        (waitui_ast_property *) definition);
+            }
+            return field <= WAITUI_AST_FIELD_PROPERTY_VALUE;
+        case WAITUI_AST_DEFINITION_TYPE_FUNCTION: {
+            waitui_ast_function *function = (waitui_ast_function *) definition;
+
+            if (field == WAITUI_AST_FIELD_FUNCTION_PARAMETERS) {
+                *list = waitui_ast_function_getParameters(function);
+            } else if (field == WAITUI_AST_FIELD_FUNCTION_BODY) {
+                *child = (waitui_ast_node *) waitui_ast_function_getBody(
+                        function);
+            }
+            return field <= WAITUI_AST_FIELD_FUNCTION_BODY;
+        }
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief Get the field of the expression node.
+ * @param[in] expression The expression node to get the field from
+ * @param[in] field The field to get
+ * @param[out] child The node of the field, if the field holds a node
+ * @param[out] list The list of the field, if the field holds a list of nodes
+ * @retval 1 The expression node has the field
+ * @retval 0 The expression node has no more fields
+ */
+static int waitui_ast_visitor_getExpressionField(
+        waitui_ast_expression *expression, unsigned int field,
+        waitui_ast_node **child, waitui_vector **list) {
+    switch (waitui_ast_expression_getExpressionType(expression)) {
+        case WAITUI_AST_EXPRESSION_TYPE_ASSIGNMENT:
+            if (field == WAITUI_AST_FIELD_ASSIGNMENT_VALUE) {
+                *child = (waitui_ast_node *) waitui_ast_assignment_getValue(
+                        (waitui_ast_assignment *) expression);
+            }
+            return field <= WAITUI_AST_FIELD_ASSIGNMENT_VALUE;
+        case WAITUI_AST_EXPRESSION_TYPE_CAST:
+            if (field == WAITUI_AST_FIELD_CAST_OBJECT) {
+                *child = (waitui_ast_node *) waitui_ast_cast_getObject(
+                        (waitui_ast_cast *) expression);
+            }
+            return field <= WAITUI_AST_FIELD_CAST_OBJECT;
+        case WAITUI_AST_EXPRESSION_TYPE_INITIALIZATION:
+            if (field == WAITUI_AST_FIELD_INITIALIZATION_VALUE) {
+                *child = (waitui_ast_node *) waitui_ast_initialization_getValue(
+                        (waitui_ast_initialization *) expression);
+            }
+            return field <= WAITUI_AST_FIELD_INITIALIZATION_VALUE;
+        case WAITUI_AST_EXPRESSION_TYPE_LET: {
+            waitui_ast_let *let = (waitui_ast_let *) expression;
+
+            if (field == WAITUI_AST_FIELD_LET_INITIALIZATIONS) {
+                *list = waitui_ast_let_getInitializations(let);
+            } else if (field == WAITUI_AST_FIELD_LET_BODY) {
+                *child = (waitui_ast_node *) waitui_ast_let_getBody(let);
+            }
+            return field <= WAITUI_AST_FIELD_LET_BODY;
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_BLOCK:
+            if (field != WAITUI_AST_FIELD_BLOCK_EXPRESSIONS) { return 0; }
+            *list = waitui_ast_block_getExpressions(
+                    (waitui_ast_block *) expression);
+            return 1;
+        case WAITUI_AST_EXPRESSION_TYPE_CONSTRUCTOR_CALL:
+            if (field == WAITUI_AST_FIELD_CONSTRUCTOR_CALL_ARGS) {
+                *list = waitui_ast_constructor_call_getArgs(
+                        (waitui_ast_constructor_call *) expression);
+            }
+            return field <= WAITUI_AST_FIELD_CONSTRUCTOR_CALL_ARGS;
+        case WAITUI_AST_EXPRESSION_TYPE_FUNCTION_CALL: {
+            waitui_ast_function_call *functionCall =
+                    (waitui_ast_function_call *) expression;
+
+            if (field == WAITUI_AST_FIELD_FUNCTION_CALL_OBJECT) {
+                *child = (waitui_ast_node *) waitui_ast_function_call_getObject(
+                        functionCall);
+            } else if (field == WAITUI_AST_FIELD_FUNCTION_CALL_ARGS) {
+                *list = waitui_ast_function_call_getArgs(functionCall);
+            }
+            return field <= WAITUI_AST_FIELD_FUNCTION_CALL_ARGS;
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_SUPER_FUNCTION_CALL:
+            if (field == WAITUI_AST_FIELD_SUPER_FUNCTION_CALL_ARGS) {
+                *list = waitui_ast_super_function_call_getArgs(
+                        (waitui_ast_super_function_call *) expression);
+            }
+            return field <= WAITUI_AST_FIELD_SUPER_FUNCTION_CALL_ARGS;
+        case WAITUI_AST_EXPRESSION_TYPE_BINARY_EXPRESSION: {
+            waitui_ast_binary_expression *binaryExpression =
+                    (waitui_ast_binary_expression *) expression;
+
+            if (field == WAITUI_AST_FIELD_BINARY_EXPRESSION_LEFT) {
+                *child = (waitui_ast_node *)
+                        waitui_ast_binary_expression_getLeft(binaryExpression);
+            } else if (field == WAITUI_AST_FIELD_BINARY_EXPRESSION_RIGHT) {
+                *child = (waitui_ast_node *)
+                        waitui_ast_binary_expression_getRight(binaryExpression);
+            }
+            return field <= WAITUI_AST_FIELD_BINARY_EXPRESSION_RIGHT;
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_UNARY_EXPRESSION:
+            if (field != WAITUI_AST_FIELD_UNARY_EXPRESSION_EXPRESSION) {
+                return 0;
+            }
+            *child = (waitui_ast_node *)
+                    waitui_ast_unary_expression_getExpression(
+                            (waitui_ast_unary_expression *) expression);
+            return 1;
+        case WAITUI_AST_EXPRESSION_TYPE_IF_ELSE: {
+            waitui_ast_if_else *ifElse = (waitui_ast_if_else *) expression;
+
+            if (field == WAITUI_AST_FIELD_IF_ELSE_CONDITION) {
+                *child = (waitui_ast_node *) waitui_ast_if_else_getCondition(
+                        ifElse);
+            } else if (field == WAITUI_AST_FIELD_IF_ELSE_THEN_BRANCH) {
+                *child = (waitui_ast_node *) waitui_ast_if_else_getThenBranch(
+                        ifElse);
+            } else if (field == WAITUI_AST_FIELD_IF_ELSE_ELSE_BRANCH) {
+                *child = (waitui_ast_node *) waitui_ast_if_else_getElseBranch(
+                        ifElse);
+            }
+            return field <= WAITUI_AST_FIELD_IF_ELSE_ELSE_BRANCH;
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_WHILE: {
+            waitui_ast_while *whileNode = (waitui_ast_while *) expression;
+
+            if (field == WAITUI_AST_FIELD_WHILE_CONDITION) {
+                *child = (waitui_ast_node *) waitui_ast_while_getCondition(
+                        whileNode);
+            } else if (field == WAITUI_AST_FIELD_WHILE_BODY) {
+                *child = (waitui_ast_node *) waitui_ast_while_getBody(
+                        whileNode);
+            }
+            return field <= WAITUI_AST_FIELD_WHILE_BODY;
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_LAZY_EXPRESSION:
+            if (field != WAITUI_AST_FIELD_LAZY_EXPRESSION_EXPRESSION) {
+                return 0;
+            }
+            *child = (waitui_ast_node *)
+                    waitui_ast_lazy_expression_getExpression(
+                            (waitui_ast_lazy_expression *) expression);
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief Return the next child of the node on the stack of the AST visitor.
+ * @param[in,out] frame The frame of the node
+ * @param[out] field The field of the node holding the child
+ * @param[out] index The position of the child in the list of the field
+ * @return The next child or NULL if all children were returned
+ */
+static waitui_ast_node *
+waitui_ast_visitor_nextChild(waitui_ast_visitor_frame *frame,
+                             waitui_ast_field *field,
+                             unsigned long int *index) {
+    for (;;) {
+        waitui_ast_node *child = NULL;
+        waitui_vector *list    = NULL;
+        int hasField           = 0;
+
+        if (frame->list) {
+            child = waitui_vector_get(frame->list, frame->index);
+            if (child) {
+                *field = (waitui_ast_field) (frame->nextField - 1);
+                *index = frame->index++;
+                return child;
+            }
+            frame->list = NULL;
+        }
+
+        switch (waitui_ast_node_getNodeType(frame->node)) {
+            case WAITUI_AST_NODE_TYPE_DEFINITION:
+                hasField = waitui_ast_visitor_getDefinitionField(
+                        (waitui_ast_definition *) frame->node,
+                        frame->nextField, &child, &list);
+                break;
+            case WAITUI_AST_NODE_TYPE_EXPRESSION:
+                hasField = waitui_ast_visitor_getExpressionField(
+                        (waitui_ast_expression *) frame->node,
+                        frame->nextField, &child, &list);
+                break;
+            default:
+                break;
+        }
+        if (!hasField) { return NULL; }
+
+        *field = (waitui_ast_field) frame->nextField++;
+        *index = 0;
+
+        if (child) { return child; }
+        if (list) {
+            frame->list  = list;
+            frame->index = 0;
+        }
+    }
+}
+
+/**
+ * @brief Push the node onto the stack of the AST visitor.
+ * @param[in,out] this The AST visitor to push onto
+ * @param[in] node The node to push
+ * @param[in] field The field of the parent holding the node
+ * @param[in] position The position of the node in the list of the field
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ */
+static int waitui_ast_visitor_push(waitui_ast_visitor *this,
+                                   waitui_ast_node *node,
+                                   waitui_ast_field field,
+                                   unsigned long int position) {
+    waitui_ast_visitor_frame *frame = NULL;
+
+    if (this->length == this->size) {
+        unsigned long int size = this->size ? this->size * 2 : 64;
+        waitui_ast_visitor_frame *frames =
+                realloc(this->frames, size * sizeof(*frames));
+        if (!frames) { return 0; }
+
+        this->frames = frames;
+        this->size   = size;
+    }
+
+    frame            = &this->frames[this->length++];
+    frame->node      = node;
+    frame->field     = field;
+    frame->position  = position;
+    frame->nextField = 0;
+    frame->list      = NULL;
+    frame->index     = 0;
+
+    return 1;
+}
+
+/**
+ * @brief Call the callback for the visited node.
+ * @param[in] callback The callback to call, may be NULL
+ * @param[in] visit The visited node
+ * @param[in,out] args The extra argument for the callback
+ * @return The action asked for by the callback
+ */
+static inline waitui_ast_visit_action
+waitui_ast_visitor_call(waitui_ast_visit_callback callback,
+                        const waitui_ast_visit *visit, void *args) {
+    if (!callback) { return WAITUI_AST_VISIT_ACTION_CONTINUE; }
+    return callback(visit, args);
+}
+
+/**
+ * @brief The pre order callback of waitui_ast_walk.
+ * @param[in] visit The visited node
+ * @param[in,out] args The walk callbacks and their extra argument
+ * @return Always continue
+ */
+static waitui_ast_visit_action
+waitui_ast_walk_preVisit(const waitui_ast_visit *visit, void *args) {
+    waitui_ast_walk_args *walkArgs = args;
+
+    if (walkArgs->callbacks->preNodeCallback) {
+        walkArgs->callbacks->preNodeCallback(visit->node, walkArgs->args);
+    }
+    if (walkArgs->callbacks->nodeCallback) {
+        walkArgs->callbacks->nodeCallback(visit->node, walkArgs->args);
+    }
+
+    return WAITUI_AST_VISIT_ACTION_CONTINUE;
+}
+
+/**
+ * @brief The post order callback of waitui_ast_walk.
+ * @param[in] visit The visited node
+ * @param[in,out] args The walk callbacks and their extra argument
+ * @return Always continue
+ */
+static waitui_ast_visit_action
+waitui_ast_walk_postVisit(const waitui_ast_visit *visit, void *args) {
+    waitui_ast_walk_args *walkArgs = args;
+
+    if (walkArgs->callbacks->postNodeCallback) {
+        walkArgs->callbacks->postNodeCallback(visit->node, walkArgs->args);
+    }
+
+    return WAITUI_AST_VISIT_ACTION_CONTINUE;
+}
+
+/**
+ * @brief Call the callback for the imported modules of the AST and then for
+ *        the AST, unless it was seen before.
+ * @param[in,out] this The AST to start at
+ * @param[in,out] seen The ASTs passed so far
+ * @param[in] callback The callback for the modules
+ * @param[in,out] args The extra argument for the callback
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed or the callback failed
+ */
+static int waitui_ast_forEachModuleOnce(waitui_ast *this,
+                                        waitui_ast_hashtable *seen,
+                                        waitui_ast_module_callback callback,
+                                        void *args) {
+    // the address of the AST is the key, a module is the same AST everywhere
+    str key = {.s = (char *) &this, .len = sizeof(this)};
+
+    if (waitui_ast_hashtable_has(seen, key)) { return 1; }
+    if (!waitui_ast_hashtable_insert(seen, key, this)) { return 0; }
+
+    WAITUI_VECTOR_FOREACH(waitui_ast_namespace, namespace,
+                          waitui_ast_program_getNamespaces(this->program)) {
+        WAITUI_VECTOR_FOREACH(waitui_ast_import, import,
+                              waitui_ast_namespace_getImports(namespace)) {
+            waitui_ast *module = waitui_ast_import_getModule(import);
+
+            if (module && !waitui_ast_forEachModuleOnce(module, seen, callback,
+                                                        args)) {
+                return 0;
+            }
+        }
+    }
+
+    return callback(this, args);
+}
+
 
 // -----------------------------------------------------------------------------
 //  Public functions
 // -----------------------------------------------------------------------------
 
-waitui_ast *waitui_ast_new(waitui_ast_program *program) {
+waitui_ast *waitui_ast_new(waitui_arena *arena, waitui_ast_program *program) {
     waitui_ast *this = NULL;
 
     waitui_log_trace("creating new waitui_ast");
@@ -37,6 +452,7 @@ waitui_ast *waitui_ast_new(waitui_ast_program *program) {
     if (!this) { return NULL; }
 
     this->program = program;
+    this->arena   = arena;
 
     waitui_log_trace("new waitui_ast successful created");
 
@@ -49,6 +465,7 @@ void ast_destroy(waitui_ast **this) {
     if (!this || !(*this)) { return; }
 
     waitui_ast_program_destroy(&(*this)->program);
+    waitui_arena_destroy(&(*this)->arena);
 
     free(*this);
     *this = NULL;
@@ -64,13 +481,268 @@ waitui_ast_program *waitui_ast_getProgram(waitui_ast *this) {
     return this->program;
 }
 
+waitui_arena *waitui_ast_getArena(waitui_ast *this) {
+    waitui_log_trace("get the waitui_arena from waitui_ast");
+
+    if (!this) { return NULL; }
+
+    return this->arena;
+}
+
 void waitui_ast_walk(waitui_ast *this, waitui_ast_callbacks *callbacks,
                      void *args) {
+    waitui_ast_visit_callbacks visitCallbacks = {
+            .preVisitCallback  = waitui_ast_walk_preVisit,
+            .postVisitCallback = waitui_ast_walk_postVisit,
+    };
+    waitui_ast_walk_args walkArgs = {callbacks, args};
+    waitui_ast_visitor *visitor   = NULL;
+
     waitui_log_trace("start walking the waitui_ast");
 
     if (!this || !callbacks) { return; }
 
-    WAITUI_AST_EXECUTE_CALLBACKS(callbacks, this->program, args);
+    visitor = waitui_ast_visitor_new();
+    if (!visitor) { return; }
+
+    waitui_ast_visitor_visit(visitor, (waitui_ast_node *) this->program,
+                             &visitCallbacks, &walkArgs);
+    waitui_ast_visitor_destroy(&visitor);
 
     waitui_log_trace("end walking the waitui_ast");
 }
+
+int waitui_ast_forEachModule(waitui_ast *this,
+                             waitui_ast_module_callback callback, void *args) {
+    waitui_ast_hashtable *seen = NULL;
+    int result                        = 0;
+
+    waitui_log_trace("start passing the modules of the waitui_ast");
+
+    if (!this || !callback) { return 0; }
+
+    seen = waitui_ast_hashtable_new(16);
+    if (!seen) { return 0; }
+
+    result = waitui_ast_forEachModuleOnce(this, seen, callback, args);
+    waitui_ast_hashtable_destroy(&seen);
+
+    waitui_log_trace("end passing the modules of the waitui_ast");
+
+    return result;
+}
+
+int waitui_ast_node_replaceChild(waitui_ast_node *parent,
+                                 waitui_ast_field field,
+                                 unsigned long int index,
+                                 waitui_ast_expression *expression) {
+    waitui_ast_expression *node = (waitui_ast_expression *) parent;
+    waitui_vector *list         = NULL;
+
+    if (!parent || !expression) { return 0; }
+
+    if (waitui_ast_node_getNodeType(parent) ==
+        WAITUI_AST_NODE_TYPE_DEFINITION) {
+        switch (waitui_ast_definition_getDefinitionType(
+                (waitui_ast_definition *) parent)) {
+            case WAITUI_AST_DEFINITION_TYPE_CLASS:
+                if (field != WAITUI_AST_FIELD_CLASS_SUPER_CLASS_ARGS) {
+                    return 0;
+                }
+                list = waitui_ast_class_getSuperClassArgs(
+                        (waitui_ast_class *) parent);
+                return waitui_vector_set(list, index, expression);
+            case WAITUI_AST_DEFINITION_TYPE_PROPERTY:
+                if (field != WAITUI_AST_FIELD_PROPERTY_VALUE) { return 0; }
+                waitui_ast_property_setValue((waitui_ast_property *) parent,
+                                             expression);
+                return 1;
+            case WAITUI_AST_DEFINITION_TYPE_FUNCTION:
+                if (field != WAITUI_AST_FIELD_FUNCTION_BODY) { return 0; }
+                waitui_ast_function_setBody((waitui_ast_function *) parent,
+                                            expression);
+                return 1;
+            default:
+                return 0;
+        }
+    }
+
+    switch (waitui_ast_expression_getExpressionType(node)) {
+        case WAITUI_AST_EXPRESSION_TYPE_ASSIGNMENT:
+            if (field != WAITUI_AST_FIELD_ASSIGNMENT_VALUE) { return 0; }
+            waitui_ast_assignment_setValue((waitui_ast_assignment *) node,
+                                           expression);
+            return 1;
+        case WAITUI_AST_EXPRESSION_TYPE_CAST:
+            if (field != WAITUI_AST_FIELD_CAST_OBJECT) { return 0; }
+            waitui_ast_cast_setObject((waitui_ast_cast *) node, expression);
+            return 1;
+        case WAITUI_AST_EXPRESSION_TYPE_INITIALIZATION:
+            if (field != WAITUI_AST_FIELD_INITIALIZATION_VALUE) { return 0; }
+            waitui_ast_initialization_setValue(
+                    (waitui_ast_initialization *) node, expression);
+            return 1;
+        case WAITUI_AST_EXPRESSION_TYPE_LET:
+            if (field != WAITUI_AST_FIELD_LET_BODY) { return 0; }
+            waitui_ast_let_setBody((waitui_ast_let *) node, expression);
+            return 1;
+        case WAITUI_AST_EXPRESSION_TYPE_BLOCK:
+            if (field != WAITUI_AST_FIELD_BLOCK_EXPRESSIONS) { return 0; }
+            list = waitui_ast_block_getExpressions((waitui_ast_block *) node);
+            return waitui_vector_set(list, index, expression);
+        case WAITUI_AST_EXPRESSION_TYPE_CONSTRUCTOR_CALL:
+            if (field != WAITUI_AST_FIELD_CONSTRUCTOR_CALL_ARGS) { return 0; }
+            list = waitui_ast_constructor_call_getArgs(
+                    (waitui_ast_constructor_call *) node);
+            return waitui_vector_set(list, index, expression);
+        case WAITUI_AST_EXPRESSION_TYPE_FUNCTION_CALL:
+            if (field == WAITUI_AST_FIELD_FUNCTION_CALL_OBJECT) {
+                waitui_ast_function_call_setObject(
+                        (waitui_ast_function_call *) node, expression);
+                return 1;
+            }
+            if (field != WAITUI_AST_FIELD_FUNCTION_CALL_ARGS) { return 0; }
+            list = waitui_ast_function_call_getArgs(
+                    (waitui_ast_function_call *) node);
+            return waitui_vector_set(list, index, expression);
+        case WAITUI_AST_EXPRESSION_TYPE_SUPER_FUNCTION_CALL:
+            if (field != WAITUI_AST_FIELD_SUPER_FUNCTION_CALL_ARGS) {
+                return 0;
+            }
+            list = waitui_ast_super_function_call_getArgs(
+                    (waitui_ast_super_function_call *) node);
+            return waitui_vector_set(list, index, expression);
+        case WAITUI_AST_EXPRESSION_TYPE_BINARY_EXPRESSION:
+            if (field == WAITUI_AST_FIELD_BINARY_EXPRESSION_LEFT) {
+                waitui_ast_binary_expression_setLeft(
+                        (waitui_ast_binary_expression *) node, expression);
+            } else if (field == WAITUI_AST_FIELD_BINARY_EXPRESSION_RIGHT) {
+                waitui_ast_binary_expression_setRight(
+                        (waitui_ast_binary_expression *) node, expression);
+            } else {
+                return 0;
+            }
+            return 1;
+        case WAITUI_AST_EXPRESSION_TYPE_UNARY_EXPRESSION:
+            if (field != WAITUI_AST_FIELD_UNARY_EXPRESSION_EXPRESSION) {
+                return 0;
+            }
+            waitui_ast_unary_expression_setExpression(
+                    (waitui_ast_unary_expression *) node, expression);
+            return 1;
+        case WAITUI_AST_EXPRESSION_TYPE_IF_ELSE:
+            if (field == WAITUI_AST_FIELD_IF_ELSE_CONDITION) {
+                waitui_ast_if_else_setCondition((waitui_ast_if_else *) node,
+                                                expression);
+            } else if (field == WAITUI_AST_FIELD_IF_ELSE_THEN_BRANCH) {
+                waitui_ast_if_else_setThenBranch((waitui_ast_if_else *) node,
+                                                 expression);
+            } else if (field == WAITUI_AST_FIELD_IF_ELSE_ELSE_BRANCH) {
+                waitui_ast_if_else_setElseBranch((waitui_ast_if_else *) node,
+                                                 expression);
+            } else {
+                return 0;
+            }
+            return 1;
+        case WAITUI_AST_EXPRESSION_TYPE_WHILE:
+            if (field == WAITUI_AST_FIELD_WHILE_CONDITION) {
+                waitui_ast_while_setCondition((waitui_ast_while *) node,
+                                              expression);
+            } else if (field == WAITUI_AST_FIELD_WHILE_BODY) {
+                waitui_ast_while_setBody((waitui_ast_while *) node, expression);
+            } else {
+                return 0;
+            }
+            return 1;
+        case WAITUI_AST_EXPRESSION_TYPE_LAZY_EXPRESSION:
+            if (field != WAITUI_AST_FIELD_LAZY_EXPRESSION_EXPRESSION) {
+                return 0;
+            }
+            waitui_ast_lazy_expression_setExpression(
+                    (waitui_ast_lazy_expression *) node, expression);
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+waitui_ast_visitor *waitui_ast_visitor_new(void) {
+    return calloc(1, sizeof(waitui_ast_visitor));
+}
+
+void waitui_ast_visitor_destroy(waitui_ast_visitor **this) {
+    if (!this || !(*this)) { return; }
+
+    free((*this)->frames);
+
+    free(*this);
+    *this = NULL;
+}
+
+int waitui_ast_visitor_visit(waitui_ast_visitor *this, waitui_ast_node *node,
+                             const waitui_ast_visit_callbacks *callbacks,
+                             void *args) {
+    waitui_ast_visit visit         = {0};
+    waitui_ast_visit_action action = WAITUI_AST_VISIT_ACTION_CONTINUE;
+
+    if (!this || !node || !callbacks) { return 0; }
+
+    this->length = 0;
+
+    visit.node  = node;
+    visit.order = WAITUI_AST_VISIT_ORDER_PRE;
+    action = waitui_ast_visitor_call(callbacks->preVisitCallback, &visit, args);
+    if (action == WAITUI_AST_VISIT_ACTION_STOP) { return 1; }
+    if (action == WAITUI_AST_VISIT_ACTION_SKIP) {
+        visit.order = WAITUI_AST_VISIT_ORDER_POST;
+        waitui_ast_visitor_call(callbacks->postVisitCallback, &visit, args);
+        return 1;
+    }
+    if (!waitui_ast_visitor_push(this, node, 0, 0)) { return 0; }
+
+    while (this->length > 0) {
+        waitui_ast_visitor_frame *frame = &this->frames[this->length - 1];
+        waitui_ast_field field          = 0;
+        unsigned long int index         = 0;
+        waitui_ast_node *child =
+                waitui_ast_visitor_nextChild(frame, &field, &index);
+
+        if (!child) {
+            this->length--;
+
+            visit.node   = frame->node;
+            visit.parent = this->length > 0
+                                   ? this->frames[this->length - 1].node
+                                   : NULL;
+            visit.field  = frame->field;
+            visit.index  = frame->position;
+            visit.depth  = this->length;
+            visit.order  = WAITUI_AST_VISIT_ORDER_POST;
+            action       = waitui_ast_visitor_call(callbacks->postVisitCallback,
+                                                   &visit, args);
+            if (action == WAITUI_AST_VISIT_ACTION_STOP) { return 1; }
+            continue;
+        }
+
+        visit.node   = child;
+        visit.parent = frame->node;
+        visit.field  = field;
+        visit.index  = index;
+        visit.depth  = this->length;
+        visit.order  = WAITUI_AST_VISIT_ORDER_PRE;
+        action = waitui_ast_visitor_call(callbacks->preVisitCallback, &visit,
+                                         args);
+        if (action == WAITUI_AST_VISIT_ACTION_STOP) { return 1; }
+        if (action == WAITUI_AST_VISIT_ACTION_SKIP) {
+            visit.order = WAITUI_AST_VISIT_ORDER_POST;
+            action = waitui_ast_visitor_call(callbacks->postVisitCallback,
+                                             &visit, args);
+            if (action == WAITUI_AST_VISIT_ACTION_STOP) { return 1; }
+            continue;
+        }
+
+        if (!waitui_ast_visitor_push(this, child, field, index)) { return 0; }
+    }
+
+    return 1;
+}
@@ -9,8 +9,6 @@
 
 #include <waitui/log.h>
 
-#include <stdlib.h>
-
 
 // -----------------------------------------------------------------------------
 //  Local defines
@@ -24,7 +22,7 @@
 
 #define AST_NODE_NEW(type, node_type, node_subtype)                            \
     waitui_log_trace("creating new waitui_ast node " #type);                   \
-    type *this = calloc(1, sizeof(*this));                                     \
+    type *this = waitui_arena_alloc(arena, sizeof(*this));                     \
     if (!this) { return NULL; }                                                \
     this->astNodeType = WAITUI_AST_NODE_TYPE_##node_type;                      \
     AST_NODE_##node_type##_INIT(node_subtype)
@@ -39,7 +37,6 @@
     waitui_log_trace("doing clean up fo waitui_ast node " #type)
 
 #define AST_NODE_DESTROY_DONE(type)                                            \
-    free(*this);                                                               \
     *this = NULL;                                                              \
     waitui_log_trace("waitui_ast node " #type " successful destroyed")
 
@@ -74,7 +71,7 @@
 #define WAITUI_AST_EXPRESSION_PROPERTIES                                       \
     WAITUI_AST_NODE_PROPERTIES                                                 \
     waitui_ast_expression_type astExpressionType;                              \
-    void *expressionType;// FIXME: not specified
+    const waitui_type *valueType;
 
 
 // -----------------------------------------------------------------------------
@@ -107,7 +104,7 @@ struct waitui_ast_expression {
  */
 struct waitui_ast_program {
     WAITUI_AST_DEFINITION_PROPERTIES
-    waitui_ast_namespace_list *namespaces;
+    waitui_ast_namespace_vector *namespaces;
 };
 
 /**
@@ -116,8 +113,8 @@ struct waitui_ast_program {
 struct waitui_ast_namespace {
     WAITUI_AST_DEFINITION_PROPERTIES
     symbol *name;
-    waitui_ast_import_list *imports;
-    waitui_ast_class_list *classes;
+    waitui_ast_import_vector *imports;
+    waitui_ast_class_vector *classes;
 };
 
 /**
@@ -127,6 +124,7 @@ struct waitui_ast_import {
     WAITUI_AST_DEFINITION_PROPERTIES
     symbol *name;
     symbol *alias;
+    waitui_ast *module;
 };
 
 /**
@@ -135,11 +133,11 @@ struct waitui_ast_import {
 struct waitui_ast_class {
     WAITUI_AST_DEFINITION_PROPERTIES
     symbol *name;
-    waitui_ast_formal_list *parameters;
+    waitui_ast_formal_vector *parameters;
     symbol *superClass;
-    waitui_ast_expression_list *superClassArgs;
-    waitui_ast_property_list *properties;
-    waitui_ast_function_list *functions;
+    waitui_ast_expression_vector *superClassArgs;
+    waitui_ast_property_vector *properties;
+    waitui_ast_function_vector *functions;
 };
 
 /**
@@ -168,7 +166,7 @@ struct waitui_ast_property {
 struct waitui_ast_function {
     WAITUI_AST_DEFINITION_PROPERTIES
     symbol *functionName;
-    waitui_ast_formal_list *parameters;
+    waitui_ast_formal_vector *parameters;
     symbol *returnType;
     waitui_ast_expression *body;
     waitui_ast_function_visibility visibility;
@@ -182,7 +180,7 @@ struct waitui_ast_function {
  */
 struct waitui_ast_block {
     WAITUI_AST_EXPRESSION_PROPERTIES
-    waitui_ast_expression_list *expressions;
+    waitui_ast_expression_vector *expressions;
 };
 
 /**
@@ -190,7 +188,7 @@ struct waitui_ast_block {
  */
 struct waitui_ast_let {
     WAITUI_AST_EXPRESSION_PROPERTIES
-    waitui_ast_initialization_list *initializations;
+    waitui_ast_initialization_vector *initializations;
     waitui_ast_expression *body;
 };
 
@@ -275,7 +273,6 @@ struct waitui_ast_lazy_expression {
  */
 struct waitui_ast_native_expression {
     WAITUI_AST_EXPRESSION_PROPERTIES
-    void *func;// FIXME: not specified
 };
 
 /**
@@ -284,7 +281,7 @@ struct waitui_ast_native_expression {
 struct waitui_ast_constructor_call {
     WAITUI_AST_EXPRESSION_PROPERTIES
     symbol *name;
-    waitui_ast_expression_list *args;
+    waitui_ast_expression_vector *args;
 };
 
 /**
@@ -294,7 +291,7 @@ struct waitui_ast_function_call {
     WAITUI_AST_EXPRESSION_PROPERTIES
     waitui_ast_expression *object;
     symbol *functionName;
-    waitui_ast_expression_list *args;
+    waitui_ast_expression_vector *args;
 };
 
 /**
@@ -303,7 +300,7 @@ struct waitui_ast_function_call {
 struct waitui_ast_super_function_call {
     WAITUI_AST_EXPRESSION_PROPERTIES
     symbol *functionName;
-    waitui_ast_expression_list *args;
+    waitui_ast_expression_vector *args;
 };
 
 /**
@@ -365,14 +362,14 @@ struct waitui_ast_string_literal {
 //  Public functions
 // -----------------------------------------------------------------------------
 
-CREATE_LIST_TYPE(IMPLEMENTATION, waitui_ast_namespace)
-CREATE_LIST_TYPE(IMPLEMENTATION, waitui_ast_import)
-CREATE_LIST_TYPE(IMPLEMENTATION, waitui_ast_class)
-CREATE_LIST_TYPE(IMPLEMENTATION, waitui_ast_expression)
-CREATE_LIST_TYPE(IMPLEMENTATION, waitui_ast_formal)
-CREATE_LIST_TYPE(IMPLEMENTATION, waitui_ast_property)
-CREATE_LIST_TYPE(IMPLEMENTATION, waitui_ast_function)
-CREATE_LIST_TYPE(IMPLEMENTATION, waitui_ast_initialization)
+CREATE_VECTOR_TYPE(IMPLEMENTATION, waitui_ast_namespace)
+CREATE_VECTOR_TYPE(IMPLEMENTATION, waitui_ast_import)
+CREATE_VECTOR_TYPE(IMPLEMENTATION, waitui_ast_class)
+CREATE_VECTOR_TYPE(IMPLEMENTATION, waitui_ast_expression)
+CREATE_VECTOR_TYPE(IMPLEMENTATION, waitui_ast_formal)
+CREATE_VECTOR_TYPE(IMPLEMENTATION, waitui_ast_property)
+CREATE_VECTOR_TYPE(IMPLEMENTATION, waitui_ast_function)
+CREATE_VECTOR_TYPE(IMPLEMENTATION, waitui_ast_initialization)
 
 waitui_ast_node_type waitui_ast_node_getNodeType(const waitui_ast_node *this) {
     WAITUI_AST_NODE_GET(waitui_ast_node, WAITUI_AST_NODE_TYPE_UNDEFINED);
@@ -442,6 +439,19 @@ waitui_ast_expression_getExpressionType(const waitui_ast_expression *this) {
     return this->astExpressionType;
 }
 
+const waitui_type *
+waitui_ast_expression_getValueType(const waitui_ast_expression *this) {
+    WAITUI_AST_NODE_GET(waitui_ast_expression, NULL);
+    return this->valueType;
+}
+
+void waitui_ast_expression_setValueType(waitui_ast_expression *this,
+                                        const waitui_type *valueType) {
+    WAITUI_AST_NODE_SET(waitui_ast_expression);
+    this->valueType = valueType;
+    WAITUI_AST_NODE_SET_DONE(waitui_ast_expression);
+}
+
 void waitui_ast_expression_destroy(waitui_ast_expression **this) {
     if (!this || !(*this)) { return; }
 
@@ -529,7 +539,8 @@ void waitui_ast_expression_destroy(waitui_ast_expression **this) {
 }
 
 waitui_ast_program *
-waitui_ast_program_new(waitui_ast_namespace_list *namespaces) {
+waitui_ast_program_new(waitui_arena *arena,
+                       waitui_ast_namespace_vector *namespaces) {
     AST_NODE_NEW(waitui_ast_program, DEFINITION, PROGRAM);
 
     this->namespaces = namespaces;
@@ -537,7 +548,7 @@ waitui_ast_program_new(waitui_ast_namespace_list *namespaces) {
     AST_NODE_NEW_DONE(waitui_ast_program);
 }
 
-waitui_ast_namespace_list *
+waitui_ast_namespace_vector *
 waitui_ast_program_getNamespaces(waitui_ast_program *this) {
     WAITUI_AST_NODE_GET(waitui_ast_program, NULL);
     return this->namespaces;
@@ -546,22 +557,19 @@ waitui_ast_program_getNamespaces(waitui_ast_program *this) {
 void waitui_ast_program_destroy(waitui_ast_program **this) {
     AST_NODE_DESTROY(waitui_ast_program);
 
-    waitui_ast_namespace_list_destroy(&(*this)->namespaces);
-
     AST_NODE_DESTROY_DONE(waitui_ast_program);
 }
 
-waitui_ast_namespace *waitui_ast_namespace_new(symbol *name,
-                                               waitui_ast_import_list *imports,
-                                               waitui_ast_class_list *classes) {
+waitui_ast_namespace *
+waitui_ast_namespace_new(waitui_arena *arena, symbol *name,
+                         waitui_ast_import_vector *imports,
+                         waitui_ast_class_vector *classes) {
     AST_NODE_NEW(waitui_ast_namespace, DEFINITION, NAMESPACE);
 
     this->name    = name;
     this->imports = imports;
     this->classes = classes;
 
-    symbol_increment_refcount(name);
-
     AST_NODE_NEW_DONE(waitui_ast_namespace);
 }
 
@@ -570,13 +578,13 @@ symbol *waitui_ast_namespace_getName(waitui_ast_namespace *this) {
     return this->name;
 }
 
-waitui_ast_import_list *
+waitui_ast_import_vector *
 waitui_ast_namespace_getImports(waitui_ast_namespace *this) {
     WAITUI_AST_NODE_GET(waitui_ast_namespace, NULL);
     return this->imports;
 }
 
-waitui_ast_class_list *
+waitui_ast_class_vector *
 waitui_ast_namespace_getClasses(waitui_ast_namespace *this) {
     WAITUI_AST_NODE_GET(waitui_ast_namespace, NULL);
     return this->classes;
@@ -585,23 +593,16 @@ waitui_ast_namespace_getClasses(waitui_ast_namespace *this) {
 void waitui_ast_namespace_destroy(waitui_ast_namespace **this) {
     AST_NODE_DESTROY(waitui_ast_namespace);
 
-    symbol_decrement_refcount(&(*this)->name);
-
-    waitui_ast_import_list_destroy(&(*this)->imports);
-    waitui_ast_class_list_destroy(&(*this)->classes);
-
     AST_NODE_DESTROY_DONE(waitui_ast_namespace);
 }
 
-waitui_ast_import *waitui_ast_import_new(symbol *name, symbol *alias) {
+waitui_ast_import *waitui_ast_import_new(waitui_arena *arena, symbol *name,
+                                         symbol *alias) {
     AST_NODE_NEW(waitui_ast_import, DEFINITION, IMPORT);
 
     this->name  = name;
     this->alias = alias;
 
-    symbol_increment_refcount(name);
-    symbol_increment_refcount(alias);
-
     AST_NODE_NEW_DONE(waitui_ast_import);
 }
 
@@ -615,21 +616,33 @@ symbol *waitui_ast_import_getAlias(waitui_ast_import *this) {
     return this->alias;
 }
 
+waitui_ast *waitui_ast_import_getModule(waitui_ast_import *this) {
+    WAITUI_AST_NODE_GET(waitui_ast_import, NULL);
+    return this->module;
+}
+
+void waitui_ast_import_setModule(waitui_ast_import *this, waitui_ast *module) {
+    WAITUI_AST_NODE_SET(waitui_ast_import);
+
+    if (!module) { return; }
+
+    this->module = module;
+
+    WAITUI_AST_NODE_SET_DONE(waitui_ast_import);
+}
+
 void waitui_ast_import_destroy(waitui_ast_import **this) {
     AST_NODE_DESTROY(waitui_ast_import);
 
-    symbol_decrement_refcount(&(*this)->name);
-    symbol_decrement_refcount(&(*this)->alias);
-
     AST_NODE_DESTROY_DONE(waitui_ast_import);
 }
 
 waitui_ast_class *
-waitui_ast_class_new(symbol *name, waitui_ast_formal_list *parameters,
-                     symbol *superClass,
-                     waitui_ast_expression_list *superClassArgs,
-                     waitui_ast_property_list *properties,
-                     waitui_ast_function_list *functions) {
+waitui_ast_class_new(waitui_arena *arena, symbol *name,
+                     waitui_ast_formal_vector *parameters, symbol *superClass,
+                     waitui_ast_expression_vector *superClassArgs,
+                     waitui_ast_property_vector *properties,
+                     waitui_ast_function_vector *functions) {
     AST_NODE_NEW(waitui_ast_class, DEFINITION, CLASS);
 
     this->name           = name;
@@ -639,9 +652,6 @@ waitui_ast_class_new(symbol *name, waitui_ast_formal_list *parameters,
     this->properties     = properties;
     this->functions      = functions;
 
-    symbol_increment_refcount(name);
-    symbol_increment_refcount(superClass);
-
     AST_NODE_NEW_DONE(waitui_ast_class);
 }
 
@@ -655,26 +665,26 @@ void waitui_ast_class_setName(waitui_ast_class *this, symbol *name) {
 
     if (!name) { return; }
 
-    if (this->name) { symbol_decrement_refcount(&this->name); }
     this->name = name;
 
-    symbol_increment_refcount(name);
-
     WAITUI_AST_NODE_SET_DONE(waitui_ast_class);
 }
 
-waitui_ast_formal_list *waitui_ast_class_getParameters(waitui_ast_class *this) {
+waitui_ast_formal_vector *
+waitui_ast_class_getParameters(waitui_ast_class *this) {
     WAITUI_AST_NODE_GET(waitui_ast_class, NULL);
     return this->parameters;
 }
 
 void waitui_ast_class_setParameters(waitui_ast_class *this,
-                                    waitui_ast_formal_list *parameters) {
+                                    waitui_ast_formal_vector *parameters) {
     WAITUI_AST_NODE_SET(waitui_ast_class);
 
     if (!parameters) { return; }
 
-    if (this->parameters) { waitui_ast_formal_list_destroy(&this->parameters); }
+    if (this->parameters) {
+        waitui_ast_formal_vector_destroy(&this->parameters);
+    }
     this->parameters = parameters;
 
     WAITUI_AST_NODE_SET_DONE(waitui_ast_class);
@@ -691,41 +701,38 @@ void waitui_ast_class_setSuperClass(waitui_ast_class *this,
 
     if (!superClass) { return; }
 
-    if (this->superClass) { symbol_decrement_refcount(&this->superClass); }
     this->superClass = superClass;
 
-    symbol_increment_refcount(superClass);
-
     WAITUI_AST_NODE_SET_DONE(waitui_ast_class);
 }
 
-waitui_ast_expression_list *
+waitui_ast_expression_vector *
 waitui_ast_class_getSuperClassArgs(waitui_ast_class *this) {
     WAITUI_AST_NODE_GET(waitui_ast_class, NULL);
     return this->superClassArgs;
 }
 
 void waitui_ast_class_setSuperClassArgs(
-        waitui_ast_class *this, waitui_ast_expression_list *superClassArgs) {
+        waitui_ast_class *this, waitui_ast_expression_vector *superClassArgs) {
     WAITUI_AST_NODE_SET(waitui_ast_class);
 
     if (!superClassArgs) { return; }
 
     if (this->superClassArgs) {
-        waitui_ast_expression_list_destroy(&this->superClassArgs);
+        waitui_ast_expression_vector_destroy(&this->superClassArgs);
     }
     this->superClassArgs = superClassArgs;
 
     WAITUI_AST_NODE_SET_DONE(waitui_ast_class);
 }
 
-waitui_ast_property_list *
+waitui_ast_property_vector *
 waitui_ast_class_getProperties(waitui_ast_class *this) {
     WAITUI_AST_NODE_GET(waitui_ast_class, NULL);
     return this->properties;
 }
 
-waitui_ast_function_list *
+waitui_ast_function_vector *
 waitui_ast_class_getFunctions(waitui_ast_class *this) {
     WAITUI_AST_NODE_GET(waitui_ast_class, NULL);
     return this->functions;
@@ -734,18 +741,11 @@ waitui_ast_class_getFunctions(waitui_ast_class *this) {
 void waitui_ast_class_destroy(waitui_ast_class **this) {
     AST_NODE_DESTROY(waitui_ast_class);
 
-    symbol_decrement_refcount(&(*this)->superClass);
-    symbol_decrement_refcount(&(*this)->name);
-
-    waitui_ast_formal_list_destroy(&(*this)->parameters);
-    waitui_ast_expression_list_destroy(&(*this)->superClassArgs);
-    waitui_ast_property_list_destroy(&(*this)->properties);
-    waitui_ast_function_list_destroy(&(*this)->functions);
-
     AST_NODE_DESTROY_DONE(waitui_ast_class);
 }
 
-waitui_ast_formal *waitui_ast_formal_new(symbol *identifier, symbol *type,
+waitui_ast_formal *waitui_ast_formal_new(waitui_arena *arena,
+                                         symbol *identifier, symbol *type,
                                          bool isLazy) {
     AST_NODE_NEW(waitui_ast_formal, DEFINITION, FORMAL);
 
@@ -753,9 +753,6 @@ waitui_ast_formal *waitui_ast_formal_new(symbol *identifier, symbol *type,
     this->type       = type;
     this->isLazy     = isLazy;
 
-    symbol_increment_refcount(identifier);
-    symbol_increment_refcount(type);
-
     AST_NODE_NEW_DONE(waitui_ast_formal);
 }
 
@@ -777,16 +774,13 @@ bool waitui_ast_formal_isLazy(waitui_ast_formal *this) {
 void waitui_ast_formal_destroy(waitui_ast_formal **this) {
     AST_NODE_DESTROY(waitui_ast_formal);
 
-    symbol_decrement_refcount(&(*this)->type);
-    symbol_decrement_refcount(&(*this)->identifier);
-
     AST_NODE_DESTROY_DONE(waitui_ast_formal);
 }
 
 waitui_ast_function *
-waitui_ast_function_new(symbol *functionName,
-                        waitui_ast_formal_list *parameters, symbol *returnType,
-                        waitui_ast_expression *body,
+waitui_ast_function_new(waitui_arena *arena, symbol *functionName,
+                        waitui_ast_formal_vector *parameters,
+                        symbol *returnType, waitui_ast_expression *body,
                         waitui_ast_function_visibility visibility,
                         bool isAbstract, bool isFinal, bool isOverwrite) {
     AST_NODE_NEW(waitui_ast_function, DEFINITION, FUNCTION);
@@ -800,9 +794,6 @@ waitui_ast_function_new(symbol *functionName,
     this->isFinal      = isFinal;
     this->isOverwrite  = isOverwrite;
 
-    symbol_increment_refcount(functionName);
-    symbol_increment_refcount(returnType);
-
     AST_NODE_NEW_DONE(waitui_ast_function);
 }
 
@@ -811,7 +802,7 @@ symbol *waitui_ast_function_getFunctionName(waitui_ast_function *this) {
     return this->functionName;
 }
 
-waitui_ast_formal_list *
+waitui_ast_formal_vector *
 waitui_ast_function_getParameters(waitui_ast_function *this) {
     WAITUI_AST_NODE_GET(waitui_ast_function, NULL);
     return this->parameters;
@@ -897,16 +888,11 @@ void waitui_ast_function_setOverwrite(waitui_ast_function *this,
 void waitui_ast_function_destroy(waitui_ast_function **this) {
     AST_NODE_DESTROY(waitui_ast_function);
 
-    symbol_decrement_refcount(&(*this)->returnType);
-    symbol_decrement_refcount(&(*this)->functionName);
-
-    waitui_ast_formal_list_destroy(&(*this)->parameters);
-    waitui_ast_expression_destroy(&(*this)->body);
-
     AST_NODE_DESTROY_DONE(waitui_ast_function);
 }
 
-waitui_ast_property *waitui_ast_property_new(symbol *name, symbol *type,
+waitui_ast_property *waitui_ast_property_new(waitui_arena *arena, symbol *name,
+                                             symbol *type,
                                              waitui_ast_expression *value) {
     AST_NODE_NEW(waitui_ast_property, DEFINITION, PROPERTY);
 
@@ -914,9 +900,6 @@ waitui_ast_property *waitui_ast_property_new(symbol *name, symbol *type,
     this->type  = type;
     this->value = value;
 
-    symbol_increment_refcount(name);
-    symbol_increment_refcount(type);
-
     AST_NODE_NEW_DONE(waitui_ast_property);
 }
 
@@ -935,19 +918,24 @@ waitui_ast_expression *waitui_ast_property_getValue(waitui_ast_property *this) {
     return this->value;
 }
 
-void waitui_ast_property_destroy(waitui_ast_property **this) {
-    AST_NODE_DESTROY(waitui_ast_property);
+void waitui_ast_property_setValue(waitui_ast_property *this,
+                                  waitui_ast_expression *value) {
+    WAITUI_AST_NODE_SET(waitui_ast_property);
 
-    symbol_decrement_refcount(&(*this)->name);
-    symbol_decrement_refcount(&(*this)->type);
+    this->value = value;
+
+    WAITUI_AST_NODE_SET_DONE(waitui_ast_property);
+}
 
-    waitui_ast_expression_destroy(&(*this)->value);
+void waitui_ast_property_destroy(waitui_ast_property **this) {
+    AST_NODE_DESTROY(waitui_ast_property);
 
     AST_NODE_DESTROY_DONE(waitui_ast_property);
 }
 
 waitui_ast_block *
-waitui_ast_block_new(waitui_ast_expression_list *expressions) {
+waitui_ast_block_new(waitui_arena *arena,
+                     waitui_ast_expression_vector *expressions) {
     AST_NODE_NEW(waitui_ast_block, EXPRESSION, BLOCK);
 
     this->expressions = expressions;
@@ -955,7 +943,7 @@ waitui_ast_block_new(waitui_ast_expression_list *expressions) {
     AST_NODE_NEW_DONE(waitui_ast_block);
 }
 
-waitui_ast_expression_list *
+waitui_ast_expression_vector *
 waitui_ast_block_getExpressions(waitui_ast_block *this) {
     WAITUI_AST_NODE_GET(waitui_ast_block, NULL);
     return this->expressions;
@@ -964,13 +952,12 @@ waitui_ast_block_getExpressions(waitui_ast_block *this) {
 void waitui_ast_block_destroy(waitui_ast_block **this) {
     AST_NODE_DESTROY(waitui_ast_block);
 
-    waitui_ast_expression_list_destroy(&(*this)->expressions);
-
     AST_NODE_DESTROY_DONE(waitui_ast_block);
 }
 
 waitui_ast_let *
-waitui_ast_let_new(waitui_ast_initialization_list *initializations,
+waitui_ast_let_new(waitui_arena *arena,
+                   waitui_ast_initialization_vector *initializations,
                    waitui_ast_expression *body) {
     AST_NODE_NEW(waitui_ast_let, EXPRESSION, LET);
 
@@ -980,7 +967,7 @@ waitui_ast_let_new(waitui_ast_initialization_list *initializations,
     AST_NODE_NEW_DONE(waitui_ast_let);
 }
 
-waitui_ast_initialization_list *
+waitui_ast_initialization_vector *
 waitui_ast_let_getInitializations(waitui_ast_let *this) {
     WAITUI_AST_NODE_GET(waitui_ast_let, NULL);
     return this->initializations;
@@ -991,27 +978,30 @@ waitui_ast_expression *waitui_ast_let_getBody(waitui_ast_let *this) {
     return this->body;
 }
 
+void waitui_ast_let_setBody(waitui_ast_let *this,
+                            waitui_ast_expression *body) {
+    WAITUI_AST_NODE_SET(waitui_ast_let);
+
+    this->body = body;
+
+    WAITUI_AST_NODE_SET_DONE(waitui_ast_let);
+}
+
 void waitui_ast_let_destroy(waitui_ast_let **this) {
     AST_NODE_DESTROY(waitui_ast_let);
 
-    waitui_ast_initialization_list_destroy(&(*this)->initializations);
-    waitui_ast_expression_destroy(&(*this)->body);
-
     AST_NODE_DESTROY_DONE(waitui_ast_let);
 }
 
 waitui_ast_initialization *
-waitui_ast_initialization_new(symbol *identifier, symbol *type,
-                              waitui_ast_expression *value) {
+waitui_ast_initialization_new(waitui_arena *arena, symbol *identifier,
+                              symbol *type, waitui_ast_expression *value) {
     AST_NODE_NEW(waitui_ast_initialization, EXPRESSION, INITIALIZATION);
 
     this->identifier = identifier;
     this->type       = type;
     this->value      = value;
 
-    symbol_increment_refcount(identifier);
-    symbol_increment_refcount(type);
-
     AST_NODE_NEW_DONE(waitui_ast_initialization);
 }
 
@@ -1032,19 +1022,23 @@ waitui_ast_initialization_getValue(waitui_ast_initialization *this) {
     return this->value;
 }
 
-void waitui_ast_initialization_destroy(waitui_ast_initialization **this) {
-    AST_NODE_DESTROY(waitui_ast_initialization);
+void waitui_ast_initialization_setValue(waitui_ast_initialization *this,
+                                        waitui_ast_expression *value) {
+    WAITUI_AST_NODE_SET(waitui_ast_initialization);
 
-    symbol_decrement_refcount(&(*this)->identifier);
-    symbol_decrement_refcount(&(*this)->type);
+    this->value = value;
 
-    waitui_ast_expression_destroy(&(*this)->value);
+    WAITUI_AST_NODE_SET_DONE(waitui_ast_initialization);
+}
+
+void waitui_ast_initialization_destroy(waitui_ast_initialization **this) {
+    AST_NODE_DESTROY(waitui_ast_initialization);
 
     AST_NODE_DESTROY_DONE(waitui_ast_initialization);
 }
 
 waitui_ast_assignment *
-waitui_ast_assignment_new(symbol *identifier,
+waitui_ast_assignment_new(waitui_arena *arena, symbol *identifier,
                           waitui_ast_assignment_operator operator,
                           waitui_ast_expression * value) {
     AST_NODE_NEW(waitui_ast_assignment, EXPRESSION, ASSIGNMENT);
@@ -1053,8 +1047,6 @@ waitui_ast_assignment_new(symbol *identifier,
     this->operator   = operator;
     this->value      = value;
 
-    symbol_increment_refcount(identifier);
-
     AST_NODE_NEW_DONE(waitui_ast_assignment);
 }
 
@@ -1076,25 +1068,29 @@ waitui_ast_assignment_getValue(waitui_ast_assignment *this) {
     return this->value;
 }
 
-void waitui_ast_assignment_destroy(waitui_ast_assignment **this) {
-    AST_NODE_DESTROY(waitui_ast_assignment);
+void waitui_ast_assignment_setValue(waitui_ast_assignment *this,
+                                    waitui_ast_expression *value) {
+    WAITUI_AST_NODE_SET(waitui_ast_assignment);
 
-    symbol_decrement_refcount(&(*this)->identifier);
+    this->value = value;
+
+    WAITUI_AST_NODE_SET_DONE(waitui_ast_assignment);
+}
 
-    waitui_ast_expression_destroy(&(*this)->value);
+void waitui_ast_assignment_destroy(waitui_ast_assignment **this) {
+    AST_NODE_DESTROY(waitui_ast_assignment);
 
     AST_NODE_DESTROY_DONE(waitui_ast_assignment);
 }
 
-waitui_ast_cast *waitui_ast_cast_new(waitui_ast_expression *object,
-                                     symbol *type) {
+waitui_ast_cast *
+waitui_ast_cast_new(waitui_arena *arena, waitui_ast_expression *object,
+                    symbol *type) {
     AST_NODE_NEW(waitui_ast_cast, EXPRESSION, CAST);
 
     this->object = object;
     this->type   = type;
 
-    symbol_increment_refcount(type);
-
     AST_NODE_NEW_DONE(waitui_ast_cast);
 }
 
@@ -1103,6 +1099,15 @@ waitui_ast_expression *waitui_ast_cast_getObject(waitui_ast_cast *this) {
     return this->object;
 }
 
+void waitui_ast_cast_setObject(waitui_ast_cast *this,
+                               waitui_ast_expression *object) {
+    WAITUI_AST_NODE_SET(waitui_ast_cast);
+
+    this->object = object;
+
+    WAITUI_AST_NODE_SET_DONE(waitui_ast_cast);
+}
+
 symbol *waitui_ast_cast_getType(waitui_ast_cast *this) {
     WAITUI_AST_NODE_GET(waitui_ast_cast, NULL);
     return this->type;
@@ -1111,14 +1116,11 @@ symbol *waitui_ast_cast_getType(waitui_ast_cast *this) {
 void waitui_ast_cast_destroy(waitui_ast_cast **this) {
     AST_NODE_DESTROY(waitui_ast_cast);
 
-    symbol_decrement_refcount(&(*this)->type);
-
-    waitui_ast_expression_destroy(&(*this)->object);
-
     AST_NODE_DESTROY_DONE(waitui_ast_cast);
 }
 
-waitui_ast_if_else *waitui_ast_if_else_new(waitui_ast_expression *condition,
+waitui_ast_if_else *waitui_ast_if_else_new(waitui_arena *arena,
+                                           waitui_ast_expression *condition,
                                            waitui_ast_expression *thenBranch,
                                            waitui_ast_expression *elseBranch) {
     AST_NODE_NEW(waitui_ast_if_else, EXPRESSION, IF_ELSE);
@@ -1136,29 +1138,53 @@ waitui_ast_if_else_getCondition(waitui_ast_if_else *this) {
     return this->condition;
 }
 
+void waitui_ast_if_else_setCondition(waitui_ast_if_else *this,
+                                     waitui_ast_expression *condition) {
+    WAITUI_AST_NODE_SET(waitui_ast_if_else);
+
+    this->condition = condition;
+
+    WAITUI_AST_NODE_SET_DONE(waitui_ast_if_else);
+}
+
 waitui_ast_expression *
 waitui_ast_if_else_getThenBranch(waitui_ast_if_else *this) {
     WAITUI_AST_NODE_GET(waitui_ast_if_else, NULL);
     return this->thenBranch;
 }
 
+void waitui_ast_if_else_setThenBranch(waitui_ast_if_else *this,
+                                      waitui_ast_expression *thenBranch) {
+    WAITUI_AST_NODE_SET(waitui_ast_if_else);
+
+    this->thenBranch = thenBranch;
+
+    WAITUI_AST_NODE_SET_DONE(waitui_ast_if_else);
+}
+
 waitui_ast_expression *
 waitui_ast_if_else_getElseBranch(waitui_ast_if_else *this) {
     WAITUI_AST_NODE_GET(waitui_ast_if_else, NULL);
     return this->elseBranch;
 }
 
+void waitui_ast_if_else_setElseBranch(waitui_ast_if_else *this,
+                                      waitui_ast_expression *elseBranch) {
+    WAITUI_AST_NODE_SET(waitui_ast_if_else);
+
+    this->elseBranch = elseBranch;
+
+    WAITUI_AST_NODE_SET_DONE(waitui_ast_if_else);
+}
+
 void waitui_ast_if_else_destroy(waitui_ast_if_else **this) {
     AST_NODE_DESTROY(waitui_ast_if_else);
 
-    waitui_ast_expression_destroy(&(*this)->condition);
-    waitui_ast_expression_destroy(&(*this)->thenBranch);
-    waitui_ast_expression_destroy(&(*this)->elseBranch);
-
     AST_NODE_DESTROY_DONE(waitui_ast_if_else);
 }
 
-waitui_ast_while *waitui_ast_while_new(waitui_ast_expression *condition,
+waitui_ast_while *waitui_ast_while_new(waitui_arena *arena,
+                                       waitui_ast_expression *condition,
                                        waitui_ast_expression *body) {
     AST_NODE_NEW(waitui_ast_while, EXPRESSION, WHILE);
 
@@ -1173,22 +1199,38 @@ waitui_ast_expression *waitui_ast_while_getCondition(waitui_ast_while *this) {
     return this->condition;
 }
 
+void waitui_ast_while_setCondition(waitui_ast_while *this,
+                                   waitui_ast_expression *condition) {
+    WAITUI_AST_NODE_SET(waitui_ast_while);
+
+    this->condition = condition;
+
+    WAITUI_AST_NODE_SET_DONE(waitui_ast_while);
+}
+
 waitui_ast_expression *waitui_ast_while_getBody(waitui_ast_while *this) {
     WAITUI_AST_NODE_GET(waitui_ast_while, NULL);
     return this->body;
 }
 
+void waitui_ast_while_setBody(waitui_ast_while *this,
+                              waitui_ast_expression *body) {
+    WAITUI_AST_NODE_SET(waitui_ast_while);
+
+    this->body = body;
+
+    WAITUI_AST_NODE_SET_DONE(waitui_ast_while);
+}
+
 void waitui_ast_while_destroy(waitui_ast_while **this) {
     AST_NODE_DESTROY(waitui_ast_while);
 
-    waitui_ast_expression_destroy(&(*this)->condition);
-    waitui_ast_expression_destroy(&(*this)->body);
-
     AST_NODE_DESTROY_DONE(waitui_ast_while);
 }
 
 waitui_ast_binary_expression *
-waitui_ast_binary_expression_new(waitui_ast_expression *left,
+waitui_ast_binary_expression_new(waitui_arena *arena,
+                                 waitui_ast_expression *left,
                                  waitui_ast_binary_operator operator,
                                  waitui_ast_expression * right) {
     AST_NODE_NEW(waitui_ast_binary_expression, EXPRESSION, BINARY_EXPRESSION);
@@ -1206,6 +1248,15 @@ waitui_ast_binary_expression_getLeft(waitui_ast_binary_expression *this) {
     return this->left;
 }
 
+void waitui_ast_binary_expression_setLeft(waitui_ast_binary_expression *this,
+                                          waitui_ast_expression *left) {
+    WAITUI_AST_NODE_SET(waitui_ast_binary_expression);
+
+    this->left = left;
+
+    WAITUI_AST_NODE_SET_DONE(waitui_ast_binary_expression);
+}
+
 waitui_ast_binary_operator
 waitui_ast_binary_expression_getOperator(waitui_ast_binary_expression *this) {
     WAITUI_AST_NODE_GET(waitui_ast_binary_expression,
@@ -1219,17 +1270,24 @@ waitui_ast_binary_expression_getRight(waitui_ast_binary_expression *this) {
     return this->right;
 }
 
+void waitui_ast_binary_expression_setRight(waitui_ast_binary_expression *this,
+                                           waitui_ast_expression *right) {
+    WAITUI_AST_NODE_SET(waitui_ast_binary_expression);
+
+    this->right = right;
+
+    WAITUI_AST_NODE_SET_DONE(waitui_ast_binary_expression);
+}
+
 void waitui_ast_binary_expression_destroy(waitui_ast_binary_expression **this) {
     AST_NODE_DESTROY(waitui_ast_binary_expression);
 
-    waitui_ast_expression_destroy(&(*this)->left);
-    waitui_ast_expression_destroy(&(*this)->right);
-
     AST_NODE_DESTROY_DONE(waitui_ast_binary_expression);
 }
 
 waitui_ast_unary_expression *
-waitui_ast_unary_expression_new(waitui_ast_unary_operator operator,
+waitui_ast_unary_expression_new(waitui_arena *arena,
+                                waitui_ast_unary_operator operator,
                                 waitui_ast_expression * expression) {
     AST_NODE_NEW(waitui_ast_unary_expression, EXPRESSION, UNARY_EXPRESSION);
 
@@ -1252,16 +1310,24 @@ waitui_ast_unary_expression_getExpression(waitui_ast_unary_expression *this) {
     return this->expression;
 }
 
+void waitui_ast_unary_expression_setExpression(
+        waitui_ast_unary_expression *this, waitui_ast_expression *expression) {
+    WAITUI_AST_NODE_SET(waitui_ast_unary_expression);
+
+    this->expression = expression;
+
+    WAITUI_AST_NODE_SET_DONE(waitui_ast_unary_expression);
+}
+
 void waitui_ast_unary_expression_destroy(waitui_ast_unary_expression **this) {
     AST_NODE_DESTROY(waitui_ast_unary_expression);
 
-    waitui_ast_expression_destroy(&(*this)->expression);
-
     AST_NODE_DESTROY_DONE(waitui_ast_unary_expression);
 }
 
 waitui_ast_lazy_expression *
-waitui_ast_lazy_expression_new(waitui_ast_expression *expression,
+waitui_ast_lazy_expression_new(waitui_arena *arena,
+                               waitui_ast_expression *expression,
                                void *context) {
     AST_NODE_NEW(waitui_ast_lazy_expression, EXPRESSION, LAZY_EXPRESSION);
 
@@ -1271,19 +1337,31 @@ waitui_ast_lazy_expression_new(waitui_ast_expression *expression,
     AST_NODE_NEW_DONE(waitui_ast_lazy_expression);
 }
 
+waitui_ast_expression *
+waitui_ast_lazy_expression_getExpression(waitui_ast_lazy_expression *this) {
+    WAITUI_AST_NODE_GET(waitui_ast_lazy_expression, NULL);
+    return this->expression;
+}
+
+void waitui_ast_lazy_expression_setExpression(
+        waitui_ast_lazy_expression *this, waitui_ast_expression *expression) {
+    WAITUI_AST_NODE_SET(waitui_ast_lazy_expression);
+
+    this->expression = expression;
+
+    WAITUI_AST_NODE_SET_DONE(waitui_ast_lazy_expression);
+}
+
 void waitui_ast_lazy_expression_destroy(waitui_ast_lazy_expression **this) {
     AST_NODE_DESTROY(waitui_ast_lazy_expression);
 
-    waitui_ast_expression_destroy(&(*this)->expression);
-
     AST_NODE_DESTROY_DONE(waitui_ast_lazy_expression);
 }
 
-waitui_ast_native_expression *waitui_ast_native_expression_new(void *func) {
+waitui_ast_native_expression *
+waitui_ast_native_expression_new(waitui_arena *arena) {
     AST_NODE_NEW(waitui_ast_native_expression, EXPRESSION, NATIVE_EXPRESSION);
 
-    this->func = func;
-
     AST_NODE_NEW_DONE(waitui_ast_native_expression);
 }
 
@@ -1294,15 +1372,13 @@ void waitui_ast_native_expression_destroy(waitui_ast_native_expression **this) {
 }
 
 waitui_ast_constructor_call *
-waitui_ast_constructor_call_new(symbol *name,
-                                waitui_ast_expression_list *args) {
+waitui_ast_constructor_call_new(waitui_arena *arena, symbol *name,
+                                waitui_ast_expression_vector *args) {
     AST_NODE_NEW(waitui_ast_constructor_call, EXPRESSION, CONSTRUCTOR_CALL);
 
     this->name = name;
     this->args = args;
 
-    symbol_increment_refcount(name);
-
     AST_NODE_NEW_DONE(waitui_ast_constructor_call);
 }
 
@@ -1311,7 +1387,7 @@ symbol *waitui_ast_constructor_call_getName(waitui_ast_constructor_call *this) {
     return this->name;
 }
 
-waitui_ast_expression_list *
+waitui_ast_expression_vector *
 waitui_ast_constructor_call_getArgs(waitui_ast_constructor_call *this) {
     WAITUI_AST_NODE_GET(waitui_ast_constructor_call, NULL);
     return this->args;
@@ -1320,25 +1396,19 @@ waitui_ast_constructor_call_getArgs(waitui_ast_constructor_call *this) {
 void waitui_ast_constructor_call_destroy(waitui_ast_constructor_call **this) {
     AST_NODE_DESTROY(waitui_ast_constructor_call);
 
-    symbol_decrement_refcount(&(*this)->name);
-
-    waitui_ast_expression_list_destroy(&(*this)->args);
-
     AST_NODE_DESTROY_DONE(waitui_ast_constructor_call);
 }
 
 waitui_ast_function_call *
-waitui_ast_function_call_new(waitui_ast_expression *object,
+waitui_ast_function_call_new(waitui_arena *arena, waitui_ast_expression *object,
                              symbol *functionName,
-                             waitui_ast_expression_list *args) {
+                             waitui_ast_expression_vector *args) {
     AST_NODE_NEW(waitui_ast_function_call, EXPRESSION, FUNCTION_CALL);
 
     this->object       = object;
     this->functionName = functionName;
     this->args         = args;
 
-    symbol_increment_refcount(functionName);
-
     AST_NODE_NEW_DONE(waitui_ast_function_call);
 }
 
@@ -1348,13 +1418,22 @@ waitui_ast_function_call_getObject(waitui_ast_function_call *this) {
     return this->object;
 }
 
+void waitui_ast_function_call_setObject(waitui_ast_function_call *this,
+                                        waitui_ast_expression *object) {
+    WAITUI_AST_NODE_SET(waitui_ast_function_call);
+
+    this->object = object;
+
+    WAITUI_AST_NODE_SET_DONE(waitui_ast_function_call);
+}
+
 symbol *
 waitui_ast_function_call_getFunctionName(waitui_ast_function_call *this) {
     WAITUI_AST_NODE_GET(waitui_ast_function_call, NULL);
     return this->functionName;
 }
 
-waitui_ast_expression_list *
+waitui_ast_expression_vector *
 waitui_ast_function_call_getArgs(waitui_ast_function_call *this) {
     WAITUI_AST_NODE_GET(waitui_ast_function_call, NULL);
     return this->args;
@@ -1363,25 +1442,18 @@ waitui_ast_function_call_getArgs(waitui_ast_function_call *this) {
 void waitui_ast_function_call_destroy(waitui_ast_function_call **this) {
     AST_NODE_DESTROY(waitui_ast_function_call);
 
-    symbol_decrement_refcount(&(*this)->functionName);
-
-    waitui_ast_expression_destroy(&(*this)->object);
-    waitui_ast_expression_list_destroy(&(*this)->args);
-
     AST_NODE_DESTROY_DONE(waitui_ast_function_call);
 }
 
 waitui_ast_super_function_call *
-waitui_ast_super_function_call_new(symbol *functionName,
-                                   waitui_ast_expression_list *args) {
+waitui_ast_super_function_call_new(waitui_arena *arena, symbol *functionName,
+                                   waitui_ast_expression_vector *args) {
     AST_NODE_NEW(waitui_ast_super_function_call, EXPRESSION,
                  SUPER_FUNCTION_CALL);
 
     this->functionName = functionName;
     this->args         = args;
 
-    symbol_increment_refcount(functionName);
-
     AST_NODE_NEW_DONE(waitui_ast_super_function_call);
 }
 
@@ -1391,7 +1463,7 @@ symbol *waitui_ast_super_function_call_getFunctionName(
     return this->functionName;
 }
 
-waitui_ast_expression_list *
+waitui_ast_expression_vector *
 waitui_ast_super_function_call_getArgs(waitui_ast_super_function_call *this) {
     WAITUI_AST_NODE_GET(waitui_ast_super_function_call, NULL);
     return this->args;
@@ -1401,20 +1473,15 @@ void waitui_ast_super_function_call_destroy(
         waitui_ast_super_function_call **this) {
     AST_NODE_DESTROY(waitui_ast_super_function_call);
 
-    symbol_decrement_refcount(&(*this)->functionName);
-
-    waitui_ast_expression_list_destroy(&(*this)->args);
-
     AST_NODE_DESTROY_DONE(waitui_ast_super_function_call);
 }
 
-waitui_ast_reference *waitui_ast_reference_new(symbol *value) {
+waitui_ast_reference *waitui_ast_reference_new(waitui_arena *arena,
+                                               symbol *value) {
     AST_NODE_NEW(waitui_ast_reference, EXPRESSION, REFERENCE);
 
     this->value = value;
 
-    symbol_increment_refcount(value);
-
     AST_NODE_NEW_DONE(waitui_ast_reference);
 }
 
@@ -1426,12 +1493,10 @@ symbol *waitui_ast_reference_getValue(waitui_ast_reference *this) {
 void waitui_ast_reference_destroy(waitui_ast_reference **this) {
     AST_NODE_DESTROY(waitui_ast_reference);
 
-    symbol_decrement_refcount(&(*this)->value);
-
     AST_NODE_DESTROY_DONE(waitui_ast_reference);
 }
 
-waitui_ast_this_literal *waitui_ast_this_literal_new(void) {
+waitui_ast_this_literal *waitui_ast_this_literal_new(waitui_arena *arena) {
     AST_NODE_NEW(waitui_ast_this_literal, EXPRESSION, THIS_LITERAL);
 
     AST_NODE_NEW_DONE(waitui_ast_this_literal);
@@ -1443,14 +1508,11 @@ void waitui_ast_this_literal_destroy(waitui_ast_this_literal **this) {
     AST_NODE_DESTROY_DONE(waitui_ast_this_literal);
 }
 
-waitui_ast_integer_literal *waitui_ast_integer_literal_new(str value) {
+waitui_ast_integer_literal *waitui_ast_integer_literal_new(waitui_arena *arena,
+                                                           str value) {
     AST_NODE_NEW(waitui_ast_integer_literal, EXPRESSION, INTEGER_LITERAL);
 
-    STR_COPY(&this->value, &value);
-    if (!this->value.s) {
-        waitui_ast_integer_literal_destroy(&this);
-        return NULL;
-    }
+    this->value = value;
 
     AST_NODE_NEW_DONE(waitui_ast_integer_literal);
 }
@@ -1463,12 +1525,11 @@ str *waitui_ast_integer_literal_getValue(waitui_ast_integer_literal *this) {
 void waitui_ast_integer_literal_destroy(waitui_ast_integer_literal **this) {
     AST_NODE_DESTROY(waitui_ast_integer_literal);
 
-    STR_FREE(&(*this)->value);
-
     AST_NODE_DESTROY_DONE(waitui_ast_integer_literal);
 }
 
-waitui_ast_boolean_literal *waitui_ast_boolean_literal_new(bool value) {
+waitui_ast_boolean_literal *waitui_ast_boolean_literal_new(waitui_arena *arena,
+                                                           bool value) {
     AST_NODE_NEW(waitui_ast_boolean_literal, EXPRESSION, BOOLEAN_LITERAL);
 
     this->value = value;
@@ -1487,14 +1548,11 @@ void waitui_ast_boolean_literal_destroy(waitui_ast_boolean_literal **this) {
     AST_NODE_DESTROY_DONE(waitui_ast_boolean_literal);
 }
 
-waitui_ast_decimal_literal *waitui_ast_decimal_literal_new(str value) {
+waitui_ast_decimal_literal *waitui_ast_decimal_literal_new(waitui_arena *arena,
+                                                           str value) {
     AST_NODE_NEW(waitui_ast_decimal_literal, EXPRESSION, DECIMAL_LITERAL);
 
-    STR_COPY(&this->value, &value);
-    if (!this->value.s) {
-        waitui_ast_decimal_literal_destroy(&this);
-        return NULL;
-    }
+    this->value = value;
 
     AST_NODE_NEW_DONE(waitui_ast_decimal_literal);
 }
@@ -1507,12 +1565,10 @@ str *waitui_ast_decimal_literal_getValue(waitui_ast_decimal_literal *this) {
 void waitui_ast_decimal_literal_destroy(waitui_ast_decimal_literal **this) {
     AST_NODE_DESTROY(waitui_ast_decimal_literal);
 
-    STR_FREE(&(*this)->value);
-
     AST_NODE_DESTROY_DONE(waitui_ast_decimal_literal);
 }
 
-waitui_ast_null_literal *waitui_ast_null_literal_new(void) {
+waitui_ast_null_literal *waitui_ast_null_literal_new(waitui_arena *arena) {
     AST_NODE_NEW(waitui_ast_null_literal, EXPRESSION, NULL_LITERAL);
 
     AST_NODE_NEW_DONE(waitui_ast_null_literal);
@@ -1524,14 +1580,11 @@ void waitui_ast_null_literal_destroy(waitui_ast_null_literal **this) {
     AST_NODE_DESTROY_DONE(waitui_ast_null_literal);
 }
 
-waitui_ast_string_literal *waitui_ast_string_literal_new(str value) {
+waitui_ast_string_literal *waitui_ast_string_literal_new(waitui_arena *arena,
+                                                         str value) {
     AST_NODE_NEW(waitui_ast_string_literal, EXPRESSION, STRING_LITERAL);
 
-    STR_COPY(&this->value, &value);
-    if (!this->value.s) {
-        waitui_ast_string_literal_destroy(&this);
-        return NULL;
-    }
+    this->value = value;
 
     AST_NODE_NEW_DONE(waitui_ast_string_literal);
 }
@@ -1544,7 +1597,5 @@ str *waitui_ast_string_literal_getValue(waitui_ast_string_literal *this) {
 void waitui_ast_string_literal_destroy(waitui_ast_string_literal **this) {
     AST_NODE_DESTROY(waitui_ast_string_literal);
 
-    STR_FREE(&(*this)->value);
-
     AST_NODE_DESTROY_DONE(waitui_ast_string_literal);
 }
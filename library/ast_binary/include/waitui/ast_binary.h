@@ -0,0 +1,245 @@
+/**
+ * @file ast_binary.h
+ * @author rick
+ * @date 17.10.26
+ * @brief File for the binary AST implementation
+ */
+
+#ifndef WAITUI_AST_BINARY_H
+#define WAITUI_AST_BINARY_H
+
+#include <waitui/ast.h>
+#include <waitui/str.h>
+
+#include <stddef.h>
+#include <stdio.h>
+
+
+// -----------------------------------------------------------------------------
+//  Public defines
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The version of the binary AST format written by this library.
+ */
+#define WAITUI_AST_BINARY_VERSION 2
+
+/**
+ * @brief Flags of a binary AST node.
+ */
+#define WAITUI_AST_BINARY_FLAG_LAZY 0x01
+#define WAITUI_AST_BINARY_FLAG_ABSTRACT 0x02
+#define WAITUI_AST_BINARY_FLAG_FINAL 0x04
+#define WAITUI_AST_BINARY_FLAG_OVERWRITE 0x08
+
+
+// -----------------------------------------------------------------------------
+//  Public types
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Type representing a binary AST image.
+ * @note The image starts with a header, followed by the node and list records
+ *       in pre-order, the reference, the symbol and the string table. Records
+ *       refer to each other by offsets relative to the start of the image, 0
+ *       is used for no record, so the image can be used right out of a memory
+ *       mapping. Every distinct string is stored once in the string table and
+ *       every distinct pair of identifier and symbol type once in the symbol
+ *       table, a reference only adds its line and column. The fields of a
+ *       node are numbered like waitui_ast_field and hold a node, a list of
+ *       nodes, the index of a reference plus one or the index of a string,
+ *       the operators, the function visibility and the boolean literal value
+ *       are stored as the value of the node and the booleans of formals and
+ *       functions as its flags.
+ */
+typedef struct waitui_ast_binary waitui_ast_binary;
+
+/**
+ * @brief Type representing a node record inside of a binary AST image.
+ */
+typedef struct waitui_ast_binary_node waitui_ast_binary_node;
+
+/**
+ * @brief Type for a symbol read from a binary AST image.
+ * @note The identifier points into the image and is NUL terminated. The line
+ *       and column are the ones of the reference in the field.
+ */
+typedef struct waitui_ast_binary_symbol {
+    str identifier;
+    symbol_type type;
+    unsigned long int line;
+    unsigned long int column;
+} waitui_ast_binary_symbol;
+
+
+// -----------------------------------------------------------------------------
+//  Public functions
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Write the AST as binary AST image into the file.
+ * @param[in] ast The AST to write
+ * @param[in,out] file The file to write the image to
+ * @retval 1 Ok
+ * @retval 0 Memory allocation or writing failed
+ * @note The modules of the imports and the native functions are not part of
+ *       the image.
+ */
+extern int waitui_ast_binary_write(waitui_ast *ast, FILE *file);
+
+/**
+ * @brief Open a binary AST image from a file by mapping it into memory.
+ * @param[in] fileName The name of the file to open
+ * @return A pointer to waitui_ast_binary or NULL if the file is no valid image
+ */
+extern waitui_ast_binary *waitui_ast_binary_open(const char *fileName);
+
+/**
+ * @brief Open a binary AST image from memory.
+ * @param[in] data The image, aligned to at least 4 bytes
+ * @param[in] size The size of the image
+ * @return A pointer to waitui_ast_binary or NULL if the data is no valid image
+ * @note The data is borrowed and has to outlive the waitui_ast_binary.
+ */
+extern waitui_ast_binary *waitui_ast_binary_fromMemory(const void *data,
+                                                       size_t size);
+
+/**
+ * @brief Close the binary AST image and unmap it.
+ * @param[in,out] this The binary AST image to close
+ */
+extern void waitui_ast_binary_close(waitui_ast_binary **this);
+
+/**
+ * @brief Get the program node of the binary AST image.
+ * @param[in] this The binary AST image to get the program from
+ * @return On success a pointer to the program node, else NULL
+ */
+extern const waitui_ast_binary_node *
+waitui_ast_binary_getProgram(const waitui_ast_binary *this);
+
+/**
+ * @brief Get the number of nodes in the binary AST image.
+ * @param[in] this The binary AST image to ask
+ * @return The number of nodes
+ */
+extern unsigned long int
+waitui_ast_binary_getNodeCount(const waitui_ast_binary *this);
+
+/**
+ * @brief Get the node type of the binary AST node.
+ * @param[in] node The node to get the type of
+ * @return The node type
+ */
+extern waitui_ast_node_type
+waitui_ast_binary_node_getNodeType(const waitui_ast_binary_node *node);
+
+/**
+ * @brief Get the definition type of the binary AST node.
+ * @param[in] node The node to get the type of
+ * @return The definition type, WAITUI_AST_DEFINITION_TYPE_UNDEFINED for
+ *         expressions
+ */
+extern waitui_ast_definition_type
+waitui_ast_binary_node_getDefinitionType(const waitui_ast_binary_node *node);
+
+/**
+ * @brief Get the expression type of the binary AST node.
+ * @param[in] node The node to get the type of
+ * @return The expression type, WAITUI_AST_EXPRESSION_TYPE_UNDEFINED for
+ *         definitions
+ */
+extern waitui_ast_expression_type
+waitui_ast_binary_node_getExpressionType(const waitui_ast_binary_node *node);
+
+/**
+ * @brief Get the value of the binary AST node.
+ * @param[in] node The node to get the value of
+ * @return The operator, the function visibility or the boolean literal value
+ */
+extern unsigned int
+waitui_ast_binary_node_getValue(const waitui_ast_binary_node *node);
+
+/**
+ * @brief Get the flags of the binary AST node.
+ * @param[in] node The node to get the flags of
+ * @return The WAITUI_AST_BINARY_FLAG_* flags of the node
+ */
+extern unsigned int
+waitui_ast_binary_node_getFlags(const waitui_ast_binary_node *node);
+
+/**
+ * @brief Get the node in the field of the binary AST node.
+ * @param[in] this The binary AST image of the node
+ * @param[in] node The node to get the field of
+ * @param[in] field The field holding a node
+ * @return On success a pointer to the node, else NULL
+ */
+extern const waitui_ast_binary_node *
+waitui_ast_binary_getNode(const waitui_ast_binary *this,
+                          const waitui_ast_binary_node *node,
+                          waitui_ast_field field);
+
+/**
+ * @brief Get the length of the list in the field of the binary AST node.
+ * @param[in] this The binary AST image of the node
+ * @param[in] node The node to get the field of
+ * @param[in] field The field holding a list
+ * @return The length of the list, 0 for no list
+ */
+extern unsigned long int
+waitui_ast_binary_getListLength(const waitui_ast_binary *this,
+                                const waitui_ast_binary_node *node,
+                                waitui_ast_field field);
+
+/**
+ * @brief Get a node of the list in the field of the binary AST node.
+ * @param[in] this The binary AST image of the node
+ * @param[in] node The node to get the field of
+ * @param[in] field The field holding a list
+ * @param[in] index The index of the node in the list
+ * @return On success a pointer to the node, else NULL
+ */
+extern const waitui_ast_binary_node *
+waitui_ast_binary_getListNode(const waitui_ast_binary *this,
+                              const waitui_ast_binary_node *node,
+                              waitui_ast_field field,
+                              unsigned long int index);
+
+/**
+ * @brief Get the symbol in the field of the binary AST node.
+ * @param[in] this The binary AST image of the node
+ * @param[in] node The node to get the field of
+ * @param[in] field The field holding a symbol
+ * @param[out] symbol The symbol to fill
+ * @retval 1 Ok
+ * @retval 0 The field holds no symbol
+ */
+extern int waitui_ast_binary_getSymbol(const waitui_ast_binary *this,
+                                       const waitui_ast_binary_node *node,
+                                       waitui_ast_field field,
+                                       waitui_ast_binary_symbol *symbol);
+
+/**
+ * @brief Get the string in the field of the binary AST node.
+ * @param[in] this The binary AST image of the node
+ * @param[in] node The node to get the field of
+ * @param[in] field The field holding a string
+ * @param[out] value The str to point to the string inside of the image
+ * @retval 1 Ok
+ * @retval 0 The field holds no string
+ */
+extern int waitui_ast_binary_getString(const waitui_ast_binary *this,
+                                       const waitui_ast_binary_node *node,
+                                       waitui_ast_field field,
+                                       str *value);
+
+/**
+ * @brief Create an AST out of the binary AST image.
+ * @param[in] this The binary AST image to create the AST from
+ * @return On success a pointer to waitui_ast, else NULL
+ * @note The AST copies everything it needs and does not depend on the image.
+ */
+extern waitui_ast *waitui_ast_binary_toAst(const waitui_ast_binary *this);
+
+#endif//WAITUI_AST_BINARY_H
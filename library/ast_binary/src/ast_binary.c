@@ -0,0 +1,1908 @@
+/**
+ * @file ast_binary.c
+ * @author rick
+ * @date 17.10.26
+ * @brief File for the binary AST implementation
+ */
+
+#include "waitui/ast_binary.h"
+
+#include <waitui/hashtable.h>
+#include <waitui/intern.h>
+#include <waitui/log.h>
+#include <waitui/vector.h>
+
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+// -----------------------------------------------------------------------------
+//  Local defines
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The magic bytes at the start of every binary AST image.
+ */
+#define WAITUI_AST_BINARY_MAGIC "WAST"
+
+/**
+ * @brief Value to detect images written with a different byte order.
+ */
+#define WAITUI_AST_BINARY_BYTE_ORDER 0x01020304u
+
+/**
+ * @brief The alignment of every record inside of the image.
+ */
+#define WAITUI_AST_BINARY_ALIGNMENT 4
+
+/**
+ * @brief The initial capacity of the buffer the image is written to.
+ */
+#define WAITUI_AST_BINARY_INITIAL_CAPACITY 4096
+
+/**
+ * @brief Write the value with the write function into the field of the node.
+ */
+#define AST_BINARY_WRITE_FIELD(writeFunction, node, field, value)              \
+    waitui_ast_binary_writer_setField(this, (node), (field),                   \
+                                      writeFunction(this, (value)))
+
+/**
+ * @brief Write the AST node into the field of the node.
+ */
+#define AST_BINARY_WRITE_NODE(node, field, value)                              \
+    AST_BINARY_WRITE_FIELD(waitui_ast_binary_writeNode, node, field,           \
+                           (waitui_ast_node *) (value))
+
+/**
+ * @brief Write the list of AST nodes into the field of the node.
+ */
+#define AST_BINARY_WRITE_LIST(node, field, value)                              \
+    AST_BINARY_WRITE_FIELD(waitui_ast_binary_writeList, node, field,           \
+                           (waitui_vector *) (value))
+
+/**
+ * @brief Write the symbol into the field of the node.
+ */
+#define AST_BINARY_WRITE_SYMBOL(node, field, value)                            \
+    AST_BINARY_WRITE_FIELD(waitui_ast_binary_writeSymbol, node, field,         \
+                           (value))
+
+/**
+ * @brief Write the string into the field of the node.
+ */
+#define AST_BINARY_WRITE_STRING(node, field, value)                            \
+    AST_BINARY_WRITE_FIELD(waitui_ast_binary_writeString, node, field,         \
+                           (value))
+
+/**
+ * @brief Write the node record of a definition of the current type.
+ */
+#define AST_BINARY_NEW_DEFINITION(value, flags, fieldCount)                    \
+    waitui_ast_binary_writer_newNode(this, WAITUI_AST_NODE_TYPE_DEFINITION,    \
+                                     type, (value), (flags), (fieldCount))
+
+/**
+ * @brief Write the node record of an expression of the current type.
+ */
+#define AST_BINARY_NEW_EXPRESSION(value, fieldCount)                           \
+    waitui_ast_binary_writer_newNode(this, WAITUI_AST_NODE_TYPE_EXPRESSION,    \
+                                     type, (value), 0, (fieldCount))
+
+/**
+ * @brief Create the AST node in the field of the node record.
+ */
+#define AST_BINARY_LOAD_NODE(field)                                            \
+    waitui_ast_binary_loadField(this, node, WAITUI_AST_FIELD_##field)
+
+/**
+ * @brief Create the list of AST nodes in the field of the node record.
+ */
+#define AST_BINARY_LOAD_LIST(field)                                            \
+    waitui_ast_binary_loadList(this, node, WAITUI_AST_FIELD_##field)
+
+/**
+ * @brief Create the symbol in the field of the node record.
+ */
+#define AST_BINARY_LOAD_SYMBOL(field)                                          \
+    waitui_ast_binary_loadSymbol(this, node, WAITUI_AST_FIELD_##field)
+
+/**
+ * @brief Create the string in the field of the node record.
+ */
+#define AST_BINARY_LOAD_STRING(field)                                          \
+    waitui_ast_binary_loadString(this, node, WAITUI_AST_FIELD_##field)
+
+
+// -----------------------------------------------------------------------------
+//  Local types
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Struct representing the header of a binary AST image.
+ */
+typedef struct waitui_ast_binary_header {
+    char magic[4];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t size;
+    uint32_t program;
+    uint32_t nodeCount;
+    uint32_t references;
+    uint32_t referenceCount;
+    uint32_t symbols;
+    uint32_t symbolCount;
+    uint32_t strings;
+    uint32_t stringCount;
+} waitui_ast_binary_header;
+
+/**
+ * @brief Struct representing a node record inside of a binary AST image.
+ * @note The subType is the definition or the expression type of the node.
+ */
+struct waitui_ast_binary_node {
+    uint8_t nodeType;
+    uint8_t subType;
+    uint8_t value;
+    uint8_t flags;
+    uint32_t fieldCount;
+    uint32_t fields[];
+};
+
+/**
+ * @brief Struct representing a list record inside of a binary AST image.
+ */
+typedef struct waitui_ast_binary_list {
+    uint32_t length;
+    uint32_t nodes[];
+} waitui_ast_binary_list;
+
+/**
+ * @brief Struct representing an entry of the reference table.
+ * @note The symbol is the index of the entry in the symbol table.
+ */
+typedef struct waitui_ast_binary_reference_entry {
+    uint32_t symbol;
+    uint32_t line;
+    uint32_t column;
+} waitui_ast_binary_reference_entry;
+
+/**
+ * @brief Struct representing an entry of the symbol table.
+ * @note The identifier is the index of the entry in the string table.
+ */
+typedef struct waitui_ast_binary_symbol_entry {
+    uint32_t identifier;
+    uint32_t type;
+} waitui_ast_binary_symbol_entry;
+
+/**
+ * @brief Struct representing an entry of the string table.
+ * @note The bytes of the string are followed by a NUL byte in the image.
+ */
+typedef struct waitui_ast_binary_string_entry {
+    uint32_t offset;
+    uint32_t length;
+} waitui_ast_binary_string_entry;
+
+/**
+ * @brief Type representing a string stored by the writer.
+ */
+typedef struct waitui_ast_binary_string {
+    str value;
+    uint32_t index;
+} waitui_ast_binary_string;
+
+static void waitui_ast_binary_string_destroy(waitui_ast_binary_string **this);
+
+CREATE_HASHTABLE_TYPE_CUSTOM(INTERFACE, waitui_ast_binary_string,
+                             waitui_ast_binary_string,
+                             waitui_ast_binary_string_destroy)
+
+/**
+ * @brief Type representing a symbol stored by the writer.
+ */
+typedef struct waitui_ast_binary_table_symbol {
+    waitui_ast_binary_symbol_entry entry;
+    uint32_t index;
+} waitui_ast_binary_table_symbol;
+
+static void
+waitui_ast_binary_table_symbol_destroy(waitui_ast_binary_table_symbol **this);
+
+CREATE_HASHTABLE_TYPE_CUSTOM(INTERFACE, waitui_ast_binary_table_symbol,
+                             waitui_ast_binary_table_symbol,
+                             waitui_ast_binary_table_symbol_destroy)
+
+/**
+ * @brief Type for writing a binary AST image.
+ * @note Records are only addressed by offsets while writing, as the buffer
+ *       moves whenever it grows. After a failure every further write is
+ *       skipped and the failure is reported at the end.
+ */
+typedef struct waitui_ast_binary_writer {
+    unsigned char *data;
+    size_t length;
+    size_t capacity;
+    waitui_ast_binary_reference_entry *references;
+    uint32_t referenceCount;
+    uint32_t referenceCapacity;
+    waitui_ast_binary_table_symbol_hashtable *symbolTable;
+    waitui_ast_binary_table_symbol **symbols;
+    uint32_t symbolCount;
+    uint32_t symbolCapacity;
+    waitui_ast_binary_string_hashtable *stringTable;
+    waitui_ast_binary_string **strings;
+    uint32_t stringCount;
+    uint32_t stringCapacity;
+    uint32_t nodeCount;
+    bool failed;
+} waitui_ast_binary_writer;
+
+/**
+ * @brief Struct representing a binary AST image.
+ */
+struct waitui_ast_binary {
+    const unsigned char *data;
+    size_t size;
+    const waitui_ast_binary_header *header;
+    bool mapped;
+};
+
+/**
+ * @brief Type for creating an AST out of a binary AST image.
+ */
+typedef struct waitui_ast_binary_loader {
+    const waitui_ast_binary *binary;
+    waitui_arena *arena;
+    waitui_intern *intern;
+    unsigned long int nodeCount;
+    bool failed;
+} waitui_ast_binary_loader;
+
+
+// -----------------------------------------------------------------------------
+//  Local functions
+// -----------------------------------------------------------------------------
+
+CREATE_HASHTABLE_TYPE_CUSTOM(IMPLEMENTATION, waitui_ast_binary_string,
+                             waitui_ast_binary_string,
+                             waitui_ast_binary_string_destroy)
+
+/**
+ * @brief Destroy a string stored by the writer.
+ * @param[in,out] this The string to destroy
+ */
+static void waitui_ast_binary_string_destroy(waitui_ast_binary_string **this) {
+    if (!this || !(*this)) { return; }
+
+    free(*this);
+    *this = NULL;
+}
+
+CREATE_HASHTABLE_TYPE_CUSTOM(IMPLEMENTATION, waitui_ast_binary_table_symbol,
+                             waitui_ast_binary_table_symbol,
+                             waitui_ast_binary_table_symbol_destroy)
+
+/**
+ * @brief Destroy a symbol stored by the writer.
+ * @param[in,out] this The symbol to destroy
+ */
+static void
+waitui_ast_binary_table_symbol_destroy(waitui_ast_binary_table_symbol **this) {
+    if (!this || !(*this)) { return; }
+
+    free(*this);
+    *this = NULL;
+}
+
+/**
+ * @brief Make room for one more element in a table of the writer.
+ * @param[in,out] this The writer of the table
+ * @param[in,out] table The elements of the table
+ * @param[in] count The number of elements in the table
+ * @param[in,out] capacity The number of elements the table has room for
+ * @param[in] size The size of an element
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed, the writer failed
+ */
+static int waitui_ast_binary_writer_grow(waitui_ast_binary_writer *this,
+                                         void **table, uint32_t count,
+                                         uint32_t *capacity, size_t size) {
+    uint32_t newCapacity = *capacity ? *capacity * 2 : 64;
+    void *newTable       = NULL;
+
+    if (count < *capacity) { return 1; }
+
+    newTable = realloc(*table, newCapacity * size);
+    if (!newTable) {
+        this->failed = true;
+        return 0;
+    }
+    *table    = newTable;
+    *capacity = newCapacity;
+
+    return 1;
+}
+
+/**
+ * @brief Reserve zeroed space for a record at the end of the image.
+ * @param[in,out] this The writer to reserve the space in
+ * @param[in] size The size of the record
+ * @return The offset of the record or 0 if the writer failed
+ */
+static uint32_t waitui_ast_binary_writer_reserve(waitui_ast_binary_writer *this,
+                                                 size_t size) {
+    size_t offset = this->length;
+
+    if (this->failed) { return 0; }
+
+    size = (size + WAITUI_AST_BINARY_ALIGNMENT - 1) &
+           ~((size_t) WAITUI_AST_BINARY_ALIGNMENT - 1);
+    if (size > UINT32_MAX - offset) {
+        this->failed = true;
+        return 0;
+    }
+
+    if (offset + size > this->capacity) {
+        size_t capacity     = WAITUI_AST_BINARY_INITIAL_CAPACITY;
+        unsigned char *data = NULL;
+
+        if (this->capacity) { capacity = this->capacity; }
+
+        while (capacity < offset + size) { capacity *= 2; }
+
+        data = realloc(this->data, capacity);
+        if (!data) {
+            this->failed = true;
+            return 0;
+        }
+        memset(data + this->capacity, 0, capacity - this->capacity);
+
+        this->data     = data;
+        this->capacity = capacity;
+    }
+    this->length += size;
+
+    return (uint32_t) offset;
+}
+
+/**
+ * @brief Set the field of the node record written before.
+ * @param[in,out] this The writer of the node record
+ * @param[in] node The offset of the node record
+ * @param[in] field The field to set
+ * @param[in] value The value for the field
+ */
+static void waitui_ast_binary_writer_setField(waitui_ast_binary_writer *this,
+                                              uint32_t node,
+                                              waitui_ast_field field,
+                                              uint32_t value) {
+    if (this->failed || !node) { return; }
+
+    ((waitui_ast_binary_node *) (this->data + node))->fields[field] = value;
+}
+
+/**
+ * @brief Write the node record without its fields.
+ * @param[in,out] this The writer to write the node record with
+ * @param[in] nodeType The node type of the node
+ * @param[in] subType The definition or expression type of the node
+ * @param[in] value The value of the node
+ * @param[in] flags The flags of the node
+ * @param[in] fieldCount The number of fields of the node
+ * @return The offset of the node record or 0 if the writer failed
+ */
+static uint32_t waitui_ast_binary_writer_newNode(waitui_ast_binary_writer *this,
+                                                 waitui_ast_node_type nodeType,
+                                                 unsigned int subType,
+                                                 unsigned int value,
+                                                 unsigned int flags,
+                                                 uint32_t fieldCount) {
+    waitui_ast_binary_node *node = NULL;
+    uint32_t offset              = 0;
+
+    offset = waitui_ast_binary_writer_reserve(
+            this, sizeof(*node) + fieldCount * sizeof(*node->fields));
+    if (!offset) { return 0; }
+
+    node             = (waitui_ast_binary_node *) (this->data + offset);
+    node->nodeType   = (uint8_t) nodeType;
+    node->subType    = (uint8_t) subType;
+    node->value      = (uint8_t) value;
+    node->flags      = (uint8_t) flags;
+    node->fieldCount = fieldCount;
+
+    this->nodeCount++;
+
+    return offset;
+}
+
+/**
+ * @brief Add the string to the string table of the image.
+ * @param[in,out] this The writer to add the string to
+ * @param[in] value The string to add
+ * @return The index of the string in the string table
+ */
+static uint32_t waitui_ast_binary_writeString(waitui_ast_binary_writer *this,
+                                              str value) {
+    waitui_ast_binary_string *string = NULL;
+
+    if (this->failed) { return 0; }
+
+    string = waitui_ast_binary_string_hashtable_lookup(this->stringTable,
+                                                        value);
+    if (string) { return string->index; }
+
+    if (!waitui_ast_binary_writer_grow(this, (void **) &this->strings,
+                                       this->stringCount, &this->stringCapacity,
+                                       sizeof(*this->strings))) {
+        return 0;
+    }
+
+    string = calloc(1, sizeof(*string));
+    if (!string) {
+        this->failed = true;
+        return 0;
+    }
+    string->value = value;
+    string->index = this->stringCount;
+
+    if (!waitui_ast_binary_string_hashtable_insert(this->stringTable, value,
+                                                   string)) {
+        waitui_ast_binary_string_destroy(&string);
+        this->failed = true;
+        return 0;
+    }
+    this->strings[this->stringCount++] = string;
+
+    return string->index;
+}
+
+/**
+ * @brief Add the identifier and the type of the symbol to the symbol table.
+ * @param[in,out] this The writer to add the symbol to
+ * @param[in] value The symbol to add
+ * @return The index of the symbol in the symbol table
+ */
+static uint32_t
+waitui_ast_binary_writer_addSymbol(waitui_ast_binary_writer *this,
+                                   symbol *value) {
+    waitui_ast_binary_table_symbol *tableSymbol = NULL;
+    waitui_ast_binary_symbol_entry entry        = {0};
+    str key = {.s = (char *) &entry, .len = sizeof(entry)};
+
+    entry.identifier = waitui_ast_binary_writeString(this, value->identifier);
+    entry.type       = (uint32_t) value->type;
+    if (this->failed) { return 0; }
+
+    tableSymbol = waitui_ast_binary_table_symbol_hashtable_lookup(
+            this->symbolTable, key);
+    if (tableSymbol) { return tableSymbol->index; }
+
+    if (!waitui_ast_binary_writer_grow(this, (void **) &this->symbols,
+                                       this->symbolCount, &this->symbolCapacity,
+                                       sizeof(*this->symbols))) {
+        return 0;
+    }
+
+    tableSymbol = calloc(1, sizeof(*tableSymbol));
+    if (!tableSymbol) {
+        this->failed = true;
+        return 0;
+    }
+    tableSymbol->entry = entry;
+    tableSymbol->index = this->symbolCount;
+
+    if (!waitui_ast_binary_table_symbol_hashtable_insert(this->symbolTable, key,
+                                                         tableSymbol)) {
+        waitui_ast_binary_table_symbol_destroy(&tableSymbol);
+        this->failed = true;
+        return 0;
+    }
+    this->symbols[this->symbolCount++] = tableSymbol;
+
+    return tableSymbol->index;
+}
+
+/**
+ * @brief Add the reference of the symbol to the reference table.
+ * @param[in,out] this The writer to add the reference to
+ * @param[in] value The symbol to add the reference of
+ * @return The index of the reference plus one or 0 for no symbol
+ * @note A symbol of the lexer has exactly one reference, only the first one
+ *       is kept.
+ */
+static uint32_t waitui_ast_binary_writeSymbol(waitui_ast_binary_writer *this,
+                                              symbol *value) {
+    waitui_ast_binary_reference_entry *entry = NULL;
+    symbol_reference *reference              = NULL;
+    uint32_t index                           = 0;
+
+    if (!value || this->failed) { return 0; }
+
+    index = waitui_ast_binary_writer_addSymbol(this, value);
+    if (this->failed ||
+        !waitui_ast_binary_writer_grow(
+                this, (void **) &this->references, this->referenceCount,
+                &this->referenceCapacity, sizeof(*this->references))) {
+        return 0;
+    }
+
+    entry     = &this->references[this->referenceCount++];
+    reference = symbol_get_reference_head(value);
+    *entry    = (waitui_ast_binary_reference_entry){.symbol = index};
+    if (reference) {
+        entry->line =
+                reference->line > UINT32_MAX ? UINT32_MAX : reference->line;
+        entry->column =
+                reference->column > UINT32_MAX ? UINT32_MAX : reference->column;
+    }
+
+    return this->referenceCount;
+}
+
+static uint32_t waitui_ast_binary_writeNode(waitui_ast_binary_writer *this,
+                                            waitui_ast_node *node);
+
+/**
+ * @brief Write the list record and the nodes of the list.
+ * @param[in,out] this The writer to write the list record with
+ * @param[in] list The list of AST nodes to write
+ * @return The offset of the list record or 0 for no list
+ */
+static uint32_t waitui_ast_binary_writeList(waitui_ast_binary_writer *this,
+                                            waitui_vector *list) {
+    uint32_t length = (uint32_t) waitui_vector_getLength(list);
+    uint32_t offset = 0;
+
+    if (!list || this->failed) { return 0; }
+
+    offset = waitui_ast_binary_writer_reserve(
+            this, sizeof(waitui_ast_binary_list) + length * sizeof(uint32_t));
+    if (!offset) { return 0; }
+    ((waitui_ast_binary_list *) (this->data + offset))->length = length;
+
+    for (uint32_t i = 0; i < length; ++i) {
+        uint32_t node =
+                waitui_ast_binary_writeNode(this, waitui_vector_get(list, i));
+        if (this->failed) { break; }
+        ((waitui_ast_binary_list *) (this->data + offset))->nodes[i] = node;
+    }
+
+    return offset;
+}
+
+/**
+ * @brief Write the node record of the definition and its fields.
+ * @param[in,out] this The writer to write the node record with
+ * @param[in] definition The definition to write
+ * @return The offset of the node record
+ */
+static uint32_t
+waitui_ast_binary_writeDefinition(waitui_ast_binary_writer *this,
+                                  waitui_ast_definition *definition) {
+    waitui_ast_definition_type type =
+            waitui_ast_definition_getDefinitionType(definition);
+    uint32_t node = 0;
+
+    switch (type) {
+        case WAITUI_AST_DEFINITION_TYPE_PROGRAM: {
+            waitui_ast_program *program = (waitui_ast_program *) definition;
+
+            node = AST_BINARY_NEW_DEFINITION(0, 0, 1);
+            AST_BINARY_WRITE_LIST(node, WAITUI_AST_FIELD_PROGRAM_NAMESPACES,
+                                  waitui_ast_program_getNamespaces(program));
+            break;
+        }
+        case WAITUI_AST_DEFINITION_TYPE_NAMESPACE: {
+            waitui_ast_namespace *namespace =
+                    (waitui_ast_namespace *) definition;
+
+            node = AST_BINARY_NEW_DEFINITION(0, 0, 3);
+            AST_BINARY_WRITE_SYMBOL(node, WAITUI_AST_FIELD_NAMESPACE_NAME,
+                                    waitui_ast_namespace_getName(namespace));
+            AST_BINARY_WRITE_LIST(node, WAITUI_AST_FIELD_NAMESPACE_IMPORTS,
+                                  waitui_ast_namespace_getImports(namespace));
+            AST_BINARY_WRITE_LIST(node, WAITUI_AST_FIELD_NAMESPACE_CLASSES,
+                                  waitui_ast_namespace_getClasses(namespace));
+            break;
+        }
+        case WAITUI_AST_DEFINITION_TYPE_IMPORT: {
+            waitui_ast_import *import = (waitui_ast_import *) definition;
+
+            node = AST_BINARY_NEW_DEFINITION(0, 0, 2);
+            AST_BINARY_WRITE_SYMBOL(node, WAITUI_AST_FIELD_IMPORT_NAME,
+                                    waitui_ast_import_getName(import));
+            AST_BINARY_WRITE_SYMBOL(node, WAITUI_AST_FIELD_IMPORT_ALIAS,
+                                    waitui_ast_import_getAlias(import));
+            break;
+        }
+        case WAITUI_AST_DEFINITION_TYPE_CLASS: {
+            waitui_ast_class *class = (waitui_ast_class *) definition;
+
+            node = AST_BINARY_NEW_DEFINITION(0, 0, 6);
+            AST_BINARY_WRITE_SYMBOL(node, WAITUI_AST_FIELD_CLASS_NAME,
+                                    waitui_ast_class_getName(class));
+            AST_BINARY_WRITE_LIST(node, WAITUI_AST_FIELD_CLASS_PARAMETERS,
+                                  waitui_ast_class_getParameters(class));
+            AST_BINARY_WRITE_SYMBOL(node, WAITUI_AST_FIELD_CLASS_SUPER_CLASS,
+                                    waitui_ast_class_getSuperClass(class));
+            AST_BINARY_WRITE_LIST(node, WAITUI_AST_FIELD_CLASS_SUPER_CLASS_ARGS,
+                                  waitui_ast_class_getSuperClassArgs(class));
+            AST_BINARY_WRITE_LIST(node, WAITUI_AST_FIELD_CLASS_PROPERTIES,
+                                  waitui_ast_class_getProperties(class));
+            AST_BINARY_WRITE_LIST(node, WAITUI_AST_FIELD_CLASS_FUNCTIONS,
+                                  waitui_ast_class_getFunctions(class));
+            break;
+        }
+        case WAITUI_AST_DEFINITION_TYPE_FORMAL: {
+            waitui_ast_formal *formal = (waitui_ast_formal *) definition;
+
+            node = AST_BINARY_NEW_DEFINITION(
+                    0,
+                    waitui_ast_formal_isLazy(formal)
+                            ? WAITUI_AST_BINARY_FLAG_LAZY
+                            : 0,
+                    2);
+            AST_BINARY_WRITE_SYMBOL(node, WAITUI_AST_FIELD_FORMAL_IDENTIFIER,
+                                    waitui_ast_formal_getIdentifier(formal));
+            AST_BINARY_WRITE_SYMBOL(node, WAITUI_AST_FIELD_FORMAL_TYPE,
+                                    waitui_ast_formal_getType(formal));
+            break;
+        }
+        case WAITUI_AST_DEFINITION_TYPE_PROPERTY: {
+            waitui_ast_property *property = (waitui_ast_property *) definition;
+
+            node = AST_BINARY_NEW_DEFINITION(0, 0, 3);
+            AST_BINARY_WRITE_SYMBOL(node, WAITUI_AST_FIELD_PROPERTY_NAME,
+                                    waitui_ast_property_getName(property));
+            AST_BINARY_WRITE_SYMBOL(node, WAITUI_AST_FIELD_PROPERTY_TYPE,
+                                    waitui_ast_property_getType(property));
+            AST_BINARY_WRITE_NODE(node, WAITUI_AST_FIELD_PROPERTY_VALUE,
+                                  waitui_ast_property_getValue(property));
+            break;
+        }
+        case WAITUI_AST_DEFINITION_TYPE_FUNCTION: {
+            waitui_ast_function *function = (waitui_ast_function *) definition;
+            unsigned int flags            = 0;
+
+            if (waitui_ast_function_isAbstract(function)) {
+                flags |= WAITUI_AST_BINARY_FLAG_ABSTRACT;
+            }
+            if (waitui_ast_function_isFinal(function)) {
+                flags |= WAITUI_AST_BINARY_FLAG_FINAL;
+            }
+            if (waitui_ast_function_isOverwrite(function)) {
+                flags |= WAITUI_AST_BINARY_FLAG_OVERWRITE;
+            }
+
+            node = AST_BINARY_NEW_DEFINITION(
+                    waitui_ast_function_getVisibility(function), flags, 4);
+            AST_BINARY_WRITE_SYMBOL(
+                    node, WAITUI_AST_FIELD_FUNCTION_NAME,
+                    waitui_ast_function_getFunctionName(function));
+            AST_BINARY_WRITE_LIST(node, WAITUI_AST_FIELD_FUNCTION_PARAMETERS,
+                                  waitui_ast_function_getParameters(function));
+            AST_BINARY_WRITE_SYMBOL(
+                    node, WAITUI_AST_FIELD_FUNCTION_RETURN_TYPE,
+                    waitui_ast_function_getReturnType(function));
+            AST_BINARY_WRITE_NODE(node, WAITUI_AST_FIELD_FUNCTION_BODY,
+                                  waitui_ast_function_getBody(function));
+            break;
+        }
+        default:
+            waitui_log_trace("trying to write a definition with an undefined "
+                             "definition type");
+            this->failed = true;
+            break;
+    }
+
+    return node;
+}
+
+/**
+ * @brief Write the node record of the expression and its fields.
+ * @param[in,out] this The writer to write the node record with
+ * @param[in] expression The expression to write
+ * @return The offset of the node record
+ */
+static uint32_t
+waitui_ast_binary_writeExpression(waitui_ast_binary_writer *this,
+                                  waitui_ast_expression *expression) {
+    waitui_ast_expression_type type =
+            waitui_ast_expression_getExpressionType(expression);
+    uint32_t node = 0;
+
+    switch (type) {
+        case WAITUI_AST_EXPRESSION_TYPE_INTEGER_LITERAL:
+            node = AST_BINARY_NEW_EXPRESSION(0, 1);
+            AST_BINARY_WRITE_STRING(
+                    node, WAITUI_AST_FIELD_LITERAL_VALUE,
+                    *waitui_ast_integer_literal_getValue(
+                            (waitui_ast_integer_literal *) expression));
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_DECIMAL_LITERAL:
+            node = AST_BINARY_NEW_EXPRESSION(0, 1);
+            AST_BINARY_WRITE_STRING(
+                    node, WAITUI_AST_FIELD_LITERAL_VALUE,
+                    *waitui_ast_decimal_literal_getValue(
+                            (waitui_ast_decimal_literal *) expression));
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_STRING_LITERAL:
+            node = AST_BINARY_NEW_EXPRESSION(0, 1);
+            AST_BINARY_WRITE_STRING(
+                    node, WAITUI_AST_FIELD_LITERAL_VALUE,
+                    *waitui_ast_string_literal_getValue(
+                            (waitui_ast_string_literal *) expression));
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_BOOLEAN_LITERAL:
+            node = AST_BINARY_NEW_EXPRESSION(
+                    waitui_ast_boolean_literal_getValue(
+                            (waitui_ast_boolean_literal *) expression),
+                    0);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_NULL_LITERAL:
+        case WAITUI_AST_EXPRESSION_TYPE_THIS_LITERAL:
+        case WAITUI_AST_EXPRESSION_TYPE_NATIVE_EXPRESSION:
+            node = AST_BINARY_NEW_EXPRESSION(0, 0);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_ASSIGNMENT: {
+            waitui_ast_assignment *assignment =
+                    (waitui_ast_assignment *) expression;
+
+            node = AST_BINARY_NEW_EXPRESSION(
+                    waitui_ast_assignment_getOperator(assignment), 2);
+            AST_BINARY_WRITE_SYMBOL(
+                    node, WAITUI_AST_FIELD_ASSIGNMENT_IDENTIFIER,
+                    waitui_ast_assignment_getIdentifier(assignment));
+            AST_BINARY_WRITE_NODE(node, WAITUI_AST_FIELD_ASSIGNMENT_VALUE,
+                                  waitui_ast_assignment_getValue(assignment));
+            break;
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_REFERENCE:
+            node = AST_BINARY_NEW_EXPRESSION(0, 1);
+            AST_BINARY_WRITE_SYMBOL(
+                    node, WAITUI_AST_FIELD_REFERENCE_VALUE,
+                    waitui_ast_reference_getValue(
+                            (waitui_ast_reference *) expression));
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_CAST: {
+            waitui_ast_cast *cast = (waitui_ast_cast *) expression;
+
+            node = AST_BINARY_NEW_EXPRESSION(0, 2);
+            AST_BINARY_WRITE_SYMBOL(node, WAITUI_AST_FIELD_CAST_TYPE,
+                                    waitui_ast_cast_getType(cast));
+            AST_BINARY_WRITE_NODE(node, WAITUI_AST_FIELD_CAST_OBJECT,
+                                  waitui_ast_cast_getObject(cast));
+            break;
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_INITIALIZATION: {
+            waitui_ast_initialization *initialization =
+                    (waitui_ast_initialization *) expression;
+
+            node = AST_BINARY_NEW_EXPRESSION(0, 3);
+            AST_BINARY_WRITE_SYMBOL(
+                    node, WAITUI_AST_FIELD_INITIALIZATION_IDENTIFIER,
+                    waitui_ast_initialization_getIdentifier(initialization));
+            AST_BINARY_WRITE_SYMBOL(
+                    node, WAITUI_AST_FIELD_INITIALIZATION_TYPE,
+                    waitui_ast_initialization_getType(initialization));
+            AST_BINARY_WRITE_NODE(
+                    node, WAITUI_AST_FIELD_INITIALIZATION_VALUE,
+                    waitui_ast_initialization_getValue(initialization));
+            break;
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_LET: {
+            waitui_ast_let *let = (waitui_ast_let *) expression;
+
+            node = AST_BINARY_NEW_EXPRESSION(0, 2);
+            AST_BINARY_WRITE_LIST(node, WAITUI_AST_FIELD_LET_INITIALIZATIONS,
+                                  waitui_ast_let_getInitializations(let));
+            AST_BINARY_WRITE_NODE(node, WAITUI_AST_FIELD_LET_BODY,
+                                  waitui_ast_let_getBody(let));
+            break;
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_BLOCK:
+            node = AST_BINARY_NEW_EXPRESSION(0, 1);
+            AST_BINARY_WRITE_LIST(
+                    node, WAITUI_AST_FIELD_BLOCK_EXPRESSIONS,
+                    waitui_ast_block_getExpressions(
+                            (waitui_ast_block *) expression));
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_CONSTRUCTOR_CALL: {
+            waitui_ast_constructor_call *constructorCall =
+                    (waitui_ast_constructor_call *) expression;
+
+            node = AST_BINARY_NEW_EXPRESSION(0, 2);
+            AST_BINARY_WRITE_SYMBOL(
+                    node, WAITUI_AST_FIELD_CONSTRUCTOR_CALL_NAME,
+                    waitui_ast_constructor_call_getName(constructorCall));
+            AST_BINARY_WRITE_LIST(
+                    node, WAITUI_AST_FIELD_CONSTRUCTOR_CALL_ARGS,
+                    waitui_ast_constructor_call_getArgs(constructorCall));
+            break;
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_FUNCTION_CALL: {
+            waitui_ast_function_call *functionCall =
+                    (waitui_ast_function_call *) expression;
+
+            node = AST_BINARY_NEW_EXPRESSION(0, 3);
+            AST_BINARY_WRITE_NODE(
+                    node, WAITUI_AST_FIELD_FUNCTION_CALL_OBJECT,
+                    waitui_ast_function_call_getObject(functionCall));
+            AST_BINARY_WRITE_SYMBOL(
+                    node, WAITUI_AST_FIELD_FUNCTION_CALL_FUNCTION_NAME,
+                    waitui_ast_function_call_getFunctionName(functionCall));
+            AST_BINARY_WRITE_LIST(
+                    node, WAITUI_AST_FIELD_FUNCTION_CALL_ARGS,
+                    waitui_ast_function_call_getArgs(functionCall));
+            break;
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_SUPER_FUNCTION_CALL: {
+            waitui_ast_super_function_call *superFunctionCall =
+                    (waitui_ast_super_function_call *) expression;
+
+            node = AST_BINARY_NEW_EXPRESSION(0, 2);
+            AST_BINARY_WRITE_SYMBOL(
+                    node, WAITUI_AST_FIELD_SUPER_FUNCTION_CALL_FUNCTION_NAME,
+                    waitui_ast_super_function_call_getFunctionName(
+                            superFunctionCall));
+            AST_BINARY_WRITE_LIST(
+                    node, WAITUI_AST_FIELD_SUPER_FUNCTION_CALL_ARGS,
+                    waitui_ast_super_function_call_getArgs(superFunctionCall));
+            break;
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_BINARY_EXPRESSION: {
+            waitui_ast_binary_expression *binaryExpression =
+                    (waitui_ast_binary_expression *) expression;
+
+            node = AST_BINARY_NEW_EXPRESSION(
+                    waitui_ast_binary_expression_getOperator(binaryExpression),
+                    2);
+            AST_BINARY_WRITE_NODE(
+                    node, WAITUI_AST_FIELD_BINARY_EXPRESSION_LEFT,
+                    waitui_ast_binary_expression_getLeft(binaryExpression));
+            AST_BINARY_WRITE_NODE(
+                    node, WAITUI_AST_FIELD_BINARY_EXPRESSION_RIGHT,
+                    waitui_ast_binary_expression_getRight(binaryExpression));
+            break;
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_UNARY_EXPRESSION: {
+            waitui_ast_unary_expression *unaryExpression =
+                    (waitui_ast_unary_expression *) expression;
+
+            node = AST_BINARY_NEW_EXPRESSION(
+                    waitui_ast_unary_expression_getOperator(unaryExpression),
+                    1);
+            AST_BINARY_WRITE_NODE(
+                    node, WAITUI_AST_FIELD_UNARY_EXPRESSION_EXPRESSION,
+                    waitui_ast_unary_expression_getExpression(unaryExpression));
+            break;
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_IF_ELSE: {
+            waitui_ast_if_else *ifElse = (waitui_ast_if_else *) expression;
+
+            node = AST_BINARY_NEW_EXPRESSION(0, 3);
+            AST_BINARY_WRITE_NODE(node, WAITUI_AST_FIELD_IF_ELSE_CONDITION,
+                                  waitui_ast_if_else_getCondition(ifElse));
+            AST_BINARY_WRITE_NODE(node, WAITUI_AST_FIELD_IF_ELSE_THEN_BRANCH,
+                                  waitui_ast_if_else_getThenBranch(ifElse));
+            AST_BINARY_WRITE_NODE(node, WAITUI_AST_FIELD_IF_ELSE_ELSE_BRANCH,
+                                  waitui_ast_if_else_getElseBranch(ifElse));
+            break;
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_WHILE: {
+            waitui_ast_while *whileNode = (waitui_ast_while *) expression;
+
+            node = AST_BINARY_NEW_EXPRESSION(0, 2);
+            AST_BINARY_WRITE_NODE(node, WAITUI_AST_FIELD_WHILE_CONDITION,
+                                  waitui_ast_while_getCondition(whileNode));
+            AST_BINARY_WRITE_NODE(node, WAITUI_AST_FIELD_WHILE_BODY,
+                                  waitui_ast_while_getBody(whileNode));
+            break;
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_LAZY_EXPRESSION:
+            node = AST_BINARY_NEW_EXPRESSION(0, 1);
+            AST_BINARY_WRITE_NODE(
+                    node, WAITUI_AST_FIELD_LAZY_EXPRESSION_EXPRESSION,
+                    waitui_ast_lazy_expression_getExpression(
+                            (waitui_ast_lazy_expression *) expression));
+            break;
+        default:
+            waitui_log_trace("trying to write a expression with an undefined "
+                             "expression type");
+            this->failed = true;
+            break;
+    }
+
+    return node;
+}
+
+/**
+ * @brief Write the node record of the AST node and its fields.
+ * @param[in,out] this The writer to write the node record with
+ * @param[in] node The AST node to write
+ * @return The offset of the node record or 0 for no node
+ */
+static uint32_t waitui_ast_binary_writeNode(waitui_ast_binary_writer *this,
+                                            waitui_ast_node *node) {
+    if (!node || this->failed) { return 0; }
+
+    switch (waitui_ast_node_getNodeType(node)) {
+        case WAITUI_AST_NODE_TYPE_EXPRESSION:
+            return waitui_ast_binary_writeExpression(
+                    this, (waitui_ast_expression *) node);
+        case WAITUI_AST_NODE_TYPE_DEFINITION:
+            return waitui_ast_binary_writeDefinition(
+                    this, (waitui_ast_definition *) node);
+        default:
+            waitui_log_trace(
+                    "trying to write a node with an undefined node type");
+            this->failed = true;
+            return 0;
+    }
+}
+
+/**
+ * @brief Write the reference and the symbol table behind the nodes.
+ * @param[in,out] this The writer to write the tables with
+ * @param[out] symbols The offset of the symbol table
+ * @return The offset of the reference table
+ */
+static uint32_t
+waitui_ast_binary_writeSymbolTables(waitui_ast_binary_writer *this,
+                                    uint32_t *symbols) {
+    uint32_t references = waitui_ast_binary_writer_reserve(
+            this,
+            this->referenceCount * sizeof(waitui_ast_binary_reference_entry));
+
+    *symbols = waitui_ast_binary_writer_reserve(
+            this, this->symbolCount * sizeof(waitui_ast_binary_symbol_entry));
+    if (this->failed) { return 0; }
+
+    if (this->referenceCount) {
+        memcpy(this->data + references, this->references,
+               this->referenceCount * sizeof(*this->references));
+    }
+    for (uint32_t i = 0; i < this->symbolCount; ++i) {
+        ((waitui_ast_binary_symbol_entry *) (this->data + *symbols))[i] =
+                this->symbols[i]->entry;
+    }
+
+    return references;
+}
+
+/**
+ * @brief Write the string table at the end of the image.
+ * @param[in,out] this The writer to write the string table with
+ * @return The offset of the string table
+ */
+static uint32_t
+waitui_ast_binary_writeStringTable(waitui_ast_binary_writer *this) {
+    uint32_t offset = waitui_ast_binary_writer_reserve(
+            this, this->stringCount * sizeof(waitui_ast_binary_string_entry));
+
+    for (uint32_t i = 0; i < this->stringCount && !this->failed; ++i) {
+        str value      = this->strings[i]->value;
+        uint32_t bytes = waitui_ast_binary_writer_reserve(this, value.len + 1);
+        waitui_ast_binary_string_entry *entry = NULL;
+
+        if (!bytes) { break; }
+
+        memcpy(this->data + bytes, value.s, value.len);
+
+        entry = (waitui_ast_binary_string_entry *) (this->data + offset) + i;
+        entry->offset = bytes;
+        entry->length = (uint32_t) value.len;
+    }
+
+    return offset;
+}
+
+/**
+ * @brief Get the record at the offset if the image is large enough for it.
+ * @param[in] this The binary AST image to get the record from
+ * @param[in] offset The offset of the record
+ * @param[in] size The minimal size of the record
+ * @return On success a pointer to the record, else NULL
+ */
+static const void *waitui_ast_binary_getRecord(const waitui_ast_binary *this,
+                                               uint32_t offset, size_t size) {
+    if (!offset || offset % WAITUI_AST_BINARY_ALIGNMENT != 0 ||
+        offset > this->size || this->size - offset < size) {
+        return NULL;
+    }
+    return this->data + offset;
+}
+
+/**
+ * @brief Get the node record at the offset.
+ * @param[in] this The binary AST image to get the node record from
+ * @param[in] offset The offset of the node record
+ * @return On success a pointer to the node record, else NULL
+ */
+static const waitui_ast_binary_node *
+waitui_ast_binary_getNodeRecord(const waitui_ast_binary *this,
+                                uint32_t offset) {
+    const waitui_ast_binary_node *node =
+            waitui_ast_binary_getRecord(this, offset, sizeof(*node));
+
+    if (!node || (this->size - offset - sizeof(*node)) / sizeof(uint32_t) <
+                         node->fieldCount) {
+        return NULL;
+    }
+    return node;
+}
+
+/**
+ * @brief Get the list record at the offset.
+ * @param[in] this The binary AST image to get the list record from
+ * @param[in] offset The offset of the list record
+ * @return On success a pointer to the list record, else NULL
+ */
+static const waitui_ast_binary_list *
+waitui_ast_binary_getListRecord(const waitui_ast_binary *this,
+                                uint32_t offset) {
+    const waitui_ast_binary_list *list =
+            waitui_ast_binary_getRecord(this, offset, sizeof(*list));
+
+    if (!list || (this->size - offset - sizeof(*list)) / sizeof(uint32_t) <
+                         list->length) {
+        return NULL;
+    }
+    return list;
+}
+
+/**
+ * @brief Get the string with the index out of the string table.
+ * @param[in] this The binary AST image to get the string from
+ * @param[in] index The index of the string
+ * @param[out] value The str to point to the string inside of the image
+ * @retval 1 Ok
+ * @retval 0 There is no valid string with the index
+ */
+static int waitui_ast_binary_getTableString(const waitui_ast_binary *this,
+                                            uint32_t index, str *value) {
+    const waitui_ast_binary_string_entry *entry = NULL;
+
+    if (index >= this->header->stringCount) { return 0; }
+
+    entry = (const waitui_ast_binary_string_entry *) (this->data +
+                                                      this->header->strings) +
+            index;
+    if (entry->offset > this->size ||
+        this->size - entry->offset <= entry->length ||
+        this->data[entry->offset + entry->length] != '\0') {
+        return 0;
+    }
+
+    value->s   = (char *) (this->data + entry->offset);
+    value->len = entry->length;
+
+    return 1;
+}
+
+/**
+ * @brief Get the raw value of the field of the node.
+ * @param[in] node The node to get the field of
+ * @param[in] field The field to get
+ * @return The value of the field or 0 if the node has no such field
+ */
+static inline uint32_t
+waitui_ast_binary_getField(const waitui_ast_binary_node *node,
+                           waitui_ast_field field) {
+    if (!node || (uint32_t) field >= node->fieldCount) { return 0; }
+    return node->fields[field];
+}
+
+/**
+ * @brief Get the symbol of the reference in the field of the node.
+ * @param[in] this The binary AST image of the node
+ * @param[in] node The node to get the field of
+ * @param[in] field The field holding the reference
+ * @param[out] reference The reference to point into the reference table
+ * @return On success a pointer to the symbol table entry, else NULL
+ */
+static const waitui_ast_binary_symbol_entry *
+waitui_ast_binary_getTableSymbol(
+        const waitui_ast_binary *this, const waitui_ast_binary_node *node,
+        waitui_ast_field field,
+        const waitui_ast_binary_reference_entry **reference) {
+    const waitui_ast_binary_reference_entry *references = NULL;
+    const waitui_ast_binary_symbol_entry *symbols       = NULL;
+    uint32_t index = waitui_ast_binary_getField(node, field);
+
+    if (!index || index > this->header->referenceCount) { return NULL; }
+
+    references = (const void *) (this->data + this->header->references);
+    symbols    = (const void *) (this->data + this->header->symbols);
+
+    *reference = &references[index - 1];
+    if ((*reference)->symbol >= this->header->symbolCount) { return NULL; }
+
+    return &symbols[(*reference)->symbol];
+}
+
+/**
+ * @brief Get the offset of a record referred to by another record.
+ * @param[in] this The binary AST image of the records
+ * @param[in] record The record referring to the other record
+ * @param[in] offset The offset of the other record
+ * @return The offset or 0 if the reference is invalid
+ * @note The records are written in pre-order, so a valid image only refers
+ *       forward. This keeps a broken image from sending a walk into a cycle.
+ */
+static inline uint32_t
+waitui_ast_binary_getReference(const waitui_ast_binary *this,
+                               const void *record, uint32_t offset) {
+    if (offset <= (uint32_t) ((const unsigned char *) record - this->data)) {
+        return 0;
+    }
+    return offset;
+}
+
+/**
+ * @brief Check the header of the binary AST image.
+ * @param[in,out] this The binary AST image to check
+ * @retval 1 Ok
+ * @retval 0 The image is invalid
+ * @note Records are only checked when they are accessed, so opening an image
+ *       does not depend on its size.
+ */
+static int waitui_ast_binary_checkHeader(waitui_ast_binary *this) {
+    const waitui_ast_binary_header *header = NULL;
+
+    if ((uintptr_t) this->data % WAITUI_AST_BINARY_ALIGNMENT != 0 ||
+        this->size < sizeof(*header) || this->size > UINT32_MAX) {
+        return 0;
+    }
+
+    header = (const waitui_ast_binary_header *) this->data;
+    if (memcmp(header->magic, WAITUI_AST_BINARY_MAGIC, sizeof(header->magic)) !=
+                0 ||
+        header->version != WAITUI_AST_BINARY_VERSION ||
+        header->byteOrder != WAITUI_AST_BINARY_BYTE_ORDER ||
+        header->size != this->size) {
+        return 0;
+    }
+
+    if (header->referenceCount > 0 &&
+        !waitui_ast_binary_getRecord(
+                this, header->references,
+                (size_t) header->referenceCount *
+                        sizeof(waitui_ast_binary_reference_entry))) {
+        return 0;
+    }
+
+    if (header->symbolCount > 0 &&
+        !waitui_ast_binary_getRecord(
+                this, header->symbols,
+                (size_t) header->symbolCount *
+                        sizeof(waitui_ast_binary_symbol_entry))) {
+        return 0;
+    }
+
+    if (header->stringCount > 0 &&
+        !waitui_ast_binary_getRecord(
+                this, header->strings,
+                (size_t) header->stringCount *
+                        sizeof(waitui_ast_binary_string_entry))) {
+        return 0;
+    }
+
+    this->header = header;
+
+    if (waitui_ast_binary_node_getDefinitionType(waitui_ast_binary_getProgram(
+                this)) != WAITUI_AST_DEFINITION_TYPE_PROGRAM) {
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Create the binary AST image for the data.
+ * @param[in] data The image
+ * @param[in] size The size of the image
+ * @param[in] mapped Whether the data is a memory mapping owned by the image
+ * @return On success a pointer to waitui_ast_binary, else NULL
+ */
+static waitui_ast_binary *waitui_ast_binary_new(const void *data, size_t size,
+                                                bool mapped) {
+    waitui_ast_binary *this = NULL;
+
+    this = calloc(1, sizeof(*this));
+    if (!this) { return NULL; }
+
+    this->data   = data;
+    this->size   = size;
+    this->mapped = mapped;
+
+    if (!waitui_ast_binary_checkHeader(this)) {
+        waitui_log_debug("invalid binary AST image");
+        free(this);
+        return NULL;
+    }
+
+    return this;
+}
+
+/**
+ * @brief Release the reference the arena holds to a loaded symbol.
+ * @param[in,out] data The symbol to release
+ */
+static void waitui_ast_binary_symbol_cleanup(void **data) {
+    symbol *referenced = *data;
+
+    symbol_decrement_refcount(&referenced);
+    *data = NULL;
+}
+
+/**
+ * @brief Create the symbol in the field of the node for the AST.
+ * @param[in,out] this The loader to create the symbol with
+ * @param[in] node The node to get the field of
+ * @param[in] field The field holding the symbol
+ * @return On success a pointer to symbol, else NULL
+ * @note Like the lexer the arena holds a reference to every symbol.
+ */
+static symbol *waitui_ast_binary_loadSymbol(waitui_ast_binary_loader *this,
+                                            const waitui_ast_binary_node *node,
+                                            waitui_ast_field field) {
+    const waitui_ast_binary_reference_entry *reference = NULL;
+    const waitui_ast_binary_symbol_entry *entry        = NULL;
+    str identifier                                     = STR_NULL_INIT;
+    symbol *result                                     = NULL;
+
+    if (!waitui_ast_binary_getField(node, field) || this->failed) {
+        return NULL;
+    }
+
+    entry = waitui_ast_binary_getTableSymbol(this->binary, node, field,
+                                             &reference);
+    if (!entry ||
+        !waitui_ast_binary_getTableString(this->binary, entry->identifier,
+                                          &identifier) ||
+        !waitui_intern_str(this->intern, identifier, &identifier)) {
+        this->failed = true;
+        return NULL;
+    }
+
+    result = symbol_new(identifier, (symbol_type) entry->type, reference->line,
+                        reference->column);
+    if (!result) {
+        this->failed = true;
+        return NULL;
+    }
+    if (!waitui_arena_addCleanup(this->arena, waitui_ast_binary_symbol_cleanup,
+                                 result)) {
+        symbol_destroy(&result);
+        this->failed = true;
+        return NULL;
+    }
+    symbol_increment_refcount(result);
+
+    return result;
+}
+
+/**
+ * @brief Create the string in the field of the node for the AST.
+ * @param[in,out] this The loader to create the string with
+ * @param[in] node The node to get the field of
+ * @param[in] field The field holding the string
+ * @return The string interned in the AST
+ */
+static str waitui_ast_binary_loadString(waitui_ast_binary_loader *this,
+                                        const waitui_ast_binary_node *node,
+                                        waitui_ast_field field) {
+    str value = STR_NULL_INIT;
+
+    if (this->failed) { return value; }
+
+    if (!waitui_ast_binary_getString(this->binary, node, field, &value) ||
+        !waitui_intern_str(this->intern, value, &value)) {
+        this->failed = true;
+    }
+
+    return value;
+}
+
+static waitui_ast_node *
+waitui_ast_binary_loadNode(waitui_ast_binary_loader *this,
+                           const waitui_ast_binary_node *node);
+
+/**
+ * @brief Create the node in the field of the node for the AST.
+ * @param[in,out] this The loader to create the node with
+ * @param[in] node The node to get the field of
+ * @param[in] field The field holding the node
+ * @return On success a pointer to the AST node, else NULL
+ */
+static void *
+waitui_ast_binary_loadField(waitui_ast_binary_loader *this,
+                            const waitui_ast_binary_node *node,
+                            waitui_ast_field field) {
+    uint32_t offset = waitui_ast_binary_getReference(
+            this->binary, node, waitui_ast_binary_getField(node, field));
+
+    if (!offset || this->failed) { return NULL; }
+
+    node = waitui_ast_binary_getNodeRecord(this->binary, offset);
+    if (!node) {
+        this->failed = true;
+        return NULL;
+    }
+
+    return waitui_ast_binary_loadNode(this, node);
+}
+
+/**
+ * @brief Create the list in the field of the node for the AST.
+ * @param[in,out] this The loader to create the list with
+ * @param[in] node The node to get the field of
+ * @param[in] field The field holding the list
+ * @return On success a pointer to waitui_vector, else NULL
+ */
+static waitui_vector *
+waitui_ast_binary_loadList(waitui_ast_binary_loader *this,
+                           const waitui_ast_binary_node *node,
+                           waitui_ast_field field) {
+    const waitui_ast_binary_list *record = NULL;
+    waitui_vector *list                  = NULL;
+    uint32_t offset = waitui_ast_binary_getReference(
+            this->binary, node, waitui_ast_binary_getField(node, field));
+
+    if (!offset || this->failed) { return NULL; }
+
+    record = waitui_ast_binary_getListRecord(this->binary, offset);
+    list   = waitui_vector_newInArena(this->arena);
+    if (!record || !list) {
+        this->failed = true;
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < record->length && !this->failed; ++i) {
+        const waitui_ast_binary_node *element =
+                waitui_ast_binary_getNodeRecord(
+                        this->binary, waitui_ast_binary_getReference(
+                                              this->binary, record,
+                                              record->nodes[i]));
+        waitui_ast_node *value = NULL;
+
+        if (element) { value = waitui_ast_binary_loadNode(this, element); }
+        if (!value || !waitui_vector_push(list, value)) { this->failed = true; }
+    }
+
+    return list;
+}
+
+/**
+ * @brief Create the definition for the AST.
+ * @param[in,out] this The loader to create the definition with
+ * @param[in] node The node record of the definition
+ * @return On success a pointer to waitui_ast_definition, else NULL
+ */
+static waitui_ast_definition *
+waitui_ast_binary_loadDefinition(waitui_ast_binary_loader *this,
+                                 const waitui_ast_binary_node *node) {
+    waitui_arena *arena = this->arena;
+
+    switch (waitui_ast_binary_node_getDefinitionType(node)) {
+        case WAITUI_AST_DEFINITION_TYPE_PROGRAM: {
+            waitui_ast_namespace_vector *namespaces =
+                    AST_BINARY_LOAD_LIST(PROGRAM_NAMESPACES);
+
+            return (waitui_ast_definition *) waitui_ast_program_new(arena,
+                                                                    namespaces);
+        }
+        case WAITUI_AST_DEFINITION_TYPE_NAMESPACE: {
+            symbol *name = AST_BINARY_LOAD_SYMBOL(NAMESPACE_NAME);
+            waitui_ast_import_vector *imports =
+                    AST_BINARY_LOAD_LIST(NAMESPACE_IMPORTS);
+            waitui_ast_class_vector *classes =
+                    AST_BINARY_LOAD_LIST(NAMESPACE_CLASSES);
+
+            return (waitui_ast_definition *) waitui_ast_namespace_new(
+                    arena, name, imports, classes);
+        }
+        case WAITUI_AST_DEFINITION_TYPE_IMPORT: {
+            symbol *name  = AST_BINARY_LOAD_SYMBOL(IMPORT_NAME);
+            symbol *alias = AST_BINARY_LOAD_SYMBOL(IMPORT_ALIAS);
+
+            return (waitui_ast_definition *) waitui_ast_import_new(arena, name,
+                                                                   alias);
+        }
+        case WAITUI_AST_DEFINITION_TYPE_CLASS: {
+            symbol *name = AST_BINARY_LOAD_SYMBOL(CLASS_NAME);
+            waitui_ast_formal_vector *parameters =
+                    AST_BINARY_LOAD_LIST(CLASS_PARAMETERS);
+            symbol *superClass = AST_BINARY_LOAD_SYMBOL(CLASS_SUPER_CLASS);
+            waitui_ast_expression_vector *superClassArgs =
+                    AST_BINARY_LOAD_LIST(CLASS_SUPER_CLASS_ARGS);
+            waitui_ast_property_vector *properties =
+                    AST_BINARY_LOAD_LIST(CLASS_PROPERTIES);
+            waitui_ast_function_vector *functions =
+                    AST_BINARY_LOAD_LIST(CLASS_FUNCTIONS);
+
+            return (waitui_ast_definition *) waitui_ast_class_new(
+                    arena, name, parameters, superClass, superClassArgs,
+                    properties, functions);
+        }
+        case WAITUI_AST_DEFINITION_TYPE_FORMAL: {
+            symbol *identifier = AST_BINARY_LOAD_SYMBOL(FORMAL_IDENTIFIER);
+            symbol *type       = AST_BINARY_LOAD_SYMBOL(FORMAL_TYPE);
+
+            return (waitui_ast_definition *) waitui_ast_formal_new(
+                    arena, identifier, type,
+                    node->flags & WAITUI_AST_BINARY_FLAG_LAZY);
+        }
+        case WAITUI_AST_DEFINITION_TYPE_PROPERTY: {
+            symbol *name = AST_BINARY_LOAD_SYMBOL(PROPERTY_NAME);
+            symbol *type = AST_BINARY_LOAD_SYMBOL(PROPERTY_TYPE);
+            waitui_ast_expression *value = AST_BINARY_LOAD_NODE(PROPERTY_VALUE);
+
+            return (waitui_ast_definition *) waitui_ast_property_new(
+                    arena, name, type, value);
+        }
+        case WAITUI_AST_DEFINITION_TYPE_FUNCTION: {
+            symbol *functionName = AST_BINARY_LOAD_SYMBOL(FUNCTION_NAME);
+            waitui_ast_formal_vector *parameters =
+                    AST_BINARY_LOAD_LIST(FUNCTION_PARAMETERS);
+            symbol *returnType = AST_BINARY_LOAD_SYMBOL(FUNCTION_RETURN_TYPE);
+            waitui_ast_expression *body = AST_BINARY_LOAD_NODE(FUNCTION_BODY);
+
+            return (waitui_ast_definition *) waitui_ast_function_new(
+                    arena, functionName, parameters, returnType, body,
+                    (waitui_ast_function_visibility) node->value,
+                    node->flags & WAITUI_AST_BINARY_FLAG_ABSTRACT,
+                    node->flags & WAITUI_AST_BINARY_FLAG_FINAL,
+                    node->flags & WAITUI_AST_BINARY_FLAG_OVERWRITE);
+        }
+        default:
+            return NULL;
+    }
+}
+
+/**
+ * @brief Create the expression for the AST.
+ * @param[in,out] this The loader to create the expression with
+ * @param[in] node The node record of the expression
+ * @return On success a pointer to waitui_ast_expression, else NULL
+ */
+static waitui_ast_expression *
+waitui_ast_binary_loadExpression(waitui_ast_binary_loader *this,
+                                 const waitui_ast_binary_node *node) {
+    waitui_arena *arena = this->arena;
+
+    switch (waitui_ast_binary_node_getExpressionType(node)) {
+        case WAITUI_AST_EXPRESSION_TYPE_INTEGER_LITERAL:
+            return (waitui_ast_expression *) waitui_ast_integer_literal_new(
+                    arena, AST_BINARY_LOAD_STRING(LITERAL_VALUE));
+        case WAITUI_AST_EXPRESSION_TYPE_DECIMAL_LITERAL:
+            return (waitui_ast_expression *) waitui_ast_decimal_literal_new(
+                    arena, AST_BINARY_LOAD_STRING(LITERAL_VALUE));
+        case WAITUI_AST_EXPRESSION_TYPE_STRING_LITERAL:
+            return (waitui_ast_expression *) waitui_ast_string_literal_new(
+                    arena, AST_BINARY_LOAD_STRING(LITERAL_VALUE));
+        case WAITUI_AST_EXPRESSION_TYPE_BOOLEAN_LITERAL:
+            return (waitui_ast_expression *) waitui_ast_boolean_literal_new(
+                    arena, node->value);
+        case WAITUI_AST_EXPRESSION_TYPE_NULL_LITERAL:
+            return (waitui_ast_expression *) waitui_ast_null_literal_new(arena);
+        case WAITUI_AST_EXPRESSION_TYPE_THIS_LITERAL:
+            return (waitui_ast_expression *) waitui_ast_this_literal_new(arena);
+        case WAITUI_AST_EXPRESSION_TYPE_NATIVE_EXPRESSION:
+            return (waitui_ast_expression *) waitui_ast_native_expression_new(
+                    arena);
+        case WAITUI_AST_EXPRESSION_TYPE_ASSIGNMENT: {
+            symbol *identifier = AST_BINARY_LOAD_SYMBOL(ASSIGNMENT_IDENTIFIER);
+            waitui_ast_expression *value =
+                    AST_BINARY_LOAD_NODE(ASSIGNMENT_VALUE);
+
+            return (waitui_ast_expression *) waitui_ast_assignment_new(
+                    arena, identifier,
+                    (waitui_ast_assignment_operator) node->value, value);
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_REFERENCE:
+            return (waitui_ast_expression *) waitui_ast_reference_new(
+                    arena, AST_BINARY_LOAD_SYMBOL(REFERENCE_VALUE));
+        case WAITUI_AST_EXPRESSION_TYPE_CAST: {
+            symbol *type                  = AST_BINARY_LOAD_SYMBOL(CAST_TYPE);
+            waitui_ast_expression *object = AST_BINARY_LOAD_NODE(CAST_OBJECT);
+
+            return (waitui_ast_expression *) waitui_ast_cast_new(arena, object,
+                                                                 type);
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_INITIALIZATION: {
+            symbol *identifier =
+                    AST_BINARY_LOAD_SYMBOL(INITIALIZATION_IDENTIFIER);
+            symbol *type = AST_BINARY_LOAD_SYMBOL(INITIALIZATION_TYPE);
+            waitui_ast_expression *value =
+                    AST_BINARY_LOAD_NODE(INITIALIZATION_VALUE);
+
+            return (waitui_ast_expression *) waitui_ast_initialization_new(
+                    arena, identifier, type, value);
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_LET: {
+            waitui_ast_initialization_vector *initializations =
+                    AST_BINARY_LOAD_LIST(LET_INITIALIZATIONS);
+            waitui_ast_expression *body = AST_BINARY_LOAD_NODE(LET_BODY);
+
+            return (waitui_ast_expression *) waitui_ast_let_new(
+                    arena, initializations, body);
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_BLOCK:
+            return (waitui_ast_expression *) waitui_ast_block_new(
+                    arena, AST_BINARY_LOAD_LIST(BLOCK_EXPRESSIONS));
+        case WAITUI_AST_EXPRESSION_TYPE_CONSTRUCTOR_CALL: {
+            symbol *name = AST_BINARY_LOAD_SYMBOL(CONSTRUCTOR_CALL_NAME);
+            waitui_ast_expression_vector *args =
+                    AST_BINARY_LOAD_LIST(CONSTRUCTOR_CALL_ARGS);
+
+            return (waitui_ast_expression *) waitui_ast_constructor_call_new(
+                    arena, name, args);
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_FUNCTION_CALL: {
+            waitui_ast_expression *object =
+                    AST_BINARY_LOAD_NODE(FUNCTION_CALL_OBJECT);
+            symbol *functionName =
+                    AST_BINARY_LOAD_SYMBOL(FUNCTION_CALL_FUNCTION_NAME);
+            waitui_ast_expression_vector *args =
+                    AST_BINARY_LOAD_LIST(FUNCTION_CALL_ARGS);
+
+            return (waitui_ast_expression *) waitui_ast_function_call_new(
+                    arena, object, functionName, args);
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_SUPER_FUNCTION_CALL: {
+            symbol *functionName =
+                    AST_BINARY_LOAD_SYMBOL(SUPER_FUNCTION_CALL_FUNCTION_NAME);
+            waitui_ast_expression_vector *args =
+                    AST_BINARY_LOAD_LIST(SUPER_FUNCTION_CALL_ARGS);
+
+            return (waitui_ast_expression *) waitui_ast_super_function_call_new(
+                    arena, functionName, args);
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_BINARY_EXPRESSION: {
+            waitui_ast_expression *left =
+                    AST_BINARY_LOAD_NODE(BINARY_EXPRESSION_LEFT);
+            waitui_ast_expression *right =
+                    AST_BINARY_LOAD_NODE(BINARY_EXPRESSION_RIGHT);
+
+            return (waitui_ast_expression *) waitui_ast_binary_expression_new(
+                    arena, left, (waitui_ast_binary_operator) node->value,
+                    right);
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_UNARY_EXPRESSION:
+            return (waitui_ast_expression *) waitui_ast_unary_expression_new(
+                    arena, (waitui_ast_unary_operator) node->value,
+                    AST_BINARY_LOAD_NODE(UNARY_EXPRESSION_EXPRESSION));
+        case WAITUI_AST_EXPRESSION_TYPE_IF_ELSE: {
+            waitui_ast_expression *condition =
+                    AST_BINARY_LOAD_NODE(IF_ELSE_CONDITION);
+            waitui_ast_expression *thenBranch =
+                    AST_BINARY_LOAD_NODE(IF_ELSE_THEN_BRANCH);
+            waitui_ast_expression *elseBranch =
+                    AST_BINARY_LOAD_NODE(IF_ELSE_ELSE_BRANCH);
+
+            return (waitui_ast_expression *) waitui_ast_if_else_new(
+                    arena, condition, thenBranch, elseBranch);
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_WHILE: {
+            waitui_ast_expression *condition =
+                    AST_BINARY_LOAD_NODE(WHILE_CONDITION);
+            waitui_ast_expression *body = AST_BINARY_LOAD_NODE(WHILE_BODY);
+
+            return (waitui_ast_expression *) waitui_ast_while_new(
+                    arena, condition, body);
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_LAZY_EXPRESSION:
+            return (waitui_ast_expression *) waitui_ast_lazy_expression_new(
+                    arena, AST_BINARY_LOAD_NODE(LAZY_EXPRESSION_EXPRESSION),
+                    NULL);
+        default:
+            return NULL;
+    }
+}
+
+/**
+ * @brief Create the AST node for the AST.
+ * @param[in,out] this The loader to create the node with
+ * @param[in] node The node record of the node
+ * @return On success a pointer to waitui_ast_node, else NULL
+ */
+static waitui_ast_node *
+waitui_ast_binary_loadNode(waitui_ast_binary_loader *this,
+                           const waitui_ast_binary_node *node) {
+    waitui_ast_node *result = NULL;
+
+    if (this->failed) { return NULL; }
+
+    // a tree has no more nodes than the image has room for node records
+    if (++this->nodeCount > this->binary->size / sizeof(*node)) {
+        this->failed = true;
+        return NULL;
+    }
+
+    switch (waitui_ast_binary_node_getNodeType(node)) {
+        case WAITUI_AST_NODE_TYPE_EXPRESSION:
+            result = (waitui_ast_node *) waitui_ast_binary_loadExpression(this,
+                                                                          node);
+            break;
+        case WAITUI_AST_NODE_TYPE_DEFINITION:
+            result = (waitui_ast_node *) waitui_ast_binary_loadDefinition(this,
+                                                                          node);
+            break;
+        default:
+            break;
+    }
+    if (!result) { this->failed = true; }
+
+    return result;
+}
+
+
+// -----------------------------------------------------------------------------
+//  Public functions
+// -----------------------------------------------------------------------------
+
+int waitui_ast_binary_write(waitui_ast *ast, FILE *file) {
+    waitui_ast_binary_writer writer = {0};
+    waitui_ast_binary_header *header = NULL;
+    uint32_t program                 = 0;
+    uint32_t references              = 0;
+    uint32_t symbols                 = 0;
+    uint32_t strings                 = 0;
+    int result                       = 0;
+
+    waitui_log_trace("start writing the binary waitui_ast");
+
+    if (!ast || !file) { return 0; }
+
+    writer.symbolTable = waitui_ast_binary_table_symbol_hashtable_new(256);
+    writer.stringTable = waitui_ast_binary_string_hashtable_new(256);
+    if (!writer.symbolTable || !writer.stringTable) { writer.failed = true; }
+
+    waitui_ast_binary_writer_reserve(&writer, sizeof(*header));
+    program = waitui_ast_binary_writeNode(
+            &writer, (waitui_ast_node *) waitui_ast_getProgram(ast));
+    references = waitui_ast_binary_writeSymbolTables(&writer, &symbols);
+    strings    = waitui_ast_binary_writeStringTable(&writer);
+
+    if (!writer.failed && program) {
+        header = (waitui_ast_binary_header *) writer.data;
+        memcpy(header->magic, WAITUI_AST_BINARY_MAGIC, sizeof(header->magic));
+        header->version     = WAITUI_AST_BINARY_VERSION;
+        header->byteOrder   = WAITUI_AST_BINARY_BYTE_ORDER;
+        header->size        = (uint32_t) writer.length;
+        header->program     = program;
+        header->nodeCount      = writer.nodeCount;
+        header->references     = references;
+        header->referenceCount = writer.referenceCount;
+        header->symbols        = symbols;
+        header->symbolCount    = writer.symbolCount;
+        header->strings        = strings;
+        header->stringCount    = writer.stringCount;
+
+        result = fwrite(writer.data, 1, writer.length, file) == writer.length;
+    }
+
+    waitui_ast_binary_table_symbol_hashtable_destroy(&writer.symbolTable);
+    waitui_ast_binary_string_hashtable_destroy(&writer.stringTable);
+    free(writer.references);
+    free(writer.symbols);
+    free(writer.strings);
+    free(writer.data);
+
+    waitui_log_trace("end writing the binary waitui_ast");
+
+    return result;
+}
+
+waitui_ast_binary *waitui_ast_binary_open(const char *fileName) {
+    waitui_ast_binary *this = NULL;
+    struct stat fileStat    = {0};
+    void *data              = MAP_FAILED;
+    int fd                  = -1;
+
+    waitui_log_trace("opening binary waitui_ast '%s'", fileName);
+
+    if (!fileName) { return NULL; }
+
+    fd = open(fileName, O_RDONLY);
+    if (fd == -1) { return NULL; }
+
+    if (fstat(fd, &fileStat) == 0 && fileStat.st_size > 0) {
+        data = mmap(NULL, (size_t) fileStat.st_size, PROT_READ, MAP_PRIVATE, fd,
+                    0);
+    }
+    close(fd);
+    if (data == MAP_FAILED) { return NULL; }
+
+    this = waitui_ast_binary_new(data, (size_t) fileStat.st_size, true);
+    if (!this) { munmap(data, (size_t) fileStat.st_size); }
+
+    return this;
+}
+
+waitui_ast_binary *waitui_ast_binary_fromMemory(const void *data,
+                                                size_t size) {
+    if (!data) { return NULL; }
+
+    return waitui_ast_binary_new(data, size, false);
+}
+
+void waitui_ast_binary_close(waitui_ast_binary **this) {
+    if (!this || !(*this)) { return; }
+
+    if ((*this)->mapped) { munmap((void *) (*this)->data, (*this)->size); }
+
+    free(*this);
+    *this = NULL;
+}
+
+const waitui_ast_binary_node *
+waitui_ast_binary_getProgram(const waitui_ast_binary *this) {
+    if (!this) { return NULL; }
+
+    return waitui_ast_binary_getNodeRecord(this, this->header->program);
+}
+
+unsigned long int
+waitui_ast_binary_getNodeCount(const waitui_ast_binary *this) {
+    if (!this) { return 0; }
+
+    return this->header->nodeCount;
+}
+
+waitui_ast_node_type
+waitui_ast_binary_node_getNodeType(const waitui_ast_binary_node *node) {
+    if (!node) { return WAITUI_AST_NODE_TYPE_UNDEFINED; }
+
+    return (waitui_ast_node_type) node->nodeType;
+}
+
+waitui_ast_definition_type
+waitui_ast_binary_node_getDefinitionType(const waitui_ast_binary_node *node) {
+    if (!node || node->nodeType != WAITUI_AST_NODE_TYPE_DEFINITION) {
+        return WAITUI_AST_DEFINITION_TYPE_UNDEFINED;
+    }
+
+    return (waitui_ast_definition_type) node->subType;
+}
+
+waitui_ast_expression_type
+waitui_ast_binary_node_getExpressionType(const waitui_ast_binary_node *node) {
+    if (!node || node->nodeType != WAITUI_AST_NODE_TYPE_EXPRESSION) {
+        return WAITUI_AST_EXPRESSION_TYPE_UNDEFINED;
+    }
+
+    return (waitui_ast_expression_type) node->subType;
+}
+
+unsigned int
+waitui_ast_binary_node_getValue(const waitui_ast_binary_node *node) {
+    if (!node) { return 0; }
+
+    return node->value;
+}
+
+unsigned int
+waitui_ast_binary_node_getFlags(const waitui_ast_binary_node *node) {
+    if (!node) { return 0; }
+
+    return node->flags;
+}
+
+const waitui_ast_binary_node *
+waitui_ast_binary_getNode(const waitui_ast_binary *this,
+                          const waitui_ast_binary_node *node,
+                          waitui_ast_field field) {
+    if (!this) { return NULL; }
+
+    return waitui_ast_binary_getNodeRecord(
+            this, waitui_ast_binary_getReference(
+                          this, node, waitui_ast_binary_getField(node, field)));
+}
+
+unsigned long int
+waitui_ast_binary_getListLength(const waitui_ast_binary *this,
+                                const waitui_ast_binary_node *node,
+                                waitui_ast_field field) {
+    const waitui_ast_binary_list *list = NULL;
+
+    if (!this) { return 0; }
+
+    list = waitui_ast_binary_getListRecord(
+            this, waitui_ast_binary_getReference(
+                          this, node, waitui_ast_binary_getField(node, field)));
+
+    return list ? list->length : 0;
+}
+
+const waitui_ast_binary_node *
+waitui_ast_binary_getListNode(const waitui_ast_binary *this,
+                              const waitui_ast_binary_node *node,
+                              waitui_ast_field field,
+                              unsigned long int index) {
+    const waitui_ast_binary_list *list = NULL;
+
+    if (!this) { return NULL; }
+
+    list = waitui_ast_binary_getListRecord(
+            this, waitui_ast_binary_getReference(
+                          this, node, waitui_ast_binary_getField(node, field)));
+    if (!list || index >= list->length) { return NULL; }
+
+    return waitui_ast_binary_getNodeRecord(
+            this,
+            waitui_ast_binary_getReference(this, list, list->nodes[index]));
+}
+
+int waitui_ast_binary_getSymbol(const waitui_ast_binary *this,
+                                const waitui_ast_binary_node *node,
+                                waitui_ast_field field,
+                                waitui_ast_binary_symbol *symbol) {
+    const waitui_ast_binary_reference_entry *reference = NULL;
+    const waitui_ast_binary_symbol_entry *entry        = NULL;
+
+    if (!this || !symbol) { return 0; }
+
+    entry = waitui_ast_binary_getTableSymbol(this, node, field, &reference);
+    if (!entry || !waitui_ast_binary_getTableString(this, entry->identifier,
+                                                    &symbol->identifier)) {
+        return 0;
+    }
+
+    symbol->type   = (symbol_type) entry->type;
+    symbol->line   = reference->line;
+    symbol->column = reference->column;
+
+    return 1;
+}
+
+int waitui_ast_binary_getString(const waitui_ast_binary *this,
+                                const waitui_ast_binary_node *node,
+                                waitui_ast_field field, str *value) {
+    if (!this || !value || !node || (uint32_t) field >= node->fieldCount) {
+        return 0;
+    }
+
+    return waitui_ast_binary_getTableString(this, node->fields[field], value);
+}
+
+waitui_ast *waitui_ast_binary_toAst(const waitui_ast_binary *this) {
+    waitui_ast_binary_loader loader = {0};
+    waitui_ast_program *program     = NULL;
+    waitui_ast *ast                 = NULL;
+
+    waitui_log_trace("start creating waitui_ast from binary waitui_ast");
+
+    if (!this) { return NULL; }
+
+    loader.binary = this;
+    loader.arena  = waitui_arena_new();
+    if (!loader.arena) { return NULL; }
+
+    loader.intern = waitui_intern_new(loader.arena);
+    if (!loader.intern) { loader.failed = true; }
+
+    program = (waitui_ast_program *) waitui_ast_binary_loadNode(
+            &loader, waitui_ast_binary_getProgram(this));
+
+    if (!loader.failed) { ast = waitui_ast_new(loader.arena, program); }
+    if (!ast) {
+        waitui_arena_destroy(&loader.arena);
+        return NULL;
+    }
+
+    waitui_log_trace("end creating waitui_ast from binary waitui_ast");
+
+    return ast;
+}
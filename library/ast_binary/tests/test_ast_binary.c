@@ -0,0 +1,265 @@
+/**
+ * @file test_ast_binary.c
+ * @author rick
+ * @date 17.10.26
+ * @brief Test for the binary AST image implementation
+ */
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <cmocka.h>
+
+#include "waitui/ast_binary.h"
+
+#include <waitui/ast_printer.h>
+#include <waitui/log.h>
+#include <waitui/parser.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct image {
+    char *data;
+    size_t size;
+} image;
+
+static const char source[] =
+        "namespace org.test\n"
+        "\n"
+        "import org.other\n"
+        "import org.more as More\n"
+        "\n"
+        "class Base(start: Int) {\n"
+        "    var count: Int = start\n"
+        "    var name = \"base\"\n"
+        "\n"
+        "    abstract public func area(): Int\n"
+        "    protected func scale(lazy factor: Int): Int = count * factor\n"
+        "}\n"
+        "\n"
+        "class Square(side: Int) extends Base(side) {\n"
+        "    final overwrite public func area(): Int = {\n"
+        "        let total: Int = 0, step = 1 in {\n"
+        "            while (total < side * side) total += step\n"
+        "            if (total == 0 || !true) -1 else total\n"
+        "        }\n"
+        "    }\n"
+        "    public func ratio(): Decimal = 1.5e3 / 0.25\n"
+        "    public func copy(): Square = new Square(super.area() as Int)\n"
+        "    public func print(): Null = native;\n"
+        "    private func nothing(): Null = this.scale(++count ~ null)\n"
+        "}\n";
+
+static waitui_ast *ast = NULL;
+
+static image generate_graph(waitui_ast *graphAst) {
+    image graph = {0};
+    FILE *file  = open_memstream(&graph.data, &graph.size);
+
+    assert_non_null(file);
+    waitui_ast_printer_generateGraph(graphAst, file);
+    fclose(file);
+
+    return graph;
+}
+
+static image write_image(waitui_ast *imageAst) {
+    image binary = {0};
+    FILE *file   = open_memstream(&binary.data, &binary.size);
+
+    assert_non_null(file);
+    assert_true(waitui_ast_binary_write(imageAst, file));
+    fclose(file);
+
+    return binary;
+}
+
+/**
+ * Open the possibly broken image and turn it into an AST, which has to fail
+ * cleanly instead of reading outside of the image.
+ */
+static void load_broken(const char *data, size_t size) {
+    char *copy                = malloc(size ? size : 1);
+    waitui_ast_binary *binary = NULL;
+    waitui_ast *loaded        = NULL;
+
+    assert_non_null(copy);
+    memcpy(copy, data, size);
+
+    binary = waitui_ast_binary_fromMemory(copy, size);
+    if (binary) {
+        loaded = waitui_ast_binary_toAst(binary);
+        ast_destroy(&loaded);
+        waitui_ast_binary_close(&binary);
+    }
+
+    free(copy);
+}
+
+static int setup(void **state) {
+    str sourceFileName = STR_STATIC_INIT("test_ast_binary.wai");
+    str sourceText     = {.s = (char *) source, .len = sizeof(source) - 1};
+    str workDirectory  = STR_STATIC_INIT("/tmp");
+    parser *parser     = NULL;
+
+    (void) state; /* unused */
+
+    waitui_log_setQuiet(true);
+
+    parser = parser_new_from_source(sourceFileName, sourceText, workDirectory,
+                                    0);
+    if (!parser) { return -1; }
+    if (parser_parse(parser)) { ast = parser_get_ast(parser); }
+    parser_destroy(&parser);
+
+    return ast ? 0 : -1;
+}
+
+static int teardown(void **state) {
+    (void) state; /* unused */
+
+    ast_destroy(&ast);
+
+    return 0;
+}
+
+static void test_ast_binary_round_trip(void **state) {
+    (void) state; /* unused */
+
+    image binary              = write_image(ast);
+    image expected            = generate_graph(ast);
+    image actual              = {0};
+    image rewritten           = {0};
+    waitui_ast_binary *loaded = NULL;
+    waitui_ast *loadedAst     = NULL;
+
+    loaded = waitui_ast_binary_fromMemory(binary.data, binary.size);
+    assert_non_null(loaded);
+    assert_true(waitui_ast_binary_getNodeCount(loaded) > 0);
+    assert_int_equal(waitui_ast_binary_node_getDefinitionType(
+                             waitui_ast_binary_getProgram(loaded)),
+                     WAITUI_AST_DEFINITION_TYPE_PROGRAM);
+
+    loadedAst = waitui_ast_binary_toAst(loaded);
+    assert_non_null(loadedAst);
+    waitui_ast_binary_close(&loaded);
+    assert_null(loaded);
+
+    // the loaded AST does not depend on the image anymore
+    memset(binary.data, 0, binary.size);
+
+    actual = generate_graph(loadedAst);
+    assert_true(expected.size > 0);
+    assert_int_equal(actual.size, expected.size);
+    assert_memory_equal(actual.data, expected.data, expected.size);
+
+    // writing the loaded AST again gives the same image
+    rewritten = write_image(loadedAst);
+    free(binary.data);
+    binary = write_image(ast);
+    assert_int_equal(rewritten.size, binary.size);
+    assert_memory_equal(rewritten.data, binary.data, binary.size);
+
+    ast_destroy(&loadedAst);
+    free(rewritten.data);
+    free(actual.data);
+    free(expected.data);
+    free(binary.data);
+}
+
+static void test_ast_binary_symbols(void **state) {
+    (void) state; /* unused */
+
+    image binary                        = write_image(ast);
+    waitui_ast_binary *loaded           = NULL;
+    const waitui_ast_binary_node *node  = NULL;
+    const waitui_ast_binary_node *copy  = NULL;
+    waitui_ast_binary_symbol className  = {0};
+    waitui_ast_binary_symbol returnType = {0};
+
+    loaded = waitui_ast_binary_fromMemory(binary.data, binary.size);
+    assert_non_null(loaded);
+
+    node = waitui_ast_binary_getListNode(loaded,
+                                         waitui_ast_binary_getProgram(loaded),
+                                         WAITUI_AST_FIELD_PROGRAM_NAMESPACES,
+                                         0);
+    node = waitui_ast_binary_getListNode(
+            loaded, node, WAITUI_AST_FIELD_NAMESPACE_CLASSES, 1);
+    copy = waitui_ast_binary_getListNode(loaded, node,
+                                         WAITUI_AST_FIELD_CLASS_FUNCTIONS, 2);
+    assert_non_null(copy);
+
+    assert_true(waitui_ast_binary_getSymbol(
+            loaded, node, WAITUI_AST_FIELD_CLASS_NAME, &className));
+    assert_true(waitui_ast_binary_getSymbol(
+            loaded, copy, WAITUI_AST_FIELD_FUNCTION_RETURN_TYPE, &returnType));
+    assert_false(waitui_ast_binary_getSymbol(
+            loaded, copy, WAITUI_AST_FIELD_FUNCTION_BODY, &returnType));
+
+    // both references share the symbol but keep their own position
+    assert_int_equal(className.identifier.len, 6);
+    assert_memory_equal(className.identifier.s, "Square", 6);
+    assert_ptr_equal(returnType.identifier.s, className.identifier.s);
+    assert_int_equal(className.line, 14);
+    assert_int_equal(returnType.line, 22);
+
+    waitui_ast_binary_close(&loaded);
+    free(binary.data);
+}
+
+static void test_ast_binary_truncated(void **state) {
+    (void) state; /* unused */
+
+    image binary = write_image(ast);
+
+    assert_null(waitui_ast_binary_fromMemory(binary.data, 0));
+
+    for (size_t size = 0; size < binary.size; ++size) {
+        load_broken(binary.data, size);
+    }
+
+    free(binary.data);
+}
+
+static void test_ast_binary_corrupt(void **state) {
+    (void) state; /* unused */
+
+    image binary = write_image(ast);
+    char *broken = malloc(binary.size);
+
+    assert_non_null(broken);
+
+    // a wrong magic is no image at all
+    memcpy(broken, binary.data, binary.size);
+    broken[0] = (char) ~broken[0];
+    assert_null(waitui_ast_binary_fromMemory(broken, binary.size));
+
+    // every single byte flipped may not read outside of the image
+    for (size_t offset = 0; offset < binary.size; ++offset) {
+        memcpy(broken, binary.data, binary.size);
+        broken[offset] = (char) ~broken[offset];
+        load_broken(broken, binary.size);
+
+        broken[offset] = (char) 0x7f;
+        load_broken(broken, binary.size);
+    }
+
+    free(broken);
+    free(binary.data);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test(test_ast_binary_round_trip),
+            cmocka_unit_test(test_ast_binary_symbols),
+            cmocka_unit_test(test_ast_binary_truncated),
+            cmocka_unit_test(test_ast_binary_corrupt),
+    };
+
+    return cmocka_run_group_tests(tests, setup, teardown);
+}
@@ -0,0 +1,225 @@
+/**
+ * @file ast_flat.h
+ * @author rick
+ * @date 17.10.26
+ * @brief File for the flat AST implementation
+ */
+
+#ifndef WAITUI_AST_FLAT_H
+#define WAITUI_AST_FLAT_H
+
+#include <waitui/ast.h>
+#include <waitui/str.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+// -----------------------------------------------------------------------------
+//  Public defines
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The id used for no node, the nodes start at 1.
+ */
+#define WAITUI_AST_FLAT_NO_NODE 0
+
+/**
+ * @brief The bit of the kind byte set for expressions.
+ * @note The remaining bits of the kind byte hold the definition type of
+ *       definitions and the expression type of expressions.
+ */
+#define WAITUI_AST_FLAT_KIND_EXPRESSION 0x80
+
+/**
+ * @brief Flags of a flat AST node.
+ */
+#define WAITUI_AST_FLAT_FLAG_LAZY 0x01
+#define WAITUI_AST_FLAT_FLAG_ABSTRACT 0x02
+#define WAITUI_AST_FLAT_FLAG_FINAL 0x04
+#define WAITUI_AST_FLAT_FLAG_OVERWRITE 0x08
+
+
+// -----------------------------------------------------------------------------
+//  Public types
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Type representing a flat AST.
+ * @note The nodes of a flat AST are numbered in pre-order and stored as a
+ *       struct of arrays: one kind byte, value byte and flags byte per node,
+ *       the index of its first field and the id after its last descendant.
+ *       The fields of all nodes are 32-bit slots in one array, the nodes of
+ *       every list are a contiguous range of ids in a side array, symbols and
+ *       strings live in side arrays as well. A pass over all nodes therefore
+ *       streams through a few dense arrays instead of chasing pointers.
+ */
+typedef struct waitui_ast_flat waitui_ast_flat;
+
+/**
+ * @brief Type for the id of a node inside of a flat AST.
+ */
+typedef uint32_t waitui_ast_flat_id;
+
+
+// -----------------------------------------------------------------------------
+//  Public functions
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Create a flat AST out of the AST.
+ * @param[in] ast The AST to convert
+ * @return On success a pointer to waitui_ast_flat, else NULL
+ * @note The flat AST copies the strings and holds a reference on every symbol,
+ *       so it does not depend on the AST. The functions of native expressions
+ *       are not part of the flat AST.
+ */
+extern waitui_ast_flat *waitui_ast_flat_fromAst(waitui_ast *ast);
+
+/**
+ * @brief Destroy the flat AST.
+ * @param[in,out] this The flat AST to destroy
+ */
+extern void waitui_ast_flat_destroy(waitui_ast_flat **this);
+
+/**
+ * @brief Get the id of the program node of the flat AST.
+ * @param[in] this The flat AST to get the program from
+ * @return The id of the program node or WAITUI_AST_FLAT_NO_NODE
+ */
+extern waitui_ast_flat_id
+waitui_ast_flat_getProgram(const waitui_ast_flat *this);
+
+/**
+ * @brief Get the number of nodes in the flat AST.
+ * @param[in] this The flat AST to ask
+ * @return The number of nodes, the ids run from 1 to this number
+ */
+extern unsigned long int
+waitui_ast_flat_getNodeCount(const waitui_ast_flat *this);
+
+/**
+ * @brief Get the number of bytes the flat AST occupies.
+ * @param[in] this The flat AST to ask
+ * @return The number of bytes
+ */
+extern size_t waitui_ast_flat_getMemorySize(const waitui_ast_flat *this);
+
+/**
+ * @brief Get the kind byte of the node.
+ * @param[in] this The flat AST of the node
+ * @param[in] node The id of the node
+ * @return The kind byte, 0 for no node
+ */
+extern uint8_t waitui_ast_flat_getKind(const waitui_ast_flat *this,
+                                       waitui_ast_flat_id node);
+
+/**
+ * @brief Get the node type of the node.
+ * @param[in] this The flat AST of the node
+ * @param[in] node The id of the node
+ * @return The node type
+ */
+extern waitui_ast_node_type
+waitui_ast_flat_getNodeType(const waitui_ast_flat *this,
+                            waitui_ast_flat_id node);
+
+/**
+ * @brief Get the definition type of the node.
+ * @param[in] this The flat AST of the node
+ * @param[in] node The id of the node
+ * @return The definition type, WAITUI_AST_DEFINITION_TYPE_UNDEFINED for
+ *         expressions
+ */
+extern waitui_ast_definition_type
+waitui_ast_flat_getDefinitionType(const waitui_ast_flat *this,
+                                  waitui_ast_flat_id node);
+
+/**
+ * @brief Get the expression type of the node.
+ * @param[in] this The flat AST of the node
+ * @param[in] node The id of the node
+ * @return The expression type, WAITUI_AST_EXPRESSION_TYPE_UNDEFINED for
+ *         definitions
+ */
+extern waitui_ast_expression_type
+waitui_ast_flat_getExpressionType(const waitui_ast_flat *this,
+                                  waitui_ast_flat_id node);
+
+/**
+ * @brief Get the value of the node.
+ * @param[in] this The flat AST of the node
+ * @param[in] node The id of the node
+ * @return The operator, the function visibility or the boolean literal value
+ */
+extern unsigned int waitui_ast_flat_getValue(const waitui_ast_flat *this,
+                                             waitui_ast_flat_id node);
+
+/**
+ * @brief Get the flags of the node.
+ * @param[in] this The flat AST of the node
+ * @param[in] node The id of the node
+ * @return The WAITUI_AST_FLAT_FLAG_* flags of the node
+ */
+extern unsigned int waitui_ast_flat_getFlags(const waitui_ast_flat *this,
+                                             waitui_ast_flat_id node);
+
+/**
+ * @brief Get the id after the last descendant of the node.
+ * @param[in] this The flat AST of the node
+ * @param[in] node The id of the node
+ * @return The id the next node after the subtree of the node would have
+ * @note The subtree of the node are the ids from node to this id, so a pass
+ *       can skip a subtree by continuing at this id.
+ */
+extern waitui_ast_flat_id waitui_ast_flat_getEnd(const waitui_ast_flat *this,
+                                                 waitui_ast_flat_id node);
+
+/**
+ * @brief Get the node in the field of the node.
+ * @param[in] this The flat AST of the node
+ * @param[in] node The id of the node
+ * @param[in] field The field holding a node
+ * @return The id of the node or WAITUI_AST_FLAT_NO_NODE
+ */
+extern waitui_ast_flat_id waitui_ast_flat_getNode(const waitui_ast_flat *this,
+                                                  waitui_ast_flat_id node,
+                                                  waitui_ast_field field);
+
+/**
+ * @brief Get the nodes of the list in the field of the node.
+ * @param[in] this The flat AST of the node
+ * @param[in] node The id of the node
+ * @param[in] field The field holding a list
+ * @param[out] length The length of the list, 0 for no list
+ * @return The ids of the nodes of the list, NULL for an empty or no list
+ */
+extern const waitui_ast_flat_id *
+waitui_ast_flat_getList(const waitui_ast_flat *this, waitui_ast_flat_id node,
+                        waitui_ast_field field, unsigned long int *length);
+
+/**
+ * @brief Get the symbol in the field of the node.
+ * @param[in] this The flat AST of the node
+ * @param[in] node The id of the node
+ * @param[in] field The field holding a symbol
+ * @return On success a pointer to the symbol owned by the flat AST, else NULL
+ */
+extern symbol *waitui_ast_flat_getSymbol(const waitui_ast_flat *this,
+                                         waitui_ast_flat_id node,
+                                         waitui_ast_field field);
+
+/**
+ * @brief Get the string in the field of the node.
+ * @param[in] this The flat AST of the node
+ * @param[in] node The id of the node
+ * @param[in] field The field holding a string
+ * @param[out] value The str to point to the NUL terminated string
+ * @retval 1 Ok
+ * @retval 0 The field holds no string
+ */
+extern int waitui_ast_flat_getString(const waitui_ast_flat *this,
+                                     waitui_ast_flat_id node,
+                                     waitui_ast_field field, str *value);
+
+#endif//WAITUI_AST_FLAT_H
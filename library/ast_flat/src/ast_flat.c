@@ -0,0 +1,1095 @@
+/**
+ * @file ast_flat.c
+ * @author rick
+ * @date 17.10.26
+ * @brief File for the flat AST implementation
+ */
+
+#include "waitui/ast_flat.h"
+
+#include <waitui/log.h>
+#include <waitui/vector.h>
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+// -----------------------------------------------------------------------------
+//  Local defines
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The maximal number of fields of a node.
+ */
+#define WAITUI_AST_FLAT_MAX_FIELDS 6
+
+/**
+ * @brief The initial capacity of every array of the flat AST.
+ */
+#define WAITUI_AST_FLAT_INITIAL_CAPACITY 64
+
+/**
+ * @brief The kind byte of the definition type.
+ */
+#define AST_FLAT_DEFINITION(type) (WAITUI_AST_DEFINITION_TYPE_##type)
+
+/**
+ * @brief The kind byte of the expression type.
+ */
+#define AST_FLAT_EXPRESSION(type)                                              \
+    (WAITUI_AST_FLAT_KIND_EXPRESSION | WAITUI_AST_EXPRESSION_TYPE_##type)
+
+/**
+ * @brief Store the symbol in the field of the current node.
+ */
+#define AST_FLAT_SET_SYMBOL(field, value)                                      \
+    waitui_ast_flat_builder_setSymbol(this, id, WAITUI_AST_FIELD_##field,      \
+                                      (value))
+
+/**
+ * @brief Reserve the range for the list in the field of the current node.
+ */
+#define AST_FLAT_SET_LIST(field, value)                                        \
+    waitui_ast_flat_builder_setList(this, id, WAITUI_AST_FIELD_##field,        \
+                                    (waitui_vector *) (value))
+
+/**
+ * @brief Store the string in the field of the current node.
+ */
+#define AST_FLAT_SET_STRING(field, value)                                      \
+    waitui_ast_flat_builder_setString(this, id, WAITUI_AST_FIELD_##field,      \
+                                      (value))
+
+
+// -----------------------------------------------------------------------------
+//  Local types
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief What a field of a flat AST node holds.
+ * @note The slot of a node field is the id of the node, the slots of the other
+ *       fields are the index into their side array plus one, 0 means none.
+ */
+typedef enum waitui_ast_flat_slot {
+    WAITUI_AST_FLAT_SLOT_NONE,
+    WAITUI_AST_FLAT_SLOT_NODE,
+    WAITUI_AST_FLAT_SLOT_LIST,
+    WAITUI_AST_FLAT_SLOT_SYMBOL,
+    WAITUI_AST_FLAT_SLOT_STRING,
+} waitui_ast_flat_slot;
+
+/**
+ * @brief Type for the fields of a node kind.
+ */
+typedef struct waitui_ast_flat_layout {
+    uint8_t fieldCount;
+    uint8_t slots[WAITUI_AST_FLAT_MAX_FIELDS];
+} waitui_ast_flat_layout;
+
+/**
+ * @brief Type for a range of a side array.
+ */
+typedef struct waitui_ast_flat_range {
+    uint32_t first;
+    uint32_t length;
+} waitui_ast_flat_range;
+
+/**
+ * @brief Struct representing a flat AST.
+ * @note The node arrays share the node length and capacity, id 0 is the
+ *       unused entry for no node.
+ */
+struct waitui_ast_flat {
+    uint8_t *kinds;
+    uint8_t *values;
+    uint8_t *flags;
+    uint32_t *firstFields;
+    uint32_t *ends;
+    uint32_t nodeLength;
+    uint32_t nodeCapacity;
+    uint32_t *fields;
+    uint32_t fieldLength;
+    uint32_t fieldCapacity;
+    waitui_ast_flat_range *lists;
+    uint32_t listLength;
+    uint32_t listCapacity;
+    waitui_ast_flat_id *children;
+    uint32_t childLength;
+    uint32_t childCapacity;
+    symbol **symbols;
+    uint32_t symbolLength;
+    uint32_t symbolCapacity;
+    waitui_ast_flat_range *strings;
+    uint32_t stringLength;
+    uint32_t stringCapacity;
+    char *characters;
+    uint32_t characterLength;
+    uint32_t characterCapacity;
+};
+
+/**
+ * @brief Type for a node on the stack of the builder.
+ * @note The cursors are the number of nodes already stored per list field.
+ */
+typedef struct waitui_ast_flat_frame {
+    waitui_ast_flat_id id;
+    uint32_t cursors[WAITUI_AST_FLAT_MAX_FIELDS];
+} waitui_ast_flat_frame;
+
+/**
+ * @brief Type for creating a flat AST out of an AST.
+ * @note The frames are indexed by the depth of the visited node. After a
+ *       failure the visit is stopped and the failure is reported at the end.
+ */
+typedef struct waitui_ast_flat_builder {
+    waitui_ast_flat *flat;
+    waitui_ast_flat_frame *frames;
+    unsigned long int frameCapacity;
+    bool failed;
+} waitui_ast_flat_builder;
+
+
+// -----------------------------------------------------------------------------
+//  Local variables
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The fields of the node kinds, indexed by the kind byte.
+ */
+static const waitui_ast_flat_layout waitui_ast_flat_layouts[256] = {
+        [AST_FLAT_DEFINITION(PROGRAM)] =
+                {1, {WAITUI_AST_FLAT_SLOT_LIST}},
+        [AST_FLAT_DEFINITION(NAMESPACE)] =
+                {3,
+                 {WAITUI_AST_FLAT_SLOT_SYMBOL,
+                  WAITUI_AST_FLAT_SLOT_LIST,
+                  WAITUI_AST_FLAT_SLOT_LIST}},
+        [AST_FLAT_DEFINITION(IMPORT)] =
+                {2, {WAITUI_AST_FLAT_SLOT_SYMBOL, WAITUI_AST_FLAT_SLOT_SYMBOL}},
+        [AST_FLAT_DEFINITION(CLASS)] =
+                {6,
+                 {WAITUI_AST_FLAT_SLOT_SYMBOL,
+                  WAITUI_AST_FLAT_SLOT_LIST,
+                  WAITUI_AST_FLAT_SLOT_SYMBOL,
+                  WAITUI_AST_FLAT_SLOT_LIST,
+                  WAITUI_AST_FLAT_SLOT_LIST,
+                  WAITUI_AST_FLAT_SLOT_LIST}},
+        [AST_FLAT_DEFINITION(FORMAL)] =
+                {2, {WAITUI_AST_FLAT_SLOT_SYMBOL, WAITUI_AST_FLAT_SLOT_SYMBOL}},
+        [AST_FLAT_DEFINITION(PROPERTY)] =
+                {3,
+                 {WAITUI_AST_FLAT_SLOT_SYMBOL,
+                  WAITUI_AST_FLAT_SLOT_SYMBOL,
+                  WAITUI_AST_FLAT_SLOT_NODE}},
+        [AST_FLAT_DEFINITION(FUNCTION)] =
+                {4,
+                 {WAITUI_AST_FLAT_SLOT_SYMBOL,
+                  WAITUI_AST_FLAT_SLOT_LIST,
+                  WAITUI_AST_FLAT_SLOT_SYMBOL,
+                  WAITUI_AST_FLAT_SLOT_NODE}},
+        [AST_FLAT_EXPRESSION(INTEGER_LITERAL)] =
+                {1, {WAITUI_AST_FLAT_SLOT_STRING}},
+        [AST_FLAT_EXPRESSION(DECIMAL_LITERAL)] =
+                {1, {WAITUI_AST_FLAT_SLOT_STRING}},
+        [AST_FLAT_EXPRESSION(STRING_LITERAL)] =
+                {1, {WAITUI_AST_FLAT_SLOT_STRING}},
+        [AST_FLAT_EXPRESSION(ASSIGNMENT)] =
+                {2, {WAITUI_AST_FLAT_SLOT_SYMBOL, WAITUI_AST_FLAT_SLOT_NODE}},
+        [AST_FLAT_EXPRESSION(REFERENCE)] =
+                {1, {WAITUI_AST_FLAT_SLOT_SYMBOL}},
+        [AST_FLAT_EXPRESSION(CAST)] =
+                {2, {WAITUI_AST_FLAT_SLOT_SYMBOL, WAITUI_AST_FLAT_SLOT_NODE}},
+        [AST_FLAT_EXPRESSION(INITIALIZATION)] =
+                {3,
+                 {WAITUI_AST_FLAT_SLOT_SYMBOL,
+                  WAITUI_AST_FLAT_SLOT_SYMBOL,
+                  WAITUI_AST_FLAT_SLOT_NODE}},
+        [AST_FLAT_EXPRESSION(LET)] =
+                {2, {WAITUI_AST_FLAT_SLOT_LIST, WAITUI_AST_FLAT_SLOT_NODE}},
+        [AST_FLAT_EXPRESSION(BLOCK)] =
+                {1, {WAITUI_AST_FLAT_SLOT_LIST}},
+        [AST_FLAT_EXPRESSION(CONSTRUCTOR_CALL)] =
+                {2, {WAITUI_AST_FLAT_SLOT_SYMBOL, WAITUI_AST_FLAT_SLOT_LIST}},
+        [AST_FLAT_EXPRESSION(FUNCTION_CALL)] =
+                {3,
+                 {WAITUI_AST_FLAT_SLOT_NODE,
+                  WAITUI_AST_FLAT_SLOT_SYMBOL,
+                  WAITUI_AST_FLAT_SLOT_LIST}},
+        [AST_FLAT_EXPRESSION(SUPER_FUNCTION_CALL)] =
+                {2, {WAITUI_AST_FLAT_SLOT_SYMBOL, WAITUI_AST_FLAT_SLOT_LIST}},
+        [AST_FLAT_EXPRESSION(BINARY_EXPRESSION)] =
+                {2, {WAITUI_AST_FLAT_SLOT_NODE, WAITUI_AST_FLAT_SLOT_NODE}},
+        [AST_FLAT_EXPRESSION(UNARY_EXPRESSION)] =
+                {1, {WAITUI_AST_FLAT_SLOT_NODE}},
+        [AST_FLAT_EXPRESSION(IF_ELSE)] =
+                {3,
+                 {WAITUI_AST_FLAT_SLOT_NODE,
+                  WAITUI_AST_FLAT_SLOT_NODE,
+                  WAITUI_AST_FLAT_SLOT_NODE}},
+        [AST_FLAT_EXPRESSION(WHILE)] =
+                {2, {WAITUI_AST_FLAT_SLOT_NODE, WAITUI_AST_FLAT_SLOT_NODE}},
+        [AST_FLAT_EXPRESSION(LAZY_EXPRESSION)] =
+                {1, {WAITUI_AST_FLAT_SLOT_NODE}},
+};
+
+
+// -----------------------------------------------------------------------------
+//  Local functions
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Make room for more entries in an array of the flat AST.
+ * @param[in,out] array The array to grow
+ * @param[in,out] capacity The capacity of the array
+ * @param[in] length The number of entries in use
+ * @param[in] count The number of entries to make room for
+ * @param[in] size The size of an entry
+ * @retval true Ok
+ * @retval false Memory allocation failed or the array would be too large
+ */
+static bool waitui_ast_flat_reserve(void **array, uint32_t *capacity,
+                                    uint32_t length, uint32_t count,
+                                    size_t size) {
+    uint64_t newCapacity = *capacity ? *capacity
+                                     : WAITUI_AST_FLAT_INITIAL_CAPACITY;
+    void *newArray       = NULL;
+
+    if ((uint64_t) length + count <= *capacity) { return true; }
+    if ((uint64_t) length + count > UINT32_MAX) { return false; }
+
+    while (newCapacity < (uint64_t) length + count) { newCapacity *= 2; }
+    if (newCapacity > UINT32_MAX) { newCapacity = UINT32_MAX; }
+
+    newArray = realloc(*array, newCapacity * size);
+    if (!newArray) { return false; }
+
+    *array    = newArray;
+    *capacity = (uint32_t) newCapacity;
+    return true;
+}
+
+/**
+ * @brief Release the unused capacity of an array of the flat AST.
+ * @param[in,out] array The array to shrink
+ * @param[in,out] capacity The capacity of the array
+ * @param[in] length The number of entries in use
+ * @param[in] size The size of an entry
+ * @note A failed shrink keeps the array as it is.
+ */
+static void waitui_ast_flat_shrink(void **array, uint32_t *capacity,
+                                   uint32_t length, size_t size) {
+    void *newArray = NULL;
+
+    if (!length || length == *capacity) { return; }
+
+    newArray = realloc(*array, length * size);
+    if (!newArray) { return; }
+
+    *array    = newArray;
+    *capacity = length;
+}
+
+/**
+ * @brief Get the layout of the node.
+ * @param[in] this The flat AST of the node
+ * @param[in] node The id of the node
+ * @param[in] field The field to check
+ * @param[in] slot What the field has to hold
+ * @return The index of the slot of the field or 0 if the node has no such field
+ */
+static uint32_t waitui_ast_flat_getSlot(const waitui_ast_flat *this,
+                                        waitui_ast_flat_id node,
+                                        waitui_ast_field field,
+                                        waitui_ast_flat_slot slot) {
+    const waitui_ast_flat_layout *layout = NULL;
+
+    if (!this || node == WAITUI_AST_FLAT_NO_NODE || node >= this->nodeLength) {
+        return 0;
+    }
+
+    layout = &waitui_ast_flat_layouts[this->kinds[node]];
+    if ((unsigned int) field >= layout->fieldCount ||
+        layout->slots[field] != slot) {
+        return 0;
+    }
+
+    return this->fields[this->firstFields[node] + field];
+}
+
+/**
+ * @brief Make room for one more node in the node arrays of the flat AST.
+ * @param[in,out] this The flat AST to make room in
+ * @retval true Ok
+ * @retval false Memory allocation failed or there are too many nodes
+ * @note Every node array grows from the same capacity to the same capacity,
+ *       after a failure the capacity stays at the one all arrays have.
+ */
+static bool waitui_ast_flat_reserveNode(waitui_ast_flat *this) {
+    uint32_t capacities[5] = {this->nodeCapacity, this->nodeCapacity,
+                              this->nodeCapacity, this->nodeCapacity,
+                              this->nodeCapacity};
+
+    if (!waitui_ast_flat_reserve((void **) &this->kinds, &capacities[0],
+                                 this->nodeLength, 1, sizeof(*this->kinds)) ||
+        !waitui_ast_flat_reserve((void **) &this->values, &capacities[1],
+                                 this->nodeLength, 1, sizeof(*this->values)) ||
+        !waitui_ast_flat_reserve((void **) &this->flags, &capacities[2],
+                                 this->nodeLength, 1, sizeof(*this->flags)) ||
+        !waitui_ast_flat_reserve((void **) &this->firstFields, &capacities[3],
+                                 this->nodeLength, 1,
+                                 sizeof(*this->firstFields)) ||
+        !waitui_ast_flat_reserve((void **) &this->ends, &capacities[4],
+                                 this->nodeLength, 1, sizeof(*this->ends))) {
+        return false;
+    }
+
+    this->nodeCapacity = capacities[0];
+    return true;
+}
+
+/**
+ * @brief Add the node with its fields to the flat AST.
+ * @param[in,out] this The builder to add the node with
+ * @param[in] kind The kind byte of the node
+ * @return The id of the node or WAITUI_AST_FLAT_NO_NODE if the builder failed
+ */
+static waitui_ast_flat_id
+waitui_ast_flat_builder_newNode(waitui_ast_flat_builder *this, uint8_t kind) {
+    waitui_ast_flat *flat = this->flat;
+    uint32_t fieldCount   = waitui_ast_flat_layouts[kind].fieldCount;
+    waitui_ast_flat_id id = flat->nodeLength;
+
+    if (!waitui_ast_flat_reserveNode(flat) ||
+        !waitui_ast_flat_reserve((void **) &flat->fields, &flat->fieldCapacity,
+                                 flat->fieldLength, fieldCount,
+                                 sizeof(*flat->fields))) {
+        this->failed = true;
+        return WAITUI_AST_FLAT_NO_NODE;
+    }
+
+    flat->kinds[id]       = kind;
+    flat->values[id]      = 0;
+    flat->flags[id]       = 0;
+    flat->firstFields[id] = flat->fieldLength;
+    flat->ends[id]        = id + 1;
+    if (fieldCount) {
+        memset(flat->fields + flat->fieldLength, 0,
+               fieldCount * sizeof(*flat->fields));
+    }
+
+    flat->fieldLength += fieldCount;
+    flat->nodeLength++;
+
+    return id;
+}
+
+/**
+ * @brief Store the symbol in the field of the node.
+ * @param[in,out] this The builder of the node
+ * @param[in] id The id of the node
+ * @param[in] field The field to store the symbol in
+ * @param[in] value The symbol to store
+ * @note The flat AST holds a reference on the symbol.
+ */
+static void waitui_ast_flat_builder_setSymbol(waitui_ast_flat_builder *this,
+                                              waitui_ast_flat_id id,
+                                              waitui_ast_field field,
+                                              symbol *value) {
+    waitui_ast_flat *flat = this->flat;
+
+    if (!value || this->failed) { return; }
+
+    if (!waitui_ast_flat_reserve((void **) &flat->symbols,
+                                 &flat->symbolCapacity, flat->symbolLength, 1,
+                                 sizeof(*flat->symbols))) {
+        this->failed = true;
+        return;
+    }
+
+    symbol_increment_refcount(value);
+    flat->symbols[flat->symbolLength++]          = value;
+    flat->fields[flat->firstFields[id] + field] = flat->symbolLength;
+}
+
+/**
+ * @brief Reserve the range of the nodes of the list in the field of the node.
+ * @param[in,out] this The builder of the node
+ * @param[in] id The id of the node
+ * @param[in] field The field to reserve the list for
+ * @param[in] value The list of AST nodes
+ * @note The ids of the nodes are stored while the nodes are visited.
+ */
+static void waitui_ast_flat_builder_setList(waitui_ast_flat_builder *this,
+                                            waitui_ast_flat_id id,
+                                            waitui_ast_field field,
+                                            waitui_vector *value) {
+    waitui_ast_flat *flat = this->flat;
+    uint32_t length       = (uint32_t) waitui_vector_getLength(value);
+
+    if (!value || this->failed) { return; }
+
+    if (!waitui_ast_flat_reserve((void **) &flat->lists, &flat->listCapacity,
+                                 flat->listLength, 1, sizeof(*flat->lists)) ||
+        !waitui_ast_flat_reserve((void **) &flat->children,
+                                 &flat->childCapacity, flat->childLength,
+                                 length, sizeof(*flat->children))) {
+        this->failed = true;
+        return;
+    }
+
+    flat->lists[flat->listLength].first  = flat->childLength;
+    flat->lists[flat->listLength].length = length;
+    if (length) {
+        memset(flat->children + flat->childLength, 0,
+               length * sizeof(*flat->children));
+    }
+
+    flat->childLength += length;
+    flat->listLength++;
+    flat->fields[flat->firstFields[id] + field] = flat->listLength;
+}
+
+/**
+ * @brief Copy the string into the field of the node.
+ * @param[in,out] this The builder of the node
+ * @param[in] id The id of the node
+ * @param[in] field The field to store the string in
+ * @param[in] value The string to copy
+ */
+static void waitui_ast_flat_builder_setString(waitui_ast_flat_builder *this,
+                                              waitui_ast_flat_id id,
+                                              waitui_ast_field field,
+                                              const str *value) {
+    waitui_ast_flat *flat = this->flat;
+
+    if (!value || this->failed) { return; }
+
+    if (value->len >= UINT32_MAX ||
+        !waitui_ast_flat_reserve((void **) &flat->strings,
+                                 &flat->stringCapacity, flat->stringLength, 1,
+                                 sizeof(*flat->strings)) ||
+        !waitui_ast_flat_reserve((void **) &flat->characters,
+                                 &flat->characterCapacity,
+                                 flat->characterLength,
+                                 (uint32_t) value->len + 1,
+                                 sizeof(*flat->characters))) {
+        this->failed = true;
+        return;
+    }
+
+    memcpy(flat->characters + flat->characterLength, value->s, value->len);
+    flat->characters[flat->characterLength + value->len] = '\0';
+
+    flat->strings[flat->stringLength].first  = flat->characterLength;
+    flat->strings[flat->stringLength].length = (uint32_t) value->len;
+
+    flat->characterLength += (uint32_t) value->len + 1;
+    flat->stringLength++;
+    flat->fields[flat->firstFields[id] + field] = flat->stringLength;
+}
+
+/**
+ * @brief Add the definition node without its child nodes.
+ * @param[in,out] this The builder to add the node with
+ * @param[in] definition The definition to add
+ * @return The id of the node or WAITUI_AST_FLAT_NO_NODE if the builder failed
+ */
+static waitui_ast_flat_id
+waitui_ast_flat_builder_addDefinition(waitui_ast_flat_builder *this,
+                                      waitui_ast_definition *definition) {
+    waitui_ast_definition_type type =
+            waitui_ast_definition_getDefinitionType(definition);
+    waitui_ast_flat_id id = WAITUI_AST_FLAT_NO_NODE;
+
+    if (type == WAITUI_AST_DEFINITION_TYPE_UNDEFINED) {
+        waitui_log_trace("trying to flatten a definition with an undefined "
+                         "definition type");
+        this->failed = true;
+        return WAITUI_AST_FLAT_NO_NODE;
+    }
+
+    id = waitui_ast_flat_builder_newNode(this, (uint8_t) type);
+    if (id == WAITUI_AST_FLAT_NO_NODE) { return id; }
+
+    switch (type) {
+        case WAITUI_AST_DEFINITION_TYPE_PROGRAM:
+            AST_FLAT_SET_LIST(PROGRAM_NAMESPACES,
+                              waitui_ast_program_getNamespaces(
+                                      (waitui_ast_program *) definition));
+            break;
+        case WAITUI_AST_DEFINITION_TYPE_NAMESPACE: {
+            waitui_ast_namespace *namespace =
+                    (waitui_ast_namespace *) definition;
+
+            AST_FLAT_SET_SYMBOL(NAMESPACE_NAME,
+                                waitui_ast_namespace_getName(namespace));
+            AST_FLAT_SET_LIST(NAMESPACE_IMPORTS,
+                              waitui_ast_namespace_getImports(namespace));
+            AST_FLAT_SET_LIST(NAMESPACE_CLASSES,
+                              waitui_ast_namespace_getClasses(namespace));
+            break;
+        }
+        case WAITUI_AST_DEFINITION_TYPE_IMPORT: {
+            waitui_ast_import *import = (waitui_ast_import *) definition;
+
+            AST_FLAT_SET_SYMBOL(IMPORT_NAME, waitui_ast_import_getName(import));
+            AST_FLAT_SET_SYMBOL(IMPORT_ALIAS,
+                                waitui_ast_import_getAlias(import));
+            break;
+        }
+        case WAITUI_AST_DEFINITION_TYPE_CLASS: {
+            waitui_ast_class *class = (waitui_ast_class *) definition;
+
+            AST_FLAT_SET_SYMBOL(CLASS_NAME, waitui_ast_class_getName(class));
+            AST_FLAT_SET_LIST(CLASS_PARAMETERS,
+                              waitui_ast_class_getParameters(class));
+            AST_FLAT_SET_SYMBOL(CLASS_SUPER_CLASS,
+                                waitui_ast_class_getSuperClass(class));
+            AST_FLAT_SET_LIST(CLASS_SUPER_CLASS_ARGS,
+                              waitui_ast_class_getSuperClassArgs(class));
+            AST_FLAT_SET_LIST(CLASS_PROPERTIES,
+                              waitui_ast_class_getProperties(class));
+            AST_FLAT_SET_LIST(CLASS_FUNCTIONS,
+                              waitui_ast_class_getFunctions(class));
+            break;
+        }
+        case WAITUI_AST_DEFINITION_TYPE_FORMAL: {
+            waitui_ast_formal *formal = (waitui_ast_formal *) definition;
+
+            if (waitui_ast_formal_isLazy(formal)) {
+                this->flat->flags[id] = WAITUI_AST_FLAT_FLAG_LAZY;
+            }
+            AST_FLAT_SET_SYMBOL(FORMAL_IDENTIFIER,
+                                waitui_ast_formal_getIdentifier(formal));
+            AST_FLAT_SET_SYMBOL(FORMAL_TYPE, waitui_ast_formal_getType(formal));
+            break;
+        }
+        case WAITUI_AST_DEFINITION_TYPE_PROPERTY: {
+            waitui_ast_property *property = (waitui_ast_property *) definition;
+
+            AST_FLAT_SET_SYMBOL(PROPERTY_NAME,
+                                waitui_ast_property_getName(property));
+            AST_FLAT_SET_SYMBOL(PROPERTY_TYPE,
+                                waitui_ast_property_getType(property));
+            break;
+        }
+        case WAITUI_AST_DEFINITION_TYPE_FUNCTION: {
+            waitui_ast_function *function = (waitui_ast_function *) definition;
+            uint8_t flags                 = 0;
+
+            if (waitui_ast_function_isAbstract(function)) {
+                flags |= WAITUI_AST_FLAT_FLAG_ABSTRACT;
+            }
+            if (waitui_ast_function_isFinal(function)) {
+                flags |= WAITUI_AST_FLAT_FLAG_FINAL;
+            }
+            if (waitui_ast_function_isOverwrite(function)) {
+                flags |= WAITUI_AST_FLAT_FLAG_OVERWRITE;
+            }
+
+            this->flat->values[id] =
+                    (uint8_t) waitui_ast_function_getVisibility(function);
+            this->flat->flags[id] = flags;
+            AST_FLAT_SET_SYMBOL(FUNCTION_NAME,
+                                waitui_ast_function_getFunctionName(function));
+            AST_FLAT_SET_LIST(FUNCTION_PARAMETERS,
+                              waitui_ast_function_getParameters(function));
+            AST_FLAT_SET_SYMBOL(FUNCTION_RETURN_TYPE,
+                                waitui_ast_function_getReturnType(function));
+            break;
+        }
+        default:
+            break;
+    }
+
+    return id;
+}
+
+/**
+ * @brief Add the expression node without its child nodes.
+ * @param[in,out] this The builder to add the node with
+ * @param[in] expression The expression to add
+ * @return The id of the node or WAITUI_AST_FLAT_NO_NODE if the builder failed
+ */
+static waitui_ast_flat_id
+waitui_ast_flat_builder_addExpression(waitui_ast_flat_builder *this,
+                                      waitui_ast_expression *expression) {
+    waitui_ast_expression_type type =
+            waitui_ast_expression_getExpressionType(expression);
+    waitui_ast_flat_id id = WAITUI_AST_FLAT_NO_NODE;
+
+    if (type == WAITUI_AST_EXPRESSION_TYPE_UNDEFINED) {
+        waitui_log_trace("trying to flatten a expression with an undefined "
+                         "expression type");
+        this->failed = true;
+        return WAITUI_AST_FLAT_NO_NODE;
+    }
+
+    id = waitui_ast_flat_builder_newNode(
+            this, (uint8_t) (WAITUI_AST_FLAT_KIND_EXPRESSION | type));
+    if (id == WAITUI_AST_FLAT_NO_NODE) { return id; }
+
+    switch (type) {
+        case WAITUI_AST_EXPRESSION_TYPE_INTEGER_LITERAL:
+            AST_FLAT_SET_STRING(LITERAL_VALUE,
+                                waitui_ast_integer_literal_getValue(
+                                        (waitui_ast_integer_literal *)
+                                                expression));
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_DECIMAL_LITERAL:
+            AST_FLAT_SET_STRING(LITERAL_VALUE,
+                                waitui_ast_decimal_literal_getValue(
+                                        (waitui_ast_decimal_literal *)
+                                                expression));
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_STRING_LITERAL:
+            AST_FLAT_SET_STRING(LITERAL_VALUE,
+                                waitui_ast_string_literal_getValue(
+                                        (waitui_ast_string_literal *)
+                                                expression));
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_BOOLEAN_LITERAL:
+            this->flat->values[id] =
+                    (uint8_t) waitui_ast_boolean_literal_getValue(
+                            (waitui_ast_boolean_literal *) expression);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_ASSIGNMENT: {
+            waitui_ast_assignment *assignment =
+                    (waitui_ast_assignment *) expression;
+
+            this->flat->values[id] =
+                    (uint8_t) waitui_ast_assignment_getOperator(assignment);
+            AST_FLAT_SET_SYMBOL(
+                    ASSIGNMENT_IDENTIFIER,
+                    waitui_ast_assignment_getIdentifier(assignment));
+            break;
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_REFERENCE:
+            AST_FLAT_SET_SYMBOL(REFERENCE_VALUE,
+                                waitui_ast_reference_getValue(
+                                        (waitui_ast_reference *) expression));
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_CAST:
+            AST_FLAT_SET_SYMBOL(CAST_TYPE,
+                                waitui_ast_cast_getType(
+                                        (waitui_ast_cast *) expression));
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_INITIALIZATION: {
+            waitui_ast_initialization *initialization =
+                    (waitui_ast_initialization *) expression;
+
+            AST_FLAT_SET_SYMBOL(
+                    INITIALIZATION_IDENTIFIER,
+                    waitui_ast_initialization_getIdentifier(initialization));
+            AST_FLAT_SET_SYMBOL(
+                    INITIALIZATION_TYPE,
+                    waitui_ast_initialization_getType(initialization));
+            break;
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_LET:
+            AST_FLAT_SET_LIST(LET_INITIALIZATIONS,
+                              waitui_ast_let_getInitializations(
+                                      (waitui_ast_let *) expression));
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_BLOCK:
+            AST_FLAT_SET_LIST(BLOCK_EXPRESSIONS,
+                              waitui_ast_block_getExpressions(
+                                      (waitui_ast_block *) expression));
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_CONSTRUCTOR_CALL: {
+            waitui_ast_constructor_call *constructorCall =
+                    (waitui_ast_constructor_call *) expression;
+
+            AST_FLAT_SET_SYMBOL(
+                    CONSTRUCTOR_CALL_NAME,
+                    waitui_ast_constructor_call_getName(constructorCall));
+            AST_FLAT_SET_LIST(
+                    CONSTRUCTOR_CALL_ARGS,
+                    waitui_ast_constructor_call_getArgs(constructorCall));
+            break;
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_FUNCTION_CALL: {
+            waitui_ast_function_call *functionCall =
+                    (waitui_ast_function_call *) expression;
+
+            AST_FLAT_SET_SYMBOL(
+                    FUNCTION_CALL_FUNCTION_NAME,
+                    waitui_ast_function_call_getFunctionName(functionCall));
+            AST_FLAT_SET_LIST(FUNCTION_CALL_ARGS,
+                              waitui_ast_function_call_getArgs(functionCall));
+            break;
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_SUPER_FUNCTION_CALL: {
+            waitui_ast_super_function_call *superFunctionCall =
+                    (waitui_ast_super_function_call *) expression;
+
+            AST_FLAT_SET_SYMBOL(SUPER_FUNCTION_CALL_FUNCTION_NAME,
+                                waitui_ast_super_function_call_getFunctionName(
+                                        superFunctionCall));
+            AST_FLAT_SET_LIST(
+                    SUPER_FUNCTION_CALL_ARGS,
+                    waitui_ast_super_function_call_getArgs(superFunctionCall));
+            break;
+        }
+        case WAITUI_AST_EXPRESSION_TYPE_BINARY_EXPRESSION:
+            this->flat->values[id] =
+                    (uint8_t) waitui_ast_binary_expression_getOperator(
+                            (waitui_ast_binary_expression *) expression);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_UNARY_EXPRESSION:
+            this->flat->values[id] =
+                    (uint8_t) waitui_ast_unary_expression_getOperator(
+                            (waitui_ast_unary_expression *) expression);
+            break;
+        default:
+            break;
+    }
+
+    return id;
+}
+
+/**
+ * @brief Store the id of the visited node in the field of its parent.
+ * @param[in,out] this The builder of the nodes
+ * @param[in] visit The visited node
+ * @param[in] id The id of the visited node
+ */
+static void waitui_ast_flat_builder_link(waitui_ast_flat_builder *this,
+                                         const waitui_ast_visit *visit,
+                                         waitui_ast_flat_id id) {
+    waitui_ast_flat *flat         = this->flat;
+    waitui_ast_flat_frame *parent = NULL;
+    uint32_t slot                 = 0;
+
+    if (!visit->parent) { return; }
+
+    parent = &this->frames[visit->depth - 1];
+    slot   = flat->firstFields[parent->id] + visit->field;
+
+    if (waitui_ast_flat_layouts[flat->kinds[parent->id]].slots[visit->field] ==
+        WAITUI_AST_FLAT_SLOT_LIST) {
+        const waitui_ast_flat_range *list =
+                &flat->lists[flat->fields[slot] - 1];
+
+        flat->children[list->first + parent->cursors[visit->field]++] = id;
+    } else {
+        flat->fields[slot] = id;
+    }
+}
+
+/**
+ * @brief Add the visited node to the flat AST in pre order.
+ * @param[in] visit The visited node
+ * @param[in,out] args The builder
+ * @return Continue with the children or stop after a failure
+ */
+static waitui_ast_visit_action
+waitui_ast_flat_builder_preVisit(const waitui_ast_visit *visit, void *args) {
+    waitui_ast_flat_builder *this = (waitui_ast_flat_builder *) args;
+    waitui_ast_flat_id id         = WAITUI_AST_FLAT_NO_NODE;
+
+    if (visit->depth >= this->frameCapacity) {
+        unsigned long int capacity =
+                this->frameCapacity ? this->frameCapacity * 2
+                                    : WAITUI_AST_FLAT_INITIAL_CAPACITY;
+        waitui_ast_flat_frame *frames =
+                realloc(this->frames, capacity * sizeof(*frames));
+        if (!frames) {
+            this->failed = true;
+            return WAITUI_AST_VISIT_ACTION_STOP;
+        }
+        this->frames        = frames;
+        this->frameCapacity = capacity;
+    }
+
+    switch (waitui_ast_node_getNodeType(visit->node)) {
+        case WAITUI_AST_NODE_TYPE_DEFINITION:
+            id = waitui_ast_flat_builder_addDefinition(
+                    this, (waitui_ast_definition *) visit->node);
+            break;
+        case WAITUI_AST_NODE_TYPE_EXPRESSION:
+            id = waitui_ast_flat_builder_addExpression(
+                    this, (waitui_ast_expression *) visit->node);
+            break;
+        default:
+            waitui_log_trace(
+                    "trying to flatten a node with an undefined node type");
+            this->failed = true;
+            break;
+    }
+    if (this->failed) { return WAITUI_AST_VISIT_ACTION_STOP; }
+
+    waitui_ast_flat_builder_link(this, visit, id);
+
+    memset(&this->frames[visit->depth], 0, sizeof(*this->frames));
+    this->frames[visit->depth].id = id;
+
+    return WAITUI_AST_VISIT_ACTION_CONTINUE;
+}
+
+/**
+ * @brief Remember the end of the subtree of the visited node in post order.
+ * @param[in] visit The visited node
+ * @param[in,out] args The builder
+ * @return Always continue
+ */
+static waitui_ast_visit_action
+waitui_ast_flat_builder_postVisit(const waitui_ast_visit *visit, void *args) {
+    waitui_ast_flat_builder *this = (waitui_ast_flat_builder *) args;
+
+    this->flat->ends[this->frames[visit->depth].id] = this->flat->nodeLength;
+
+    return WAITUI_AST_VISIT_ACTION_CONTINUE;
+}
+
+/**
+ * @brief Release the unused capacity of all arrays of the flat AST.
+ * @param[in,out] this The flat AST to shrink
+ */
+static void waitui_ast_flat_shrinkToFit(waitui_ast_flat *this) {
+    uint32_t capacities[5] = {this->nodeCapacity, this->nodeCapacity,
+                              this->nodeCapacity, this->nodeCapacity,
+                              this->nodeCapacity};
+
+    waitui_ast_flat_shrink((void **) &this->kinds, &capacities[0],
+                           this->nodeLength, sizeof(*this->kinds));
+    waitui_ast_flat_shrink((void **) &this->values, &capacities[1],
+                           this->nodeLength, sizeof(*this->values));
+    waitui_ast_flat_shrink((void **) &this->flags, &capacities[2],
+                           this->nodeLength, sizeof(*this->flags));
+    waitui_ast_flat_shrink((void **) &this->firstFields, &capacities[3],
+                           this->nodeLength, sizeof(*this->firstFields));
+    waitui_ast_flat_shrink((void **) &this->ends, &capacities[4],
+                           this->nodeLength, sizeof(*this->ends));
+    if (capacities[0] == capacities[1] && capacities[0] == capacities[2] &&
+        capacities[0] == capacities[3] && capacities[0] == capacities[4]) {
+        this->nodeCapacity = capacities[0];
+    }
+
+    waitui_ast_flat_shrink((void **) &this->fields, &this->fieldCapacity,
+                           this->fieldLength, sizeof(*this->fields));
+    waitui_ast_flat_shrink((void **) &this->lists, &this->listCapacity,
+                           this->listLength, sizeof(*this->lists));
+    waitui_ast_flat_shrink((void **) &this->children, &this->childCapacity,
+                           this->childLength, sizeof(*this->children));
+    waitui_ast_flat_shrink((void **) &this->symbols, &this->symbolCapacity,
+                           this->symbolLength, sizeof(*this->symbols));
+    waitui_ast_flat_shrink((void **) &this->strings, &this->stringCapacity,
+                           this->stringLength, sizeof(*this->strings));
+    waitui_ast_flat_shrink((void **) &this->characters,
+                           &this->characterCapacity, this->characterLength,
+                           sizeof(*this->characters));
+}
+
+
+// -----------------------------------------------------------------------------
+//  Public functions
+// -----------------------------------------------------------------------------
+
+waitui_ast_flat *waitui_ast_flat_fromAst(waitui_ast *ast) {
+    waitui_ast_flat_builder builder = {0};
+    waitui_ast_visitor *visitor     = NULL;
+    waitui_ast_program *program     = NULL;
+    int visited                     = 0;
+
+    waitui_ast_visit_callbacks callbacks = {
+            .preVisitCallback  = waitui_ast_flat_builder_preVisit,
+            .postVisitCallback = waitui_ast_flat_builder_postVisit,
+    };
+
+    waitui_log_trace("creating new waitui_ast_flat");
+
+    program = waitui_ast_getProgram(ast);
+    if (!program) { return NULL; }
+
+    builder.flat = calloc(1, sizeof(*builder.flat));
+    if (!builder.flat) {
+        waitui_log_trace("creating new waitui_ast_flat failed");
+        return NULL;
+    }
+
+    visitor = waitui_ast_visitor_new();
+    if (!visitor) {
+        waitui_ast_flat_destroy(&builder.flat);
+        return NULL;
+    }
+
+    // the unused entry for no node
+    builder.flat->nodeLength = 0;
+    waitui_ast_flat_builder_newNode(&builder, 0);
+
+    if (!builder.failed) {
+        visited = waitui_ast_visitor_visit(
+                visitor, (waitui_ast_node *) program, &callbacks, &builder);
+    }
+
+    waitui_ast_visitor_destroy(&visitor);
+    free(builder.frames);
+
+    if (!visited || builder.failed) {
+        waitui_log_trace("creating new waitui_ast_flat failed");
+        waitui_ast_flat_destroy(&builder.flat);
+        return NULL;
+    }
+
+    builder.flat->ends[WAITUI_AST_FLAT_NO_NODE] = WAITUI_AST_FLAT_NO_NODE;
+    waitui_ast_flat_shrinkToFit(builder.flat);
+
+    waitui_log_trace("new waitui_ast_flat successful created");
+
+    return builder.flat;
+}
+
+void waitui_ast_flat_destroy(waitui_ast_flat **this) {
+    waitui_log_trace("destroying waitui_ast_flat");
+
+    if (!this || !(*this)) { return; }
+
+    for (uint32_t i = 0; i < (*this)->symbolLength; ++i) {
+        symbol_decrement_refcount(&(*this)->symbols[i]);
+    }
+
+    free((*this)->kinds);
+    free((*this)->values);
+    free((*this)->flags);
+    free((*this)->firstFields);
+    free((*this)->ends);
+    free((*this)->fields);
+    free((*this)->lists);
+    free((*this)->children);
+    free((*this)->symbols);
+    free((*this)->strings);
+    free((*this)->characters);
+    free(*this);
+    *this = NULL;
+
+    waitui_log_trace("waitui_ast_flat successful destroyed");
+}
+
+waitui_ast_flat_id waitui_ast_flat_getProgram(const waitui_ast_flat *this) {
+    if (!this || this->nodeLength < 2) { return WAITUI_AST_FLAT_NO_NODE; }
+    return 1;
+}
+
+unsigned long int waitui_ast_flat_getNodeCount(const waitui_ast_flat *this) {
+    if (!this || !this->nodeLength) { return 0; }
+    return this->nodeLength - 1;
+}
+
+size_t waitui_ast_flat_getMemorySize(const waitui_ast_flat *this) {
+    if (!this) { return 0; }
+
+    return sizeof(*this) +
+           this->nodeCapacity *
+                   (sizeof(*this->kinds) + sizeof(*this->values) +
+                    sizeof(*this->flags) + sizeof(*this->firstFields) +
+                    sizeof(*this->ends)) +
+           this->fieldCapacity * sizeof(*this->fields) +
+           this->listCapacity * sizeof(*this->lists) +
+           this->childCapacity * sizeof(*this->children) +
+           this->symbolCapacity * sizeof(*this->symbols) +
+           this->stringCapacity * sizeof(*this->strings) +
+           this->characterCapacity * sizeof(*this->characters);
+}
+
+uint8_t waitui_ast_flat_getKind(const waitui_ast_flat *this,
+                                waitui_ast_flat_id node) {
+    if (!this || node >= this->nodeLength) { return 0; }
+    return this->kinds[node];
+}
+
+waitui_ast_node_type waitui_ast_flat_getNodeType(const waitui_ast_flat *this,
+                                                 waitui_ast_flat_id node) {
+    uint8_t kind = waitui_ast_flat_getKind(this, node);
+
+    if (!kind) { return WAITUI_AST_NODE_TYPE_UNDEFINED; }
+    if (kind & WAITUI_AST_FLAT_KIND_EXPRESSION) {
+        return WAITUI_AST_NODE_TYPE_EXPRESSION;
+    }
+    return WAITUI_AST_NODE_TYPE_DEFINITION;
+}
+
+waitui_ast_definition_type
+waitui_ast_flat_getDefinitionType(const waitui_ast_flat *this,
+                                  waitui_ast_flat_id node) {
+    uint8_t kind = waitui_ast_flat_getKind(this, node);
+
+    if (kind & WAITUI_AST_FLAT_KIND_EXPRESSION) {
+        return WAITUI_AST_DEFINITION_TYPE_UNDEFINED;
+    }
+    return (waitui_ast_definition_type) kind;
+}
+
+waitui_ast_expression_type
+waitui_ast_flat_getExpressionType(const waitui_ast_flat *this,
+                                  waitui_ast_flat_id node) {
+    uint8_t kind = waitui_ast_flat_getKind(this, node);
+
+    if (!(kind & WAITUI_AST_FLAT_KIND_EXPRESSION)) {
+        return WAITUI_AST_EXPRESSION_TYPE_UNDEFINED;
+    }
+    return (waitui_ast_expression_type) (kind &
+                                         ~WAITUI_AST_FLAT_KIND_EXPRESSION);
+}
+
+unsigned int waitui_ast_flat_getValue(const waitui_ast_flat *this,
+                                      waitui_ast_flat_id node) {
+    if (!this || node >= this->nodeLength) { return 0; }
+    return this->values[node];
+}
+
+unsigned int waitui_ast_flat_getFlags(const waitui_ast_flat *this,
+                                      waitui_ast_flat_id node) {
+    if (!this || node >= this->nodeLength) { return 0; }
+    return this->flags[node];
+}
+
+waitui_ast_flat_id waitui_ast_flat_getEnd(const waitui_ast_flat *this,
+                                          waitui_ast_flat_id node) {
+    if (!this || node >= this->nodeLength) { return WAITUI_AST_FLAT_NO_NODE; }
+    return this->ends[node];
+}
+
+waitui_ast_flat_id waitui_ast_flat_getNode(const waitui_ast_flat *this,
+                                           waitui_ast_flat_id node,
+                                           waitui_ast_field field) {
+    return waitui_ast_flat_getSlot(this, node, field,
+                                   WAITUI_AST_FLAT_SLOT_NODE);
+}
+
+const waitui_ast_flat_id *
+waitui_ast_flat_getList(const waitui_ast_flat *this, waitui_ast_flat_id node,
+                        waitui_ast_field field, unsigned long int *length) {
+    uint32_t list = waitui_ast_flat_getSlot(this, node, field,
+                                            WAITUI_AST_FLAT_SLOT_LIST);
+
+    if (length) { *length = 0; }
+    if (!list || !this->lists[list - 1].length) { return NULL; }
+
+    if (length) { *length = this->lists[list - 1].length; }
+    return this->children + this->lists[list - 1].first;
+}
+
+symbol *waitui_ast_flat_getSymbol(const waitui_ast_flat *this,
+                                  waitui_ast_flat_id node,
+                                  waitui_ast_field field) {
+    uint32_t index = waitui_ast_flat_getSlot(this, node, field,
+                                             WAITUI_AST_FLAT_SLOT_SYMBOL);
+
+    if (!index) { return NULL; }
+    return this->symbols[index - 1];
+}
+
+int waitui_ast_flat_getString(const waitui_ast_flat *this,
+                              waitui_ast_flat_id node, waitui_ast_field field,
+                              str *value) {
+    uint32_t index = waitui_ast_flat_getSlot(this, node, field,
+                                             WAITUI_AST_FLAT_SLOT_STRING);
+
+    if (!index || !value) { return 0; }
+
+    value->s   = this->characters + this->strings[index - 1].first;
+    value->len = this->strings[index - 1].length;
+    return 1;
+}
@@ -0,0 +1,271 @@
+/**
+ * @file test_ast_flat.c
+ * @author rick
+ * @date 17.10.26
+ * @brief Test for the flat AST implementation
+ */
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <cmocka.h>
+
+#include "waitui/ast_flat.h"
+
+#include <waitui/log.h>
+#include <waitui/parser.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The maximal number of fields of a node.
+ */
+#define TEST_AST_FLAT_MAX_FIELDS 6
+
+typedef struct frame {
+    waitui_ast_flat_id id;
+    unsigned long int listLengths[TEST_AST_FLAT_MAX_FIELDS];
+} frame;
+
+typedef struct comparison {
+    const waitui_ast_flat *flat;
+    waitui_ast_flat_id nextId;
+    frame frames[64];
+} comparison;
+
+static const char source[] =
+        "namespace org.test\n"
+        "\n"
+        "import org.other\n"
+        "import org.more as More\n"
+        "\n"
+        "class Base(start: Int) {\n"
+        "    var count: Int = start\n"
+        "    var name = \"base\"\n"
+        "\n"
+        "    abstract public func area(): Int\n"
+        "    protected func scale(lazy factor: Int): Int = count * factor\n"
+        "}\n"
+        "\n"
+        "class Square(side: Int) extends Base(side) {\n"
+        "    final overwrite public func area(): Int = {\n"
+        "        let total: Int = 0, step = 1 in {\n"
+        "            while (total < side * side) total += step\n"
+        "            if (total == 0 || !true) -1 else total\n"
+        "        }\n"
+        "    }\n"
+        "    public func ratio(): Decimal = 1.5e3 / 0.25\n"
+        "    public func copy(): Square = new Square(super.area() as Int)\n"
+        "    public func print(): Null = native;\n"
+        "    private func nothing(): Null = this.scale(++count ~ null)\n"
+        "}\n";
+
+static waitui_ast *ast = NULL;
+
+/**
+ * Test that the next flat node has the kind of the visited node and is in
+ * the field of its parent.
+ */
+static waitui_ast_visit_action compare_pre_visit(const waitui_ast_visit *visit,
+                                                 void *args) {
+    comparison *this               = (comparison *) args;
+    waitui_ast_flat_id id          = this->nextId++;
+    frame *parent                  = NULL;
+    const waitui_ast_flat_id *list = NULL;
+    unsigned long int length       = 0;
+
+    assert_true(visit->depth < sizeof(this->frames) / sizeof(*this->frames));
+    this->frames[visit->depth] = (frame){.id = id};
+
+    assert_int_equal(waitui_ast_flat_getNodeType(this->flat, id),
+                     waitui_ast_node_getNodeType(visit->node));
+    if (waitui_ast_node_getNodeType(visit->node) ==
+        WAITUI_AST_NODE_TYPE_DEFINITION) {
+        assert_int_equal(waitui_ast_flat_getDefinitionType(this->flat, id),
+                         waitui_ast_definition_getDefinitionType(
+                                 (waitui_ast_definition *) visit->node));
+    } else {
+        assert_int_equal(waitui_ast_flat_getExpressionType(this->flat, id),
+                         waitui_ast_expression_getExpressionType(
+                                 (waitui_ast_expression *) visit->node));
+    }
+
+    if (!visit->parent) { return WAITUI_AST_VISIT_ACTION_CONTINUE; }
+
+    parent = &this->frames[visit->depth - 1];
+    list   = waitui_ast_flat_getList(this->flat, parent->id, visit->field,
+                                     &length);
+    if (list) {
+        assert_true(visit->index < length);
+        assert_int_equal(list[visit->index], id);
+        parent->listLengths[visit->field]++;
+    } else {
+        assert_int_equal(
+                waitui_ast_flat_getNode(this->flat, parent->id, visit->field),
+                id);
+    }
+
+    return WAITUI_AST_VISIT_ACTION_CONTINUE;
+}
+
+/**
+ * Test that the subtree of the flat node ends after the last descendant of
+ * the visited node and that its lists are as long as the visited ones.
+ */
+static waitui_ast_visit_action compare_post_visit(const waitui_ast_visit *visit,
+                                                  void *args) {
+    comparison *this = (comparison *) args;
+    frame *current   = &this->frames[visit->depth];
+
+    assert_int_equal(waitui_ast_flat_getEnd(this->flat, current->id),
+                     this->nextId);
+
+    for (int field = 0; field < TEST_AST_FLAT_MAX_FIELDS; ++field) {
+        unsigned long int length = 0;
+
+        waitui_ast_flat_getList(this->flat, current->id,
+                                (waitui_ast_field) field, &length);
+        assert_int_equal(length, current->listLengths[field]);
+    }
+
+    return WAITUI_AST_VISIT_ACTION_CONTINUE;
+}
+
+static int setup(void **state) {
+    str sourceFileName = STR_STATIC_INIT("test_ast_flat.wai");
+    str sourceText     = {.s = (char *) source, .len = sizeof(source) - 1};
+    str workDirectory  = STR_STATIC_INIT("/tmp");
+    parser *parser     = NULL;
+
+    (void) state; /* unused */
+
+    waitui_log_setQuiet(true);
+
+    parser = parser_new_from_source(sourceFileName, sourceText, workDirectory,
+                                    0);
+    if (!parser) { return -1; }
+    if (parser_parse(parser)) { ast = parser_get_ast(parser); }
+    parser_destroy(&parser);
+
+    return ast ? 0 : -1;
+}
+
+static int teardown(void **state) {
+    (void) state; /* unused */
+
+    ast_destroy(&ast);
+
+    return 0;
+}
+
+static void test_ast_flat_matches_ast(void **state) {
+    (void) state; /* unused */
+
+    waitui_ast_flat *flat       = waitui_ast_flat_fromAst(ast);
+    waitui_ast_visitor *visitor = waitui_ast_visitor_new();
+    comparison compare          = {0};
+
+    waitui_ast_visit_callbacks callbacks = {
+            .preVisitCallback  = compare_pre_visit,
+            .postVisitCallback = compare_post_visit,
+    };
+
+    assert_non_null(flat);
+    assert_non_null(visitor);
+
+    compare.flat   = flat;
+    compare.nextId = waitui_ast_flat_getProgram(flat);
+    assert_int_equal(compare.nextId, 1);
+
+    assert_true(waitui_ast_visitor_visit(
+            visitor, (waitui_ast_node *) waitui_ast_getProgram(ast), &callbacks,
+            &compare));
+
+    // every node of the AST is a node of the flat AST and the other way
+    assert_int_equal(waitui_ast_flat_getNodeCount(flat), compare.nextId - 1);
+    assert_int_equal(waitui_ast_flat_getEnd(flat, 1), compare.nextId);
+    assert_true(waitui_ast_flat_getMemorySize(flat) > 0);
+
+    waitui_ast_visitor_destroy(&visitor);
+    waitui_ast_flat_destroy(&flat);
+    assert_null(flat);
+}
+
+static void test_ast_flat_fields(void **state) {
+    (void) state; /* unused */
+
+    waitui_ast_flat *flat          = waitui_ast_flat_fromAst(ast);
+    const waitui_ast_flat_id *list = NULL;
+    waitui_ast_flat_id namespace   = WAITUI_AST_FLAT_NO_NODE;
+    waitui_ast_flat_id square      = WAITUI_AST_FLAT_NO_NODE;
+    waitui_ast_flat_id property    = WAITUI_AST_FLAT_NO_NODE;
+    waitui_ast_flat_id function    = WAITUI_AST_FLAT_NO_NODE;
+    unsigned long int length       = 0;
+    symbol *name                   = NULL;
+    str value                      = STR_NULL_INIT;
+
+    assert_non_null(flat);
+
+    list = waitui_ast_flat_getList(flat, waitui_ast_flat_getProgram(flat),
+                                   WAITUI_AST_FIELD_PROGRAM_NAMESPACES,
+                                   &length);
+    assert_int_equal(length, 1);
+    namespace = list[0];
+
+    list = waitui_ast_flat_getList(flat, namespace,
+                                   WAITUI_AST_FIELD_NAMESPACE_CLASSES, &length);
+    assert_int_equal(length, 2);
+    square = list[1];
+
+    // skipping the subtree of the first class lands on the second one
+    assert_int_equal(waitui_ast_flat_getEnd(flat, list[0]), square);
+
+    name = waitui_ast_flat_getSymbol(flat, square, WAITUI_AST_FIELD_CLASS_NAME);
+    assert_non_null(name);
+    assert_int_equal(name->identifier.len, 6);
+    assert_memory_equal(name->identifier.s, "Square", 6);
+
+    list = waitui_ast_flat_getList(flat, square,
+                                   WAITUI_AST_FIELD_CLASS_FUNCTIONS, &length);
+    assert_int_equal(length, 5);
+    function = list[0];
+    assert_int_equal(waitui_ast_flat_getFlags(flat, function),
+                     WAITUI_AST_FLAT_FLAG_FINAL |
+                             WAITUI_AST_FLAT_FLAG_OVERWRITE);
+
+    // the string of the literal of the property name of the class Base
+    list = waitui_ast_flat_getList(flat, namespace,
+                                   WAITUI_AST_FIELD_NAMESPACE_CLASSES, &length);
+    list = waitui_ast_flat_getList(flat, list[0],
+                                   WAITUI_AST_FIELD_CLASS_PROPERTIES, &length);
+    assert_int_equal(length, 2);
+    property = waitui_ast_flat_getNode(flat, list[1],
+                                       WAITUI_AST_FIELD_PROPERTY_VALUE);
+    assert_true(waitui_ast_flat_getString(flat, property,
+                                          WAITUI_AST_FIELD_LITERAL_VALUE,
+                                          &value));
+    assert_int_equal(value.len, 4);
+    assert_memory_equal(value.s, "base", 4);
+
+    // fields of the wrong kind hold nothing
+    assert_null(waitui_ast_flat_getSymbol(flat, square,
+                                          WAITUI_AST_FIELD_CLASS_FUNCTIONS));
+    assert_int_equal(waitui_ast_flat_getNode(flat, square,
+                                             WAITUI_AST_FIELD_CLASS_NAME),
+                     WAITUI_AST_FLAT_NO_NODE);
+
+    waitui_ast_flat_destroy(&flat);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test(test_ast_flat_matches_ast),
+            cmocka_unit_test(test_ast_flat_fields),
+    };
+
+    return cmocka_run_group_tests(tests, setup, teardown);
+}
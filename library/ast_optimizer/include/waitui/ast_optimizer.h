@@ -0,0 +1,34 @@
+/**
+ * @file ast_optimizer.h
+ * @author rick
+ * @date 17.10.26
+ * @brief File for the AST optimizer implementation
+ */
+
+#ifndef WAITUI_AST_OPTIMIZER_H
+#define WAITUI_AST_OPTIMIZER_H
+
+#include <waitui/ast.h>
+
+
+// -----------------------------------------------------------------------------
+//  Public functions
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Fold the constant expressions of the AST in place.
+ * @param[in,out] ast The AST to optimize
+ * @param[out] foldCount The number of expressions replaced, may be NULL
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed, the AST is still valid but only partly
+ *           optimized
+ * @note Operators on literals are evaluated with the semantics of the VM, an
+ *       operation that would fail at runtime, like a division by zero, is
+ *       kept. Conditionals with a constant condition are replaced by the
+ *       branch taken and loops that never run by null. The modules the AST
+ *       imports are not changed, they may be shared with other ASTs.
+ */
+extern int waitui_ast_optimizer_fold(waitui_ast *ast,
+                                     unsigned long int *foldCount);
+
+#endif//WAITUI_AST_OPTIMIZER_H
@@ -0,0 +1,771 @@
+/**
+ * @file ast_optimizer.c
+ * @author rick
+ * @date 17.10.26
+ * @brief File for the AST optimizer implementation
+ */
+
+#include "waitui/ast_optimizer.h"
+
+#include <waitui/log.h>
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+// -----------------------------------------------------------------------------
+//  Local defines
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The size of the text of a folded number.
+ */
+#define WAITUI_AST_OPTIMIZER_NUMBER_SIZE 32
+
+/**
+ * @brief Return whether the constant is an integer or a decimal.
+ */
+#define WAITUI_AST_OPTIMIZER_IS_NUMBER(constant)                               \
+    ((constant)->type == WAITUI_AST_OPTIMIZER_CONSTANT_INTEGER ||              \
+     (constant)->type == WAITUI_AST_OPTIMIZER_CONSTANT_DECIMAL)
+
+/**
+ * @brief Return the number constant as a decimal.
+ */
+#define WAITUI_AST_OPTIMIZER_TO_DECIMAL(constant)                              \
+    ((constant)->type == WAITUI_AST_OPTIMIZER_CONSTANT_INTEGER                 \
+             ? (double) (constant)->as.integer                                 \
+             : (constant)->as.decimal)
+
+
+// -----------------------------------------------------------------------------
+//  Local types
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The types possible for the value of an expression.
+ * @note NONE marks an expression whose value is only known at runtime.
+ */
+typedef enum waitui_ast_optimizer_constant_type {
+    WAITUI_AST_OPTIMIZER_CONSTANT_NONE,
+    WAITUI_AST_OPTIMIZER_CONSTANT_NULL,
+    WAITUI_AST_OPTIMIZER_CONSTANT_BOOLEAN,
+    WAITUI_AST_OPTIMIZER_CONSTANT_INTEGER,
+    WAITUI_AST_OPTIMIZER_CONSTANT_DECIMAL,
+    WAITUI_AST_OPTIMIZER_CONSTANT_STRING,
+} waitui_ast_optimizer_constant_type;
+
+/**
+ * @brief Type for the value of a visited node.
+ * @note Strings hold the text of the literal with its escapes.
+ */
+typedef struct waitui_ast_optimizer_constant {
+    waitui_ast_optimizer_constant_type type;
+    unsigned long int depth;
+    union {
+        bool boolean;
+        int64_t integer;
+        double decimal;
+        str string;
+    } as;
+} waitui_ast_optimizer_constant;
+
+/**
+ * @brief Type for folding the AST.
+ * @note The AST is visited in post order and every node leaves its value on
+ *       the stack of constants, so a literal is parsed once and an operator
+ *       finds the values of its operands right below the top of the stack.
+ */
+typedef struct waitui_ast_optimizer {
+    waitui_arena *arena;
+    waitui_ast_optimizer_constant *constants;
+    unsigned long int length;
+    unsigned long int capacity;
+    unsigned long int foldCount;
+    bool failed;
+} waitui_ast_optimizer;
+
+
+// -----------------------------------------------------------------------------
+//  Local functions
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Push the value of a visited node onto the stack of constants.
+ * @param[in,out] this The AST optimizer
+ * @param[in] constant The value to push
+ * @param[in] depth The depth of the visited node
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ */
+static int waitui_ast_optimizer_push(waitui_ast_optimizer *this,
+                                     const waitui_ast_optimizer_constant *value,
+                                     unsigned long int depth) {
+    if (this->length == this->capacity) {
+        unsigned long int capacity = this->capacity ? this->capacity * 2 : 64;
+        waitui_ast_optimizer_constant *constants =
+                realloc(this->constants, capacity * sizeof(*constants));
+        if (!constants) { return 0; }
+
+        this->constants = constants;
+        this->capacity  = capacity;
+    }
+
+    this->constants[this->length]       = *value;
+    this->constants[this->length].depth = depth;
+    this->length++;
+
+    return 1;
+}
+
+/**
+ * @brief Parse the digits of an integer literal.
+ * @param[in] text The digits of the literal
+ * @param[out] value The value of the literal
+ * @note A literal that does not fit into 64 bits is left for the compiler to
+ *       report and has no value.
+ */
+static void waitui_ast_optimizer_parseInteger(const str *text,
+                                              waitui_ast_optimizer_constant
+                                                      *value) {
+    uint64_t integer = 0;
+
+    for (unsigned long int i = 0; i < text->len; ++i) {
+        unsigned int digit = (unsigned int) (text->s[i] - '0');
+
+        if (digit > 9 || integer > ((uint64_t) INT64_MAX - digit) / 10) {
+            return;
+        }
+        integer = integer * 10 + digit;
+    }
+
+    value->type       = WAITUI_AST_OPTIMIZER_CONSTANT_INTEGER;
+    value->as.integer = (int64_t) integer;
+}
+
+/**
+ * @brief Parse the text of a decimal literal.
+ * @param[in,out] this The AST optimizer
+ * @param[in] text The text of the literal
+ * @param[out] value The value of the literal
+ */
+static void waitui_ast_optimizer_parseDecimal(waitui_ast_optimizer *this,
+                                              const str *text,
+                                              waitui_ast_optimizer_constant
+                                                      *value) {
+    str copy = STR_NULL_INIT;
+
+    STR_COPY_WITH_NUL(&copy, text);
+    if (!copy.s) {
+        this->failed = true;
+        return;
+    }
+
+    value->type       = WAITUI_AST_OPTIMIZER_CONSTANT_DECIMAL;
+    value->as.decimal = strtod(copy.s, NULL);
+
+    STR_FREE(&copy);
+}
+
+/**
+ * @brief Copy the text into the arena of the AST.
+ * @param[in,out] this The AST optimizer
+ * @param[in] text The text to copy
+ * @param[in] length The length of the text
+ * @param[out] copy The copied text
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ */
+static int waitui_ast_optimizer_copyText(waitui_ast_optimizer *this,
+                                         const char *text, size_t length,
+                                         str *copy) {
+    copy->s = waitui_arena_alloc(this->arena, length + 1);
+    if (!copy->s) {
+        this->failed = true;
+        return 0;
+    }
+
+    memcpy(copy->s, text, length);
+    copy->s[length] = '\0';
+    copy->len       = length;
+
+    return 1;
+}
+
+/**
+ * @brief Create the literal for the non negative number.
+ * @param[in,out] this The AST optimizer
+ * @param[in] value The number, either an integer or a decimal
+ * @return The literal or NULL if memory allocation failed
+ * @note A decimal is written with the fewest digits that read back as the
+ *       same value, in the form the lexer accepts for decimal literals.
+ */
+static waitui_ast_expression *
+waitui_ast_optimizer_newNumber(waitui_ast_optimizer *this,
+                               const waitui_ast_optimizer_constant *value) {
+    char buffer[WAITUI_AST_OPTIMIZER_NUMBER_SIZE];
+    char *exponent = NULL;
+    str text       = STR_NULL_INIT;
+
+    if (value->type == WAITUI_AST_OPTIMIZER_CONSTANT_INTEGER) {
+        snprintf(buffer, sizeof(buffer), "%" PRId64, value->as.integer);
+        if (!waitui_ast_optimizer_copyText(this, buffer, strlen(buffer),
+                                           &text)) {
+            return NULL;
+        }
+        return (waitui_ast_expression *) waitui_ast_integer_literal_new(
+                this->arena, text);
+    }
+
+    for (int precision = 1; precision <= 17; ++precision) {
+        snprintf(buffer, sizeof(buffer), "%.*g", precision, value->as.decimal);
+        if (strtod(buffer, NULL) == value->as.decimal) { break; }
+    }
+
+    exponent = strchr(buffer, 'e');
+    if (!exponent) {
+        if (!strchr(buffer, '.')) { strcat(buffer, ".0"); }
+    } else {
+        char *digits = exponent + 2;
+        char *zeros  = digits;
+
+        while (*zeros == '0') { zeros++; }
+        memmove(digits, zeros, strlen(zeros) + 1);
+    }
+
+    if (!waitui_ast_optimizer_copyText(this, buffer, strlen(buffer), &text)) {
+        return NULL;
+    }
+    return (waitui_ast_expression *) waitui_ast_decimal_literal_new(this->arena,
+                                                                    text);
+}
+
+/**
+ * @brief Create the expression for the value.
+ * @param[in,out] this The AST optimizer
+ * @param[in] value The value to create the expression for
+ * @return The expression or NULL if the value can not be written as literal
+ *         or memory allocation failed
+ * @note Literals never have a sign, a negative number is the negation of the
+ *       literal of its magnitude.
+ */
+static waitui_ast_expression *
+waitui_ast_optimizer_newExpression(waitui_ast_optimizer *this,
+                                   const waitui_ast_optimizer_constant *value) {
+    waitui_ast_optimizer_constant magnitude = *value;
+    waitui_ast_expression *expression       = NULL;
+    bool negative                           = false;
+
+    switch (value->type) {
+        case WAITUI_AST_OPTIMIZER_CONSTANT_NULL:
+            expression = (waitui_ast_expression *) waitui_ast_null_literal_new(
+                    this->arena);
+            break;
+        case WAITUI_AST_OPTIMIZER_CONSTANT_BOOLEAN:
+            expression =
+                    (waitui_ast_expression *) waitui_ast_boolean_literal_new(
+                            this->arena, value->as.boolean);
+            break;
+        case WAITUI_AST_OPTIMIZER_CONSTANT_STRING:
+            expression =
+                    (waitui_ast_expression *) waitui_ast_string_literal_new(
+                            this->arena, value->as.string);
+            break;
+        case WAITUI_AST_OPTIMIZER_CONSTANT_INTEGER:
+            if (value->as.integer == INT64_MIN) { return NULL; }
+            negative = value->as.integer < 0;
+            if (negative) { magnitude.as.integer = -value->as.integer; }
+            expression = waitui_ast_optimizer_newNumber(this, &magnitude);
+            break;
+        case WAITUI_AST_OPTIMIZER_CONSTANT_DECIMAL:
+            if (!isfinite(value->as.decimal)) { return NULL; }
+            negative = signbit(value->as.decimal);
+            if (negative) { magnitude.as.decimal = -value->as.decimal; }
+            expression = waitui_ast_optimizer_newNumber(this, &magnitude);
+            break;
+        default:
+            return NULL;
+    }
+
+    if (expression && negative) {
+        expression = (waitui_ast_expression *) waitui_ast_unary_expression_new(
+                this->arena, WAITUI_AST_UNARY_OPERATOR_MINUS, expression);
+    }
+    if (!expression) { this->failed = true; }
+
+    return expression;
+}
+
+/**
+ * @brief Compare the constants like the VM does.
+ * @param[in] left The left operand
+ * @param[in] right The right operand
+ * @param[out] equal Whether the operands are equal
+ * @retval 1 Ok
+ * @retval 0 The comparison is only known at runtime
+ * @note Strings are compared by their text, so only strings without escapes.
+ */
+static int
+waitui_ast_optimizer_equals(const waitui_ast_optimizer_constant *left,
+                            const waitui_ast_optimizer_constant *right,
+                            bool *equal) {
+    if (left->type != right->type) {
+        *equal = WAITUI_AST_OPTIMIZER_IS_NUMBER(left) &&
+                 WAITUI_AST_OPTIMIZER_IS_NUMBER(right) &&
+                 WAITUI_AST_OPTIMIZER_TO_DECIMAL(left) ==
+                         WAITUI_AST_OPTIMIZER_TO_DECIMAL(right);
+        return 1;
+    }
+
+    switch (left->type) {
+        case WAITUI_AST_OPTIMIZER_CONSTANT_NULL:
+            *equal = true;
+            return 1;
+        case WAITUI_AST_OPTIMIZER_CONSTANT_BOOLEAN:
+            *equal = left->as.boolean == right->as.boolean;
+            return 1;
+        case WAITUI_AST_OPTIMIZER_CONSTANT_INTEGER:
+            *equal = left->as.integer == right->as.integer;
+            return 1;
+        case WAITUI_AST_OPTIMIZER_CONSTANT_DECIMAL:
+            *equal = left->as.decimal == right->as.decimal;
+            return 1;
+        case WAITUI_AST_OPTIMIZER_CONSTANT_STRING:
+            if (memchr(left->as.string.s, '\\', left->as.string.len) ||
+                memchr(right->as.string.s, '\\', right->as.string.len)) {
+                return 0;
+            }
+            *equal = left->as.string.len == right->as.string.len &&
+                     memcmp(left->as.string.s, right->as.string.s,
+                            left->as.string.len) == 0;
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief Evaluate the binary operator on the constants like the VM does.
+ * @param[in,out] this The AST optimizer
+ * @param[in] binaryOperator The binary operator
+ * @param[in] left The left operand
+ * @param[in] right The right operand
+ * @param[out] result The value of the operation
+ * @retval 1 Ok
+ * @retval 0 The operation fails at runtime or memory allocation failed
+ * @note Integers wrap around, an integer and a decimal give a decimal.
+ */
+static int waitui_ast_optimizer_evaluateBinary(
+        waitui_ast_optimizer *this, waitui_ast_binary_operator binaryOperator,
+        const waitui_ast_optimizer_constant *left,
+        const waitui_ast_optimizer_constant *right,
+        waitui_ast_optimizer_constant *result) {
+    bool integers = left->type == WAITUI_AST_OPTIMIZER_CONSTANT_INTEGER &&
+                    right->type == WAITUI_AST_OPTIMIZER_CONSTANT_INTEGER;
+    bool booleans = left->type == WAITUI_AST_OPTIMIZER_CONSTANT_BOOLEAN &&
+                    right->type == WAITUI_AST_OPTIMIZER_CONSTANT_BOOLEAN;
+    bool numbers  = WAITUI_AST_OPTIMIZER_IS_NUMBER(left) &&
+                   WAITUI_AST_OPTIMIZER_IS_NUMBER(right);
+    uint64_t a = (uint64_t) left->as.integer;
+    uint64_t b = (uint64_t) right->as.integer;
+    double x   = numbers ? WAITUI_AST_OPTIMIZER_TO_DECIMAL(left) : 0;
+    double y   = numbers ? WAITUI_AST_OPTIMIZER_TO_DECIMAL(right) : 0;
+    bool equal = false;
+
+    result->type = integers ? WAITUI_AST_OPTIMIZER_CONSTANT_INTEGER
+                            : WAITUI_AST_OPTIMIZER_CONSTANT_DECIMAL;
+
+    switch (binaryOperator) {
+        case WAITUI_AST_BINARY_OPERATOR_PLUS:
+            if (integers) {
+                result->as.integer = (int64_t) (a + b);
+            } else {
+                result->as.decimal = x + y;
+            }
+            return numbers;
+        case WAITUI_AST_BINARY_OPERATOR_MINUS:
+            if (integers) {
+                result->as.integer = (int64_t) (a - b);
+            } else {
+                result->as.decimal = x - y;
+            }
+            return numbers;
+        case WAITUI_AST_BINARY_OPERATOR_TIMES:
+            if (integers) {
+                result->as.integer = (int64_t) (a * b);
+            } else {
+                result->as.decimal = x * y;
+            }
+            return numbers;
+        case WAITUI_AST_BINARY_OPERATOR_DIV:
+            if (!integers) {
+                result->as.decimal = x / y;
+                return numbers;
+            }
+            if (b == 0) { return 0; }
+            result->as.integer = right->as.integer == -1
+                                         ? (int64_t) (0 - a)
+                                         : left->as.integer / right->as.integer;
+            return 1;
+        case WAITUI_AST_BINARY_OPERATOR_MODULO:
+            if (!integers || b == 0) { return 0; }
+            result->as.integer = right->as.integer == -1
+                                         ? 0
+                                         : left->as.integer % right->as.integer;
+            return 1;
+        case WAITUI_AST_BINARY_OPERATOR_AND:
+            if (integers) {
+                result->as.integer = (int64_t) (a & b);
+            } else {
+                result->type       = WAITUI_AST_OPTIMIZER_CONSTANT_BOOLEAN;
+                result->as.boolean = left->as.boolean && right->as.boolean;
+            }
+            return integers || booleans;
+        case WAITUI_AST_BINARY_OPERATOR_CARET:
+            if (integers) {
+                result->as.integer = (int64_t) (a ^ b);
+            } else {
+                result->type       = WAITUI_AST_OPTIMIZER_CONSTANT_BOOLEAN;
+                result->as.boolean = left->as.boolean != right->as.boolean;
+            }
+            return integers || booleans;
+        case WAITUI_AST_BINARY_OPERATOR_PIPE:
+            if (integers) {
+                result->as.integer = (int64_t) (a | b);
+            } else {
+                result->type       = WAITUI_AST_OPTIMIZER_CONSTANT_BOOLEAN;
+                result->as.boolean = left->as.boolean || right->as.boolean;
+            }
+            return integers || booleans;
+        case WAITUI_AST_BINARY_OPERATOR_TILDE: {
+            const str *first  = &left->as.string;
+            const str *second = &right->as.string;
+            char *text        = NULL;
+
+            if (left->type != WAITUI_AST_OPTIMIZER_CONSTANT_STRING ||
+                right->type != WAITUI_AST_OPTIMIZER_CONSTANT_STRING) {
+                return 0;
+            }
+
+            text = waitui_arena_alloc(this->arena,
+                                      first->len + second->len + 1);
+            if (!text) {
+                this->failed = true;
+                return 0;
+            }
+            memcpy(text, first->s, first->len);
+            memcpy(text + first->len, second->s, second->len);
+            text[first->len + second->len] = '\0';
+
+            result->type          = WAITUI_AST_OPTIMIZER_CONSTANT_STRING;
+            result->as.string.s   = text;
+            result->as.string.len = first->len + second->len;
+            return 1;
+        }
+        case WAITUI_AST_BINARY_OPERATOR_LESS:
+            result->type       = WAITUI_AST_OPTIMIZER_CONSTANT_BOOLEAN;
+            result->as.boolean = integers ? left->as.integer <
+                                                    right->as.integer
+                                          : x < y;
+            return numbers;
+        case WAITUI_AST_BINARY_OPERATOR_LESS_EQUAL:
+            result->type       = WAITUI_AST_OPTIMIZER_CONSTANT_BOOLEAN;
+            result->as.boolean = integers ? left->as.integer <=
+                                                    right->as.integer
+                                          : x <= y;
+            return numbers;
+        case WAITUI_AST_BINARY_OPERATOR_GREATER:
+            result->type       = WAITUI_AST_OPTIMIZER_CONSTANT_BOOLEAN;
+            result->as.boolean = integers ? left->as.integer >
+                                                    right->as.integer
+                                          : x > y;
+            return numbers;
+        case WAITUI_AST_BINARY_OPERATOR_GREATER_EQUAL:
+            result->type       = WAITUI_AST_OPTIMIZER_CONSTANT_BOOLEAN;
+            result->as.boolean = integers ? left->as.integer >=
+                                                    right->as.integer
+                                          : x >= y;
+            return numbers;
+        case WAITUI_AST_BINARY_OPERATOR_EQUAL:
+        case WAITUI_AST_BINARY_OPERATOR_NOT_EQUAL:
+            if (!waitui_ast_optimizer_equals(left, right, &equal)) { return 0; }
+            result->type       = WAITUI_AST_OPTIMIZER_CONSTANT_BOOLEAN;
+            result->as.boolean =
+                    binaryOperator == WAITUI_AST_BINARY_OPERATOR_EQUAL ? equal
+                                                                       : !equal;
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief Fold the binary expression, && and || with a constant left operand
+ *        are replaced by the operand that decides their value.
+ */
+static waitui_ast_expression *waitui_ast_optimizer_foldBinaryExpression(
+        waitui_ast_optimizer *this, waitui_ast_binary_expression *expression,
+        const waitui_ast_optimizer_constant *operands,
+        unsigned long int operandCount, waitui_ast_optimizer_constant *value) {
+    waitui_ast_binary_operator binaryOperator =
+            waitui_ast_binary_expression_getOperator(expression);
+
+    if (operandCount != 2) { return NULL; }
+
+    if (binaryOperator == WAITUI_AST_BINARY_OPERATOR_DOUBLE_AND ||
+        binaryOperator == WAITUI_AST_BINARY_OPERATOR_DOUBLE_PIPE) {
+        if (operands[0].type != WAITUI_AST_OPTIMIZER_CONSTANT_BOOLEAN) {
+            return NULL;
+        }
+        if (operands[0].as.boolean ==
+            (binaryOperator == WAITUI_AST_BINARY_OPERATOR_DOUBLE_AND)) {
+            *value = operands[1];
+            return waitui_ast_binary_expression_getRight(expression);
+        }
+        *value = operands[0];
+        return waitui_ast_binary_expression_getLeft(expression);
+    }
+
+    if (!waitui_ast_optimizer_evaluateBinary(this, binaryOperator, &operands[0],
+                                             &operands[1], value)) {
+        value->type = WAITUI_AST_OPTIMIZER_CONSTANT_NONE;
+        return NULL;
+    }
+
+    return waitui_ast_optimizer_newExpression(this, value);
+}
+
+/**
+ * @brief Fold the unary expression, the negation of a literal is kept as the
+ *        literal of a negative number.
+ */
+static waitui_ast_expression *waitui_ast_optimizer_foldUnaryExpression(
+        waitui_ast_optimizer *this, waitui_ast_unary_expression *expression,
+        const waitui_ast_optimizer_constant *operands,
+        unsigned long int operandCount, waitui_ast_optimizer_constant *value) {
+    waitui_ast_expression *operand =
+            waitui_ast_unary_expression_getExpression(expression);
+    waitui_ast_expression_type operandType =
+            waitui_ast_expression_getExpressionType(operand);
+
+    if (operandCount != 1) { return NULL; }
+
+    switch (waitui_ast_unary_expression_getOperator(expression)) {
+        case WAITUI_AST_UNARY_OPERATOR_MINUS:
+            if (operands[0].type == WAITUI_AST_OPTIMIZER_CONSTANT_INTEGER) {
+                value->type = WAITUI_AST_OPTIMIZER_CONSTANT_INTEGER;
+                value->as.integer =
+                        (int64_t) (0 - (uint64_t) operands[0].as.integer);
+            } else if (operands[0].type ==
+                       WAITUI_AST_OPTIMIZER_CONSTANT_DECIMAL) {
+                value->type       = WAITUI_AST_OPTIMIZER_CONSTANT_DECIMAL;
+                value->as.decimal = -operands[0].as.decimal;
+            } else {
+                return NULL;
+            }
+            if (operandType == WAITUI_AST_EXPRESSION_TYPE_INTEGER_LITERAL ||
+                operandType == WAITUI_AST_EXPRESSION_TYPE_DECIMAL_LITERAL) {
+                return NULL;
+            }
+            return waitui_ast_optimizer_newExpression(this, value);
+        case WAITUI_AST_UNARY_OPERATOR_NOT:
+            if (operands[0].type != WAITUI_AST_OPTIMIZER_CONSTANT_BOOLEAN) {
+                return NULL;
+            }
+            value->type       = WAITUI_AST_OPTIMIZER_CONSTANT_BOOLEAN;
+            value->as.boolean = !operands[0].as.boolean;
+            return waitui_ast_optimizer_newExpression(this, value);
+        default:
+            return NULL;
+    }
+}
+
+/**
+ * @brief Replace the if else with a constant condition by the branch taken.
+ */
+static waitui_ast_expression *waitui_ast_optimizer_foldIfElse(
+        waitui_ast_optimizer *this, waitui_ast_if_else *ifElse,
+        const waitui_ast_optimizer_constant *operands,
+        unsigned long int operandCount, waitui_ast_optimizer_constant *value) {
+    waitui_ast_expression *elseBranch =
+            waitui_ast_if_else_getElseBranch(ifElse);
+
+    if (operandCount < 2 ||
+        operands[0].type != WAITUI_AST_OPTIMIZER_CONSTANT_BOOLEAN) {
+        return NULL;
+    }
+
+    if (operands[0].as.boolean) {
+        *value = operands[1];
+        return waitui_ast_if_else_getThenBranch(ifElse);
+    }
+    if (elseBranch && operandCount == 3) {
+        *value = operands[2];
+        return elseBranch;
+    }
+
+    value->type = WAITUI_AST_OPTIMIZER_CONSTANT_NULL;
+    return waitui_ast_optimizer_newExpression(this, value);
+}
+
+/**
+ * @brief Replace the while with a condition that is false by null.
+ */
+static waitui_ast_expression *
+waitui_ast_optimizer_foldWhile(waitui_ast_optimizer *this,
+                               const waitui_ast_optimizer_constant *operands,
+                               unsigned long int operandCount,
+                               waitui_ast_optimizer_constant *value) {
+    if (operandCount < 1 ||
+        operands[0].type != WAITUI_AST_OPTIMIZER_CONSTANT_BOOLEAN ||
+        operands[0].as.boolean) {
+        return NULL;
+    }
+
+    value->type = WAITUI_AST_OPTIMIZER_CONSTANT_NULL;
+    return waitui_ast_optimizer_newExpression(this, value);
+}
+
+/**
+ * @brief Fold the expression whose children were folded already.
+ * @param[in,out] this The AST optimizer
+ * @param[in] expression The expression to fold
+ * @param[in] operands The values of the children of the expression
+ * @param[in] operandCount The number of children of the expression
+ * @param[out] value The value of the expression
+ * @return The expression to replace the expression with or NULL to keep it
+ */
+static waitui_ast_expression *waitui_ast_optimizer_foldExpression(
+        waitui_ast_optimizer *this, waitui_ast_expression *expression,
+        const waitui_ast_optimizer_constant *operands,
+        unsigned long int operandCount, waitui_ast_optimizer_constant *value) {
+    switch (waitui_ast_expression_getExpressionType(expression)) {
+        case WAITUI_AST_EXPRESSION_TYPE_NULL_LITERAL:
+            value->type = WAITUI_AST_OPTIMIZER_CONSTANT_NULL;
+            return NULL;
+        case WAITUI_AST_EXPRESSION_TYPE_BOOLEAN_LITERAL:
+            value->type       = WAITUI_AST_OPTIMIZER_CONSTANT_BOOLEAN;
+            value->as.boolean = waitui_ast_boolean_literal_getValue(
+                    (waitui_ast_boolean_literal *) expression);
+            return NULL;
+        case WAITUI_AST_EXPRESSION_TYPE_INTEGER_LITERAL:
+            waitui_ast_optimizer_parseInteger(
+                    waitui_ast_integer_literal_getValue(
+                            (waitui_ast_integer_literal *) expression),
+                    value);
+            return NULL;
+        case WAITUI_AST_EXPRESSION_TYPE_DECIMAL_LITERAL:
+            waitui_ast_optimizer_parseDecimal(
+                    this,
+                    waitui_ast_decimal_literal_getValue(
+                            (waitui_ast_decimal_literal *) expression),
+                    value);
+            return NULL;
+        case WAITUI_AST_EXPRESSION_TYPE_STRING_LITERAL:
+            value->type      = WAITUI_AST_OPTIMIZER_CONSTANT_STRING;
+            value->as.string = *waitui_ast_string_literal_getValue(
+                    (waitui_ast_string_literal *) expression);
+            return NULL;
+        case WAITUI_AST_EXPRESSION_TYPE_BINARY_EXPRESSION:
+            return waitui_ast_optimizer_foldBinaryExpression(
+                    this, (waitui_ast_binary_expression *) expression, operands,
+                    operandCount, value);
+        case WAITUI_AST_EXPRESSION_TYPE_UNARY_EXPRESSION:
+            return waitui_ast_optimizer_foldUnaryExpression(
+                    this, (waitui_ast_unary_expression *) expression, operands,
+                    operandCount, value);
+        case WAITUI_AST_EXPRESSION_TYPE_IF_ELSE:
+            return waitui_ast_optimizer_foldIfElse(
+                    this, (waitui_ast_if_else *) expression, operands,
+                    operandCount, value);
+        case WAITUI_AST_EXPRESSION_TYPE_WHILE:
+            return waitui_ast_optimizer_foldWhile(this, operands, operandCount,
+                                                  value);
+        default:
+            return NULL;
+    }
+}
+
+/**
+ * @brief Fold the visited node and put it in place in its parent.
+ * @param[in] visit The visited node
+ * @param[in,out] args The AST optimizer
+ * @return What the AST visitor should do next
+ * @note The children of the node are the constants on top of the stack that
+ *       are deeper than the node.
+ */
+static waitui_ast_visit_action
+waitui_ast_optimizer_postVisit(const waitui_ast_visit *visit, void *args) {
+    waitui_ast_optimizer *this          = args;
+    waitui_ast_optimizer_constant value = {0};
+    waitui_ast_expression *replacement  = NULL;
+    unsigned long int first             = this->length;
+
+    while (first > 0 && this->constants[first - 1].depth > visit->depth) {
+        first--;
+    }
+
+    if (waitui_ast_node_getNodeType(visit->node) ==
+        WAITUI_AST_NODE_TYPE_EXPRESSION) {
+        replacement = waitui_ast_optimizer_foldExpression(
+                this, (waitui_ast_expression *) visit->node,
+                &this->constants[first], this->length - first, &value);
+    }
+    this->length = first;
+
+    if (this->failed) { return WAITUI_AST_VISIT_ACTION_STOP; }
+
+    if (replacement && visit->parent &&
+        waitui_ast_node_replaceChild(visit->parent, visit->field, visit->index,
+                                     replacement)) {
+        this->foldCount++;
+    }
+
+    if (!waitui_ast_optimizer_push(this, &value, visit->depth)) {
+        this->failed = true;
+        return WAITUI_AST_VISIT_ACTION_STOP;
+    }
+
+    return WAITUI_AST_VISIT_ACTION_CONTINUE;
+}
+
+
+// -----------------------------------------------------------------------------
+//  Public functions
+// -----------------------------------------------------------------------------
+
+int waitui_ast_optimizer_fold(waitui_ast *ast, unsigned long int *foldCount) {
+    waitui_ast_visit_callbacks callbacks = {
+            .preVisitCallback  = NULL,
+            .postVisitCallback = waitui_ast_optimizer_postVisit,
+    };
+    waitui_ast_optimizer optimizer = {0};
+    waitui_ast_visitor *visitor    = NULL;
+    int result                     = 0;
+
+    if (foldCount) { *foldCount = 0; }
+    if (!ast) { return 0; }
+
+    waitui_log_trace("start folding the waitui_ast");
+
+    optimizer.arena = waitui_ast_getArena(ast);
+
+    visitor = waitui_ast_visitor_new();
+    if (!visitor) { return 0; }
+
+    result = waitui_ast_visitor_visit(
+                     visitor, (waitui_ast_node *) waitui_ast_getProgram(ast),
+                     &callbacks, &optimizer) &&
+             !optimizer.failed;
+
+    waitui_ast_visitor_destroy(&visitor);
+    free(optimizer.constants);
+
+    if (foldCount) { *foldCount = optimizer.foldCount; }
+
+    waitui_log_trace("end folding the waitui_ast");
+
+    return result;
+}
@@ -0,0 +1,286 @@
+/**
+ * @file test_ast_optimizer.c
+ * @author rick
+ * @date 17.10.26
+ * @brief Test for the AST optimizer implementation
+ */
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <cmocka.h>
+
+#include "waitui/ast_optimizer.h"
+
+#include <waitui/log.h>
+#include <waitui/parser.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+static const char source[] =
+        "namespace org.test\n"
+        "\n"
+        "class Main {\n"
+        "    func plus(): Int = 9223372036854775807 + 2\n"
+        "    func times(): Int = 9223372036854775807 * 3\n"
+        "    func minus(): Int = 1 - 3\n"
+        "    func min(): Int = -9223372036854775807 - 1\n"
+        "    func minPlus(): Int = 9223372036854775807 + 1\n"
+        "    func div(): Int = -7 / 2\n"
+        "    func mod(): Int = -7 % 2\n"
+        "    func divMinusOne(): Int = 7 / -1\n"
+        "    func modMinusOne(): Int = 7 % -1\n"
+        "    func divZero(): Int = 1 / 0\n"
+        "    func modZero(): Int = 1 % 0\n"
+        "    func modDecimal(): Decimal = 1.5 % 2\n"
+        "    func decimal(): Decimal = 1.5 * 2\n"
+        "    func decimalDiv(): Decimal = 1 / 4.0\n"
+        "    func infinity(): Decimal = 1.0 / 0.0\n"
+        "    func overflow(): Decimal = 1e308 * 10\n"
+        "    func nan(): Decimal = 0.0 / 0.0\n"
+        "    func concat(): String = \"ab\" ~ \"cd\" ~ \"\"\n"
+        "    func concatInt(): String = \"ab\" ~ 1\n"
+        "    func branch(): Int = if (1 < 2) 3 else 4\n"
+        "}\n";
+
+static const char countSource[] =
+        "namespace org.test\n"
+        "\n"
+        "class Count {\n"
+        "    func first(): Int = 1 + 2 * 3\n"
+        "    func second(): Boolean = !(1 == 2)\n"
+        "    func third(): Int = 1 / 0\n"
+        "}\n";
+
+static waitui_ast *ast = NULL;
+
+static unsigned long int foldCount = 0;
+
+static waitui_ast *parse_source(const char *text) {
+    str sourceFileName = STR_STATIC_INIT("test_ast_optimizer.wai");
+    str sourceText     = {.s = (char *) text, .len = strlen(text)};
+    str workDirectory  = STR_STATIC_INIT("/tmp");
+    waitui_ast *result = NULL;
+    parser *parser     = NULL;
+
+    parser = parser_new_from_source(sourceFileName, sourceText, workDirectory,
+                                    0);
+    if (parser && parser_parse(parser)) { result = parser_get_ast(parser); }
+    parser_destroy(&parser);
+
+    return result;
+}
+
+/**
+ * Write the expression like the source would look, every binary expression
+ * in parentheses and unknown expressions as a question mark.
+ */
+static void write_expression(waitui_ast_expression *expression, FILE *file) {
+    static const char *const operators[] = {
+            [WAITUI_AST_BINARY_OPERATOR_PLUS]   = "+",
+            [WAITUI_AST_BINARY_OPERATOR_MINUS]  = "-",
+            [WAITUI_AST_BINARY_OPERATOR_TIMES]  = "*",
+            [WAITUI_AST_BINARY_OPERATOR_DIV]    = "/",
+            [WAITUI_AST_BINARY_OPERATOR_MODULO] = "%",
+            [WAITUI_AST_BINARY_OPERATOR_TILDE]  = "~",
+    };
+    waitui_ast_binary_expression *binary = NULL;
+    waitui_ast_unary_expression *unary   = NULL;
+    waitui_ast_binary_operator operator;
+    str *value = NULL;
+
+    switch (waitui_ast_expression_getExpressionType(expression)) {
+        case WAITUI_AST_EXPRESSION_TYPE_INTEGER_LITERAL:
+            value = waitui_ast_integer_literal_getValue(
+                    (waitui_ast_integer_literal *) expression);
+            fprintf(file, "%.*s", STR_FMT(value));
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_DECIMAL_LITERAL:
+            value = waitui_ast_decimal_literal_getValue(
+                    (waitui_ast_decimal_literal *) expression);
+            fprintf(file, "%.*s", STR_FMT(value));
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_STRING_LITERAL:
+            value = waitui_ast_string_literal_getValue(
+                    (waitui_ast_string_literal *) expression);
+            fprintf(file, "\"%.*s\"", STR_FMT(value));
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_BOOLEAN_LITERAL:
+            fputs(waitui_ast_boolean_literal_getValue(
+                          (waitui_ast_boolean_literal *) expression)
+                          ? "true"
+                          : "false",
+                  file);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_UNARY_EXPRESSION:
+            unary = (waitui_ast_unary_expression *) expression;
+            if (waitui_ast_unary_expression_getOperator(unary) !=
+                WAITUI_AST_UNARY_OPERATOR_MINUS) {
+                fputc('?', file);
+                break;
+            }
+            fputc('-', file);
+            write_expression(waitui_ast_unary_expression_getExpression(unary),
+                             file);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_BINARY_EXPRESSION:
+            binary   = (waitui_ast_binary_expression *) expression;
+            operator = waitui_ast_binary_expression_getOperator(binary);
+            fputc('(', file);
+            write_expression(waitui_ast_binary_expression_getLeft(binary),
+                             file);
+            fprintf(file, " %s ",
+                    operator < sizeof(operators) / sizeof(operators[0]) &&
+                                    operators[operator]
+                            ? operators[operator]
+                            : "?");
+            write_expression(waitui_ast_binary_expression_getRight(binary),
+                             file);
+            fputc(')', file);
+            break;
+        default:
+            fputc('?', file);
+            break;
+    }
+}
+
+/**
+ * Test that the body of the function of the class Main is written as the
+ * expected source.
+ */
+static void assert_body(const char *functionName, const char *expected) {
+    waitui_ast_namespace *namespace = waitui_ast_namespace_vector_get(
+            waitui_ast_program_getNamespaces(waitui_ast_getProgram(ast)), 0);
+    waitui_ast_class *class = waitui_ast_class_vector_get(
+            waitui_ast_namespace_getClasses(namespace), 0);
+    char *actual = NULL;
+    size_t size  = 0;
+    FILE *file   = NULL;
+
+    WAITUI_VECTOR_FOREACH(waitui_ast_function, function,
+                          waitui_ast_class_getFunctions(class)) {
+        str *name = &waitui_ast_function_getFunctionName(function)->identifier;
+
+        if (name->len != strlen(functionName) ||
+            memcmp(name->s, functionName, name->len) != 0) {
+            continue;
+        }
+
+        file = open_memstream(&actual, &size);
+        assert_non_null(file);
+        write_expression(waitui_ast_function_getBody(function), file);
+        fclose(file);
+
+        assert_string_equal(actual, expected);
+        free(actual);
+        return;
+    }
+
+    fail_msg("unknown function '%s'", functionName);
+}
+
+static int setup(void **state) {
+    (void) state; /* unused */
+
+    waitui_log_setQuiet(true);
+
+    ast = parse_source(source);
+    if (!ast) { return -1; }
+
+    return waitui_ast_optimizer_fold(ast, &foldCount) ? 0 : -1;
+}
+
+static int teardown(void **state) {
+    (void) state; /* unused */
+
+    ast_destroy(&ast);
+
+    return 0;
+}
+
+static void test_ast_optimizer_integer_wraparound(void **state) {
+    (void) state; /* unused */
+
+    assert_body("plus", "-9223372036854775807");
+    assert_body("times", "9223372036854775805");
+    assert_body("minus", "-2");
+}
+
+static void test_ast_optimizer_integer_min(void **state) {
+    (void) state; /* unused */
+
+    // the smallest integer has no literal of its magnitude
+    assert_body("min", "(-9223372036854775807 - 1)");
+    assert_body("minPlus", "(9223372036854775807 + 1)");
+}
+
+static void test_ast_optimizer_division(void **state) {
+    (void) state; /* unused */
+
+    assert_body("div", "-3");
+    assert_body("mod", "-1");
+    assert_body("divMinusOne", "-7");
+    assert_body("modMinusOne", "0");
+
+    // these fail at runtime and have to fail there
+    assert_body("divZero", "(1 / 0)");
+    assert_body("modZero", "(1 % 0)");
+    assert_body("modDecimal", "(1.5 % 2)");
+}
+
+static void test_ast_optimizer_decimal(void **state) {
+    (void) state; /* unused */
+
+    assert_body("decimal", "3.0");
+    assert_body("decimalDiv", "0.25");
+
+    // infinity and nan have no literal
+    assert_body("infinity", "(1.0 / 0.0)");
+    assert_body("overflow", "(1e308 * 10)");
+    assert_body("nan", "(0.0 / 0.0)");
+}
+
+static void test_ast_optimizer_concat(void **state) {
+    (void) state; /* unused */
+
+    assert_body("concat", "\"abcd\"");
+    assert_body("concatInt", "(\"ab\" ~ 1)");
+}
+
+static void test_ast_optimizer_fold_count(void **state) {
+    (void) state; /* unused */
+
+    waitui_ast *countAst    = parse_source(countSource);
+    unsigned long int count = 0;
+
+    assert_true(foldCount > 0);
+    assert_body("branch", "3");
+
+    assert_non_null(countAst);
+    assert_true(waitui_ast_optimizer_fold(countAst, &count));
+    assert_int_equal(count, 4);
+
+    // a folded AST has nothing left to fold
+    assert_true(waitui_ast_optimizer_fold(countAst, &count));
+    assert_int_equal(count, 0);
+    assert_true(waitui_ast_optimizer_fold(countAst, NULL));
+
+    ast_destroy(&countAst);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test(test_ast_optimizer_integer_wraparound),
+            cmocka_unit_test(test_ast_optimizer_integer_min),
+            cmocka_unit_test(test_ast_optimizer_division),
+            cmocka_unit_test(test_ast_optimizer_decimal),
+            cmocka_unit_test(test_ast_optimizer_concat),
+            cmocka_unit_test(test_ast_optimizer_fold_count),
+    };
+
+    return cmocka_run_group_tests(tests, setup, teardown);
+}
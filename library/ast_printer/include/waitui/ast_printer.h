@@ -9,6 +9,7 @@
 #define WAITUI_AST_PRINTER_H
 
 #include <waitui/ast.h>
+#include <waitui/threadpool.h>
 
 
 // -----------------------------------------------------------------------------
@@ -22,4 +23,20 @@
  */
 extern void waitui_ast_printer_generateGraph(const waitui_ast *ast, FILE *file);
 
+/**
+ * @brief Generate a dot graph description of the AST into the file, printing
+ *        the classes concurrently on the Thread pool.
+ * @param[in] ast The AST to visualize as graph
+ * @param[in,out] file The file to write the dot graph description
+ * @param[in,out] threadpool The Thread pool to print the classes on
+ * @note The graph nodes of every class are counted first, so each class gets
+ *       its range of node ids up front and the output is the same as the one
+ *       of waitui_ast_printer_generateGraph. With less than two classes or
+ *       threads the graph is printed on the calling thread.
+ * @warning This must not be called from a job of the same Thread pool.
+ */
+extern void
+waitui_ast_printer_generateGraphParallel(const waitui_ast *ast, FILE *file,
+                                         waitui_threadpool *threadpool);
+
 #endif//WAITUI_AST_PRINTER_H
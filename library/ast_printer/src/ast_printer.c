@@ -7,38 +7,91 @@
 
 #include "waitui/ast_printer.h"
 
-#include <stdarg.h>
 #include <waitui/log.h>
+#include <waitui/output.h>
 
 
 // -----------------------------------------------------------------------------
 //  Local defines
 // -----------------------------------------------------------------------------
 
+#define WAITUI_AST_PRINTER_APPEND(printer, literal)                            \
+    waitui_output_append((printer)->output, (literal), sizeof((literal)) - 1)
+
+#define WAITUI_AST_PRINTER_NODE_BEGIN " [label=<"
+#define WAITUI_AST_PRINTER_NODE_END ">];\n"
 #define WAITUI_AST_PRINTER_TABLE_BEGIN                                         \
     "<TABLE BORDER=\"0\" CELLBORDER=\"1\" CELLSPACING=\"0\">"
 #define WAITUI_AST_PRINTER_TABLE_END "</TABLE>"
-#define WAITUI_AST_PRINTER_TITLE_ROW                                           \
-    "<TR><TD COLSPAN=\"2\"><B>%.*s</B></TD></TR>"
-#define WAITUI_AST_PRINTER_KEY_STR_VALUE                                       \
-    "<TR><TD ALIGN=\"LEFT\">%s:</TD><TD ALIGN=\"LEFT\">%.*s</TD></TR>"
-#define WAITUI_AST_PRINTER_KEY_STRING_VALUE                                    \
-    "<TR><TD ALIGN=\"LEFT\">%s:</TD><TD ALIGN=\"LEFT\">%s</TD></TR>"
-#define WAITUI_AST_PRINTER_KEY_PORT                                            \
-    "<TR><TD ALIGN=\"LEFT\" COLSPAN=\"2\" PORT=\"%s%llu\">%s</TD></TR>"
+#define WAITUI_AST_PRINTER_TITLE_BEGIN "<TR><TD COLSPAN=\"2\"><B>"
+#define WAITUI_AST_PRINTER_TITLE_END "</B></TD></TR>"
+#define WAITUI_AST_PRINTER_KEY_BEGIN "<TR><TD ALIGN=\"LEFT\">"
+#define WAITUI_AST_PRINTER_KEY_END ":</TD><TD ALIGN=\"LEFT\">"
+#define WAITUI_AST_PRINTER_VALUE_END "</TD></TR>"
+#define WAITUI_AST_PRINTER_PORT_BEGIN                                          \
+    "<TR><TD ALIGN=\"LEFT\" COLSPAN=\"2\" PORT=\""
+#define WAITUI_AST_PRINTER_PORT_END "\">"
+#define WAITUI_AST_PRINTER_LENGTH(array) (sizeof(array) / sizeof(*(array)))
 
 
 // -----------------------------------------------------------------------------
 //  Local types
 // -----------------------------------------------------------------------------
 
+/**
+ * @brief Type for the functions printing an AST node of one kind.
+ */
+typedef void (*waitui_ast_printer_print_function)(waitui_ast_node *node,
+                                                  void *args);
+
+/**
+ * @brief Type for a printed graph node the edges to its children start at.
+ */
+typedef struct waitui_ast_printer_parent {
+    waitui_ast_node *node;
+    str title;
+    unsigned long long nodeCount;
+    const char *const *ports;
+} waitui_ast_printer_parent;
+
+/**
+ * @brief Type for a class printed concurrently into its own output.
+ * @note The output holds the graph nodes of the class, the trailer what the
+ *       AST printer prints after the class until the next class.
+ */
+typedef struct waitui_ast_printer_job {
+    waitui_ast_class *class;
+    unsigned long long nodeCount;
+    unsigned long long firstNode;
+    waitui_output *output;
+    waitui_output *trailer;
+    bool failed;
+} waitui_ast_printer_job;
+
+/**
+ * @brief Type for the classes of the AST printed concurrently.
+ */
+typedef struct waitui_ast_printer_jobs {
+    waitui_ast_printer_job *jobs;
+    unsigned long int length;
+} waitui_ast_printer_jobs;
+
 /**
  * @brief Type for the printing the AST.
+ * @note The AST is walked by the AST visitor, the printed graph nodes the
+ *       visitor is below are kept as a stack of parents. With jobs the classes
+ *       are not printed, only their range of node counts is reserved.
  */
 typedef struct waitui_ast_printer {
-    FILE *outputFile;
-    waitui_ast_callbacks *callbacks;
+    waitui_output *output;
     unsigned long long nodeCount;
+    const waitui_ast_visit *visit;
+    waitui_ast_printer_parent *parents;
+    unsigned long int parentsLength;
+    unsigned long int parentsSize;
+    waitui_ast_printer_jobs *jobs;
+    unsigned long int jobIndex;
+    bool failed;
 } waitui_ast_printer;
 
 
@@ -187,151 +240,220 @@ static inline str waitui_ast_printer_symbolToStr(const symbol *input) {
 }
 
 /**
- * @brief Print a graph node.
+ * @brief Print the name of a graph node.
  * @param[in] printer The printer to print to
  * @param[in] node The node str to use
  * @param[in] nodeCount The node count to use
- * @param[in] format The format to use
- * @param[in] ... The arguments to fill in the format
  */
 static inline void
-waitui_ast_printer_printGraphNode(waitui_ast_printer *printer, str *node,
-                                  unsigned long long nodeCount, char *format,
-                                  ...) {
-    va_list args;
+waitui_ast_printer_printGraphNodeName(waitui_ast_printer *printer,
+                                      const str *node,
+                                      unsigned long long nodeCount) {
+    waitui_output_appendStr(printer->output, node);
+    waitui_output_appendU64(printer->output, nodeCount);
+}
 
-    fprintf(printer->outputFile, "\t%.*s%llu [label=<", STR_FMT(node),
-            nodeCount);
+/**
+ * @brief Print the beginning of a graph node up to its title row.
+ * @param[in] printer The printer to print to
+ * @param[in] node The node str to use
+ * @param[in] nodeCount The node count to use
+ */
+static void waitui_ast_printer_beginGraphNode(waitui_ast_printer *printer,
+                                              const str *node,
+                                              unsigned long long nodeCount) {
+    WAITUI_AST_PRINTER_APPEND(printer, "\t");
+    waitui_ast_printer_printGraphNodeName(printer, node, nodeCount);
+    WAITUI_AST_PRINTER_APPEND(printer, WAITUI_AST_PRINTER_NODE_BEGIN);
+    WAITUI_AST_PRINTER_APPEND(printer, WAITUI_AST_PRINTER_TABLE_BEGIN
+                                               WAITUI_AST_PRINTER_TITLE_BEGIN);
+    waitui_output_appendHtmlEscaped(printer->output, node);
+    WAITUI_AST_PRINTER_APPEND(printer, WAITUI_AST_PRINTER_TITLE_END);
+}
 
-    va_start(args, format);
-    vfprintf(printer->outputFile, format, args);
-    va_end(args);
+/**
+ * @brief Print a row of the graph node with the key and str value.
+ * @param[in] printer The printer to print to
+ * @param[in] key The key of the row
+ * @param[in] value The value of the row, it gets HTML escaped
+ */
+static void waitui_ast_printer_printStrRow(waitui_ast_printer *printer,
+                                           const char *key, const str *value) {
+    WAITUI_AST_PRINTER_APPEND(printer, WAITUI_AST_PRINTER_KEY_BEGIN);
+    waitui_output_appendString(printer->output, key);
+    WAITUI_AST_PRINTER_APPEND(printer, WAITUI_AST_PRINTER_KEY_END);
+    waitui_output_appendHtmlEscaped(printer->output, value);
+    WAITUI_AST_PRINTER_APPEND(printer, WAITUI_AST_PRINTER_VALUE_END);
+}
 
-    fprintf(printer->outputFile, ">];\n");
+/**
+ * @brief Print a row of the graph node with the key and string value.
+ * @param[in] printer The printer to print to
+ * @param[in] key The key of the row
+ * @param[in] value The value of the row, it must not need HTML escaping
+ */
+static void waitui_ast_printer_printStringRow(waitui_ast_printer *printer,
+                                              const char *key,
+                                              const char *value) {
+    WAITUI_AST_PRINTER_APPEND(printer, WAITUI_AST_PRINTER_KEY_BEGIN);
+    waitui_output_appendString(printer->output, key);
+    WAITUI_AST_PRINTER_APPEND(printer, WAITUI_AST_PRINTER_KEY_END);
+    waitui_output_appendString(printer->output, value);
+    WAITUI_AST_PRINTER_APPEND(printer, WAITUI_AST_PRINTER_VALUE_END);
 }
 
 /**
- * @brief Print a graph node start edge.
+ * @brief Print a row of the graph node the edges of a field start at.
  * @param[in] printer The printer to print to
- * @param[in] node The node str to use
- * @param[in] port The port to use
+ * @param[in] port The port of the field
  * @param[in] nodeCount The node count to use
+ * @param[in] label The label of the row
  */
-static inline void
-waitui_ast_printer_printGraphLinkLeft(waitui_ast_printer *printer, str *node,
-                                      char *port,
-                                      unsigned long long nodeCount) {
-    fprintf(printer->outputFile, "\t%.*s%llu:%s%llu -> ", STR_FMT(node),
-            nodeCount, port, nodeCount);
+static void waitui_ast_printer_printPortRow(waitui_ast_printer *printer,
+                                            const char *port,
+                                            unsigned long long nodeCount,
+                                            const char *label) {
+    WAITUI_AST_PRINTER_APPEND(printer, WAITUI_AST_PRINTER_PORT_BEGIN);
+    waitui_output_appendString(printer->output, port);
+    waitui_output_appendU64(printer->output, nodeCount);
+    WAITUI_AST_PRINTER_APPEND(printer, WAITUI_AST_PRINTER_PORT_END);
+    waitui_output_appendString(printer->output, label);
+    WAITUI_AST_PRINTER_APPEND(printer, WAITUI_AST_PRINTER_VALUE_END);
 }
 
 /**
- * @brief Print a graph node end edge.
+ * @brief Print the end of a graph node.
  * @param[in] printer The printer to print to
+ */
+static void waitui_ast_printer_endGraphNode(waitui_ast_printer *printer) {
+    WAITUI_AST_PRINTER_APPEND(printer, WAITUI_AST_PRINTER_TABLE_END
+                                               WAITUI_AST_PRINTER_NODE_END);
+}
+
+/**
+ * @brief Print the edge from the parent to the graph node.
+ * @param[in,out] printer The printer to print to
  * @param[in] node The node str to use
  * @param[in] nodeCount The node count to use
  */
-static inline void
-waitui_ast_printer_printGraphLinkRight(waitui_ast_printer *printer, str *node,
-                                       unsigned long long nodeCount) {
-    fprintf(printer->outputFile, "%.*s%llu;\n", STR_FMT(node), nodeCount);
+static void waitui_ast_printer_printEdge(waitui_ast_printer *printer,
+                                         const str *node,
+                                         unsigned long long nodeCount) {
+    waitui_ast_printer_parent *parent = NULL;
+
+    if (printer->parentsLength == 0) { return; }
+
+    parent = &printer->parents[printer->parentsLength - 1];
+    WAITUI_AST_PRINTER_APPEND(printer, "\t");
+    waitui_ast_printer_printGraphNodeName(printer, &parent->title,
+                                          parent->nodeCount);
+    WAITUI_AST_PRINTER_APPEND(printer, ":");
+    waitui_output_appendString(printer->output,
+                               parent->ports[printer->visit->field]);
+    waitui_output_appendU64(printer->output, parent->nodeCount);
+    WAITUI_AST_PRINTER_APPEND(printer, " -> ");
+    waitui_ast_printer_printGraphNodeName(printer, node, nodeCount);
+    WAITUI_AST_PRINTER_APPEND(printer, ";\n");
+}
+
+/**
+ * @brief Print the edge from the parent to the graph node and enter it.
+ * @param[in,out] printer The printer to print to
+ * @param[in] node The node str to use
+ * @param[in] nodeCount The node count to use
+ * @param[in] ports The ports of the node per field, NULL without children
+ */
+static void waitui_ast_printer_enterGraphNode(waitui_ast_printer *printer,
+                                              str *node,
+                                              unsigned long long nodeCount,
+                                              const char *const *ports) {
+    waitui_ast_printer_parent *parent = NULL;
+
+    waitui_ast_printer_printEdge(printer, node, nodeCount);
+
+    if (printer->parentsLength == printer->parentsSize) {
+        unsigned long int size =
+                printer->parentsSize ? printer->parentsSize * 2 : 64;
+        waitui_ast_printer_parent *parents =
+                realloc(printer->parents, size * sizeof(*parents));
+        if (!parents) {
+            printer->failed = true;
+            return;
+        }
+
+        printer->parents     = parents;
+        printer->parentsSize = size;
+    }
+
+    parent            = &printer->parents[printer->parentsLength++];
+    parent->node      = printer->visit->node;
+    parent->title     = *node;
+    parent->nodeCount = nodeCount;
+    parent->ports     = ports;
 }
 
 /**
  * @brief Print the Program AST node.
- * @param[in] programNode The Program AST node to print
+ * @param[in] node The Program AST node to print
  * @param[in] args The extra args for the callback call
  */
-static void waitui_ast_printer_printProgram(waitui_ast_program *programNode,
-                                            void *args) {
+static void waitui_ast_printer_printProgram(waitui_ast_node *node, void *args) {
     waitui_ast_printer *printer  = (waitui_ast_printer *) args;
     unsigned long long nodeCount = printer->nodeCount++;
 
     str title = STR_STATIC_INIT("program");
+    static const char *const ports[] = {
+            [WAITUI_AST_FIELD_PROGRAM_NAMESPACES] = "program_namespaces",
+    };
 
-    waitui_ast_printer_printGraphNode(
-            printer, &title, nodeCount,
-            WAITUI_AST_PRINTER_TABLE_BEGIN WAITUI_AST_PRINTER_TITLE_ROW
-                    WAITUI_AST_PRINTER_KEY_PORT WAITUI_AST_PRINTER_TABLE_END,
-            STR_FMT(&title), "program_namespaces", nodeCount, "namespaces");
-
-    {
-        waitui_ast_namespace_list_iter *iter =
-                waitui_ast_namespace_list_getIterator(
-                        waitui_ast_program_getNamespaces(programNode));
-        while (waitui_ast_namespace_list_iter_hasNext(iter)) {
-            waitui_ast_printer_printGraphLinkLeft(
-                    printer, &title, "program_namespaces", nodeCount);
-            WAITUI_AST_EXECUTE_CALLBACKS(
-                    printer->callbacks,
-                    waitui_ast_namespace_list_iter_next(iter), args);
-        }
-        waitui_ast_namespace_list_iter_destroy(&iter);
-    }
+    (void) node;
+
+    waitui_ast_printer_enterGraphNode(printer, &title, nodeCount, ports);
+    waitui_ast_printer_beginGraphNode(printer, &title, nodeCount);
+    waitui_ast_printer_printPortRow(printer, "program_namespaces", nodeCount,
+                                    "namespaces");
+    waitui_ast_printer_endGraphNode(printer);
 }
 
 /**
  * @brief Print the Namespace AST node.
- * @param[in] namespaceNode The Namespace AST node to print
+ * @param[in] node The Namespace AST node to print
  * @param[in] args The extra args for the callback call
  */
 static void
-waitui_ast_printer_printNamespace(waitui_ast_namespace *namespaceNode,
-                                  void *args) {
-    waitui_ast_printer *printer  = (waitui_ast_printer *) args;
-    unsigned long long nodeCount = printer->nodeCount++;
+waitui_ast_printer_printNamespace(waitui_ast_node *node, void *args) {
+    waitui_ast_namespace *namespaceNode = (waitui_ast_namespace *) node;
+    waitui_ast_printer *printer         = (waitui_ast_printer *) args;
+    unsigned long long nodeCount        = printer->nodeCount++;
 
     str title = STR_STATIC_INIT("namespace");
+    static const char *const ports[] = {
+            [WAITUI_AST_FIELD_NAMESPACE_IMPORTS] = "namespaces_imports",
+            [WAITUI_AST_FIELD_NAMESPACE_CLASSES] = "namespaces_classes",
+    };
 
     const str name = waitui_ast_printer_symbolToStr(
             waitui_ast_namespace_getName(namespaceNode));
 
-    waitui_ast_printer_printGraphLinkRight(printer, &title, nodeCount);
-    waitui_ast_printer_printGraphNode(
-            printer, &title, nodeCount,
-            WAITUI_AST_PRINTER_TABLE_BEGIN WAITUI_AST_PRINTER_TITLE_ROW
-                    WAITUI_AST_PRINTER_KEY_STR_VALUE WAITUI_AST_PRINTER_KEY_PORT
-                            WAITUI_AST_PRINTER_KEY_PORT
-                                    WAITUI_AST_PRINTER_TABLE_END,
-            STR_FMT(&title), "name", STR_FMT(&name), "namespaces_imports",
-            nodeCount, "imports", "namespaces_classes", nodeCount, "classes");
-
-    {
-        waitui_ast_import_list_iter *iter = waitui_ast_import_list_getIterator(
-                waitui_ast_namespace_getImports(namespaceNode));
-        while (waitui_ast_import_list_iter_hasNext(iter)) {
-            waitui_ast_printer_printGraphLinkLeft(
-                    printer, &title, "namespaces_imports", nodeCount);
-            WAITUI_AST_EXECUTE_CALLBACKS(printer->callbacks,
-                                         waitui_ast_import_list_iter_next(iter),
-                                         args);
-        }
-        waitui_ast_import_list_iter_destroy(&iter);
-    }
-
-    {
-        waitui_ast_class_list_iter *iter = waitui_ast_class_list_getIterator(
-                waitui_ast_namespace_getClasses(namespaceNode));
-        while (waitui_ast_class_list_iter_hasNext(iter)) {
-            waitui_ast_printer_printGraphLinkLeft(
-                    printer, &title, "namespaces_classes", nodeCount);
-            WAITUI_AST_EXECUTE_CALLBACKS(printer->callbacks,
-                                         waitui_ast_class_list_iter_next(iter),
-                                         args);
-        }
-        waitui_ast_class_list_iter_destroy(&iter);
-    }
+    waitui_ast_printer_enterGraphNode(printer, &title, nodeCount, ports);
+    waitui_ast_printer_beginGraphNode(printer, &title, nodeCount);
+    waitui_ast_printer_printStrRow(printer, "name", &name);
+    waitui_ast_printer_printPortRow(printer, "namespaces_imports", nodeCount,
+                                    "imports");
+    waitui_ast_printer_printPortRow(printer, "namespaces_classes", nodeCount,
+                                    "classes");
+    waitui_ast_printer_endGraphNode(printer);
 }
 
 /**
  * @brief Print the Import AST node.
- * @param[in] importNode The Import AST node to print
+ * @param[in] node The Import AST node to print
  * @param[in] args The extra args for the callback call
  */
-static void waitui_ast_printer_printImport(waitui_ast_import *importNode,
-                                           void *args) {
-    waitui_ast_printer *printer  = (waitui_ast_printer *) args;
-    unsigned long long nodeCount = printer->nodeCount++;
+static void waitui_ast_printer_printImport(waitui_ast_node *node, void *args) {
+    waitui_ast_import *importNode = (waitui_ast_import *) node;
+    waitui_ast_printer *printer   = (waitui_ast_printer *) args;
+    unsigned long long nodeCount  = printer->nodeCount++;
 
     str title = STR_STATIC_INIT("import");
 
@@ -340,114 +462,61 @@ static void waitui_ast_printer_printImport(waitui_ast_import *importNode,
     const str alias = waitui_ast_printer_symbolToStr(
             waitui_ast_import_getAlias(importNode));
 
-    waitui_ast_printer_printGraphLinkRight(printer, &title, nodeCount);
-    waitui_ast_printer_printGraphNode(
-            printer, &title, nodeCount,
-            WAITUI_AST_PRINTER_TABLE_BEGIN WAITUI_AST_PRINTER_TITLE_ROW
-                    WAITUI_AST_PRINTER_KEY_STR_VALUE
-                            WAITUI_AST_PRINTER_KEY_STR_VALUE
-                                    WAITUI_AST_PRINTER_TABLE_END,
-            STR_FMT(&title), "name", STR_FMT(&name), "alias", STR_FMT(&alias),
-            nodeCount, "classes");
+    waitui_ast_printer_enterGraphNode(printer, &title, nodeCount, NULL);
+    waitui_ast_printer_beginGraphNode(printer, &title, nodeCount);
+    waitui_ast_printer_printStrRow(printer, "name", &name);
+    waitui_ast_printer_printStrRow(printer, "alias", &alias);
+    waitui_ast_printer_endGraphNode(printer);
 }
 
 /**
  * @brief Print the Class AST node.
- * @param[in] classNode The Class AST node to print
+ * @param[in] node The Class AST node to print
  * @param[in] args The extra args for the callback call
  */
-static void waitui_ast_printer_printClass(waitui_ast_class *classNode,
-                                          void *args) {
+static void waitui_ast_printer_printClass(waitui_ast_node *node, void *args) {
+    waitui_ast_class *classNode  = (waitui_ast_class *) node;
     waitui_ast_printer *printer  = (waitui_ast_printer *) args;
     unsigned long long nodeCount = printer->nodeCount++;
 
     str title = STR_STATIC_INIT("class");
+    static const char *const ports[] = {
+            [WAITUI_AST_FIELD_CLASS_PARAMETERS] = "class_parameters",
+            [WAITUI_AST_FIELD_CLASS_SUPER_CLASS_ARGS] =
+                    "class_super_class_args",
+            [WAITUI_AST_FIELD_CLASS_PROPERTIES] = "class_properties",
+            [WAITUI_AST_FIELD_CLASS_FUNCTIONS] = "class_functions",
+    };
 
     const str className =
             waitui_ast_printer_symbolToStr(waitui_ast_class_getName(classNode));
     const str superClassName = waitui_ast_printer_symbolToStr(
             waitui_ast_class_getSuperClass(classNode));
 
-    waitui_ast_printer_printGraphLinkRight(printer, &title, nodeCount);
-    waitui_ast_printer_printGraphNode(
-            printer, &title, nodeCount,
-            WAITUI_AST_PRINTER_TABLE_BEGIN WAITUI_AST_PRINTER_TITLE_ROW
-                    WAITUI_AST_PRINTER_KEY_STR_VALUE WAITUI_AST_PRINTER_KEY_PORT
-                            WAITUI_AST_PRINTER_KEY_STR_VALUE WAITUI_AST_PRINTER_KEY_PORT
-                                    WAITUI_AST_PRINTER_KEY_PORT
-                                            WAITUI_AST_PRINTER_KEY_PORT
-                                                    WAITUI_AST_PRINTER_TABLE_END,
-            STR_FMT(&title), "name", STR_FMT(&className), "class_parameters",
-            nodeCount, "parameters", "super", STR_FMT(&superClassName),
-            "class_super_class_args", nodeCount, "superClassArgs",
-            "class_properties", nodeCount, "properties", "class_functions",
-            nodeCount, "functions");
-
-    {
-        waitui_ast_formal_list_iter *iter = waitui_ast_formal_list_getIterator(
-                waitui_ast_class_getParameters(classNode));
-        while (waitui_ast_formal_list_iter_hasNext(iter)) {
-            waitui_ast_printer_printGraphLinkLeft(
-                    printer, &title, "class_parameters", nodeCount);
-            WAITUI_AST_EXECUTE_CALLBACKS(printer->callbacks,
-                                         waitui_ast_formal_list_iter_next(iter),
-                                         args);
-        }
-        waitui_ast_formal_list_iter_destroy(&iter);
-    }
-
-    {
-        waitui_ast_expression_list_iter *iter =
-                waitui_ast_expression_list_getIterator(
-                        waitui_ast_class_getSuperClassArgs(classNode));
-        while (waitui_ast_expression_list_iter_hasNext(iter)) {
-            waitui_ast_printer_printGraphLinkLeft(
-                    printer, &title, "class_super_class_args", nodeCount);
-            WAITUI_AST_EXECUTE_CALLBACKS(
-                    printer->callbacks,
-                    waitui_ast_expression_list_iter_next(iter), args);
-        }
-        waitui_ast_expression_list_iter_destroy(&iter);
-    }
-
-    {
-        waitui_ast_property_list_iter *iter =
-                waitui_ast_property_list_getIterator(
-                        waitui_ast_class_getProperties(classNode));
-        while (waitui_ast_property_list_iter_hasNext(iter)) {
-            waitui_ast_printer_printGraphLinkLeft(
-                    printer, &title, "class_properties", nodeCount);
-            WAITUI_AST_EXECUTE_CALLBACKS(
-                    printer->callbacks,
-                    waitui_ast_property_list_iter_next(iter), args);
-        }
-        waitui_ast_property_list_iter_destroy(&iter);
-    }
-
-    {
-        waitui_ast_function_list_iter *iter =
-                waitui_ast_function_list_getIterator(
-                        waitui_ast_class_getFunctions(classNode));
-        while (waitui_ast_function_list_iter_hasNext(iter)) {
-            waitui_ast_printer_printGraphLinkLeft(printer, &title,
-                                                  "class_functions", nodeCount);
-            WAITUI_AST_EXECUTE_CALLBACKS(
-                    printer->callbacks,
-                    waitui_ast_function_list_iter_next(iter), args);
-        }
-        waitui_ast_function_list_iter_destroy(&iter);
-    }
+    waitui_ast_printer_enterGraphNode(printer, &title, nodeCount, ports);
+    waitui_ast_printer_beginGraphNode(printer, &title, nodeCount);
+    waitui_ast_printer_printStrRow(printer, "name", &className);
+    waitui_ast_printer_printPortRow(printer, "class_parameters", nodeCount,
+                                    "parameters");
+    waitui_ast_printer_printStrRow(printer, "super", &superClassName);
+    waitui_ast_printer_printPortRow(printer, "class_super_class_args",
+                                    nodeCount, "superClassArgs");
+    waitui_ast_printer_printPortRow(printer, "class_properties", nodeCount,
+                                    "properties");
+    waitui_ast_printer_printPortRow(printer, "class_functions", nodeCount,
+                                    "functions");
+    waitui_ast_printer_endGraphNode(printer);
 }
 
 /**
  * @brief Print the Formal AST node.
- * @param[in] formalNode The Formal AST node to print
+ * @param[in] node The Formal AST node to print
  * @param[in] args The extra args for the callback call
  */
-static void waitui_ast_printer_printFormal(waitui_ast_formal *formalNode,
-                                           void *args) {
-    waitui_ast_printer *printer  = (waitui_ast_printer *) args;
-    unsigned long long nodeCount = printer->nodeCount++;
+static void waitui_ast_printer_printFormal(waitui_ast_node *node, void *args) {
+    waitui_ast_formal *formalNode = (waitui_ast_formal *) node;
+    waitui_ast_printer *printer   = (waitui_ast_printer *) args;
+    unsigned long long nodeCount  = printer->nodeCount++;
 
     str title = STR_STATIC_INIT("formal");
 
@@ -458,68 +527,60 @@ static void waitui_ast_printer_printFormal(waitui_ast_formal *formalNode,
     const char *isLazy = waitui_ast_printer_boolToString(
             waitui_ast_formal_isLazy(formalNode));
 
-    waitui_ast_printer_printGraphLinkRight(printer, &title, nodeCount);
-    waitui_ast_printer_printGraphNode(
-            printer, &title, nodeCount,
-            WAITUI_AST_PRINTER_TABLE_BEGIN WAITUI_AST_PRINTER_TITLE_ROW
-                    WAITUI_AST_PRINTER_KEY_STR_VALUE
-                            WAITUI_AST_PRINTER_KEY_STR_VALUE
-                                    WAITUI_AST_PRINTER_KEY_STRING_VALUE
-                                            WAITUI_AST_PRINTER_TABLE_END,
-            STR_FMT(&title), "identifier", STR_FMT(&identifier), "type",
-            STR_FMT(&type), "isLazy", isLazy);
+    waitui_ast_printer_enterGraphNode(printer, &title, nodeCount, NULL);
+    waitui_ast_printer_beginGraphNode(printer, &title, nodeCount);
+    waitui_ast_printer_printStrRow(printer, "identifier", &identifier);
+    waitui_ast_printer_printStrRow(printer, "type", &type);
+    waitui_ast_printer_printStringRow(printer, "isLazy", isLazy);
+    waitui_ast_printer_endGraphNode(printer);
 }
 
 /**
  * @brief Print the Property AST node.
- * @param[in] propertyNode The Property AST node to print
+ * @param[in] node The Property AST node to print
  * @param[in] args The extra args for the callback call
  */
-static void waitui_ast_printer_printProperty(waitui_ast_property *propertyNode,
-                                             void *args) {
-    waitui_ast_printer *printer  = (waitui_ast_printer *) args;
-    unsigned long long nodeCount = printer->nodeCount++;
+static void
+waitui_ast_printer_printProperty(waitui_ast_node *node, void *args) {
+    waitui_ast_property *propertyNode = (waitui_ast_property *) node;
+    waitui_ast_printer *printer       = (waitui_ast_printer *) args;
+    unsigned long long nodeCount      = printer->nodeCount++;
 
     str title = STR_STATIC_INIT("property");
+    static const char *const ports[] = {
+            [WAITUI_AST_FIELD_PROPERTY_VALUE] = "property_value",
+    };
 
     const str name = waitui_ast_printer_symbolToStr(
             waitui_ast_property_getName(propertyNode));
     const str type = waitui_ast_printer_symbolToStr(
             waitui_ast_property_getType(propertyNode));
 
-    waitui_ast_printer_printGraphLinkRight(printer, &title, nodeCount);
-    waitui_ast_printer_printGraphNode(
-            printer, &title, nodeCount,
-            WAITUI_AST_PRINTER_TABLE_BEGIN WAITUI_AST_PRINTER_TITLE_ROW
-                    WAITUI_AST_PRINTER_KEY_STR_VALUE
-                            WAITUI_AST_PRINTER_KEY_STR_VALUE
-                                    WAITUI_AST_PRINTER_KEY_PORT
-                                            WAITUI_AST_PRINTER_TABLE_END,
-            STR_FMT(&title), "name", STR_FMT(&name), "type", STR_FMT(&type),
-            "property_value", nodeCount, "value");
-
-    {
-        const waitui_ast_expression *value =
-                waitui_ast_property_getValue(propertyNode);
-        if (value) {
-            waitui_ast_printer_printGraphLinkLeft(printer, &title,
-                                                  "property_value", nodeCount);
-            WAITUI_AST_EXECUTE_CALLBACKS(printer->callbacks, value, args);
-        }
-    }
+    waitui_ast_printer_enterGraphNode(printer, &title, nodeCount, ports);
+    waitui_ast_printer_beginGraphNode(printer, &title, nodeCount);
+    waitui_ast_printer_printStrRow(printer, "name", &name);
+    waitui_ast_printer_printStrRow(printer, "type", &type);
+    waitui_ast_printer_printPortRow(printer, "property_value", nodeCount,
+                                    "value");
+    waitui_ast_printer_endGraphNode(printer);
 }
 
 /**
  * @brief Print the Function AST node.
- * @param[in] functionNode The Function AST node to print
+ * @param[in] node The Function AST node to print
  * @param[in] args The extra args for the callback call
  */
-static void waitui_ast_printer_printFunction(waitui_ast_function *functionNode,
-                                             void *args) {
-    waitui_ast_printer *printer  = (waitui_ast_printer *) args;
-    unsigned long long nodeCount = printer->nodeCount++;
+static void
+waitui_ast_printer_printFunction(waitui_ast_node *node, void *args) {
+    waitui_ast_function *functionNode = (waitui_ast_function *) node;
+    waitui_ast_printer *printer       = (waitui_ast_printer *) args;
+    unsigned long long nodeCount      = printer->nodeCount++;
 
     str title = STR_STATIC_INIT("function");
+    static const char *const ports[] = {
+            [WAITUI_AST_FIELD_FUNCTION_PARAMETERS] = "function_parameters",
+            [WAITUI_AST_FIELD_FUNCTION_BODY] = "function_body",
+    };
 
     const str name = waitui_ast_printer_symbolToStr(
             waitui_ast_function_getFunctionName(functionNode));
@@ -534,93 +595,61 @@ static void waitui_ast_printer_printFunction(waitui_ast_function *functionNode,
     const char *visibility = waitui_ast_printer_functionVisibilityToString(
             waitui_ast_function_getVisibility(functionNode));
 
-    waitui_ast_printer_printGraphLinkRight(printer, &title, nodeCount);
-    waitui_ast_printer_printGraphNode(
-            printer, &title, nodeCount,
-            WAITUI_AST_PRINTER_TABLE_BEGIN WAITUI_AST_PRINTER_TITLE_ROW
-                    WAITUI_AST_PRINTER_KEY_STR_VALUE WAITUI_AST_PRINTER_KEY_PORT
-                            WAITUI_AST_PRINTER_KEY_STR_VALUE WAITUI_AST_PRINTER_KEY_STRING_VALUE
-                                    WAITUI_AST_PRINTER_KEY_STRING_VALUE WAITUI_AST_PRINTER_KEY_STRING_VALUE
-                                            WAITUI_AST_PRINTER_KEY_STRING_VALUE
-                                                    WAITUI_AST_PRINTER_KEY_PORT
-                                                            WAITUI_AST_PRINTER_TABLE_END,
-            STR_FMT(&title), "name", STR_FMT(&name), "function_parameters",
-            nodeCount, "parameters", "returnType", STR_FMT(&returnType),
-            "visibility", visibility, "isAbstract", isAbstract, "isFinal",
-            isFinal, "isOverwrite", isOverwrite, "function_body", nodeCount,
-            "body");
-
-    {
-        waitui_ast_formal_list_iter *iter = waitui_ast_formal_list_getIterator(
-                waitui_ast_function_getParameters(functionNode));
-        while (waitui_ast_formal_list_iter_hasNext(iter)) {
-            waitui_ast_printer_printGraphLinkLeft(printer, &title,
-                                                  "class_functions", nodeCount);
-            WAITUI_AST_EXECUTE_CALLBACKS(printer->callbacks,
-                                         waitui_ast_formal_list_iter_next(iter),
-                                         args);
-        }
-        waitui_ast_formal_list_iter_destroy(&iter);
-    }
-
-    {
-        const waitui_ast_expression *body =
-                waitui_ast_function_getBody(functionNode);
-        if (body) {
-            waitui_ast_printer_printGraphLinkLeft(printer, &title,
-                                                  "function_body", nodeCount);
-            WAITUI_AST_EXECUTE_CALLBACKS(printer->callbacks, body, args);
-        }
-    }
+    waitui_ast_printer_enterGraphNode(printer, &title, nodeCount, ports);
+    waitui_ast_printer_beginGraphNode(printer, &title, nodeCount);
+    waitui_ast_printer_printStrRow(printer, "name", &name);
+    waitui_ast_printer_printPortRow(printer, "function_parameters", nodeCount,
+                                    "parameters");
+    waitui_ast_printer_printStrRow(printer, "returnType", &returnType);
+    waitui_ast_printer_printStringRow(printer, "visibility", visibility);
+    waitui_ast_printer_printStringRow(printer, "isAbstract", isAbstract);
+    waitui_ast_printer_printStringRow(printer, "isFinal", isFinal);
+    waitui_ast_printer_printStringRow(printer, "isOverwrite", isOverwrite);
+    waitui_ast_printer_printPortRow(printer, "function_body", nodeCount,
+                                    "body");
+    waitui_ast_printer_endGraphNode(printer);
 }
 
 /**
  * @brief Print the Assignment AST node.
- * @param[in] assignmentNode The Assignment AST node to print
+ * @param[in] node The Assignment AST node to print
  * @param[in] args The extra args for the callback call
  */
 static void
-waitui_ast_printer_printAssignment(waitui_ast_assignment *assignmentNode,
-                                   void *args) {
-    waitui_ast_printer *printer  = (waitui_ast_printer *) args;
-    unsigned long long nodeCount = printer->nodeCount++;
+waitui_ast_printer_printAssignment(waitui_ast_node *node, void *args) {
+    waitui_ast_assignment *assignmentNode = (waitui_ast_assignment *) node;
+    waitui_ast_printer *printer           = (waitui_ast_printer *) args;
+    unsigned long long nodeCount          = printer->nodeCount++;
 
     str title = STR_STATIC_INIT("assignment");
+    static const char *const ports[] = {
+            [WAITUI_AST_FIELD_ASSIGNMENT_VALUE] = "assignment_value",
+    };
 
     const str identifier = waitui_ast_printer_symbolToStr(
             waitui_ast_assignment_getIdentifier(assignmentNode));
     const char *operator= waitui_ast_printer_assignmentOperatorToString(
             waitui_ast_assignment_getOperator(assignmentNode));
 
-    waitui_ast_printer_printGraphLinkRight(printer, &title, nodeCount);
-    waitui_ast_printer_printGraphNode(
-            printer, &title, nodeCount,
-            WAITUI_AST_PRINTER_TABLE_BEGIN WAITUI_AST_PRINTER_TITLE_ROW
-                    WAITUI_AST_PRINTER_KEY_STR_VALUE
-                            WAITUI_AST_PRINTER_KEY_STRING_VALUE
-                                    WAITUI_AST_PRINTER_KEY_PORT
-                                            WAITUI_AST_PRINTER_TABLE_END,
-            STR_FMT(&title), "identifier", STR_FMT(&identifier),
-            "operator", operator, "assignment_value", nodeCount, "value");
-
-    {
-        const waitui_ast_expression *value =
-                waitui_ast_assignment_getValue(assignmentNode);
-        if (value) {
-            waitui_ast_printer_printGraphLinkLeft(
-                    printer, &title, "assignment_value", nodeCount);
-            WAITUI_AST_EXECUTE_CALLBACKS(printer->callbacks, value, args);
-        }
-    }
+    waitui_ast_printer_enterGraphNode(printer, &title, nodeCount, ports);
+    waitui_ast_printer_beginGraphNode(printer, &title, nodeCount);
+    waitui_ast_printer_printStrRow(printer, "identifier", &identifier);
+    waitui_ast_printer_printStringRow(printer, "operator", operator);
+    waitui_ast_printer_printPortRow(printer, "assignment_value", nodeCount,
+                                    "value");
+    waitui_ast_printer_endGraphNode(printer);
 }
 
 /**
  * @brief Print the String Literal AST node.
- * @param[in] stringLiteralNode The String Literal AST node to print
+ * @param[in] node The String Literal AST node to print
  * @param[in] args The extra args for the callback call
  */
-static void waitui_ast_printer_printStringLiteral(
-        waitui_ast_string_literal *stringLiteralNode, void *args) {
+static void
+waitui_ast_printer_printStringLiteral(waitui_ast_node *node, void *args) {
+    waitui_ast_string_literal *stringLiteralNode =
+            (waitui_ast_string_literal *) node;
+
     waitui_ast_printer *printer  = (waitui_ast_printer *) args;
     unsigned long long nodeCount = printer->nodeCount++;
 
@@ -628,22 +657,22 @@ static void waitui_ast_printer_printStringLiteral(
 
     const str *value = waitui_ast_string_literal_getValue(stringLiteralNode);
 
-    waitui_ast_printer_printGraphLinkRight(printer, &title, nodeCount);
-    waitui_ast_printer_printGraphNode(
-            printer, &title, nodeCount,
-            WAITUI_AST_PRINTER_TABLE_BEGIN WAITUI_AST_PRINTER_TITLE_ROW
-                    WAITUI_AST_PRINTER_KEY_STR_VALUE
-                            WAITUI_AST_PRINTER_TABLE_END,
-            STR_FMT(&title), "value", STR_FMT(value));
+    waitui_ast_printer_enterGraphNode(printer, &title, nodeCount, NULL);
+    waitui_ast_printer_beginGraphNode(printer, &title, nodeCount);
+    waitui_ast_printer_printStrRow(printer, "value", value);
+    waitui_ast_printer_endGraphNode(printer);
 }
 
 /**
  * @brief Print the Integer Literal AST node.
- * @param[in] integerLiteralNode The Integer Literal AST node to print
+ * @param[in] node The Integer Literal AST node to print
  * @param[in] args The extra args for the callback call
  */
-static void waitui_ast_printer_printIntegerLiteral(
-        waitui_ast_integer_literal *integerLiteralNode, void *args) {
+static void
+waitui_ast_printer_printIntegerLiteral(waitui_ast_node *node, void *args) {
+    waitui_ast_integer_literal *integerLiteralNode =
+            (waitui_ast_integer_literal *) node;
+
     waitui_ast_printer *printer  = (waitui_ast_printer *) args;
     unsigned long long nodeCount = printer->nodeCount++;
 
@@ -651,44 +680,40 @@ static void waitui_ast_printer_printIntegerLiteral(
 
     const str *value = waitui_ast_integer_literal_getValue(integerLiteralNode);
 
-    waitui_ast_printer_printGraphLinkRight(printer, &title, nodeCount);
-    waitui_ast_printer_printGraphNode(
-            printer, &title, nodeCount,
-            WAITUI_AST_PRINTER_TABLE_BEGIN WAITUI_AST_PRINTER_TITLE_ROW
-                    WAITUI_AST_PRINTER_KEY_STR_VALUE
-                            WAITUI_AST_PRINTER_TABLE_END,
-            STR_FMT(&title), "value", STR_FMT(value));
+    waitui_ast_printer_enterGraphNode(printer, &title, nodeCount, NULL);
+    waitui_ast_printer_beginGraphNode(printer, &title, nodeCount);
+    waitui_ast_printer_printStrRow(printer, "value", value);
+    waitui_ast_printer_endGraphNode(printer);
 }
 
 /**
  * @brief Print the Null Literal AST node.
- * @param[in] nullLiteralNode The Null Literal AST node to print
+ * @param[in] node The Null Literal AST node to print
  * @param[in] args The extra args for the callback call
  */
 static void
-waitui_ast_printer_printNullLiteral(waitui_ast_null_literal *nullLiteralNode,
-                                    void *args) {
+waitui_ast_printer_printNullLiteral(waitui_ast_node *node, void *args) {
     waitui_ast_printer *printer  = (waitui_ast_printer *) args;
     unsigned long long nodeCount = printer->nodeCount++;
-    (void) nullLiteralNode;
+    (void) node;
 
     str title = STR_STATIC_INIT("null_literal");
 
-    waitui_ast_printer_printGraphLinkRight(printer, &title, nodeCount);
-    waitui_ast_printer_printGraphNode(
-            printer, &title, nodeCount,
-            WAITUI_AST_PRINTER_TABLE_BEGIN WAITUI_AST_PRINTER_TITLE_ROW
-                    WAITUI_AST_PRINTER_TABLE_END,
-            STR_FMT(&title));
+    waitui_ast_printer_enterGraphNode(printer, &title, nodeCount, NULL);
+    waitui_ast_printer_beginGraphNode(printer, &title, nodeCount);
+    waitui_ast_printer_endGraphNode(printer);
 }
 
 /**
  * @brief Print the Boolean Literal AST node.
- * @param[in] booleanLiteralNode The Boolean Literal AST node to print
+ * @param[in] node The Boolean Literal AST node to print
  * @param[in] args The extra args for the callback call
  */
-static void waitui_ast_printer_printBooleanLiteral(
-        waitui_ast_boolean_literal *booleanLiteralNode, void *args) {
+static void
+waitui_ast_printer_printBooleanLiteral(waitui_ast_node *node, void *args) {
+    waitui_ast_boolean_literal *booleanLiteralNode =
+            (waitui_ast_boolean_literal *) node;
+
     waitui_ast_printer *printer  = (waitui_ast_printer *) args;
     unsigned long long nodeCount = printer->nodeCount++;
 
@@ -697,633 +722,557 @@ static void waitui_ast_printer_printBooleanLiteral(
     const char *value = waitui_ast_printer_boolToString(
             waitui_ast_boolean_literal_getValue(booleanLiteralNode));
 
-    waitui_ast_printer_printGraphLinkRight(printer, &title, nodeCount);
-    waitui_ast_printer_printGraphNode(
-            printer, &title, nodeCount,
-            WAITUI_AST_PRINTER_TABLE_BEGIN WAITUI_AST_PRINTER_TITLE_ROW
-                    WAITUI_AST_PRINTER_KEY_STRING_VALUE
-                            WAITUI_AST_PRINTER_TABLE_END,
-            STR_FMT(&title), "value", value);
+    waitui_ast_printer_enterGraphNode(printer, &title, nodeCount, NULL);
+    waitui_ast_printer_beginGraphNode(printer, &title, nodeCount);
+    waitui_ast_printer_printStringRow(printer, "value", value);
+    waitui_ast_printer_endGraphNode(printer);
 }
 
 /**
  * @brief Print the This Literal AST node.
- * @param[in] thisLiteralNode The This Literal AST node to print
+ * @param[in] node The This Literal AST node to print
  * @param[in] args The extra args for the callback call
  */
 static void
-waitui_ast_printer_printThisLiteral(waitui_ast_this_literal *thisLiteralNode,
-                                    void *args) {
+waitui_ast_printer_printThisLiteral(waitui_ast_node *node, void *args) {
     waitui_ast_printer *printer  = (waitui_ast_printer *) args;
     unsigned long long nodeCount = printer->nodeCount++;
-    (void) thisLiteralNode;
+    (void) node;
 
     str title = STR_STATIC_INIT("this_literal");
 
-    waitui_ast_printer_printGraphLinkRight(printer, &title, nodeCount);
-    waitui_ast_printer_printGraphNode(
-            printer, &title, nodeCount,
-            WAITUI_AST_PRINTER_TABLE_BEGIN WAITUI_AST_PRINTER_TITLE_ROW
-                    WAITUI_AST_PRINTER_TABLE_END,
-            STR_FMT(&title));
+    waitui_ast_printer_enterGraphNode(printer, &title, nodeCount, NULL);
+    waitui_ast_printer_beginGraphNode(printer, &title, nodeCount);
+    waitui_ast_printer_endGraphNode(printer);
 }
 
 /**
  * @brief Print the Reference Literal AST node.
- * @param[in] referenceNode The Reference Literal AST node to print
+ * @param[in] node The Reference Literal AST node to print
  * @param[in] args The extra args for the callback call
  */
 static void
-waitui_ast_printer_printReference(waitui_ast_reference *referenceNode,
-                                  void *args) {
-    waitui_ast_printer *printer  = (waitui_ast_printer *) args;
-    unsigned long long nodeCount = printer->nodeCount++;
+waitui_ast_printer_printReference(waitui_ast_node *node, void *args) {
+    waitui_ast_reference *referenceNode = (waitui_ast_reference *) node;
+    waitui_ast_printer *printer         = (waitui_ast_printer *) args;
+    unsigned long long nodeCount        = printer->nodeCount++;
 
     str title = STR_STATIC_INIT("reference");
 
     const str identifier = waitui_ast_printer_symbolToStr(
             waitui_ast_reference_getValue(referenceNode));
 
-    waitui_ast_printer_printGraphLinkRight(printer, &title, nodeCount);
-    waitui_ast_printer_printGraphNode(
-            printer, &title, nodeCount,
-            WAITUI_AST_PRINTER_TABLE_BEGIN WAITUI_AST_PRINTER_TITLE_ROW
-                    WAITUI_AST_PRINTER_KEY_STR_VALUE
-                            WAITUI_AST_PRINTER_TABLE_END,
-            STR_FMT(&title), "value", STR_FMT(&identifier));
+    waitui_ast_printer_enterGraphNode(printer, &title, nodeCount, NULL);
+    waitui_ast_printer_beginGraphNode(printer, &title, nodeCount);
+    waitui_ast_printer_printStrRow(printer, "value", &identifier);
+    waitui_ast_printer_endGraphNode(printer);
 }
 
 /**
  * @brief Print the Cast AST node.
- * @param[in] castNode The Cast AST node to print
+ * @param[in] node The Cast AST node to print
  * @param[in] args The extra args for the callback call
  */
-static void waitui_ast_printer_printCast(waitui_ast_cast *castNode,
-                                         void *args) {
+static void waitui_ast_printer_printCast(waitui_ast_node *node, void *args) {
+    waitui_ast_cast *castNode    = (waitui_ast_cast *) node;
     waitui_ast_printer *printer  = (waitui_ast_printer *) args;
     unsigned long long nodeCount = printer->nodeCount++;
 
     str title = STR_STATIC_INIT("cast");
+    static const char *const ports[] = {
+            [WAITUI_AST_FIELD_CAST_OBJECT] = "cast_object",
+    };
 
     const str type =
             waitui_ast_printer_symbolToStr(waitui_ast_cast_getType(castNode));
 
-    waitui_ast_printer_printGraphLinkRight(printer, &title, nodeCount);
-    waitui_ast_printer_printGraphNode(
-            printer, &title, nodeCount,
-            WAITUI_AST_PRINTER_TABLE_BEGIN WAITUI_AST_PRINTER_TITLE_ROW
-                    WAITUI_AST_PRINTER_KEY_PORT WAITUI_AST_PRINTER_KEY_STR_VALUE
-                            WAITUI_AST_PRINTER_TABLE_END,
-            STR_FMT(&title), "cast_object", nodeCount, "object", "type",
-            STR_FMT(&type));
-
-    {
-        const waitui_ast_expression *object =
-                waitui_ast_cast_getObject(castNode);
-        if (object) {
-            waitui_ast_printer_printGraphLinkLeft(printer, &title,
-                                                  "cast_object", nodeCount);
-            WAITUI_AST_EXECUTE_CALLBACKS(printer->callbacks, object, args);
-        }
-    }
+    waitui_ast_printer_enterGraphNode(printer, &title, nodeCount, ports);
+    waitui_ast_printer_beginGraphNode(printer, &title, nodeCount);
+    waitui_ast_printer_printPortRow(printer, "cast_object", nodeCount,
+                                    "object");
+    waitui_ast_printer_printStrRow(printer, "type", &type);
+    waitui_ast_printer_endGraphNode(printer);
 }
 
 /**
  * @brief Print the Block AST node.
- * @param[in] blockNode The Block AST node to print
+ * @param[in] node The Block AST node to print
  * @param[in] args The extra args for the callback call
  */
-static void waitui_ast_printer_printBlock(waitui_ast_block *blockNode,
-                                          void *args) {
+static void waitui_ast_printer_printBlock(waitui_ast_node *node, void *args) {
     waitui_ast_printer *printer  = (waitui_ast_printer *) args;
     unsigned long long nodeCount = printer->nodeCount++;
 
     str title = STR_STATIC_INIT("block");
+    static const char *const ports[] = {
+            [WAITUI_AST_FIELD_BLOCK_EXPRESSIONS] = "block_expressions",
+    };
 
-    waitui_ast_printer_printGraphLinkRight(printer, &title, nodeCount);
-    waitui_ast_printer_printGraphNode(
-            printer, &title, nodeCount,
-            WAITUI_AST_PRINTER_TABLE_BEGIN WAITUI_AST_PRINTER_TITLE_ROW
-                    WAITUI_AST_PRINTER_KEY_PORT WAITUI_AST_PRINTER_TABLE_END,
-            STR_FMT(&title), "block_expressions", nodeCount, "expressions");
-
-    {
-        waitui_ast_expression_list_iter *iter =
-                waitui_ast_expression_list_getIterator(
-                        waitui_ast_block_getExpressions(blockNode));
-        while (waitui_ast_expression_list_iter_hasNext(iter)) {
-            waitui_ast_printer_printGraphLinkLeft(
-                    printer, &title, "block_expressions", nodeCount);
-            WAITUI_AST_EXECUTE_CALLBACKS(
-                    printer->callbacks,
-                    waitui_ast_expression_list_iter_next(iter), args);
-        }
-        waitui_ast_expression_list_iter_destroy(&iter);
-    }
+    (void) node;
+
+    waitui_ast_printer_enterGraphNode(printer, &title, nodeCount, ports);
+    waitui_ast_printer_beginGraphNode(printer, &title, nodeCount);
+    waitui_ast_printer_printPortRow(printer, "block_expressions", nodeCount,
+                                    "expressions");
+    waitui_ast_printer_endGraphNode(printer);
 }
 
 /**
  * @brief Print the Constructor Call AST node.
- * @param[in] constructorCallNode The Constructor Call AST node to print
+ * @param[in] node The Constructor Call AST node to print
  * @param[in] args The extra args for the callback call
  */
-static void waitui_ast_printer_printConstructorCall(
-        waitui_ast_constructor_call *constructorCallNode, void *args) {
+static void
+waitui_ast_printer_printConstructorCall(waitui_ast_node *node, void *args) {
+    waitui_ast_constructor_call *constructorCallNode =
+            (waitui_ast_constructor_call *) node;
+
     waitui_ast_printer *printer  = (waitui_ast_printer *) args;
     unsigned long long nodeCount = printer->nodeCount++;
 
     str title = STR_STATIC_INIT("constructor_call");
+    static const char *const ports[] = {
+            [WAITUI_AST_FIELD_CONSTRUCTOR_CALL_ARGS] = "constructor_call_args",
+    };
 
     const str name = waitui_ast_printer_symbolToStr(
             waitui_ast_constructor_call_getName(constructorCallNode));
 
-    waitui_ast_printer_printGraphLinkRight(printer, &title, nodeCount);
-    waitui_ast_printer_printGraphNode(
-            printer, &title, nodeCount,
-            WAITUI_AST_PRINTER_TABLE_BEGIN WAITUI_AST_PRINTER_TITLE_ROW
-                    WAITUI_AST_PRINTER_KEY_STR_VALUE WAITUI_AST_PRINTER_KEY_PORT
-                            WAITUI_AST_PRINTER_TABLE_END,
-            STR_FMT(&title), "name", STR_FMT(&name), "constructor_call_args",
-            nodeCount, "args");
-
-    {
-        waitui_ast_expression_list_iter *iter =
-                waitui_ast_expression_list_getIterator(
-                        waitui_ast_constructor_call_getArgs(
-                                constructorCallNode));
-        while (waitui_ast_expression_list_iter_hasNext(iter)) {
-            waitui_ast_printer_printGraphLinkLeft(
-                    printer, &title, "constructor_call_args", nodeCount);
-            WAITUI_AST_EXECUTE_CALLBACKS(
-                    printer->callbacks,
-                    waitui_ast_expression_list_iter_next(iter), args);
-        }
-        waitui_ast_expression_list_iter_destroy(&iter);
-    }
+    waitui_ast_printer_enterGraphNode(printer, &title, nodeCount, ports);
+    waitui_ast_printer_beginGraphNode(printer, &title, nodeCount);
+    waitui_ast_printer_printStrRow(printer, "name", &name);
+    waitui_ast_printer_printPortRow(printer, "constructor_call_args", nodeCount,
+                                    "args");
+    waitui_ast_printer_endGraphNode(printer);
 }
 
 /**
  * @brief Print the Let AST node.
- * @param[in] letNode The Let AST node to print
+ * @param[in] node The Let AST node to print
  * @param[in] args The extra args for the callback call
  */
-static void waitui_ast_printer_printLet(waitui_ast_let *letNode, void *args) {
+static void waitui_ast_printer_printLet(waitui_ast_node *node, void *args) {
     waitui_ast_printer *printer  = (waitui_ast_printer *) args;
     unsigned long long nodeCount = printer->nodeCount++;
 
     str title = STR_STATIC_INIT("let");
+    static const char *const ports[] = {
+            [WAITUI_AST_FIELD_LET_INITIALIZATIONS] = "let_initializations",
+            [WAITUI_AST_FIELD_LET_BODY] = "let_body",
+    };
 
-    waitui_ast_printer_printGraphLinkRight(printer, &title, nodeCount);
-    waitui_ast_printer_printGraphNode(
-            printer, &title, nodeCount,
-            WAITUI_AST_PRINTER_TABLE_BEGIN WAITUI_AST_PRINTER_TITLE_ROW
-                    WAITUI_AST_PRINTER_KEY_PORT WAITUI_AST_PRINTER_KEY_PORT
-                            WAITUI_AST_PRINTER_TABLE_END,
-            STR_FMT(&title), "let_initializations", nodeCount,
-            "initializations", "let_body", nodeCount, "body");
-
-    {
-        waitui_ast_initialization_list_iter *iter =
-                waitui_ast_initialization_list_getIterator(
-                        waitui_ast_let_getInitializations(letNode));
-        while (waitui_ast_initialization_list_iter_hasNext(iter)) {
-            waitui_ast_printer_printGraphLinkLeft(
-                    printer, &title, "let_initializations", nodeCount);
-            WAITUI_AST_EXECUTE_CALLBACKS(
-                    printer->callbacks,
-                    waitui_ast_initialization_list_iter_next(iter), args);
-        }
-        waitui_ast_initialization_list_iter_destroy(&iter);
-    }
+    (void) node;
 
-    {
-        const waitui_ast_expression *body = waitui_ast_let_getBody(letNode);
-        if (body) {
-            waitui_ast_printer_printGraphLinkLeft(printer, &title, "let_body",
-                                                  nodeCount);
-            WAITUI_AST_EXECUTE_CALLBACKS(printer->callbacks, body, args);
-        }
-    }
+    waitui_ast_printer_enterGraphNode(printer, &title, nodeCount, ports);
+    waitui_ast_printer_beginGraphNode(printer, &title, nodeCount);
+    waitui_ast_printer_printPortRow(printer, "let_initializations", nodeCount,
+                                    "initializations");
+    waitui_ast_printer_printPortRow(printer, "let_body", nodeCount, "body");
+    waitui_ast_printer_endGraphNode(printer);
 }
 
 /**
  * @brief Print the Initialization AST node.
- * @param[in] initializationNode The Initialization AST node to print
+ * @param[in] node The Initialization AST node to print
  * @param[in] args The extra args for the callback call
  */
-static void waitui_ast_printer_printInitialization(
-        waitui_ast_initialization *initializationNode, void *args) {
+static void
+waitui_ast_printer_printInitialization(waitui_ast_node *node, void *args) {
+    waitui_ast_initialization *initializationNode =
+            (waitui_ast_initialization *) node;
+
     waitui_ast_printer *printer  = (waitui_ast_printer *) args;
     unsigned long long nodeCount = printer->nodeCount++;
 
     str title = STR_STATIC_INIT("initialization");
+    static const char *const ports[] = {
+            [WAITUI_AST_FIELD_INITIALIZATION_VALUE] = "initialization_value",
+    };
 
     const str identifier = waitui_ast_printer_symbolToStr(
             waitui_ast_initialization_getIdentifier(initializationNode));
     const str type = waitui_ast_printer_symbolToStr(
             waitui_ast_initialization_getType(initializationNode));
-    const waitui_ast_expression *value =
-            waitui_ast_initialization_getValue(initializationNode);
-
-    waitui_ast_printer_printGraphLinkRight(printer, &title, nodeCount);
-    waitui_ast_printer_printGraphNode(
-            printer, &title, nodeCount,
-            WAITUI_AST_PRINTER_TABLE_BEGIN WAITUI_AST_PRINTER_TITLE_ROW
-                    WAITUI_AST_PRINTER_KEY_STR_VALUE
-                            WAITUI_AST_PRINTER_KEY_STR_VALUE
-                                    WAITUI_AST_PRINTER_KEY_PORT
-                                            WAITUI_AST_PRINTER_TABLE_END,
-            STR_FMT(&title), "identifier", STR_FMT(&identifier), "type",
-            STR_FMT(&type), "initialization_value", nodeCount, "value");
-
-    if (value) {
-        waitui_ast_printer_printGraphLinkLeft(
-                printer, &title, "initialization_value", nodeCount);
-        WAITUI_AST_EXECUTE_CALLBACKS(printer->callbacks, value, args);
-    }
+
+    waitui_ast_printer_enterGraphNode(printer, &title, nodeCount, ports);
+    waitui_ast_printer_beginGraphNode(printer, &title, nodeCount);
+    waitui_ast_printer_printStrRow(printer, "identifier", &identifier);
+    waitui_ast_printer_printStrRow(printer, "type", &type);
+    waitui_ast_printer_printPortRow(printer, "initialization_value", nodeCount,
+                                    "value");
+    waitui_ast_printer_endGraphNode(printer);
 }
 
 /**
  * @brief Print the Binary Expression AST node.
- * @param[in] binaryExpressionNode The Binary Expression AST node to print
+ * @param[in] node The Binary Expression AST node to print
  * @param[in] args The extra args for the callback call
  */
-static void waitui_ast_printer_printBinaryExpression(
-        waitui_ast_binary_expression *binaryExpressionNode, void *args) {
+static void
+waitui_ast_printer_printBinaryExpression(waitui_ast_node *node, void *args) {
+    waitui_ast_binary_expression *binaryExpressionNode =
+            (waitui_ast_binary_expression *) node;
+
     waitui_ast_printer *printer  = (waitui_ast_printer *) args;
     unsigned long long nodeCount = printer->nodeCount++;
 
     str title = STR_STATIC_INIT("binary_expression");
+    static const char *const ports[] = {
+            [WAITUI_AST_FIELD_BINARY_EXPRESSION_LEFT] =
+                    "binary_expression_left",
+            [WAITUI_AST_FIELD_BINARY_EXPRESSION_RIGHT] =
+                    "binary_expression_right",
+    };
 
-    const waitui_ast_expression *left =
-            waitui_ast_binary_expression_getLeft(binaryExpressionNode);
     const char *operator= waitui_ast_printer_binaryOperatorToString(
             waitui_ast_binary_expression_getOperator(binaryExpressionNode));
-    const waitui_ast_expression *right =
-            waitui_ast_binary_expression_getRight(binaryExpressionNode);
-
-    waitui_ast_printer_printGraphLinkRight(printer, &title, nodeCount);
-    waitui_ast_printer_printGraphNode(
-            printer, &title, nodeCount,
-            WAITUI_AST_PRINTER_TABLE_BEGIN WAITUI_AST_PRINTER_TITLE_ROW
-                    WAITUI_AST_PRINTER_KEY_PORT
-                            WAITUI_AST_PRINTER_KEY_STRING_VALUE
-                                    WAITUI_AST_PRINTER_KEY_PORT
-                                            WAITUI_AST_PRINTER_TABLE_END,
-            STR_FMT(&title), "binary_expression_left", nodeCount, "left",
-            "operator", operator, "binary_expression_right", nodeCount,
-            "right");
-
-    if (left) {
-        waitui_ast_printer_printGraphLinkLeft(
-                printer, &title, "binary_expression_left", nodeCount);
-        WAITUI_AST_EXECUTE_CALLBACKS(printer->callbacks, left, args);
-    }
 
-    if (right) {
-        waitui_ast_printer_printGraphLinkLeft(
-                printer, &title, "binary_expression_right", nodeCount);
-        WAITUI_AST_EXECUTE_CALLBACKS(printer->callbacks, right, args);
-    }
+    waitui_ast_printer_enterGraphNode(printer, &title, nodeCount, ports);
+    waitui_ast_printer_beginGraphNode(printer, &title, nodeCount);
+    waitui_ast_printer_printPortRow(printer, "binary_expression_left",
+                                    nodeCount, "left");
+    waitui_ast_printer_printStringRow(printer, "operator", operator);
+    waitui_ast_printer_printPortRow(printer, "binary_expression_right",
+                                    nodeCount, "right");
+    waitui_ast_printer_endGraphNode(printer);
 }
 
 /**
  * @brief Print the Unary Expression AST node.
- * @param[in] unaryExpressionNode The Unary Expression AST node to print
+ * @param[in] node The Unary Expression AST node to print
  * @param[in] args The extra args for the callback call
  */
-static void waitui_ast_printer_printUnaryExpression(
-        waitui_ast_unary_expression *unaryExpressionNode, void *args) {
+static void
+waitui_ast_printer_printUnaryExpression(waitui_ast_node *node, void *args) {
+    waitui_ast_unary_expression *unaryExpressionNode =
+            (waitui_ast_unary_expression *) node;
+
     waitui_ast_printer *printer  = (waitui_ast_printer *) args;
     unsigned long long nodeCount = printer->nodeCount++;
 
     str title = STR_STATIC_INIT("unary_expression");
+    static const char *const ports[] = {
+            [WAITUI_AST_FIELD_UNARY_EXPRESSION_EXPRESSION] =
+                    "unary_expression_expression",
+    };
 
     const char *operator= waitui_ast_printer_unaryOperatorToString(
             waitui_ast_unary_expression_getOperator(unaryExpressionNode));
-    const waitui_ast_expression *expression =
-            waitui_ast_unary_expression_getExpression(unaryExpressionNode);
-
-    waitui_ast_printer_printGraphLinkRight(printer, &title, nodeCount);
-    waitui_ast_printer_printGraphNode(
-            printer, &title, nodeCount,
-            WAITUI_AST_PRINTER_TABLE_BEGIN WAITUI_AST_PRINTER_TITLE_ROW
-                    WAITUI_AST_PRINTER_KEY_STRING_VALUE
-                            WAITUI_AST_PRINTER_KEY_PORT
-                                    WAITUI_AST_PRINTER_TABLE_END,
-            STR_FMT(&title), "operator", operator,
-            "unary_expression_expression", nodeCount, "expression");
-
-    if (expression) {
-        waitui_ast_printer_printGraphLinkLeft(
-                printer, &title, "unary_expression_expression", nodeCount);
-        WAITUI_AST_EXECUTE_CALLBACKS(printer->callbacks, expression, args);
-    }
+
+    waitui_ast_printer_enterGraphNode(printer, &title, nodeCount, ports);
+    waitui_ast_printer_beginGraphNode(printer, &title, nodeCount);
+    waitui_ast_printer_printStringRow(printer, "operator", operator);
+    waitui_ast_printer_printPortRow(printer, "unary_expression_expression",
+                                    nodeCount, "expression");
+    waitui_ast_printer_endGraphNode(printer);
 }
 
 /**
  * @brief Print the If Else AST node.
- * @param[in] ifElseNode The If Else AST node to print
+ * @param[in] node The If Else AST node to print
  * @param[in] args The extra args for the callback call
  */
-static void waitui_ast_printer_printIfElse(waitui_ast_if_else *ifElseNode,
-                                           void *args) {
-    waitui_ast_printer *printer  = (waitui_ast_printer *) args;
-    unsigned long long nodeCount = printer->nodeCount++;
+static void waitui_ast_printer_printIfElse(waitui_ast_node *node, void *args) {
+    waitui_ast_if_else *ifElseNode = (waitui_ast_if_else *) node;
+    waitui_ast_printer *printer    = (waitui_ast_printer *) args;
+    unsigned long long nodeCount   = printer->nodeCount++;
 
     str title = STR_STATIC_INIT("if_else");
+    static const char *const ports[] = {
+            [WAITUI_AST_FIELD_IF_ELSE_CONDITION] = "if_else_condition",
+            [WAITUI_AST_FIELD_IF_ELSE_THEN_BRANCH] = "if_else_then_branch",
+            [WAITUI_AST_FIELD_IF_ELSE_ELSE_BRANCH] = "if_else_else_branch",
+    };
 
-    const waitui_ast_expression *condition =
-            waitui_ast_if_else_getCondition(ifElseNode);
-    const waitui_ast_expression *thenBranch =
-            waitui_ast_if_else_getThenBranch(ifElseNode);
     const waitui_ast_expression *elseBranch =
             waitui_ast_if_else_getElseBranch(ifElseNode);
 
-    waitui_ast_printer_printGraphLinkRight(printer, &title, nodeCount);
+    waitui_ast_printer_enterGraphNode(printer, &title, nodeCount, ports);
     if (!elseBranch) {
-        waitui_ast_printer_printGraphNode(
-                printer, &title, nodeCount,
-                WAITUI_AST_PRINTER_TABLE_BEGIN WAITUI_AST_PRINTER_TITLE_ROW
-                        WAITUI_AST_PRINTER_KEY_PORT WAITUI_AST_PRINTER_KEY_PORT
-                                WAITUI_AST_PRINTER_TABLE_END,
-                STR_FMT(&title), "if_else_condition", nodeCount, "condition",
-                "if_else_then_branch", nodeCount, "thenBranch");
+        waitui_ast_printer_beginGraphNode(printer, &title, nodeCount);
+        waitui_ast_printer_printPortRow(printer, "if_else_condition", nodeCount,
+                                        "condition");
+        waitui_ast_printer_printPortRow(printer, "if_else_then_branch",
+                                        nodeCount, "thenBranch");
+        waitui_ast_printer_endGraphNode(printer);
     } else {
-        waitui_ast_printer_printGraphNode(
-                printer, &title, nodeCount,
-                WAITUI_AST_PRINTER_TABLE_BEGIN WAITUI_AST_PRINTER_TITLE_ROW
-                        WAITUI_AST_PRINTER_KEY_PORT WAITUI_AST_PRINTER_KEY_PORT
-                                WAITUI_AST_PRINTER_KEY_PORT
-                                        WAITUI_AST_PRINTER_TABLE_END,
-                STR_FMT(&title), "if_else_condition", nodeCount, "condition",
-                "if_else_then_branch", nodeCount, "thenBranch",
-                "if_else_else_branch", nodeCount, "elseBranch");
-    }
-
-    if (condition) {
-        waitui_ast_printer_printGraphLinkLeft(printer, &title,
-                                              "if_else_condition", nodeCount);
-        WAITUI_AST_EXECUTE_CALLBACKS(printer->callbacks, condition, args);
-    }
-
-    if (thenBranch) {
-        waitui_ast_printer_printGraphLinkLeft(printer, &title,
-                                              "if_else_then_branch", nodeCount);
-        WAITUI_AST_EXECUTE_CALLBACKS(printer->callbacks, thenBranch, args);
-    }
-
-    if (elseBranch) {
-        waitui_ast_printer_printGraphLinkLeft(printer, &title,
-                                              "if_else_else_branch", nodeCount);
-        WAITUI_AST_EXECUTE_CALLBACKS(printer->callbacks, elseBranch, args);
+        waitui_ast_printer_beginGraphNode(printer, &title, nodeCount);
+        waitui_ast_printer_printPortRow(printer, "if_else_condition", nodeCount,
+                                        "condition");
+        waitui_ast_printer_printPortRow(printer, "if_else_then_branch",
+                                        nodeCount, "thenBranch");
+        waitui_ast_printer_printPortRow(printer, "if_else_else_branch",
+                                        nodeCount, "elseBranch");
+        waitui_ast_printer_endGraphNode(printer);
     }
 }
 
 /**
  * @brief Print the While AST node.
- * @param[in] whileNode The While AST node to print
+ * @param[in] node The While AST node to print
  * @param[in] args The extra args for the callback call
  */
-static void waitui_ast_printer_printWhile(waitui_ast_while *whileNode,
-                                          void *args) {
+static void waitui_ast_printer_printWhile(waitui_ast_node *node, void *args) {
     waitui_ast_printer *printer  = (waitui_ast_printer *) args;
     unsigned long long nodeCount = printer->nodeCount++;
 
     str title = STR_STATIC_INIT("while");
+    static const char *const ports[] = {
+            [WAITUI_AST_FIELD_WHILE_CONDITION] = "while_condition",
+            [WAITUI_AST_FIELD_WHILE_BODY] = "while_body",
+    };
 
-    const waitui_ast_expression *condition =
-            waitui_ast_while_getCondition(whileNode);
-    const waitui_ast_expression *body = waitui_ast_while_getBody(whileNode);
-
-    waitui_ast_printer_printGraphLinkRight(printer, &title, nodeCount);
-    waitui_ast_printer_printGraphNode(
-            printer, &title, nodeCount,
-            WAITUI_AST_PRINTER_TABLE_BEGIN WAITUI_AST_PRINTER_TITLE_ROW
-                    WAITUI_AST_PRINTER_KEY_PORT WAITUI_AST_PRINTER_KEY_PORT
-                            WAITUI_AST_PRINTER_TABLE_END,
-            STR_FMT(&title), "while_condition", nodeCount, "condition",
-            "while_body", nodeCount, "body");
-
-    if (condition) {
-        waitui_ast_printer_printGraphLinkLeft(printer, &title,
-                                              "while_condition", nodeCount);
-        WAITUI_AST_EXECUTE_CALLBACKS(printer->callbacks, condition, args);
-    }
+    (void) node;
 
-    if (body) {
-        waitui_ast_printer_printGraphLinkLeft(printer, &title, "while_body",
-                                              nodeCount);
-        WAITUI_AST_EXECUTE_CALLBACKS(printer->callbacks, body, args);
-    }
+    waitui_ast_printer_enterGraphNode(printer, &title, nodeCount, ports);
+    waitui_ast_printer_beginGraphNode(printer, &title, nodeCount);
+    waitui_ast_printer_printPortRow(printer, "while_condition", nodeCount,
+                                    "condition");
+    waitui_ast_printer_printPortRow(printer, "while_body", nodeCount, "body");
+    waitui_ast_printer_endGraphNode(printer);
 }
 
 /**
  * @brief Print the Function Call AST node.
- * @param[in] functionCallNode The Function Call AST node to print
+ * @param[in] node The Function Call AST node to print
  * @param[in] args The extra args for the callback call
  */
 static void
-waitui_ast_printer_printFunctionCall(waitui_ast_function_call *functionCallNode,
-                                     void *args) {
+waitui_ast_printer_printFunctionCall(waitui_ast_node *node, void *args) {
+    waitui_ast_function_call *functionCallNode =
+            (waitui_ast_function_call *) node;
+
     waitui_ast_printer *printer  = (waitui_ast_printer *) args;
     unsigned long long nodeCount = printer->nodeCount++;
 
     str title = STR_STATIC_INIT("function_call");
+    static const char *const ports[] = {
+            [WAITUI_AST_FIELD_FUNCTION_CALL_OBJECT] = "function_call_object",
+            [WAITUI_AST_FIELD_FUNCTION_CALL_ARGS] = "function_call_args",
+    };
 
     const str functionName = waitui_ast_printer_symbolToStr(
             waitui_ast_function_call_getFunctionName(functionCallNode));
 
-    waitui_ast_printer_printGraphLinkRight(printer, &title, nodeCount);
-    waitui_ast_printer_printGraphNode(
-            printer, &title, nodeCount,
-            WAITUI_AST_PRINTER_TABLE_BEGIN WAITUI_AST_PRINTER_TITLE_ROW
-                    WAITUI_AST_PRINTER_KEY_PORT WAITUI_AST_PRINTER_KEY_STR_VALUE
-                            WAITUI_AST_PRINTER_KEY_PORT
-                                    WAITUI_AST_PRINTER_TABLE_END,
-            STR_FMT(&title), "function_call_object", nodeCount, "object",
-            "functionName", STR_FMT(&functionName), "function_call_args",
-            nodeCount, "args");
-
-    {
-        const waitui_ast_expression *object =
-                waitui_ast_function_call_getObject(functionCallNode);
-        if (object) {
-            waitui_ast_printer_printGraphLinkLeft(
-                    printer, &title, "function_call_object", nodeCount);
-            WAITUI_AST_EXECUTE_CALLBACKS(printer->callbacks, object, args);
-        }
-    }
+    waitui_ast_printer_enterGraphNode(printer, &title, nodeCount, ports);
+    waitui_ast_printer_beginGraphNode(printer, &title, nodeCount);
+    waitui_ast_printer_printPortRow(printer, "function_call_object", nodeCount,
+                                    "object");
+    waitui_ast_printer_printStrRow(printer, "functionName", &functionName);
+    waitui_ast_printer_printPortRow(printer, "function_call_args", nodeCount,
+                                    "args");
+    waitui_ast_printer_endGraphNode(printer);
+}
 
-    {
-        waitui_ast_expression_list_iter *iter =
-                waitui_ast_expression_list_getIterator(
-                        waitui_ast_function_call_getArgs(functionCallNode));
-        while (waitui_ast_expression_list_iter_hasNext(iter)) {
-            waitui_ast_printer_printGraphLinkLeft(
-                    printer, &title, "function_call_args", nodeCount);
-            WAITUI_AST_EXECUTE_CALLBACKS(
-                    printer->callbacks,
-                    waitui_ast_expression_list_iter_next(iter), args);
-        }
-        waitui_ast_expression_list_iter_destroy(&iter);
+/**
+ * @brief The print functions of the definitions by definition type, the
+ *        definitions without one are not printed.
+ */
+static const waitui_ast_printer_print_function
+        waitui_ast_printer_definitionPrinters[] = {
+        [WAITUI_AST_DEFINITION_TYPE_FORMAL] = waitui_ast_printer_printFormal,
+        [WAITUI_AST_DEFINITION_TYPE_PROPERTY] =
+                waitui_ast_printer_printProperty,
+        [WAITUI_AST_DEFINITION_TYPE_FUNCTION] =
+                waitui_ast_printer_printFunction,
+        [WAITUI_AST_DEFINITION_TYPE_CLASS] = waitui_ast_printer_printClass,
+        [WAITUI_AST_DEFINITION_TYPE_IMPORT] = waitui_ast_printer_printImport,
+        [WAITUI_AST_DEFINITION_TYPE_NAMESPACE] =
+                waitui_ast_printer_printNamespace,
+        [WAITUI_AST_DEFINITION_TYPE_PROGRAM] = waitui_ast_printer_printProgram,
+};
+
+/**
+ * @brief The print functions of the expressions by expression type, the
+ *        expressions without one are not printed, neither are their children.
+ */
+static const waitui_ast_printer_print_function
+        waitui_ast_printer_expressionPrinters[] = {
+        [WAITUI_AST_EXPRESSION_TYPE_INTEGER_LITERAL] =
+                waitui_ast_printer_printIntegerLiteral,
+        [WAITUI_AST_EXPRESSION_TYPE_BOOLEAN_LITERAL] =
+                waitui_ast_printer_printBooleanLiteral,
+        [WAITUI_AST_EXPRESSION_TYPE_NULL_LITERAL] =
+                waitui_ast_printer_printNullLiteral,
+        [WAITUI_AST_EXPRESSION_TYPE_STRING_LITERAL] =
+                waitui_ast_printer_printStringLiteral,
+        [WAITUI_AST_EXPRESSION_TYPE_THIS_LITERAL] =
+                waitui_ast_printer_printThisLiteral,
+        [WAITUI_AST_EXPRESSION_TYPE_ASSIGNMENT] =
+                waitui_ast_printer_printAssignment,
+        [WAITUI_AST_EXPRESSION_TYPE_REFERENCE] =
+                waitui_ast_printer_printReference,
+        [WAITUI_AST_EXPRESSION_TYPE_CAST] = waitui_ast_printer_printCast,
+        [WAITUI_AST_EXPRESSION_TYPE_INITIALIZATION] =
+                waitui_ast_printer_printInitialization,
+        [WAITUI_AST_EXPRESSION_TYPE_LET] = waitui_ast_printer_printLet,
+        [WAITUI_AST_EXPRESSION_TYPE_BLOCK] = waitui_ast_printer_printBlock,
+        [WAITUI_AST_EXPRESSION_TYPE_CONSTRUCTOR_CALL] =
+                waitui_ast_printer_printConstructorCall,
+        [WAITUI_AST_EXPRESSION_TYPE_FUNCTION_CALL] =
+                waitui_ast_printer_printFunctionCall,
+        [WAITUI_AST_EXPRESSION_TYPE_BINARY_EXPRESSION] =
+                waitui_ast_printer_printBinaryExpression,
+        [WAITUI_AST_EXPRESSION_TYPE_UNARY_EXPRESSION] =
+                waitui_ast_printer_printUnaryExpression,
+        [WAITUI_AST_EXPRESSION_TYPE_IF_ELSE] = waitui_ast_printer_printIfElse,
+        [WAITUI_AST_EXPRESSION_TYPE_WHILE] = waitui_ast_printer_printWhile,
+};
+
+/**
+ * @brief Get the function printing the AST node.
+ * @param[in] node The AST node to get the print function of
+ * @return The print function or NULL if the node does not get printed
+ * @note Everything printing or counting graph nodes asks this, so the node
+ *       counts reserved for a class match the ones its print job uses.
+ */
+static waitui_ast_printer_print_function
+waitui_ast_printer_getPrintFunction(waitui_ast_node *node) {
+    unsigned int type = 0;
+
+    switch (waitui_ast_node_getNodeType(node)) {
+        case WAITUI_AST_NODE_TYPE_DEFINITION:
+            type = waitui_ast_definition_getDefinitionType(
+                    (waitui_ast_definition *) node);
+            if (type >= WAITUI_AST_PRINTER_LENGTH(
+                                waitui_ast_printer_definitionPrinters)) {
+                return NULL;
+            }
+            return waitui_ast_printer_definitionPrinters[type];
+        case WAITUI_AST_NODE_TYPE_EXPRESSION:
+            type = waitui_ast_expression_getExpressionType(
+                    (waitui_ast_expression *) node);
+            if (type >= WAITUI_AST_PRINTER_LENGTH(
+                                waitui_ast_printer_expressionPrinters)) {
+                return NULL;
+            }
+            return waitui_ast_printer_expressionPrinters[type];
+        default:
+            return NULL;
     }
 }
 
 /**
- * @brief Print the AST definition.
- * @param[in] definition The AST definition to print
+ * @brief Print the AST node.
+ * @param[in] node The AST node to print
  * @param[in] args The extra args for the callback call
  */
-static void
-waitui_ast_printer_printDefinition(waitui_ast_definition *definition,
-                                   void *args) {
-    switch (waitui_ast_definition_getDefinitionType(definition)) {
-        case WAITUI_AST_DEFINITION_TYPE_FORMAL:
-            waitui_ast_printer_printFormal((waitui_ast_formal *) definition,
-                                           args);
-            break;
-        case WAITUI_AST_DEFINITION_TYPE_PROPERTY:
-            waitui_ast_printer_printProperty((waitui_ast_property *) definition,
-                                             args);
-            break;
-        case WAITUI_AST_DEFINITION_TYPE_FUNCTION:
-            waitui_ast_printer_printFunction((waitui_ast_function *) definition,
-                                             args);
-            break;
-        case WAITUI_AST_DEFINITION_TYPE_CLASS:
-            waitui_ast_printer_printClass((waitui_ast_class *) definition,
-                                          args);
-            break;
-        case WAITUI_AST_DEFINITION_TYPE_PROGRAM:
-            waitui_ast_printer_printProgram((waitui_ast_program *) definition,
-                                            args);
-            break;
-        case WAITUI_AST_DEFINITION_TYPE_IMPORT:
-            waitui_ast_printer_printImport((waitui_ast_import *) definition,
-                                           args);
-            break;
-        case WAITUI_AST_DEFINITION_TYPE_NAMESPACE:
-            waitui_ast_printer_printNamespace(
-                    (waitui_ast_namespace *) definition, args);
-            break;
-        default:
-            waitui_log_trace("trying to print a definition with an undefined "
-                             "definition type");
-            break;
+static void waitui_ast_printer_printNode(waitui_ast_node *node, void *args) {
+    waitui_ast_printer_print_function print =
+            waitui_ast_printer_getPrintFunction(node);
+
+    if (print) { print(node, args); }
+}
+
+/**
+ * @brief Return whether the AST node gets printed as a graph node.
+ * @param[in] node The AST node to check
+ * @retval true The node and maybe its children get printed
+ * @retval false Neither the node nor its children get printed
+ */
+static bool waitui_ast_printer_isPrinted(waitui_ast_node *node) {
+    return waitui_ast_printer_getPrintFunction(node) != NULL;
+}
+
+/**
+ * @brief Reserve the node counts of the class and print the edge to it.
+ * @param[in,out] printer The printer with the jobs of the classes
+ * @return Skip the children, the job of the class prints them
+ * @note Everything the printer prints afterwards goes to the trailer of the
+ *       job, so the outputs concatenated in order form the whole graph.
+ */
+static waitui_ast_visit_action
+waitui_ast_printer_reserveClass(waitui_ast_printer *printer) {
+    waitui_ast_printer_job *job = NULL;
+    str title                   = STR_STATIC_INIT("class");
+
+    if (printer->jobIndex >= printer->jobs->length) {
+        printer->failed = true;
+        return WAITUI_AST_VISIT_ACTION_STOP;
     }
+
+    job            = &printer->jobs->jobs[printer->jobIndex++];
+    job->firstNode = printer->nodeCount;
+    printer->nodeCount += job->nodeCount;
+
+    waitui_ast_printer_printEdge(printer, &title, job->firstNode);
+    printer->output = job->trailer;
+
+    return WAITUI_AST_VISIT_ACTION_SKIP;
 }
 
 /**
- * @brief Print the AST expression.
- * @param[in] expression The AST expression to print
- * @param[in] args The extra args for the callback call
+ * @brief Print the visited AST node in pre order.
+ * @param[in] visit The visited AST node
+ * @param[in,out] args The printer
+ * @return Continue with the children, skip them if the node was not printed
  */
-static void
-waitui_ast_printer_printExpression(waitui_ast_expression *expression,
-                                   void *args) {
-    switch (waitui_ast_expression_getExpressionType(expression)) {
-        case WAITUI_AST_EXPRESSION_TYPE_INTEGER_LITERAL:
-            waitui_ast_printer_printIntegerLiteral(
-                    (waitui_ast_integer_literal *) expression, args);
-            break;
-        case WAITUI_AST_EXPRESSION_TYPE_BOOLEAN_LITERAL:
-            waitui_ast_printer_printBooleanLiteral(
-                    (waitui_ast_boolean_literal *) expression, args);
-            break;
-        case WAITUI_AST_EXPRESSION_TYPE_DECIMAL_LITERAL:
-            break;
-        case WAITUI_AST_EXPRESSION_TYPE_NULL_LITERAL:
-            waitui_ast_printer_printNullLiteral(
-                    (waitui_ast_null_literal *) expression, args);
-            break;
-        case WAITUI_AST_EXPRESSION_TYPE_STRING_LITERAL:
-            waitui_ast_printer_printStringLiteral(
-                    (waitui_ast_string_literal *) expression, args);
-            break;
-        case WAITUI_AST_EXPRESSION_TYPE_THIS_LITERAL:
-            waitui_ast_printer_printThisLiteral(
-                    (waitui_ast_this_literal *) expression, args);
-            break;
-        case WAITUI_AST_EXPRESSION_TYPE_ASSIGNMENT:
-            waitui_ast_printer_printAssignment(
-                    (waitui_ast_assignment *) expression, args);
-            break;
-        case WAITUI_AST_EXPRESSION_TYPE_REFERENCE:
-            waitui_ast_printer_printReference(
-                    (waitui_ast_reference *) expression, args);
-            break;
-        case WAITUI_AST_EXPRESSION_TYPE_CAST:
-            waitui_ast_printer_printCast((waitui_ast_cast *) expression, args);
-            break;
-        case WAITUI_AST_EXPRESSION_TYPE_INITIALIZATION:
-            waitui_ast_printer_printInitialization(
-                    (waitui_ast_initialization *) expression, args);
-            break;
-        case WAITUI_AST_EXPRESSION_TYPE_LET:
-            waitui_ast_printer_printLet((waitui_ast_let *) expression, args);
-            break;
-        case WAITUI_AST_EXPRESSION_TYPE_BLOCK:
-            waitui_ast_printer_printBlock((waitui_ast_block *) expression,
-                                          args);
-            break;
-        case WAITUI_AST_EXPRESSION_TYPE_CONSTRUCTOR_CALL:
-            waitui_ast_printer_printConstructorCall(
-                    (waitui_ast_constructor_call *) expression, args);
-            break;
-        case WAITUI_AST_EXPRESSION_TYPE_FUNCTION_CALL:
-            waitui_ast_printer_printFunctionCall(
-                    (waitui_ast_function_call *) expression, args);
-            break;
-        case WAITUI_AST_EXPRESSION_TYPE_SUPER_FUNCTION_CALL:
-            break;
-        case WAITUI_AST_EXPRESSION_TYPE_BINARY_EXPRESSION:
-            waitui_ast_printer_printBinaryExpression(
-                    (waitui_ast_binary_expression *) expression, args);
-            break;
-        case WAITUI_AST_EXPRESSION_TYPE_UNARY_EXPRESSION:
-            waitui_ast_printer_printUnaryExpression(
-                    (waitui_ast_unary_expression *) expression, args);
-            break;
-        case WAITUI_AST_EXPRESSION_TYPE_IF_ELSE:
-            waitui_ast_printer_printIfElse((waitui_ast_if_else *) expression,
-                                           args);
-            break;
-        case WAITUI_AST_EXPRESSION_TYPE_WHILE:
-            waitui_ast_printer_printWhile((waitui_ast_while *) expression,
-                                          args);
-            break;
-        case WAITUI_AST_EXPRESSION_TYPE_LAZY_EXPRESSION:
-            break;
-        case WAITUI_AST_EXPRESSION_TYPE_NATIVE_EXPRESSION:
-            break;
-        default:
-            waitui_log_trace("trying to print a expression with an undefined "
-                             "expression type");
-            break;
+static waitui_ast_visit_action
+waitui_ast_printer_preVisit(const waitui_ast_visit *visit, void *args) {
+    waitui_ast_printer *printer = (waitui_ast_printer *) args;
+    unsigned long int length    = printer->parentsLength;
+
+    printer->visit = visit;
+
+    if (printer->jobs &&
+        waitui_ast_node_getNodeType(visit->node) ==
+                WAITUI_AST_NODE_TYPE_DEFINITION &&
+        waitui_ast_definition_getDefinitionType(
+                (waitui_ast_definition *) visit->node) ==
+                WAITUI_AST_DEFINITION_TYPE_CLASS) {
+        return waitui_ast_printer_reserveClass(printer);
     }
+
+    waitui_ast_printer_printNode(visit->node, printer);
+
+    if (printer->failed) { return WAITUI_AST_VISIT_ACTION_STOP; }
+    if (printer->parentsLength == length) {
+        return WAITUI_AST_VISIT_ACTION_SKIP;
+    }
+    return WAITUI_AST_VISIT_ACTION_CONTINUE;
 }
 
 /**
- * @brief Print the AST node.
+ * @brief Leave the visited AST node in post order.
+ * @param[in] visit The visited AST node
+ * @param[in,out] args The printer
+ * @return Always continue
+ */
+static waitui_ast_visit_action
+waitui_ast_printer_postVisit(const waitui_ast_visit *visit, void *args) {
+    waitui_ast_printer *printer = (waitui_ast_printer *) args;
+
+    if (printer->parentsLength > 0 &&
+        printer->parents[printer->parentsLength - 1].node == visit->node) {
+        printer->parentsLength--;
+    }
+
+    return WAITUI_AST_VISIT_ACTION_CONTINUE;
+}
+
+/**
+ * @brief Print the AST node and everything below it.
+ * @param[in,out] printer The printer to print with
  * @param[in] node The AST node to print
- * @param[in] args The extra args for the callback call
  */
-static void waitui_ast_printer_printNode(waitui_ast_node *node, void *args) {
-    switch (waitui_ast_node_getNodeType(node)) {
-        case WAITUI_AST_NODE_TYPE_EXPRESSION:
-            waitui_ast_printer_printExpression((waitui_ast_expression *) node,
-                                               args);
-            break;
-        case WAITUI_AST_NODE_TYPE_DEFINITION:
-            waitui_ast_printer_printDefinition((waitui_ast_definition *) node,
-                                               args);
-            break;
-        default:
-            waitui_log_trace(
-                    "trying to print a node with an undefined node type");
-            break;
+static void waitui_ast_printer_printTree(waitui_ast_printer *printer,
+                                         waitui_ast_node *node) {
+    waitui_ast_visitor *visitor = NULL;
+
+    waitui_ast_visit_callbacks callbacks = {
+            .preVisitCallback  = waitui_ast_printer_preVisit,
+            .postVisitCallback = waitui_ast_printer_postVisit,
+    };
+
+    visitor = waitui_ast_visitor_new();
+    if (!visitor) {
+        printer->failed = true;
+        return;
     }
+
+    waitui_ast_visitor_visit(visitor, node, &callbacks, printer);
+
+    waitui_ast_visitor_destroy(&visitor);
 }
 
 /**
@@ -1334,17 +1283,133 @@ static void waitui_ast_printer_printNode(waitui_ast_node *node, void *args) {
 static void waitui_ast_printer_printAst(waitui_ast *ast, void *args) {
     waitui_ast_printer *printer = (waitui_ast_printer *) args;
 
-    if (!ast || !printer || !printer->outputFile || !printer->callbacks) {
+    if (!ast || !printer || !printer->output) { return; }
+
+    WAITUI_AST_PRINTER_APPEND(printer, "digraph AST {\n"
+                                       "\tconcentrate=true\n"
+                                       "\tnode [shape=plain]\n");
+
+    waitui_ast_printer_printTree(
+            printer, (waitui_ast_node *) waitui_ast_getProgram(ast));
+
+    WAITUI_AST_PRINTER_APPEND(printer, "}\n");
+}
+
+/**
+ * @brief Count the visited AST node if it gets printed.
+ * @param[in] visit The visited AST node
+ * @param[in,out] args The node count to increment
+ * @return Continue with the children, skip them if the node is not printed
+ */
+static waitui_ast_visit_action
+waitui_ast_printer_countVisit(const waitui_ast_visit *visit, void *args) {
+    unsigned long long *nodeCount = (unsigned long long *) args;
+
+    if (!waitui_ast_printer_isPrinted(visit->node)) {
+        return WAITUI_AST_VISIT_ACTION_SKIP;
+    }
+
+    (*nodeCount)++;
+
+    return WAITUI_AST_VISIT_ACTION_CONTINUE;
+}
+
+/**
+ * @brief Count the graph nodes of the class of the job.
+ * @param[in,out] args The jobs
+ * @param[in] index The index of the job
+ */
+static void waitui_ast_printer_countJob(void *args, unsigned long int index) {
+    waitui_ast_printer_job *job =
+            &((waitui_ast_printer_jobs *) args)->jobs[index];
+    waitui_ast_visitor *visitor = waitui_ast_visitor_new();
+
+    waitui_ast_visit_callbacks callbacks = {
+            .preVisitCallback = waitui_ast_printer_countVisit,
+    };
+
+    if (!visitor) {
+        job->failed = true;
         return;
     }
 
-    fprintf(printer->outputFile, "digraph AST {\n");
-    fprintf(printer->outputFile, "\tconcentrate=true\n");
-    fprintf(printer->outputFile, "\tnode [shape=plain]\n");
+    waitui_ast_visitor_visit(visitor, (waitui_ast_node *) job->class,
+                             &callbacks, &job->nodeCount);
+
+    waitui_ast_visitor_destroy(&visitor);
+}
+
+/**
+ * @brief Print the class of the job into its output.
+ * @param[in,out] args The jobs
+ * @param[in] index The index of the job
+ */
+static void waitui_ast_printer_printJob(void *args, unsigned long int index) {
+    waitui_ast_printer_job *job =
+            &((waitui_ast_printer_jobs *) args)->jobs[index];
 
-    waitui_ast_walk(ast, printer->callbacks, printer);
+    waitui_ast_printer printer = {
+            .output    = job->output,
+            .nodeCount = job->firstNode,
+    };
+
+    waitui_ast_printer_printTree(&printer, (waitui_ast_node *) job->class);
+    free(printer.parents);
+
+    if (printer.failed || waitui_output_hasFailed(job->output)) {
+        job->failed = true;
+    }
+}
 
-    fprintf(printer->outputFile, "}\n");
+/**
+ * @brief Destroy the jobs.
+ * @param[in,out] jobs The jobs to destroy
+ */
+static void waitui_ast_printer_destroyJobs(waitui_ast_printer_jobs *jobs) {
+    for (unsigned long int i = 0; i < jobs->length; ++i) {
+        waitui_output_destroy(&jobs->jobs[i].output);
+        waitui_output_destroy(&jobs->jobs[i].trailer);
+    }
+    free(jobs->jobs);
+    jobs->jobs   = NULL;
+    jobs->length = 0;
+}
+
+/**
+ * @brief Create a job for every class of the AST in the order of printing.
+ * @param[in] ast The AST to get the classes of
+ * @param[out] jobs The jobs to fill
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ */
+static int waitui_ast_printer_createJobs(waitui_ast *ast,
+                                         waitui_ast_printer_jobs *jobs) {
+    waitui_ast_namespace_vector *namespaces =
+            waitui_ast_program_getNamespaces(waitui_ast_getProgram(ast));
+    unsigned long int length = 0;
+
+    WAITUI_VECTOR_FOREACH(waitui_ast_namespace, namespace, namespaces) {
+        length += waitui_ast_class_vector_getLength(
+                waitui_ast_namespace_getClasses(namespace));
+    }
+    if (length == 0) { return 1; }
+
+    jobs->jobs = calloc(length, sizeof(*jobs->jobs));
+    if (!jobs->jobs) { return 0; }
+
+    WAITUI_VECTOR_FOREACH(waitui_ast_namespace, namespace, namespaces) {
+        WAITUI_VECTOR_FOREACH(waitui_ast_class, class,
+                              waitui_ast_namespace_getClasses(namespace)) {
+            waitui_ast_printer_job *job = &jobs->jobs[jobs->length++];
+
+            job->class   = class;
+            job->output  = waitui_output_newInMemory();
+            job->trailer = waitui_output_newInMemory();
+            if (!job->output || !job->trailer) { return 0; }
+        }
+    }
+
+    return 1;
 }
 
 
@@ -1357,17 +1422,80 @@ void waitui_ast_printer_generateGraph(const waitui_ast *ast, FILE *file) {
 
     if (!ast || !file) { return; }
 
-    waitui_ast_callbacks callbacks = {
-            .preNodeCallback  = NULL,
-            .nodeCallback     = waitui_ast_printer_printNode,
-            .postNodeCallback = NULL,
-    };
     waitui_ast_printer printer = {
-            .callbacks  = &callbacks,
-            .outputFile = file,
+            .output = waitui_output_new(file),
     };
 
+    if (!printer.output) {
+        waitui_log_error("could not allocate memory for the output");
+        return;
+    }
+
     waitui_ast_printer_printAst((waitui_ast *) ast, &printer);
+    free(printer.parents);
+
+    if (!waitui_output_flush(printer.output)) {
+        waitui_log_error("could not write the waitui_ast graph");
+    }
+    waitui_output_destroy(&printer.output);
 
     waitui_log_trace("end generating the waitui_ast graph");
+}
+
+void waitui_ast_printer_generateGraphParallel(const waitui_ast *ast,
+                                              FILE *file,
+                                              waitui_threadpool *threadpool) {
+    waitui_ast_printer_jobs jobs = {0};
+    waitui_output *output        = NULL;
+    bool failed                  = false;
+
+    if (!ast || !file) { return; }
+
+    if (!threadpool || waitui_threadpool_getThreadCount(threadpool) < 2 ||
+        !waitui_ast_printer_createJobs((waitui_ast *) ast, &jobs) ||
+        jobs.length < 2) {
+        waitui_ast_printer_destroyJobs(&jobs);
+        waitui_ast_printer_generateGraph(ast, file);
+        return;
+    }
+
+    waitui_log_trace("start generating the waitui_ast graph in parallel");
+
+    waitui_threadpool_run(threadpool, jobs.length, waitui_ast_printer_countJob,
+                          &jobs);
+    for (unsigned long int i = 0; i < jobs.length; ++i) {
+        if (jobs.jobs[i].failed) { failed = true; }
+    }
+
+    if (!failed) { output = waitui_output_new(file); }
+    if (!output) {
+        waitui_log_error("could not allocate memory for the output");
+        waitui_ast_printer_destroyJobs(&jobs);
+        return;
+    }
+
+    waitui_ast_printer printer = {
+            .output = output,
+            .jobs   = &jobs,
+    };
+
+    waitui_ast_printer_printAst((waitui_ast *) ast, &printer);
+    free(printer.parents);
+
+    waitui_threadpool_run(threadpool, jobs.length, waitui_ast_printer_printJob,
+                          &jobs);
+
+    for (unsigned long int i = 0; i < jobs.length; ++i) {
+        if (jobs.jobs[i].failed) { failed = true; }
+        waitui_output_appendOutput(output, jobs.jobs[i].output);
+        waitui_output_appendOutput(output, jobs.jobs[i].trailer);
+    }
+
+    if (failed || printer.failed || !waitui_output_flush(output)) {
+        waitui_log_error("could not write the waitui_ast graph");
+    }
+    waitui_output_destroy(&output);
+    waitui_ast_printer_destroyJobs(&jobs);
+
+    waitui_log_trace("end generating the waitui_ast graph in parallel");
 }
\ No newline at end of file
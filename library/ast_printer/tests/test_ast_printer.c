@@ -0,0 +1,166 @@
+/**
+ * @file test_ast_printer.c
+ * @author rick
+ * @date 17.10.26
+ * @brief Test for the AST printer implementation
+ */
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <cmocka.h>
+
+#include "waitui/ast_printer.h"
+
+#include <waitui/log.h>
+#include <waitui/parser.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct graph {
+    char *data;
+    size_t size;
+} graph;
+
+/**
+ * The classes hold nodes which are not printed, like decimal literals, super
+ * function calls, lazy and native expressions, between printed ones.
+ */
+static const char source[] =
+        "namespace org.test\n"
+        "\n"
+        "import org.other\n"
+        "import org.more as More\n"
+        "\n"
+        "class Base(start: Int) {\n"
+        "    var count: Int = start\n"
+        "    var name = \"base\"\n"
+        "\n"
+        "    abstract public func area(): Int\n"
+        "    protected func scale(lazy factor: Int): Int = count * factor\n"
+        "}\n"
+        "\n"
+        "class Square(side: Int) extends Base(side) {\n"
+        "    final overwrite public func area(): Int = {\n"
+        "        let total: Int = 0, step = 1 in {\n"
+        "            while (total < side * side) total += step\n"
+        "            if (total == 0 || !true) -1 else total\n"
+        "        }\n"
+        "    }\n"
+        "    public func ratio(): Decimal = 1.5e3 / 0.25\n"
+        "    public func copy(): Square = new Square(super.area() as Int)\n"
+        "    public func print(): Null = native;\n"
+        "    private func nothing(): Null = this.scale(++count ~ null)\n"
+        "}\n"
+        "\n"
+        "class Empty {\n"
+        "}\n"
+        "\n"
+        "class Circle(radius: Int) extends Base(radius) {\n"
+        "    overwrite public func area(): Int = 3 * radius * radius\n"
+        "    public func grow(): Circle = new Circle(this.scale(2))\n"
+        "}\n";
+
+static waitui_ast *ast = NULL;
+
+static graph generate_graph(waitui_threadpool *threadpool) {
+    graph result = {0};
+    FILE *file   = open_memstream(&result.data, &result.size);
+
+    assert_non_null(file);
+    if (threadpool) {
+        waitui_ast_printer_generateGraphParallel(ast, file, threadpool);
+    } else {
+        waitui_ast_printer_generateGraph(ast, file);
+    }
+    fclose(file);
+
+    return result;
+}
+
+static int setup(void **state) {
+    str sourceFileName = STR_STATIC_INIT("test_ast_printer.wai");
+    str sourceText     = {.s = (char *) source, .len = sizeof(source) - 1};
+    str workDirectory  = STR_STATIC_INIT("/tmp");
+    parser *parser     = NULL;
+
+    (void) state; /* unused */
+
+    waitui_log_setQuiet(true);
+
+    parser = parser_new_from_source(sourceFileName, sourceText, workDirectory,
+                                    0);
+    if (!parser) { return -1; }
+    if (parser_parse(parser)) { ast = parser_get_ast(parser); }
+    parser_destroy(&parser);
+
+    return ast ? 0 : -1;
+}
+
+static int teardown(void **state) {
+    (void) state; /* unused */
+
+    ast_destroy(&ast);
+
+    return 0;
+}
+
+static void test_ast_printer_parallel_matches_serial(void **state) {
+    (void) state; /* unused */
+
+    static const unsigned long int threadCounts[] = {2, 3, 8};
+    graph expected = generate_graph(NULL);
+
+    assert_true(expected.size > 0);
+    assert_non_null(strstr(expected.data, "digraph AST {\n"));
+
+    for (size_t i = 0; i < sizeof(threadCounts) / sizeof(*threadCounts); ++i) {
+        waitui_threadpool *threadpool = waitui_threadpool_new(threadCounts[i]);
+        graph actual                  = {0};
+
+        assert_non_null(threadpool);
+        assert_true(waitui_threadpool_getThreadCount(threadpool) >= 2);
+
+        // the classes are printed by the jobs, the graph stays the same
+        actual = generate_graph(threadpool);
+        assert_int_equal(actual.size, expected.size);
+        assert_memory_equal(actual.data, expected.data, expected.size);
+
+        free(actual.data);
+        waitui_threadpool_destroy(&threadpool);
+    }
+
+    free(expected.data);
+}
+
+static void test_ast_printer_single_thread(void **state) {
+    (void) state; /* unused */
+
+    waitui_threadpool *threadpool = waitui_threadpool_new(1);
+    graph expected                = generate_graph(NULL);
+    graph actual                  = {0};
+
+    assert_non_null(threadpool);
+
+    // with one thread the graph is printed serially
+    actual = generate_graph(threadpool);
+    assert_int_equal(actual.size, expected.size);
+    assert_memory_equal(actual.data, expected.data, expected.size);
+
+    free(actual.data);
+    free(expected.data);
+    waitui_threadpool_destroy(&threadpool);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test(test_ast_printer_parallel_matches_serial),
+            cmocka_unit_test(test_ast_printer_single_thread),
+    };
+
+    return cmocka_run_group_tests(tests, setup, teardown);
+}
@@ -0,0 +1,118 @@
+/**
+ * @file build_cache.h
+ * @author rick
+ * @date 17.10.26
+ * @brief File for the Build cache implementation
+ */
+
+#ifndef WAITUI_BUILD_CACHE_H
+#define WAITUI_BUILD_CACHE_H
+
+#include <waitui/str.h>
+
+#include <stdint.h>
+
+
+// -----------------------------------------------------------------------------
+//  Public defines
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The version of the entry format, entries of other versions miss.
+ */
+#define WAITUI_BUILD_CACHE_VERSION 2
+
+
+// -----------------------------------------------------------------------------
+//  Public types
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Type representing a Build cache.
+ * @note The Build cache keeps the results of compiling a source file in a
+ *       directory, keyed by a hash of the canonical path and the contents of
+ *       the file and the options of the run, which hold the search paths.
+ *       The imports are only resolved by parsing, so they are not part of the
+ *       key: an entry records the resolved path and the content hash of every
+ *       module the source file depends on and misses when one of them changed
+ *       or is gone. A module added to a search path in front of the recorded
+ *       one is not noticed, clear the directory after such a change. The
+ *       content hash of a file is computed once per run.
+ */
+typedef struct waitui_build_cache waitui_build_cache;
+
+/**
+ * @brief Type for the results of compiling a source file.
+ * @note The binary AST image also holds the symbols the source file exports.
+ */
+typedef struct waitui_build_cache_entry {
+    str diagnostics;
+    str graph;
+    str binary;
+} waitui_build_cache_entry;
+
+
+// -----------------------------------------------------------------------------
+//  Public functions
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Create a Build cache for the directory.
+ * @param[in] directory The directory to keep the entries in
+ * @param[in] options The version and options of the run, part of every key
+ * @return A pointer to waitui_build_cache or NULL if creation failed
+ * @note The directory is created when it does not exist yet.
+ */
+extern waitui_build_cache *waitui_build_cache_new(str directory, str options);
+
+/**
+ * @brief Destroy a Build cache, the entries stay in the directory.
+ * @param[in,out] this The Build cache to destroy
+ */
+extern void waitui_build_cache_destroy(waitui_build_cache **this);
+
+/**
+ * @brief Load the results for the source file out of the Build cache.
+ * @param[in,out] this The Build cache to load from
+ * @param[in] sourceFileName The source file to load the results for
+ * @param[out] key The key of the source file, for waitui_build_cache_store
+ * @param[out] entry The results of the source file
+ * @retval 1 Hit, the entry has to be freed with waitui_build_cache_entry_free
+ * @retval 0 Miss, the key is 0 if the source file could not be read
+ */
+extern int waitui_build_cache_load(waitui_build_cache *this,
+                                   str sourceFileName, uint64_t *key,
+                                   waitui_build_cache_entry *entry);
+
+/**
+ * @brief Store the results for the key in the Build cache.
+ * @param[in,out] this The Build cache to store in
+ * @param[in] key The key returned by waitui_build_cache_load
+ * @param[in] dependencies The canonical paths of the modules depended on
+ * @param[in] dependencyCount The number of dependencies
+ * @param[in] entry The results to store
+ * @retval 1 Ok
+ * @retval 0 A dependency could not be read or writing the entry failed
+ * @note The entry is written to a temporary file and renamed, so concurrent
+ *       runs never see a partial entry.
+ */
+extern int waitui_build_cache_store(waitui_build_cache *this, uint64_t key,
+                                    const str *dependencies,
+                                    unsigned long int dependencyCount,
+                                    const waitui_build_cache_entry *entry);
+
+/**
+ * @brief Free the results loaded out of the Build cache.
+ * @param[in,out] this The results to free
+ */
+extern void waitui_build_cache_entry_free(waitui_build_cache_entry *this);
+
+/**
+ * @brief Return the number of hits of the Build cache.
+ * @param[in] this The Build cache to ask
+ * @return The number of hits
+ */
+extern unsigned long int
+waitui_build_cache_getHitCount(waitui_build_cache *this);
+
+#endif//WAITUI_BUILD_CACHE_H
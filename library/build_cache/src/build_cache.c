@@ -0,0 +1,567 @@
+/**
+ * @file build_cache.c
+ * @author rick
+ * @date 17.10.26
+ * @brief File for the Build cache implementation
+ */
+
+#include "waitui/build_cache.h"
+
+#include <waitui/hashtable.h>
+#include <waitui/log.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+// -----------------------------------------------------------------------------
+//  Local defines
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The magic bytes at the start of every entry.
+ */
+#define WAITUI_BUILD_CACHE_MAGIC "WBCE"
+
+/**
+ * @brief The extension of the entry files.
+ */
+#define WAITUI_BUILD_CACHE_EXTENSION ".wbc"
+
+
+// -----------------------------------------------------------------------------
+//  Local types
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Type for the content hash of a file read during the run.
+ */
+typedef struct waitui_build_cache_file {
+    uint64_t hash;
+    uint64_t size;
+} waitui_build_cache_file;
+
+static void waitui_build_cache_file_destroy(waitui_build_cache_file **this);
+
+CREATE_HASHTABLE_TYPE_CUSTOM(INTERFACE, waitui_build_cache_file,
+                             waitui_build_cache_file,
+                             waitui_build_cache_file_destroy)
+
+/**
+ * @brief Type for the header at the start of every entry.
+ * @note The header is followed by the dependencies, each a
+ *       waitui_build_cache_dependency and the bytes of its path, and then by
+ *       the diagnostics, the graph and the binary AST, each a uint64_t length
+ *       and the bytes. Entries are only read by the machine writing them, so
+ *       they are in native byte order.
+ */
+typedef struct waitui_build_cache_header {
+    char magic[4];
+    uint32_t version;
+    uint64_t key;
+    uint64_t dependencyCount;
+} waitui_build_cache_header;
+
+/**
+ * @brief Type for a dependency of an entry.
+ */
+typedef struct waitui_build_cache_dependency {
+    uint64_t hash;
+    uint64_t size;
+    uint64_t pathLength;
+} waitui_build_cache_dependency;
+
+/**
+ * @brief Type for reading an entry out of memory.
+ */
+typedef struct waitui_build_cache_reader {
+    const unsigned char *data;
+    size_t size;
+    size_t offset;
+} waitui_build_cache_reader;
+
+/**
+ * @brief Struct representing a Build cache.
+ * @note The content hashes are kept for the run, a module imported by many
+ *       source files is only read once.
+ */
+struct waitui_build_cache {
+    str directory;
+    uint64_t optionsHash;
+    waitui_build_cache_file_hashtable *files;
+    pthread_mutex_t mutex;
+    unsigned long int hitCount;
+};
+
+
+// -----------------------------------------------------------------------------
+//  Local functions
+// -----------------------------------------------------------------------------
+
+CREATE_HASHTABLE_TYPE_CUSTOM(IMPLEMENTATION, waitui_build_cache_file,
+                             waitui_build_cache_file,
+                             waitui_build_cache_file_destroy)
+
+/**
+ * @brief Destroy the content hash of a file.
+ * @param[in,out] this The content hash to destroy
+ */
+static void waitui_build_cache_file_destroy(waitui_build_cache_file **this) {
+    if (!this || !(*this)) { return; }
+
+    free(*this);
+    *this = NULL;
+}
+
+/**
+ * @brief Compute the content hash of the file.
+ * @param[in] fileName The file to hash
+ * @param[out] file The content hash of the file
+ * @retval 1 Ok
+ * @retval 0 The file could not be read
+ */
+static int waitui_build_cache_hashFile(str fileName,
+                                       waitui_build_cache_file *file) {
+    char path[PATH_MAX];
+    struct stat fileStat = {0};
+    void *data           = MAP_FAILED;
+    int fd               = -1;
+    int written          = 0;
+
+    written = snprintf(path, sizeof(path), "%.*s", STR_FMT(&fileName));
+    if (written < 0 || (size_t) written >= sizeof(path)) { return 0; }
+
+    fd = open(path, O_RDONLY);
+    if (fd == -1) { return 0; }
+
+    if (fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode)) {
+        close(fd);
+        return 0;
+    }
+
+    file->size = (uint64_t) fileStat.st_size;
+    file->hash = 0;
+
+    if (fileStat.st_size > 0) {
+        data = mmap(NULL, (size_t) fileStat.st_size, PROT_READ, MAP_PRIVATE,
+                    fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            return 0;
+        }
+        file->hash = hashtable_hash((str){.s   = data,
+                                          .len = (size_t) fileStat.st_size});
+        munmap(data, (size_t) fileStat.st_size);
+    }
+    close(fd);
+
+    return 1;
+}
+
+/**
+ * @brief Return the content hash of the file, hash it on first use.
+ * @param[in,out] this The Build cache keeping the content hashes
+ * @param[in] fileName The file to hash
+ * @param[out] file The content hash of the file
+ * @retval 1 Ok
+ * @retval 0 The file could not be read or memory allocation failed
+ */
+static int waitui_build_cache_getFile(waitui_build_cache *this, str fileName,
+                                      waitui_build_cache_file *file) {
+    waitui_build_cache_file *known = NULL;
+
+    pthread_mutex_lock(&this->mutex);
+    known = waitui_build_cache_file_hashtable_lookup(this->files, fileName);
+    if (known) { *file = *known; }
+    pthread_mutex_unlock(&this->mutex);
+
+    if (known) { return 1; }
+
+    if (!waitui_build_cache_hashFile(fileName, file)) { return 0; }
+
+    known = malloc(sizeof(*known));
+    if (!known) { return 0; }
+    *known = *file;
+
+    // another thread may have hashed the file meanwhile, both hashes are equal
+    pthread_mutex_lock(&this->mutex);
+    if (waitui_build_cache_file_hashtable_has(this->files, fileName) ||
+        !waitui_build_cache_file_hashtable_insert(this->files, fileName,
+                                                  known)) {
+        free(known);
+    }
+    pthread_mutex_unlock(&this->mutex);
+
+    return 1;
+}
+
+/**
+ * @brief Resolve the canonical path of the file.
+ * @param[in] fileName The file to resolve
+ * @param[out] path The buffer of PATH_MAX bytes for the canonical path
+ * @retval 1 Ok
+ * @retval 0 The file could not be resolved
+ */
+static int waitui_build_cache_getCanonicalPath(str fileName, char *path) {
+    char name[PATH_MAX];
+    int written = snprintf(name, sizeof(name), "%.*s", STR_FMT(&fileName));
+
+    if (written < 0 || (size_t) written >= sizeof(name)) { return 0; }
+
+    return realpath(name, path) != NULL;
+}
+
+/**
+ * @brief Build the file name of the entry for the key.
+ * @param[in] this The Build cache with the directory
+ * @param[in] key The key of the entry
+ * @param[out] path The buffer of PATH_MAX bytes for the file name
+ * @retval 1 Ok
+ * @retval 0 The file name is too long
+ */
+static int waitui_build_cache_getEntryName(const waitui_build_cache *this,
+                                           uint64_t key, char *path) {
+    int written = snprintf(path, PATH_MAX, "%.*s/%016" PRIx64 "%s",
+                           STR_FMT(&this->directory), key,
+                           WAITUI_BUILD_CACHE_EXTENSION);
+
+    return written >= 0 && written < PATH_MAX;
+}
+
+/**
+ * @brief Read the next bytes of the entry.
+ * @param[in,out] this The reader of the entry
+ * @param[in] size The number of bytes to read
+ * @return A pointer to the bytes or NULL if the entry is too short
+ */
+static const void *waitui_build_cache_reader_next(
+        waitui_build_cache_reader *this, uint64_t size) {
+    const void *result = NULL;
+
+    if (size > this->size - this->offset) { return NULL; }
+
+    result = this->data + this->offset;
+    this->offset += (size_t) size;
+
+    return result;
+}
+
+/**
+ * @brief Read a length and the bytes following it into a new string.
+ * @param[in,out] this The reader of the entry
+ * @param[out] value The string to copy the bytes into
+ * @retval 1 Ok
+ * @retval 0 The entry is too short or memory allocation failed
+ */
+static int waitui_build_cache_reader_nextStr(waitui_build_cache_reader *this,
+                                             str *value) {
+    const unsigned char *bytes = NULL;
+    str view                   = STR_NULL_INIT;
+    uint64_t length            = 0;
+
+    bytes = waitui_build_cache_reader_next(this, sizeof(length));
+    if (!bytes) { return 0; }
+    memcpy(&length, bytes, sizeof(length));
+
+    view.s = (char *) waitui_build_cache_reader_next(this, length);
+    if (!view.s) { return 0; }
+    view.len = (unsigned long int) length;
+
+    if (view.len == 0) { return 1; }
+
+    STR_COPY(value, &view);
+
+    return value->s != NULL;
+}
+
+/**
+ * @brief Check the entry and read its results.
+ * @param[in,out] this The Build cache to check the dependencies with
+ * @param[in] key The key the entry is expected to have
+ * @param[in] data The entry
+ * @param[in] size The size of the entry
+ * @param[out] entry The results of the entry
+ * @retval 1 The entry is valid
+ * @retval 0 The entry is broken or a dependency changed
+ */
+static int waitui_build_cache_readEntry(waitui_build_cache *this,
+                                        uint64_t key, const void *data,
+                                        size_t size,
+                                        waitui_build_cache_entry *entry) {
+    waitui_build_cache_reader reader = {data, size, 0};
+    waitui_build_cache_header header = {0};
+    const void *bytes                = NULL;
+
+    bytes = waitui_build_cache_reader_next(&reader, sizeof(header));
+    if (!bytes) { return 0; }
+    memcpy(&header, bytes, sizeof(header));
+
+    if (memcmp(header.magic, WAITUI_BUILD_CACHE_MAGIC, sizeof(header.magic)) !=
+                0 ||
+        header.version != WAITUI_BUILD_CACHE_VERSION || header.key != key) {
+        return 0;
+    }
+
+    for (uint64_t i = 0; i < header.dependencyCount; ++i) {
+        waitui_build_cache_dependency dependency = {0};
+        waitui_build_cache_file file             = {0};
+        str path                                 = STR_NULL_INIT;
+
+        bytes = waitui_build_cache_reader_next(&reader, sizeof(dependency));
+        if (!bytes) { return 0; }
+        memcpy(&dependency, bytes, sizeof(dependency));
+
+        path.s = (char *) waitui_build_cache_reader_next(&reader,
+                                                         dependency.pathLength);
+        if (!path.s) { return 0; }
+        path.len = (unsigned long int) dependency.pathLength;
+
+        if (!waitui_build_cache_getFile(this, path, &file) ||
+            file.hash != dependency.hash || file.size != dependency.size) {
+            waitui_log_debug("build cache dependency '%.*s' changed",
+                             STR_FMT(&path));
+            return 0;
+        }
+    }
+
+    if (!waitui_build_cache_reader_nextStr(&reader, &entry->diagnostics) ||
+        !waitui_build_cache_reader_nextStr(&reader, &entry->graph) ||
+        !waitui_build_cache_reader_nextStr(&reader, &entry->binary) ||
+        reader.offset != reader.size) {
+        waitui_build_cache_entry_free(entry);
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Write a length and the bytes of the string.
+ * @param[in,out] file The file to write to
+ * @param[in] value The string to write
+ * @retval 1 Ok
+ * @retval 0 Writing failed
+ */
+static int waitui_build_cache_writeStr(FILE *file, str value) {
+    uint64_t length = value.len;
+
+    if (fwrite(&length, sizeof(length), 1, file) != 1) { return 0; }
+    if (length == 0) { return 1; }
+
+    return fwrite(value.s, 1, value.len, file) == value.len;
+}
+
+
+// -----------------------------------------------------------------------------
+//  Public functions
+// -----------------------------------------------------------------------------
+
+waitui_build_cache *waitui_build_cache_new(str directory, str options) {
+    char path[PATH_MAX];
+    waitui_build_cache *this = NULL;
+    int written              = 0;
+
+    waitui_log_trace("creating new build cache");
+
+    written = snprintf(path, sizeof(path), "%.*s", STR_FMT(&directory));
+    if (written <= 0 || (size_t) written >= sizeof(path)) { return NULL; }
+
+    if (mkdir(path, 0777) != 0 && errno != EEXIST) {
+        waitui_log_error("could not create build cache directory: '%s'",
+                         path);
+        return NULL;
+    }
+
+    this = calloc(1, sizeof(*this));
+    if (!this) { return NULL; }
+
+    STR_COPY_WITH_NUL(&this->directory, &directory);
+    if (!this->directory.s) {
+        waitui_build_cache_destroy(&this);
+        return NULL;
+    }
+
+    this->optionsHash = hashtable_hash(options);
+
+    this->files = waitui_build_cache_file_hashtable_new(256);
+    if (!this->files) {
+        waitui_build_cache_destroy(&this);
+        return NULL;
+    }
+
+    pthread_mutex_init(&this->mutex, NULL);
+
+    waitui_log_trace("new build cache successful created");
+
+    return this;
+}
+
+void waitui_build_cache_destroy(waitui_build_cache **this) {
+    waitui_log_trace("destroying build cache");
+
+    if (!this || !(*this)) { return; }
+
+    if ((*this)->files) {
+        waitui_build_cache_file_hashtable_destroy(&(*this)->files);
+        pthread_mutex_destroy(&(*this)->mutex);
+    }
+    STR_FREE(&(*this)->directory);
+
+    free(*this);
+    *this = NULL;
+
+    waitui_log_trace("build cache successful destroyed");
+}
+
+int waitui_build_cache_load(waitui_build_cache *this, str sourceFileName,
+                            uint64_t *key, waitui_build_cache_entry *entry) {
+    char path[PATH_MAX];
+    uint64_t parts[4];
+    waitui_build_cache_file file = {0};
+    struct stat entryStat        = {0};
+    void *data                   = MAP_FAILED;
+    int fd                       = -1;
+    int result                   = 0;
+
+    if (!this || !key || !entry) { return 0; }
+
+    *key = 0;
+    memset(entry, 0, sizeof(*entry));
+
+    if (!waitui_build_cache_getFile(this, sourceFileName, &file) ||
+        !waitui_build_cache_getCanonicalPath(sourceFileName, path)) {
+        return 0;
+    }
+
+    // equal files in different directories differ in their results
+    parts[0] = this->optionsHash;
+    parts[1] = hashtable_hash((str){.s = path, .len = strlen(path)});
+    parts[2] = file.hash;
+    parts[3] = file.size;
+    *key     = hashtable_hash((str){.s = (char *) parts, .len = sizeof(parts)});
+
+    if (!waitui_build_cache_getEntryName(this, *key, path)) { return 0; }
+
+    fd = open(path, O_RDONLY);
+    if (fd == -1) { return 0; }
+
+    if (fstat(fd, &entryStat) == 0 && entryStat.st_size > 0) {
+        data = mmap(NULL, (size_t) entryStat.st_size, PROT_READ, MAP_PRIVATE,
+                    fd, 0);
+    }
+    close(fd);
+    if (data == MAP_FAILED) { return 0; }
+
+    result = waitui_build_cache_readEntry(this, *key, data,
+                                          (size_t) entryStat.st_size, entry);
+    munmap(data, (size_t) entryStat.st_size);
+
+    if (result) {
+        pthread_mutex_lock(&this->mutex);
+        this->hitCount++;
+        pthread_mutex_unlock(&this->mutex);
+    }
+
+    return result;
+}
+
+int waitui_build_cache_store(waitui_build_cache *this, uint64_t key,
+                             const str *dependencies,
+                             unsigned long int dependencyCount,
+                             const waitui_build_cache_entry *entry) {
+    char path[PATH_MAX];
+    char temporaryPath[PATH_MAX];
+    waitui_build_cache_header header = {0};
+    FILE *file                       = NULL;
+    int fd                           = -1;
+    int result                       = 1;
+
+    if (!this || !entry || (!dependencies && dependencyCount > 0)) {
+        return 0;
+    }
+
+    if (!waitui_build_cache_getEntryName(this, key, path) ||
+        snprintf(temporaryPath, sizeof(temporaryPath), "%s.XXXXXX", path) >=
+                (int) sizeof(temporaryPath)) {
+        return 0;
+    }
+
+    fd = mkstemp(temporaryPath);
+    if (fd == -1) { return 0; }
+
+    file = fdopen(fd, "wb");
+    if (!file) {
+        close(fd);
+        unlink(temporaryPath);
+        return 0;
+    }
+
+    memcpy(header.magic, WAITUI_BUILD_CACHE_MAGIC, sizeof(header.magic));
+    header.version         = WAITUI_BUILD_CACHE_VERSION;
+    header.key             = key;
+    header.dependencyCount = dependencyCount;
+
+    result = fwrite(&header, sizeof(header), 1, file) == 1;
+
+    for (unsigned long int i = 0; result && i < dependencyCount; ++i) {
+        waitui_build_cache_dependency dependency = {0};
+        waitui_build_cache_file dependencyFile   = {0};
+
+        if (!waitui_build_cache_getFile(this, dependencies[i],
+                                        &dependencyFile)) {
+            result = 0;
+            break;
+        }
+
+        dependency.hash       = dependencyFile.hash;
+        dependency.size       = dependencyFile.size;
+        dependency.pathLength = dependencies[i].len;
+
+        result = fwrite(&dependency, sizeof(dependency), 1, file) == 1 &&
+                 fwrite(dependencies[i].s, 1, dependencies[i].len, file) ==
+                         dependencies[i].len;
+    }
+
+    result = result && waitui_build_cache_writeStr(file, entry->diagnostics) &&
+             waitui_build_cache_writeStr(file, entry->graph) &&
+             waitui_build_cache_writeStr(file, entry->binary);
+
+    if (fclose(file) != 0) { result = 0; }
+
+    if (!result || rename(temporaryPath, path) != 0) {
+        unlink(temporaryPath);
+        return 0;
+    }
+
+    return 1;
+}
+
+void waitui_build_cache_entry_free(waitui_build_cache_entry *this) {
+    if (!this) { return; }
+
+    STR_FREE(&this->diagnostics);
+    STR_FREE(&this->graph);
+    STR_FREE(&this->binary);
+}
+
+unsigned long int
+waitui_build_cache_getHitCount(waitui_build_cache *this) {
+    unsigned long int hitCount = 0;
+
+    if (!this) { return 0; }
+
+    pthread_mutex_lock(&this->mutex);
+    hitCount = this->hitCount;
+    pthread_mutex_unlock(&this->mutex);
+
+    return hitCount;
+}
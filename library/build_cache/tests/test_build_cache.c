@@ -0,0 +1,359 @@
+/**
+ * @file test_build_cache.c
+ * @author rick
+ * @date 17.10.26
+ * @brief Test for the Build cache implementation
+ */
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <cmocka.h>
+
+#include "waitui/build_cache.h"
+
+#include <waitui/log.h>
+
+#include <dirent.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * The magic, the version, the key and the dependency count of an entry.
+ */
+#define HEADER_SIZE 24
+
+static char directory[] = "/tmp/waitui-test_build_cache-XXXXXX";
+
+static const waitui_build_cache_entry results = {
+        .diagnostics = STR_STATIC_INIT("warning: unused import\n"),
+        .graph       = STR_STATIC_INIT("digraph {}\n"),
+        .binary      = STR_STATIC_INIT("WAST"),
+};
+
+static str get_path(char *path, const char *name) {
+    str result = STR_NULL_INIT;
+
+    snprintf(path, 256, "%s/%s", directory, name);
+    result.s   = path;
+    result.len = strlen(path);
+
+    return result;
+}
+
+static void write_file(const char *name, const char *content) {
+    char path[256];
+    FILE *file = NULL;
+
+    get_path(path, name);
+    file = fopen(path, "w");
+    assert_non_null(file);
+    fputs(content, file);
+    assert_int_equal(fclose(file), 0);
+}
+
+static waitui_build_cache *new_cache(const char *options) {
+    char path[256];
+    str optionsStr = STR_NULL_INIT;
+
+    optionsStr.s   = (char *) options;
+    optionsStr.len = strlen(options);
+
+    return waitui_build_cache_new(get_path(path, "cache"), optionsStr);
+}
+
+static void assert_entry_equal(const waitui_build_cache_entry *entry,
+                               const waitui_build_cache_entry *expected) {
+    assert_int_equal(entry->diagnostics.len, expected->diagnostics.len);
+    assert_memory_equal(entry->diagnostics.s, expected->diagnostics.s,
+                        expected->diagnostics.len);
+    assert_int_equal(entry->graph.len, expected->graph.len);
+    assert_memory_equal(entry->graph.s, expected->graph.s, expected->graph.len);
+    assert_int_equal(entry->binary.len, expected->binary.len);
+    assert_memory_equal(entry->binary.s, expected->binary.s,
+                        expected->binary.len);
+}
+
+/**
+ * Load the source file, which has to miss, and store the results for it.
+ */
+static uint64_t store_source(waitui_build_cache *cache, const char *name,
+                             const str *dependencies,
+                             unsigned long int dependencyCount) {
+    char path[256];
+    waitui_build_cache_entry entry = {0};
+    uint64_t key                   = 0;
+
+    assert_false(waitui_build_cache_load(cache, get_path(path, name), &key,
+                                         &entry));
+    assert_int_not_equal(key, 0);
+    assert_true(waitui_build_cache_store(cache, key, dependencies,
+                                         dependencyCount, &results));
+
+    return key;
+}
+
+static int load_source(waitui_build_cache *cache, const char *name,
+                       uint64_t *key) {
+    char path[256];
+    waitui_build_cache_entry entry = {0};
+    uint64_t ignored               = 0;
+    int result                     = 0;
+
+    result = waitui_build_cache_load(cache, get_path(path, name),
+                                     key ? key : &ignored, &entry);
+    if (result) { assert_entry_equal(&entry, &results); }
+    waitui_build_cache_entry_free(&entry);
+
+    return result;
+}
+
+static void write_entry(uint64_t key, const void *data, size_t size) {
+    char path[256];
+    char name[64];
+    FILE *file = NULL;
+
+    snprintf(name, sizeof(name), "cache/%016" PRIx64 ".wbc", key);
+    get_path(path, name);
+
+    file = fopen(path, "wb");
+    assert_non_null(file);
+    assert_int_equal(fwrite(data, 1, size, file), size);
+    assert_int_equal(fclose(file), 0);
+}
+
+static int setup(void **state) {
+    char path[256];
+
+    (void) state; /* unused */
+
+    waitui_log_setQuiet(true);
+
+    if (!mkdtemp(directory)) { return -1; }
+    if (mkdir(get_path(path, "other").s, 0700) != 0) { return -1; }
+
+    return 0;
+}
+
+static void remove_tree(const char *path) {
+    char childPath[512];
+    DIR *dir             = opendir(path);
+    struct dirent *child = NULL;
+
+    if (!dir) {
+        unlink(path);
+        return;
+    }
+
+    while ((child = readdir(dir))) {
+        if (strcmp(child->d_name, ".") == 0 ||
+            strcmp(child->d_name, "..") == 0) {
+            continue;
+        }
+        snprintf(childPath, sizeof(childPath), "%s/%s", path, child->d_name);
+        remove_tree(childPath);
+    }
+    closedir(dir);
+
+    rmdir(path);
+}
+
+static int teardown(void **state) {
+    (void) state; /* unused */
+
+    // the names of the cache entries are not known, remove the whole tree
+    remove_tree(directory);
+
+    return 0;
+}
+
+static void test_build_cache_hit_and_miss(void **state) {
+    (void) state; /* unused */
+
+    waitui_build_cache *cache = new_cache("-O");
+    uint64_t key              = 0;
+    uint64_t loadedKey        = 0;
+
+    assert_non_null(cache);
+    write_file("hit.wai", "class Hit {}\n");
+
+    key = store_source(cache, "hit.wai", NULL, 0);
+    assert_int_equal(waitui_build_cache_getHitCount(cache), 0);
+
+    assert_true(load_source(cache, "hit.wai", &loadedKey));
+    assert_int_equal(loadedKey, key);
+    assert_int_equal(waitui_build_cache_getHitCount(cache), 1);
+    waitui_build_cache_destroy(&cache);
+    assert_null(cache);
+
+    // a new run reads the entry the last run stored
+    cache = new_cache("-O");
+    assert_non_null(cache);
+    assert_true(load_source(cache, "hit.wai", NULL));
+    waitui_build_cache_destroy(&cache);
+
+    // changing the source file itself is a miss
+    write_file("hit.wai", "class Hit { }\n");
+    cache = new_cache("-O");
+    assert_non_null(cache);
+    assert_false(load_source(cache, "hit.wai", &loadedKey));
+    assert_int_not_equal(loadedKey, key);
+    assert_false(load_source(cache, "missing.wai", &loadedKey));
+    assert_int_equal(loadedKey, 0);
+    waitui_build_cache_destroy(&cache);
+}
+
+static void test_build_cache_dependency_changed(void **state) {
+    (void) state; /* unused */
+
+    char path[256];
+    waitui_build_cache *cache = new_cache("-O");
+    str dependency            = get_path(path, "base.wai");
+
+    assert_non_null(cache);
+    write_file("base.wai", "class Base {}\n");
+    write_file("top.wai", "import base\n");
+
+    store_source(cache, "top.wai", &dependency, 1);
+    assert_true(load_source(cache, "top.wai", NULL));
+    waitui_build_cache_destroy(&cache);
+
+    // the content hashes are kept per run, the next run sees the change
+    write_file("base.wai", "class Base { }\n");
+    cache = new_cache("-O");
+    assert_non_null(cache);
+    assert_false(load_source(cache, "top.wai", NULL));
+    waitui_build_cache_destroy(&cache);
+
+    // a removed dependency is a miss as well
+    cache = new_cache("-O");
+    assert_non_null(cache);
+    store_source(cache, "top.wai", &dependency, 1);
+    waitui_build_cache_destroy(&cache);
+    unlink(dependency.s);
+    cache = new_cache("-O");
+    assert_non_null(cache);
+    assert_false(load_source(cache, "top.wai", NULL));
+    waitui_build_cache_destroy(&cache);
+}
+
+static void test_build_cache_options_changed(void **state) {
+    (void) state; /* unused */
+
+    waitui_build_cache *cache = new_cache("-O");
+    uint64_t key              = 0;
+    uint64_t otherKey         = 0;
+
+    assert_non_null(cache);
+    write_file("options.wai", "class Options {}\n");
+
+    key = store_source(cache, "options.wai", NULL, 0);
+    waitui_build_cache_destroy(&cache);
+
+    cache = new_cache("-t");
+    assert_non_null(cache);
+    assert_false(load_source(cache, "options.wai", &otherKey));
+    assert_int_not_equal(otherKey, key);
+    waitui_build_cache_destroy(&cache);
+
+    cache = new_cache("-O");
+    assert_non_null(cache);
+    assert_true(load_source(cache, "options.wai", NULL));
+    waitui_build_cache_destroy(&cache);
+}
+
+static void test_build_cache_same_content(void **state) {
+    (void) state; /* unused */
+
+    waitui_build_cache *cache = new_cache("-O");
+    uint64_t key              = 0;
+    uint64_t otherKey         = 0;
+
+    assert_non_null(cache);
+    write_file("same.wai", "class Same {}\n");
+    write_file("other/same.wai", "class Same {}\n");
+
+    key = store_source(cache, "same.wai", NULL, 0);
+
+    // an equal file in another directory does not get the results of the first
+    assert_false(load_source(cache, "other/same.wai", &otherKey));
+    assert_int_not_equal(otherKey, key);
+
+    // other names of the same file share the entry
+    assert_true(load_source(cache, "other/../same.wai", &otherKey));
+    assert_int_equal(otherKey, key);
+
+    waitui_build_cache_destroy(&cache);
+}
+
+static void test_build_cache_corrupt_entry(void **state) {
+    (void) state; /* unused */
+
+    static const char garbage[] = "WBCE garbage";
+    char path[256];
+    char name[64];
+    waitui_build_cache *cache = new_cache("-O");
+    unsigned char *entry      = NULL;
+    uint64_t key              = 0;
+    long size                 = 0;
+    FILE *file                = NULL;
+
+    assert_non_null(cache);
+    write_file("corrupt.wai", "class Corrupt {}\n");
+
+    key = store_source(cache, "corrupt.wai", NULL, 0);
+
+    snprintf(name, sizeof(name), "cache/%016" PRIx64 ".wbc", key);
+    file = fopen(get_path(path, name).s, "rb");
+    assert_non_null(file);
+    assert_int_equal(fseek(file, 0, SEEK_END), 0);
+    size = ftell(file);
+    assert_true(size > 0);
+    rewind(file);
+    entry = malloc((size_t) size);
+    assert_non_null(entry);
+    assert_int_equal(fread(entry, 1, (size_t) size, file), size);
+    fclose(file);
+
+    // every truncated entry is a miss
+    for (long length = 0; length < size; ++length) {
+        write_entry(key, entry, (size_t) length);
+        assert_false(load_source(cache, "corrupt.wai", NULL));
+    }
+
+    // every flipped byte of the header and the first length is a miss
+    for (long offset = 0; offset < HEADER_SIZE + 8 && offset < size;
+         ++offset) {
+        entry[offset] = (unsigned char) ~entry[offset];
+        write_entry(key, entry, (size_t) size);
+        assert_false(load_source(cache, "corrupt.wai", NULL));
+        entry[offset] = (unsigned char) ~entry[offset];
+    }
+
+    write_entry(key, garbage, sizeof(garbage));
+    assert_false(load_source(cache, "corrupt.wai", NULL));
+
+    write_entry(key, entry, (size_t) size);
+    assert_true(load_source(cache, "corrupt.wai", NULL));
+
+    free(entry);
+    waitui_build_cache_destroy(&cache);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test(test_build_cache_hit_and_miss),
+            cmocka_unit_test(test_build_cache_dependency_changed),
+            cmocka_unit_test(test_build_cache_options_changed),
+            cmocka_unit_test(test_build_cache_same_content),
+            cmocka_unit_test(test_build_cache_corrupt_entry),
+    };
+
+    return cmocka_run_group_tests(tests, setup, teardown);
+}
@@ -10,22 +10,13 @@
 
 #include <waitui/str.h>
 
+#include <stdint.h>
+
 
 // -----------------------------------------------------------------------------
 //  Public types
 // -----------------------------------------------------------------------------
 
-/**
- * @brief Type representing a HashTable node.
- */
-typedef struct hashtable_node hashtable_node;
-struct hashtable_node {
-    str key;
-    void *value;
-    int isStolen;
-    hashtable_node *next;
-};
-
 /**
  * @brief Type for value destroy function.
  */
@@ -39,11 +30,7 @@ typedef int (*hashtable_value_check)(void *value, void *arg);
 /**
  * @brief Type representing a HashTable.
  */
-typedef struct hashtable {
-    hashtable_node **list;
-    hashtable_value_destroy valueDestroyCallback;
-    unsigned long int size;
-} hashtable;
+typedef struct hashtable hashtable;
 
 
 // -----------------------------------------------------------------------------
@@ -69,6 +56,26 @@ typedef struct hashtable {
                 length, (hashtable_value_destroy)(elem_destroy));              \
     }
 
+#define INTERFACE_HASHTABLE_NEW_INTERNED(type)                                 \
+    extern type##_hashtable *type##_hashtable_new_interned(                    \
+            unsigned long int length)
+#define IMPLEMENTATION_HASHTABLE_NEW_INTERNED(type)                            \
+    type##_hashtable *type##_hashtable_new_interned(                           \
+            unsigned long int length) {                                        \
+        return (type##_hashtable *) hashtable_new_interned(                    \
+                length, (hashtable_value_destroy) type##_destroy);             \
+    }
+
+#define INTERFACE_HASHTABLE_NEW_INTERNED_CUSTOM(type, elem_destroy)            \
+    extern type##_hashtable *type##_hashtable_new_interned(                    \
+            unsigned long int length)
+#define IMPLEMENTATION_HASHTABLE_NEW_INTERNED_CUSTOM(type, elem_destroy)       \
+    type##_hashtable *type##_hashtable_new_interned(                           \
+            unsigned long int length) {                                        \
+        return (type##_hashtable *) hashtable_new_interned(                    \
+                length, (hashtable_value_destroy)(elem_destroy));              \
+    }
+
 #define INTERFACE_HASHTABLE_DESTROY(type)                                      \
     extern void type##_hashtable_destroy(type##_hashtable **this)
 #define IMPLEMENTATION_HASHTABLE_DESTROY(type)                                 \
@@ -124,6 +131,30 @@ typedef struct hashtable {
                                            valueCheckCallback, arg);           \
     }
 
+#define INTERFACE_HASHTABLE_REMOVE_CHECK(type)                                 \
+    extern int type##_hashtable_remove_check(                                  \
+            type##_hashtable *this, str key,                                   \
+            hashtable_value_check valueCheckCallback, void *arg)
+#define IMPLEMENTATION_HASHTABLE_REMOVE_CHECK(type)                            \
+    int type##_hashtable_remove_check(                                         \
+            type##_hashtable *this, str key,                                   \
+            hashtable_value_check valueCheckCallback, void *arg) {             \
+        return hashtable_remove_check((hashtable *) this, key,                 \
+                                      valueCheckCallback, arg);                \
+    }
+
+#define INTERFACE_HASHTABLE_REMOVE_ALL_CHECK(type)                             \
+    extern unsigned long int type##_hashtable_remove_all_check(                \
+            type##_hashtable *this, hashtable_value_check valueCheckCallback,  \
+            void *arg)
+#define IMPLEMENTATION_HASHTABLE_REMOVE_ALL_CHECK(type)                        \
+    unsigned long int type##_hashtable_remove_all_check(                       \
+            type##_hashtable *this, hashtable_value_check valueCheckCallback,  \
+            void *arg) {                                                       \
+        return hashtable_remove_all_check((hashtable *) this,                  \
+                                          valueCheckCallback, arg);            \
+    }
+
 #define INTERFACE_HASHTABLE_INSERT(type, elem)                                 \
     extern int type##_hashtable_insert(type##_hashtable *this, str key,        \
                                        type *elem)
@@ -139,6 +170,13 @@ typedef struct hashtable {
         return (type *) hashtable_lookup((hashtable *) this, key);             \
     }
 
+#define INTERFACE_HASHTABLE_REMOVE(type)                                       \
+    extern int type##_hashtable_remove(type##_hashtable *this, str key)
+#define IMPLEMENTATION_HASHTABLE_REMOVE(type)                                  \
+    int type##_hashtable_remove(type##_hashtable *this, str key) {             \
+        return hashtable_remove((hashtable *) this, key);                      \
+    }
+
 #define INTERFACE_HASHTABLE_HAS(type)                                          \
     extern int type##_hashtable_has(type##_hashtable *this, str key)
 #define IMPLEMENTATION_HASHTABLE_HAS(type)                                     \
@@ -157,6 +195,7 @@ typedef struct hashtable {
 #define CREATE_HASHTABLE_TYPE(kind, type, elem)                                \
     kind##_HASHTABLE_TYPEDEF(type);                                            \
     kind##_HASHTABLE_NEW(type);                                                \
+    kind##_HASHTABLE_NEW_INTERNED(type);                                       \
     kind##_HASHTABLE_DESTROY(type);                                            \
     kind##_HASHTABLE_INSERT_CHECK(type, elem);                                 \
     kind##_HASHTABLE_INSERT(type, elem);                                       \
@@ -165,11 +204,15 @@ typedef struct hashtable {
     kind##_HASHTABLE_HAS_CHECK(type);                                          \
     kind##_HASHTABLE_HAS(type);                                                \
     kind##_HASHTABLE_MARK_STOLEN_CHECK(type);                                  \
-    kind##_HASHTABLE_MARK_STOLEN(type);
+    kind##_HASHTABLE_MARK_STOLEN(type);                                        \
+    kind##_HASHTABLE_REMOVE_CHECK(type);                                       \
+    kind##_HASHTABLE_REMOVE(type);                                             \
+    kind##_HASHTABLE_REMOVE_ALL_CHECK(type);
 
 #define CREATE_HASHTABLE_TYPE_CUSTOM(kind, type, elem, elem_destroy)           \
     kind##_HASHTABLE_TYPEDEF(type);                                            \
     kind##_HASHTABLE_NEW_CUSTOM(type, elem_destroy);                           \
+    kind##_HASHTABLE_NEW_INTERNED_CUSTOM(type, elem_destroy);                  \
     kind##_HASHTABLE_DESTROY(type);                                            \
     kind##_HASHTABLE_INSERT_CHECK(type, elem);                                 \
     kind##_HASHTABLE_INSERT(type, elem);                                       \
@@ -178,22 +221,49 @@ typedef struct hashtable {
     kind##_HASHTABLE_HAS_CHECK(type);                                          \
     kind##_HASHTABLE_HAS(type);                                                \
     kind##_HASHTABLE_MARK_STOLEN_CHECK(type);                                  \
-    kind##_HASHTABLE_MARK_STOLEN(type);
+    kind##_HASHTABLE_MARK_STOLEN(type);                                        \
+    kind##_HASHTABLE_REMOVE_CHECK(type);                                       \
+    kind##_HASHTABLE_REMOVE(type);                                             \
+    kind##_HASHTABLE_REMOVE_ALL_CHECK(type);
 
 
 // -----------------------------------------------------------------------------
 //  Public functions
 // -----------------------------------------------------------------------------
 
+/**
+ * @brief Calculate the hash value for the given key.
+ * @param[in] key The key to hash
+ * @return The 64 bit hash value of the key
+ * @note Short keys are read with a few overlapping loads, longer keys are
+ *       consumed in independent 48 byte lanes.
+ */
+extern uint64_t hashtable_hash(str key);
+
 /**
  * @brief Create a HashTable.
- * @param[in] size The HashTable size
+ * @param[in] size The initial HashTable size
  * @param[in] valueDestroyCallback Function to call for value destruction
+ * @note The HashTable grows on its own, so the size is only a hint for the
+ *       expected number of values.
  * @return A pointer to hashtable or NULL if memory allocation failed
  */
 extern hashtable *hashtable_new(unsigned long int size,
                                 hashtable_value_destroy valueDestroyCallback);
 
+/**
+ * @brief Create a HashTable for interned keys.
+ * @param[in] size The initial HashTable size
+ * @param[in] valueDestroyCallback Function to call for value destruction
+ * @note The keys are not copied but borrowed, so they have to outlive the
+ *       HashTable. Keys are hashed and compared by address only, so equal keys
+ *       have to share the same memory.
+ * @return A pointer to hashtable or NULL if memory allocation failed
+ */
+extern hashtable *
+hashtable_new_interned(unsigned long int size,
+                       hashtable_value_destroy valueDestroyCallback);
+
 /**
  * @brief Destroy a HashTable.
  * @param[in,out] this The HashTable to destroy
@@ -253,6 +323,32 @@ extern int hashtable_mark_stolen_check(hashtable *this, str key,
                                        hashtable_value_check valueCheckCallback,
                                        void *arg);
 
+/**
+ * @brief Remove the value for the key from the HashTable.
+ * @param[in,out] this The HashTable to remove the value from
+ * @param[in] key The key to remove the value for
+ * @param[in] valueCheckCallback The value checking function to call
+ * @param[in] arg The value for the second parameter to the valueCheckCallback
+ * @note The valueDestroyCallback is called for the value if not stolen.
+ * @retval 1 The value was removed
+ * @retval 0 The HashTable does not have the key
+ */
+extern int hashtable_remove_check(hashtable *this, str key,
+                                  hashtable_value_check valueCheckCallback,
+                                  void *arg);
+
+/**
+ * @brief Remove all values passing the check from the HashTable.
+ * @param[in,out] this The HashTable to remove the values from
+ * @param[in] valueCheckCallback The value checking function to call
+ * @param[in] arg The value for the second parameter to the valueCheckCallback
+ * @note The valueDestroyCallback is called for every value not stolen.
+ * @return The number of removed values
+ */
+extern unsigned long int
+hashtable_remove_all_check(hashtable *this,
+                           hashtable_value_check valueCheckCallback, void *arg);
+
 /**
  * @brief Insert a value for the key into the HashTable.
  * @param[in,out] this The HashTable to insert the value
@@ -289,4 +385,14 @@ extern int hashtable_has(hashtable *this, str key);
  */
 extern int hashtable_mark_stolen(hashtable *this, str key);
 
+/**
+ * @brief Remove the value for the key from the HashTable.
+ * @param[in,out] this The HashTable to remove the value from
+ * @param[in] key The key to remove the value for
+ * @note The valueDestroyCallback is called for the value if not stolen.
+ * @retval 1 The value was removed
+ * @retval 0 The HashTable does not have the key
+ */
+extern int hashtable_remove(hashtable *this, str key);
+
 #endif//WAITUI_HASHTABLE_H
@@ -7,29 +7,358 @@
 
 #include "waitui/hashtable.h"
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
 
+// -----------------------------------------------------------------------------
+//  Local defines
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The minimal number of slots of a HashTable.
+ */
+#define HASHTABLE_MIN_SIZE 8UL
+
+/**
+ * @brief The maximal number of slots of a HashTable, so that every probe
+ *        distance fits into the slot metadata.
+ */
+#define HASHTABLE_MAX_SIZE (1UL << 24U)
+
+/**
+ * @brief Whether the HashTable has to grow before one more value is inserted,
+ *        the maximal load factor is 7/8.
+ */
+#define HASHTABLE_NEEDS_GROW(this)                                             \
+    (((this)->length + 1) * 8 > (this)->size * 7)
+
+/**
+ * @brief Metadata of an empty slot.
+ */
+#define HASHTABLE_META_EMPTY 0U
+
+/**
+ * @brief Build the slot metadata out of probe distance and hash fragment.
+ */
+#define HASHTABLE_META(distance, fragment)                                     \
+    ((((uint32_t) (fragment)) << 24U) | ((uint32_t) (distance) + 1U))
+
+/**
+ * @brief Get the probe distance out of the slot metadata.
+ */
+#define HASHTABLE_META_DISTANCE(meta) (((meta) & 0x00FFFFFFU) - 1U)
+
+/**
+ * @brief Get the hash fragment out of the slot metadata.
+ */
+#define HASHTABLE_META_FRAGMENT(meta) ((meta) >> 24U)
+
+/**
+ * @brief Get the hash fragment stored in the slot metadata for a hash value,
+ *        the high bits are used as the low bits select the slot.
+ */
+#define HASHTABLE_FRAGMENT(hash) ((uint32_t) ((hash) >> 56U))
+
+/**
+ * @brief Get the slot for a hash value, the size is always a power of two.
+ */
+#define HASHTABLE_SLOT(this, hash) ((hash) & ((this)->size - 1))
+
+/**
+ * @brief Get the slot following the given slot.
+ */
+#define HASHTABLE_NEXT_SLOT(this, slot) (((slot) + 1) & ((this)->size - 1))
+
+/**
+ * @brief The seed and the secrets for the hash function.
+ */
+#define HASHTABLE_SEED 0xa0761d6478bd642fULL
+#define HASHTABLE_SECRET1 0xe7037ed1a0b428dbULL
+#define HASHTABLE_SECRET2 0x8ebc6af09c88c6e3ULL
+#define HASHTABLE_SECRET3 0x589965cc75374cc3ULL
+
+/**
+ * @brief Test if the key of the entry is equal to the given key, interned keys
+ *        are only compared by pointer.
+ */
+#define HASHTABLE_KEY_EQUAL(this, entry, other)                                \
+    ((entry)->key.len == (other).len &&                                        \
+     ((entry)->key.s == (other).s ||                                           \
+      (!(this)->keysInterned &&                                                \
+       memcmp((entry)->key.s, (other).s, (other).len) == 0)))
+
+
+// -----------------------------------------------------------------------------
+//  Local types
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Type representing a HashTable entry.
+ */
+typedef struct hashtable_entry {
+    str key;
+    void *value;
+    int isStolen;
+} hashtable_entry;
+
+/**
+ * @brief Struct representing a HashTable.
+ * @note The slots use robin hood open addressing. The metadata of all slots is
+ *       kept in its own array, so probing mostly stays within a few cache
+ *       lines and only touches an entry when the hash fragment matches.
+ *       Entries with the same key are kept newest first in probe order.
+ */
+struct hashtable {
+    uint32_t *meta;
+    hashtable_entry *entries;
+    hashtable_value_destroy valueDestroyCallback;
+    unsigned long int size;
+    unsigned long int length;
+    int keysInterned;
+};
+
+
 // -----------------------------------------------------------------------------
 //  Local functions
 // -----------------------------------------------------------------------------
 
 /**
- * @brief Calculate the HashTable slot for the given key.
- * @param[in] this The HashTable to calculate the slot for
- * @param[in] key The key to calculate the slot for
- * @return The slot in the HashTable for the given key
+ * @brief Read 8 bytes from the pointer.
+ * @param[in] p The pointer to read from
+ * @return The read bytes
+ */
+static inline uint64_t hashtable_read64(const unsigned char *p) {
+    uint64_t value = 0;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief Read 4 bytes from the pointer.
+ * @param[in] p The pointer to read from
+ * @return The read bytes
+ */
+static inline uint64_t hashtable_read32(const unsigned char *p) {
+    uint32_t value = 0;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief Multiply both values to 128 bits and fold the result to 64 bits.
+ * @param[in] a The first value
+ * @param[in] b The second value
+ * @return The folded product
+ */
+static inline uint64_t hashtable_mix(uint64_t a, uint64_t b) {
+#ifdef __SIZEOF_INT128__
+    __uint128_t product = (__uint128_t) a * b;
+    return (uint64_t) product ^ (uint64_t) (product >> 64U);
+#else
+    uint64_t aHigh = a >> 32U, aLow = a & 0xFFFFFFFFU;
+    uint64_t bHigh = b >> 32U, bLow = b & 0xFFFFFFFFU;
+    uint64_t high = aHigh * bHigh, low = aLow * bLow;
+    uint64_t middle1 = aHigh * bLow, middle2 = aLow * bHigh;
+    uint64_t carry = ((low >> 32U) + (middle1 & 0xFFFFFFFFU) +
+                      (middle2 & 0xFFFFFFFFU)) >>
+                     32U;
+
+    high += (middle1 >> 32U) + (middle2 >> 32U) + carry;
+    low += (middle1 << 32U) + (middle2 << 32U);
+
+    return low ^ high;
+#endif
+}
+
+/**
+ * @brief Calculate the hash value of the key for the HashTable.
+ * @param[in] this The HashTable to hash the key for
+ * @param[in] key The key to hash
+ * @return The hash value of the key
+ * @note Interned keys are hashed by their address, as equal keys share it.
+ */
+static inline uint64_t hashtable_key_hash(const hashtable *this, str key) {
+    if (this->keysInterned) {
+        return hashtable_mix((uint64_t) (uintptr_t) key.s ^ HASHTABLE_SECRET1,
+                             key.len ^ HASHTABLE_SEED);
+    }
+    return hashtable_hash(key);
+}
+
+/**
+ * @brief Round the size up to the next power of two.
+ * @param[in] size The size to round up
+ * @return The rounded size, at least HASHTABLE_MIN_SIZE
+ */
+static unsigned long int hashtable_round_size(unsigned long int size) {
+    unsigned long int rounded = HASHTABLE_MIN_SIZE;
+
+    while (rounded < size) { rounded <<= 1U; }
+
+    return rounded;
+}
+
+/**
+ * @brief Find the slot of the newest entry for the key passing the check.
+ * @param[in] this The HashTable to search in
+ * @param[in] key The key to search for
+ * @param[in] valueCheckCallback The value checking function to call
+ * @param[in] arg The value for the second parameter to the valueCheckCallback
+ * @param[out] slot The slot of the found entry
+ * @retval 1 Found
+ * @retval 0 Not found
+ */
+static int hashtable_find(const hashtable *this, str key,
+                          hashtable_value_check valueCheckCallback, void *arg,
+                          unsigned long int *slot) {
+    uint64_t hashValue      = hashtable_key_hash(this, key);
+    uint32_t fragment       = HASHTABLE_FRAGMENT(hashValue);
+    unsigned long int index = HASHTABLE_SLOT(this, hashValue);
+
+    for (uint32_t distance = 0;; ++distance) {
+        uint32_t meta = this->meta[index];
+
+        if (meta == HASHTABLE_META_EMPTY ||
+            HASHTABLE_META_DISTANCE(meta) < distance) {
+            return 0;
+        }
+
+        if (HASHTABLE_META_FRAGMENT(meta) == fragment) {
+            hashtable_entry *entry = &this->entries[index];
+
+            if (HASHTABLE_KEY_EQUAL(this, entry, key) &&
+                (!valueCheckCallback ||
+                 valueCheckCallback(entry->value, arg))) {
+                *slot = index;
+                return 1;
+            }
+        }
+
+        index = HASHTABLE_NEXT_SLOT(this, index);
+    }
+}
+
+/**
+ * @brief Place the entry into a free slot of the HashTable.
+ * @param[in,out] this The HashTable to place the entry in
+ * @param[in] entry The entry to place
+ * @note The caller has to ensure that there is a free slot. The entry is
+ *       placed in front of older entries with the same key.
+ */
+static void hashtable_place(hashtable *this, hashtable_entry entry) {
+    uint64_t hashValue      = hashtable_key_hash(this, entry.key);
+    uint32_t fragment       = HASHTABLE_FRAGMENT(hashValue);
+    unsigned long int index = HASHTABLE_SLOT(this, hashValue);
+
+    for (uint32_t distance = 0;; ++distance) {
+        uint32_t meta = this->meta[index];
+
+        if (meta == HASHTABLE_META_EMPTY) {
+            this->meta[index]    = HASHTABLE_META(distance, fragment);
+            this->entries[index] = entry;
+            return;
+        }
+
+        if (HASHTABLE_META_DISTANCE(meta) < distance ||
+            (HASHTABLE_META_DISTANCE(meta) == distance &&
+             HASHTABLE_META_FRAGMENT(meta) == fragment &&
+             HASHTABLE_KEY_EQUAL(this, &this->entries[index], entry.key))) {
+            hashtable_entry temp = this->entries[index];
+
+            this->meta[index]    = HASHTABLE_META(distance, fragment);
+            this->entries[index] = entry;
+
+            entry    = temp;
+            distance = HASHTABLE_META_DISTANCE(meta);
+            fragment = HASHTABLE_META_FRAGMENT(meta);
+        }
+
+        index = HASHTABLE_NEXT_SLOT(this, index);
+    }
+}
+
+/**
+ * @brief Remove the entry in the slot and close the gap in the probe sequence.
+ * @param[in,out] this The HashTable to remove the entry from
+ * @param[in] slot The slot of the entry to remove
+ */
+static void hashtable_remove_slot(hashtable *this, unsigned long int slot) {
+    hashtable_entry *entry = &this->entries[slot];
+    unsigned long int next = HASHTABLE_NEXT_SLOT(this, slot);
+
+    if (!entry->isStolen && this->valueDestroyCallback) {
+        this->valueDestroyCallback(&entry->value);
+    }
+    if (!this->keysInterned) { STR_FREE(&entry->key); }
+
+    while (this->meta[next] != HASHTABLE_META_EMPTY &&
+           HASHTABLE_META_DISTANCE(this->meta[next]) > 0) {
+        uint32_t meta = this->meta[next];
+
+        this->meta[slot] = HASHTABLE_META(HASHTABLE_META_DISTANCE(meta) - 1,
+                                          HASHTABLE_META_FRAGMENT(meta));
+        this->entries[slot] = this->entries[next];
+
+        slot = next;
+        next = HASHTABLE_NEXT_SLOT(this, next);
+    }
+
+    this->meta[slot] = HASHTABLE_META_EMPTY;
+    memset(&this->entries[slot], 0, sizeof(this->entries[slot]));
+    this->length--;
+}
+
+/**
+ * @brief Resize the HashTable and place all entries again.
+ * @param[in,out] this The HashTable to resize
+ * @param[in] size The new number of slots
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
  */
-unsigned long int hashtable_hash(hashtable *this, str key) {
-    unsigned long int hashValue = 0;
+static int hashtable_resize(hashtable *this, unsigned long int size) {
+    uint32_t *oldMeta              = this->meta;
+    hashtable_entry *oldEntries    = this->entries;
+    unsigned long int oldSize      = this->size;
+    unsigned long int clusterStart = 0;
+    uint32_t *newMeta              = NULL;
+    hashtable_entry *newEntries    = NULL;
+
+    newMeta    = calloc(size, sizeof(*newMeta));
+    newEntries = calloc(size, sizeof(*newEntries));
+    if (!newMeta || !newEntries) {
+        free(newMeta);
+        free(newEntries);
+        return 0;
+    }
+
+    this->meta    = newMeta;
+    this->entries = newEntries;
+    this->size    = size;
+
+    if (!oldMeta) { return 1; }
 
-    if (key.len < 1 || !key.s) { return 0; }
+    while (clusterStart < oldSize &&
+           oldMeta[clusterStart] != HASHTABLE_META_EMPTY &&
+           HASHTABLE_META_DISTANCE(oldMeta[clusterStart]) != 0) {
+        clusterStart++;
+    }
+
+    // walk backwards from a cluster start, so entries with the same key are
+    // placed oldest first and every cluster is visited as a whole
+    for (unsigned long int i = 1; i <= oldSize; ++i) {
+        unsigned long int index = (clusterStart - i) & (oldSize - 1);
+
+        if (oldMeta[index] == HASHTABLE_META_EMPTY) { continue; }
 
-    for (unsigned long int i = 0; i < key.len; ++i) { hashValue += key.s[i]; }
-    hashValue += key.s[0] % 11 + (((unsigned char) key.s[0]) << 3U) - key.s[0];
+        hashtable_place(this, oldEntries[index]);
+    }
+
+    free(oldMeta);
+    free(oldEntries);
 
-    return hashValue % this->size;
+    return 1;
 }
 
 
@@ -37,6 +366,63 @@ unsigned long int hashtable_hash(hashtable *this, str key) {
 //  Public functions
 // -----------------------------------------------------------------------------
 
+uint64_t hashtable_hash(str key) {
+    const unsigned char *p = (const unsigned char *) key.s;
+    uint64_t seed          = HASHTABLE_SEED;
+    uint64_t a             = 0;
+    uint64_t b             = 0;
+
+    if (!p) { return 0; }
+
+    if (key.len <= 16) {
+        if (key.len >= 4) {
+            unsigned long int offset = (key.len >> 3U) << 2U;
+
+            a = (hashtable_read32(p) << 32U) | hashtable_read32(p + offset);
+            b = (hashtable_read32(p + key.len - 4) << 32U) |
+                hashtable_read32(p + key.len - 4 - offset);
+        } else if (key.len > 0) {
+            a = ((uint64_t) p[0] << 16U) | ((uint64_t) p[key.len >> 1U] << 8U) |
+                p[key.len - 1];
+        }
+    } else {
+        unsigned long int i = key.len;
+
+        if (i > 48) {
+            uint64_t seed1 = seed, seed2 = seed;
+
+            // three independent lanes, so long keys keep the multipliers busy
+            do {
+                seed = hashtable_mix(hashtable_read64(p) ^ HASHTABLE_SECRET1,
+                                     hashtable_read64(p + 8) ^ seed);
+                seed1 = hashtable_mix(
+                        hashtable_read64(p + 16) ^ HASHTABLE_SECRET2,
+                        hashtable_read64(p + 24) ^ seed1);
+                seed2 = hashtable_mix(
+                        hashtable_read64(p + 32) ^ HASHTABLE_SECRET3,
+                        hashtable_read64(p + 40) ^ seed2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+
+            seed ^= seed1 ^ seed2;
+        }
+
+        while (i > 16) {
+            seed = hashtable_mix(hashtable_read64(p) ^ HASHTABLE_SECRET1,
+                                 hashtable_read64(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+
+        a = hashtable_read64(p + i - 16);
+        b = hashtable_read64(p + i - 8);
+    }
+
+    return hashtable_mix(HASHTABLE_SECRET1 ^ key.len,
+                         hashtable_mix(a ^ HASHTABLE_SECRET1, b ^ seed));
+}
+
 hashtable *hashtable_new(unsigned long int size,
                          hashtable_value_destroy valueDestroyCallback) {
     hashtable *this = NULL;
@@ -44,15 +430,25 @@ hashtable *hashtable_new(unsigned long int size,
     this = calloc(1, sizeof(*this));
     if (!this) { return NULL; }
 
-    this->size                 = size;
+    if (size > HASHTABLE_MAX_SIZE) { size = HASHTABLE_MAX_SIZE; }
+    size = hashtable_round_size(size);
+
     this->valueDestroyCallback = valueDestroyCallback;
-    this->list                 = calloc(size, sizeof(this->list));
-    if (!this->list) {
+    if (!hashtable_resize(this, size)) {
         hashtable_destroy(&this);
         return NULL;
     }
 
-    for (unsigned long int i = 0; i < this->size; ++i) { this->list[i] = NULL; }
+    return this;
+}
+
+hashtable *
+hashtable_new_interned(unsigned long int size,
+                       hashtable_value_destroy valueDestroyCallback) {
+    hashtable *this = hashtable_new(size, valueDestroyCallback);
+    if (!this) { return NULL; }
+
+    this->keysInterned = 1;
 
     return this;
 }
@@ -60,23 +456,21 @@ hashtable *hashtable_new(unsigned long int size,
 void hashtable_destroy(hashtable **this) {
     if (!this || !(*this)) { return; }
 
-    if ((*this)->list) {
+    if ((*this)->meta) {
         for (unsigned long int i = 0; i < (*this)->size; ++i) {
-            while ((*this)->list[i]) {
-                hashtable_node *temp = (*this)->list[i];
-                (*this)->list[i]     = (*this)->list[i]->next;
-
-                if (!temp->isStolen) {
-                    (*this)->valueDestroyCallback(&temp->value);
-                }
+            hashtable_entry *entry = &(*this)->entries[i];
 
-                STR_FREE(&temp->key);
+            if ((*this)->meta[i] == HASHTABLE_META_EMPTY) { continue; }
 
-                free(temp);
+            if (!entry->isStolen && (*this)->valueDestroyCallback) {
+                (*this)->valueDestroyCallback(&entry->value);
             }
+
+            if (!(*this)->keysInterned) { STR_FREE(&entry->key); }
         }
-        free((*this)->list);
     }
+    free((*this)->meta);
+    free((*this)->entries);
 
     free(*this);
     *this = NULL;
@@ -85,34 +479,31 @@ void hashtable_destroy(hashtable **this) {
 int hashtable_insert_check(hashtable *this, str key, void *value,
                            hashtable_value_check valueCheckCallback,
                            void *arg) {
-    if (!this) { return 0; }
+    hashtable_entry entry  = {0};
+    unsigned long int slot = 0;
 
-    unsigned long int hashSlot = hashtable_hash(this, key);
-    hashtable_node *node       = this->list[hashSlot];
-    str keyCopy                = STR_NULL_INIT;
+    if (!this) { return 0; }
 
-    while (node &&
-           (key.len != node->key.len ||
-            memcmp(key.s, node->key.s, key.len) != 0 ||
-            (valueCheckCallback && !valueCheckCallback(node->value, arg)))) {
-        node = node->next;
+    if (hashtable_find(this, key, valueCheckCallback, arg, &slot)) {
+        return 0;
     }
 
-    if (node) { return 0; }
-
-    node = calloc(1, sizeof(*node));
-    if (!node) { return 0; }
+    if (HASHTABLE_NEEDS_GROW(this)) {
+        if (this->size >= HASHTABLE_MAX_SIZE) { return 0; }
+        if (!hashtable_resize(this, this->size * 2)) { return 0; }
+    }
 
-    STR_COPY(&keyCopy, &key);
-    if (!keyCopy.s) {
-        free(node);
-        return 0;
+    if (this->keysInterned) {
+        entry.key = key;
+    } else {
+        STR_COPY(&entry.key, &key);
+        if (!entry.key.s) { return 0; }
     }
 
-    node->key            = keyCopy;
-    node->value          = value;
-    node->next           = this->list[hashSlot];
-    this->list[hashSlot] = node;
+    entry.value = value;
+
+    hashtable_place(this, entry);
+    this->length++;
 
     return 1;
 }
@@ -120,62 +511,79 @@ int hashtable_insert_check(hashtable *this, str key, void *value,
 void *hashtable_lookup_check(hashtable *this, str key,
                              hashtable_value_check valueCheckCallback,
                              void *arg) {
-    if (!this) { return NULL; }
+    unsigned long int slot = 0;
 
-    unsigned long int hashValue = hashtable_hash(this, key);
-    hashtable_node *node        = this->list[hashValue];
+    if (!this) { return NULL; }
 
-    while (node &&
-           (key.len != node->key.len ||
-            memcmp(key.s, node->key.s, key.len) != 0 ||
-            (valueCheckCallback && !valueCheckCallback(node->value, arg)))) {
-        node = node->next;
+    if (!hashtable_find(this, key, valueCheckCallback, arg, &slot)) {
+        return NULL;
     }
 
-    if (!node) { return NULL; }
-
-    return node->value;
+    return this->entries[slot].value;
 }
 
 int hashtable_has_check(hashtable *this, str key,
                         hashtable_value_check valueCheckCallback, void *arg) {
-    if (!this) { return 0; }
-
-    unsigned long int hashValue = hashtable_hash(this, key);
-    hashtable_node *node        = this->list[hashValue];
+    unsigned long int slot = 0;
 
-    while (node &&
-           (key.len != node->key.len ||
-            memcmp(key.s, node->key.s, key.len) != 0 ||
-            (valueCheckCallback && !valueCheckCallback(node->value, arg)))) {
-        node = node->next;
-    }
+    if (!this) { return 0; }
 
-    return node != NULL;
+    return hashtable_find(this, key, valueCheckCallback, arg, &slot);
 }
 
 int hashtable_mark_stolen_check(hashtable *this, str key,
                                 hashtable_value_check valueCheckCallback,
                                 void *arg) {
-    if (!this) { return 0; }
+    unsigned long int slot = 0;
 
-    unsigned long int hashValue = hashtable_hash(this, key);
-    hashtable_node *node        = this->list[hashValue];
+    if (!this) { return 0; }
 
-    while (node &&
-           (key.len != node->key.len ||
-            memcmp(key.s, node->key.s, key.len) != 0 ||
-            (valueCheckCallback && !valueCheckCallback(node->value, arg)))) {
-        node = node->next;
+    if (!hashtable_find(this, key, valueCheckCallback, arg, &slot)) {
+        return 0;
     }
 
-    if (!node) { return 0; }
+    this->entries[slot].isStolen = 1;
 
-    node->isStolen = 1;
+    return 1;
+}
+
+int hashtable_remove_check(hashtable *this, str key,
+                           hashtable_value_check valueCheckCallback,
+                           void *arg) {
+    unsigned long int slot = 0;
+
+    if (!this) { return 0; }
+
+    if (!hashtable_find(this, key, valueCheckCallback, arg, &slot)) {
+        return 0;
+    }
+
+    hashtable_remove_slot(this, slot);
 
     return 1;
 }
 
+unsigned long int
+hashtable_remove_all_check(hashtable *this,
+                           hashtable_value_check valueCheckCallback,
+                           void *arg) {
+    unsigned long int removed = 0;
+
+    if (!this || !valueCheckCallback) { return 0; }
+
+    // removing shifts the following entries back into the current slot, so
+    // the slot is only left once its entry stays
+    for (unsigned long int i = 0; i < this->size; ++i) {
+        while (this->meta[i] != HASHTABLE_META_EMPTY &&
+               valueCheckCallback(this->entries[i].value, arg)) {
+            hashtable_remove_slot(this, i);
+            removed++;
+        }
+    }
+
+    return removed;
+}
+
 int hashtable_insert(hashtable *this, str key, void *value) {
     return hashtable_insert_check(this, key, value, NULL, NULL);
 }
@@ -191,3 +599,7 @@ int hashtable_has(hashtable *this, str key) {
 int hashtable_mark_stolen(hashtable *this, str key) {
     return hashtable_mark_stolen_check(this, key, NULL, NULL);
 }
+
+int hashtable_remove(hashtable *this, str key) {
+    return hashtable_remove_check(this, key, NULL, NULL);
+}
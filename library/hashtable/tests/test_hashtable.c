@@ -9,6 +9,7 @@
 #include <stdarg.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
 
 #include <cmocka.h>
 
@@ -40,6 +41,13 @@ static int value_check_counter(value *this, int *count) {
     return this->count == *count;
 }
 
+static int value_check_odd(value *this, void *arg) {
+    (void) arg; /* unused */
+
+    if (!this) { return 0; }
+    return this->i % 2 == 1;
+}
+
 CREATE_HASHTABLE_TYPE(INTERFACE, value, value)
 
 CREATE_HASHTABLE_TYPE(IMPLEMENTATION, value, value)
@@ -188,6 +196,139 @@ static void test_hashtable_double_insert_lookup_with_check(void **state) {
     assert_null(table);
 }
 
+static void test_hashtable_grow(void **state) {
+    (void) state; /* unused */
+
+    hashtable *table =
+            hashtable_new(1, (hashtable_value_destroy) value_destroy);
+    assert_non_null(table);
+
+    char buffer[32];
+    str key = STR_NULL_INIT;
+
+    for (int i = 0; i < 10000; ++i) {
+        key.s   = buffer;
+        key.len = snprintf(buffer, sizeof(buffer), "key%d", i);
+        assert_true(hashtable_insert(table, key, (void *) value_new(i)));
+    }
+
+    for (int i = 0; i < 10000; ++i) {
+        key.s   = buffer;
+        key.len = snprintf(buffer, sizeof(buffer), "key%d", i);
+
+        value *valueLookup = (value *) hashtable_lookup(table, key);
+        assert_non_null(valueLookup);
+        assert_int_equal(valueLookup->i, i);
+    }
+
+    hashtable_destroy(&table);
+}
+
+static void test_hashtable_remove(void **state) {
+    (void) state; /* unused */
+
+    hashtable *table =
+            hashtable_new(1, (hashtable_value_destroy) value_destroy);
+    assert_non_null(table);
+
+    char buffer[32];
+    str key = STR_NULL_INIT;
+
+    for (int i = 0; i < 100; ++i) {
+        key.s   = buffer;
+        key.len = snprintf(buffer, sizeof(buffer), "key%d", i);
+        assert_true(hashtable_insert(table, key, (void *) value_new(i)));
+    }
+
+    for (int i = 0; i < 100; i += 3) {
+        key.s   = buffer;
+        key.len = snprintf(buffer, sizeof(buffer), "key%d", i);
+        assert_true(hashtable_remove(table, key));
+        assert_false(hashtable_remove(table, key));
+    }
+
+    assert_int_equal(hashtable_remove_all_check(
+                             table, (hashtable_value_check) value_check_odd,
+                             NULL),
+                     33);
+
+    for (int i = 0; i < 100; ++i) {
+        key.s   = buffer;
+        key.len = snprintf(buffer, sizeof(buffer), "key%d", i);
+        assert_int_equal(hashtable_has(table, key), i % 3 != 0 && i % 2 == 0);
+    }
+
+    hashtable_destroy(&table);
+}
+
+static void test_hashtable_lookup_newest_first(void **state) {
+    (void) state; /* unused */
+
+    hashtable *table =
+            hashtable_new(1, (hashtable_value_destroy) value_destroy);
+    assert_non_null(table);
+
+    char buffer[32];
+    str key1 = STR_STATIC_INIT("foo1");
+    str key  = STR_NULL_INIT;
+
+    for (int count = 0; count < 5; ++count) {
+        value *value1 = value_new(count);
+        value1->count = count;
+
+        assert_true(hashtable_insert_check(
+                table, key1, (void *) value1,
+                (hashtable_value_check) value_check_counter, &count));
+
+        for (int i = 0; i < 20; ++i) {
+            key.s   = buffer;
+            key.len = snprintf(buffer, sizeof(buffer), "key%d_%d", count, i);
+            assert_true(hashtable_insert(table, key, (void *) value_new(i)));
+        }
+    }
+
+    for (int count = 4; count >= 0; --count) {
+        value *valueLookup1 = (value *) hashtable_lookup(table, key1);
+        assert_non_null(valueLookup1);
+        assert_int_equal(valueLookup1->i, count);
+        assert_true(hashtable_remove(table, key1));
+    }
+    assert_false(hashtable_has(table, key1));
+
+    hashtable_destroy(&table);
+}
+
+static void test_hashtable_interned(void **state) {
+    (void) state; /* unused */
+
+    hashtable *table =
+            hashtable_new_interned(1, (hashtable_value_destroy) value_destroy);
+    assert_non_null(table);
+
+    char buffer[8] = "foo";
+    str key1       = STR_STATIC_INIT("foo");
+    str key2       = {.s = buffer, .len = 3};
+
+    assert_true(hashtable_insert(table, key1, (void *) value_new(1)));
+    assert_true(hashtable_has(table, key1));
+    assert_false(hashtable_has(table, key2));
+    assert_true(hashtable_insert(table, key2, (void *) value_new(2)));
+
+    value *valueLookup1 = (value *) hashtable_lookup(table, key1);
+    assert_non_null(valueLookup1);
+    assert_int_equal(valueLookup1->i, 1);
+
+    value *valueLookup2 = (value *) hashtable_lookup(table, key2);
+    assert_non_null(valueLookup2);
+    assert_int_equal(valueLookup2->i, 2);
+
+    assert_true(hashtable_remove(table, key1));
+    assert_false(hashtable_has(table, key1));
+    assert_true(hashtable_has(table, key2));
+
+    hashtable_destroy(&table);
+}
+
 static void test_value_hashtable(void **state) {
     (void) state; /* unused */
 
@@ -205,6 +346,10 @@ int main(void) {
             cmocka_unit_test(test_hashtable_insert_has_lookup_collision),
             cmocka_unit_test(test_hashtable_double_insert_fail_without_check),
             cmocka_unit_test(test_hashtable_double_insert_lookup_with_check),
+            cmocka_unit_test(test_hashtable_grow),
+            cmocka_unit_test(test_hashtable_remove),
+            cmocka_unit_test(test_hashtable_lookup_newest_first),
+            cmocka_unit_test(test_hashtable_interned),
             cmocka_unit_test(test_value_hashtable),
     };
 
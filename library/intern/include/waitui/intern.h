@@ -0,0 +1,70 @@
+/**
+ * @file intern.h
+ * @author rick
+ * @date 17.10.26
+ * @brief File for the Intern pool implementation
+ */
+
+#ifndef WAITUI_INTERN_H
+#define WAITUI_INTERN_H
+
+#include <waitui/arena.h>
+#include <waitui/str.h>
+
+
+// -----------------------------------------------------------------------------
+//  Public defines
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Test if the two interned strings are the same string.
+ */
+#define WAITUI_INTERN_EQUAL(_a_, _b_) ((_a_).s == (_b_).s)
+
+
+// -----------------------------------------------------------------------------
+//  Public types
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Type representing an Intern pool.
+ */
+typedef struct waitui_intern waitui_intern;
+
+
+// -----------------------------------------------------------------------------
+//  Public functions
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Create an Intern pool inside the Arena.
+ * @param[in,out] arena The Arena to store the pool and its strings in
+ * @return A pointer to waitui_intern or NULL if memory allocation failed
+ * @note The pool and every interned string live as long as the Arena, there
+ *       is no separate destroy function.
+ */
+extern waitui_intern *waitui_intern_new(waitui_arena *arena);
+
+/**
+ * @brief Intern the text, so every equal text yields the same string.
+ * @param[in,out] this The Intern pool to intern the text in
+ * @param[in] text The text to intern
+ * @param[out] interned The str to store the interned string in
+ * @note Interned strings are NUL terminated and can be compared with
+ *       WAITUI_INTERN_EQUAL.
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ */
+extern int waitui_intern_str(waitui_intern *this, str text, str *interned);
+
+/**
+ * @brief Find the interned string for the text without interning it.
+ * @param[in] this The Intern pool to search in
+ * @param[in] text The text to find
+ * @param[out] interned The str to store the interned string in
+ * @retval 1 Ok
+ * @retval 0 The text was never interned
+ */
+extern int waitui_intern_find(waitui_intern *this, str text, str *interned);
+
+#endif//WAITUI_INTERN_H
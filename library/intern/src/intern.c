@@ -0,0 +1,192 @@
+/**
+ * @file intern.c
+ * @author rick
+ * @date 17.10.26
+ * @brief File for the Intern pool implementation
+ */
+
+#include "waitui/intern.h"
+
+#include <waitui/hashtable.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+// -----------------------------------------------------------------------------
+//  Local defines
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The initial number of slots of the Intern pool.
+ */
+#define WAITUI_INTERN_INITIAL_SIZE 256UL
+
+/**
+ * @brief Whether the Intern pool has to grow before one more string is added,
+ *        the maximal load factor is 3/4.
+ */
+#define WAITUI_INTERN_NEEDS_GROW(this)                                         \
+    (((this)->length + 1) * 4 > (this)->size * 3)
+
+
+// -----------------------------------------------------------------------------
+//  Local types
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Type representing an Intern pool slot.
+ */
+typedef struct waitui_intern_slot {
+    str text;
+    uint64_t hash;
+} waitui_intern_slot;
+
+/**
+ * @brief Struct representing an Intern pool.
+ * @note The slots use linear probing and only borrow the strings, which are
+ *       allocated from the Arena.
+ */
+struct waitui_intern {
+    waitui_arena *arena;
+    waitui_intern_slot *slots;
+    unsigned long int size;
+    unsigned long int length;
+};
+
+
+// -----------------------------------------------------------------------------
+//  Local functions
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Release the slots of the Intern pool, called by the Arena.
+ * @param[in,out] data The Intern pool to release the slots for
+ */
+static void waitui_intern_cleanup(void **data) {
+    waitui_intern *this = *data;
+
+    if (!this) { return; }
+
+    free(this->slots);
+    this->slots = NULL;
+}
+
+/**
+ * @brief Find the slot for the text, either holding it or the empty slot
+ *        where it belongs.
+ * @param[in] this The Intern pool to search in
+ * @param[in] text The text to find the slot for
+ * @param[in] hash The hash value of the text
+ * @return The found slot
+ */
+static waitui_intern_slot *waitui_intern_slot_find(waitui_intern *this,
+                                                   str text, uint64_t hash) {
+    unsigned long int index = hash & (this->size - 1);
+
+    for (;;) {
+        waitui_intern_slot *slot = &this->slots[index];
+
+        if (!slot->text.s) { return slot; }
+        if (slot->hash == hash && slot->text.len == text.len &&
+            memcmp(slot->text.s, text.s, text.len) == 0) {
+            return slot;
+        }
+
+        index = (index + 1) & (this->size - 1);
+    }
+}
+
+/**
+ * @brief Double the number of slots of the Intern pool.
+ * @param[in,out] this The Intern pool to grow
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ */
+static int waitui_intern_grow(waitui_intern *this) {
+    waitui_intern_slot *oldSlots = this->slots;
+    unsigned long int oldSize    = this->size;
+
+    this->slots = calloc(oldSize * 2, sizeof(*this->slots));
+    if (!this->slots) {
+        this->slots = oldSlots;
+        return 0;
+    }
+    this->size = oldSize * 2;
+
+    for (unsigned long int i = 0; i < oldSize; ++i) {
+        if (!oldSlots[i].text.s) { continue; }
+
+        *waitui_intern_slot_find(this, oldSlots[i].text, oldSlots[i].hash) =
+                oldSlots[i];
+    }
+
+    free(oldSlots);
+
+    return 1;
+}
+
+
+// -----------------------------------------------------------------------------
+//  Public functions
+// -----------------------------------------------------------------------------
+
+waitui_intern *waitui_intern_new(waitui_arena *arena) {
+    waitui_intern *this = NULL;
+
+    this = waitui_arena_alloc(arena, sizeof(*this));
+    if (!this) { return NULL; }
+
+    this->arena = arena;
+    this->size  = WAITUI_INTERN_INITIAL_SIZE;
+    this->slots = calloc(this->size, sizeof(*this->slots));
+    if (!this->slots) { return NULL; }
+
+    if (!waitui_arena_addCleanup(arena, waitui_intern_cleanup, this)) {
+        free(this->slots);
+        return NULL;
+    }
+
+    return this;
+}
+
+int waitui_intern_str(waitui_intern *this, str text, str *interned) {
+    uint64_t hash            = 0;
+    waitui_intern_slot *slot = NULL;
+
+    if (!this || !interned) { return 0; }
+
+    hash = hashtable_hash(text);
+    slot = waitui_intern_slot_find(this, text, hash);
+    if (slot->text.s) {
+        *interned = slot->text;
+        return 1;
+    }
+
+    if (WAITUI_INTERN_NEEDS_GROW(this)) {
+        if (!waitui_intern_grow(this)) { return 0; }
+        slot = waitui_intern_slot_find(this, text, hash);
+    }
+
+    if (!waitui_arena_copyStr(this->arena, &slot->text, &text)) { return 0; }
+    slot->hash = hash;
+    this->length++;
+
+    *interned = slot->text;
+
+    return 1;
+}
+
+int waitui_intern_find(waitui_intern *this, str text, str *interned) {
+    waitui_intern_slot *slot = NULL;
+
+    if (!this || !interned) { return 0; }
+
+    slot = waitui_intern_slot_find(this, text, hashtable_hash(text));
+    if (!slot->text.s) { return 0; }
+
+    *interned = slot->text;
+
+    return 1;
+}
@@ -8,6 +8,8 @@
 #ifndef WAITUI_LIST_H
 #define WAITUI_LIST_H
 
+#include <waitui/arena.h>
+
 #include <stdbool.h>
 
 
@@ -32,8 +34,12 @@ typedef struct waitui_list waitui_list;
 
 /**
  * @brief Type representing a List iterator.
+ * @note The iterator is a plain value, so it can live on the stack, see
+ *       waitui_list_iterate.
  */
-typedef struct waitui_list_iter waitui_list_iter;
+typedef struct waitui_list_iter {
+    waitui_list_node *node;
+} waitui_list_iter;
 
 
 // -----------------------------------------------------------------------------
@@ -53,6 +59,13 @@ typedef struct waitui_list_iter waitui_list_iter;
                 (waitui_list_element_destroy) type##_destroy);                 \
     }
 
+#define INTERFACE_LIST_NEW_IN_ARENA(type)                                      \
+    extern type##_list *type##_list_newInArena(waitui_arena *arena)
+#define IMPLEMENTATION_LIST_NEW_IN_ARENA(type)                                 \
+    type##_list *type##_list_newInArena(waitui_arena *arena) {                 \
+        return (type##_list *) waitui_list_newInArena(arena);                  \
+    }
+
 #define INTERFACE_LIST_DESTROY(type)                                           \
     extern void type##_list_destroy(type##_list **this)
 #define IMPLEMENTATION_LIST_DESTROY(type)                                      \
@@ -103,6 +116,13 @@ typedef struct waitui_list_iter waitui_list_iter;
                 (waitui_list *) this);                                         \
     }
 
+#define INTERFACE_LIST_ITERATE(type)                                           \
+    extern type##_list_iter type##_list_iterate(type##_list *this)
+#define IMPLEMENTATION_LIST_ITERATE(type)                                      \
+    type##_list_iter type##_list_iterate(type##_list *this) {                  \
+        return waitui_list_iterate((waitui_list *) this);                      \
+    }
+
 #define INTERFACE_LIST_ITER_HAS_NEXT(type)                                     \
     extern bool type##_list_iter_hasNext(type##_list_iter *this)
 #define IMPLEMENTATION_LIST_ITER_HAS_NEXT(type)                                \
@@ -133,6 +153,7 @@ typedef struct waitui_list_iter waitui_list_iter;
 #define CREATE_LIST_TYPE(kind, type)                                           \
     kind##_LIST_TYPEDEF(type);                                                 \
     kind##_LIST_NEW(type);                                                     \
+    kind##_LIST_NEW_IN_ARENA(type);                                            \
     kind##_LIST_DESTROY(type);                                                 \
     kind##_LIST_PUSH(type);                                                    \
     kind##_LIST_POP(type);                                                     \
@@ -140,10 +161,27 @@ typedef struct waitui_list_iter waitui_list_iter;
     kind##_LIST_SHIFT(type);                                                   \
     kind##_LIST_PEEK(type);                                                    \
     kind##_LIST_GET_ITERATOR(type);                                            \
+    kind##_LIST_ITERATE(type);                                                 \
     kind##_LIST_ITER_HAS_NEXT(type);                                           \
     kind##_LIST_ITER_NEXT(type);                                               \
     kind##_LIST_ITER_DESTROY(type);
 
+/**
+ * @brief Define for iterating over a list created with CREATE_LIST_TYPE
+ *        without any allocation.
+ * @param[in] type The type the list was created for
+ * @param[in] element The name of the variable holding the current element
+ * @param[in] list The list to iterate over
+ * @note The body is a statement like for a for loop, break and continue work
+ *       as usual. The list must not be changed while iterating over it.
+ */
+#define WAITUI_LIST_FOREACH(type, element, list)                               \
+    for (type##_list_iter element##Iter = type##_list_iterate(list);           \
+         element##Iter.node; element##Iter.node = NULL)                        \
+        for (type *element = NULL;                                             \
+             type##_list_iter_hasNext(&element##Iter) &&                       \
+             ((element = type##_list_iter_next(&element##Iter)), true);)
+
 
 // -----------------------------------------------------------------------------
 //  Public functions
@@ -157,10 +195,21 @@ typedef struct waitui_list_iter waitui_list_iter;
 extern waitui_list *
 waitui_list_new(waitui_list_element_destroy elementDestroyCallback);
 
+/**
+ * @brief Create a List with its nodes allocated from the Arena.
+ * @param[in,out] arena The Arena to allocate the List and its nodes from
+ * @return A pointer to waitui_list or NULL if memory allocation failed
+ * @note The elements are not owned by the List, they have to live at least as
+ *       long as the Arena.
+ */
+extern waitui_list *waitui_list_newInArena(waitui_arena *arena);
+
 /**
  * @brief Destroy a List.
  * @param[in,out] this The List to destroy
  * @note This will free call for every element the elementDestroyCallback
+ * @note For a List created with waitui_list_newInArena this will only reset
+ *       the pointer, the memory is released together with the Arena.
  */
 extern void waitui_list_destroy(waitui_list **this);
 
@@ -208,6 +257,29 @@ extern void *waitui_list_shift(waitui_list *this);
  */
 extern void *waitui_list_peek(waitui_list *this);
 
+/**
+ * @brief Return the first node of the List.
+ * @param[in] this The List to get the first node from
+ * @return The first node or NULL if waitui_list is empty
+ * @note Walking the nodes with waitui_list_node_getNext needs no allocation,
+ *       the List must not be changed meanwhile.
+ */
+extern waitui_list_node *waitui_list_getFirstNode(waitui_list *this);
+
+/**
+ * @brief Return the node following the List node.
+ * @param[in] this The List node to get the next node from
+ * @return The next node or NULL if this is the last node
+ */
+extern waitui_list_node *waitui_list_node_getNext(waitui_list_node *this);
+
+/**
+ * @brief Return the element of the List node.
+ * @param[in] this The List node to get the element from
+ * @return The element or NULL if the node is NULL
+ */
+extern void *waitui_list_node_getElement(waitui_list_node *this);
+
 /**
  * @brief Return the iterator to iterate over the List.
  * @param[in] this The List to get the iterator for
@@ -215,6 +287,15 @@ extern void *waitui_list_peek(waitui_list *this);
  */
 extern waitui_list_iter *waitui_list_getIterator(waitui_list *this);
 
+/**
+ * @brief Return the iterator to iterate over the List as a value.
+ * @param[in] this The List to get the iterator for
+ * @return The iterator, it needs no allocation and no destroy
+ * @note Use it with waitui_list_iter_hasNext and waitui_list_iter_next by
+ *       address, the List must not be changed meanwhile.
+ */
+extern waitui_list_iter waitui_list_iterate(waitui_list *this);
+
 /**
  * @brief Return true if the List iterator has a next element.
  * @param[in] this The List iterator to test for next element available
@@ -30,16 +30,10 @@ struct waitui_list {
     waitui_list_node *head;
     waitui_list_node *tail;
     waitui_list_element_destroy elementDestroyCallback;
+    waitui_arena *arena;
     unsigned long long length;
 };
 
-/**
- * @brief Struct representing a List iterator.
- */
-struct waitui_list_iter {
-    waitui_list_node *node;
-};
-
 
 // -----------------------------------------------------------------------------
 //  Local functions
@@ -61,6 +55,41 @@ static waitui_list_iter *waitui_list_iter_new(waitui_list_node *node) {
     return this;
 }
 
+/**
+ * @brief Create a List node.
+ * @param[in,out] list The List to create the node for
+ * @param[in] element The element of the node
+ * @return A pointer to waitui_list_node or NULL if memory allocation failed
+ */
+static waitui_list_node *waitui_list_node_new(waitui_list *list,
+                                              void *element) {
+    waitui_list_node *this = NULL;
+
+    if (list->arena) {
+        this = waitui_arena_alloc(list->arena, sizeof(*this));
+    } else {
+        this = calloc(1, sizeof(*this));
+    }
+    if (!this) { return NULL; }
+
+    this->element = element;
+
+    return this;
+}
+
+/**
+ * @brief Destroy a List node.
+ * @param[in,out] list The List the node belongs to
+ * @param[in,out] this The List node to destroy
+ */
+static void waitui_list_node_destroy(waitui_list *list,
+                                     waitui_list_node **this) {
+    if (!this || !(*this)) { return; }
+
+    if (!list->arena) { free(*this); }
+    *this = NULL;
+}
+
 
 // -----------------------------------------------------------------------------
 //  Public functions
@@ -78,9 +107,25 @@ waitui_list_new(waitui_list_element_destroy elementDestroyCallback) {
     return this;
 }
 
+waitui_list *waitui_list_newInArena(waitui_arena *arena) {
+    waitui_list *this = NULL;
+
+    this = waitui_arena_alloc(arena, sizeof(*this));
+    if (!this) { return NULL; }
+
+    this->arena = arena;
+
+    return this;
+}
+
 void waitui_list_destroy(waitui_list **this) {
     if (!this || !(*this)) { return; }
 
+    if ((*this)->arena) {
+        *this = NULL;
+        return;
+    }
+
     while ((*this)->head) {
         waitui_list_node *temp = (*this)->head;
         (*this)->head          = (*this)->head->next;
@@ -100,11 +145,9 @@ int waitui_list_push(waitui_list *this, void *element) {
 
     if (!this || !element) { return 0; }
 
-    node = calloc(1, sizeof(*node));
+    node = waitui_list_node_new(this, element);
     if (!node) { return 0; }
 
-    node->element = element;
-
     if (this->tail == NULL) {
         this->head = this->tail = node;
     } else {
@@ -135,7 +178,7 @@ void *waitui_list_pop(waitui_list *this) {
         this->head = NULL;
     }
 
-    free(node);
+    waitui_list_node_destroy(this, &node);
 
     return element;
 }
@@ -145,11 +188,9 @@ int waitui_list_unshift(waitui_list *this, void *element) {
 
     if (!this || !element) { return 0; }
 
-    node = calloc(1, sizeof(*node));
+    node = waitui_list_node_new(this, element);
     if (!node) { return 0; }
 
-    node->element = element;
-
     if (this->head == NULL) {
         this->head = this->tail = node;
     } else {
@@ -180,7 +221,7 @@ void *waitui_list_shift(waitui_list *this) {
         this->tail = NULL;
     }
 
-    free(node);
+    waitui_list_node_destroy(this, &node);
 
     return element;
 }
@@ -190,11 +231,34 @@ void *waitui_list_peek(waitui_list *this) {
     return this->head->element;
 }
 
+waitui_list_node *waitui_list_getFirstNode(waitui_list *this) {
+    if (!this) { return NULL; }
+    return this->head;
+}
+
+waitui_list_node *waitui_list_node_getNext(waitui_list_node *this) {
+    if (!this) { return NULL; }
+    return this->next;
+}
+
+void *waitui_list_node_getElement(waitui_list_node *this) {
+    if (!this) { return NULL; }
+    return this->element;
+}
+
 waitui_list_iter *waitui_list_getIterator(waitui_list *this) {
     if (!this) { return NULL; }
     return waitui_list_iter_new(this->head);
 }
 
+waitui_list_iter waitui_list_iterate(waitui_list *this) {
+    waitui_list_iter iter = {NULL};
+
+    if (this) { iter.node = this->head; }
+
+    return iter;
+}
+
 bool waitui_list_iter_hasNext(waitui_list_iter *this) {
     if (!this) { return false; }
     return this->node != NULL;
@@ -9,6 +9,7 @@
 #define WAITUI_LOG_H
 
 #include <stdarg.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <time.h>
@@ -59,24 +60,54 @@ typedef enum {
 //  Public defines
 // -----------------------------------------------------------------------------
 
-#define waitui_log_trace(...)                                                  \
-    waitui_log_writeLog(WAITUI_LOG_TRACE, __FILE__, __LINE__, __VA_ARGS__)
-#define waitui_log_debug(...)                                                  \
-    waitui_log_writeLog(WAITUI_LOG_DEBUG, __FILE__, __LINE__, __VA_ARGS__)
-#define waitui_log_info(...)                                                   \
-    waitui_log_writeLog(LOG_INFO, __FILE__, __LINE__, __VA_ARGS__)
-#define waitui_log_warn(...)                                                   \
-    waitui_log_writeLog(LOG_WARN, __FILE__, __LINE__, __VA_ARGS__)
-#define waitui_log_error(...)                                                  \
-    waitui_log_writeLog(WAITUI_LOG_ERROR, __FILE__, __LINE__, __VA_ARGS__)
-#define waitui_log_fatal(...)                                                  \
-    waitui_log_writeLog(WAITUI_LOG_FATAL, __FILE__, __LINE__, __VA_ARGS__)
+/**
+ * @brief The minimal log level compiled in, log calls below it compile to
+ *        nothing. Set it through the WAITUI_LOG_MIN_LEVEL CMake option.
+ */
+#ifndef WAITUI_LOG_MIN_LEVEL
+#define WAITUI_LOG_MIN_LEVEL WAITUI_LOG_TRACE
+#endif
+
+/**
+ * @brief Write the log message if the level is compiled in and any sink wants
+ *        it, the arguments are only evaluated in that case.
+ */
+#define WAITUI_LOG_WRITE(level, ...)                                           \
+    do {                                                                       \
+        if ((level) >= WAITUI_LOG_MIN_LEVEL && waitui_log_isEnabled(level)) {  \
+            waitui_log_writeLog((level), __FILE__, __LINE__, __VA_ARGS__);     \
+        }                                                                      \
+    } while (0)
+
+#define waitui_log_trace(...) WAITUI_LOG_WRITE(WAITUI_LOG_TRACE, __VA_ARGS__)
+#define waitui_log_debug(...) WAITUI_LOG_WRITE(WAITUI_LOG_DEBUG, __VA_ARGS__)
+#define waitui_log_info(...) WAITUI_LOG_WRITE(WAITUI_LOG_INFO, __VA_ARGS__)
+#define waitui_log_warn(...) WAITUI_LOG_WRITE(WAITUI_LOG_WARN, __VA_ARGS__)
+#define waitui_log_error(...) WAITUI_LOG_WRITE(WAITUI_LOG_ERROR, __VA_ARGS__)
+#define waitui_log_fatal(...) WAITUI_LOG_WRITE(WAITUI_LOG_FATAL, __VA_ARGS__)
+
 
+// -----------------------------------------------------------------------------
+//  Public variables
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The lowest level any sink currently writes, kept up to date by the
+ *        setters of the log. Only read it through waitui_log_isEnabled.
+ */
+extern _Atomic waitui_log_level waitui_log_enabledLevel;
 
 // -----------------------------------------------------------------------------
 //  Public functions
 // -----------------------------------------------------------------------------
 
+/**
+ * @brief Return the name of the log level.
+ * @param level The log level to return the name for
+ * @return The name of the log level or empty when out of bounds
+ */
+extern const char *waitui_log_getLevelString(waitui_log_level level);
+
 /**
  * @brief Set locking function for log.
  * @param lockFn The function to be called for lock and unlock when writing logs
@@ -106,6 +137,33 @@ extern void waitui_log_setQuiet(bool enable);
 extern int waitui_log_addCallback(waitui_log_logging_fn logFn, void *userData,
                                   waitui_log_level level);
 
+/**
+ * @brief Add the logFn as a log callback that many threads may call at once.
+ * @param logFn The function to add as a concurrent log callback
+ * @param userData Extra user data to pass to the logFn
+ * @param level The level from which on this log callback is executed
+ * @retval 1 Successful added the callback
+ * @retval 0 No more space to add the callback
+ * @note Concurrent log callbacks are called without the lock set with
+ *       waitui_log_set_lock, so the logging threads do not wait for each
+ *       other. Callbacks are added and removed by one thread at a time.
+ */
+extern int waitui_log_addConcurrentCallback(waitui_log_logging_fn logFn,
+                                            void *userData,
+                                            waitui_log_level level);
+
+/**
+ * @brief Remove the log callback added with the logFn and userData.
+ * @param logFn The function of the log callback to remove
+ * @param userData The user data of the log callback to remove
+ * @retval 1 Successful removed the callback
+ * @retval 0 No such callback registered
+ * @note Returns only once no other thread is inside the callback any more, so
+ *       its user data can be released right after.
+ */
+extern int waitui_log_removeCallback(waitui_log_logging_fn logFn,
+                                     void *userData);
+
 /**
  * @brief Add a log callback to write logs starting at the level into the file.
  * @param file The file into which to write the log
@@ -115,6 +173,16 @@ extern int waitui_log_addCallback(waitui_log_logging_fn logFn, void *userData,
  */
 extern int waitui_log_addFile(FILE *file, waitui_log_level level);
 
+/**
+ * @brief Check whether any sink writes logs of the level.
+ * @param level The log level to check
+ * @return true if a log of the level would be written, else false
+ */
+static inline bool waitui_log_isEnabled(waitui_log_level level) {
+    return level >= atomic_load_explicit(&waitui_log_enabledLevel,
+                                         memory_order_relaxed);
+}
+
 /**
  * @brief Write the log message to log with the given parameters.
  * @param level The log level for this message
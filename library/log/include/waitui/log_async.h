@@ -0,0 +1,74 @@
+/**
+ * @file log_async.h
+ * @author rick
+ * @date 17.10.26
+ * @brief File for the asynchronous Log sink implementation
+ */
+
+#ifndef WAITUI_LOG_ASYNC_H
+#define WAITUI_LOG_ASYNC_H
+
+#include "waitui/log.h"
+
+
+// -----------------------------------------------------------------------------
+//  Public types
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Type representing an asynchronous Log sink.
+ */
+typedef struct waitui_log_async waitui_log_async;
+
+
+// -----------------------------------------------------------------------------
+//  Public functions
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Create an asynchronous Log sink and start its writer thread.
+ * @param[in] fd The file descriptor the writer thread writes the logs to
+ * @param[in] capacity The number of log records the ring buffer can hold
+ * @return A pointer to waitui_log_async or NULL if creation failed
+ * @note The capacity is rounded up to a power of two. Logs written while the
+ *       ring buffer is full are dropped and counted.
+ */
+extern waitui_log_async *waitui_log_async_new(int fd,
+                                              unsigned long int capacity);
+
+/**
+ * @brief Remove the sink from the log, write all pending logs and destroy it.
+ * @param[in,out] this The asynchronous Log sink to destroy
+ * @note Other threads may keep logging, the removal waits until no thread is
+ *       inside the callback any more.
+ */
+extern void waitui_log_async_destroy(waitui_log_async **this);
+
+/**
+ * @brief The log callback capturing the event into the ring buffer.
+ * @param[in] event The log event with the asynchronous Log sink as userData
+ * @note The message is formatted on the calling thread, everything else
+ *       happens on the writer thread. The callback is safe to add with
+ *       waitui_log_addConcurrentCallback.
+ */
+extern void waitui_log_async_callback(waitui_log_event *event);
+
+/**
+ * @brief Add the asynchronous Log sink as log callback starting at the level.
+ * @param[in] this The asynchronous Log sink to add
+ * @param[in] level The level from which on the sink is executed
+ * @retval 1 Successful added the sink
+ * @retval 0 No more space to add the callback
+ * @note The sink is added as concurrent log callback, so logging through it
+ *       does not take the lock of the log.
+ */
+extern int waitui_log_addAsync(waitui_log_async *this, waitui_log_level level);
+
+/**
+ * @brief Return the number of logs dropped because the ring buffer was full.
+ * @param[in] this The asynchronous Log sink to ask
+ * @return The number of dropped logs
+ */
+extern unsigned long int waitui_log_async_getDropped(waitui_log_async *this);
+
+#endif//WAITUI_LOG_ASYNC_H
@@ -7,6 +7,9 @@
 
 #include "waitui/log.h"
 
+#include <sched.h>
+#include <stdatomic.h>
+
 
 // -----------------------------------------------------------------------------
 //  Local defines
@@ -17,6 +20,11 @@
  */
 #define MAX_CALLBACKS 32
 
+/**
+ * @brief The maximum number of possible concurrent callbacks to register.
+ */
+#define MAX_CONCURRENT_CALLBACKS 8
+
 
 // -----------------------------------------------------------------------------
 //  Local types
@@ -31,18 +39,42 @@ typedef struct waitui_log_callback {
     void *userData;
 } waitui_log_callback;
 
+/**
+ * @brief Internal type to store a concurrent log callback with all its info.
+ * @note The fields are only written while the callback is not active. A
+ *       logging thread counts itself as caller before it checks active a
+ *       second time and reads the fields, so a removal only has to wait until
+ *       no callers are left.
+ */
+typedef struct waitui_log_concurrent_callback {
+    waitui_log_logging_fn logFn;
+    waitui_log_level level;
+    void *userData;
+    atomic_bool active;
+    atomic_uint callers;
+} waitui_log_concurrent_callback;
+
 /**
  * @brief Internal type to store the log with all its info.
  */
 typedef struct waitui_log {
     waitui_log_lock_fn lockFn;
     waitui_log_level level;
+    _Atomic waitui_log_level lockedLevel;
     bool quiet;
     waitui_log_callback callbacks[MAX_CALLBACKS];
+    waitui_log_concurrent_callback concurrent[MAX_CONCURRENT_CALLBACKS];
     void *userData;
 } log;
 
 
+// -----------------------------------------------------------------------------
+//  Public variables
+// -----------------------------------------------------------------------------
+
+_Atomic waitui_log_level waitui_log_enabledLevel = WAITUI_LOG_TRACE;
+
+
 // -----------------------------------------------------------------------------
 //  Local variables
 // -----------------------------------------------------------------------------
@@ -146,6 +178,56 @@ static void waitui_log_file_callback(waitui_log_event *event) {
     fflush(event->userData);
 }
 
+/**
+ * @brief Recalculate the lowest level any sink writes and the lowest level a
+ *        sink called under the lock writes.
+ */
+static void waitui_log_updateEnabledLevel(void) {
+    waitui_log_level level = L.quiet ? WAITUI_LOG_MAX : L.level;
+
+    for (int i = 0; i < MAX_CALLBACKS && L.callbacks[i].logFn; ++i) {
+        if (L.callbacks[i].level < level) { level = L.callbacks[i].level; }
+    }
+    atomic_store_explicit(&L.lockedLevel, level, memory_order_relaxed);
+
+    for (int i = 0; i < MAX_CONCURRENT_CALLBACKS; ++i) {
+        waitui_log_concurrent_callback *cb = &L.concurrent[i];
+        if (atomic_load(&cb->active) && cb->level < level) {
+            level = cb->level;
+        }
+    }
+
+    atomic_store_explicit(&waitui_log_enabledLevel, level,
+                          memory_order_relaxed);
+}
+
+/**
+ * @brief Remove the concurrent log callback added with the logFn and userData.
+ * @param logFn The function of the concurrent log callback to remove
+ * @param userData The user data of the concurrent log callback to remove
+ * @retval 1 Successful removed the callback
+ * @retval 0 No such callback registered
+ * @note Returns only once no thread is inside the callback any more.
+ */
+static int waitui_log_removeConcurrentCallback(waitui_log_logging_fn logFn,
+                                               void *userData) {
+    for (int i = 0; i < MAX_CONCURRENT_CALLBACKS; ++i) {
+        waitui_log_concurrent_callback *cb = &L.concurrent[i];
+        if (!atomic_load(&cb->active) || cb->logFn != logFn ||
+            cb->userData != userData) {
+            continue;
+        }
+
+        atomic_store(&cb->active, false);
+        waitui_log_updateEnabledLevel();
+
+        while (atomic_load(&cb->callers) > 0) { sched_yield(); }
+
+        return 1;
+    }
+    return 0;
+}
+
 /**
  * @brief TODO
  * @param event
@@ -153,9 +235,18 @@ static void waitui_log_file_callback(waitui_log_event *event) {
  */
 static inline void waitui_log_init_event(waitui_log_event *event,
                                          void *userData) {
+    static _Thread_local time_t cachedSeconds = -1;
+    static _Thread_local struct tm cachedTime;
+
     if (!event->time) {
-        time_t t    = time(NULL);
-        event->time = localtime(&t);
+        time_t t = time(NULL);
+
+        // localtime is expensive, so convert only once per second
+        if (t != cachedSeconds) {
+            localtime_r(&t, &cachedTime);
+            cachedSeconds = t;
+        }
+        event->time = &cachedTime;
     }
 
     event->userData = userData;
@@ -166,28 +257,92 @@ static inline void waitui_log_init_event(waitui_log_event *event,
 //  Public functions
 // -----------------------------------------------------------------------------
 
+const char *waitui_log_getLevelString(waitui_log_level level) {
+    return waitui_log_levelAsString(level);
+}
+
 void waitui_log_set_lock(waitui_log_lock_fn lockFn, void *userData) {
     L.lockFn   = lockFn;
     L.userData = userData;
 }
 
-void waitui_log_setLevel(waitui_log_level level) { L.level = level; }
+void waitui_log_setLevel(waitui_log_level level) {
+    L.level = level;
+    waitui_log_updateEnabledLevel();
+}
 
-void waitui_log_setQuiet(bool enable) { L.quiet = enable; }
+void waitui_log_setQuiet(bool enable) {
+    L.quiet = enable;
+    waitui_log_updateEnabledLevel();
+}
 
 int waitui_log_addCallback(waitui_log_logging_fn logFn, void *userData,
                            waitui_log_level level) {
+    int result = 0;
+
+    waitui_log_lock();
+
     for (int i = 0; i < MAX_CALLBACKS; ++i) {
         if (!L.callbacks[i].logFn) {
             L.callbacks[i] = (waitui_log_callback){.logFn    = logFn,
                                                    .userData = userData,
                                                    .level    = level};
-            return 1;
+            waitui_log_updateEnabledLevel();
+            result = 1;
+            break;
         }
     }
+
+    waitui_log_unlock();
+
+    return result;
+}
+
+int waitui_log_addConcurrentCallback(waitui_log_logging_fn logFn,
+                                     void *userData, waitui_log_level level) {
+    for (int i = 0; i < MAX_CONCURRENT_CALLBACKS; ++i) {
+        waitui_log_concurrent_callback *cb = &L.concurrent[i];
+        if (atomic_load(&cb->active)) { continue; }
+
+        cb->logFn    = logFn;
+        cb->userData = userData;
+        cb->level    = level;
+        atomic_store(&cb->active, true);
+
+        waitui_log_updateEnabledLevel();
+        return 1;
+    }
     return 0;
 }
 
+int waitui_log_removeCallback(waitui_log_logging_fn logFn, void *userData) {
+    int result = 0;
+
+    if (waitui_log_removeConcurrentCallback(logFn, userData)) { return 1; }
+
+    waitui_log_lock();
+
+    for (int i = 0; i < MAX_CALLBACKS && L.callbacks[i].logFn; ++i) {
+        if (L.callbacks[i].logFn != logFn ||
+            L.callbacks[i].userData != userData) {
+            continue;
+        }
+
+        for (; i < MAX_CALLBACKS - 1; ++i) {
+            L.callbacks[i] = L.callbacks[i + 1];
+        }
+        L.callbacks[MAX_CALLBACKS - 1] = (waitui_log_callback){0};
+
+        waitui_log_updateEnabledLevel();
+        result = 1;
+        break;
+    }
+
+    waitui_log_unlock();
+
+    return result;
+}
+
 int waitui_log_addFile(FILE *file, waitui_log_level level) {
     return waitui_log_addCallback(waitui_log_file_callback, file, level);
 }
@@ -201,24 +356,41 @@ void waitui_log_writeLog(waitui_log_level level, const char *file, int line,
             .level  = level,
     };
 
-    waitui_log_lock();
+    if (level >= atomic_load_explicit(&L.lockedLevel, memory_order_relaxed)) {
+        waitui_log_lock();
 
-    if (!L.quiet && level >= L.level) {
-        waitui_log_init_event(&event, stderr);
-        va_start(event.ap, format);
-        waitui_log_stdout_callback(&event);
-        va_end(event.ap);
+        if (!L.quiet && level >= L.level) {
+            waitui_log_init_event(&event, stderr);
+            va_start(event.ap, format);
+            waitui_log_stdout_callback(&event);
+            va_end(event.ap);
+        }
+
+        for (int i = 0; i < MAX_CALLBACKS && L.callbacks[i].logFn; ++i) {
+            waitui_log_callback *cb = &L.callbacks[i];
+            if (level >= cb->level) {
+                waitui_log_init_event(&event, cb->userData);
+                va_start(event.ap, format);
+                cb->logFn(&event);
+                va_end(event.ap);
+            }
+        }
+
+        waitui_log_unlock();
     }
 
-    for (int i = 0; i < MAX_CALLBACKS && L.callbacks[i].logFn; ++i) {
-        waitui_log_callback *cb = &L.callbacks[i];
-        if (level >= cb->level) {
+    // the concurrent callbacks are called without the lock
+    for (int i = 0; i < MAX_CONCURRENT_CALLBACKS; ++i) {
+        waitui_log_concurrent_callback *cb = &L.concurrent[i];
+        if (!atomic_load(&cb->active)) { continue; }
+
+        atomic_fetch_add(&cb->callers, 1);
+        if (atomic_load(&cb->active) && level >= cb->level) {
             waitui_log_init_event(&event, cb->userData);
             va_start(event.ap, format);
             cb->logFn(&event);
             va_end(event.ap);
         }
+        atomic_fetch_sub(&cb->callers, 1);
     }
-
-    waitui_log_unlock();
 }
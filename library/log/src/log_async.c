@@ -0,0 +1,307 @@
+/**
+ * @file log_async.c
+ * @author rick
+ * @date 17.10.26
+ * @brief File for the asynchronous Log sink implementation
+ */
+
+#include "waitui/log_async.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+
+// -----------------------------------------------------------------------------
+//  Local defines
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The maximal length of a formatted message, longer ones are truncated.
+ */
+#define WAITUI_LOG_ASYNC_MESSAGE_SIZE 384
+
+/**
+ * @brief The maximal length of one written log line.
+ */
+#define WAITUI_LOG_ASYNC_LINE_SIZE 1024
+
+/**
+ * @brief The size of the buffer the writer thread collects lines in.
+ */
+#define WAITUI_LOG_ASYNC_WRITE_SIZE (64 * 1024)
+
+/**
+ * @brief How long the writer thread sleeps when the ring buffer is empty.
+ */
+#define WAITUI_LOG_ASYNC_IDLE_NANOSECONDS 1000000L
+
+
+// -----------------------------------------------------------------------------
+//  Local types
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Type representing a log record in the ring buffer.
+ */
+typedef struct waitui_log_async_record {
+    atomic_size_t sequence;
+    waitui_log_level level;
+    int line;
+    const char *file;
+    struct tm time;
+    unsigned int length;
+    char message[WAITUI_LOG_ASYNC_MESSAGE_SIZE];
+} waitui_log_async_record;
+
+/**
+ * @brief Struct representing an asynchronous Log sink.
+ * @note The ring buffer is a bounded multi producer single consumer queue,
+ *       every record carries a sequence number telling whether it is free for
+ *       the position of a producer or filled for the position of the writer.
+ */
+struct waitui_log_async {
+    waitui_log_async_record *records;
+    size_t mask;
+    atomic_size_t enqueuePosition;
+    size_t dequeuePosition;
+    atomic_ulong dropped;
+    atomic_bool stop;
+    pthread_t writer;
+    int fd;
+};
+
+
+// -----------------------------------------------------------------------------
+//  Local functions
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Write the whole buffer to the file descriptor.
+ * @param[in] fd The file descriptor to write to
+ * @param[in] buffer The buffer to write
+ * @param[in] length The length of the buffer
+ */
+static void waitui_log_async_writeAll(int fd, const char *buffer,
+                                      size_t length) {
+    while (length > 0) {
+        ssize_t written = write(fd, buffer, length);
+        if (written < 0) {
+            if (errno == EINTR) { continue; }
+            return;
+        }
+        buffer += written;
+        length -= (size_t) written;
+    }
+}
+
+/**
+ * @brief Format the record as log line into the buffer.
+ * @param[in] record The record to format
+ * @param[out] buffer The buffer to format into
+ * @return The length of the log line
+ * @note The buffer has to hold at least WAITUI_LOG_ASYNC_LINE_SIZE bytes.
+ */
+static size_t waitui_log_async_format(const waitui_log_async_record *record,
+                                      char *buffer) {
+    size_t length = strftime(buffer, WAITUI_LOG_ASYNC_LINE_SIZE,
+                             "%Y-%m-%d %H:%M:%S", &record->time);
+    int prefix    = snprintf(buffer + length,
+                             WAITUI_LOG_ASYNC_LINE_SIZE - length,
+                             " %-5s %s:%d: ",
+                             waitui_log_getLevelString(record->level),
+                             record->file, record->line);
+
+    if (prefix > 0) { length += (size_t) prefix; }
+    if (length > WAITUI_LOG_ASYNC_LINE_SIZE - WAITUI_LOG_ASYNC_MESSAGE_SIZE) {
+        length = WAITUI_LOG_ASYNC_LINE_SIZE - WAITUI_LOG_ASYNC_MESSAGE_SIZE;
+    }
+
+    memcpy(buffer + length, record->message, record->length);
+    length += record->length;
+    buffer[length++] = '\n';
+
+    return length;
+}
+
+/**
+ * @brief Take the oldest filled record out of the ring buffer.
+ * @param[in,out] this The asynchronous Log sink to take the record from
+ * @param[out] buffer The buffer to format the record into
+ * @return The length of the formatted log line or 0 if the ring buffer is empty
+ */
+static size_t waitui_log_async_dequeue(waitui_log_async *this, char *buffer) {
+    size_t position                 = this->dequeuePosition;
+    waitui_log_async_record *record = &this->records[position & this->mask];
+    size_t length                   = 0;
+
+    if (atomic_load_explicit(&record->sequence, memory_order_acquire) !=
+        position + 1) {
+        return 0;
+    }
+
+    length = waitui_log_async_format(record, buffer);
+
+    atomic_store_explicit(&record->sequence, position + this->mask + 1,
+                          memory_order_release);
+    this->dequeuePosition = position + 1;
+
+    return length;
+}
+
+/**
+ * @brief The writer thread draining the ring buffer in large writes.
+ * @param[in,out] arg The asynchronous Log sink to drain
+ * @return Always NULL
+ */
+static void *waitui_log_async_writer(void *arg) {
+    static const struct timespec idle = {
+            .tv_nsec = WAITUI_LOG_ASYNC_IDLE_NANOSECONDS};
+    waitui_log_async *this = arg;
+    char *buffer           = NULL;
+
+    buffer = malloc(WAITUI_LOG_ASYNC_WRITE_SIZE);
+    if (!buffer) { return NULL; }
+
+    for (;;) {
+        size_t used = 0;
+        size_t line = 0;
+
+        while (used + WAITUI_LOG_ASYNC_LINE_SIZE <=
+                       WAITUI_LOG_ASYNC_WRITE_SIZE &&
+               (line = waitui_log_async_dequeue(this, buffer + used)) > 0) {
+            used += line;
+        }
+
+        if (used > 0) {
+            waitui_log_async_writeAll(this->fd, buffer, used);
+            continue;
+        }
+
+        if (atomic_load(&this->stop)) { break; }
+
+        nanosleep(&idle, NULL);
+    }
+
+    free(buffer);
+
+    return NULL;
+}
+
+
+// -----------------------------------------------------------------------------
+//  Public functions
+// -----------------------------------------------------------------------------
+
+waitui_log_async *waitui_log_async_new(int fd, unsigned long int capacity) {
+    waitui_log_async *this = NULL;
+    size_t size            = 2;
+
+    while (size < capacity) { size <<= 1U; }
+
+    this = calloc(1, sizeof(*this));
+    if (!this) { return NULL; }
+
+    this->records = calloc(size, sizeof(*this->records));
+    if (!this->records) {
+        free(this);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < size; ++i) {
+        atomic_init(&this->records[i].sequence, i);
+    }
+    atomic_init(&this->enqueuePosition, 0);
+    atomic_init(&this->dropped, 0);
+    atomic_init(&this->stop, false);
+    this->mask = size - 1;
+    this->fd   = fd;
+
+    if (pthread_create(&this->writer, NULL, waitui_log_async_writer, this) !=
+        0) {
+        free(this->records);
+        free(this);
+        return NULL;
+    }
+
+    return this;
+}
+
+void waitui_log_async_destroy(waitui_log_async **this) {
+    if (!this || !(*this)) { return; }
+
+    waitui_log_removeCallback(waitui_log_async_callback, *this);
+
+    atomic_store(&(*this)->stop, true);
+    pthread_join((*this)->writer, NULL);
+
+    free((*this)->records);
+    free(*this);
+    *this = NULL;
+}
+
+void waitui_log_async_callback(waitui_log_event *event) {
+    waitui_log_async *this          = event->userData;
+    waitui_log_async_record *record = NULL;
+    size_t position                 = 0;
+    int length                      = 0;
+
+    position = atomic_load_explicit(&this->enqueuePosition,
+                                    memory_order_relaxed);
+
+    for (;;) {
+        size_t sequence = 0;
+
+        record   = &this->records[position & this->mask];
+        sequence = atomic_load_explicit(&record->sequence,
+                                        memory_order_acquire);
+
+        if (sequence == position) {
+            if (atomic_compare_exchange_weak_explicit(
+                        &this->enqueuePosition, &position, position + 1,
+                        memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if ((ptrdiff_t) (sequence - position) < 0) {
+            atomic_fetch_add_explicit(&this->dropped, 1, memory_order_relaxed);
+            return;
+        } else {
+            position = atomic_load_explicit(&this->enqueuePosition,
+                                            memory_order_relaxed);
+        }
+    }
+
+    record->level = event->level;
+    record->line  = event->line;
+    record->file  = event->file;
+    record->time  = *event->time;
+
+    length = vsnprintf(record->message, sizeof(record->message), event->format,
+                       event->ap);
+    if (length < 0) { length = 0; }
+    if ((size_t) length >= sizeof(record->message)) {
+        length = sizeof(record->message) - 1;
+    }
+    record->length = (unsigned int) length;
+
+    atomic_store_explicit(&record->sequence, position + 1,
+                          memory_order_release);
+}
+
+int waitui_log_addAsync(waitui_log_async *this, waitui_log_level level) {
+    if (!this) { return 0; }
+
+    return waitui_log_addConcurrentCallback(waitui_log_async_callback, this,
+                                            level);
+}
+
+unsigned long int waitui_log_async_getDropped(waitui_log_async *this) {
+    if (!this) { return 0; }
+
+    return atomic_load(&this->dropped);
+}
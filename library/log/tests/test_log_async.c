@@ -0,0 +1,192 @@
+/**
+ * @file test_log_async.c
+ * @author rick
+ * @date 17.10.26
+ * @brief Test for the asynchronous Log sink implementation
+ */
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <cmocka.h>
+
+#include "waitui/log_async.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <time.h>
+
+#define PRODUCER_COUNT 8
+#define MESSAGE_COUNT 2000
+
+typedef struct producer {
+    int id;
+    atomic_bool *running;
+} producer;
+
+static int lockCount = 0;
+
+static void count_lock(bool lock, void *userData) {
+    (void) userData; /* unused */
+
+    if (lock) { lockCount++; }
+}
+
+static void *produce_messages(void *arg) {
+    producer *this = arg;
+
+    for (int i = 0; i < MESSAGE_COUNT; ++i) {
+        waitui_log_info("producer %d message %d", this->id, i);
+    }
+
+    return NULL;
+}
+
+static void *produce_until_stopped(void *arg) {
+    producer *this = arg;
+
+    for (int i = 0; atomic_load(this->running); ++i) {
+        waitui_log_info("producer %d message %d", this->id, i);
+    }
+
+    return NULL;
+}
+
+static int setup(void **state) {
+    (void) state; /* unused */
+
+    waitui_log_setQuiet(true);
+    waitui_log_set_lock(NULL, NULL);
+    return 0;
+}
+
+static void test_log_async_multiple_producers(void **state) {
+    (void) state; /* unused */
+
+    FILE *file             = tmpfile();
+    waitui_log_async *sink = NULL;
+    pthread_t threads[PRODUCER_COUNT];
+    producer producers[PRODUCER_COUNT];
+    int nextMessage[PRODUCER_COUNT] = {0};
+    char line[1024];
+
+    assert_non_null(file);
+    sink = waitui_log_async_new(fileno(file), PRODUCER_COUNT * MESSAGE_COUNT);
+    assert_non_null(sink);
+    assert_true(waitui_log_addAsync(sink, WAITUI_LOG_INFO));
+
+    for (int i = 0; i < PRODUCER_COUNT; ++i) {
+        producers[i].id = i;
+        assert_int_equal(pthread_create(&threads[i], NULL, produce_messages,
+                                        &producers[i]),
+                         0);
+    }
+    for (int i = 0; i < PRODUCER_COUNT; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+
+    assert_int_equal(waitui_log_async_getDropped(sink), 0);
+    waitui_log_async_destroy(&sink);
+    assert_null(sink);
+
+    rewind(file);
+    while (fgets(line, sizeof(line), file)) {
+        const char *message = strstr(line, "producer ");
+        int id              = -1;
+        int number          = -1;
+
+        assert_non_null(message);
+        assert_int_equal(sscanf(message, "producer %d message %d", &id,
+                                &number),
+                         2);
+        assert_in_range(id, 0, PRODUCER_COUNT - 1);
+
+        // the logs of one producer keep their order
+        assert_int_equal(number, nextMessage[id]);
+        nextMessage[id]++;
+    }
+
+    for (int i = 0; i < PRODUCER_COUNT; ++i) {
+        assert_int_equal(nextMessage[i], MESSAGE_COUNT);
+    }
+
+    fclose(file);
+}
+
+static void test_log_async_without_lock(void **state) {
+    (void) state; /* unused */
+
+    FILE *file             = tmpfile();
+    waitui_log_async *sink = NULL;
+
+    assert_non_null(file);
+    sink = waitui_log_async_new(fileno(file), 16);
+    assert_non_null(sink);
+
+    lockCount = 0;
+    waitui_log_set_lock(count_lock, NULL);
+
+    assert_true(waitui_log_addAsync(sink, WAITUI_LOG_INFO));
+    waitui_log_info("not locked");
+    waitui_log_async_destroy(&sink);
+
+    assert_int_equal(lockCount, 0);
+
+    waitui_log_set_lock(NULL, NULL);
+    fclose(file);
+}
+
+static void test_log_async_destroy_while_logging(void **state) {
+    (void) state; /* unused */
+
+    static const struct timespec wait = {.tv_nsec = 10000000L};
+    FILE *file                        = tmpfile();
+    waitui_log_async *sink            = NULL;
+    atomic_bool running               = true;
+    pthread_t threads[PRODUCER_COUNT];
+    producer producers[PRODUCER_COUNT];
+
+    assert_non_null(file);
+    sink = waitui_log_async_new(fileno(file), 64);
+    assert_non_null(sink);
+    assert_true(waitui_log_addAsync(sink, WAITUI_LOG_INFO));
+
+    for (int i = 0; i < PRODUCER_COUNT; ++i) {
+        producers[i].id      = i;
+        producers[i].running = &running;
+        assert_int_equal(pthread_create(&threads[i], NULL,
+                                        produce_until_stopped, &producers[i]),
+                         0);
+    }
+
+    nanosleep(&wait, NULL);
+    waitui_log_async_destroy(&sink);
+    assert_null(sink);
+    nanosleep(&wait, NULL);
+
+    atomic_store(&running, false);
+    for (int i = 0; i < PRODUCER_COUNT; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+
+    assert_false(waitui_log_isEnabled(WAITUI_LOG_FATAL));
+
+    fclose(file);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test_setup_teardown(test_log_async_multiple_producers,
+                                            setup, NULL),
+            cmocka_unit_test_setup_teardown(test_log_async_without_lock, setup,
+                                            NULL),
+            cmocka_unit_test_setup_teardown(
+                    test_log_async_destroy_while_logging, setup, NULL),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
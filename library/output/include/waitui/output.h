@@ -0,0 +1,126 @@
+/**
+ * @file output.h
+ * @author rick
+ * @date 17.10.26
+ * @brief File for the Output implementation
+ */
+
+#ifndef WAITUI_OUTPUT_H
+#define WAITUI_OUTPUT_H
+
+#include <waitui/str.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+
+// -----------------------------------------------------------------------------
+//  Public types
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Type representing an Output.
+ * @note An Output collects everything appended to it in a large buffer and
+ *       writes the buffer to its file in one block once it is full, so
+ *       emitting many small pieces costs a memcpy each instead of a formatted
+ *       and locked stdio call each. An Output in memory has no file and grows
+ *       its buffer instead, to be appended to another Output later.
+ */
+typedef struct waitui_output waitui_output;
+
+
+// -----------------------------------------------------------------------------
+//  Public functions
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Create an Output writing to the file.
+ * @param[in,out] file The file to write the buffered output to
+ * @return A pointer to waitui_output or NULL if memory allocation failed
+ * @note The file is not owned by the Output.
+ */
+extern waitui_output *waitui_output_new(FILE *file);
+
+/**
+ * @brief Create an Output collecting everything appended to it in memory.
+ * @return A pointer to waitui_output or NULL if memory allocation failed
+ */
+extern waitui_output *waitui_output_newInMemory(void);
+
+/**
+ * @brief Flush and destroy the Output.
+ * @param[in,out] this The Output to destroy
+ */
+extern void waitui_output_destroy(waitui_output **this);
+
+/**
+ * @brief Write everything buffered by the Output to its file.
+ * @param[in,out] this The Output to flush
+ * @retval 1 Ok
+ * @retval 0 Writing to the file failed now or before
+ * @note An Output in memory keeps its buffer.
+ */
+extern int waitui_output_flush(waitui_output *this);
+
+/**
+ * @brief Return whether writing to the file of the Output failed.
+ * @param[in] this The Output to ask
+ * @retval true If any write or allocation failed, the rest of the output
+ *              got dropped
+ * @retval false If all writes so far succeeded
+ */
+extern bool waitui_output_hasFailed(const waitui_output *this);
+
+/**
+ * @brief Append the bytes to the Output.
+ * @param[in,out] this The Output to append to
+ * @param[in] data The bytes to append
+ * @param[in] length The number of bytes to append
+ */
+extern void waitui_output_append(waitui_output *this, const char *data,
+                                 size_t length);
+
+/**
+ * @brief Append everything buffered by the other Output to the Output.
+ * @param[in,out] this The Output to append to
+ * @param[in] other The Output to append the buffer of, usually in memory
+ * @note A failure of the other Output makes the Output fail as well.
+ */
+extern void waitui_output_appendOutput(waitui_output *this,
+                                       const waitui_output *other);
+
+/**
+ * @brief Append the NUL terminated string to the Output.
+ * @param[in,out] this The Output to append to
+ * @param[in] value The string to append, NULL appends nothing
+ */
+extern void waitui_output_appendString(waitui_output *this, const char *value);
+
+/**
+ * @brief Append the str to the Output.
+ * @param[in,out] this The Output to append to
+ * @param[in] value The str to append, NULL appends nothing
+ */
+extern void waitui_output_appendStr(waitui_output *this, const str *value);
+
+/**
+ * @brief Append the decimal digits of the number to the Output.
+ * @param[in,out] this The Output to append to
+ * @param[in] value The number to append
+ */
+extern void waitui_output_appendU64(waitui_output *this, uint64_t value);
+
+/**
+ * @brief Append the str to the Output with the HTML special characters
+ *        replaced by their entities.
+ * @param[in,out] this The Output to append to
+ * @param[in] value The str to append, NULL appends nothing
+ * @note Escaped are &, <, > and ", so the text is safe inside of HTML content
+ *       and quoted attribute values.
+ */
+extern void waitui_output_appendHtmlEscaped(waitui_output *this,
+                                            const str *value);
+
+#endif//WAITUI_OUTPUT_H
@@ -0,0 +1,235 @@
+/**
+ * @file output.c
+ * @author rick
+ * @date 17.10.26
+ * @brief File for the Output implementation
+ */
+
+#include "waitui/output.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+// -----------------------------------------------------------------------------
+//  Local defines
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The size of the buffer of an Output with a file and the initial size
+ *        of the buffer of an Output in memory.
+ */
+#define WAITUI_OUTPUT_BUFFER_SIZE (64 * 1024)
+
+/**
+ * @brief The maximal number of decimal digits of a 64 bit number.
+ */
+#define WAITUI_OUTPUT_U64_DIGITS 20
+
+
+// -----------------------------------------------------------------------------
+//  Local types
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Struct representing an Output.
+ */
+struct waitui_output {
+    FILE *file;
+    char *buffer;
+    size_t length;
+    size_t capacity;
+    bool failed;
+};
+
+
+// -----------------------------------------------------------------------------
+//  Local functions
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Write the bytes to the file of the Output, bypassing the buffer.
+ * @param[in,out] this The Output to write with
+ * @param[in] data The bytes to write
+ * @param[in] length The number of bytes to write
+ */
+static void waitui_output_write(waitui_output *this, const char *data,
+                                size_t length) {
+    if (this->failed || length == 0) { return; }
+
+    if (fwrite(data, 1, length, this->file) != length) { this->failed = true; }
+}
+
+/**
+ * @brief Grow the buffer of the Output in memory to fit the bytes.
+ * @param[in,out] this The Output to grow
+ * @param[in] length The number of bytes to fit in addition
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ */
+static int waitui_output_grow(waitui_output *this, size_t length) {
+    size_t capacity = this->capacity;
+    char *buffer    = NULL;
+
+    if (!capacity) { capacity = WAITUI_OUTPUT_BUFFER_SIZE; }
+
+    if (this->failed) { return 0; }
+
+    while (length > capacity - this->length) { capacity *= 2; }
+
+    buffer = realloc(this->buffer, capacity);
+    if (!buffer) {
+        this->failed = true;
+        return 0;
+    }
+
+    this->buffer   = buffer;
+    this->capacity = capacity;
+
+    return 1;
+}
+
+/**
+ * @brief Return the HTML entity replacing the character.
+ * @param[in] character The character to look up
+ * @return The entity or NULL if the character needs no escaping
+ */
+static inline const char *waitui_output_getHtmlEntity(char character) {
+    switch (character) {
+        case '&':
+            return "&amp;";
+        case '<':
+            return "&lt;";
+        case '>':
+            return "&gt;";
+        case '"':
+            return "&quot;";
+        default:
+            return NULL;
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+//  Public functions
+// -----------------------------------------------------------------------------
+
+waitui_output *waitui_output_new(FILE *file) {
+    waitui_output *this = NULL;
+
+    if (!file) { return NULL; }
+
+    this = calloc(1, sizeof(*this));
+    if (!this) { return NULL; }
+
+    this->buffer = malloc(WAITUI_OUTPUT_BUFFER_SIZE);
+    if (!this->buffer) {
+        free(this);
+        return NULL;
+    }
+
+    this->file     = file;
+    this->capacity = WAITUI_OUTPUT_BUFFER_SIZE;
+
+    return this;
+}
+
+waitui_output *waitui_output_newInMemory(void) {
+    return calloc(1, sizeof(waitui_output));
+}
+
+void waitui_output_destroy(waitui_output **this) {
+    if (!this || !(*this)) { return; }
+
+    waitui_output_flush(*this);
+
+    free((*this)->buffer);
+    free(*this);
+    *this = NULL;
+}
+
+int waitui_output_flush(waitui_output *this) {
+    if (!this) { return 0; }
+    if (!this->file) { return !this->failed; }
+
+    waitui_output_write(this, this->buffer, this->length);
+    this->length = 0;
+
+    return !this->failed;
+}
+
+bool waitui_output_hasFailed(const waitui_output *this) {
+    if (!this) { return true; }
+    return this->failed;
+}
+
+void waitui_output_append(waitui_output *this, const char *data,
+                          size_t length) {
+    if (!this || !data) { return; }
+
+    if (length > this->capacity - this->length) {
+        if (!this->file) {
+            if (!waitui_output_grow(this, length)) { return; }
+        } else {
+            waitui_output_flush(this);
+            if (length > this->capacity) {
+                waitui_output_write(this, data, length);
+                return;
+            }
+        }
+    }
+
+    if (length == 0) { return; }
+
+    memcpy(this->buffer + this->length, data, length);
+    this->length += length;
+}
+
+void waitui_output_appendOutput(waitui_output *this,
+                                const waitui_output *other) {
+    if (!this || !other) { return; }
+
+    if (other->failed) { this->failed = true; }
+    waitui_output_append(this, other->buffer, other->length);
+}
+
+void waitui_output_appendString(waitui_output *this, const char *value) {
+    if (!value) { return; }
+    waitui_output_append(this, value, strlen(value));
+}
+
+void waitui_output_appendStr(waitui_output *this, const str *value) {
+    if (!value) { return; }
+    waitui_output_append(this, value->s, value->len);
+}
+
+void waitui_output_appendU64(waitui_output *this, uint64_t value) {
+    char digits[WAITUI_OUTPUT_U64_DIGITS];
+    size_t start = WAITUI_OUTPUT_U64_DIGITS;
+
+    do {
+        digits[--start] = (char) ('0' + value % 10);
+        value /= 10;
+    } while (value);
+
+    waitui_output_append(this, digits + start,
+                         WAITUI_OUTPUT_U64_DIGITS - start);
+}
+
+void waitui_output_appendHtmlEscaped(waitui_output *this, const str *value) {
+    unsigned long int start = 0;
+
+    if (!value || !value->s) { return; }
+
+    for (unsigned long int i = 0; i < value->len; ++i) {
+        const char *entity = waitui_output_getHtmlEntity(value->s[i]);
+
+        if (!entity) { continue; }
+
+        waitui_output_append(this, value->s + start, i - start);
+        waitui_output_appendString(this, entity);
+        start = i + 1;
+    }
+
+    waitui_output_append(this, value->s + start, value->len - start);
+}
@@ -0,0 +1,206 @@
+/**
+ * @file test_output.c
+ * @author rick
+ * @date 17.10.26
+ * @brief Test for the Output implementation
+ */
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <cmocka.h>
+
+#include "waitui/output.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct text {
+    char *data;
+    size_t size;
+    FILE *file;
+    waitui_output *output;
+} text;
+
+/**
+ * Create an Output writing to a file in memory.
+ */
+static void open_text(text *this) {
+    *this      = (text){0};
+    this->file = open_memstream(&this->data, &this->size);
+    assert_non_null(this->file);
+
+    this->output = waitui_output_new(this->file);
+    assert_non_null(this->output);
+}
+
+/**
+ * Destroy the Output, which flushes it, and test what it wrote.
+ */
+static void assert_text(text *this, const char *expected, size_t length) {
+    waitui_output_destroy(&this->output);
+    assert_null(this->output);
+    fclose(this->file);
+
+    assert_int_equal(this->size, length);
+    assert_memory_equal(this->data, expected, length);
+    free(this->data);
+}
+
+static void test_output_append_u64(void **state) {
+    (void) state; /* unused */
+
+    text out = {0};
+
+    open_text(&out);
+    waitui_output_appendU64(out.output, 0);
+    waitui_output_appendString(out.output, " ");
+    waitui_output_appendU64(out.output, 42);
+    waitui_output_appendString(out.output, " ");
+    waitui_output_appendU64(out.output, UINT64_MAX);
+    assert_false(waitui_output_hasFailed(out.output));
+
+    assert_text(&out, "0 42 18446744073709551615", 25);
+}
+
+static void test_output_append_html_escaped(void **state) {
+    (void) state; /* unused */
+
+    static const char expected[] = "&amp;&lt;&gt;&quot; a&amp;b &lt;tag "
+                                   "x=&quot;1&quot;&gt;";
+    str special                  = STR_STATIC_INIT("&<>\"");
+    str mixed                    = STR_STATIC_INIT(" a&b <tag x=\"1\">");
+    str empty                    = STR_NULL_INIT;
+    text out                     = {0};
+
+    open_text(&out);
+    waitui_output_appendHtmlEscaped(out.output, &special);
+    waitui_output_appendHtmlEscaped(out.output, &mixed);
+    waitui_output_appendHtmlEscaped(out.output, &empty);
+    waitui_output_appendHtmlEscaped(out.output, NULL);
+
+    assert_text(&out, expected, sizeof(expected) - 1);
+}
+
+static void test_output_in_memory_growth(void **state) {
+    (void) state; /* unused */
+
+    static const size_t size = 200 * 1024;
+    waitui_output *memory    = waitui_output_newInMemory();
+    char *expected           = malloc(size);
+    text out                 = {0};
+
+    assert_non_null(memory);
+    assert_non_null(expected);
+
+    // small pieces and one piece larger than the initial 64 KiB buffer
+    for (size_t i = 0; i < size; ++i) { expected[i] = (char) ('a' + i % 26); }
+    for (size_t i = 0; i < 1024; i += 13) {
+        waitui_output_append(memory, expected + i,
+                             i + 13 <= 1024 ? 13 : 1024 - i);
+    }
+    waitui_output_append(memory, expected + 1024, 100 * 1024);
+    waitui_output_append(memory, expected + 101 * 1024, size - 101 * 1024);
+    assert_false(waitui_output_hasFailed(memory));
+
+    // an Output in memory keeps its buffer when flushed
+    assert_true(waitui_output_flush(memory));
+
+    open_text(&out);
+    waitui_output_appendOutput(out.output, memory);
+    waitui_output_appendOutput(out.output, memory);
+    waitui_output_destroy(&memory);
+
+    waitui_output_destroy(&out.output);
+    fclose(out.file);
+    assert_int_equal(out.size, 2 * size);
+    assert_memory_equal(out.data, expected, size);
+    assert_memory_equal(out.data + size, expected, size);
+    free(out.data);
+    free(expected);
+}
+
+static void test_output_append_output(void **state) {
+    (void) state; /* unused */
+
+    waitui_output *first  = waitui_output_newInMemory();
+    waitui_output *second = waitui_output_newInMemory();
+    waitui_output *empty  = waitui_output_newInMemory();
+    text out              = {0};
+
+    assert_non_null(first);
+    assert_non_null(second);
+    assert_non_null(empty);
+
+    waitui_output_appendString(first, "first ");
+    waitui_output_appendString(second, "second");
+
+    open_text(&out);
+    waitui_output_appendString(out.output, "[");
+    waitui_output_appendOutput(out.output, first);
+    waitui_output_appendOutput(out.output, empty);
+    waitui_output_appendOutput(out.output, second);
+    waitui_output_appendOutput(out.output, NULL);
+    waitui_output_appendString(out.output, "]");
+    assert_false(waitui_output_hasFailed(out.output));
+
+    waitui_output_destroy(&first);
+    waitui_output_destroy(&second);
+    waitui_output_destroy(&empty);
+
+    assert_text(&out, "[first second]", 14);
+}
+
+static void test_output_failed(void **state) {
+    (void) state; /* unused */
+
+    FILE *file            = fopen("/dev/null", "r");
+    waitui_output *output = NULL;
+    text out              = {0};
+
+    assert_non_null(file);
+
+    // the write of the buffer into the read only file fails on the flush
+    output = waitui_output_new(file);
+    assert_non_null(output);
+    waitui_output_appendString(output, "lost");
+    assert_false(waitui_output_hasFailed(output));
+    assert_false(waitui_output_flush(output));
+    assert_true(waitui_output_hasFailed(output));
+
+    // the failure sticks, even when nothing is left to write
+    waitui_output_appendString(output, "dropped");
+    assert_false(waitui_output_flush(output));
+    assert_true(waitui_output_hasFailed(output));
+
+    // appending an Output that failed makes the Output fail as well
+    open_text(&out);
+    waitui_output_appendString(out.output, "kept");
+    assert_true(waitui_output_flush(out.output));
+    waitui_output_appendOutput(out.output, output);
+    assert_true(waitui_output_hasFailed(out.output));
+    assert_false(waitui_output_flush(out.output));
+
+    waitui_output_destroy(&output);
+    fclose(file);
+    assert_text(&out, "kept", 4);
+
+    assert_true(waitui_output_hasFailed(NULL));
+    assert_false(waitui_output_flush(NULL));
+    assert_null(waitui_output_new(NULL));
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test(test_output_append_u64),
+            cmocka_unit_test(test_output_append_html_escaped),
+            cmocka_unit_test(test_output_in_memory_growth),
+            cmocka_unit_test(test_output_append_output),
+            cmocka_unit_test(test_output_failed),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,127 @@
+/**
+ * @file module_cache.h
+ * @author rick
+ * @date 17.10.26
+ * @brief File for the Module cache implementation
+ */
+
+#ifndef WAITUI_MODULE_CACHE_H
+#define WAITUI_MODULE_CACHE_H
+
+#include <waitui/ast.h>
+#include <waitui/str.h>
+
+#include <stdio.h>
+
+
+// -----------------------------------------------------------------------------
+//  Public types
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Type representing a Module cache.
+ * @note The Module cache holds the AST of every imported module of a build,
+ *       keyed by the canonical path of its source file. Every module is parsed
+ *       once and shared by all importing files, also across threads.
+ */
+typedef struct parser_module_cache parser_module_cache;
+
+/**
+ * @brief Callback type for every module an AST depends on.
+ * @param[in,out] args The extra argument given to the walk
+ * @param[in] canonicalPath The canonical path of the source file of the module
+ * @retval 1 Ok
+ * @retval 0 Stop the walk
+ */
+typedef int (*parser_module_cache_dependency)(void *args, str canonicalPath);
+
+
+// -----------------------------------------------------------------------------
+//  Public functions
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Create a Module cache.
+ * @param[in] searchPaths The directories to search imported modules in
+ * @param[in] searchPathCount The number of directories
+ * @return A pointer to parser_module_cache or NULL if memory allocation failed
+ * @note Without search paths the current directory is searched.
+ */
+extern parser_module_cache *parser_module_cache_new(const str *searchPaths,
+                                                    unsigned long int
+                                                            searchPathCount);
+
+/**
+ * @brief Destroy a Module cache and the ASTs of all modules.
+ * @param[in,out] this The Module cache to destroy
+ * @note The ASTs importing the modules hold pointers to the module ASTs, so
+ *       the Module cache has to outlive them.
+ */
+extern void parser_module_cache_destroy(parser_module_cache **this);
+
+/**
+ * @brief Return the AST of the imported module, parse it on first use.
+ * @param[in,out] this The Module cache to load the module from
+ * @param[in] importName The name of the import, like org.test.home
+ * @param[in] diagnostics The file to write the errors of the import to
+ * @return A pointer to the module AST or NULL if it could not be loaded
+ * @note The import org.test.home is searched as org/test/home.wai and then as
+ *       org/test.wai, so a class can be imported out of its namespace file.
+ *       Returns only once the imports of the module and of every module it
+ *       imports, also indirectly, are resolved, so the whole import graph can
+ *       be read without the lock. When other threads parse or resolve any of
+ *       these modules right now, the call waits for them.
+ *       The errors inside of the module are kept by the Module cache, see
+ *       parser_module_cache_writeDiagnostics.
+ */
+extern waitui_ast *parser_module_cache_load(parser_module_cache *this,
+                                            str importName, FILE *diagnostics);
+
+/**
+ * @brief Resolve every import of the AST to the AST of its module.
+ * @param[in,out] this The Module cache to load the modules from
+ * @param[in,out] ast The AST to resolve the imports of
+ * @param[in] diagnostics The file to write errors to
+ * @retval 1 Ok
+ * @retval 0 At least one import could not be loaded
+ */
+extern int parser_module_cache_resolveImports(parser_module_cache *this,
+                                              waitui_ast *ast,
+                                              FILE *diagnostics);
+
+/**
+ * @brief Write the errors of all modules ordered by their canonical path.
+ * @param[in,out] this The Module cache to write the errors of
+ * @param[in] diagnostics The file to write the errors to
+ * @return The number of modules with errors
+ * @note No module may be loaded at the same time.
+ */
+extern unsigned long int
+parser_module_cache_writeDiagnostics(parser_module_cache *this,
+                                     FILE *diagnostics);
+
+/**
+ * @brief Return the number of modules parsed by the Module cache.
+ * @param[in] this The Module cache to ask
+ * @return The number of parsed modules
+ */
+extern unsigned long int
+parser_module_cache_getParsedCount(parser_module_cache *this);
+
+/**
+ * @brief Call the callback for every module the AST depends on.
+ * @param[in,out] this The Module cache the imports were resolved with
+ * @param[in] ast The AST to walk the imports of
+ * @param[in] callback The callback to call for every module
+ * @param[in,out] args The extra argument for the callback
+ * @retval 1 Ok
+ * @retval 0 A module failed, was not loaded or the callback stopped the walk
+ * @note The modules imported by the imported modules are walked as well, every
+ *       module is passed once. Modules still resolving their imports on other
+ *       threads are waited for.
+ */
+extern int parser_module_cache_forEachDependency(
+        parser_module_cache *this, waitui_ast *ast,
+        parser_module_cache_dependency callback, void *args);
+
+#endif//WAITUI_MODULE_CACHE_H
@@ -8,6 +8,7 @@
 #ifndef WAITUI_PARSER_H
 #define WAITUI_PARSER_H
 
+#include "waitui/module_cache.h"
 #include "waitui/parser_helper.h"
 
 #include <waitui/ast.h>
@@ -20,14 +21,21 @@
 
 /**
  * @brief Type for the Parser.
+ * @note Regular files are mapped and sources held in memory are copied into
+ *       sourceText and scanned in place, only other input like stdin is
+ *       streamed through sourceFile. The sourceText is owned by the Arena, so
+ *       it ends up in the AST with the tokens pointing into it. With a
+ *       moduleCache the imports are resolved after parsing.
  */
 typedef struct parser {
     FILE *sourceFile;
+    str sourceText;
     str sourceFileName;
     str workingDirectory;
     unsigned int debug;
     parser_extra_parser extraParser;
     parser_extra_lexer extraLexer;
+    parser_module_cache *moduleCache;
 } parser;
 
 
@@ -50,28 +58,74 @@ typedef struct parser {
  * @param[in] workingDirectory The working directory to search other files in
  * @param[in] debug The debug level of the parser
  * @return A pointer to Parser or NULL if memory allocation failed
+ * @note Parsers share no state and can run on different threads at the same
+ *       time, except for the trace of PARSER_DEBUG_PARSER which is global.
  */
 extern parser *parser_new(str sourceFileName, str workingDirectory,
                           unsigned int debug);
 
+/**
+ * @brief Create a Parser for a source held in memory.
+ * @param[in] sourceFileName The name the source is reported with
+ * @param[in] source The source to parse, it is copied
+ * @param[in] workingDirectory The working directory to search other files in
+ * @param[in] debug The debug level of the parser
+ * @return A pointer to Parser or NULL if memory allocation failed
+ * @note The copy of the source is scanned in place like a mapped source file.
+ */
+extern parser *parser_new_from_source(str sourceFileName, str source,
+                                      str workingDirectory,
+                                      unsigned int debug);
+
 /**
  * @brief Destroy a Parser.
  * @param[in,out] this The Parser to destroy
  */
 extern void parser_destroy(parser **this);
 
+/**
+ * @brief Set the file the syntax errors of the Parser are written to.
+ * @param[in,out] this The Parser to set the diagnostics file for
+ * @param[in] diagnostics The file to write to, NULL for stderr
+ * @note The file is not closed by the Parser.
+ */
+extern void parser_set_diagnostics(parser *this, FILE *diagnostics);
+
+/**
+ * @brief Set the Module cache the imports of the source file are loaded from.
+ * @param[in,out] this The Parser to set the Module cache for
+ * @param[in] moduleCache The Module cache to use, NULL to not resolve imports
+ * @note The Module cache is not owned by the Parser, it has to outlive the
+ *       resulting AST.
+ */
+extern void parser_set_module_cache(parser *this,
+                                    parser_module_cache *moduleCache);
+
 /**
  * @brief Parse the source file.
  * @param[in] this The parser to run.
  * @retval 1 Ok
- * @retval 0 Error while parsing
+ * @retval 0 Error while parsing or resolving the imports
  */
 extern int parser_parse(parser *this);
 
+/**
+ * @brief Only run the lexer over the source file without parsing.
+ * @param[in] this The parser to run the lexer of
+ * @param[out] tokenCount The number of tokens read, may be NULL
+ * @retval 1 Ok
+ * @retval 0 Error while lexing
+ * @note Meant for measuring the lexer, a Parser can either lex or parse once.
+ */
+extern int parser_lex(parser *this, unsigned long int *tokenCount);
+
 /**
  * @brief Return the resulting waitui_ast after parsing.
  * @param[in] this The parser to retrieve the waitui_ast from
  * @return A pointer to a AST or NULL if parsing failed or hasn't run
+ * @note The identifiers are interned in the Arena of the AST, so the parser
+ *       has to be destroyed before the AST. Literal values point into the
+ *       source mapping, which is released together with the AST.
  */
 extern waitui_ast *parser_get_ast(parser *this);
 
@@ -9,61 +9,39 @@
 #define WAITUI_PARSER_HELPER_H
 
 #include <waitui/ast.h>
+#include <waitui/intern.h>
 #include <waitui/list.h>
 #include <waitui/symboltable.h>
 
-
-// -----------------------------------------------------------------------------
-//  Public defines
-// -----------------------------------------------------------------------------
-
-/**
- * @brief TODO
- */
-#define MAX_IMPORT_DEPTH 1024
+#include <stdio.h>
 
 
 // -----------------------------------------------------------------------------
 //  Public types
 // -----------------------------------------------------------------------------
 
-/**
- * @brief TODO
- */
-typedef struct parser_yy_state {
-    void *state;
-    str filename;
-    int first_line;
-    int last_line;
-    int first_column;
-    int last_column;
-} parser_yy_state;
-
-extern parser_yy_state *parser_yy_state_new(str filename, int first_line,
-                                            int last_line, int first_column,
-                                            int last_column, void *state);
-
-extern void parser_yy_state_destroy(parser_yy_state **this);
-
-CREATE_LIST_TYPE(INTERFACE, parser_yy_state)
-
 /**
  * @brief Type for extra parser data.
+ * @note The syntax errors are written to diagnostics.
  */
 typedef struct parser_extra_parser {
     void *scanner;
     waitui_ast *resultAst;
+    waitui_arena *arena;
+    waitui_intern *intern;
     str sourceFileName;
     symboltable *symtable;
+    FILE *diagnostics;
 } parser_extra_parser;
 
 /**
  * @brief Type for extra lexer data.
+ * @note With sourceIsStable the token values are slices of the scanned buffer,
+ *       else they are copied into the Arena.
  */
 typedef struct parser_extra_lexer {
     int lastToken;
-    parser_yy_state_list *importStack;
-    int import_stack_ptr;
+    int sourceIsStable;
     parser_extra_parser *extraParser;
 } parser_extra_lexer;
 
@@ -0,0 +1,759 @@
+/**
+ * @file module_cache.c
+ * @author rick
+ * @date 17.10.26
+ * @brief File for the Module cache implementation
+ */
+
+#include "waitui/module_cache.h"
+
+#include "waitui/parser.h"
+
+#include <waitui/hashtable.h>
+#include <waitui/log.h>
+
+#include <limits.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+
+// -----------------------------------------------------------------------------
+//  Local defines
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The extension of the source files of modules.
+ */
+#define PARSER_MODULE_EXTENSION ".wai"
+
+
+// -----------------------------------------------------------------------------
+//  Local types
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The states a module in the Module cache can be in.
+ */
+typedef enum parser_module_state {
+    PARSER_MODULE_STATE_LOADING,
+    PARSER_MODULE_STATE_LOADED,
+    PARSER_MODULE_STATE_FAILED,
+} parser_module_state;
+
+/**
+ * @brief Type representing a module in the Module cache.
+ * @note A module is done once its own imports are resolved and resolved once
+ *       every module it imports, also indirectly, is done. The imported
+ *       modules are only written before the module is done.
+ */
+typedef struct parser_module parser_module;
+struct parser_module {
+    parser_module_state state;
+    str canonicalPath;
+    waitui_ast *ast;
+    char *diagnostics;
+    size_t diagnosticsLength;
+    parser_module **imports;
+    unsigned long int importCount;
+    unsigned long int importSize;
+    unsigned long int visitMark;
+    int failed;
+    int done;
+    int resolved;
+};
+
+static void parser_module_destroy(parser_module **this);
+
+static int parser_module_cache_resolveModule(parser_module_cache *this,
+                                             parser_module *module,
+                                             FILE *diagnostics);
+
+CREATE_HASHTABLE_TYPE_CUSTOM(INTERFACE, parser_module, parser_module,
+                             parser_module_destroy)
+
+/**
+ * @brief Type for the modules already walked for the dependencies of an AST.
+ * @note An AST imports only a handful of modules, a list is enough.
+ */
+typedef struct parser_module_visited {
+    parser_module **modules;
+    unsigned long int length;
+    unsigned long int size;
+} parser_module_visited;
+
+/**
+ * @brief Struct representing a Module cache.
+ * @note A module is inserted as loading before it is parsed outside of the
+ *       lock, so every other thread importing it waits for the one parse.
+ *       The imports of a module are resolved after it is marked loaded. While
+ *       resolving imports a thread only waits for modules to be parsed, never
+ *       for their imports, so import cycles, also across threads, can not
+ *       deadlock. Only parser_module_cache_load waits until the whole import
+ *       graph below the module is done, before that other threads may still
+ *       write the imports of the modules in it. The diagnostics of a module
+ *       are kept with the module and not with the file that happened to import
+ *       it first.
+ */
+struct parser_module_cache {
+    str *searchPaths;
+    unsigned long int searchPathCount;
+    parser_module_hashtable *modules;
+    parser_module **moduleList;
+    unsigned long int moduleListLength;
+    unsigned long int moduleListSize;
+    pthread_mutex_t mutex;
+    pthread_cond_t loaded;
+    unsigned long int parsedCount;
+    unsigned long int visitMark;
+};
+
+
+// -----------------------------------------------------------------------------
+//  Local variables
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The search path used without any configured search paths.
+ */
+static str parserModuleDefaultSearchPath = STR_STATIC_INIT(".");
+
+
+// -----------------------------------------------------------------------------
+//  Local functions
+// -----------------------------------------------------------------------------
+
+CREATE_HASHTABLE_TYPE_CUSTOM(IMPLEMENTATION, parser_module, parser_module,
+                             parser_module_destroy)
+
+/**
+ * @brief Destroy a module and its AST.
+ * @param[in,out] this The module to destroy
+ */
+static void parser_module_destroy(parser_module **this) {
+    if (!this || !(*this)) { return; }
+
+    ast_destroy(&(*this)->ast);
+    STR_FREE(&(*this)->canonicalPath);
+    free((*this)->diagnostics);
+    free((*this)->imports);
+
+    free(*this);
+    *this = NULL;
+}
+
+/**
+ * @brief Find the canonical path of the source file for the import.
+ * @param[in] this The Module cache with the search paths
+ * @param[in] importName The name of the import
+ * @param[out] canonicalPath The buffer of PATH_MAX bytes for the found path
+ * @retval 1 Ok
+ * @retval 0 No source file for the import was found
+ */
+static int parser_module_cache_find(parser_module_cache *this, str importName,
+                                    char *canonicalPath) {
+    char relativePath[PATH_MAX];
+    char path[PATH_MAX];
+    unsigned long int length = importName.len;
+
+    if (length == 0 || length >= sizeof(relativePath)) { return 0; }
+
+    // first org/test/home.wai for the namespace, then org/test.wai for a class
+    for (int candidate = 0; candidate < 2 && length > 0; ++candidate) {
+        for (unsigned long int i = 0; i < length; ++i) {
+            relativePath[i] = importName.s[i] == '.' ? '/' : importName.s[i];
+        }
+        relativePath[length] = '\0';
+
+        for (unsigned long int i = 0; i < this->searchPathCount; ++i) {
+            struct stat pathStat;
+            int written = snprintf(path, sizeof(path), "%.*s/%s%s",
+                                   STR_FMT(&this->searchPaths[i]),
+                                   relativePath, PARSER_MODULE_EXTENSION);
+
+            if (written < 0 || (size_t) written >= sizeof(path)) { continue; }
+            if (stat(path, &pathStat) != 0 || !S_ISREG(pathStat.st_mode)) {
+                continue;
+            }
+            if (realpath(path, canonicalPath)) { return 1; }
+        }
+
+        while (length > 0 && importName.s[length - 1] != '.') { length--; }
+        if (length > 0) { length--; }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Compare two modules by their canonical path for qsort.
+ * @param[in] a The first module
+ * @param[in] b The second module
+ * @return The order of the canonical paths
+ */
+static int parser_module_compare(const void *a, const void *b) {
+    return strcmp((*(parser_module *const *) a)->canonicalPath.s,
+                  (*(parser_module *const *) b)->canonicalPath.s);
+}
+
+/**
+ * @brief Add the module to the Module cache, the lock has to be held.
+ * @param[in,out] this The Module cache to add the module to
+ * @param[in,out] module The module to add
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ */
+static int parser_module_cache_add(parser_module_cache *this,
+                                   parser_module *module) {
+    if (this->moduleListLength == this->moduleListSize) {
+        unsigned long int size = this->moduleListSize
+                                         ? this->moduleListSize * 2
+                                         : 16;
+        parser_module **moduleList =
+                realloc(this->moduleList, size * sizeof(*moduleList));
+        if (!moduleList) { return 0; }
+
+        this->moduleList     = moduleList;
+        this->moduleListSize = size;
+    }
+
+    if (!parser_module_hashtable_insert(this->modules, module->canonicalPath,
+                                        module)) {
+        return 0;
+    }
+    this->moduleList[this->moduleListLength++] = module;
+
+    return 1;
+}
+
+/**
+ * @brief Test if the module was already walked.
+ * @param[in] this The walked modules
+ * @param[in] module The module to look for
+ * @retval 1 The module was walked
+ * @retval 0 The module was not walked yet
+ */
+static int parser_module_visited_contains(const parser_module_visited *this,
+                                          const parser_module *module) {
+    for (unsigned long int i = 0; i < this->length; ++i) {
+        if (this->modules[i] == module) { return 1; }
+    }
+    return 0;
+}
+
+/**
+ * @brief Add the module to the walked modules.
+ * @param[in,out] this The walked modules
+ * @param[in] module The module to add
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ */
+static int parser_module_visited_add(parser_module_visited *this,
+                                     parser_module *module) {
+    if (this->length == this->size) {
+        unsigned long int size = this->size ? this->size * 2 : 16;
+        parser_module **modules =
+                realloc(this->modules, size * sizeof(*modules));
+        if (!modules) { return 0; }
+
+        this->modules = modules;
+        this->size    = size;
+    }
+
+    this->modules[this->length++] = module;
+
+    return 1;
+}
+
+/**
+ * @brief Add the imported module to the imports of the module.
+ * @param[in,out] this The module importing the other module
+ * @param[in] module The imported module
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ */
+static int parser_module_addImport(parser_module *this, parser_module *module) {
+    if (this->importCount == this->importSize) {
+        unsigned long int size = this->importSize ? this->importSize * 2 : 4;
+        parser_module **imports =
+                realloc(this->imports, size * sizeof(*imports));
+        if (!imports) { return 0; }
+
+        this->imports    = imports;
+        this->importSize = size;
+    }
+
+    this->imports[this->importCount++] = module;
+
+    return 1;
+}
+
+/**
+ * @brief Test if the module and the modules it imports are done, the lock
+ *        has to be held.
+ * @param[in,out] this The Module cache with the current walk
+ * @param[in,out] module The module to test
+ * @retval 1 Every module reachable from the module is done
+ * @retval 0 A module reachable from the module is not done yet
+ * @note A module already on the current walk counts as done, its imports are
+ *       tested further up, that way import cycles end.
+ */
+static int parser_module_cache_isDone(parser_module_cache *this,
+                                      parser_module *module) {
+    if (module->resolved) { return 1; }
+    if (!module->done) { return 0; }
+    if (module->visitMark == this->visitMark) { return 1; }
+
+    module->visitMark = this->visitMark;
+
+    for (unsigned long int i = 0; i < module->importCount; ++i) {
+        if (!parser_module_cache_isDone(this, module->imports[i])) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Mark the module and the modules it imports as resolved.
+ * @param[in,out] module The module to mark
+ */
+static void parser_module_markResolved(parser_module *module) {
+    if (module->resolved) { return; }
+
+    module->resolved = 1;
+
+    for (unsigned long int i = 0; i < module->importCount; ++i) {
+        parser_module_markResolved(module->imports[i]);
+    }
+}
+
+/**
+ * @brief Test if the module is resolved, the lock has to be held.
+ * @param[in,out] this The Module cache with the module
+ * @param[in,out] module The module to test
+ * @retval 1 The module and every module it imports are done
+ * @retval 0 A module is still resolving its imports
+ * @note Once a module is resolved the whole import graph below it is marked,
+ *       so later tests end right there.
+ */
+static int parser_module_cache_isResolved(parser_module_cache *this,
+                                          parser_module *module) {
+    if (module->resolved) { return 1; }
+
+    this->visitMark++;
+    if (!parser_module_cache_isDone(this, module)) { return 0; }
+
+    parser_module_markResolved(module);
+
+    return 1;
+}
+
+/**
+ * @brief Parse the source file of a module.
+ * @param[in] canonicalPath The canonical path of the source file
+ * @param[in] diagnostics The file to write errors to
+ * @return A pointer to the AST of the module or NULL if parsing failed
+ * @note The imports of the module are not resolved, that is up to the caller.
+ */
+static waitui_ast *parser_module_parse(str canonicalPath, FILE *diagnostics) {
+    parser *moduleParser = NULL;
+    waitui_ast *ast      = NULL;
+    str directory        = STR_NULL_INIT;
+    int result           = 0;
+
+    moduleParser = parser_new(canonicalPath, directory, PARSER_DEBUG_NONE);
+    if (!moduleParser) { return NULL; }
+
+    parser_set_diagnostics(moduleParser, diagnostics);
+
+    result = parser_parse(moduleParser);
+    ast    = parser_get_ast(moduleParser);
+
+    parser_destroy(&moduleParser);
+
+    if (!result) { ast_destroy(&ast); }
+
+    return ast;
+}
+
+/**
+ * @brief Return the imported module, parse it and resolve its imports on first
+ *        use.
+ * @param[in,out] this The Module cache to load the module from
+ * @param[in] importName The name of the import
+ * @param[in] diagnostics The file to write the errors of the import to
+ * @return A pointer to the module or NULL if it could not be loaded
+ * @note Only waits for the module to be parsed, its imports may still be
+ *       resolved by another thread.
+ */
+static parser_module *parser_module_cache_loadModule(parser_module_cache *this,
+                                                     str importName,
+                                                     FILE *diagnostics) {
+    char canonicalPath[PATH_MAX];
+    str key               = STR_NULL_INIT;
+    parser_module *module = NULL;
+    FILE *moduleErrors    = NULL;
+    waitui_ast *ast       = NULL;
+    int failed            = 0;
+
+    if (!parser_module_cache_find(this, importName, canonicalPath)) {
+        fprintf(diagnostics, "ERROR: could not find module '%.*s'\n",
+                STR_FMT(&importName));
+        return NULL;
+    }
+    key.s   = canonicalPath;
+    key.len = strlen(canonicalPath);
+
+    pthread_mutex_lock(&this->mutex);
+
+    module = parser_module_hashtable_lookup(this->modules, key);
+    if (module) {
+        while (module->state == PARSER_MODULE_STATE_LOADING) {
+            pthread_cond_wait(&this->loaded, &this->mutex);
+        }
+        if (module->state == PARSER_MODULE_STATE_FAILED) { module = NULL; }
+        pthread_mutex_unlock(&this->mutex);
+
+        if (!module) {
+            fprintf(diagnostics, "ERROR: could not load module '%.*s'\n",
+                    STR_FMT(&importName));
+        }
+
+        return module;
+    }
+
+    module = calloc(1, sizeof(*module));
+    if (module) { STR_COPY_WITH_NUL(&module->canonicalPath, &key); }
+    if (!module || !module->canonicalPath.s ||
+        !parser_module_cache_add(this, module)) {
+        pthread_mutex_unlock(&this->mutex);
+        parser_module_destroy(&module);
+        return NULL;
+    }
+    module->state = PARSER_MODULE_STATE_LOADING;
+
+    pthread_mutex_unlock(&this->mutex);
+
+    waitui_log_debug("parsing module '%.*s' from '%s'", STR_FMT(&importName),
+                     canonicalPath);
+
+    moduleErrors = open_memstream(&module->diagnostics,
+                                  &module->diagnosticsLength);
+
+    ast = parser_module_parse(module->canonicalPath,
+                              moduleErrors ? moduleErrors : stderr);
+
+    pthread_mutex_lock(&this->mutex);
+    module->ast   = ast;
+    module->state = ast ? PARSER_MODULE_STATE_LOADED
+                        : PARSER_MODULE_STATE_FAILED;
+    this->parsedCount++;
+    pthread_cond_broadcast(&this->loaded);
+    pthread_mutex_unlock(&this->mutex);
+
+    if (ast && !parser_module_cache_resolveModule(
+                       this, module, moduleErrors ? moduleErrors : stderr)) {
+        failed = 1;
+    }
+    if (!ast) { failed = 1; }
+
+    if (moduleErrors) { fclose(moduleErrors); }
+
+    pthread_mutex_lock(&this->mutex);
+    module->failed = failed;
+    module->done   = 1;
+    pthread_cond_broadcast(&this->loaded);
+    pthread_mutex_unlock(&this->mutex);
+
+    if (!ast) {
+        fprintf(diagnostics, "ERROR: could not load module '%.*s'\n",
+                STR_FMT(&importName));
+        return NULL;
+    }
+
+    return module;
+}
+
+/**
+ * @brief Resolve every import of the module to the AST of its module.
+ * @param[in,out] this The Module cache to load the modules from
+ * @param[in,out] module The parsed module to resolve the imports of
+ * @param[in] diagnostics The file to write errors to
+ * @retval 1 Ok
+ * @retval 0 At least one import could not be loaded
+ */
+static int parser_module_cache_resolveModule(parser_module_cache *this,
+                                             parser_module *module,
+                                             FILE *diagnostics) {
+    int result = 1;
+
+    WAITUI_VECTOR_FOREACH(waitui_ast_namespace, namespace,
+                          waitui_ast_program_getNamespaces(
+                                  waitui_ast_getProgram(module->ast))) {
+        WAITUI_VECTOR_FOREACH(waitui_ast_import, import,
+                              waitui_ast_namespace_getImports(namespace)) {
+            symbol *name            = waitui_ast_import_getName(import);
+            parser_module *imported = NULL;
+
+            if (!name) { continue; }
+
+            imported = parser_module_cache_loadModule(this, name->identifier,
+                                                      diagnostics);
+            if (!imported || !parser_module_addImport(module, imported)) {
+                result = 0;
+                continue;
+            }
+
+            waitui_ast_import_setModule(import, imported->ast);
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Call the callback for every module the AST imports and so on.
+ * @param[in,out] this The Module cache with the modules
+ * @param[in] ast The AST to walk the imports of
+ * @param[in,out] visited The modules already walked
+ * @param[in] callback The callback to call for every module
+ * @param[in,out] args The extra argument for the callback
+ * @retval 1 Ok
+ * @retval 0 A module failed, is not in the Module cache or the callback failed
+ */
+static int parser_module_cache_walkDependencies(
+        parser_module_cache *this, waitui_ast *ast,
+        parser_module_visited *visited,
+        parser_module_cache_dependency callback, void *args) {
+    int result = 1;
+
+    WAITUI_VECTOR_FOREACH(
+            waitui_ast_namespace, namespace,
+            waitui_ast_program_getNamespaces(waitui_ast_getProgram(ast))) {
+        if (!result) { break; }
+
+        WAITUI_VECTOR_FOREACH(waitui_ast_import, import,
+                              waitui_ast_namespace_getImports(namespace)) {
+            char canonicalPath[PATH_MAX];
+            symbol *name          = waitui_ast_import_getName(import);
+            parser_module *module = NULL;
+            str key               = STR_NULL_INIT;
+
+            if (!name) { continue; }
+
+            if (!parser_module_cache_find(this, name->identifier,
+                                          canonicalPath)) {
+                result = 0;
+                break;
+            }
+            key.s   = canonicalPath;
+            key.len = strlen(canonicalPath);
+
+            pthread_mutex_lock(&this->mutex);
+            module = parser_module_hashtable_lookup(this->modules, key);
+            while (module && !parser_module_cache_isResolved(this, module)) {
+                pthread_cond_wait(&this->loaded, &this->mutex);
+            }
+            pthread_mutex_unlock(&this->mutex);
+
+            if (!module || module->failed) {
+                result = 0;
+                break;
+            }
+
+            if (parser_module_visited_contains(visited, module)) { continue; }
+            if (!parser_module_visited_add(visited, module) ||
+                !callback(args, module->canonicalPath)) {
+                result = 0;
+                break;
+            }
+
+            result = parser_module_cache_walkDependencies(
+                    this, module->ast, visited, callback, args);
+            if (!result) { break; }
+        }
+    }
+
+    return result;
+}
+
+
+// -----------------------------------------------------------------------------
+//  Public functions
+// -----------------------------------------------------------------------------
+
+parser_module_cache *parser_module_cache_new(const str *searchPaths,
+                                             unsigned long int
+                                                     searchPathCount) {
+    parser_module_cache *this = NULL;
+
+    waitui_log_trace("creating new module cache");
+
+    this = calloc(1, sizeof(*this));
+    if (!this) { return NULL; }
+
+    if (!searchPaths || searchPathCount == 0) {
+        searchPaths     = &parserModuleDefaultSearchPath;
+        searchPathCount = 1;
+    }
+
+    this->searchPaths = calloc(searchPathCount, sizeof(*this->searchPaths));
+    if (!this->searchPaths) {
+        parser_module_cache_destroy(&this);
+        return NULL;
+    }
+
+    for (unsigned long int i = 0; i < searchPathCount; ++i) {
+        STR_COPY_WITH_NUL(&this->searchPaths[i], &searchPaths[i]);
+        if (!this->searchPaths[i].s) {
+            parser_module_cache_destroy(&this);
+            return NULL;
+        }
+        this->searchPathCount++;
+    }
+
+    this->modules = parser_module_hashtable_new(64);
+    if (!this->modules) {
+        parser_module_cache_destroy(&this);
+        return NULL;
+    }
+
+    pthread_mutex_init(&this->mutex, NULL);
+    pthread_cond_init(&this->loaded, NULL);
+
+    waitui_log_trace("new module cache successful created");
+
+    return this;
+}
+
+void parser_module_cache_destroy(parser_module_cache **this) {
+    waitui_log_trace("destroying module cache");
+
+    if (!this || !(*this)) { return; }
+
+    if ((*this)->modules) {
+        parser_module_hashtable_destroy(&(*this)->modules);
+        pthread_cond_destroy(&(*this)->loaded);
+        pthread_mutex_destroy(&(*this)->mutex);
+    }
+
+    for (unsigned long int i = 0; i < (*this)->searchPathCount; ++i) {
+        STR_FREE(&(*this)->searchPaths[i]);
+    }
+    free((*this)->searchPaths);
+    free((*this)->moduleList);
+
+    free(*this);
+    *this = NULL;
+
+    waitui_log_trace("module cache successful destroyed");
+}
+
+waitui_ast *parser_module_cache_load(parser_module_cache *this,
+                                     str importName, FILE *diagnostics) {
+    parser_module *module = NULL;
+    waitui_ast *ast       = NULL;
+
+    if (!this) { return NULL; }
+    if (!diagnostics) { diagnostics = stderr; }
+
+    module = parser_module_cache_loadModule(this, importName, diagnostics);
+    if (!module) { return NULL; }
+
+    pthread_mutex_lock(&this->mutex);
+    while (!parser_module_cache_isResolved(this, module)) {
+        pthread_cond_wait(&this->loaded, &this->mutex);
+    }
+    ast = module->ast;
+    pthread_mutex_unlock(&this->mutex);
+
+    return ast;
+}
+
+int parser_module_cache_resolveImports(parser_module_cache *this,
+                                       waitui_ast *ast, FILE *diagnostics) {
+    int result = 1;
+
+    if (!this || !ast) { return 0; }
+
+    WAITUI_VECTOR_FOREACH(
+            waitui_ast_namespace, namespace,
+            waitui_ast_program_getNamespaces(waitui_ast_getProgram(ast))) {
+        WAITUI_VECTOR_FOREACH(waitui_ast_import, import,
+                              waitui_ast_namespace_getImports(namespace)) {
+            symbol *name       = waitui_ast_import_getName(import);
+            waitui_ast *module = NULL;
+
+            if (!name) { continue; }
+
+            module = parser_module_cache_load(this, name->identifier,
+                                              diagnostics);
+            if (!module) {
+                result = 0;
+                continue;
+            }
+
+            waitui_ast_import_setModule(import, module);
+        }
+    }
+
+    return result;
+}
+
+unsigned long int
+parser_module_cache_writeDiagnostics(parser_module_cache *this,
+                                     FILE *diagnostics) {
+    unsigned long int failedCount = 0;
+
+    if (!this || !diagnostics) { return 0; }
+
+    pthread_mutex_lock(&this->mutex);
+
+    qsort(this->moduleList, this->moduleListLength,
+          sizeof(*this->moduleList), parser_module_compare);
+
+    for (unsigned long int i = 0; i < this->moduleListLength; ++i) {
+        parser_module *module = this->moduleList[i];
+
+        if (module->diagnosticsLength > 0) {
+            fwrite(module->diagnostics, 1, module->diagnosticsLength,
+                   diagnostics);
+        }
+        if (module->failed) { failedCount++; }
+    }
+
+    pthread_mutex_unlock(&this->mutex);
+
+    return failedCount;
+}
+
+unsigned long int
+parser_module_cache_getParsedCount(parser_module_cache *this) {
+    unsigned long int parsedCount = 0;
+
+    if (!this) { return 0; }
+
+    pthread_mutex_lock(&this->mutex);
+    parsedCount = this->parsedCount;
+    pthread_mutex_unlock(&this->mutex);
+
+    return parsedCount;
+}
+
+int parser_module_cache_forEachDependency(
+        parser_module_cache *this, waitui_ast *ast,
+        parser_module_cache_dependency callback, void *args) {
+    parser_module_visited visited = {0};
+    int result                    = 0;
+
+    if (!this || !ast || !callback) { return 0; }
+
+    result = parser_module_cache_walkDependencies(this, ast, &visited,
+                                                  callback, args);
+    free(visited.modules);
+
+    return result;
+}
@@ -14,6 +14,11 @@
 
 #include <waitui/log.h>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 
 // -----------------------------------------------------------------------------
 //  Local variables
@@ -26,19 +31,114 @@ static str parser_source_stdin = STR_STATIC_INIT("stdin");
 
 
 // -----------------------------------------------------------------------------
-//  Public functions
+//  Local functions
 // -----------------------------------------------------------------------------
 
-parser *parser_new(str sourceFileName, str workingDirectory,
-                   unsigned int debug) {
-    parser *this = NULL;
+/**
+ * @brief Calculate the size of the mapping for a source of the given length.
+ * @param[in] length The length of the source
+ * @return The size of the mapping
+ */
+static size_t parser_source_map_size(size_t length) {
+    size_t pageSize = (size_t) sysconf(_SC_PAGESIZE);
 
-    waitui_log_trace("creating new parser");
+    return (length + 2 + pageSize - 1) & ~(pageSize - 1);
+}
+
+/**
+ * @brief Unmap a mapped source file, called by the Arena.
+ * @param[in,out] data The mapped source file to unmap
+ */
+static void parser_unmap_source(void **data) {
+    str *source = *data;
+
+    if (!source) { return; }
+
+    munmap(source->s, parser_source_map_size(source->len));
+    *data = NULL;
+}
+
+/**
+ * @brief Map the source file of the Parser into memory for scanning in place.
+ * @param[in,out] this The Parser to map the source file for
+ * @retval 1 Ok
+ * @retval 0 The source file is no regular file or could not be mapped
+ * @note The mapping is followed by the two NUL bytes flex expects at the end
+ *       of a buffer. The mapping is private and writable, as flex temporarily
+ *       terminates the current token inside the buffer. The mapping belongs to
+ *       the Arena of the Parser, so tokens can point into it as long as the
+ *       AST lives.
+ */
+static int parser_map_source(parser *this) {
+    struct stat sourceStat;
+    size_t sourceSize = 0;
+    size_t mapSize    = 0;
+    char *buffer      = MAP_FAILED;
+    str *mapping      = NULL;
+    int fd            = -1;
+
+    fd = open(this->sourceFileName.s, O_RDONLY);
+    if (fd < 0) { return 0; }
+
+    if (fstat(fd, &sourceStat) != 0 || !S_ISREG(sourceStat.st_mode) ||
+        sourceStat.st_size == 0) {
+        close(fd);
+        return 0;
+    }
+
+    sourceSize = (size_t) sourceStat.st_size;
+    mapSize    = parser_source_map_size(sourceSize);
+
+    // reserve zeroed memory for the file and the terminating NUL bytes first,
+    // then place the file over the start of it
+    buffer = mmap(NULL, mapSize, PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buffer == MAP_FAILED) {
+        close(fd);
+        return 0;
+    }
+
+    if (mmap(buffer, sourceSize, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        munmap(buffer, mapSize);
+        close(fd);
+        return 0;
+    }
+    close(fd);
+
+    madvise(buffer, mapSize, MADV_SEQUENTIAL);
+
+    mapping = waitui_arena_alloc(this->extraParser.arena, sizeof(*mapping));
+    if (!mapping ||
+        !waitui_arena_addCleanup(this->extraParser.arena, parser_unmap_source,
+                                 mapping)) {
+        munmap(buffer, mapSize);
+        return 0;
+    }
+    mapping->s   = buffer;
+    mapping->len = sourceSize;
+
+    this->sourceText = *mapping;
+
+    return 1;
+}
+
+/**
+ * @brief Create a Parser without a source to scan yet.
+ * @param[in] sourceFileName The source file to begin the parsing with
+ * @param[in] workingDirectory The working directory to search other files in
+ * @param[in] debug The debug level of the parser
+ * @return A pointer to Parser or NULL if memory allocation failed
+ */
+static parser *parser_create(str sourceFileName, str workingDirectory,
+                             unsigned int debug) {
+    parser *this = NULL;
 
     this = calloc(1, sizeof(*this));
     if (!this) { return NULL; }
 
-    this->debug = debug;
+    this->debug                   = debug;
+    this->extraParser.diagnostics = stderr;
 
     STR_COPY_WITH_NUL(&this->sourceFileName, &sourceFileName);
     if (!this->sourceFileName.s) {
@@ -55,16 +155,23 @@ parser *parser_new(str sourceFileName, str workingDirectory,
         return NULL;
     }
 
-    this->extraParser.symtable = symboltable_new();
-    if (!this->extraParser.symtable) {
-        waitui_log_fatal("could not create symboltable");
+    this->extraParser.arena = waitui_arena_new();
+    if (!this->extraParser.arena) {
+        waitui_log_fatal("could not create arena");
         parser_destroy(&this);
         return NULL;
     }
 
-    this->extraLexer.importStack = parser_yy_state_list_new();
-    if (!this->extraLexer.importStack) {
-        waitui_log_fatal("could not allocate memory for importStack");
+    this->extraParser.intern = waitui_intern_new(this->extraParser.arena);
+    if (!this->extraParser.intern) {
+        waitui_log_fatal("could not create intern pool");
+        parser_destroy(&this);
+        return NULL;
+    }
+
+    this->extraParser.symtable = symboltable_new(this->extraParser.intern);
+    if (!this->extraParser.symtable) {
+        waitui_log_fatal("could not create symboltable");
         parser_destroy(&this);
         return NULL;
     }
@@ -78,10 +185,60 @@ parser *parser_new(str sourceFileName, str workingDirectory,
         return NULL;
     }
 
+    return this;
+}
+
+/**
+ * @brief Copy the source of the Parser into its Arena for scanning in place.
+ * @param[in,out] this The Parser to copy the source for
+ * @param[in] source The source to copy
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ * @note Like a mapped source file the copy is followed by the two NUL bytes
+ *       flex expects at the end of a buffer and lives as long as the AST.
+ */
+static int parser_copy_source(parser *this, str source) {
+    char *buffer = waitui_arena_alloc(this->extraParser.arena, source.len + 2);
+
+    if (!buffer) { return 0; }
+
+    if (source.len) { memcpy(buffer, source.s, source.len); }
+    buffer[source.len]     = '\0';
+    buffer[source.len + 1] = '\0';
+
+    this->sourceText.s   = buffer;
+    this->sourceText.len = source.len;
+
+    return 1;
+}
+
+
+// -----------------------------------------------------------------------------
+//  Public functions
+// -----------------------------------------------------------------------------
+
+parser *parser_new(str sourceFileName, str workingDirectory,
+                   unsigned int debug) {
+    parser *this = NULL;
+
+    waitui_log_trace("creating new parser");
+
+    this = parser_create(sourceFileName, workingDirectory, debug);
+    if (!this) { return NULL; }
+
     if (parser_source_stdin.len == sourceFileName.len &&
         memcmp(parser_source_stdin.s, sourceFileName.s,
                parser_source_stdin.len) == 0) {
         this->sourceFile = stdin;
+    } else if (parser_map_source(this)) {
+        this->extraLexer.sourceIsStable = 1;
+
+        if (!yy_scan_buffer(this->sourceText.s, this->sourceText.len + 2,
+                            this->extraParser.scanner)) {
+            waitui_log_fatal("could not scan the mapped source file");
+            parser_destroy(&this);
+            return NULL;
+        }
     } else {
         this->sourceFile = fopen(sourceFileName.s, "r");
         if (!this->sourceFile) {
@@ -91,7 +248,40 @@ parser *parser_new(str sourceFileName, str workingDirectory,
         }
     }
 
-    yyset_in(this->sourceFile, this->extraParser.scanner);
+    if (this->sourceFile) {
+        yyset_in(this->sourceFile, this->extraParser.scanner);
+    }
+    if (this->debug & PARSER_DEBUG_LEXER) {
+        yyset_debug(1, this->extraParser.scanner);
+    }
+
+    waitui_log_trace("new parser successful created");
+
+    return this;
+}
+
+parser *parser_new_from_source(str sourceFileName, str source,
+                               str workingDirectory, unsigned int debug) {
+    parser *this = NULL;
+
+    waitui_log_trace("creating new parser from source");
+
+    this = parser_create(sourceFileName, workingDirectory, debug);
+    if (!this) { return NULL; }
+
+    if (!parser_copy_source(this, source)) {
+        waitui_log_fatal("could not allocate memory for the source");
+        parser_destroy(&this);
+        return NULL;
+    }
+    this->extraLexer.sourceIsStable = 1;
+
+    if (!yy_scan_buffer(this->sourceText.s, this->sourceText.len + 2,
+                        this->extraParser.scanner)) {
+        waitui_log_fatal("could not scan the source");
+        parser_destroy(&this);
+        return NULL;
+    }
     if (this->debug & PARSER_DEBUG_LEXER) {
         yyset_debug(1, this->extraParser.scanner);
     }
@@ -106,8 +296,8 @@ void parser_destroy(parser **this) {
 
     if (!this || !(*this)) { return; }
 
-    parser_yy_state_list_destroy(&(*this)->extraLexer.importStack);
     symboltable_destroy(&(*this)->extraParser.symtable);
+    waitui_arena_destroy(&(*this)->extraParser.arena);
     if ((*this)->extraParser.scanner) {
         yylex_destroy((*this)->extraParser.scanner);
     }
@@ -123,6 +313,19 @@ void parser_destroy(parser **this) {
     waitui_log_trace("parser successful destroyed");
 }
 
+void parser_set_diagnostics(parser *this, FILE *diagnostics) {
+    if (!this) { return; }
+
+    this->extraParser.diagnostics = diagnostics ? diagnostics : stderr;
+}
+
+void parser_set_module_cache(parser *this,
+                             parser_module_cache *moduleCache) {
+    if (!this) { return; }
+
+    this->moduleCache = moduleCache;
+}
+
 int parser_parse(parser *this) {
     if (!this) { return 0; }
 
@@ -130,6 +333,38 @@ int parser_parse(parser *this) {
 
     if (yyparse(&this->extraParser) != 0) { return 0; }
 
+    if (this->moduleCache &&
+        !parser_module_cache_resolveImports(this->moduleCache,
+                                            this->extraParser.resultAst,
+                                            this->extraParser.diagnostics)) {
+        return 0;
+    }
+
+    return 1;
+}
+
+int parser_lex(parser *this, unsigned long int *tokenCount) {
+    YYSTYPE value;
+    YYLTYPE location;
+    unsigned long int count = 0;
+    int token               = 0;
+
+    if (!this) { return 0; }
+
+    location.first_line   = 1;
+    location.first_column = 1;
+    location.last_line    = 1;
+    location.last_column  = 1;
+    location.filename     = this->extraParser.sourceFileName;
+
+    while ((token = yylex(&value, &location, this->extraParser.scanner)) !=
+           YYEOF) {
+        if (token == YYerror) { return 0; }
+        count++;
+    }
+
+    if (tokenCount) { *tokenCount = count; }
+
     return 1;
 }
 
@@ -39,18 +39,18 @@
     waitui_ast_block *block;
     waitui_ast_cast *cast;
     waitui_ast_class *class;
-    waitui_ast_class_list *classes;
+    waitui_ast_class_vector *classes;
     waitui_ast_constructor_call *constructor_call;
     waitui_ast_expression *expression;
-    waitui_ast_expression_list *expressions;
+    waitui_ast_expression_vector *expressions;
     waitui_ast_formal *formal;
-    waitui_ast_formal_list *formals;
+    waitui_ast_formal_vector *formals;
     waitui_ast_function *function;
     waitui_ast_if_else *if_else_expression;
     waitui_ast_initialization *initialization;
-    waitui_ast_initialization_list *initializations;
+    waitui_ast_initialization_vector *initializations;
     waitui_ast_import *import;
-    waitui_ast_import_list *imports;
+    waitui_ast_import_vector *imports;
     waitui_ast_namespace *namespace;
     waitui_ast_let *let;
     waitui_ast_property *property;
@@ -127,6 +127,7 @@ void yyerror(YYLTYPE *locp, parser_extra_parser *extraParser, char const *msg);
 %token LAZY_KEYWORD
 %token LET_KEYWORD
 %token NAMESPACE_KEYWORD
+%token NATIVE_KEYWORD
 %token NEW_KEYWORD
 %token OVERWRITE_KEYWORD
 %token PUBLIC_KEYWORD
@@ -187,16 +188,6 @@ void yyerror(YYLTYPE *locp, parser_extra_parser *extraParser, char const *msg);
 %type <unary_expression>   unary_expression
 %type <while_expression>   while
 
-%destructor { waitui_ast_node_destroy((waitui_ast_node **)&$$); }    <assignment> <binary_expression> <block>
-                                                                     <constructor_call> <cast> <class> <expression>
-                                                                     <formal> <function> <if_else_expression>
-                                                                     <initialization> <let> <property>
-                                                                     <unary_expression> <while_expression>
-%destructor { waitui_ast_expression_list_destroy(&$$); }       <expressions>
-%destructor { waitui_ast_formal_list_destroy(&$$); }           <formals>
-%destructor { waitui_ast_class_list_destroy(&$$); }            <classes>
-%destructor { waitui_ast_initialization_list_destroy(&$$); }   <initializations>
-
 %start program
 
 
@@ -208,22 +199,23 @@ void yyerror(YYLTYPE *locp, parser_extra_parser *extraParser, char const *msg);
 /* program definitions */
 program                         : namespace
                                     {
-                                        waitui_ast_namespace_list *namespaces = waitui_ast_namespace_list_new();
-                                        waitui_ast_namespace_list_push(namespaces, $1);
-                                        $$ = waitui_ast_program_new(namespaces);
-                                        extraParser->resultAst = waitui_ast_new($$);
+                                        waitui_ast_namespace_vector *namespaces = waitui_ast_namespace_vector_newInArena(extraParser->arena);
+                                        waitui_ast_namespace_vector_push(namespaces, $1);
+                                        $$ = waitui_ast_program_new(extraParser->arena, namespaces);
+                                        extraParser->resultAst = waitui_ast_new(extraParser->arena, $$);
+                                        if (extraParser->resultAst) { extraParser->arena = NULL; }
                                     }
                                 ;
 
 namespace                       : NAMESPACE_KEYWORD NAMESPACE_NAME imports classes
                                     {
-                                        $$ = waitui_ast_namespace_new($2, $3, $4);
+                                        $$ = waitui_ast_namespace_new(extraParser->arena, $2, $3, $4);
                                     }
                                 ;
 
 imports                         : /* empty */
                                     {
-                                        $$ = waitui_ast_import_list_new();
+                                        $$ = waitui_ast_import_vector_newInArena(extraParser->arena);
                                     }
                                 | import_list
                                     {
@@ -233,35 +225,35 @@ imports                         : /* empty */
 
 import_list                     : import
                                     {
-                                        $$ = waitui_ast_import_list_new();
-                                        waitui_ast_import_list_push($$, $1);
+                                        $$ = waitui_ast_import_vector_newInArena(extraParser->arena);
+                                        waitui_ast_import_vector_push($$, $1);
                                     }
                                 | import_list import
                                     {
                                         $$ = $1;
-                                        waitui_ast_import_list_push($$, $2);
+                                        waitui_ast_import_vector_push($$, $2);
                                     }
                                 ;
 
 import                          : IMPORT_KEYWORD IMPORT_NAME ';'
                                     {
-                                        $$ = waitui_ast_import_new($2, NULL);
+                                        $$ = waitui_ast_import_new(extraParser->arena, $2, NULL);
                                     }
                                 | IMPORT_KEYWORD IMPORT_NAME AS_KEYWORD IDENTIFIER ';'
                                     {
-                                        $$ = waitui_ast_import_new($2, $4);
+                                        $$ = waitui_ast_import_new(extraParser->arena, $2, $4);
                                     }
                                 ;
 
 classes                         : class_definition
                                     {
-                                        $$ = waitui_ast_class_list_new();
-                                        waitui_ast_class_list_push($$, $1);
+                                        $$ = waitui_ast_class_vector_newInArena(extraParser->arena);
+                                        waitui_ast_class_vector_push($$, $1);
                                     }
                                 | classes class_definition
                                     {
                                         $$ = $1;
-                                        waitui_ast_class_list_push($$, $2);
+                                        waitui_ast_class_vector_push($$, $2);
                                     }
                                 ;
 
@@ -292,7 +284,7 @@ class_head                      : CLASS_KEYWORD IDENTIFIER
 
 class_formals                   : /* empty */
                                     {
-                                        $$ = waitui_ast_formal_list_new();
+                                        $$ = waitui_ast_formal_vector_newInArena(extraParser->arena);
                                     }
                                 | '(' formals ')'
                                     {
@@ -302,7 +294,7 @@ class_formals                   : /* empty */
 
 class_actuals                   : /* empty */
                                     {
-                                        $$ = waitui_ast_expression_list_new();
+                                        $$ = waitui_ast_expression_vector_newInArena(extraParser->arena);
                                     }
                                 | '(' actuals ')'
                                     {
@@ -312,36 +304,36 @@ class_actuals                   : /* empty */
 
 class_body                      : /* empty */
                                     {
-                                        waitui_ast_property_list *properties = waitui_ast_property_list_new();
-                                        waitui_ast_function_list *functions = waitui_ast_function_list_new();
-                                        $$ = waitui_ast_class_new(NULL, NULL, NULL, NULL, properties, functions);
+                                        waitui_ast_property_vector *properties = waitui_ast_property_vector_newInArena(extraParser->arena);
+                                        waitui_ast_function_vector *functions = waitui_ast_function_vector_newInArena(extraParser->arena);
+                                        $$ = waitui_ast_class_new(extraParser->arena, NULL, NULL, NULL, NULL, properties, functions);
                                     }
                                 | class_body property_definition ';'
                                     {
                                         $$ = $1;
-                                        waitui_ast_property_list *properties = waitui_ast_class_getProperties($$);
-                                        waitui_ast_property_list_push(properties, $2);
+                                        waitui_ast_property_vector *properties = waitui_ast_class_getProperties($$);
+                                        waitui_ast_property_vector_push(properties, $2);
                                     }
                                 | class_body function_definition ';'
                                     {
                                         $$ = $1;
-                                        waitui_ast_function_list *functions = waitui_ast_class_getFunctions($$);
-                                        waitui_ast_function_list_push(functions, $2);
+                                        waitui_ast_function_vector *functions = waitui_ast_class_getFunctions($$);
+                                        waitui_ast_function_vector_push(functions, $2);
                                     }
                                 ;
 
 /* properties definitions */
 property_definition             : property_head ':' IDENTIFIER '=' expression
                                     {
-                                        $$ = waitui_ast_property_new($1, $3, $5);
+                                        $$ = waitui_ast_property_new(extraParser->arena, $1, $3, $5);
                                     }
                                 | property_head ':' IDENTIFIER
                                     {
-                                        $$ = waitui_ast_property_new($1, $3, NULL);
+                                        $$ = waitui_ast_property_new(extraParser->arena, $1, $3, NULL);
                                     }
                                 | property_head '=' expression
                                     {
-                                        $$ = waitui_ast_property_new($1, NULL, $3);
+                                        $$ = waitui_ast_property_new(extraParser->arena, $1, NULL, $3);
                                     }
                                 ;
 
@@ -370,6 +362,17 @@ function_definition             : ABSTRACT_KEYWORD function_visibility function_
 
                                         waitui_ast_function_setBody($$, $6);
                                     }
+                                | function_final function_overwrite function_visibility function_signature '=' NATIVE_KEYWORD
+                                    {
+                                        $$ = $4;
+
+                                        waitui_ast_function_setAbstract($$, false);
+                                        waitui_ast_function_setFinal($$, $1);
+                                        waitui_ast_function_setOverwrite($$, $2);
+                                        waitui_ast_function_setVisibility($$, $3);
+
+                                        waitui_ast_function_setBody($$, (waitui_ast_expression *) waitui_ast_native_expression_new(extraParser->arena));
+                                    }
                                 ;
 
 function_final                  : /* empty */
@@ -413,11 +416,11 @@ function_visibility             : /* empty */
 
 function_signature              : function_head '(' formals ')'
                                     {
-                                        $$ = waitui_ast_function_new($1, $3, NULL, NULL, WAITUI_AST_FUNCTION_VISIBILITY_PRIVATE, 0, 0, 0);
+                                        $$ = waitui_ast_function_new(extraParser->arena, $1, $3, NULL, NULL, WAITUI_AST_FUNCTION_VISIBILITY_PRIVATE, 0, 0, 0);
                                     }
                                 | function_head '(' formals ')' ':' IDENTIFIER
                                     {
-                                        $$ = waitui_ast_function_new($1, $3, $6, NULL, WAITUI_AST_FUNCTION_VISIBILITY_PRIVATE, 0, 0, 0);
+                                        $$ = waitui_ast_function_new(extraParser->arena, $1, $3, $6, NULL, WAITUI_AST_FUNCTION_VISIBILITY_PRIVATE, 0, 0, 0);
                                     }
                                 ;
 
@@ -446,167 +449,167 @@ expression                      : assignment            { $$ = (waitui_ast_expre
 
 assignment                      : IDENTIFIER ASSIGNMENT expression
                                     {
-                                        $$ = waitui_ast_assignment_new($1, $2, $3);
+                                        $$ = waitui_ast_assignment_new(extraParser->arena, $1, $2, $3);
                                     }
                                 | IDENTIFIER '=' expression
                                     {
-                                        $$ = waitui_ast_assignment_new($1, WAITUI_AST_ASSIGNMENT_OPERATOR_EQUAL, $3);
+                                        $$ = waitui_ast_assignment_new(extraParser->arena, $1, WAITUI_AST_ASSIGNMENT_OPERATOR_EQUAL, $3);
                                     }
                                 ;
 
 binary_expression               : expression '+' expression
                                     {
-                                        $$ = waitui_ast_binary_expression_new($1, WAITUI_AST_BINARY_OPERATOR_PLUS, $3);
+                                        $$ = waitui_ast_binary_expression_new(extraParser->arena, $1, WAITUI_AST_BINARY_OPERATOR_PLUS, $3);
                                     }
                                 | expression '-' expression
                                     {
-                                        $$ = waitui_ast_binary_expression_new($1, WAITUI_AST_BINARY_OPERATOR_MINUS, $3);
+                                        $$ = waitui_ast_binary_expression_new(extraParser->arena, $1, WAITUI_AST_BINARY_OPERATOR_MINUS, $3);
                                     }
                                 | expression '*' expression
                                     {
-                                        $$ = waitui_ast_binary_expression_new($1, WAITUI_AST_BINARY_OPERATOR_TIMES, $3);
+                                        $$ = waitui_ast_binary_expression_new(extraParser->arena, $1, WAITUI_AST_BINARY_OPERATOR_TIMES, $3);
                                     }
                                 | expression '/' expression
                                     {
-                                        $$ = waitui_ast_binary_expression_new($1, WAITUI_AST_BINARY_OPERATOR_DIV, $3);
+                                        $$ = waitui_ast_binary_expression_new(extraParser->arena, $1, WAITUI_AST_BINARY_OPERATOR_DIV, $3);
                                     }
                                 | expression '%' expression
                                     {
-                                        $$ = waitui_ast_binary_expression_new($1, WAITUI_AST_BINARY_OPERATOR_MODULO, $3);
+                                        $$ = waitui_ast_binary_expression_new(extraParser->arena, $1, WAITUI_AST_BINARY_OPERATOR_MODULO, $3);
                                     }
                                 | expression '&' expression
                                     {
-                                        $$ = waitui_ast_binary_expression_new($1, WAITUI_AST_BINARY_OPERATOR_AND, $3);
+                                        $$ = waitui_ast_binary_expression_new(extraParser->arena, $1, WAITUI_AST_BINARY_OPERATOR_AND, $3);
                                     }
                                 | expression '^' expression
                                     {
-                                        $$ = waitui_ast_binary_expression_new($1, WAITUI_AST_BINARY_OPERATOR_CARET, $3);
+                                        $$ = waitui_ast_binary_expression_new(extraParser->arena, $1, WAITUI_AST_BINARY_OPERATOR_CARET, $3);
                                     }
                                 | expression '~' expression
                                     {
-                                        $$ = waitui_ast_binary_expression_new($1, WAITUI_AST_BINARY_OPERATOR_TILDE, $3);
+                                        $$ = waitui_ast_binary_expression_new(extraParser->arena, $1, WAITUI_AST_BINARY_OPERATOR_TILDE, $3);
                                     }
                                 | expression '|' expression
                                     {
-                                        $$ = waitui_ast_binary_expression_new($1, WAITUI_AST_BINARY_OPERATOR_PIPE, $3);
+                                        $$ = waitui_ast_binary_expression_new(extraParser->arena, $1, WAITUI_AST_BINARY_OPERATOR_PIPE, $3);
                                     }
                                 | expression DOUBLE_AND_OPERATOR expression
                                     {
-                                        $$ = waitui_ast_binary_expression_new($1, WAITUI_AST_BINARY_OPERATOR_DOUBLE_AND, $3);
+                                        $$ = waitui_ast_binary_expression_new(extraParser->arena, $1, WAITUI_AST_BINARY_OPERATOR_DOUBLE_AND, $3);
                                     }
                                 | expression DOUBLE_PIPE_OPERATOR expression
                                     {
-                                        $$ = waitui_ast_binary_expression_new($1, WAITUI_AST_BINARY_OPERATOR_DOUBLE_PIPE, $3);
+                                        $$ = waitui_ast_binary_expression_new(extraParser->arena, $1, WAITUI_AST_BINARY_OPERATOR_DOUBLE_PIPE, $3);
                                     }
                                 | expression RELATIONAL expression
                                     {
-                                        $$ = waitui_ast_binary_expression_new($1, $2, $3);
+                                        $$ = waitui_ast_binary_expression_new(extraParser->arena, $1, $2, $3);
                                     }
                                 | expression EQUALITY expression
                                     {
-                                        $$ = waitui_ast_binary_expression_new($1, $2, $3);
+                                        $$ = waitui_ast_binary_expression_new(extraParser->arena, $1, $2, $3);
                                     }
                                 ;
 
 block                           : '{' expressions '}'
                                     {
-                                        $$ = waitui_ast_block_new($2);
+                                        $$ = waitui_ast_block_new(extraParser->arena, $2);
                                     }
                                 ;
 
 cast                            : expression AS_KEYWORD IDENTIFIER
                                     {
-                                        $$ = waitui_ast_cast_new($1, $3);
+                                        $$ = waitui_ast_cast_new(extraParser->arena, $1, $3);
                                     }
                                 ;
 
 constructor_call                : NEW_KEYWORD IDENTIFIER '(' actuals ')'
                                     {
-                                        $$ = waitui_ast_constructor_call_new($2, $4);
+                                        $$ = waitui_ast_constructor_call_new(extraParser->arena, $2, $4);
                                     }
                                 ;
 
 dispatch                        : expression '.' IDENTIFIER '(' actuals ')'
                                     {
-                                        $$ = (waitui_ast_expression *) waitui_ast_function_call_new($1, $3, $5);
+                                        $$ = (waitui_ast_expression *) waitui_ast_function_call_new(extraParser->arena, $1, $3, $5);
                                     }
                                 | SUPER_LITERAL '.' IDENTIFIER '(' actuals ')'
                                     {
-                                        $$ = (waitui_ast_expression *) waitui_ast_super_function_call_new($3, $5);
+                                        $$ = (waitui_ast_expression *) waitui_ast_super_function_call_new(extraParser->arena, $3, $5);
                                     }
                                 ;
 
 if_else                         : IF_KEYWORD '(' expression ')' expression %prec NO_ELSE
                                     {
-                                        $$ = waitui_ast_if_else_new($3, $5, NULL);
+                                        $$ = waitui_ast_if_else_new(extraParser->arena, $3, $5, NULL);
                                     }
                                 | IF_KEYWORD '(' expression ')' expression ELSE_KEYWORD expression
                                     {
-                                        $$ = waitui_ast_if_else_new($3, $5, $7);
+                                        $$ = waitui_ast_if_else_new(extraParser->arena, $3, $5, $7);
                                     }
                                 ;
 
 let                             : LET_KEYWORD initializations IN_KEYWORD expression
                                     {
-                                        $$ = waitui_ast_let_new($2, $4);
+                                        $$ = waitui_ast_let_new(extraParser->arena, $2, $4);
                                     }
                                 ;
 
 literal                         : INTEGER_LITERAL
                                     {
-                                        $$ = (waitui_ast_expression *) waitui_ast_integer_literal_new($1);
+                                        $$ = (waitui_ast_expression *) waitui_ast_integer_literal_new(extraParser->arena, $1);
                                     }
                                 | DECIMAL_LITERAL
                                     {
-                                        $$ = (waitui_ast_expression *) waitui_ast_decimal_literal_new($1);
+                                        $$ = (waitui_ast_expression *) waitui_ast_decimal_literal_new(extraParser->arena, $1);
                                     }
                                 | STRING_LITERAL
                                     {
-                                        $$ = (waitui_ast_expression *) waitui_ast_string_literal_new($1);
+                                        $$ = (waitui_ast_expression *) waitui_ast_string_literal_new(extraParser->arena, $1);
                                     }
                                 | NULL_LITERAL
                                     {
-                                        $$ = (waitui_ast_expression *) waitui_ast_null_literal_new();
+                                        $$ = (waitui_ast_expression *) waitui_ast_null_literal_new(extraParser->arena);
                                     }
                                 | THIS_LITERAL
                                     {
-                                        $$ = (waitui_ast_expression *) waitui_ast_this_literal_new();
+                                        $$ = (waitui_ast_expression *) waitui_ast_this_literal_new(extraParser->arena);
                                     }
                                 | TRUE_LITERAL
                                     {
-                                        $$ = (waitui_ast_expression *) waitui_ast_boolean_literal_new(true);
+                                        $$ = (waitui_ast_expression *) waitui_ast_boolean_literal_new(extraParser->arena, true);
                                     }
                                 | FALSE_LITERAL
                                     {
-                                        $$ = (waitui_ast_expression *) waitui_ast_boolean_literal_new(false);
+                                        $$ = (waitui_ast_expression *) waitui_ast_boolean_literal_new(extraParser->arena, false);
                                     }
                                 | IDENTIFIER
                                     {
-                                        $$ = (waitui_ast_expression *) waitui_ast_reference_new($1);
+                                        $$ = (waitui_ast_expression *) waitui_ast_reference_new(extraParser->arena, $1);
                                     }
                                 ;
 
 unary_expression                : '-' expression %prec UMINUS
                                     {
-                                        $$ = waitui_ast_unary_expression_new(WAITUI_AST_UNARY_OPERATOR_MINUS, $2);
+                                        $$ = waitui_ast_unary_expression_new(extraParser->arena, WAITUI_AST_UNARY_OPERATOR_MINUS, $2);
                                     }
                                 | NOT_OPERATOR expression
                                     {
-                                        $$ = waitui_ast_unary_expression_new(WAITUI_AST_UNARY_OPERATOR_NOT, $2);
+                                        $$ = waitui_ast_unary_expression_new(extraParser->arena, WAITUI_AST_UNARY_OPERATOR_NOT, $2);
                                     }
                                 | DOUBLE_PLUS_OPERATOR expression
                                     {
-                                        $$ = waitui_ast_unary_expression_new(WAITUI_AST_UNARY_OPERATOR_DOUBLE_PLUS, $2);
+                                        $$ = waitui_ast_unary_expression_new(extraParser->arena, WAITUI_AST_UNARY_OPERATOR_DOUBLE_PLUS, $2);
                                     }
                                 | DOUBLE_MINUS_OPERATOR expression
                                     {
-                                        $$ = waitui_ast_unary_expression_new(WAITUI_AST_UNARY_OPERATOR_DOUBLE_MINUS, $2);
+                                        $$ = waitui_ast_unary_expression_new(extraParser->arena, WAITUI_AST_UNARY_OPERATOR_DOUBLE_MINUS, $2);
                                     }
                                 ;
 
 while                           : WHILE_KEYWORD '(' expression ')' expression
                                     {
-                                        $$ = waitui_ast_while_new($3, $5);
+                                        $$ = waitui_ast_while_new(extraParser->arena, $3, $5);
                                     }
                                 ;
 
@@ -615,7 +618,7 @@ while                           : WHILE_KEYWORD '(' expression ')' expression
 
 formals                         : /* empty */
                                     {
-                                        $$ = waitui_ast_formal_list_new();
+                                        $$ = waitui_ast_formal_vector_newInArena(extraParser->arena);
                                     }
                                 | formal_list
                                     {
@@ -625,34 +628,34 @@ formals                         : /* empty */
 
 formal_list                     : formal
                                     {
-                                        $$ = waitui_ast_formal_list_new();
-                                        waitui_ast_formal_list_push($$, $1);
+                                        $$ = waitui_ast_formal_vector_newInArena(extraParser->arena);
+                                        waitui_ast_formal_vector_push($$, $1);
                                     }
                                 | formal_list ',' formal
                                     {
                                         $$ = $1;
-                                        waitui_ast_formal_list_push($$, $3);
+                                        waitui_ast_formal_vector_push($$, $3);
                                     }
                                 ;
 
 formal                          : LAZY_KEYWORD IDENTIFIER ':' IDENTIFIER
                                     {
-                                        $$ = waitui_ast_formal_new($2, $4, true);
+                                        $$ = waitui_ast_formal_new(extraParser->arena, $2, $4, true);
                                     }
                                 | IDENTIFIER ':' IDENTIFIER
                                     {
-                                        $$ = waitui_ast_formal_new($1, $3, false);
+                                        $$ = waitui_ast_formal_new(extraParser->arena, $1, $3, false);
                                     }
                                 ;
 
 expressions                     : /* empty */
                                     {
-                                        $$ = waitui_ast_expression_list_new();
+                                        $$ = waitui_ast_expression_vector_newInArena(extraParser->arena);
                                     }
                                 | expression
                                     {
-                                        $$ = waitui_ast_expression_list_new();
-                                        waitui_ast_expression_list_push($$, $1);
+                                        $$ = waitui_ast_expression_vector_newInArena(extraParser->arena);
+                                        waitui_ast_expression_vector_push($$, $1);
                                     }
                                 | expression_list
                                     {
@@ -662,19 +665,19 @@ expressions                     : /* empty */
 
 expression_list                 : expression ';'
                                     {
-                                        $$ = waitui_ast_expression_list_new();
-                                        waitui_ast_expression_list_push($$, $1);
+                                        $$ = waitui_ast_expression_vector_newInArena(extraParser->arena);
+                                        waitui_ast_expression_vector_push($$, $1);
                                     }
                                 | expression_list expression ';'
                                     {
                                         $$ = $1;
-                                        waitui_ast_expression_list_push($$, $2);
+                                        waitui_ast_expression_vector_push($$, $2);
                                     }
                                 ;
 
 actuals                         : /* empty */
                                     {
-                                        $$ = waitui_ast_expression_list_new();
+                                        $$ = waitui_ast_expression_vector_newInArena(extraParser->arena);
                                     }
                                 | actual_list
                                     {
@@ -684,20 +687,20 @@ actuals                         : /* empty */
 
 actual_list                     : expression
                                     {
-                                        $$ = waitui_ast_expression_list_new();
-                                        waitui_ast_expression_list_push($$, $1);
+                                        $$ = waitui_ast_expression_vector_newInArena(extraParser->arena);
+                                        waitui_ast_expression_vector_push($$, $1);
                                     }
                                 | actual_list ',' expression
                                     {
                                         $$ = $1;
-                                        waitui_ast_expression_list_push($$, $3);
+                                        waitui_ast_expression_vector_push($$, $3);
                                     }
                                 ;
 
 initializations                 : initialization
                                     {
-                                        $$ = waitui_ast_initialization_list_new();
-                                        waitui_ast_initialization_list_push ($$, $1);
+                                        $$ = waitui_ast_initialization_vector_newInArena(extraParser->arena);
+                                        waitui_ast_initialization_vector_push ($$, $1);
                                     }
                                 | initialization_list
                                     {
@@ -707,27 +710,27 @@ initializations                 : initialization
 
 initialization_list             : initialization ','
                                     {
-                                        $$ = waitui_ast_initialization_list_new();
-                                        waitui_ast_initialization_list_push ($$, $1);
+                                        $$ = waitui_ast_initialization_vector_newInArena(extraParser->arena);
+                                        waitui_ast_initialization_vector_push ($$, $1);
                                     }
                                 | initialization_list initialization
                                     {
                                         $$ = $1;
-                                        waitui_ast_initialization_list_push($$, $2);
+                                        waitui_ast_initialization_vector_push($$, $2);
                                     }
                                 ;
 
 initialization                  : IDENTIFIER ':' IDENTIFIER '=' expression
                                     {
-                                        $$ = waitui_ast_initialization_new($1, $3, $5);
+                                        $$ = waitui_ast_initialization_new(extraParser->arena, $1, $3, $5);
                                     }
                                 | IDENTIFIER ':' IDENTIFIER
                                     {
-                                        $$ = waitui_ast_initialization_new($1, $3, NULL);
+                                        $$ = waitui_ast_initialization_new(extraParser->arena, $1, $3, NULL);
                                     }
                                 | IDENTIFIER '=' expression
                                     {
-                                        $$ = waitui_ast_initialization_new($1, NULL, $3);
+                                        $$ = waitui_ast_initialization_new(extraParser->arena, $1, NULL, $3);
                                     }
                                 ;
 
@@ -736,7 +739,8 @@ initialization                  : IDENTIFIER ':' IDENTIFIER '=' expression
 
 
 void yyerror(YYLTYPE *locp, parser_extra_parser *extraParser, char const *msg) {
-    fprintf(stderr, "ERROR: %.*s (%d:%d): %s in this line:\n%s\n",
+    fprintf(extraParser->diagnostics ? extraParser->diagnostics : stderr,
+            "ERROR: %.*s (%d:%d): %s in this line:\n%s\n",
             STR_FMT(&locp->filename), locp->first_line, locp->first_column + 1, msg, "");
     /*fprintf(stderr, "%*s\n", yylloc.first_column + 1, "^");*/
 }
@@ -0,0 +1,276 @@
+/**
+ * @file test_module_cache.c
+ * @author rick
+ * @date 17.10.26
+ * @brief Test for the Module cache implementation
+ */
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <cmocka.h>
+
+#include "waitui/module_cache.h"
+
+#include <waitui/log.h>
+#include <waitui/threadpool.h>
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define ROUND_COUNT 200
+#define THREAD_COUNT 8
+#define JOB_COUNT 32
+
+typedef struct module_file {
+    const char *name;
+    const char *source;
+} module_file;
+
+typedef struct loader {
+    parser_module_cache *cache;
+    atomic_int incomplete;
+} loader;
+
+/**
+ * A diamond, top imports left and right which both import base, on top of
+ * import cycles, base and right both import cycle which imports them back.
+ */
+static const module_file moduleFiles[] = {
+        {"top.wai", "namespace org\n"
+                    "\n"
+                    "import org.left\n"
+                    "import org.right\n"
+                    "\n"
+                    "class Top {\n"
+                    "}\n"},
+        {"left.wai", "namespace org\n"
+                     "\n"
+                     "import org.base\n"
+                     "\n"
+                     "class Left {\n"
+                     "}\n"},
+        {"right.wai", "namespace org\n"
+                      "\n"
+                      "import org.base\n"
+                      "import org.cycle\n"
+                      "\n"
+                      "class Right {\n"
+                      "}\n"},
+        {"base.wai", "namespace org\n"
+                     "\n"
+                     "import org.cycle\n"
+                     "\n"
+                     "class Base {\n"
+                     "}\n"},
+        {"cycle.wai", "namespace org\n"
+                      "\n"
+                      "import org.base\n"
+                      "import org.right\n"
+                      "\n"
+                      "class Cycle {\n"
+                      "}\n"},
+};
+
+#define MODULE_COUNT (sizeof(moduleFiles) / sizeof(moduleFiles[0]))
+
+static char directory[] = "/tmp/waitui-test_module_cache-XXXXXX";
+
+static int write_file(const char *name, const char *source) {
+    char path[256];
+    FILE *file = NULL;
+
+    snprintf(path, sizeof(path), "%s/org/%s", directory, name);
+
+    file = fopen(path, "w");
+    if (!file) { return 0; }
+    fputs(source, file);
+    return fclose(file) == 0;
+}
+
+static void remove_file(const char *name) {
+    char path[256];
+
+    snprintf(path, sizeof(path), "%s/org/%s", directory, name);
+    unlink(path);
+}
+
+static int count_dependency(void *args, str canonicalPath) {
+    (void) canonicalPath; /* unused */
+
+    (*(int *) args)++;
+    return 1;
+}
+
+/**
+ * Test that every import reachable from the AST is resolved, the depth is
+ * limited as the imports form a cycle.
+ */
+static int is_complete(waitui_ast *ast, int depth) {
+    if (depth > (int) MODULE_COUNT) { return 1; }
+
+    WAITUI_VECTOR_FOREACH(
+            waitui_ast_namespace, namespace,
+            waitui_ast_program_getNamespaces(waitui_ast_getProgram(ast))) {
+        WAITUI_VECTOR_FOREACH(waitui_ast_import, import,
+                              waitui_ast_namespace_getImports(namespace)) {
+            waitui_ast *module = waitui_ast_import_getModule(import);
+
+            if (!module || !is_complete(module, depth + 1)) { return 0; }
+        }
+    }
+
+    return 1;
+}
+
+static waitui_ast *first_import_module(waitui_ast *ast) {
+    waitui_ast_namespace *namespace = waitui_ast_namespace_vector_get(
+            waitui_ast_program_getNamespaces(waitui_ast_getProgram(ast)), 0);
+    waitui_ast_import *import = waitui_ast_import_vector_get(
+            waitui_ast_namespace_getImports(namespace), 0);
+
+    return waitui_ast_import_getModule(import);
+}
+
+static void load_top(void *args, unsigned long int index) {
+    loader *this      = args;
+    str importName    = STR_STATIC_INIT("org.top");
+    str otherName     = STR_STATIC_INIT("org.cycle");
+    waitui_ast *ast   = NULL;
+    FILE *diagnostics = fopen("/dev/null", "w");
+
+    // half of the jobs start inside the cycle
+    ast = parser_module_cache_load(this->cache,
+                                   index % 2 ? otherName : importName,
+                                   diagnostics);
+    if (!ast || !is_complete(ast, 0)) {
+        atomic_fetch_add(&this->incomplete, 1);
+    }
+
+    if (diagnostics) { fclose(diagnostics); }
+}
+
+static int setup(void **state) {
+    char path[256];
+
+    (void) state; /* unused */
+
+    waitui_log_setQuiet(true);
+
+    if (!mkdtemp(directory)) { return -1; }
+    snprintf(path, sizeof(path), "%s/org", directory);
+    if (mkdir(path, 0700) != 0) { return -1; }
+
+    for (unsigned long int i = 0; i < MODULE_COUNT; ++i) {
+        if (!write_file(moduleFiles[i].name, moduleFiles[i].source)) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int teardown(void **state) {
+    char path[256];
+
+    (void) state; /* unused */
+
+    for (unsigned long int i = 0; i < MODULE_COUNT; ++i) {
+        remove_file(moduleFiles[i].name);
+    }
+    snprintf(path, sizeof(path), "%s/org", directory);
+    rmdir(path);
+    rmdir(directory);
+
+    return 0;
+}
+
+static void test_module_cache_load_parallel(void **state) {
+    (void) state; /* unused */
+
+    str searchPath                = {.s = directory, .len = strlen(directory)};
+    waitui_threadpool *threadpool = waitui_threadpool_new(THREAD_COUNT);
+    loader loader                 = {0};
+
+    assert_non_null(threadpool);
+
+    for (int round = 0; round < ROUND_COUNT; ++round) {
+        loader.cache = parser_module_cache_new(&searchPath, 1);
+        assert_non_null(loader.cache);
+        atomic_init(&loader.incomplete, 0);
+
+        waitui_threadpool_run(threadpool, JOB_COUNT, load_top, &loader);
+
+        // a load only returns once the whole import graph below is resolved
+        assert_int_equal(atomic_load(&loader.incomplete), 0);
+        assert_int_equal(parser_module_cache_getParsedCount(loader.cache),
+                         MODULE_COUNT);
+        assert_int_equal(
+                parser_module_cache_writeDiagnostics(loader.cache, stderr), 0);
+
+        parser_module_cache_destroy(&loader.cache);
+    }
+
+    waitui_threadpool_destroy(&threadpool);
+}
+
+static void test_module_cache_load_cycle(void **state) {
+    (void) state; /* unused */
+
+    str searchPath             = {.s = directory, .len = strlen(directory)};
+    str baseName               = STR_STATIC_INIT("org.base");
+    str cycleName              = STR_STATIC_INIT("org.cycle");
+    parser_module_cache *cache = parser_module_cache_new(&searchPath, 1);
+    waitui_ast *base           = NULL;
+    waitui_ast *cycle          = NULL;
+
+    assert_non_null(cache);
+
+    base = parser_module_cache_load(cache, baseName, stderr);
+    assert_non_null(base);
+    cycle = parser_module_cache_load(cache, cycleName, stderr);
+    assert_non_null(cycle);
+
+    assert_ptr_equal(first_import_module(base), cycle);
+    assert_ptr_equal(first_import_module(cycle), base);
+
+    parser_module_cache_destroy(&cache);
+}
+
+static void test_module_cache_forEachDependency(void **state) {
+    (void) state; /* unused */
+
+    str searchPath             = {.s = directory, .len = strlen(directory)};
+    str topName                = STR_STATIC_INIT("org.top");
+    parser_module_cache *cache = parser_module_cache_new(&searchPath, 1);
+    waitui_ast *top            = NULL;
+    int count                  = 0;
+
+    assert_non_null(cache);
+
+    top = parser_module_cache_load(cache, topName, stderr);
+    assert_non_null(top);
+
+    assert_true(parser_module_cache_forEachDependency(cache, top,
+                                                      count_dependency,
+                                                      &count));
+    assert_int_equal(count, MODULE_COUNT - 1);
+
+    parser_module_cache_destroy(&cache);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test(test_module_cache_load_parallel),
+            cmocka_unit_test(test_module_cache_load_cycle),
+            cmocka_unit_test(test_module_cache_forEachDependency),
+    };
+
+    return cmocka_run_group_tests(tests, setup, teardown);
+}
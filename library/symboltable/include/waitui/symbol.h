@@ -50,6 +50,8 @@ typedef struct symbol {
  * @param[in] type Type of the Symbol
  * @param[in] line Line of the Symbol
  * @param[in] column Column of the Symbol
+ * @note The identifier has to be interned, it is not copied and has to outlive
+ *       the Symbol.
  * @return On success a pointer to Symbol, else NULL
  */
 extern symbol *symbol_new(str identifier, symbol_type type,
@@ -11,6 +11,7 @@
 #include "waitui/symbol.h"
 
 #include <waitui/hashtable.h>
+#include <waitui/intern.h>
 
 
 // -----------------------------------------------------------------------------
@@ -22,11 +23,18 @@ CREATE_HASHTABLE_TYPE_CUSTOM(INTERFACE, symbol, symbol,
 
 /**
  * @brief Type for the SymbolTable.
+ * @note The scopeLog records every Symbol inserted into the symbols in order of
+ *       insertion, so exiting a scope only touches the Symbols of that scope.
+ *       The symbols are keyed by the interned identifiers of the Symbols.
  */
 typedef struct symboltable {
     long int currentScope;
     int declarationMode;
+    waitui_intern *intern;
     symbol_hashtable *symbols;
+    symbol **scopeLog;
+    unsigned long int scopeLogLength;
+    unsigned long int scopeLogSize;
 } symboltable;
 
 
@@ -36,9 +44,10 @@ typedef struct symboltable {
 
 /**
  * @brief Create the SymbolTable.
+ * @param[in] intern The Intern pool the identifiers of the Symbols come from
  * @return On success a pointer to SymbolTable, else NULL
  */
-extern symboltable *symboltable_new(void);
+extern symboltable *symboltable_new(waitui_intern *intern);
 
 /**
  * @brief Destroy the SymbolTable and its content.
@@ -55,6 +64,7 @@ extern void symboltable_enter_scope(symboltable *this);
 /**
  * @brief Exit current scope of the SymbolTable.
  * @param[in] this The SymbolTable to exit the current scope
+ * @note Only the Symbols declared in the current scope are visited.
  */
 extern void symboltable_exit_scope(symboltable *this);
 
@@ -75,6 +85,8 @@ extern void symboltable_leave_declaration_mode(symboltable *this);
  * @param[in] this The SymbolTable to add the Symbol
  * @param[in] identifier The identifier for which to add the SymbolTable
  * @param[in,out] newSymbol The Symbol to add
+ * @note The identifier has to match the identifier of the Symbol, the
+ *       interned identifier of the Symbol is used as key.
  * @retval 1 Ok
  * @retval 0 Double declaration or Memory allocation failed
  */
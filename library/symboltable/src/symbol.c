@@ -27,12 +27,7 @@ symbol *symbol_new(str identifier, symbol_type type, unsigned long int line,
 
     this->type = type;
 
-    STR_COPY(&this->identifier, &identifier);
-    if (!this->identifier.s) {
-        waitui_log_fatal("could not allocate memory for identifier");
-        symbol_destroy(&this);
-        return NULL;
-    }
+    this->identifier = identifier;
     this->references = symbol_reference_list_new();
     if (!this->references) {
         waitui_log_fatal("could not allocate memory for symbol_reference_list");
@@ -100,7 +95,6 @@ void symbol_destroy(symbol **this) {
     waitui_log_trace("destroying symbol with identifier '%.*s' %p",
                      STR_FMT(&(*this)->identifier), *this);
 
-    STR_FREE(&(*this)->identifier);
     symbol_reference_list_destroy(&(*this)->references);
 
     free(*this);
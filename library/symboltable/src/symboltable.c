@@ -17,7 +17,9 @@
 //  Local defines
 // -----------------------------------------------------------------------------
 
-#define SYMBOLTABLE_SIZE 997
+#define SYMBOLTABLE_INITIAL_SIZE 64
+
+#define SYMBOLTABLE_INITIAL_SCOPE_LOG_SIZE 64
 
 
 // -----------------------------------------------------------------------------
@@ -32,6 +34,65 @@ static int symboltable_symbol_check(symbol *this, symbol *other) {
     return this->scope == other->scope;
 }
 
+/**
+ * @brief Check the both Symbols to be the same Symbol.
+ * @return 1 if both Symbols are the same, else 0
+ */
+static int symboltable_symbol_same_check(symbol *this, symbol *other) {
+    return this == other;
+}
+
+/**
+ * @brief Make room for one more Symbol in the scope log of the SymbolTable.
+ * @param[in,out] this The SymbolTable to grow the scope log for
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ */
+static int symboltable_reserve_scope_log(symboltable *this) {
+    unsigned long int size = 0;
+    symbol **scopeLog      = NULL;
+
+    if (this->scopeLogLength < this->scopeLogSize) { return 1; }
+
+    size     = this->scopeLogSize ? this->scopeLogSize * 2
+                                  : SYMBOLTABLE_INITIAL_SCOPE_LOG_SIZE;
+    scopeLog = realloc(this->scopeLog, size * sizeof(*scopeLog));
+    if (!scopeLog) {
+        waitui_log_fatal("could not allocate memory for scope log");
+        return 0;
+    }
+
+    this->scopeLog     = scopeLog;
+    this->scopeLogSize = size;
+
+    return 1;
+}
+
+/**
+ * @brief Insert the Symbol into the current scope of the SymbolTable.
+ * @param[in,out] this The SymbolTable to insert the Symbol into
+ * @param[in] newSymbol The Symbol to insert
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ */
+static int symboltable_insert_symbol(symboltable *this, symbol *newSymbol) {
+    if (!symboltable_reserve_scope_log(this)) { return 0; }
+
+    newSymbol->scope = this->currentScope;
+
+    if (!symbol_hashtable_insert_check(
+                this->symbols, newSymbol->identifier, newSymbol,
+                (hashtable_value_check) symboltable_symbol_check, newSymbol)) {
+        return 0;
+    }
+
+    symbol_increment_refcount(newSymbol);
+
+    this->scopeLog[this->scopeLogLength++] = newSymbol;
+
+    return 1;
+}
+
 
 // -----------------------------------------------------------------------------
 //  Public functions
@@ -40,7 +101,7 @@ static int symboltable_symbol_check(symbol *this, symbol *other) {
 CREATE_HASHTABLE_TYPE_CUSTOM(IMPLEMENTATION, symbol, symbol,
                              symbol_decrement_refcount);
 
-symboltable *symboltable_new(void) {
+symboltable *symboltable_new(waitui_intern *intern) {
     symboltable *this = NULL;
 
     waitui_log_trace("creating new symboltable");
@@ -49,7 +110,9 @@ symboltable *symboltable_new(void) {
     if (!this) { return NULL; }
 
     this->currentScope = 0;
-    this->symbols      = symbol_hashtable_new(SYMBOLTABLE_SIZE);
+    this->intern       = intern;
+    this->symbols      = symbol_hashtable_new_interned(
+            SYMBOLTABLE_INITIAL_SIZE);
     if (!this->symbols) {
         waitui_log_fatal("could not allocate memory for symbol_hashtable");
         symboltable_destroy(&this);
@@ -67,6 +130,7 @@ void symboltable_destroy(symboltable **this) {
     if (!this || !(*this)) { return; }
 
     symbol_hashtable_destroy(&(*this)->symbols);
+    free((*this)->scopeLog);
 
     free(*this);
     *this = NULL;
@@ -87,27 +151,15 @@ void symboltable_exit_scope(symboltable *this) {
 
     waitui_log_debug("leaving scope: %ld", this->currentScope);
 
-    for (unsigned long int i = 0; i < this->symbols->size; ++i) {
-        if (this->symbols->list[i]) {
-            hashtable_node *node = this->symbols->list[i];
-
-            while (node &&
-                   ((symbol *) node->value)->scope == this->currentScope) {
-                hashtable_node *temp = node;
-
-                node = temp->next;
+    while (this->scopeLogLength > 0 &&
+           this->scopeLog[this->scopeLogLength - 1]->scope ==
+                   this->currentScope) {
+        symbol *scopeSymbol = this->scopeLog[--this->scopeLogLength];
 
-                if (!temp->isStolen) {
-                    this->symbols->valueDestroyCallback(&temp->value);
-                }
-
-                STR_FREE(&temp->key);
-
-                free(temp);
-            }
-
-            this->symbols->list[i] = node;
-        }
+        symbol_hashtable_remove_check(
+                this->symbols, scopeSymbol->identifier,
+                (hashtable_value_check) symboltable_symbol_same_check,
+                scopeSymbol);
     }
 
     waitui_log_trace("left current scope: %ld", this->currentScope);
@@ -135,7 +187,8 @@ int symboltable_add_symbol(symboltable *this, str identifier,
                            symbol **newSymbol) {
     if (!this || !newSymbol || !(*newSymbol)) { goto error; }
 
-    symbol *foundSymbol = symbol_hashtable_lookup(this->symbols, identifier);
+    symbol *foundSymbol =
+            symbol_hashtable_lookup(this->symbols, (*newSymbol)->identifier);
 
     if (foundSymbol) {
         if (this->declarationMode) {
@@ -150,17 +203,10 @@ int symboltable_add_symbol(symboltable *this, str identifier,
                 goto error;
             }
 
-            (*newSymbol)->scope = this->currentScope;
-
-            if (!symbol_hashtable_insert_check(
-                        this->symbols, identifier, *newSymbol,
-                        (hashtable_value_check) symboltable_symbol_check,
-                        *newSymbol)) {
+            if (!symboltable_insert_symbol(this, *newSymbol)) {
                 goto error;
             }
 
-            symbol_increment_refcount(*newSymbol);
-
             waitui_log_debug(
                     "declaring new symbol with identifier '%.*s' in scope %ld",
                     STR_FMT(&identifier), this->currentScope);
@@ -184,17 +230,10 @@ int symboltable_add_symbol(symboltable *this, str identifier,
             *newSymbol = foundSymbol;
         }
     } else {
-        (*newSymbol)->scope = this->currentScope;
-
-        if (!symbol_hashtable_insert_check(
-                    this->symbols, identifier, *newSymbol,
-                    (hashtable_value_check) symboltable_symbol_check,
-                    *newSymbol)) {
+        if (!symboltable_insert_symbol(this, *newSymbol)) {
             goto error;
         }
 
-        symbol_increment_refcount(*newSymbol);
-
         if (this->declarationMode) {
             waitui_log_debug("declaring new symbol with identifier '%.*s' in scope "
                       "%ld",
@@ -213,13 +252,23 @@ error:
 }
 
 int symboltable_has(symboltable *this, str identifier) {
+    str interned = STR_NULL_INIT;
+
     if (!this) { return 0; }
 
-    return symbol_hashtable_has(this->symbols, identifier);
+    if (!waitui_intern_find(this->intern, identifier, &interned)) { return 0; }
+
+    return symbol_hashtable_has(this->symbols, interned);
 }
 
 symbol *symboltable_lookup(symboltable *this, str identifier) {
+    str interned = STR_NULL_INIT;
+
     if (!this) { return NULL; }
 
-    return symbol_hashtable_lookup(this->symbols, identifier);
+    if (!waitui_intern_find(this->intern, identifier, &interned)) {
+        return NULL;
+    }
+
+    return symbol_hashtable_lookup(this->symbols, interned);
 }
@@ -0,0 +1,70 @@
+/**
+ * @file threadpool.h
+ * @author rick
+ * @date 17.10.26
+ * @brief File for the Thread pool implementation
+ */
+
+#ifndef WAITUI_THREADPOOL_H
+#define WAITUI_THREADPOOL_H
+
+
+// -----------------------------------------------------------------------------
+//  Public types
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Type representing a Thread pool.
+ */
+typedef struct waitui_threadpool waitui_threadpool;
+
+/**
+ * @brief Callback type for a job run by the Thread pool.
+ * @param[in,out] args The extra argument given to waitui_threadpool_run
+ * @param[in] index The index of the job, from 0 up to the job count
+ */
+typedef void (*waitui_threadpool_job)(void *args, unsigned long int index);
+
+
+// -----------------------------------------------------------------------------
+//  Public functions
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Create a Thread pool and start its worker threads.
+ * @param[in] threads The number of threads running jobs, 0 for one per CPU
+ * @return A pointer to waitui_threadpool or NULL if creation failed
+ * @note The thread calling waitui_threadpool_run counts as one of the threads,
+ *       so a Thread pool with one thread runs every job on the caller.
+ */
+extern waitui_threadpool *waitui_threadpool_new(unsigned long int threads);
+
+/**
+ * @brief Stop the worker threads and destroy the Thread pool.
+ * @param[in,out] this The Thread pool to destroy
+ */
+extern void waitui_threadpool_destroy(waitui_threadpool **this);
+
+/**
+ * @brief Run the job for every index up to jobCount and wait for all of them.
+ * @param[in,out] this The Thread pool to run the jobs on
+ * @param[in] jobCount The number of jobs to run
+ * @param[in] job The callback to run for every index
+ * @param[in,out] args The extra argument for the callback
+ * @note The indices are handed out one by one, so long and short jobs balance
+ *       out over the threads. The order the jobs run in is not defined, jobs
+ *       should write their results into a slot of their index.
+ */
+extern void waitui_threadpool_run(waitui_threadpool *this,
+                                  unsigned long int jobCount,
+                                  waitui_threadpool_job job, void *args);
+
+/**
+ * @brief Return the number of threads running jobs including the caller.
+ * @param[in] this The Thread pool to ask
+ * @return The number of threads
+ */
+extern unsigned long int
+waitui_threadpool_getThreadCount(const waitui_threadpool *this);
+
+#endif//WAITUI_THREADPOOL_H
@@ -0,0 +1,186 @@
+/**
+ * @file threadpool.c
+ * @author rick
+ * @date 17.10.26
+ * @brief File for the Thread pool implementation
+ */
+
+#include "waitui/threadpool.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+
+// -----------------------------------------------------------------------------
+//  Local types
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Struct representing a Thread pool.
+ * @note Every call of waitui_threadpool_run starts a new generation, the
+ *       workers sleep until the generation changes and count themselves out
+ *       in busy when no index is left.
+ */
+struct waitui_threadpool {
+    pthread_t *workers;
+    unsigned long int workerCount;
+    pthread_mutex_t mutex;
+    pthread_cond_t wake;
+    pthread_cond_t done;
+    waitui_threadpool_job job;
+    void *args;
+    unsigned long int jobCount;
+    atomic_ulong nextIndex;
+    unsigned long int generation;
+    unsigned long int busy;
+    bool stop;
+};
+
+
+// -----------------------------------------------------------------------------
+//  Local functions
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Run jobs of the current generation until no index is left.
+ * @param[in,out] this The Thread pool to take the jobs from
+ * @param[in] job The callback of the current generation
+ * @param[in,out] args The extra argument of the current generation
+ * @param[in] jobCount The number of jobs of the current generation
+ */
+static void waitui_threadpool_work(waitui_threadpool *this,
+                                   waitui_threadpool_job job, void *args,
+                                   unsigned long int jobCount) {
+    unsigned long int index = 0;
+
+    while ((index = atomic_fetch_add(&this->nextIndex, 1)) < jobCount) {
+        job(args, index);
+    }
+}
+
+/**
+ * @brief The worker thread waiting for new generations of jobs.
+ * @param[in,out] arg The Thread pool the worker belongs to
+ * @return Always NULL
+ */
+static void *waitui_threadpool_worker(void *arg) {
+    waitui_threadpool *this      = arg;
+    unsigned long int generation = 0;
+
+    pthread_mutex_lock(&this->mutex);
+    for (;;) {
+        waitui_threadpool_job job  = NULL;
+        void *args                 = NULL;
+        unsigned long int jobCount = 0;
+
+        while (!this->stop && this->generation == generation) {
+            pthread_cond_wait(&this->wake, &this->mutex);
+        }
+        if (this->stop) { break; }
+
+        generation = this->generation;
+        job        = this->job;
+        args       = this->args;
+        jobCount   = this->jobCount;
+        pthread_mutex_unlock(&this->mutex);
+
+        waitui_threadpool_work(this, job, args, jobCount);
+
+        pthread_mutex_lock(&this->mutex);
+        if (--this->busy == 0) { pthread_cond_signal(&this->done); }
+    }
+    pthread_mutex_unlock(&this->mutex);
+
+    return NULL;
+}
+
+
+// -----------------------------------------------------------------------------
+//  Public functions
+// -----------------------------------------------------------------------------
+
+waitui_threadpool *waitui_threadpool_new(unsigned long int threads) {
+    waitui_threadpool *this = NULL;
+
+    if (threads == 0) {
+        long int cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads       = cpus > 0 ? (unsigned long int) cpus : 1;
+    }
+
+    this = calloc(1, sizeof(*this));
+    if (!this) { return NULL; }
+
+    this->workers = calloc(threads, sizeof(*this->workers));
+    if (!this->workers) {
+        free(this);
+        return NULL;
+    }
+
+    pthread_mutex_init(&this->mutex, NULL);
+    pthread_cond_init(&this->wake, NULL);
+    pthread_cond_init(&this->done, NULL);
+    atomic_init(&this->nextIndex, 0);
+
+    for (unsigned long int i = 0; i + 1 < threads; ++i) {
+        if (pthread_create(&this->workers[i], NULL, waitui_threadpool_worker,
+                           this) != 0) {
+            waitui_threadpool_destroy(&this);
+            return NULL;
+        }
+        this->workerCount++;
+    }
+
+    return this;
+}
+
+void waitui_threadpool_destroy(waitui_threadpool **this) {
+    if (!this || !(*this)) { return; }
+
+    pthread_mutex_lock(&(*this)->mutex);
+    (*this)->stop = true;
+    pthread_cond_broadcast(&(*this)->wake);
+    pthread_mutex_unlock(&(*this)->mutex);
+
+    for (unsigned long int i = 0; i < (*this)->workerCount; ++i) {
+        pthread_join((*this)->workers[i], NULL);
+    }
+
+    pthread_cond_destroy(&(*this)->done);
+    pthread_cond_destroy(&(*this)->wake);
+    pthread_mutex_destroy(&(*this)->mutex);
+
+    free((*this)->workers);
+    free(*this);
+    *this = NULL;
+}
+
+void waitui_threadpool_run(waitui_threadpool *this, unsigned long int jobCount,
+                           waitui_threadpool_job job, void *args) {
+    if (!this || !job || jobCount == 0) { return; }
+
+    pthread_mutex_lock(&this->mutex);
+    this->job      = job;
+    this->args     = args;
+    this->jobCount = jobCount;
+    this->busy     = this->workerCount;
+    atomic_store(&this->nextIndex, 0);
+    this->generation++;
+    pthread_cond_broadcast(&this->wake);
+    pthread_mutex_unlock(&this->mutex);
+
+    waitui_threadpool_work(this, job, args, jobCount);
+
+    pthread_mutex_lock(&this->mutex);
+    while (this->busy > 0) { pthread_cond_wait(&this->done, &this->mutex); }
+    pthread_mutex_unlock(&this->mutex);
+}
+
+unsigned long int
+waitui_threadpool_getThreadCount(const waitui_threadpool *this) {
+    if (!this) { return 0; }
+
+    return this->workerCount + 1;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file type_checker.h
+ * @author rick
+ * @date 17.10.26
+ * @brief File for the Type checker implementation
+ */
+
+#ifndef WAITUI_TYPE_CHECKER_H
+#define WAITUI_TYPE_CHECKER_H
+
+#include <waitui/ast.h>
+#include <waitui/str.h>
+
+#include <stdbool.h>
+#include <stdio.h>
+
+
+// -----------------------------------------------------------------------------
+//  Public types
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The kinds of types possible for the value of an expression.
+ * @note Null is the type of the null literal and of loops, null can be
+ *       assigned to every type.
+ */
+typedef enum waitui_type_kind {
+    WAITUI_TYPE_KIND_NULL,
+    WAITUI_TYPE_KIND_BOOLEAN,
+    WAITUI_TYPE_KIND_INTEGER,
+    WAITUI_TYPE_KIND_DECIMAL,
+    WAITUI_TYPE_KIND_STRING,
+    WAITUI_TYPE_KIND_CLASS,
+} waitui_type_kind;
+
+/**
+ * @brief Struct representing the type of the value of an expression.
+ * @note Types are interned, there is one type per built-in type and per
+ *       class, so two types are the same type if they are the same pointer.
+ *       The class and super type are only set for classes.
+ */
+struct waitui_type {
+    waitui_type_kind kind;
+    str name;
+    waitui_ast_class *class;
+    const waitui_type *superType;
+};
+
+
+// -----------------------------------------------------------------------------
+//  Public functions
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Resolve the type of every expression of the AST once and store it
+ *        in the expression.
+ * @param[in,out] ast The AST to type check
+ * @param[in] fileName The source file of the AST, the errors start with it
+ * @param[out] errorCount The number of type errors found, may be NULL
+ * @param[in,out] diagnostics The file to write the errors to, NULL for stderr
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ * @note The type errors are written to the diagnostics. An expression whose
+ *       type can not be resolved keeps NULL as value type. The types of
+ *       classes live in the arena of the AST and point to the classes of the
+ *       AST and of the modules it imports, the expressions of the modules are
+ *       not changed, they may be shared with other ASTs.
+ */
+extern int waitui_type_checker_check(waitui_ast *ast, str fileName,
+                                     unsigned long int *errorCount,
+                                     FILE *diagnostics);
+
+/**
+ * @brief Return whether a value of the type can be stored where a value of
+ *        the other type is expected.
+ * @param[in] from The type of the value
+ * @param[in] to The expected type
+ * @return true if from is to, null or a sub class of to
+ */
+extern bool waitui_type_isAssignable(const waitui_type *from,
+                                     const waitui_type *to);
+
+#endif//WAITUI_TYPE_CHECKER_H
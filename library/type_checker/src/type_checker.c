@@ -0,0 +1,1135 @@
+/**
+ * @file type_checker.c
+ * @author rick
+ * @date 17.10.26
+ * @brief File for the Type checker implementation
+ */
+
+#include "waitui/type_checker.h"
+
+#include <waitui/hashtable.h>
+#include <waitui/log.h>
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+// -----------------------------------------------------------------------------
+//  Local defines
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The maximal nesting of expressions the Type checker descends into.
+ */
+#define WAITUI_TYPE_CHECKER_MAX_DEPTH 1000
+
+/**
+ * @brief Return whether the type is Int or Decimal.
+ */
+#define WAITUI_TYPE_IS_NUMBER(type)                                            \
+    ((type)->kind == WAITUI_TYPE_KIND_INTEGER ||                               \
+     (type)->kind == WAITUI_TYPE_KIND_DECIMAL)
+
+
+// -----------------------------------------------------------------------------
+//  Local types
+// -----------------------------------------------------------------------------
+
+CREATE_HASHTABLE_TYPE_CUSTOM(INTERFACE, waitui_type, waitui_type, NULL)
+
+/**
+ * @brief Type for a local variable, a parameter or a let binding, in scope.
+ * @note The type is NULL if the declared type is unknown.
+ */
+typedef struct waitui_type_local {
+    const str *name;
+    const waitui_type *type;
+} waitui_type_local;
+
+/**
+ * @brief Type for checking the types of an AST.
+ */
+typedef struct waitui_type_checker {
+    waitui_arena *arena;
+    str fileName;
+    FILE *diagnostics;
+    waitui_type_hashtable *classTypes;
+    waitui_type **types;
+    unsigned long int typeCount;
+    unsigned long int typeCapacity;
+    const waitui_type *classType;
+    const str *functionName;
+    waitui_type_local *locals;
+    unsigned long int localCount;
+    unsigned long int localCapacity;
+    unsigned long int depth;
+    bool tooDeep;
+    unsigned long int errorCount;
+    bool failed;
+} waitui_type_checker;
+
+
+// -----------------------------------------------------------------------------
+//  Local variables
+// -----------------------------------------------------------------------------
+
+static const waitui_type waitui_type_null    = {WAITUI_TYPE_KIND_NULL,
+                                                STR_STATIC_INIT("Null"), NULL,
+                                                NULL};
+static const waitui_type waitui_type_boolean = {WAITUI_TYPE_KIND_BOOLEAN,
+                                                STR_STATIC_INIT("Bool"), NULL,
+                                                NULL};
+static const waitui_type waitui_type_integer = {WAITUI_TYPE_KIND_INTEGER,
+                                                STR_STATIC_INIT("Int"), NULL,
+                                                NULL};
+static const waitui_type waitui_type_decimal = {WAITUI_TYPE_KIND_DECIMAL,
+                                                STR_STATIC_INIT("Decimal"),
+                                                NULL, NULL};
+static const waitui_type waitui_type_string  = {WAITUI_TYPE_KIND_STRING,
+                                                STR_STATIC_INIT("String"), NULL,
+                                                NULL};
+
+
+// -----------------------------------------------------------------------------
+//  Local functions
+// -----------------------------------------------------------------------------
+
+CREATE_HASHTABLE_TYPE_CUSTOM(IMPLEMENTATION, waitui_type, waitui_type, NULL)
+
+static const waitui_type *
+waitui_type_checker_checkExpression(waitui_type_checker *this,
+                                    waitui_ast_expression *expression);
+
+/**
+ * @brief Write the type error of the class being checked to the diagnostics.
+ * @param[in,out] this The Type checker
+ * @param[in] format The printf format of the error
+ * @return Always NULL, to be returned as the unknown type
+ */
+static const waitui_type *waitui_type_checker_error(waitui_type_checker *this,
+                                                    const char *format, ...) {
+    char message[256];
+    va_list args;
+
+    va_start(args, format);
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+
+    this->errorCount++;
+
+    if (this->classType && this->functionName) {
+        fprintf(this->diagnostics, "ERROR: %.*s: %.*s.%.*s: %s\n",
+                STR_FMT(&this->fileName), STR_FMT(&this->classType->name),
+                STR_FMT(this->functionName), message);
+    } else if (this->classType) {
+        fprintf(this->diagnostics, "ERROR: %.*s: %.*s: %s\n",
+                STR_FMT(&this->fileName), STR_FMT(&this->classType->name),
+                message);
+    } else {
+        fprintf(this->diagnostics, "ERROR: %.*s: %s\n",
+                STR_FMT(&this->fileName), message);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Return the type with the name, a built-in type or a class.
+ * @param[in,out] this The Type checker
+ * @param[in] name The name of the type, may be NULL
+ * @return The type or NULL if there is no type with the name
+ */
+static const waitui_type *
+waitui_type_checker_resolveType(waitui_type_checker *this,
+                                const symbol *name) {
+    static const waitui_type *builtins[] = {
+            &waitui_type_boolean,
+            &waitui_type_integer,
+            &waitui_type_decimal,
+            &waitui_type_string,
+    };
+    const waitui_type *type = NULL;
+
+    if (!name) { return NULL; }
+
+    for (unsigned long int i = 0; i < sizeof(builtins) / sizeof(*builtins);
+         ++i) {
+        if (STR_EQUALS(&builtins[i]->name, &name->identifier)) {
+            return builtins[i];
+        }
+    }
+
+    type = waitui_type_hashtable_lookup(this->classTypes, name->identifier);
+    if (!type) {
+        return waitui_type_checker_error(this, "unknown type '%.*s'",
+                                         STR_FMT(&name->identifier));
+    }
+    return type;
+}
+
+/**
+ * @brief Return the common type of the values of two branches.
+ * @param[in,out] this The Type checker
+ * @param[in] a The type of the first branch, may be NULL
+ * @param[in] b The type of the second branch, may be NULL
+ * @return The type both can be assigned to or NULL if there is none
+ * @note The common type of two classes is their nearest common super class.
+ */
+static const waitui_type *waitui_type_checker_join(waitui_type_checker *this,
+                                                   const waitui_type *a,
+                                                   const waitui_type *b) {
+    if (!a || !b) { return NULL; }
+
+    for (const waitui_type *type = a; type; type = type->superType) {
+        if (waitui_type_isAssignable(b, type)) { return type; }
+    }
+    if (waitui_type_isAssignable(a, b)) { return b; }
+
+    return waitui_type_checker_error(this, "branches have the incompatible "
+                                           "types '%.*s' and '%.*s'",
+                                     STR_FMT(&a->name), STR_FMT(&b->name));
+}
+
+/**
+ * @brief Report an error if the value can not be stored as the type.
+ * @param[in,out] this The Type checker
+ * @param[in] from The type of the value, may be NULL
+ * @param[in] to The expected type, may be NULL
+ * @param[in] what The description of where the value is stored
+ * @param[in] name The name of where the value is stored
+ */
+static void waitui_type_checker_expect(waitui_type_checker *this,
+                                       const waitui_type *from,
+                                       const waitui_type *to, const char *what,
+                                       const str *name) {
+    if (!from || !to || waitui_type_isAssignable(from, to)) { return; }
+
+    waitui_type_checker_error(this, "%s '%.*s' expects '%.*s' but got '%.*s'",
+                              what, STR_FMT(name), STR_FMT(&to->name),
+                              STR_FMT(&from->name));
+}
+
+/**
+ * @brief Add the local to the scope.
+ * @param[in,out] this The Type checker
+ * @param[in] name The name of the local
+ * @param[in] type The type of the local, may be NULL
+ */
+static void waitui_type_checker_addLocal(waitui_type_checker *this,
+                                         const str *name,
+                                         const waitui_type *type) {
+    if (this->localCount == this->localCapacity) {
+        unsigned long int capacity =
+                this->localCapacity ? this->localCapacity * 2 : 16;
+        waitui_type_local *locals =
+                realloc(this->locals, capacity * sizeof(*locals));
+        if (!locals) {
+            this->failed = true;
+            return;
+        }
+
+        this->locals        = locals;
+        this->localCapacity = capacity;
+    }
+
+    this->locals[this->localCount].name   = name;
+    this->locals[this->localCount++].type = type;
+}
+
+/**
+ * @brief Find the local with the name, inner scopes first.
+ * @param[in] this The Type checker
+ * @param[in] name The name of the local
+ * @param[out] type The type of the local
+ * @return true if there is a local with the name
+ */
+static bool waitui_type_checker_findLocal(const waitui_type_checker *this,
+                                          const str *name,
+                                          const waitui_type **type) {
+    for (unsigned long int i = this->localCount; i > 0; --i) {
+        if (STR_EQUALS(this->locals[i - 1].name, name)) {
+            *type = this->locals[i - 1].type;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Find the field with the name in the class being checked, fields of
+ *        sub classes hide the ones of super classes.
+ * @param[in,out] this The Type checker
+ * @param[in] name The name of the field
+ * @param[out] type The type of the field
+ * @return true if there is a field with the name
+ */
+static bool waitui_type_checker_findField(waitui_type_checker *this,
+                                          const str *name,
+                                          const waitui_type **type) {
+    for (const waitui_type *class = this->classType; class;
+         class = class->superType) {
+        WAITUI_VECTOR_FOREACH(waitui_ast_property, property,
+                              waitui_ast_class_getProperties(class->class)) {
+            if (STR_EQUALS(&waitui_ast_property_getName(property)->identifier,
+                           name)) {
+                *type = waitui_type_checker_resolveType(
+                        this, waitui_ast_property_getType(property));
+                return true;
+            }
+        }
+        WAITUI_VECTOR_FOREACH(waitui_ast_formal, parameter,
+                              waitui_ast_class_getParameters(class->class)) {
+            if (STR_EQUALS(
+                        &waitui_ast_formal_getIdentifier(parameter)->identifier,
+                        name)) {
+                *type = waitui_type_checker_resolveType(
+                        this, waitui_ast_formal_getType(parameter));
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Find the type of the variable with the name, locals hide fields.
+ * @param[in,out] this The Type checker
+ * @param[in] name The name of the variable
+ * @param[out] type The type of the variable
+ * @return true if there is a variable with the name
+ */
+static bool waitui_type_checker_findVariable(waitui_type_checker *this,
+                                             const str *name,
+                                             const waitui_type **type) {
+    if (waitui_type_checker_findLocal(this, name, type) ||
+        waitui_type_checker_findField(this, name, type)) {
+        return true;
+    }
+
+    waitui_type_checker_error(this, "unknown identifier '%.*s'", STR_FMT(name));
+    return false;
+}
+
+/**
+ * @brief Find the function with the name in the class or its super classes.
+ * @param[in] class The type of the class
+ * @param[in] name The name of the function
+ * @return The function or NULL if the class has no function with the name
+ */
+static waitui_ast_function *waitui_type_findFunction(const waitui_type *class,
+                                                     const str *name) {
+    for (; class; class = class->superType) {
+        WAITUI_VECTOR_FOREACH(waitui_ast_function, function,
+                              waitui_ast_class_getFunctions(class->class)) {
+            if (STR_EQUALS(
+                        &waitui_ast_function_getFunctionName(function)
+                                 ->identifier,
+                        name)) {
+                return function;
+            }
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Check the arguments against the parameters they are passed to.
+ * @param[in,out] this The Type checker
+ * @param[in] args The arguments of the call
+ * @param[in] parameters The parameters of the called function or class
+ * @param[in] name The name of the called function or class
+ */
+static void waitui_type_checker_checkArgs(waitui_type_checker *this,
+                                          waitui_ast_expression_vector *args,
+                                          waitui_ast_formal_vector *parameters,
+                                          const str *name) {
+    unsigned long int argCount = waitui_ast_expression_vector_getLength(args);
+    unsigned long int parameterCount =
+            waitui_ast_formal_vector_getLength(parameters);
+    unsigned long int i = 0;
+
+    if (argCount != parameterCount) {
+        waitui_type_checker_error(this, "'%.*s' expects %lu arguments but got "
+                                        "%lu",
+                                  STR_FMT(name), parameterCount, argCount);
+    }
+
+    WAITUI_VECTOR_FOREACH(waitui_ast_expression, arg, args) {
+        const waitui_type *type =
+                waitui_type_checker_checkExpression(this, arg);
+
+        if (i < parameterCount) {
+            waitui_ast_formal *parameter =
+                    waitui_ast_formal_vector_get(parameters, i);
+
+            waitui_type_checker_expect(
+                    this, type,
+                    waitui_type_checker_resolveType(
+                            this, waitui_ast_formal_getType(parameter)),
+                    "parameter",
+                    &waitui_ast_formal_getIdentifier(parameter)->identifier);
+        }
+        i++;
+    }
+}
+
+/**
+ * @brief Return the type of the binary operator on the operand types.
+ * @param[in,out] this The Type checker
+ * @param[in] binaryOperator The binary operator
+ * @param[in] left The type of the left operand, may be NULL
+ * @param[in] right The type of the right operand, may be NULL
+ * @return The type of the operation or NULL if it fails
+ * @note The rules are the ones the VM applies at runtime, an Int and a
+ *       Decimal give a Decimal.
+ */
+static const waitui_type *
+waitui_type_checker_binaryType(waitui_type_checker *this,
+                               waitui_ast_binary_operator binaryOperator,
+                               const waitui_type *left,
+                               const waitui_type *right) {
+    bool numbers = false;
+
+    if (!left || !right) { return NULL; }
+
+    numbers = WAITUI_TYPE_IS_NUMBER(left) && WAITUI_TYPE_IS_NUMBER(right);
+
+    switch (binaryOperator) {
+        case WAITUI_AST_BINARY_OPERATOR_PLUS:
+        case WAITUI_AST_BINARY_OPERATOR_MINUS:
+        case WAITUI_AST_BINARY_OPERATOR_TIMES:
+        case WAITUI_AST_BINARY_OPERATOR_DIV:
+            if (left == &waitui_type_integer && right == &waitui_type_integer) {
+                return &waitui_type_integer;
+            }
+            if (numbers) { return &waitui_type_decimal; }
+            break;
+        case WAITUI_AST_BINARY_OPERATOR_MODULO:
+            if (left == &waitui_type_integer && right == &waitui_type_integer) {
+                return &waitui_type_integer;
+            }
+            break;
+        case WAITUI_AST_BINARY_OPERATOR_AND:
+        case WAITUI_AST_BINARY_OPERATOR_CARET:
+        case WAITUI_AST_BINARY_OPERATOR_PIPE:
+            if (left == right && (left == &waitui_type_integer ||
+                                  left == &waitui_type_boolean)) {
+                return left;
+            }
+            break;
+        case WAITUI_AST_BINARY_OPERATOR_TILDE:
+            if (left == &waitui_type_string && right == &waitui_type_string) {
+                return &waitui_type_string;
+            }
+            break;
+        case WAITUI_AST_BINARY_OPERATOR_LESS:
+        case WAITUI_AST_BINARY_OPERATOR_LESS_EQUAL:
+        case WAITUI_AST_BINARY_OPERATOR_GREATER:
+        case WAITUI_AST_BINARY_OPERATOR_GREATER_EQUAL:
+            if (numbers) { return &waitui_type_boolean; }
+            break;
+        case WAITUI_AST_BINARY_OPERATOR_EQUAL:
+        case WAITUI_AST_BINARY_OPERATOR_NOT_EQUAL:
+            return &waitui_type_boolean;
+        case WAITUI_AST_BINARY_OPERATOR_DOUBLE_AND:
+        case WAITUI_AST_BINARY_OPERATOR_DOUBLE_PIPE:
+            if (left == &waitui_type_boolean && right == &waitui_type_boolean) {
+                return &waitui_type_boolean;
+            }
+            break;
+        default:
+            return waitui_type_checker_error(this, "unknown binary operator");
+    }
+
+    return waitui_type_checker_error(this, "binary operator can not be "
+                                           "applied to '%.*s' and '%.*s'",
+                                     STR_FMT(&left->name),
+                                     STR_FMT(&right->name));
+}
+
+/**
+ * @brief Return the binary operator of the compound assignment operator.
+ * @param[in] assignmentOperator The assignment operator
+ * @return The binary operator or WAITUI_AST_BINARY_OPERATOR_UNDEFINED for the
+ *         plain assignment
+ */
+static waitui_ast_binary_operator waitui_type_getAssignmentOperator(
+        waitui_ast_assignment_operator assignmentOperator) {
+    switch (assignmentOperator) {
+        case WAITUI_AST_ASSIGNMENT_OPERATOR_PLUS_EQUAL:
+            return WAITUI_AST_BINARY_OPERATOR_PLUS;
+        case WAITUI_AST_ASSIGNMENT_OPERATOR_MINUS_EQUAL:
+            return WAITUI_AST_BINARY_OPERATOR_MINUS;
+        case WAITUI_AST_ASSIGNMENT_OPERATOR_TIMES_EQUAL:
+            return WAITUI_AST_BINARY_OPERATOR_TIMES;
+        case WAITUI_AST_ASSIGNMENT_OPERATOR_DIV_EQUAL:
+            return WAITUI_AST_BINARY_OPERATOR_DIV;
+        case WAITUI_AST_ASSIGNMENT_OPERATOR_MODULO_EQUAL:
+            return WAITUI_AST_BINARY_OPERATOR_MODULO;
+        case WAITUI_AST_ASSIGNMENT_OPERATOR_AND_EQUAL:
+            return WAITUI_AST_BINARY_OPERATOR_AND;
+        case WAITUI_AST_ASSIGNMENT_OPERATOR_CARET_EQUAL:
+            return WAITUI_AST_BINARY_OPERATOR_CARET;
+        case WAITUI_AST_ASSIGNMENT_OPERATOR_TILDE_EQUAL:
+            return WAITUI_AST_BINARY_OPERATOR_TILDE;
+        case WAITUI_AST_ASSIGNMENT_OPERATOR_PIPE_EQUAL:
+            return WAITUI_AST_BINARY_OPERATOR_PIPE;
+        default:
+            return WAITUI_AST_BINARY_OPERATOR_UNDEFINED;
+    }
+}
+
+/**
+ * @brief Check the assignment, its type is the type of the variable.
+ */
+static const waitui_type *
+waitui_type_checker_checkAssignment(waitui_type_checker *this,
+                                    waitui_ast_assignment *assignment) {
+    const str *name =
+            &waitui_ast_assignment_getIdentifier(assignment)->identifier;
+    waitui_ast_binary_operator binaryOperator =
+            waitui_type_getAssignmentOperator(
+                    waitui_ast_assignment_getOperator(assignment));
+    const waitui_type *value = waitui_type_checker_checkExpression(
+            this, waitui_ast_assignment_getValue(assignment));
+    const waitui_type *type = NULL;
+
+    if (!waitui_type_checker_findVariable(this, name, &type)) { return NULL; }
+
+    if (binaryOperator != WAITUI_AST_BINARY_OPERATOR_UNDEFINED) {
+        value = waitui_type_checker_binaryType(this, binaryOperator, type,
+                                               value);
+    }
+    waitui_type_checker_expect(this, value, type, "variable", name);
+
+    return type;
+}
+
+/**
+ * @brief Check the cast, only casts between related types can succeed.
+ */
+static const waitui_type *
+waitui_type_checker_checkCast(waitui_type_checker *this,
+                              waitui_ast_cast *cast) {
+    const waitui_type *object = waitui_type_checker_checkExpression(
+            this, waitui_ast_cast_getObject(cast));
+    const waitui_type *type   = waitui_type_checker_resolveType(
+            this, waitui_ast_cast_getType(cast));
+
+    if (object && type && !waitui_type_isAssignable(object, type) &&
+        !waitui_type_isAssignable(type, object)) {
+        waitui_type_checker_error(this, "'%.*s' can not be cast to '%.*s'",
+                                  STR_FMT(&object->name), STR_FMT(&type->name));
+    }
+
+    return type;
+}
+
+/**
+ * @brief Check the let, the bindings are in scope of the following bindings
+ *        and of the body.
+ */
+static const waitui_type *
+waitui_type_checker_checkLet(waitui_type_checker *this, waitui_ast_let *let) {
+    unsigned long int localCount = this->localCount;
+    const waitui_type *type      = NULL;
+
+    WAITUI_VECTOR_FOREACH(waitui_ast_initialization, initialization,
+                          waitui_ast_let_getInitializations(let)) {
+        const str *name =
+                &waitui_ast_initialization_getIdentifier(initialization)
+                         ->identifier;
+        symbol *typeName = waitui_ast_initialization_getType(initialization);
+        const waitui_type *value = waitui_type_checker_checkExpression(
+                this, waitui_ast_initialization_getValue(initialization));
+        const waitui_type *declared =
+                waitui_type_checker_resolveType(this, typeName);
+
+        if (typeName) {
+            waitui_type_checker_expect(this, value, declared, "variable", name);
+        } else {
+            declared = value;
+        }
+
+        waitui_ast_expression_setValueType(
+                (waitui_ast_expression *) initialization, declared);
+        waitui_type_checker_addLocal(this, name, declared);
+    }
+
+    type = waitui_type_checker_checkExpression(this,
+                                               waitui_ast_let_getBody(let));
+
+    this->localCount = localCount;
+
+    return type;
+}
+
+/**
+ * @brief Check the block, its type is the type of the last expression.
+ */
+static const waitui_type *
+waitui_type_checker_checkBlock(waitui_type_checker *this,
+                               waitui_ast_block *block) {
+    const waitui_type *type = &waitui_type_null;
+
+    WAITUI_VECTOR_FOREACH(waitui_ast_expression, expression,
+                          waitui_ast_block_getExpressions(block)) {
+        type = waitui_type_checker_checkExpression(this, expression);
+    }
+
+    return type;
+}
+
+/**
+ * @brief Check the creation of an object of the class.
+ */
+static const waitui_type *waitui_type_checker_checkConstructorCall(
+        waitui_type_checker *this,
+        waitui_ast_constructor_call *constructorCall) {
+    symbol *name = waitui_ast_constructor_call_getName(constructorCall);
+    waitui_type *class =
+            waitui_type_hashtable_lookup(this->classTypes, name->identifier);
+
+    if (!class) {
+        waitui_type_checker_checkArgs(
+                this, waitui_ast_constructor_call_getArgs(constructorCall),
+                NULL, &name->identifier);
+        return waitui_type_checker_error(this, "unknown class '%.*s'",
+                                         STR_FMT(&name->identifier));
+    }
+
+    waitui_type_checker_checkArgs(
+            this, waitui_ast_constructor_call_getArgs(constructorCall),
+            waitui_ast_class_getParameters(class->class), &class->name);
+
+    return class;
+}
+
+/**
+ * @brief Check the call of the function on the class of the object, a call
+ *        without object is a call on this.
+ */
+static const waitui_type *
+waitui_type_checker_checkFunctionCall(waitui_type_checker *this,
+                                      waitui_ast_function_call *functionCall) {
+    const str *name =
+            &waitui_ast_function_call_getFunctionName(functionCall)->identifier;
+    waitui_ast_expression *object =
+            waitui_ast_function_call_getObject(functionCall);
+    waitui_ast_expression_vector *args =
+            waitui_ast_function_call_getArgs(functionCall);
+    const waitui_type *class    = this->classType;
+    waitui_ast_function *function = NULL;
+
+    if (object) { class = waitui_type_checker_checkExpression(this, object); }
+
+    if (class && class->kind == WAITUI_TYPE_KIND_CLASS) {
+        function = waitui_type_findFunction(class, name);
+        if (!function) {
+            waitui_type_checker_error(this, "class '%.*s' has no function "
+                                            "'%.*s'",
+                                      STR_FMT(&class->name), STR_FMT(name));
+        }
+    } else if (class) {
+        waitui_type_checker_error(this, "function '%.*s' called on '%.*s'",
+                                  STR_FMT(name), STR_FMT(&class->name));
+    }
+
+    if (!function) {
+        waitui_type_checker_checkArgs(this, args, NULL, name);
+        return NULL;
+    }
+
+    waitui_type_checker_checkArgs(
+            this, args, waitui_ast_function_getParameters(function), name);
+
+    return waitui_type_checker_resolveType(
+            this, waitui_ast_function_getReturnType(function));
+}
+
+/**
+ * @brief Check the call of the function of the super class.
+ */
+static const waitui_type *waitui_type_checker_checkSuperFunctionCall(
+        waitui_type_checker *this,
+        waitui_ast_super_function_call *superFunctionCall) {
+    const str *name =
+            &waitui_ast_super_function_call_getFunctionName(superFunctionCall)
+                     ->identifier;
+    waitui_ast_expression_vector *args =
+            waitui_ast_super_function_call_getArgs(superFunctionCall);
+    waitui_ast_function *function =
+            waitui_type_findFunction(this->classType->superType, name);
+
+    if (!function) {
+        waitui_type_checker_checkArgs(this, args, NULL, name);
+        return waitui_type_checker_error(this, "unknown super function "
+                                               "'%.*s'",
+                                         STR_FMT(name));
+    }
+
+    waitui_type_checker_checkArgs(
+            this, args, waitui_ast_function_getParameters(function), name);
+
+    return waitui_type_checker_resolveType(
+            this, waitui_ast_function_getReturnType(function));
+}
+
+/**
+ * @brief Check the unary expression, ++ and -- change a variable.
+ */
+static const waitui_type *waitui_type_checker_checkUnaryExpression(
+        waitui_type_checker *this, waitui_ast_unary_expression *expression) {
+    waitui_ast_expression *operand =
+            waitui_ast_unary_expression_getExpression(expression);
+    const waitui_type *type =
+            waitui_type_checker_checkExpression(this, operand);
+
+    if (!type) { return NULL; }
+
+    switch (waitui_ast_unary_expression_getOperator(expression)) {
+        case WAITUI_AST_UNARY_OPERATOR_NOT:
+            if (type == &waitui_type_boolean) { return type; }
+            break;
+        case WAITUI_AST_UNARY_OPERATOR_DOUBLE_PLUS:
+        case WAITUI_AST_UNARY_OPERATOR_DOUBLE_MINUS:
+            if (waitui_ast_expression_getExpressionType(operand) !=
+                WAITUI_AST_EXPRESSION_TYPE_REFERENCE) {
+                return waitui_type_checker_error(this, "operand of ++ and -- "
+                                                       "has to be a variable");
+            }
+            // fall through
+        case WAITUI_AST_UNARY_OPERATOR_MINUS:
+            if (WAITUI_TYPE_IS_NUMBER(type)) { return type; }
+            break;
+        default:
+            return waitui_type_checker_error(this, "unknown unary operator");
+    }
+
+    return waitui_type_checker_error(this, "unary operator can not be applied "
+                                           "to '%.*s'",
+                                     STR_FMT(&type->name));
+}
+
+/**
+ * @brief Report an error if the type of the condition is not Bool.
+ * @param[in,out] this The Type checker
+ * @param[in] condition The condition to check
+ */
+static void
+waitui_type_checker_checkCondition(waitui_type_checker *this,
+                                   waitui_ast_expression *condition) {
+    const waitui_type *type =
+            waitui_type_checker_checkExpression(this, condition);
+
+    if (type && type != &waitui_type_boolean) {
+        waitui_type_checker_error(this, "condition has the type '%.*s' "
+                                        "instead of 'Bool'",
+                                  STR_FMT(&type->name));
+    }
+}
+
+/**
+ * @brief Check the if else, a missing else branch has the type Null.
+ */
+static const waitui_type *
+waitui_type_checker_checkIfElse(waitui_type_checker *this,
+                                waitui_ast_if_else *ifElse) {
+    const waitui_type *thenType = NULL;
+    const waitui_type *elseType = NULL;
+
+    waitui_type_checker_checkCondition(this,
+                                       waitui_ast_if_else_getCondition(ifElse));
+    thenType = waitui_type_checker_checkExpression(
+            this, waitui_ast_if_else_getThenBranch(ifElse));
+    elseType = waitui_type_checker_checkExpression(
+            this, waitui_ast_if_else_getElseBranch(ifElse));
+
+    return waitui_type_checker_join(this, thenType, elseType);
+}
+
+/**
+ * @brief Check the while, its type is Null.
+ */
+static const waitui_type *
+waitui_type_checker_checkWhile(waitui_type_checker *this,
+                               waitui_ast_while *loop) {
+    waitui_type_checker_checkCondition(this,
+                                       waitui_ast_while_getCondition(loop));
+    waitui_type_checker_checkExpression(this, waitui_ast_while_getBody(loop));
+
+    return &waitui_type_null;
+}
+
+/**
+ * @brief Resolve the type of the expression and store it in the expression.
+ * @param[in,out] this The Type checker
+ * @param[in,out] expression The expression to check, may be NULL
+ * @return The type of the expression or NULL if it is unknown
+ * @note A missing expression has the type Null.
+ */
+static const waitui_type *
+waitui_type_checker_checkExpression(waitui_type_checker *this,
+                                    waitui_ast_expression *expression) {
+    const waitui_type *type = NULL;
+
+    if (!expression) { return &waitui_type_null; }
+    if (this->failed) { return NULL; }
+
+    if (this->depth == WAITUI_TYPE_CHECKER_MAX_DEPTH) {
+        if (this->tooDeep) { return NULL; }
+        this->tooDeep = true;
+        return waitui_type_checker_error(this, "expression is nested too "
+                                               "deeply");
+    }
+    this->depth++;
+
+    switch (waitui_ast_expression_getExpressionType(expression)) {
+        case WAITUI_AST_EXPRESSION_TYPE_INTEGER_LITERAL:
+            type = &waitui_type_integer;
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_BOOLEAN_LITERAL:
+            type = &waitui_type_boolean;
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_DECIMAL_LITERAL:
+            type = &waitui_type_decimal;
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_NULL_LITERAL:
+            type = &waitui_type_null;
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_STRING_LITERAL:
+            type = &waitui_type_string;
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_THIS_LITERAL:
+            type = this->classType;
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_ASSIGNMENT:
+            type = waitui_type_checker_checkAssignment(
+                    this, (waitui_ast_assignment *) expression);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_REFERENCE:
+            waitui_type_checker_findVariable(
+                    this,
+                    &waitui_ast_reference_getValue(
+                             (waitui_ast_reference *) expression)
+                             ->identifier,
+                    &type);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_CAST:
+            type = waitui_type_checker_checkCast(
+                    this, (waitui_ast_cast *) expression);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_LET:
+            type = waitui_type_checker_checkLet(this,
+                                                (waitui_ast_let *) expression);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_BLOCK:
+            type = waitui_type_checker_checkBlock(
+                    this, (waitui_ast_block *) expression);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_CONSTRUCTOR_CALL:
+            type = waitui_type_checker_checkConstructorCall(
+                    this, (waitui_ast_constructor_call *) expression);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_FUNCTION_CALL:
+            type = waitui_type_checker_checkFunctionCall(
+                    this, (waitui_ast_function_call *) expression);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_SUPER_FUNCTION_CALL:
+            type = waitui_type_checker_checkSuperFunctionCall(
+                    this, (waitui_ast_super_function_call *) expression);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_BINARY_EXPRESSION:
+            type = waitui_type_checker_binaryType(
+                    this,
+                    waitui_ast_binary_expression_getOperator(
+                            (waitui_ast_binary_expression *) expression),
+                    waitui_type_checker_checkExpression(
+                            this, waitui_ast_binary_expression_getLeft(
+                                          (waitui_ast_binary_expression *)
+                                                  expression)),
+                    waitui_type_checker_checkExpression(
+                            this, waitui_ast_binary_expression_getRight(
+                                          (waitui_ast_binary_expression *)
+                                                  expression)));
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_UNARY_EXPRESSION:
+            type = waitui_type_checker_checkUnaryExpression(
+                    this, (waitui_ast_unary_expression *) expression);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_IF_ELSE:
+            type = waitui_type_checker_checkIfElse(
+                    this, (waitui_ast_if_else *) expression);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_WHILE:
+            type = waitui_type_checker_checkWhile(
+                    this, (waitui_ast_while *) expression);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_LAZY_EXPRESSION:
+            type = waitui_type_checker_checkExpression(
+                    this, waitui_ast_lazy_expression_getExpression(
+                                  (waitui_ast_lazy_expression *) expression));
+            break;
+        default:
+            break;
+    }
+
+    this->depth--;
+    if (this->depth == 0) { this->tooDeep = false; }
+
+    waitui_ast_expression_setValueType(expression, type);
+
+    return type;
+}
+
+/**
+ * @brief Check the parameters, super class arguments, properties and
+ *        functions of the class.
+ * @param[in,out] this The Type checker
+ * @param[in] classType The type of the class to check
+ */
+static void waitui_type_checker_checkClass(waitui_type_checker *this,
+                                           const waitui_type *classType) {
+    waitui_ast_class *class = classType->class;
+    waitui_ast_expression_vector *superClassArgs =
+            waitui_ast_class_getSuperClassArgs(class);
+
+    this->classType    = classType;
+    this->functionName = NULL;
+    this->localCount   = 0;
+
+    WAITUI_VECTOR_FOREACH(waitui_ast_formal, parameter,
+                          waitui_ast_class_getParameters(class)) {
+        waitui_type_checker_addLocal(
+                this, &waitui_ast_formal_getIdentifier(parameter)->identifier,
+                waitui_type_checker_resolveType(
+                        this, waitui_ast_formal_getType(parameter)));
+    }
+
+    if (classType->superType) {
+        waitui_type_checker_checkArgs(
+                this, superClassArgs,
+                waitui_ast_class_getParameters(classType->superType->class),
+                &classType->superType->name);
+    } else {
+        waitui_type_checker_checkArgs(this, superClassArgs, NULL,
+                                      &classType->name);
+    }
+
+    WAITUI_VECTOR_FOREACH(waitui_ast_property, property,
+                          waitui_ast_class_getProperties(class)) {
+        waitui_ast_expression *value = waitui_ast_property_getValue(property);
+
+        if (value) {
+            waitui_type_checker_expect(
+                    this, waitui_type_checker_checkExpression(this, value),
+                    waitui_type_checker_resolveType(
+                            this, waitui_ast_property_getType(property)),
+                    "property",
+                    &waitui_ast_property_getName(property)->identifier);
+        }
+    }
+
+    WAITUI_VECTOR_FOREACH(waitui_ast_function, function,
+                          waitui_ast_class_getFunctions(class)) {
+        waitui_ast_expression *body = waitui_ast_function_getBody(function);
+
+        this->functionName =
+                &waitui_ast_function_getFunctionName(function)->identifier;
+        this->localCount = 0;
+
+        WAITUI_VECTOR_FOREACH(waitui_ast_formal, parameter,
+                              waitui_ast_function_getParameters(function)) {
+            waitui_type_checker_addLocal(
+                    this,
+                    &waitui_ast_formal_getIdentifier(parameter)->identifier,
+                    waitui_type_checker_resolveType(
+                            this, waitui_ast_formal_getType(parameter)));
+        }
+
+        if (body) {
+            waitui_type_checker_expect(
+                    this, waitui_type_checker_checkExpression(this, body),
+                    waitui_type_checker_resolveType(
+                            this, waitui_ast_function_getReturnType(function)),
+                    "function", this->functionName);
+        }
+    }
+
+    this->classType    = NULL;
+    this->functionName = NULL;
+}
+
+/**
+ * @brief Create the types of the classes of the module.
+ * @param[in] module The AST of the module to collect the classes of
+ * @param[in,out] args The Type checker
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ */
+static int waitui_type_checker_collectClasses(waitui_ast *module, void *args) {
+    waitui_type_checker *this = args;
+
+    WAITUI_VECTOR_FOREACH(
+            waitui_ast_namespace, namespace,
+            waitui_ast_program_getNamespaces(waitui_ast_getProgram(module))) {
+        WAITUI_VECTOR_FOREACH(waitui_ast_class, class,
+                              waitui_ast_namespace_getClasses(namespace)) {
+            const str *name = &waitui_ast_class_getName(class)->identifier;
+            waitui_type *type = NULL;
+
+            if (waitui_type_hashtable_has(this->classTypes, *name)) {
+                waitui_type_checker_error(this, "class '%.*s' is defined more "
+                                                "than once",
+                                          STR_FMT(name));
+                continue;
+            }
+
+            if (this->typeCount == this->typeCapacity) {
+                unsigned long int capacity =
+                        this->typeCapacity ? this->typeCapacity * 2 : 16;
+                waitui_type **types =
+                        realloc(this->types, capacity * sizeof(*types));
+                if (!types) { return 0; }
+
+                this->types        = types;
+                this->typeCapacity = capacity;
+            }
+
+            type = waitui_arena_alloc(this->arena, sizeof(*type));
+            if (!type ||
+                !waitui_arena_copyStr(this->arena, &type->name, name)) {
+                return 0;
+            }
+            type->kind  = WAITUI_TYPE_KIND_CLASS;
+            type->class = class;
+
+            if (!waitui_type_hashtable_insert(this->classTypes, type->name,
+                                              type)) {
+                return 0;
+            }
+            this->types[this->typeCount++] = type;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Link the types of the classes to the types of their super classes.
+ * @param[in,out] this The Type checker
+ * @note A class that inherits from itself is reported and loses its super
+ *       class, so walking up the super types always ends.
+ */
+static void waitui_type_checker_linkSuperTypes(waitui_type_checker *this) {
+    for (unsigned long int i = 0; i < this->typeCount; ++i) {
+        waitui_type *type = this->types[i];
+        symbol *name      = waitui_ast_class_getSuperClass(type->class);
+
+        if (!name) { continue; }
+
+        type->superType = waitui_type_hashtable_lookup(this->classTypes,
+                                                       name->identifier);
+        if (!type->superType) {
+            waitui_type_checker_error(this, "unknown super class '%.*s' of "
+                                            "class '%.*s'",
+                                      STR_FMT(&name->identifier),
+                                      STR_FMT(&type->name));
+        }
+    }
+
+    for (unsigned long int i = 0; i < this->typeCount; ++i) {
+        const waitui_type *superType = this->types[i]->superType;
+        unsigned long int steps      = 0;
+
+        while (superType && superType != this->types[i] &&
+               steps++ < this->typeCount) {
+            superType = superType->superType;
+        }
+        if (superType) {
+            waitui_type_checker_error(this, "class '%.*s' inherits from "
+                                            "itself",
+                                      STR_FMT(&this->types[i]->name));
+            this->types[i]->superType = NULL;
+        }
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+//  Public functions
+// -----------------------------------------------------------------------------
+
+int waitui_type_checker_check(waitui_ast *ast, str fileName,
+                              unsigned long int *errorCount,
+                              FILE *diagnostics) {
+    waitui_type_checker checker = {0};
+    int result                  = 0;
+
+    if (errorCount) { *errorCount = 0; }
+    if (!ast) { return 0; }
+    if (!diagnostics) { diagnostics = stderr; }
+
+    waitui_log_trace("start type checking the waitui_ast");
+
+    checker.arena       = waitui_ast_getArena(ast);
+    checker.fileName    = fileName;
+    checker.diagnostics = diagnostics;
+    checker.classTypes  = waitui_type_hashtable_new(64);
+    // every module is collected once, even if it is imported many times
+    if (!checker.classTypes ||
+        !waitui_ast_forEachModule(ast, waitui_type_checker_collectClasses,
+                                  &checker)) {
+        fprintf(diagnostics, "ERROR: %.*s: could not allocate memory for the "
+                             "type checker\n",
+                STR_FMT(&fileName));
+        goto done;
+    }
+
+    waitui_type_checker_linkSuperTypes(&checker);
+
+    WAITUI_VECTOR_FOREACH(
+            waitui_ast_namespace, namespace,
+            waitui_ast_program_getNamespaces(waitui_ast_getProgram(ast))) {
+        WAITUI_VECTOR_FOREACH(waitui_ast_class, class,
+                              waitui_ast_namespace_getClasses(namespace)) {
+            const waitui_type *type = waitui_type_hashtable_lookup(
+                    checker.classTypes,
+                    waitui_ast_class_getName(class)->identifier);
+
+            if (type && type->class == class) {
+                waitui_type_checker_checkClass(&checker, type);
+            }
+        }
+    }
+
+    result = !checker.failed;
+    if (!result) {
+        fprintf(diagnostics, "ERROR: %.*s: could not allocate memory for the "
+                             "type checker\n",
+                STR_FMT(&fileName));
+    }
+
+    waitui_log_trace("end type checking the waitui_ast");
+
+done:
+    if (errorCount) { *errorCount = checker.errorCount; }
+
+    waitui_type_hashtable_destroy(&checker.classTypes);
+    free(checker.types);
+    free(checker.locals);
+
+    return result;
+}
+
+bool waitui_type_isAssignable(const waitui_type *from, const waitui_type *to) {
+    if (!from || !to) { return false; }
+    if (from->kind == WAITUI_TYPE_KIND_NULL) { return true; }
+
+    for (; from; from = from->superType) {
+        if (from == to) { return true; }
+    }
+    return false;
+}
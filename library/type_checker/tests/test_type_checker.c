@@ -0,0 +1,367 @@
+/**
+ * @file test_type_checker.c
+ * @author rick
+ * @date 17.10.26
+ * @brief Test for the Type checker implementation
+ */
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <cmocka.h>
+
+#include "waitui/type_checker.h"
+
+#include <waitui/log.h>
+#include <waitui/module_cache.h>
+
+#include <dirent.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+typedef struct output {
+    char *data;
+    size_t size;
+} output;
+
+/**
+ * The module imported by the other modules.
+ */
+static const char shapesSource[] = "namespace org\n"
+                                   "\n"
+                                   "class Shape {\n"
+                                   "    public func area(): Int = 0\n"
+                                   "}\n"
+                                   "\n"
+                                   "class Square(side: Int) extends Shape {\n"
+                                   "    overwrite public func area(): Int =\n"
+                                   "        side * side\n"
+                                   "}\n";
+
+static const char assignSource[] = "namespace org\n"
+                                   "\n"
+                                   "import org.shapes\n"
+                                   "\n"
+                                   "class Assign {\n"
+                                   "    var shape: Shape = new Square(2)\n"
+                                   "    var none: Shape = null\n"
+                                   "\n"
+                                   "    func square(): Square = new Square(3)\n"
+                                   "    func shape(): Shape = this.square()\n"
+                                   "    func area(): Int = shape.area()\n"
+                                   "    func nothing(): Square = null\n"
+                                   "    func wrong(): Square = new Shape()\n"
+                                   "    func number(): Shape = 1\n"
+                                   "}\n";
+
+static const char cycleSource[] = "namespace org\n"
+                                  "\n"
+                                  "class First extends Second {\n"
+                                  "    func value(): Int = this.missing()\n"
+                                  "}\n"
+                                  "\n"
+                                  "class Second extends First {\n"
+                                  "}\n"
+                                  "\n"
+                                  "class Self extends Self {\n"
+                                  "}\n"
+                                  "\n"
+                                  "class Orphan extends Missing {\n"
+                                  "}\n";
+
+static const char duplicateSource[] = "namespace org\n"
+                                      "\n"
+                                      "import org.shapes\n"
+                                      "\n"
+                                      "class Twice {\n"
+                                      "}\n"
+                                      "\n"
+                                      "class Twice {\n"
+                                      "}\n"
+                                      "\n"
+                                      "class Shape {\n"
+                                      "}\n";
+
+static const char leftSource[] = "namespace org\n"
+                                 "\n"
+                                 "import org.shapes\n"
+                                 "\n"
+                                 "class Left extends Square(1) {\n"
+                                 "}\n";
+
+static const char topSource[] = "namespace org\n"
+                                "\n"
+                                "import org.left\n"
+                                "import org.shapes\n"
+                                "\n"
+                                "class Top {\n"
+                                "    func left(): Shape = new Left()\n"
+                                "    func area(): Int = this.left().area()\n"
+                                "    func circle(): Circle = null\n"
+                                "}\n";
+
+static char directory[] = "/tmp/waitui-test_type_checker-XXXXXX";
+
+static parser_module_cache *cache = NULL;
+
+static void get_path(char *path, const char *name) {
+    snprintf(path, 256, "%s/org/%s.wai", directory, name);
+}
+
+static void write_module(const char *name, const char *source) {
+    char path[256];
+    FILE *file = NULL;
+
+    get_path(path, name);
+    file = fopen(path, "w");
+    assert_non_null(file);
+    fputs(source, file);
+    assert_int_equal(fclose(file), 0);
+}
+
+/**
+ * Load the module with a new Module cache, which is destroyed by the next
+ * load, and type check it.
+ */
+static unsigned long int check_module(const char *name, const char *source,
+                                      waitui_ast **ast, output *diagnostics) {
+    char importName[64];
+    char path[256];
+    str searchPath               = {.s = directory, .len = strlen(directory)};
+    str importNameStr            = STR_NULL_INIT;
+    str fileName                 = STR_NULL_INIT;
+    unsigned long int errorCount = 0;
+    FILE *file                   = NULL;
+
+    write_module(name, source);
+
+    parser_module_cache_destroy(&cache);
+    cache = parser_module_cache_new(&searchPath, 1);
+    assert_non_null(cache);
+
+    snprintf(importName, sizeof(importName), "org.%s", name);
+    importNameStr.s   = importName;
+    importNameStr.len = strlen(importName);
+
+    *ast = parser_module_cache_load(cache, importNameStr, stderr);
+    assert_non_null(*ast);
+    assert_int_equal(parser_module_cache_writeDiagnostics(cache, stderr), 0);
+
+    get_path(path, name);
+    fileName.s   = path;
+    fileName.len = strlen(path);
+
+    *diagnostics = (output){0};
+    file         = open_memstream(&diagnostics->data, &diagnostics->size);
+    assert_non_null(file);
+
+    assert_true(waitui_type_checker_check(*ast, fileName, &errorCount, file));
+    fclose(file);
+
+    return errorCount;
+}
+
+/**
+ * Test that the diagnostics hold the error of the module, prefixed with its
+ * path.
+ */
+static void assert_error(const output *diagnostics, const char *name,
+                         const char *error) {
+    char expected[512];
+    char path[256];
+
+    get_path(path, name);
+    snprintf(expected, sizeof(expected), "ERROR: %s: %s\n", path, error);
+
+    assert_non_null(diagnostics->data);
+    assert_non_null(strstr(diagnostics->data, expected));
+}
+
+/**
+ * Return the type of the body of the function of the first class of the AST.
+ */
+static const waitui_type *get_body_type(waitui_ast *ast,
+                                        const char *functionName) {
+    waitui_ast_namespace *namespace = waitui_ast_namespace_vector_get(
+            waitui_ast_program_getNamespaces(waitui_ast_getProgram(ast)), 0);
+    waitui_ast_class *class = waitui_ast_class_vector_get(
+            waitui_ast_namespace_getClasses(namespace), 0);
+
+    WAITUI_VECTOR_FOREACH(waitui_ast_function, function,
+                          waitui_ast_class_getFunctions(class)) {
+        str *name = &waitui_ast_function_getFunctionName(function)->identifier;
+
+        if (name->len == strlen(functionName) &&
+            memcmp(name->s, functionName, name->len) == 0) {
+            return waitui_ast_expression_getValueType(
+                    waitui_ast_function_getBody(function));
+        }
+    }
+
+    fail_msg("unknown function '%s'", functionName);
+    return NULL;
+}
+
+static int setup(void **state) {
+    char path[256];
+    FILE *file = NULL;
+
+    (void) state; /* unused */
+
+    waitui_log_setQuiet(true);
+
+    if (!mkdtemp(directory)) { return -1; }
+    snprintf(path, sizeof(path), "%s/org", directory);
+    if (mkdir(path, 0700) != 0) { return -1; }
+
+    get_path(path, "shapes");
+    file = fopen(path, "w");
+    if (!file) { return -1; }
+    fputs(shapesSource, file);
+
+    return fclose(file) == 0 ? 0 : -1;
+}
+
+static int teardown(void **state) {
+    char path[256];
+    DIR *dir             = NULL;
+    struct dirent *child = NULL;
+
+    (void) state; /* unused */
+
+    parser_module_cache_destroy(&cache);
+
+    snprintf(path, sizeof(path), "%s/org", directory);
+    dir = opendir(path);
+    if (dir) {
+        while ((child = readdir(dir))) {
+            char childPath[512];
+
+            if (child->d_name[0] == '.') { continue; }
+            snprintf(childPath, sizeof(childPath), "%s/%s", path,
+                     child->d_name);
+            unlink(childPath);
+        }
+        closedir(dir);
+    }
+    rmdir(path);
+    rmdir(directory);
+
+    return 0;
+}
+
+static void test_type_checker_assignable(void **state) {
+    (void) state; /* unused */
+
+    waitui_ast *ast            = NULL;
+    output diagnostics         = {0};
+    const waitui_type *square  = NULL;
+    const waitui_type *shape   = NULL;
+    const waitui_type *null    = NULL;
+    const waitui_type *integer = NULL;
+
+    assert_int_equal(
+            check_module("assign", assignSource, &ast, &diagnostics), 2);
+    assert_error(&diagnostics, "assign",
+                 "Assign.wrong: function 'wrong' expects 'Square' but got "
+                 "'Shape'");
+    assert_error(&diagnostics, "assign",
+                 "Assign.number: function 'number' expects 'Shape' but got "
+                 "'Int'");
+    free(diagnostics.data);
+
+    square  = get_body_type(ast, "square");
+    shape   = get_body_type(ast, "wrong");
+    null    = get_body_type(ast, "nothing");
+    integer = get_body_type(ast, "number");
+    assert_non_null(square);
+    assert_non_null(shape);
+    assert_non_null(null);
+    assert_non_null(integer);
+    assert_int_equal(square->kind, WAITUI_TYPE_KIND_CLASS);
+    assert_ptr_equal(square->superType, shape);
+    assert_ptr_equal(get_body_type(ast, "shape"), square);
+
+    // a sub class is assignable to its super class but not the other way
+    assert_true(waitui_type_isAssignable(square, shape));
+    assert_true(waitui_type_isAssignable(square, square));
+    assert_false(waitui_type_isAssignable(shape, square));
+
+    // null is assignable to every type, but nothing to null
+    assert_int_equal(null->kind, WAITUI_TYPE_KIND_NULL);
+    assert_true(waitui_type_isAssignable(null, square));
+    assert_true(waitui_type_isAssignable(null, integer));
+    assert_false(waitui_type_isAssignable(square, null));
+
+    assert_false(waitui_type_isAssignable(integer, shape));
+    assert_false(waitui_type_isAssignable(NULL, shape));
+    assert_false(waitui_type_isAssignable(square, NULL));
+}
+
+static void test_type_checker_super_class_cycle(void **state) {
+    (void) state; /* unused */
+
+    waitui_ast *ast    = NULL;
+    output diagnostics = {0};
+
+    // breaking the cycle at First ends it for Second as well, the lookup of
+    // the function does not loop forever
+    assert_int_equal(check_module("cycle", cycleSource, &ast, &diagnostics),
+                     4);
+    assert_error(&diagnostics, "cycle", "class 'First' inherits from itself");
+    assert_error(&diagnostics, "cycle", "class 'Self' inherits from itself");
+    assert_error(&diagnostics, "cycle",
+                 "unknown super class 'Missing' of class 'Orphan'");
+    assert_error(&diagnostics, "cycle",
+                 "First.value: class 'First' has no function 'missing'");
+    free(diagnostics.data);
+}
+
+static void test_type_checker_duplicate_class(void **state) {
+    (void) state; /* unused */
+
+    waitui_ast *ast    = NULL;
+    output diagnostics = {0};
+
+    assert_int_equal(
+            check_module("duplicate", duplicateSource, &ast, &diagnostics), 2);
+    assert_error(&diagnostics, "duplicate",
+                 "class 'Twice' is defined more than once");
+    assert_error(&diagnostics, "duplicate",
+                 "class 'Shape' is defined more than once");
+    free(diagnostics.data);
+}
+
+static void test_type_checker_imported_class(void **state) {
+    (void) state; /* unused */
+
+    waitui_ast *ast    = NULL;
+    output diagnostics = {0};
+
+    write_module("left", leftSource);
+
+    // the shapes are imported twice but are only defined once
+    assert_int_equal(check_module("top", topSource, &ast, &diagnostics), 1);
+    assert_error(&diagnostics, "top", "Top.circle: unknown type 'Circle'");
+    free(diagnostics.data);
+
+    assert_non_null(get_body_type(ast, "left"));
+    assert_int_equal(get_body_type(ast, "area")->kind,
+                     WAITUI_TYPE_KIND_INTEGER);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test(test_type_checker_assignable),
+            cmocka_unit_test(test_type_checker_super_class_cycle),
+            cmocka_unit_test(test_type_checker_duplicate_class),
+            cmocka_unit_test(test_type_checker_imported_class),
+    };
+
+    return cmocka_run_group_tests(tests, setup, teardown);
+}
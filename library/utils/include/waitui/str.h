@@ -39,6 +39,10 @@ typedef struct str {
     (((_pstr_) != (str *) 0) ? (int) (_pstr_)->len : 0),                       \
             (((_pstr_) != (str *) 0) ? (_pstr_)->s : "")
 
+#define STR_EQUALS(_pstr1_, _pstr2_)                                           \
+    ((_pstr1_)->len == (_pstr2_)->len &&                                       \
+     memcmp((_pstr1_)->s, (_pstr2_)->s, (_pstr1_)->len) == 0)
+
 #define STR_STATIC_SET(_pstr_, _str_)                                          \
     do {                                                                       \
         if ((_pstr_)) {                                                        \
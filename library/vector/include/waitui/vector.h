@@ -0,0 +1,361 @@
+/**
+ * @file vector.h
+ * @author rick
+ * @date 17.10.26
+ * @brief File for the Vector implementation
+ */
+
+#ifndef WAITUI_VECTOR_H
+#define WAITUI_VECTOR_H
+
+#include <waitui/arena.h>
+
+#include <stdbool.h>
+
+
+// -----------------------------------------------------------------------------
+//  Public types
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Type for element destroy function.
+ */
+typedef void (*waitui_vector_element_destroy)(void **element);
+
+/**
+ * @brief Type representing a Vector.
+ * @note The elements of a Vector are kept in one contiguous buffer, the first
+ *       few of them inside of the Vector itself, so short Vectors need no
+ *       allocation besides the Vector.
+ */
+typedef struct waitui_vector waitui_vector;
+
+/**
+ * @brief Type representing a Vector iterator.
+ * @note The iterator is a plain value, so it can live on the stack, see
+ *       waitui_vector_iterate.
+ */
+typedef struct waitui_vector_iter {
+    waitui_vector *vector;
+    unsigned long int index;
+} waitui_vector_iter;
+
+
+// -----------------------------------------------------------------------------
+//  Public defines
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The number of elements kept inside of the Vector itself.
+ */
+#define WAITUI_VECTOR_INLINE_CAPACITY 4
+
+#define INTERFACE_VECTOR_TYPEDEF(type)                                         \
+    typedef waitui_vector type##_vector;                                       \
+    typedef waitui_vector_iter type##_vector_iter
+
+#define IMPLEMENTATION_VECTOR_TYPEDEF(type)
+
+#define INTERFACE_VECTOR_NEW(type) extern type##_vector *type##_vector_new()
+#define IMPLEMENTATION_VECTOR_NEW(type)                                        \
+    type##_vector *type##_vector_new() {                                       \
+        return (type##_vector *) waitui_vector_new(                            \
+                (waitui_vector_element_destroy) type##_destroy);               \
+    }
+
+#define INTERFACE_VECTOR_NEW_IN_ARENA(type)                                    \
+    extern type##_vector *type##_vector_newInArena(waitui_arena *arena)
+#define IMPLEMENTATION_VECTOR_NEW_IN_ARENA(type)                               \
+    type##_vector *type##_vector_newInArena(waitui_arena *arena) {             \
+        return (type##_vector *) waitui_vector_newInArena(arena);              \
+    }
+
+#define INTERFACE_VECTOR_DESTROY(type)                                         \
+    extern void type##_vector_destroy(type##_vector **this)
+#define IMPLEMENTATION_VECTOR_DESTROY(type)                                    \
+    void type##_vector_destroy(type##_vector **this) {                         \
+        waitui_vector_destroy((waitui_vector **) this);                        \
+    }
+
+#define INTERFACE_VECTOR_PUSH(type)                                            \
+    extern int type##_vector_push(type##_vector *this, type *type##element)
+#define IMPLEMENTATION_VECTOR_PUSH(type)                                       \
+    int type##_vector_push(type##_vector *this, type *type##element) {         \
+        return waitui_vector_push((waitui_vector *) this,                      \
+                                  (void *) type##element);                     \
+    }
+
+#define INTERFACE_VECTOR_POP(type)                                             \
+    extern type *type##_vector_pop(type##_vector *this)
+#define IMPLEMENTATION_VECTOR_POP(type)                                        \
+    type *type##_vector_pop(type##_vector *this) {                             \
+        return (type *) waitui_vector_pop((waitui_vector *) this);             \
+    }
+
+#define INTERFACE_VECTOR_UNSHIFT(type)                                         \
+    extern int type##_vector_unshift(type##_vector *this, type *type##element)
+#define IMPLEMENTATION_VECTOR_UNSHIFT(type)                                    \
+    int type##_vector_unshift(type##_vector *this, type *type##element) {      \
+        return waitui_vector_unshift((waitui_vector *) this,                   \
+                                     (void *) type##element);                  \
+    }
+
+#define INTERFACE_VECTOR_SHIFT(type)                                           \
+    extern type *type##_vector_shift(type##_vector *this)
+#define IMPLEMENTATION_VECTOR_SHIFT(type)                                      \
+    type *type##_vector_shift(type##_vector *this) {                           \
+        return (type *) waitui_vector_shift((waitui_vector *) this);           \
+    }
+
+#define INTERFACE_VECTOR_PEEK(type)                                            \
+    extern type *type##_vector_peek(type##_vector *this)
+#define IMPLEMENTATION_VECTOR_PEEK(type)                                       \
+    type *type##_vector_peek(type##_vector *this) {                            \
+        return (type *) waitui_vector_peek((waitui_vector *) this);            \
+    }
+
+#define INTERFACE_VECTOR_GET_LENGTH(type)                                      \
+    extern unsigned long int type##_vector_getLength(type##_vector *this)
+#define IMPLEMENTATION_VECTOR_GET_LENGTH(type)                                 \
+    unsigned long int type##_vector_getLength(type##_vector *this) {           \
+        return waitui_vector_getLength((waitui_vector *) this);                \
+    }
+
+#define INTERFACE_VECTOR_GET(type)                                             \
+    extern type *type##_vector_get(type##_vector *this, unsigned long int index)
+#define IMPLEMENTATION_VECTOR_GET(type)                                        \
+    type *type##_vector_get(type##_vector *this, unsigned long int index) {    \
+        return (type *) waitui_vector_get((waitui_vector *) this, index);      \
+    }
+
+#define INTERFACE_VECTOR_SET(type)                                             \
+    extern int type##_vector_set(type##_vector *this, unsigned long int index, \
+                                 type *type##element)
+#define IMPLEMENTATION_VECTOR_SET(type)                                        \
+    int type##_vector_set(type##_vector *this, unsigned long int index,        \
+                          type *type##element) {                               \
+        return waitui_vector_set((waitui_vector *) this, index,                \
+                                 type##element);                               \
+    }
+
+#define INTERFACE_VECTOR_GET_ITERATOR(type)                                    \
+    extern type##_vector_iter *type##_vector_getIterator(type##_vector *this)
+#define IMPLEMENTATION_VECTOR_GET_ITERATOR(type)                               \
+    type##_vector_iter *type##_vector_getIterator(type##_vector *this) {       \
+        return (type##_vector_iter *) waitui_vector_getIterator(               \
+                (waitui_vector *) this);                                       \
+    }
+
+#define INTERFACE_VECTOR_ITERATE(type)                                         \
+    extern type##_vector_iter type##_vector_iterate(type##_vector *this)
+#define IMPLEMENTATION_VECTOR_ITERATE(type)                                    \
+    type##_vector_iter type##_vector_iterate(type##_vector *this) {            \
+        return waitui_vector_iterate((waitui_vector *) this);                  \
+    }
+
+#define INTERFACE_VECTOR_ITER_HAS_NEXT(type)                                   \
+    extern bool type##_vector_iter_hasNext(type##_vector_iter *this)
+#define IMPLEMENTATION_VECTOR_ITER_HAS_NEXT(type)                              \
+    bool type##_vector_iter_hasNext(type##_vector_iter *this) {                \
+        return waitui_vector_iter_hasNext((waitui_vector_iter *) this);        \
+    }
+
+#define INTERFACE_VECTOR_ITER_NEXT(type)                                       \
+    extern type *type##_vector_iter_next(type##_vector_iter *this)
+#define IMPLEMENTATION_VECTOR_ITER_NEXT(type)                                  \
+    type *type##_vector_iter_next(type##_vector_iter *this) {                  \
+        return (type *) waitui_vector_iter_next((waitui_vector_iter *) this);  \
+    }
+
+#define INTERFACE_VECTOR_ITER_DESTROY(type)                                    \
+    extern void type##_vector_iter_destroy(type##_vector_iter **this)
+#define IMPLEMENTATION_VECTOR_ITER_DESTROY(type)                               \
+    void type##_vector_iter_destroy(type##_vector_iter **this) {               \
+        waitui_vector_iter_destroy((waitui_vector_iter **) this);              \
+    }
+
+/**
+ * @brief Define for quickly created vector implementations for a value type.
+ * @param[in] kind Whether to create interface vector definition
+ *                 or actual implementation
+ * @param[in] type For what type to create the vector
+ */
+#define CREATE_VECTOR_TYPE(kind, type)                                         \
+    kind##_VECTOR_TYPEDEF(type);                                               \
+    kind##_VECTOR_NEW(type);                                                   \
+    kind##_VECTOR_NEW_IN_ARENA(type);                                          \
+    kind##_VECTOR_DESTROY(type);                                               \
+    kind##_VECTOR_PUSH(type);                                                  \
+    kind##_VECTOR_POP(type);                                                   \
+    kind##_VECTOR_UNSHIFT(type);                                               \
+    kind##_VECTOR_SHIFT(type);                                                 \
+    kind##_VECTOR_PEEK(type);                                                  \
+    kind##_VECTOR_GET_LENGTH(type);                                            \
+    kind##_VECTOR_GET(type);                                                   \
+    kind##_VECTOR_SET(type);                                                   \
+    kind##_VECTOR_GET_ITERATOR(type);                                          \
+    kind##_VECTOR_ITERATE(type);                                               \
+    kind##_VECTOR_ITER_HAS_NEXT(type);                                         \
+    kind##_VECTOR_ITER_NEXT(type);                                             \
+    kind##_VECTOR_ITER_DESTROY(type);
+
+/**
+ * @brief Define for iterating over a vector created with CREATE_VECTOR_TYPE
+ *        without any allocation.
+ * @param[in] type The type the vector was created for
+ * @param[in] element The name of the variable holding the current element
+ * @param[in] elements The vector to iterate over
+ * @note The body is a statement like for a for loop, break and continue work
+ *       as usual. The vector must not be changed while iterating over it.
+ */
+#define WAITUI_VECTOR_FOREACH(type, element, elements)                         \
+    for (type##_vector_iter element##Iter = type##_vector_iterate(elements);   \
+         element##Iter.vector; element##Iter.vector = NULL)                    \
+        for (type *element = NULL;                                             \
+             type##_vector_iter_hasNext(&element##Iter) &&                     \
+             ((element = type##_vector_iter_next(&element##Iter)), true);)
+
+
+// -----------------------------------------------------------------------------
+//  Public functions
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Create a Vector.
+ * @param[in] elementDestroyCallback Function to call for element destruction
+ * @return A pointer to waitui_vector or NULL if memory allocation failed
+ */
+extern waitui_vector *
+waitui_vector_new(waitui_vector_element_destroy elementDestroyCallback);
+
+/**
+ * @brief Create a Vector with its buffer allocated from the Arena.
+ * @param[in,out] arena The Arena to allocate the Vector and its buffer from
+ * @return A pointer to waitui_vector or NULL if memory allocation failed
+ * @note The elements are not owned by the Vector, they have to live at least
+ *       as long as the Arena. A buffer outgrown stays in the Arena until the
+ *       Arena is destroyed.
+ */
+extern waitui_vector *waitui_vector_newInArena(waitui_arena *arena);
+
+/**
+ * @brief Destroy a Vector.
+ * @param[in,out] this The Vector to destroy
+ * @note This will free call for every element the elementDestroyCallback
+ * @note For a Vector created with waitui_vector_newInArena this will only
+ *       reset the pointer, the memory is released together with the Arena.
+ */
+extern void waitui_vector_destroy(waitui_vector **this);
+
+/**
+ * @brief Add the element to the end of the Vector.
+ * @param[in,out] this The Vector to add the element at the end
+ * @param[in] element The element to add
+ * @note This function does steel the pointer to the element.
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ */
+extern int waitui_vector_push(waitui_vector *this, void *element);
+
+/**
+ * @brief Remove the element from the end of the Vector and return it.
+ * @param[in,out] this The Vector to remove the element from
+ * @note The caller has to destroy element on its own.
+ * @return The element or NULL if waitui_vector is empty
+ */
+extern void *waitui_vector_pop(waitui_vector *this);
+
+/**
+ * @brief Add the element to the beginning of the Vector.
+ * @param[in,out] this The Vector to add the element at the beginning
+ * @param[in] element The element to add
+ * @note This function does steel the pointer to the element.
+ * @note This moves all elements of the Vector.
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ */
+extern int waitui_vector_unshift(waitui_vector *this, void *element);
+
+/**
+ * @brief Remove the element from the beginning of the Vector and return it.
+ * @param[in,out] this The Vector to remove the element from
+ * @note The caller has to destroy element on its own.
+ * @note This moves all elements of the Vector.
+ * @return The element or NULL if waitui_vector is empty
+ */
+extern void *waitui_vector_shift(waitui_vector *this);
+
+/**
+ * @brief Return the element from the beginning of the Vector, without
+ *        removing it.
+ * @param[in] this The Vector to get the first element from
+ * @warning The caller has not to destroy element on its own.
+ * @return The element or NULL if waitui_vector is empty
+ */
+extern void *waitui_vector_peek(waitui_vector *this);
+
+/**
+ * @brief Return the number of elements in the Vector.
+ * @param[in] this The Vector to get the length of
+ * @return The number of elements, 0 for no Vector
+ */
+extern unsigned long int waitui_vector_getLength(waitui_vector *this);
+
+/**
+ * @brief Return the element at the index of the Vector.
+ * @param[in] this The Vector to get the element from
+ * @param[in] index The index of the element
+ * @return The element or NULL if the index is out of range
+ */
+extern void *waitui_vector_get(waitui_vector *this, unsigned long int index);
+
+/**
+ * @brief Replace the element at the index of the Vector.
+ * @param[in,out] this The Vector to replace the element in
+ * @param[in] index The index of the element
+ * @param[in] element The new element
+ * @retval 1 Ok
+ * @retval 0 The index is out of range
+ * @note The replaced element is not destroyed.
+ */
+extern int waitui_vector_set(waitui_vector *this, unsigned long int index,
+                             void *element);
+
+/**
+ * @brief Return the iterator to iterate over the Vector.
+ * @param[in] this The Vector to get the iterator for
+ * @return A pointer to waitui_vector_iter or NULL if memory allocation failed
+ */
+extern waitui_vector_iter *waitui_vector_getIterator(waitui_vector *this);
+
+/**
+ * @brief Return the iterator to iterate over the Vector as a value.
+ * @param[in] this The Vector to get the iterator for
+ * @return The iterator, it needs no allocation and no destroy
+ * @note Use it with waitui_vector_iter_hasNext and waitui_vector_iter_next by
+ *       address, the Vector must not be changed meanwhile.
+ */
+extern waitui_vector_iter waitui_vector_iterate(waitui_vector *this);
+
+/**
+ * @brief Return true if the Vector iterator has a next element.
+ * @param[in] this The Vector iterator to test for next element available
+ * @retval true If the iterator has a next element available
+ * @retval false If the iterator has no next element available
+ */
+extern bool waitui_vector_iter_hasNext(waitui_vector_iter *this);
+
+/**
+ * @brief Return the next element from the Vector iterator.
+ * @param[in] this The Vector iterator to get the next element
+ * @return The element or NULL if no more elements are available
+ */
+extern void *waitui_vector_iter_next(waitui_vector_iter *this);
+
+/**
+ * @brief Destroy a Vector iterator.
+ * @param[in,out] this The Vector iterator to destroy
+ */
+extern void waitui_vector_iter_destroy(waitui_vector_iter **this);
+
+#endif//WAITUI_VECTOR_H
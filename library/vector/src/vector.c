@@ -0,0 +1,223 @@
+/**
+ * @file vector.c
+ * @author rick
+ * @date 17.10.26
+ * @brief File for the Vector implementation
+ */
+
+#include "waitui/vector.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+// -----------------------------------------------------------------------------
+//  Local types
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Struct representing a Vector.
+ * @note The elements point to the inline elements until the Vector outgrows
+ *       them.
+ */
+struct waitui_vector {
+    void **elements;
+    unsigned long int length;
+    unsigned long int capacity;
+    waitui_vector_element_destroy elementDestroyCallback;
+    waitui_arena *arena;
+    void *inlineElements[WAITUI_VECTOR_INLINE_CAPACITY];
+};
+
+
+// -----------------------------------------------------------------------------
+//  Local functions
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Make room for one more element in the Vector.
+ * @param[in,out] this The Vector to make room in
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ */
+static int waitui_vector_reserve(waitui_vector *this) {
+    unsigned long int capacity = this->capacity * 2;
+    void **elements            = NULL;
+
+    if (this->length < this->capacity) { return 1; }
+
+    if (this->arena) {
+        elements = waitui_arena_alloc(this->arena, capacity * sizeof(void *));
+    } else if (this->elements == this->inlineElements) {
+        elements = malloc(capacity * sizeof(void *));
+    } else {
+        elements = realloc(this->elements, capacity * sizeof(void *));
+    }
+    if (!elements) { return 0; }
+
+    if (this->arena || this->elements == this->inlineElements) {
+        memcpy(elements, this->elements, this->length * sizeof(void *));
+    }
+
+    this->elements = elements;
+    this->capacity = capacity;
+
+    return 1;
+}
+
+
+// -----------------------------------------------------------------------------
+//  Public functions
+// -----------------------------------------------------------------------------
+
+waitui_vector *
+waitui_vector_new(waitui_vector_element_destroy elementDestroyCallback) {
+    waitui_vector *this = NULL;
+
+    this = calloc(1, sizeof(*this));
+    if (!this) { return NULL; }
+
+    this->elements               = this->inlineElements;
+    this->capacity               = WAITUI_VECTOR_INLINE_CAPACITY;
+    this->elementDestroyCallback = elementDestroyCallback;
+
+    return this;
+}
+
+waitui_vector *waitui_vector_newInArena(waitui_arena *arena) {
+    waitui_vector *this = NULL;
+
+    this = waitui_arena_alloc(arena, sizeof(*this));
+    if (!this) { return NULL; }
+
+    this->elements = this->inlineElements;
+    this->capacity = WAITUI_VECTOR_INLINE_CAPACITY;
+    this->arena    = arena;
+
+    return this;
+}
+
+void waitui_vector_destroy(waitui_vector **this) {
+    if (!this || !(*this)) { return; }
+
+    if ((*this)->arena) {
+        *this = NULL;
+        return;
+    }
+
+    if ((*this)->elementDestroyCallback) {
+        for (unsigned long int i = 0; i < (*this)->length; ++i) {
+            (*this)->elementDestroyCallback(&(*this)->elements[i]);
+        }
+    }
+
+    if ((*this)->elements != (*this)->inlineElements) {
+        free((*this)->elements);
+    }
+    free(*this);
+    *this = NULL;
+}
+
+int waitui_vector_push(waitui_vector *this, void *element) {
+    if (!this || !element) { return 0; }
+
+    if (!waitui_vector_reserve(this)) { return 0; }
+
+    this->elements[this->length++] = element;
+
+    return 1;
+}
+
+void *waitui_vector_pop(waitui_vector *this) {
+    if (!this || this->length == 0) { return NULL; }
+    return this->elements[--this->length];
+}
+
+int waitui_vector_unshift(waitui_vector *this, void *element) {
+    if (!this || !element) { return 0; }
+
+    if (!waitui_vector_reserve(this)) { return 0; }
+
+    memmove(this->elements + 1, this->elements,
+            this->length * sizeof(*this->elements));
+    this->elements[0] = element;
+    this->length++;
+
+    return 1;
+}
+
+void *waitui_vector_shift(waitui_vector *this) {
+    void *element = NULL;
+
+    if (!this || this->length == 0) { return NULL; }
+
+    element = this->elements[0];
+
+    this->length--;
+    memmove(this->elements, this->elements + 1,
+            this->length * sizeof(*this->elements));
+
+    return element;
+}
+
+void *waitui_vector_peek(waitui_vector *this) {
+    if (!this || this->length == 0) { return NULL; }
+    return this->elements[0];
+}
+
+unsigned long int waitui_vector_getLength(waitui_vector *this) {
+    if (!this) { return 0; }
+    return this->length;
+}
+
+void *waitui_vector_get(waitui_vector *this, unsigned long int index) {
+    if (!this || index >= this->length) { return NULL; }
+    return this->elements[index];
+}
+
+int waitui_vector_set(waitui_vector *this, unsigned long int index,
+                      void *element) {
+    if (!this || index >= this->length) { return 0; }
+
+    this->elements[index] = element;
+
+    return 1;
+}
+
+waitui_vector_iter *waitui_vector_getIterator(waitui_vector *this) {
+    waitui_vector_iter *iter = NULL;
+
+    if (!this) { return NULL; }
+
+    iter = calloc(1, sizeof(*iter));
+    if (!iter) { return NULL; }
+
+    iter->vector = this;
+
+    return iter;
+}
+
+waitui_vector_iter waitui_vector_iterate(waitui_vector *this) {
+    waitui_vector_iter iter = {this, 0};
+
+    return iter;
+}
+
+bool waitui_vector_iter_hasNext(waitui_vector_iter *this) {
+    if (!this || !this->vector) { return false; }
+    return this->index < this->vector->length;
+}
+
+void *waitui_vector_iter_next(waitui_vector_iter *this) {
+    if (!this || !this->vector || this->index >= this->vector->length) {
+        return NULL;
+    }
+    return this->vector->elements[this->index++];
+}
+
+void waitui_vector_iter_destroy(waitui_vector_iter **this) {
+    if (!this || !(*this)) { return; }
+
+    free(*this);
+    *this = NULL;
+}
@@ -0,0 +1,195 @@
+/**
+ * @file test_vector.c
+ * @author rick
+ * @date 17.10.26
+ * @brief Test for the Vector implementation
+ */
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <cmocka.h>
+
+#include "waitui/vector.h"
+
+#include <stdlib.h>
+
+typedef struct value {
+    int i;
+} value;
+
+static int destroyCount = 0;
+
+static value *value_new(int i) {
+    value *this = calloc(1, sizeof(*this));
+    if (!this) { return NULL; }
+
+    this->i = i;
+
+    return this;
+}
+
+static void value_destroy(value **this) {
+    if (!this || !(*this)) { return; }
+
+    destroyCount++;
+
+    free(*this);
+    *this = NULL;
+}
+
+CREATE_VECTOR_TYPE(INTERFACE, value)
+
+CREATE_VECTOR_TYPE(IMPLEMENTATION, value)
+
+/**
+ * Test that the elements of the vector are 0 to length - 1 in order.
+ */
+static void assert_values(value_vector *vector, int length) {
+    assert_int_equal(value_vector_getLength(vector), length);
+    for (int i = 0; i < length; ++i) {
+        assert_int_equal(value_vector_get(vector, i)->i, i);
+    }
+    assert_null(value_vector_get(vector, length));
+}
+
+static void test_vector_inline_to_heap(void **state) {
+    (void) state; /* unused */
+
+    value_vector *vector = value_vector_new();
+    value *last          = NULL;
+
+    assert_non_null(vector);
+    destroyCount = 0;
+
+    for (int i = 0; i < WAITUI_VECTOR_INLINE_CAPACITY; ++i) {
+        assert_true(value_vector_push(vector, value_new(i)));
+    }
+    assert_values(vector, WAITUI_VECTOR_INLINE_CAPACITY);
+
+    // the last element moves the elements from inline to the heap
+    assert_true(value_vector_push(vector,
+                                  value_new(WAITUI_VECTOR_INLINE_CAPACITY)));
+    assert_values(vector, WAITUI_VECTOR_INLINE_CAPACITY + 1);
+
+    // growing the heap again keeps the elements
+    for (int i = WAITUI_VECTOR_INLINE_CAPACITY + 1; i < 100; ++i) {
+        assert_true(value_vector_push(vector, value_new(i)));
+    }
+    assert_values(vector, 100);
+
+    last = value_vector_pop(vector);
+    assert_int_equal(last->i, 99);
+    value_destroy(&last);
+
+    value_vector_destroy(&vector);
+    assert_null(vector);
+    assert_int_equal(destroyCount, 100);
+}
+
+static void test_vector_unshift_to_heap(void **state) {
+    (void) state; /* unused */
+
+    value_vector *vector = value_vector_new();
+    value *first         = NULL;
+
+    assert_non_null(vector);
+    destroyCount = 0;
+
+    for (int i = WAITUI_VECTOR_INLINE_CAPACITY; i >= 0; --i) {
+        assert_true(value_vector_unshift(vector, value_new(i)));
+    }
+    assert_values(vector, WAITUI_VECTOR_INLINE_CAPACITY + 1);
+    assert_int_equal(value_vector_peek(vector)->i, 0);
+
+    first = value_vector_shift(vector);
+    assert_int_equal(first->i, 0);
+    value_destroy(&first);
+    assert_int_equal(value_vector_getLength(vector),
+                     WAITUI_VECTOR_INLINE_CAPACITY);
+    assert_int_equal(value_vector_peek(vector)->i, 1);
+
+    value_vector_destroy(&vector);
+    assert_int_equal(destroyCount, WAITUI_VECTOR_INLINE_CAPACITY + 1);
+}
+
+static void test_vector_arena(void **state) {
+    (void) state; /* unused */
+
+    waitui_arena *arena  = waitui_arena_new();
+    value_vector *vector = NULL;
+    value values[100];
+
+    assert_non_null(arena);
+    vector = value_vector_newInArena(arena);
+    assert_non_null(vector);
+
+    for (int i = 0; i < 100; ++i) {
+        values[i].i = i;
+        assert_true(value_vector_push(vector, &values[i]));
+        assert_ptr_equal(value_vector_get(vector, i), &values[i]);
+    }
+    assert_values(vector, 100);
+    assert_true(value_vector_set(vector, 0, &values[99]));
+    assert_ptr_equal(value_vector_get(vector, 0), &values[99]);
+    assert_false(value_vector_set(vector, 100, &values[0]));
+
+    // the elements are not owned, destroying only forgets the vector
+    destroyCount = 0;
+    value_vector_destroy(&vector);
+    assert_null(vector);
+    assert_int_equal(destroyCount, 0);
+
+    waitui_arena_destroy(&arena);
+}
+
+static void test_vector_foreach(void **state) {
+    (void) state; /* unused */
+
+    value_vector *vector = value_vector_new();
+    value_vector *empty  = value_vector_new();
+    int next             = 0;
+
+    assert_non_null(vector);
+    assert_non_null(empty);
+
+    for (int i = 0; i < 10; ++i) {
+        assert_true(value_vector_push(vector, value_new(i)));
+    }
+
+    WAITUI_VECTOR_FOREACH(value, element, vector) {
+        assert_int_equal(element->i, next++);
+    }
+    assert_int_equal(next, 10);
+
+    // continue and break work like in a for loop
+    next = 0;
+    WAITUI_VECTOR_FOREACH(value, element, vector) {
+        if (element->i % 2) { continue; }
+        if (element->i == 6) { break; }
+        assert_int_equal(element->i, next);
+        next += 2;
+    }
+    assert_int_equal(next, 6);
+
+    // an element of an empty vector would fail the test
+    WAITUI_VECTOR_FOREACH(value, element, empty) { assert_null(element); }
+    WAITUI_VECTOR_FOREACH(value, element, NULL) { assert_null(element); }
+
+    value_vector_destroy(&vector);
+    value_vector_destroy(&empty);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test(test_vector_inline_to_heap),
+            cmocka_unit_test(test_vector_unshift_to_heap),
+            cmocka_unit_test(test_vector_arena),
+            cmocka_unit_test(test_vector_foreach),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,100 @@
+/**
+ * @file vm.h
+ * @author rick
+ * @date 17.10.26
+ * @brief File for the VM implementation
+ */
+
+#ifndef WAITUI_VM_H
+#define WAITUI_VM_H
+
+#include <waitui/str.h>
+#include <waitui/vm_program.h>
+
+#include <stdio.h>
+
+
+// -----------------------------------------------------------------------------
+//  Public defines
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The number of registers of all frames of a VM together.
+ */
+#define WAITUI_VM_STACK_SIZE (64 * 1024)
+
+/**
+ * @brief The maximal call depth of a VM.
+ */
+#define WAITUI_VM_MAX_FRAMES (8 * 1024)
+
+
+// -----------------------------------------------------------------------------
+//  Public types
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Type representing a VM.
+ * @note A VM executes the functions of a VM program. The registers and call
+ *       frames are allocated once with the VM, the instructions themselves
+ *       never allocate except for creating objects, thunks and concatenating
+ *       strings, which live in the heap of the VM until it is destroyed.
+ */
+typedef struct waitui_vm waitui_vm;
+
+
+// -----------------------------------------------------------------------------
+//  Public functions
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Create a VM for the VM program.
+ * @param[in] program The VM program to execute, it has to outlive the VM
+ * @return A pointer to waitui_vm or NULL if memory allocation failed
+ */
+extern waitui_vm *waitui_vm_new(const waitui_vm_program *program);
+
+/**
+ * @brief Destroy the VM and all objects it created.
+ * @param[in,out] this The VM to destroy
+ */
+extern void waitui_vm_destroy(waitui_vm **this);
+
+/**
+ * @brief Create an object of the class and call the function on it.
+ * @param[in,out] this The VM to execute with
+ * @param[in] className The name of the class, it must not have parameters
+ * @param[in] functionName The name of the function, it must not have
+ *                         parameters
+ * @param[out] result The value the function returned
+ * @param[in,out] diagnostics The file to write the errors to, NULL for stderr
+ * @retval 1 Ok
+ * @retval 0 The class or function does not exist or the execution failed,
+ *           the error is written to the diagnostics
+ */
+extern int waitui_vm_run(waitui_vm *this, str className, str functionName,
+                         waitui_vm_value *result, FILE *diagnostics);
+
+/**
+ * @brief Call the function with the arguments.
+ * @param[in,out] this The VM to execute with
+ * @param[in] function The function to call
+ * @param[in] self The value for this
+ * @param[in] args The arguments, as many as the function has parameters
+ * @param[out] result The value the function returned
+ * @param[in,out] diagnostics The file to write the errors to, NULL for stderr
+ * @retval 1 Ok
+ * @retval 0 The execution failed, the error is written to the diagnostics
+ */
+extern int waitui_vm_call(waitui_vm *this, const waitui_vm_function *function,
+                          waitui_vm_value self, const waitui_vm_value *args,
+                          waitui_vm_value *result, FILE *diagnostics);
+
+/**
+ * @brief Print the value to the file.
+ * @param[in] value The value to print
+ * @param[in,out] file The file to print to
+ */
+extern void waitui_vm_value_print(const waitui_vm_value *value, FILE *file);
+
+#endif//WAITUI_VM_H
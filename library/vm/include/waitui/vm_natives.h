@@ -0,0 +1,71 @@
+/**
+ * @file vm_natives.h
+ * @author rick
+ * @date 17.10.26
+ * @brief File for the VM natives implementation
+ */
+
+#ifndef WAITUI_VM_NATIVES_H
+#define WAITUI_VM_NATIVES_H
+
+#include <waitui/str.h>
+#include <waitui/vm_program.h>
+
+
+// -----------------------------------------------------------------------------
+//  Public types
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Type for the C function bound to a native function.
+ * @note The name is qualified with the class, like Console.log.
+ */
+typedef struct waitui_vm_native {
+    str name;
+    unsigned long int parameterCount;
+    waitui_vm_native_function function;
+} waitui_vm_native;
+
+
+// -----------------------------------------------------------------------------
+//  Public functions
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Create an empty table of VM natives.
+ * @return A pointer to waitui_vm_natives or NULL if memory allocation failed
+ */
+extern waitui_vm_natives *waitui_vm_natives_new(void);
+
+/**
+ * @brief Destroy the table of VM natives.
+ * @param[in,out] this The table of VM natives to destroy
+ * @note The VM programs linked against the table do not reference it.
+ */
+extern void waitui_vm_natives_destroy(waitui_vm_natives **this);
+
+/**
+ * @brief Bind the C function to the native function with the qualified name.
+ * @param[in,out] this The table of VM natives to add the binding to
+ * @param[in] name The name of the class and function, like Console.log
+ * @param[in] parameterCount The number of arguments the function takes
+ * @param[in] function The C function to call
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed or the name is bound already
+ */
+extern int waitui_vm_natives_register(waitui_vm_natives *this, str name,
+                                      unsigned long int parameterCount,
+                                      waitui_vm_native_function function);
+
+/**
+ * @brief Return the binding of the native function of the class.
+ * @param[in] this The table of VM natives to search in
+ * @param[in] className The name of the class
+ * @param[in] functionName The name of the function
+ * @return The binding or NULL if the function is not bound
+ */
+extern const waitui_vm_native *
+waitui_vm_natives_lookup(const waitui_vm_natives *this, str className,
+                         str functionName);
+
+#endif//WAITUI_VM_NATIVES_H
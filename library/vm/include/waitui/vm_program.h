@@ -0,0 +1,308 @@
+/**
+ * @file vm_program.h
+ * @author rick
+ * @date 17.10.26
+ * @brief File for the VM program implementation
+ */
+
+#ifndef WAITUI_VM_PROGRAM_H
+#define WAITUI_VM_PROGRAM_H
+
+#include <waitui/arena.h>
+#include <waitui/ast.h>
+#include <waitui/str.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+
+// -----------------------------------------------------------------------------
+//  Public defines
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The opcodes of the VM with their operands.
+ * @note R[x] is register x of the current frame, K[x] constant x of the
+ *       program. Register 0 holds this, the arguments follow in order.
+ */
+#define WAITUI_VM_OPCODES(X)                                                   \
+    X(MOVE)       /* A B     R[A] = R[B]                                 */    \
+    X(LOADK)      /* A Bx    R[A] = K[Bx]                                */    \
+    X(LOADINT)    /* A sBx   R[A] = sBx                                  */    \
+    X(LOADNULL)   /* A       R[A] = null                                 */    \
+    X(LOADBOOL)   /* A B     R[A] = B != 0                               */    \
+    X(GETFIELD)   /* A B C   R[A] = R[B].fields[C]                       */    \
+    X(SETFIELD)   /* A B C   R[A].fields[B] = R[C]                       */    \
+    X(ADD)        /* A B C   R[A] = R[B] + R[C]                          */    \
+    X(SUB)        /* A B C   R[A] = R[B] - R[C]                          */    \
+    X(MUL)        /* A B C   R[A] = R[B] * R[C]                          */    \
+    X(DIV)        /* A B C   R[A] = R[B] / R[C]                          */    \
+    X(MOD)        /* A B C   R[A] = R[B] % R[C]                          */    \
+    X(BAND)       /* A B C   R[A] = R[B] & R[C]                          */    \
+    X(BXOR)       /* A B C   R[A] = R[B] ^ R[C]                          */    \
+    X(BOR)        /* A B C   R[A] = R[B] | R[C]                          */    \
+    X(CONCAT)     /* A B C   R[A] = R[B] ~ R[C]                          */    \
+    X(LT)         /* A B C   R[A] = R[B] < R[C]                          */    \
+    X(LE)         /* A B C   R[A] = R[B] <= R[C]                         */    \
+    X(GT)         /* A B C   R[A] = R[B] > R[C]                          */    \
+    X(GE)         /* A B C   R[A] = R[B] >= R[C]                         */    \
+    X(EQ)         /* A B C   R[A] = R[B] == R[C]                         */    \
+    X(NE)         /* A B C   R[A] = R[B] != R[C]                         */    \
+    X(NEG)        /* A B     R[A] = -R[B]                                */    \
+    X(NOT)        /* A B     R[A] = !R[B]                                */    \
+    X(JMP)        /* sBx     pc += sBx                                   */    \
+    X(JMPIF)      /* A sBx   if R[A] then pc += sBx                      */    \
+    X(JMPIFNOT)   /* A sBx   if !R[A] then pc += sBx                     */    \
+    X(CHECKTYPE)  /* A B     fail unless R[A] is null or of value type B */    \
+    X(CHECKCLASS) /* A Bx    fail unless R[A] is null or of class Bx     */    \
+    X(NEW)        /* A Bx    R[A] = new object of class Bx               */    \
+    X(CALL)       /* A B, W  R[A] = R[A].methods[W](R[A+1], ..., R[A+B]) */    \
+    X(CALLSTATIC) /* A B, W  R[A] = functions[W](R[A+1], ..., R[A+B])    */    \
+    X(RETURN)     /* A       return R[A]                                 */    \
+    X(THUNK)      /* A Bx    R[A] = new thunk of thunks[Bx]              */    \
+    X(FORCE)      /* A       if R[A] is a thunk R[A] = its value         */    \
+    X(NATIVE)     /* A       R[A] = native of the function(R[A], ...)    */
+
+/**
+ * @brief Return the operands of an instruction.
+ * @note An instruction is 32 bits: the opcode in the low byte followed by the
+ *       bytes A, B and C. B and C together form the 16 bit operand Bx, which
+ *       is biased by WAITUI_VM_SBX_BIAS for the signed operand sBx. CALL and
+ *       CALLSTATIC are followed by one extra word W.
+ */
+#define WAITUI_VM_GET_OP(i) ((i) & 0xff)
+#define WAITUI_VM_GET_A(i) (((i) >> 8) & 0xff)
+#define WAITUI_VM_GET_B(i) (((i) >> 16) & 0xff)
+#define WAITUI_VM_GET_C(i) ((i) >> 24)
+#define WAITUI_VM_GET_BX(i) ((i) >> 16)
+#define WAITUI_VM_GET_SBX(i)                                                   \
+    ((int32_t) WAITUI_VM_GET_BX(i) - WAITUI_VM_SBX_BIAS)
+
+/**
+ * @brief Create an instruction from its operands.
+ */
+#define WAITUI_VM_ABC(op, a, b, c)                                             \
+    ((waitui_vm_instruction) (op) | ((waitui_vm_instruction) (a) << 8) |       \
+     ((waitui_vm_instruction) (b) << 16) | ((waitui_vm_instruction) (c) << 24))
+#define WAITUI_VM_ABX(op, a, bx)                                               \
+    ((waitui_vm_instruction) (op) | ((waitui_vm_instruction) (a) << 8) |       \
+     ((waitui_vm_instruction) (bx) << 16))
+#define WAITUI_VM_ASBX(op, a, sbx)                                             \
+    WAITUI_VM_ABX((op), (a), (int32_t) (sbx) + WAITUI_VM_SBX_BIAS)
+
+/**
+ * @brief The limits of the operands of an instruction.
+ */
+#define WAITUI_VM_MAX_A 0xff
+#define WAITUI_VM_MAX_BX 0xffff
+#define WAITUI_VM_SBX_BIAS 0x7fff
+#define WAITUI_VM_MIN_SBX (-WAITUI_VM_SBX_BIAS)
+#define WAITUI_VM_MAX_SBX (WAITUI_VM_MAX_BX - WAITUI_VM_SBX_BIAS)
+
+/**
+ * @brief The maximal number of registers of a function.
+ */
+#define WAITUI_VM_MAX_REGISTERS (WAITUI_VM_MAX_A + 1)
+
+
+// -----------------------------------------------------------------------------
+//  Public types
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The opcodes of the VM.
+ */
+typedef enum waitui_vm_opcode {
+#define WAITUI_VM_OPCODE_ENUM(name) WAITUI_VM_OP_##name,
+    WAITUI_VM_OPCODES(WAITUI_VM_OPCODE_ENUM)
+#undef WAITUI_VM_OPCODE_ENUM
+    WAITUI_VM_OP_COUNT,
+} waitui_vm_opcode;
+
+/**
+ * @brief Type for one instruction of the VM.
+ */
+typedef uint32_t waitui_vm_instruction;
+
+/**
+ * @brief The types of values possible for a VM value.
+ * @note Null is 0, so zeroed memory holds null values.
+ */
+typedef enum waitui_vm_value_type {
+    WAITUI_VM_VALUE_TYPE_NULL,
+    WAITUI_VM_VALUE_TYPE_BOOLEAN,
+    WAITUI_VM_VALUE_TYPE_INTEGER,
+    WAITUI_VM_VALUE_TYPE_DECIMAL,
+    WAITUI_VM_VALUE_TYPE_STRING,
+    WAITUI_VM_VALUE_TYPE_OBJECT,
+    WAITUI_VM_VALUE_TYPE_THUNK,
+} waitui_vm_value_type;
+
+/**
+ * @brief Type representing an object of a VM class.
+ */
+typedef struct waitui_vm_object waitui_vm_object;
+
+/**
+ * @brief Type representing the delayed value of a lazy argument.
+ */
+typedef struct waitui_vm_thunk waitui_vm_thunk;
+
+/**
+ * @brief Type for a VM value.
+ * @note A value is 16 bytes and copied around by value, only strings,
+ *       objects and thunks point to memory. Thunks only live in the
+ *       registers of lazy parameters, every read of such a parameter forces
+ *       them first.
+ */
+typedef struct waitui_vm_value {
+    waitui_vm_value_type type;
+    union {
+        bool boolean;
+        int64_t integer;
+        double decimal;
+        const str *string;
+        waitui_vm_object *object;
+        waitui_vm_thunk *thunk;
+    } as;
+} waitui_vm_value;
+
+/**
+ * @brief Type representing a VM class.
+ */
+typedef struct waitui_vm_class waitui_vm_class;
+
+struct waitui_vm;
+
+/**
+ * @brief Type for the C function implementing a native function.
+ * @param[in,out] vm The VM executing the native function
+ * @param[in,out] registers This followed by the arguments, the value to
+ *                          return goes to the first register
+ * @retval 1 Ok
+ * @retval 0 The native function failed, the error is written to the log
+ * @note The arguments are passed in the registers of the VM, so calling a
+ *       native function neither looks up its name nor copies its arguments.
+ */
+typedef int (*waitui_vm_native_function)(struct waitui_vm *vm,
+                                         waitui_vm_value *registers);
+
+/**
+ * @brief Type representing a table of C functions for native functions.
+ */
+typedef struct waitui_vm_natives waitui_vm_natives;
+
+/**
+ * @brief Type for a function compiled to VM instructions.
+ * @note The frame of a function has registerCount registers, the first one
+ *       holds this and the next parameterCount ones the arguments. The
+ *       lazyParameters tell which arguments are passed as thunks, it is NULL
+ *       if none is. The function of a thunk has the name and class of the
+ *       function it is created in, its parameters are the registers it
+ *       captures from there. The code of a native function only calls the
+ *       native, which is bound when the program is compiled.
+ */
+typedef struct waitui_vm_function {
+    str name;
+    const waitui_vm_class *class;
+    unsigned long int parameterCount;
+    const bool *lazyParameters;
+    waitui_vm_native_function native;
+    unsigned long int registerCount;
+    const waitui_vm_instruction *code;
+    unsigned long int codeLength;
+} waitui_vm_function;
+
+/**
+ * @brief Struct representing a VM class.
+ * @note The fields of the super class come first, followed by the parameters
+ *       of the class and its properties. The methods hold the function for
+ *       every selector of the program, NULL if the class does not understand
+ *       the selector, so a call is a single indexed load.
+ */
+struct waitui_vm_class {
+    str name;
+    unsigned long int index;
+    const waitui_vm_class *superClass;
+    unsigned long int parameterCount;
+    unsigned long int fieldCount;
+    str *fieldNames;
+    const waitui_vm_function *initializer;
+    const waitui_vm_function **methods;
+};
+
+/**
+ * @brief Struct representing an object of a VM class.
+ */
+struct waitui_vm_object {
+    const waitui_vm_class *class;
+    waitui_vm_value fields[];
+};
+
+/**
+ * @brief Type representing a VM program.
+ * @note A VM program holds the classes, functions, thunks, constants and
+ *       selectors of everything reachable from an AST. It is immutable once
+ *       compiled and does not reference the AST anymore.
+ */
+typedef struct waitui_vm_program {
+    waitui_arena *arena;
+    waitui_vm_class *classes;
+    unsigned long int classCount;
+    waitui_vm_function *functions;
+    unsigned long int functionCount;
+    const waitui_vm_function **thunks;
+    unsigned long int thunkCount;
+    waitui_vm_value *constants;
+    unsigned long int constantCount;
+    str *selectors;
+    unsigned long int selectorCount;
+} waitui_vm_program;
+
+
+// -----------------------------------------------------------------------------
+//  Public functions
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Compile the classes of the AST and of the modules it imports.
+ * @param[in] ast The AST to compile
+ * @param[in] natives The C functions for the native functions, may be NULL
+ * @param[in,out] diagnostics The file to write the errors to, NULL for stderr
+ * @return On success a pointer to waitui_vm_program, else NULL
+ * @note Every native function is bound to its C function once while
+ *       compiling, a native function without one is an error.
+ */
+extern waitui_vm_program *
+waitui_vm_program_compile(waitui_ast *ast, const waitui_vm_natives *natives,
+                          FILE *diagnostics);
+
+/**
+ * @brief Destroy the VM program.
+ * @param[in,out] this The VM program to destroy
+ */
+extern void waitui_vm_program_destroy(waitui_vm_program **this);
+
+/**
+ * @brief Return the class with the name from the VM program.
+ * @param[in] this The VM program to search in
+ * @param[in] name The name of the class
+ * @return The class or NULL if the VM program has no class with the name
+ */
+extern const waitui_vm_class *
+waitui_vm_program_getClass(const waitui_vm_program *this, str name);
+
+/**
+ * @brief Return the selector of the function name from the VM program.
+ * @param[in] this The VM program to search in
+ * @param[in] name The name of the function
+ * @param[out] selector The selector of the function name
+ * @retval 1 Ok
+ * @retval 0 No class of the VM program has a function with the name
+ */
+extern int waitui_vm_program_getSelector(const waitui_vm_program *this,
+                                         str name,
+                                         unsigned long int *selector);
+
+#endif//WAITUI_VM_PROGRAM_H
@@ -0,0 +1,900 @@
+/**
+ * @file vm.c
+ * @author rick
+ * @date 17.10.26
+ * @brief File for the VM implementation
+ */
+
+#include "waitui/vm.h"
+
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+// -----------------------------------------------------------------------------
+//  Local defines
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Whether the interpreter dispatches with computed gotos.
+ * @note With computed gotos every instruction jumps straight to the handler
+ *       of the next one, which gives the branch predictor one indirect jump
+ *       per handler instead of a single shared one.
+ */
+#if defined(__GNUC__)
+#define WAITUI_VM_COMPUTED_GOTO 1
+#else
+#define WAITUI_VM_COMPUTED_GOTO 0
+#endif
+
+/**
+ * @brief Fetch the next instruction and jump to its handler.
+ */
+#if WAITUI_VM_COMPUTED_GOTO
+#define WAITUI_VM_DISPATCH()                                                   \
+    do {                                                                       \
+        instruction = *pc++;                                                   \
+        goto *dispatchTable[WAITUI_VM_GET_OP(instruction)];                    \
+    } while (0)
+#define WAITUI_VM_CASE(name) op_##name:
+#else
+#define WAITUI_VM_DISPATCH() goto dispatch
+#define WAITUI_VM_CASE(name) case WAITUI_VM_OP_##name:
+#endif
+
+/**
+ * @brief The operands of the current instruction.
+ */
+#define RA (base[WAITUI_VM_GET_A(instruction)])
+#define RB (base[WAITUI_VM_GET_B(instruction)])
+#define RC (base[WAITUI_VM_GET_C(instruction)])
+
+/**
+ * @brief Stop the execution with the error.
+ */
+#define WAITUI_VM_FAIL(...)                                                    \
+    do {                                                                       \
+        waitui_vm_fail(this, frame->function, stopDepth, __VA_ARGS__);         \
+        return 0;                                                              \
+    } while (0)
+
+/**
+ * @brief Execute the arithmetic operator on two numbers, integers wrap
+ *        around and an integer and a decimal give a decimal.
+ */
+#define WAITUI_VM_ARITHMETIC(operator, name)                                   \
+    do {                                                                       \
+        const waitui_vm_value *b = &RB;                                        \
+        const waitui_vm_value *c = &RC;                                        \
+        if (b->type == WAITUI_VM_VALUE_TYPE_INTEGER &&                         \
+            c->type == WAITUI_VM_VALUE_TYPE_INTEGER) {                         \
+            int64_t value = (int64_t) ((uint64_t) b->as.integer operator(      \
+                    uint64_t) c->as.integer);                                  \
+            RA.type       = WAITUI_VM_VALUE_TYPE_INTEGER;                      \
+            RA.as.integer = value;                                             \
+        } else if (WAITUI_VM_IS_NUMBER(b) && WAITUI_VM_IS_NUMBER(c)) {         \
+            double value  = WAITUI_VM_TO_DECIMAL(b)                            \
+                    operator WAITUI_VM_TO_DECIMAL(c);                          \
+            RA.type       = WAITUI_VM_VALUE_TYPE_DECIMAL;                      \
+            RA.as.decimal = value;                                             \
+        } else {                                                               \
+            WAITUI_VM_FAIL("operands of %s have to be numbers", name);         \
+        }                                                                      \
+    } while (0)
+
+/**
+ * @brief Execute the comparison operator on two numbers.
+ */
+#define WAITUI_VM_COMPARISON(operator, name)                                   \
+    do {                                                                       \
+        const waitui_vm_value *b = &RB;                                        \
+        const waitui_vm_value *c = &RC;                                        \
+        bool value               = false;                                      \
+        if (b->type == WAITUI_VM_VALUE_TYPE_INTEGER &&                         \
+            c->type == WAITUI_VM_VALUE_TYPE_INTEGER) {                         \
+            value = b->as.integer operator c->as.integer;                      \
+        } else if (WAITUI_VM_IS_NUMBER(b) && WAITUI_VM_IS_NUMBER(c)) {         \
+            value = WAITUI_VM_TO_DECIMAL(b) operator WAITUI_VM_TO_DECIMAL(c);  \
+        } else {                                                               \
+            WAITUI_VM_FAIL("operands of %s have to be numbers", name);         \
+        }                                                                      \
+        RA.type       = WAITUI_VM_VALUE_TYPE_BOOLEAN;                          \
+        RA.as.boolean = value;                                                 \
+    } while (0)
+
+/**
+ * @brief Execute the bitwise operator on two integers or the logical one on
+ *        two booleans, both operands are always evaluated.
+ */
+#define WAITUI_VM_BITWISE(operator, name)                                      \
+    do {                                                                       \
+        const waitui_vm_value *b = &RB;                                        \
+        const waitui_vm_value *c = &RC;                                        \
+        if (b->type == WAITUI_VM_VALUE_TYPE_INTEGER &&                         \
+            c->type == WAITUI_VM_VALUE_TYPE_INTEGER) {                         \
+            int64_t value = b->as.integer operator c->as.integer;              \
+            RA.type       = WAITUI_VM_VALUE_TYPE_INTEGER;                      \
+            RA.as.integer = value;                                             \
+        } else if (b->type == WAITUI_VM_VALUE_TYPE_BOOLEAN &&                  \
+                   c->type == WAITUI_VM_VALUE_TYPE_BOOLEAN) {                  \
+            bool value    = b->as.boolean operator c->as.boolean;              \
+            RA.type       = WAITUI_VM_VALUE_TYPE_BOOLEAN;                      \
+            RA.as.boolean = value;                                             \
+        } else {                                                               \
+            WAITUI_VM_FAIL("operands of %s have to be integers or booleans",   \
+                           name);                                              \
+        }                                                                      \
+    } while (0)
+
+/**
+ * @brief Return whether the value is an integer or a decimal.
+ */
+#define WAITUI_VM_IS_NUMBER(value)                                             \
+    ((value)->type == WAITUI_VM_VALUE_TYPE_INTEGER ||                          \
+     (value)->type == WAITUI_VM_VALUE_TYPE_DECIMAL)
+
+/**
+ * @brief Return the number as a decimal.
+ */
+#define WAITUI_VM_TO_DECIMAL(value)                                            \
+    ((value)->type == WAITUI_VM_VALUE_TYPE_INTEGER                             \
+             ? (double) (value)->as.integer                                    \
+             : (value)->as.decimal)
+
+
+// -----------------------------------------------------------------------------
+//  Local types
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Type for the registers a thunk captured from the frame it was
+ *        created in.
+ * @note A context is released once its thunk is forced and reused by the
+ *       next thunk capturing as many registers.
+ */
+typedef struct waitui_vm_context {
+    struct waitui_vm_context *next;
+    waitui_vm_value registers[];
+} waitui_vm_context;
+
+/**
+ * @brief Struct representing the delayed value of a lazy argument.
+ * @note A thunk is evaluated at most once, after that its context is NULL
+ *       and the value is cached.
+ */
+struct waitui_vm_thunk {
+    const waitui_vm_function *function;
+    waitui_vm_context *context;
+    waitui_vm_value value;
+};
+
+/**
+ * @brief Type for the frame of a function being executed.
+ * @note The pc of a frame is only up to date while it is calling another
+ *       function. The thunk is only set for the frame evaluating it.
+ */
+typedef struct waitui_vm_frame {
+    const waitui_vm_function *function;
+    const waitui_vm_instruction *pc;
+    waitui_vm_value *base;
+    waitui_vm_thunk *thunk;
+} waitui_vm_frame;
+
+/**
+ * @brief Struct representing a VM.
+ * @note The frames of the functions overlap: the registers of a callee start
+ *       at the register of the caller holding the receiver, so the arguments
+ *       are passed without copying and the value returned lands where the
+ *       caller expects it.
+ */
+struct waitui_vm {
+    const waitui_vm_program *program;
+    waitui_arena *heap;
+    waitui_vm_value *stack;
+    waitui_vm_frame *frames;
+    unsigned long int frameCount;
+    FILE *diagnostics;
+    waitui_vm_context *freeContexts[WAITUI_VM_MAX_REGISTERS + 1];
+};
+
+
+// -----------------------------------------------------------------------------
+//  Local functions
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Write the runtime error to the diagnostics and unwind the frames.
+ * @param[in,out] this The VM
+ * @param[in] function The function that failed
+ * @param[in] stopDepth The number of frames to unwind to
+ * @param[in] format The printf format of the error
+ */
+static void waitui_vm_fail(waitui_vm *this, const waitui_vm_function *function,
+                           unsigned long int stopDepth, const char *format,
+                           ...) {
+    char message[256];
+    va_list args;
+
+    va_start(args, format);
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+
+    fprintf(this->diagnostics, "ERROR: %.*s.%.*s: %s\n",
+            STR_FMT(&function->class->name), STR_FMT(&function->name),
+            message);
+
+    this->frameCount = stopDepth;
+}
+
+/**
+ * @brief Return whether the values are equal, numbers are compared by value,
+ *        strings by content and objects by identity.
+ * @param[in] a The first value
+ * @param[in] b The second value
+ * @return true if the values are equal
+ */
+static bool waitui_vm_value_equals(const waitui_vm_value *a,
+                                   const waitui_vm_value *b) {
+    if (a->type != b->type) {
+        return WAITUI_VM_IS_NUMBER(a) && WAITUI_VM_IS_NUMBER(b) &&
+               WAITUI_VM_TO_DECIMAL(a) == WAITUI_VM_TO_DECIMAL(b);
+    }
+
+    switch (a->type) {
+        case WAITUI_VM_VALUE_TYPE_BOOLEAN:
+            return a->as.boolean == b->as.boolean;
+        case WAITUI_VM_VALUE_TYPE_INTEGER:
+            return a->as.integer == b->as.integer;
+        case WAITUI_VM_VALUE_TYPE_DECIMAL:
+            return a->as.decimal == b->as.decimal;
+        case WAITUI_VM_VALUE_TYPE_STRING:
+            return a->as.string->len == b->as.string->len &&
+                   memcmp(a->as.string->s, b->as.string->s,
+                          a->as.string->len) == 0;
+        case WAITUI_VM_VALUE_TYPE_OBJECT:
+            return a->as.object == b->as.object;
+        default:
+            return true;
+    }
+}
+
+/**
+ * @brief Return whether the class is the other class or inherits from it.
+ * @param[in] class The class to check
+ * @param[in] other The class to look for
+ * @return true if the class is a sub class of the other one
+ */
+static bool waitui_vm_class_isSubClassOf(const waitui_vm_class *class,
+                                         const waitui_vm_class *other) {
+    for (; class; class = class->superClass) {
+        if (class == other) { return true; }
+    }
+    return false;
+}
+
+/**
+ * @brief Create a new object of the class with all fields null.
+ * @param[in,out] this The VM to create the object in
+ * @param[in] class The class of the object
+ * @return The object or NULL if memory allocation failed
+ */
+static waitui_vm_object *waitui_vm_newObject(waitui_vm *this,
+                                             const waitui_vm_class *class) {
+    waitui_vm_object *object = NULL;
+
+    object = waitui_arena_alloc(this->heap,
+                                sizeof(*object) +
+                                        class->fieldCount *
+                                                sizeof(waitui_vm_value));
+    if (!object) { return NULL; }
+
+    object->class = class;
+
+    return object;
+}
+
+/**
+ * @brief Create the string holding the two strings one after the other.
+ * @param[in,out] this The VM to create the string in
+ * @param[in] a The first string
+ * @param[in] b The second string
+ * @return The string or NULL if memory allocation failed
+ */
+static const str *waitui_vm_concat(waitui_vm *this, const str *a,
+                                   const str *b) {
+    str *string = NULL;
+
+    string = waitui_arena_alloc(this->heap, sizeof(*string) + a->len + b->len +
+                                                    1);
+    if (!string) { return NULL; }
+
+    string->s   = (char *) (string + 1);
+    string->len = a->len + b->len;
+    memcpy(string->s, a->s, a->len);
+    memcpy(string->s + a->len, b->s, b->len);
+
+    return string;
+}
+
+/**
+ * @brief Create a new thunk of the function capturing the registers.
+ * @param[in,out] this The VM to create the thunk in
+ * @param[in] function The function of the thunk
+ * @param[in] registers The registers to capture, as many as the function has
+ *                      parameters
+ * @return The thunk or NULL if memory allocation failed
+ */
+static waitui_vm_thunk *waitui_vm_newThunk(waitui_vm *this,
+                                           const waitui_vm_function *function,
+                                           const waitui_vm_value *registers) {
+    unsigned long int count    = function->parameterCount;
+    waitui_vm_context *context = this->freeContexts[count];
+    waitui_vm_thunk *thunk     = NULL;
+
+    thunk = waitui_arena_alloc(this->heap, sizeof(*thunk));
+    if (!thunk) { return NULL; }
+
+    if (context) {
+        this->freeContexts[count] = context->next;
+    } else {
+        context = waitui_arena_alloc(this->heap,
+                                     sizeof(*context) +
+                                             count * sizeof(waitui_vm_value));
+        if (!context) { return NULL; }
+    }
+    memcpy(context->registers, registers, count * sizeof(*registers));
+
+    thunk->function = function;
+    thunk->context  = context;
+
+    return thunk;
+}
+
+/**
+ * @brief Cache the value of the thunk and release its context.
+ * @param[in,out] this The VM the thunk was created in
+ * @param[in,out] thunk The thunk that was evaluated
+ * @param[in] value The value of the thunk
+ */
+static void waitui_vm_resolveThunk(waitui_vm *this, waitui_vm_thunk *thunk,
+                                   const waitui_vm_value *value) {
+    unsigned long int count = thunk->function->parameterCount;
+
+    thunk->value              = *value;
+    thunk->context->next      = this->freeContexts[count];
+    this->freeContexts[count] = thunk->context;
+    thunk->context            = NULL;
+}
+
+/**
+ * @brief Push the frame for the function with the registers at the base.
+ * @param[in,out] this The VM to push the frame on
+ * @param[in] function The function to execute in the frame
+ * @param[in] base The first register of the frame
+ * @return The frame or NULL if the stack of the VM is exhausted
+ */
+static waitui_vm_frame *waitui_vm_pushFrame(waitui_vm *this,
+                                            const waitui_vm_function *function,
+                                            waitui_vm_value *base) {
+    waitui_vm_frame *frame = NULL;
+
+    if (this->frameCount == WAITUI_VM_MAX_FRAMES ||
+        base + function->registerCount > this->stack + WAITUI_VM_STACK_SIZE) {
+        return NULL;
+    }
+
+    frame           = &this->frames[this->frameCount++];
+    frame->function = function;
+    frame->pc       = function->code;
+    frame->base     = base;
+    frame->thunk    = NULL;
+
+    return frame;
+}
+
+/**
+ * @brief Return the first register above the frame being executed.
+ * @param[in] this The VM
+ * @return The first free register
+ */
+static waitui_vm_value *waitui_vm_getTop(const waitui_vm *this) {
+    const waitui_vm_frame *frame = NULL;
+
+    if (this->frameCount == 0) { return this->stack; }
+
+    frame = &this->frames[this->frameCount - 1];
+    return frame->base + frame->function->registerCount;
+}
+
+/**
+ * @brief Execute the frames above the stop depth until the first one returns.
+ * @param[in,out] this The VM to execute with
+ * @param[in] stopDepth The number of frames below the first one
+ * @retval 1 Ok, the value returned is in the first register of the frame
+ * @retval 0 The execution failed
+ */
+static int waitui_vm_execute(waitui_vm *this, unsigned long int stopDepth) {
+#if WAITUI_VM_COMPUTED_GOTO
+#define WAITUI_VM_LABEL(name) &&op_##name,
+    static const void *const dispatchTable[WAITUI_VM_OP_COUNT] = {
+            WAITUI_VM_OPCODES(WAITUI_VM_LABEL)};
+#undef WAITUI_VM_LABEL
+#endif
+    const waitui_vm_program *program = this->program;
+    const waitui_vm_value *constants = program->constants;
+    waitui_vm_frame *frame           = &this->frames[this->frameCount - 1];
+    const waitui_vm_instruction *pc  = frame->pc;
+    waitui_vm_value *base            = frame->base;
+    waitui_vm_instruction instruction;
+
+#if WAITUI_VM_COMPUTED_GOTO
+    WAITUI_VM_DISPATCH();
+#else
+dispatch:
+    instruction = *pc++;
+    switch (WAITUI_VM_GET_OP(instruction)) {
+#endif
+
+    WAITUI_VM_CASE(MOVE) {
+        RA = RB;
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(LOADK) {
+        RA = constants[WAITUI_VM_GET_BX(instruction)];
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(LOADINT) {
+        RA.type       = WAITUI_VM_VALUE_TYPE_INTEGER;
+        RA.as.integer = WAITUI_VM_GET_SBX(instruction);
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(LOADNULL) {
+        RA.type = WAITUI_VM_VALUE_TYPE_NULL;
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(LOADBOOL) {
+        RA.type       = WAITUI_VM_VALUE_TYPE_BOOLEAN;
+        RA.as.boolean = WAITUI_VM_GET_B(instruction) != 0;
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(GETFIELD) {
+        if (RB.type != WAITUI_VM_VALUE_TYPE_OBJECT) {
+            WAITUI_VM_FAIL("field access on a value without fields");
+        }
+        RA = RB.as.object->fields[WAITUI_VM_GET_C(instruction)];
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(SETFIELD) {
+        if (RA.type != WAITUI_VM_VALUE_TYPE_OBJECT) {
+            WAITUI_VM_FAIL("field access on a value without fields");
+        }
+        RA.as.object->fields[WAITUI_VM_GET_B(instruction)] = RC;
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(ADD) {
+        WAITUI_VM_ARITHMETIC(+, "+");
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(SUB) {
+        WAITUI_VM_ARITHMETIC(-, "-");
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(MUL) {
+        WAITUI_VM_ARITHMETIC(*, "*");
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(DIV) {
+        const waitui_vm_value *b = &RB;
+        const waitui_vm_value *c = &RC;
+
+        if (b->type == WAITUI_VM_VALUE_TYPE_INTEGER &&
+            c->type == WAITUI_VM_VALUE_TYPE_INTEGER) {
+            int64_t value = 0;
+
+            if (c->as.integer == 0) { WAITUI_VM_FAIL("division by zero"); }
+            if (c->as.integer == -1) {
+                value = (int64_t) (0 - (uint64_t) b->as.integer);
+            } else {
+                value = b->as.integer / c->as.integer;
+            }
+            RA.type       = WAITUI_VM_VALUE_TYPE_INTEGER;
+            RA.as.integer = value;
+        } else if (WAITUI_VM_IS_NUMBER(b) && WAITUI_VM_IS_NUMBER(c)) {
+            double value  = WAITUI_VM_TO_DECIMAL(b) / WAITUI_VM_TO_DECIMAL(c);
+            RA.type       = WAITUI_VM_VALUE_TYPE_DECIMAL;
+            RA.as.decimal = value;
+        } else {
+            WAITUI_VM_FAIL("operands of / have to be numbers");
+        }
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(MOD) {
+        const waitui_vm_value *b = &RB;
+        const waitui_vm_value *c = &RC;
+        int64_t value            = 0;
+
+        if (b->type != WAITUI_VM_VALUE_TYPE_INTEGER ||
+            c->type != WAITUI_VM_VALUE_TYPE_INTEGER) {
+            WAITUI_VM_FAIL("operands of %% have to be integers");
+        }
+        if (c->as.integer == 0) { WAITUI_VM_FAIL("division by zero"); }
+        if (c->as.integer != -1) { value = b->as.integer % c->as.integer; }
+        RA.type       = WAITUI_VM_VALUE_TYPE_INTEGER;
+        RA.as.integer = value;
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(BAND) {
+        WAITUI_VM_BITWISE(&, "&");
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(BXOR) {
+        WAITUI_VM_BITWISE(^, "^");
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(BOR) {
+        WAITUI_VM_BITWISE(|, "|");
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(CONCAT) {
+        const str *value = NULL;
+
+        if (RB.type != WAITUI_VM_VALUE_TYPE_STRING ||
+            RC.type != WAITUI_VM_VALUE_TYPE_STRING) {
+            WAITUI_VM_FAIL("operands of ~ have to be strings");
+        }
+        value = waitui_vm_concat(this, RB.as.string, RC.as.string);
+        if (!value) { WAITUI_VM_FAIL("could not allocate memory"); }
+        RA.type      = WAITUI_VM_VALUE_TYPE_STRING;
+        RA.as.string = value;
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(LT) {
+        WAITUI_VM_COMPARISON(<, "<");
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(LE) {
+        WAITUI_VM_COMPARISON(<=, "<=");
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(GT) {
+        WAITUI_VM_COMPARISON(>, ">");
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(GE) {
+        WAITUI_VM_COMPARISON(>=, ">=");
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(EQ) {
+        bool value    = waitui_vm_value_equals(&RB, &RC);
+        RA.type       = WAITUI_VM_VALUE_TYPE_BOOLEAN;
+        RA.as.boolean = value;
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(NE) {
+        bool value    = !waitui_vm_value_equals(&RB, &RC);
+        RA.type       = WAITUI_VM_VALUE_TYPE_BOOLEAN;
+        RA.as.boolean = value;
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(NEG) {
+        if (RB.type == WAITUI_VM_VALUE_TYPE_INTEGER) {
+            int64_t value = (int64_t) (0 - (uint64_t) RB.as.integer);
+            RA.type       = WAITUI_VM_VALUE_TYPE_INTEGER;
+            RA.as.integer = value;
+        } else if (RB.type == WAITUI_VM_VALUE_TYPE_DECIMAL) {
+            double value  = -RB.as.decimal;
+            RA.type       = WAITUI_VM_VALUE_TYPE_DECIMAL;
+            RA.as.decimal = value;
+        } else {
+            WAITUI_VM_FAIL("operand of - has to be a number");
+        }
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(NOT) {
+        if (RB.type != WAITUI_VM_VALUE_TYPE_BOOLEAN) {
+            WAITUI_VM_FAIL("operand of ! has to be a boolean");
+        }
+        RA.type       = WAITUI_VM_VALUE_TYPE_BOOLEAN;
+        RA.as.boolean = !RB.as.boolean;
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(JMP) {
+        pc += WAITUI_VM_GET_SBX(instruction);
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(JMPIF) {
+        if (RA.type != WAITUI_VM_VALUE_TYPE_BOOLEAN) {
+            WAITUI_VM_FAIL("condition has to be a boolean");
+        }
+        if (RA.as.boolean) { pc += WAITUI_VM_GET_SBX(instruction); }
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(JMPIFNOT) {
+        if (RA.type != WAITUI_VM_VALUE_TYPE_BOOLEAN) {
+            WAITUI_VM_FAIL("condition has to be a boolean");
+        }
+        if (!RA.as.boolean) { pc += WAITUI_VM_GET_SBX(instruction); }
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(CHECKTYPE) {
+        if (RA.type != WAITUI_VM_VALUE_TYPE_NULL &&
+            RA.type != (waitui_vm_value_type) WAITUI_VM_GET_B(instruction)) {
+            WAITUI_VM_FAIL("invalid cast");
+        }
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(CHECKCLASS) {
+        const waitui_vm_class *class =
+                &program->classes[WAITUI_VM_GET_BX(instruction)];
+
+        if (RA.type != WAITUI_VM_VALUE_TYPE_NULL &&
+            (RA.type != WAITUI_VM_VALUE_TYPE_OBJECT ||
+             !waitui_vm_class_isSubClassOf(RA.as.object->class, class))) {
+            WAITUI_VM_FAIL("invalid cast to %.*s", STR_FMT(&class->name));
+        }
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(NEW) {
+        waitui_vm_object *object = waitui_vm_newObject(
+                this, &program->classes[WAITUI_VM_GET_BX(instruction)]);
+
+        if (!object) { WAITUI_VM_FAIL("could not allocate memory"); }
+        RA.type      = WAITUI_VM_VALUE_TYPE_OBJECT;
+        RA.as.object = object;
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(CALL) {
+        const waitui_vm_function *function = NULL;
+        waitui_vm_instruction selector     = *pc++;
+
+        if (RA.type != WAITUI_VM_VALUE_TYPE_OBJECT) {
+            WAITUI_VM_FAIL("call of %.*s on a value without functions",
+                           STR_FMT(&program->selectors[selector]));
+        }
+        function = RA.as.object->class->methods[selector];
+        if (!function) {
+            WAITUI_VM_FAIL("%.*s does not understand %.*s",
+                           STR_FMT(&RA.as.object->class->name),
+                           STR_FMT(&program->selectors[selector]));
+        }
+        if (function->parameterCount != WAITUI_VM_GET_B(instruction)) {
+            WAITUI_VM_FAIL("%.*s.%.*s expects %lu arguments",
+                           STR_FMT(&function->class->name),
+                           STR_FMT(&function->name), function->parameterCount);
+        }
+
+        frame->pc = pc;
+        frame     = waitui_vm_pushFrame(this, function, &RA);
+        if (!frame) {
+            frame = &this->frames[this->frameCount - 1];
+            WAITUI_VM_FAIL("stack overflow");
+        }
+        pc   = frame->pc;
+        base = frame->base;
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(CALLSTATIC) {
+        const waitui_vm_function *function = &program->functions[*pc++];
+
+        frame->pc = pc;
+        frame     = waitui_vm_pushFrame(this, function, &RA);
+        if (!frame) {
+            frame = &this->frames[this->frameCount - 1];
+            WAITUI_VM_FAIL("stack overflow");
+        }
+        pc   = frame->pc;
+        base = frame->base;
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(RETURN) {
+        base[0] = RA;
+        if (frame->thunk) { waitui_vm_resolveThunk(this, frame->thunk, base); }
+        if (--this->frameCount == stopDepth) { return 1; }
+
+        frame = &this->frames[this->frameCount - 1];
+        pc    = frame->pc;
+        base  = frame->base;
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(THUNK) {
+        waitui_vm_thunk *thunk = waitui_vm_newThunk(
+                this, program->thunks[WAITUI_VM_GET_BX(instruction)], base);
+
+        if (!thunk) { WAITUI_VM_FAIL("could not allocate memory"); }
+        RA.type     = WAITUI_VM_VALUE_TYPE_THUNK;
+        RA.as.thunk = thunk;
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(FORCE) {
+        waitui_vm_thunk *thunk = NULL;
+
+        if (RA.type != WAITUI_VM_VALUE_TYPE_THUNK) { WAITUI_VM_DISPATCH(); }
+
+        thunk = RA.as.thunk;
+        if (!thunk->context) {
+            RA = thunk->value;
+            WAITUI_VM_DISPATCH();
+        }
+
+        // evaluate the thunk above the frame and execute the FORCE again
+        // once it returns, which then finds the value cached
+        frame->pc = pc - 1;
+        frame     = waitui_vm_pushFrame(this, thunk->function,
+                                        base + frame->function->registerCount);
+        if (!frame) {
+            frame = &this->frames[this->frameCount - 1];
+            WAITUI_VM_FAIL("stack overflow");
+        }
+        frame->thunk = thunk;
+        memcpy(frame->base, thunk->context->registers,
+               thunk->function->parameterCount * sizeof(*base));
+        pc   = frame->pc;
+        base = frame->base;
+        WAITUI_VM_DISPATCH();
+    }
+    WAITUI_VM_CASE(NATIVE) {
+        if (!frame->function->native(this, &RA)) {
+            WAITUI_VM_FAIL("native function failed");
+        }
+        WAITUI_VM_DISPATCH();
+    }
+
+#if !WAITUI_VM_COMPUTED_GOTO
+        default:
+            WAITUI_VM_FAIL("invalid instruction");
+    }
+#endif
+}
+
+
+// -----------------------------------------------------------------------------
+//  Public functions
+// -----------------------------------------------------------------------------
+
+waitui_vm *waitui_vm_new(const waitui_vm_program *program) {
+    waitui_vm *this = NULL;
+
+    if (!program) { return NULL; }
+
+    this = calloc(1, sizeof(*this));
+    if (!this) { return NULL; }
+
+    this->program = program;
+    this->heap    = waitui_arena_new();
+    this->stack   = calloc(WAITUI_VM_STACK_SIZE, sizeof(*this->stack));
+    this->frames  = calloc(WAITUI_VM_MAX_FRAMES, sizeof(*this->frames));
+    if (!this->heap || !this->stack || !this->frames) {
+        waitui_vm_destroy(&this);
+        return NULL;
+    }
+
+    return this;
+}
+
+void waitui_vm_destroy(waitui_vm **this) {
+    if (!this || !(*this)) { return; }
+
+    waitui_arena_destroy(&(*this)->heap);
+    free((*this)->stack);
+    free((*this)->frames);
+    free(*this);
+    *this = NULL;
+}
+
+int waitui_vm_run(waitui_vm *this, str className, str functionName,
+                  waitui_vm_value *result, FILE *diagnostics) {
+    const waitui_vm_function *function = NULL;
+    const waitui_vm_class *class       = NULL;
+    unsigned long int selector         = 0;
+    waitui_vm_value self               = {0};
+    waitui_vm_value ignored            = {0};
+
+    if (!this || !result) { return 0; }
+    if (!diagnostics) { diagnostics = stderr; }
+
+    class = waitui_vm_program_getClass(this->program, className);
+    if (!class) {
+        fprintf(diagnostics, "ERROR: unknown class '%.*s'\n",
+                STR_FMT(&className));
+        return 0;
+    }
+    if (class->parameterCount != 0) {
+        fprintf(diagnostics, "ERROR: class '%.*s' has parameters\n",
+                STR_FMT(&className));
+        return 0;
+    }
+
+    if (waitui_vm_program_getSelector(this->program, functionName,
+                                      &selector)) {
+        function = class->methods[selector];
+    }
+    if (!function) {
+        fprintf(diagnostics, "ERROR: unknown function '%.*s' of class '%.*s'\n",
+                STR_FMT(&functionName), STR_FMT(&className));
+        return 0;
+    }
+    if (function->parameterCount != 0) {
+        fprintf(diagnostics,
+                "ERROR: function '%.*s' of class '%.*s' has parameters\n",
+                STR_FMT(&functionName), STR_FMT(&className));
+        return 0;
+    }
+
+    self.type      = WAITUI_VM_VALUE_TYPE_OBJECT;
+    self.as.object = waitui_vm_newObject(this, class);
+    if (!self.as.object) {
+        fprintf(diagnostics,
+                "ERROR: could not allocate memory for the object\n");
+        return 0;
+    }
+
+    return waitui_vm_call(this, class->initializer, self, NULL, &ignored,
+                          diagnostics) &&
+           waitui_vm_call(this, function, self, NULL, result, diagnostics);
+}
+
+int waitui_vm_call(waitui_vm *this, const waitui_vm_function *function,
+                   waitui_vm_value self, const waitui_vm_value *args,
+                   waitui_vm_value *result, FILE *diagnostics) {
+    FILE *outerDiagnostics      = NULL;
+    unsigned long int stopDepth = 0;
+    waitui_vm_value *base       = NULL;
+    int executed                = 0;
+
+    if (!this || !function || !result) { return 0; }
+    if (!diagnostics) { diagnostics = stderr; }
+
+    stopDepth = this->frameCount;
+    base      = waitui_vm_getTop(this);
+
+    if (!waitui_vm_pushFrame(this, function, base)) {
+        fprintf(diagnostics, "ERROR: %.*s.%.*s: stack overflow\n",
+                STR_FMT(&function->class->name), STR_FMT(&function->name));
+        return 0;
+    }
+
+    base[0] = self;
+    if (function->parameterCount) {
+        memcpy(base + 1, args, function->parameterCount * sizeof(*args));
+    }
+
+    // a native function may call back in, the outer call keeps its file
+    outerDiagnostics  = this->diagnostics;
+    this->diagnostics = diagnostics;
+    executed          = waitui_vm_execute(this, stopDepth);
+    this->diagnostics = outerDiagnostics;
+
+    if (!executed) { return 0; }
+
+    *result = base[0];
+
+    return 1;
+}
+
+void waitui_vm_value_print(const waitui_vm_value *value, FILE *file) {
+    if (!value || !file) { return; }
+
+    switch (value->type) {
+        case WAITUI_VM_VALUE_TYPE_BOOLEAN:
+            fputs(value->as.boolean ? "true" : "false", file);
+            break;
+        case WAITUI_VM_VALUE_TYPE_INTEGER:
+            fprintf(file, "%" PRId64, value->as.integer);
+            break;
+        case WAITUI_VM_VALUE_TYPE_DECIMAL:
+            fprintf(file, "%g", value->as.decimal);
+            break;
+        case WAITUI_VM_VALUE_TYPE_STRING:
+            fprintf(file, "%.*s", STR_FMT(value->as.string));
+            break;
+        case WAITUI_VM_VALUE_TYPE_OBJECT:
+            fprintf(file, "<%.*s>", STR_FMT(&value->as.object->class->name));
+            break;
+        default:
+            fputs("null", file);
+            break;
+    }
+}
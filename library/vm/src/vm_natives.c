@@ -0,0 +1,112 @@
+/**
+ * @file vm_natives.c
+ * @author rick
+ * @date 17.10.26
+ * @brief File for the VM natives implementation
+ */
+
+#include "waitui/vm_natives.h"
+
+#include <waitui/arena.h>
+#include <waitui/hashtable.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+
+// -----------------------------------------------------------------------------
+//  Local types
+// -----------------------------------------------------------------------------
+
+CREATE_HASHTABLE_TYPE_CUSTOM(INTERFACE, waitui_vm_native, waitui_vm_native,
+                             NULL)
+
+/**
+ * @brief Struct representing a table of VM natives.
+ * @note The bindings live in the arena of the table, the hashtable only
+ *       points to them.
+ */
+struct waitui_vm_natives {
+    waitui_arena *arena;
+    waitui_vm_native_hashtable *bindings;
+};
+
+
+// -----------------------------------------------------------------------------
+//  Local functions
+// -----------------------------------------------------------------------------
+
+CREATE_HASHTABLE_TYPE_CUSTOM(IMPLEMENTATION, waitui_vm_native,
+                             waitui_vm_native, NULL)
+
+
+// -----------------------------------------------------------------------------
+//  Public functions
+// -----------------------------------------------------------------------------
+
+waitui_vm_natives *waitui_vm_natives_new(void) {
+    waitui_vm_natives *this = NULL;
+
+    this = calloc(1, sizeof(*this));
+    if (!this) { return NULL; }
+
+    this->arena    = waitui_arena_new();
+    this->bindings = waitui_vm_native_hashtable_new(16);
+    if (!this->arena || !this->bindings) {
+        waitui_vm_natives_destroy(&this);
+        return NULL;
+    }
+
+    return this;
+}
+
+void waitui_vm_natives_destroy(waitui_vm_natives **this) {
+    if (!this || !(*this)) { return; }
+
+    waitui_vm_native_hashtable_destroy(&(*this)->bindings);
+    waitui_arena_destroy(&(*this)->arena);
+    free(*this);
+    *this = NULL;
+}
+
+int waitui_vm_natives_register(waitui_vm_natives *this, str name,
+                               unsigned long int parameterCount,
+                               waitui_vm_native_function function) {
+    waitui_vm_native *native = NULL;
+
+    if (!this || !name.s || !function) { return 0; }
+    if (waitui_vm_native_hashtable_has(this->bindings, name)) { return 0; }
+
+    native = waitui_arena_alloc(this->arena, sizeof(*native));
+    if (!native || !waitui_arena_copyStr(this->arena, &native->name, &name)) {
+        return 0;
+    }
+    native->parameterCount = parameterCount;
+    native->function       = function;
+
+    return waitui_vm_native_hashtable_insert(this->bindings, native->name,
+                                             native);
+}
+
+const waitui_vm_native *
+waitui_vm_natives_lookup(const waitui_vm_natives *this, str className,
+                         str functionName) {
+    const waitui_vm_native *native = NULL;
+    str name                       = STR_NULL_INIT;
+
+    if (!this) { return NULL; }
+
+    name.len = className.len + 1 + functionName.len;
+    name.s   = malloc(name.len);
+    if (!name.s) { return NULL; }
+
+    memcpy(name.s, className.s, className.len);
+    name.s[className.len] = '.';
+    memcpy(name.s + className.len + 1, functionName.s, functionName.len);
+
+    native = waitui_vm_native_hashtable_lookup(this->bindings, name);
+
+    free(name.s);
+
+    return native;
+}
@@ -0,0 +1,2234 @@
+/**
+ * @file vm_program.c
+ * @author rick
+ * @date 17.10.26
+ * @brief File for the VM program implementation
+ */
+
+#include "waitui/vm_program.h"
+#include "waitui/vm_natives.h"
+
+#include <waitui/hashtable.h>
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+// -----------------------------------------------------------------------------
+//  Local defines
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief The maximal nesting of expressions the compiler descends into.
+ */
+#define WAITUI_VM_MAX_DEPTH 1000
+
+/**
+ * @brief The initial capacity of the code of a function and the constants.
+ */
+#define WAITUI_VM_INITIAL_CAPACITY 64
+
+
+// -----------------------------------------------------------------------------
+//  Local types
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Type for the index of a function name in the selectors.
+ * @note The lazy parameters are the ones any function with the name takes as
+ *       thunks, so every call with the name passes those arguments as thunks.
+ */
+typedef struct waitui_vm_selector {
+    unsigned long int index;
+    bool *lazyParameters;
+    unsigned long int lazyCount;
+} waitui_vm_selector;
+
+CREATE_HASHTABLE_TYPE_CUSTOM(INTERFACE, waitui_vm_class, waitui_vm_class, NULL)
+CREATE_HASHTABLE_TYPE_CUSTOM(INTERFACE, waitui_vm_selector, waitui_vm_selector,
+                             NULL)
+
+/**
+ * @brief Type for a local variable, a parameter or a let binding, of the
+ *        function being compiled.
+ * @note The register of a lazy local may hold a thunk, which has to be
+ *       forced before the value is read.
+ */
+typedef struct waitui_vm_local {
+    const str *name;
+    unsigned int reg;
+    bool isLazy;
+} waitui_vm_local;
+
+/**
+ * @brief The states of a class while the classes are laid out.
+ */
+typedef enum waitui_vm_layout_state {
+    WAITUI_VM_LAYOUT_STATE_NONE,
+    WAITUI_VM_LAYOUT_STATE_ACTIVE,
+    WAITUI_VM_LAYOUT_STATE_DONE,
+} waitui_vm_layout_state;
+
+/**
+ * @brief Type for the compiler of a VM program.
+ * @note The registers of a function are allocated like a stack: the locals
+ *       and temporaries of an expression live above the register its value
+ *       goes to and are released once the expression is compiled, so the
+ *       arguments of a call always end up in consecutive registers.
+ */
+typedef struct waitui_vm_compiler {
+    waitui_vm_program *program;
+    const waitui_vm_natives *natives;
+    FILE *diagnostics;
+    waitui_vm_class_hashtable *classNames;
+    waitui_vm_selector_hashtable *selectorNames;
+    waitui_ast_class **astClasses;
+    unsigned long int astClassCount;
+    unsigned long int astClassCapacity;
+    waitui_vm_layout_state *layoutStates;
+    waitui_ast_function **astFunctions;
+    unsigned long int nextFunction;
+    unsigned long int constantCapacity;
+    waitui_vm_function *function;
+    waitui_vm_instruction *code;
+    unsigned long int codeLength;
+    unsigned long int codeCapacity;
+    waitui_vm_local locals[WAITUI_VM_MAX_REGISTERS];
+    unsigned long int localCount;
+    unsigned int nextRegister;
+    unsigned long int depth;
+} waitui_vm_compiler;
+
+
+// -----------------------------------------------------------------------------
+//  Local functions
+// -----------------------------------------------------------------------------
+
+CREATE_HASHTABLE_TYPE_CUSTOM(IMPLEMENTATION, waitui_vm_class, waitui_vm_class,
+                             NULL)
+CREATE_HASHTABLE_TYPE_CUSTOM(IMPLEMENTATION, waitui_vm_selector,
+                             waitui_vm_selector, NULL)
+
+static int
+waitui_vm_compiler_compileExpression(waitui_vm_compiler *this,
+                                     waitui_ast_expression *expression,
+                                     unsigned int target);
+static int waitui_vm_compiler_endFunction(waitui_vm_compiler *this);
+
+/**
+ * @brief Write the error of the function being compiled to the diagnostics.
+ * @param[in] this The compiler
+ * @param[in] format The printf format of the error
+ * @return Always 0, to be returned by the failing function
+ */
+static int waitui_vm_compiler_error(const waitui_vm_compiler *this,
+                                    const char *format, ...) {
+    char message[256];
+    va_list args;
+
+    va_start(args, format);
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+
+    if (this->function) {
+        fprintf(this->diagnostics, "ERROR: %.*s.%.*s: %s\n",
+                STR_FMT(&this->function->class->name),
+                STR_FMT(&this->function->name), message);
+    } else {
+        fprintf(this->diagnostics, "ERROR: %s\n", message);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Append the instruction to the code of the function being compiled.
+ * @param[in,out] this The compiler
+ * @param[in] instruction The instruction to append
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ */
+static int waitui_vm_compiler_emit(waitui_vm_compiler *this,
+                                   waitui_vm_instruction instruction) {
+    if (this->codeLength == this->codeCapacity) {
+        unsigned long int capacity      = this->codeCapacity * 2;
+        waitui_vm_instruction *code = NULL;
+
+        if (!capacity) { capacity = WAITUI_VM_INITIAL_CAPACITY; }
+
+        code = realloc(this->code, capacity * sizeof(*code));
+        if (!code) {
+            return waitui_vm_compiler_error(this, "could not allocate memory");
+        }
+
+        this->code         = code;
+        this->codeCapacity = capacity;
+    }
+
+    this->code[this->codeLength++] = instruction;
+
+    return 1;
+}
+
+/**
+ * @brief Append a jump to be patched later.
+ * @param[in,out] this The compiler
+ * @param[in] opcode The opcode of the jump
+ * @param[in] reg The register of the condition
+ * @param[out] position The position of the jump in the code
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ */
+static int waitui_vm_compiler_emitJump(waitui_vm_compiler *this,
+                                       waitui_vm_opcode opcode,
+                                       unsigned int reg,
+                                       unsigned long int *position) {
+    *position = this->codeLength;
+    return waitui_vm_compiler_emit(this, WAITUI_VM_ASBX(opcode, reg, 0));
+}
+
+/**
+ * @brief Point the jump at the position to the destination.
+ * @param[in,out] this The compiler
+ * @param[in] position The position of the jump in the code
+ * @param[in] destination The position to jump to
+ * @retval 1 Ok
+ * @retval 0 The distance does not fit into the jump
+ */
+static int waitui_vm_compiler_patchJump(waitui_vm_compiler *this,
+                                        unsigned long int position,
+                                        unsigned long int destination) {
+    long int offset                   = (long int) destination -
+                      (long int) position - 1;
+    waitui_vm_instruction instruction = this->code[position];
+
+    if (offset < WAITUI_VM_MIN_SBX || offset > WAITUI_VM_MAX_SBX) {
+        return waitui_vm_compiler_error(this, "function is too large");
+    }
+
+    this->code[position] = WAITUI_VM_ASBX(WAITUI_VM_GET_OP(instruction),
+                                          WAITUI_VM_GET_A(instruction), offset);
+
+    return 1;
+}
+
+/**
+ * @brief Allocate the next free register of the function being compiled.
+ * @param[in,out] this The compiler
+ * @param[out] reg The allocated register
+ * @retval 1 Ok
+ * @retval 0 The function needs too many registers
+ */
+static int waitui_vm_compiler_allocRegister(waitui_vm_compiler *this,
+                                            unsigned int *reg) {
+    if (this->nextRegister >= WAITUI_VM_MAX_REGISTERS) {
+        return waitui_vm_compiler_error(this, "function needs more than %d "
+                                              "registers",
+                                        WAITUI_VM_MAX_REGISTERS);
+    }
+
+    *reg = this->nextRegister++;
+    if (this->nextRegister > this->function->registerCount) {
+        this->function->registerCount = this->nextRegister;
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Add the value to the constants of the program.
+ * @param[in,out] this The compiler
+ * @param[in] value The value to add
+ * @param[out] index The index of the constant
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed or there are too many constants
+ */
+static int waitui_vm_compiler_addConstant(waitui_vm_compiler *this,
+                                          waitui_vm_value value,
+                                          unsigned long int *index) {
+    waitui_vm_program *program = this->program;
+
+    if (program->constantCount > WAITUI_VM_MAX_BX) {
+        return waitui_vm_compiler_error(this, "program has more than %d "
+                                              "constants",
+                                        WAITUI_VM_MAX_BX + 1);
+    }
+
+    if (program->constantCount == this->constantCapacity) {
+        unsigned long int capacity = this->constantCapacity * 2;
+        waitui_vm_value *constants = NULL;
+
+        if (!capacity) { capacity = WAITUI_VM_INITIAL_CAPACITY; }
+
+        constants = realloc(program->constants, capacity * sizeof(*constants));
+        if (!constants) {
+            return waitui_vm_compiler_error(this, "could not allocate memory");
+        }
+
+        program->constants     = constants;
+        this->constantCapacity = capacity;
+    }
+
+    *index                                      = program->constantCount;
+    program->constants[program->constantCount++] = value;
+
+    return 1;
+}
+
+/**
+ * @brief Load the constant into the register.
+ * @param[in,out] this The compiler
+ * @param[in] value The value to load
+ * @param[in] target The register to load into
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed or there are too many constants
+ */
+static int waitui_vm_compiler_loadConstant(waitui_vm_compiler *this,
+                                           waitui_vm_value value,
+                                           unsigned int target) {
+    unsigned long int index = 0;
+
+    if (value.type == WAITUI_VM_VALUE_TYPE_INTEGER &&
+        value.as.integer >= WAITUI_VM_MIN_SBX &&
+        value.as.integer <= WAITUI_VM_MAX_SBX) {
+        return waitui_vm_compiler_emit(
+                this,
+                WAITUI_VM_ASBX(WAITUI_VM_OP_LOADINT, target, value.as.integer));
+    }
+
+    if (!waitui_vm_compiler_addConstant(this, value, &index)) { return 0; }
+
+    return waitui_vm_compiler_emit(
+            this, WAITUI_VM_ABX(WAITUI_VM_OP_LOADK, target, index));
+}
+
+/**
+ * @brief Find the local with the name, inner scopes first.
+ * @param[in] this The compiler
+ * @param[in] name The name of the local
+ * @return The local or NULL if there is no local with the name
+ */
+static const waitui_vm_local *
+waitui_vm_compiler_findLocal(const waitui_vm_compiler *this, const str *name) {
+    for (unsigned long int i = this->localCount; i > 0; --i) {
+        if (STR_EQUALS(this->locals[i - 1].name, name)) {
+            return &this->locals[i - 1];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Force the thunk a lazy local may hold, so its register holds the
+ *        value afterwards.
+ * @param[in,out] this The compiler
+ * @param[in] local The local to force
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ */
+static int waitui_vm_compiler_forceLocal(waitui_vm_compiler *this,
+                                         const waitui_vm_local *local) {
+    if (!local->isLazy) { return 1; }
+    return waitui_vm_compiler_emit(
+            this, WAITUI_VM_ABC(WAITUI_VM_OP_FORCE, local->reg, 0, 0));
+}
+
+/**
+ * @brief Find the field with the name in the class of the function being
+ *        compiled, fields of sub classes hide the ones of super classes.
+ * @param[in] this The compiler
+ * @param[in] name The name of the field
+ * @param[out] field The index of the field
+ * @return true if there is a field with the name
+ */
+static bool waitui_vm_compiler_findField(const waitui_vm_compiler *this,
+                                         const str *name, unsigned int *field) {
+    const waitui_vm_class *class = this->function->class;
+
+    for (unsigned long int i = class->fieldCount; i > 0; --i) {
+        if (STR_EQUALS(&class->fieldNames[i - 1], name)) {
+            *field = i - 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Find the class with the name.
+ * @param[in] this The compiler
+ * @param[in] name The name of the class
+ * @return The class or NULL if there is no class with the name
+ */
+static waitui_vm_class *waitui_vm_compiler_findClass(waitui_vm_compiler *this,
+                                                     const str *name) {
+    return waitui_vm_class_hashtable_lookup(this->classNames, *name);
+}
+
+/**
+ * @brief Add the local to the scope of the function being compiled.
+ * @param[in,out] this The compiler
+ * @param[in] name The name of the local
+ * @param[in] reg The register of the local
+ * @param[in] isLazy If the register of the local may hold a thunk
+ */
+static void waitui_vm_compiler_addLocal(waitui_vm_compiler *this,
+                                        const str *name, unsigned int reg,
+                                        bool isLazy) {
+    this->locals[this->localCount].name     = name;
+    this->locals[this->localCount].reg      = reg;
+    this->locals[this->localCount++].isLazy = isLazy;
+}
+
+/**
+ * @brief Return the opcode of the binary operator.
+ * @param[in] operator The binary operator
+ * @return The opcode or WAITUI_VM_OP_COUNT for the short circuit operators
+ */
+static waitui_vm_opcode
+waitui_vm_getBinaryOpcode(waitui_ast_binary_operator operator) {
+    switch (operator) {
+        case WAITUI_AST_BINARY_OPERATOR_PLUS:
+            return WAITUI_VM_OP_ADD;
+        case WAITUI_AST_BINARY_OPERATOR_MINUS:
+            return WAITUI_VM_OP_SUB;
+        case WAITUI_AST_BINARY_OPERATOR_TIMES:
+            return WAITUI_VM_OP_MUL;
+        case WAITUI_AST_BINARY_OPERATOR_DIV:
+            return WAITUI_VM_OP_DIV;
+        case WAITUI_AST_BINARY_OPERATOR_MODULO:
+            return WAITUI_VM_OP_MOD;
+        case WAITUI_AST_BINARY_OPERATOR_AND:
+            return WAITUI_VM_OP_BAND;
+        case WAITUI_AST_BINARY_OPERATOR_CARET:
+            return WAITUI_VM_OP_BXOR;
+        case WAITUI_AST_BINARY_OPERATOR_TILDE:
+            return WAITUI_VM_OP_CONCAT;
+        case WAITUI_AST_BINARY_OPERATOR_PIPE:
+            return WAITUI_VM_OP_BOR;
+        case WAITUI_AST_BINARY_OPERATOR_LESS:
+            return WAITUI_VM_OP_LT;
+        case WAITUI_AST_BINARY_OPERATOR_LESS_EQUAL:
+            return WAITUI_VM_OP_LE;
+        case WAITUI_AST_BINARY_OPERATOR_GREATER:
+            return WAITUI_VM_OP_GT;
+        case WAITUI_AST_BINARY_OPERATOR_GREATER_EQUAL:
+            return WAITUI_VM_OP_GE;
+        case WAITUI_AST_BINARY_OPERATOR_EQUAL:
+            return WAITUI_VM_OP_EQ;
+        case WAITUI_AST_BINARY_OPERATOR_NOT_EQUAL:
+            return WAITUI_VM_OP_NE;
+        default:
+            return WAITUI_VM_OP_COUNT;
+    }
+}
+
+/**
+ * @brief Return the opcode of the compound assignment operator.
+ * @param[in] operator The assignment operator
+ * @return The opcode or WAITUI_VM_OP_COUNT for the plain assignment
+ */
+static waitui_vm_opcode
+waitui_vm_getAssignmentOpcode(waitui_ast_assignment_operator operator) {
+    switch (operator) {
+        case WAITUI_AST_ASSIGNMENT_OPERATOR_PLUS_EQUAL:
+            return WAITUI_VM_OP_ADD;
+        case WAITUI_AST_ASSIGNMENT_OPERATOR_MINUS_EQUAL:
+            return WAITUI_VM_OP_SUB;
+        case WAITUI_AST_ASSIGNMENT_OPERATOR_TIMES_EQUAL:
+            return WAITUI_VM_OP_MUL;
+        case WAITUI_AST_ASSIGNMENT_OPERATOR_DIV_EQUAL:
+            return WAITUI_VM_OP_DIV;
+        case WAITUI_AST_ASSIGNMENT_OPERATOR_MODULO_EQUAL:
+            return WAITUI_VM_OP_MOD;
+        case WAITUI_AST_ASSIGNMENT_OPERATOR_AND_EQUAL:
+            return WAITUI_VM_OP_BAND;
+        case WAITUI_AST_ASSIGNMENT_OPERATOR_CARET_EQUAL:
+            return WAITUI_VM_OP_BXOR;
+        case WAITUI_AST_ASSIGNMENT_OPERATOR_TILDE_EQUAL:
+            return WAITUI_VM_OP_CONCAT;
+        case WAITUI_AST_ASSIGNMENT_OPERATOR_PIPE_EQUAL:
+            return WAITUI_VM_OP_BOR;
+        default:
+            return WAITUI_VM_OP_COUNT;
+    }
+}
+
+/**
+ * @brief Return the value type of the built-in type name.
+ * @param[in] name The name of the type
+ * @param[out] type The value type
+ * @return true if the name is a built-in type
+ */
+static bool waitui_vm_getValueType(const str *name,
+                                   waitui_vm_value_type *type) {
+    static const struct {
+        str name;
+        waitui_vm_value_type type;
+    } types[] = {
+            {STR_STATIC_INIT("Bool"), WAITUI_VM_VALUE_TYPE_BOOLEAN},
+            {STR_STATIC_INIT("Int"), WAITUI_VM_VALUE_TYPE_INTEGER},
+            {STR_STATIC_INIT("Decimal"), WAITUI_VM_VALUE_TYPE_DECIMAL},
+            {STR_STATIC_INIT("String"), WAITUI_VM_VALUE_TYPE_STRING},
+    };
+
+    for (unsigned long int i = 0; i < sizeof(types) / sizeof(*types); ++i) {
+        if (STR_EQUALS(&types[i].name, name)) {
+            *type = types[i].type;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Parse the integer literal.
+ * @param[in] this The compiler
+ * @param[in] text The digits of the literal
+ * @param[out] value The parsed value
+ * @retval 1 Ok
+ * @retval 0 The literal does not fit into 64 bits
+ */
+static int waitui_vm_compiler_parseInteger(const waitui_vm_compiler *this,
+                                           const str *text,
+                                           waitui_vm_value *value) {
+    uint64_t integer = 0;
+
+    for (unsigned long int i = 0; i < text->len; ++i) {
+        unsigned int digit = (unsigned int) (text->s[i] - '0');
+
+        if (digit > 9 || integer > ((uint64_t) INT64_MAX - digit) / 10) {
+            return waitui_vm_compiler_error(this, "invalid integer '%.*s'",
+                                            STR_FMT(text));
+        }
+        integer = integer * 10 + digit;
+    }
+
+    value->type       = WAITUI_VM_VALUE_TYPE_INTEGER;
+    value->as.integer = (int64_t) integer;
+
+    return 1;
+}
+
+/**
+ * @brief Parse the decimal literal.
+ * @param[in] this The compiler
+ * @param[in] text The text of the literal
+ * @param[out] value The parsed value
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ */
+static int waitui_vm_compiler_parseDecimal(const waitui_vm_compiler *this,
+                                           const str *text,
+                                           waitui_vm_value *value) {
+    str copy = STR_NULL_INIT;
+
+    STR_COPY_WITH_NUL(&copy, text);
+    if (!copy.s) {
+        return waitui_vm_compiler_error(this, "could not allocate memory");
+    }
+
+    value->type       = WAITUI_VM_VALUE_TYPE_DECIMAL;
+    value->as.decimal = strtod(copy.s, NULL);
+
+    STR_FREE(&copy);
+
+    return 1;
+}
+
+/**
+ * @brief Copy the string literal into the program, resolving the escapes.
+ * @param[in,out] this The compiler
+ * @param[in] text The text of the literal without the quotes
+ * @param[out] value The string value
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ */
+static int waitui_vm_compiler_parseString(waitui_vm_compiler *this,
+                                          const str *text,
+                                          waitui_vm_value *value) {
+    str *string = NULL;
+
+    string = waitui_arena_alloc(this->program->arena, sizeof(*string));
+    if (!string) {
+        return waitui_vm_compiler_error(this, "could not allocate memory");
+    }
+
+    string->s = waitui_arena_alloc(this->program->arena, text->len + 1);
+    if (!string->s) {
+        return waitui_vm_compiler_error(this, "could not allocate memory");
+    }
+
+    for (unsigned long int i = 0; i < text->len; ++i) {
+        char character = text->s[i];
+
+        if (character == '\\' && i + 1 < text->len) {
+            switch (text->s[++i]) {
+                case 'n':
+                    character = '\n';
+                    break;
+                case 'r':
+                    character = '\r';
+                    break;
+                case 't':
+                    character = '\t';
+                    break;
+                case '0':
+                    character = '\0';
+                    break;
+                default:
+                    character = text->s[i];
+                    break;
+            }
+        }
+        string->s[string->len++] = character;
+    }
+
+    value->type      = WAITUI_VM_VALUE_TYPE_STRING;
+    value->as.string = string;
+
+    return 1;
+}
+
+/**
+ * @brief Compile the expression into a register, locals are used in place.
+ * @param[in,out] this The compiler
+ * @param[in] expression The expression to compile
+ * @param[out] reg The register holding the value of the expression
+ * @retval 1 Ok
+ * @retval 0 Compilation failed
+ * @note A temporary register stays allocated until the caller releases it.
+ */
+static int waitui_vm_compiler_compileOperand(waitui_vm_compiler *this,
+                                             waitui_ast_expression *expression,
+                                             unsigned int *reg) {
+    const waitui_vm_local *local = NULL;
+
+    if (waitui_ast_expression_getExpressionType(expression) ==
+        WAITUI_AST_EXPRESSION_TYPE_REFERENCE) {
+        local = waitui_vm_compiler_findLocal(
+                this, &waitui_ast_reference_getValue(
+                               (waitui_ast_reference *) expression)
+                               ->identifier);
+    }
+    if (local) {
+        *reg = local->reg;
+        return waitui_vm_compiler_forceLocal(this, local);
+    }
+
+    if (!waitui_vm_compiler_allocRegister(this, reg)) { return 0; }
+    return waitui_vm_compiler_compileExpression(this, expression, *reg);
+}
+
+/**
+ * @brief Return whether the expression is a reference to a local.
+ * @param[in] this The compiler
+ * @param[in] expression The expression to check
+ * @return true if the expression is a reference to a local
+ */
+static bool waitui_vm_compiler_isLocal(const waitui_vm_compiler *this,
+                                       waitui_ast_expression *expression) {
+    return waitui_ast_expression_getExpressionType(expression) ==
+                   WAITUI_AST_EXPRESSION_TYPE_REFERENCE &&
+           waitui_vm_compiler_findLocal(
+                   this, &waitui_ast_reference_getValue(
+                                  (waitui_ast_reference *) expression)
+                                  ->identifier);
+}
+
+/**
+ * @brief Compile the first operand of an operator, in the target if it is the
+ *        last allocated register.
+ * @param[in,out] this The compiler
+ * @param[in] expression The expression to compile
+ * @param[in] target The register the value of the operator goes to
+ * @param[out] reg The register holding the value of the expression
+ * @retval 1 Ok
+ * @retval 0 Compilation failed
+ * @note Building the first operand in the target keeps a chain of operators
+ *       like a + b + c + d at two registers instead of one per operator.
+ */
+static int waitui_vm_compiler_compileFirstOperand(
+        waitui_vm_compiler *this, waitui_ast_expression *expression,
+        unsigned int target, unsigned int *reg) {
+    if (target + 1 != this->nextRegister ||
+        waitui_vm_compiler_isLocal(this, expression)) {
+        return waitui_vm_compiler_compileOperand(this, expression, reg);
+    }
+
+    *reg = target;
+    return waitui_vm_compiler_compileExpression(this, expression, target);
+}
+
+/**
+ * @brief Compile the expression into a thunk with a function of its own.
+ * @param[in,out] this The compiler
+ * @param[in] expression The expression to compile
+ * @param[in] target The register for the thunk
+ * @retval 1 Ok
+ * @retval 0 Compilation failed
+ * @note The thunk captures the registers up to the last local in scope, its
+ *       function finds the locals in the same registers. An assignment to a
+ *       local inside the thunk only changes the captured copy.
+ */
+static int waitui_vm_compiler_compileThunk(waitui_vm_compiler *this,
+                                           waitui_ast_expression *expression,
+                                           unsigned int target) {
+    waitui_vm_program *program        = this->program;
+    waitui_vm_function *function      = this->function;
+    waitui_vm_instruction *code       = this->code;
+    unsigned long int codeLength      = this->codeLength;
+    unsigned long int codeCapacity    = this->codeCapacity;
+    unsigned int nextRegister         = this->nextRegister;
+    const waitui_vm_function **thunks = NULL;
+    waitui_vm_function *thunk         = NULL;
+    unsigned int captureCount         = 1;
+    unsigned int reg                  = 0;
+    int result                        = 0;
+
+    for (unsigned long int i = 0; i < this->localCount; ++i) {
+        if (this->locals[i].reg >= captureCount) {
+            captureCount = this->locals[i].reg + 1;
+        }
+    }
+
+    thunk = waitui_arena_alloc(program->arena, sizeof(*thunk));
+    if (!thunk) {
+        return waitui_vm_compiler_error(this, "could not allocate memory");
+    }
+    thunk->name           = function->name;
+    thunk->class          = function->class;
+    thunk->parameterCount = captureCount;
+    thunk->registerCount  = captureCount;
+
+    this->function     = thunk;
+    this->code         = NULL;
+    this->codeLength   = 0;
+    this->codeCapacity = 0;
+    this->nextRegister = captureCount;
+
+    result = waitui_vm_compiler_allocRegister(this, &reg) &&
+             waitui_vm_compiler_compileExpression(this, expression, reg) &&
+             waitui_vm_compiler_emit(
+                     this, WAITUI_VM_ABC(WAITUI_VM_OP_RETURN, reg, 0, 0)) &&
+             waitui_vm_compiler_endFunction(this);
+
+    free(this->code);
+    this->function     = function;
+    this->code         = code;
+    this->codeLength   = codeLength;
+    this->codeCapacity = codeCapacity;
+    this->nextRegister = nextRegister;
+    if (!result) { return 0; }
+
+    if (program->thunkCount > WAITUI_VM_MAX_BX) {
+        return waitui_vm_compiler_error(this, "program has more than %d "
+                                              "thunks",
+                                        WAITUI_VM_MAX_BX + 1);
+    }
+
+    thunks = realloc(program->thunks,
+                     (program->thunkCount + 1) * sizeof(*thunks));
+    if (!thunks) {
+        return waitui_vm_compiler_error(this, "could not allocate memory");
+    }
+    program->thunks                        = thunks;
+    program->thunks[program->thunkCount++] = thunk;
+
+    return waitui_vm_compiler_emit(
+            this, WAITUI_VM_ABX(WAITUI_VM_OP_THUNK, target,
+                                program->thunkCount - 1));
+}
+
+/**
+ * @brief Compile the argument of a lazy parameter into a thunk.
+ * @param[in,out] this The compiler
+ * @param[in] expression The argument to compile
+ * @param[in] target The register for the argument
+ * @retval 1 Ok
+ * @retval 0 Compilation failed
+ * @note Literals, this and locals are passed as they are, reading them later
+ *       gives the same value as reading them now. A lazy local passes its
+ *       thunk on, so it is still evaluated at most once.
+ */
+static int
+waitui_vm_compiler_compileLazyArgument(waitui_vm_compiler *this,
+                                       waitui_ast_expression *expression,
+                                       unsigned int target) {
+    const waitui_vm_local *local = NULL;
+
+    switch (waitui_ast_expression_getExpressionType(expression)) {
+        case WAITUI_AST_EXPRESSION_TYPE_REFERENCE:
+            local = waitui_vm_compiler_findLocal(
+                    this, &waitui_ast_reference_getValue(
+                                   (waitui_ast_reference *) expression)
+                                   ->identifier);
+            if (!local) { break; }
+            return waitui_vm_compiler_emit(
+                    this,
+                    WAITUI_VM_ABC(WAITUI_VM_OP_MOVE, target, local->reg, 0));
+        case WAITUI_AST_EXPRESSION_TYPE_INTEGER_LITERAL:
+        case WAITUI_AST_EXPRESSION_TYPE_DECIMAL_LITERAL:
+        case WAITUI_AST_EXPRESSION_TYPE_STRING_LITERAL:
+        case WAITUI_AST_EXPRESSION_TYPE_BOOLEAN_LITERAL:
+        case WAITUI_AST_EXPRESSION_TYPE_NULL_LITERAL:
+        case WAITUI_AST_EXPRESSION_TYPE_THIS_LITERAL:
+            return waitui_vm_compiler_compileExpression(this, expression,
+                                                        target);
+        default:
+            break;
+    }
+
+    return waitui_vm_compiler_compileThunk(this, expression, target);
+}
+
+/**
+ * @brief Compile the arguments into the registers following the base.
+ * @param[in,out] this The compiler
+ * @param[in] args The arguments to compile
+ * @param[in] parameterCount The number of parameters of the called function
+ * @param[in] lazyParameters Which of the first lazyCount arguments are passed
+ *                           as thunks, may be NULL
+ * @param[in] lazyCount The number of lazy parameters
+ * @retval 1 Ok
+ * @retval 0 Compilation failed
+ * @note The base has to be the last allocated register.
+ */
+static int waitui_vm_compiler_compileArgs(waitui_vm_compiler *this,
+                                          waitui_ast_expression_vector *args,
+                                          unsigned long int parameterCount,
+                                          const bool *lazyParameters,
+                                          unsigned long int lazyCount) {
+    unsigned long int argCount = waitui_ast_expression_vector_getLength(args);
+
+    if (argCount != parameterCount) {
+        return waitui_vm_compiler_error(this, "expected %lu arguments but got "
+                                              "%lu",
+                                        parameterCount, argCount);
+    }
+
+    for (unsigned long int i = 0; i < argCount; ++i) {
+        waitui_ast_expression *arg = waitui_ast_expression_vector_get(args, i);
+        unsigned int reg           = 0;
+        int result                 = 0;
+
+        if (!waitui_vm_compiler_allocRegister(this, &reg)) { return 0; }
+
+        if (i < lazyCount && lazyParameters[i]) {
+            result = waitui_vm_compiler_compileLazyArgument(this, arg, reg);
+        } else {
+            result = waitui_vm_compiler_compileExpression(this, arg, reg);
+        }
+        if (!result) { return 0; }
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Return the register to place a call in, the target if it is the last
+ *        allocated register.
+ * @param[in,out] this The compiler
+ * @param[in] target The register the value of the call goes to
+ * @param[out] base The register for the callee
+ * @retval 1 Ok
+ * @retval 0 The function needs too many registers
+ */
+static int waitui_vm_compiler_getCallBase(waitui_vm_compiler *this,
+                                          unsigned int target,
+                                          unsigned int *base) {
+    if (target + 1 == this->nextRegister) {
+        *base = target;
+        return 1;
+    }
+    return waitui_vm_compiler_allocRegister(this, base);
+}
+
+/**
+ * @brief Emit the call and move its value into the target.
+ * @param[in,out] this The compiler
+ * @param[in] opcode Either WAITUI_VM_OP_CALL or WAITUI_VM_OP_CALLSTATIC
+ * @param[in] base The register of the callee
+ * @param[in] argCount The number of arguments following the callee
+ * @param[in] word The selector or the index of the function
+ * @param[in] target The register the value of the call goes to
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ */
+static int waitui_vm_compiler_emitCall(waitui_vm_compiler *this,
+                                       waitui_vm_opcode opcode,
+                                       unsigned int base,
+                                       unsigned long int argCount,
+                                       unsigned long int word,
+                                       unsigned int target) {
+    if (!waitui_vm_compiler_emit(this,
+                                 WAITUI_VM_ABC(opcode, base, argCount, 0)) ||
+        !waitui_vm_compiler_emit(this, (waitui_vm_instruction) word)) {
+        return 0;
+    }
+
+    if (base == target) { return 1; }
+
+    return waitui_vm_compiler_emit(
+            this, WAITUI_VM_ABC(WAITUI_VM_OP_MOVE, target, base, 0));
+}
+
+/**
+ * @brief Compile the reference to a local or a field of this.
+ */
+static int waitui_vm_compiler_compileReference(waitui_vm_compiler *this,
+                                               waitui_ast_reference *reference,
+                                               unsigned int target) {
+    const str *name = &waitui_ast_reference_getValue(reference)->identifier;
+    const waitui_vm_local *local = waitui_vm_compiler_findLocal(this, name);
+    unsigned int index           = 0;
+
+    if (local) {
+        return waitui_vm_compiler_forceLocal(this, local) &&
+               waitui_vm_compiler_emit(this, WAITUI_VM_ABC(WAITUI_VM_OP_MOVE,
+                                                           target, local->reg,
+                                                           0));
+    }
+    if (waitui_vm_compiler_findField(this, name, &index)) {
+        return waitui_vm_compiler_emit(
+                this, WAITUI_VM_ABC(WAITUI_VM_OP_GETFIELD, target, 0, index));
+    }
+
+    return waitui_vm_compiler_error(this, "unknown identifier '%.*s'",
+                                    STR_FMT(name));
+}
+
+/**
+ * @brief Compile the assignment to a local or a field of this.
+ */
+static int
+waitui_vm_compiler_compileAssignment(waitui_vm_compiler *this,
+                                     waitui_ast_assignment *assignment,
+                                     unsigned int target) {
+    const str *name = &waitui_ast_assignment_getIdentifier(assignment)
+                               ->identifier;
+    waitui_vm_opcode opcode = waitui_vm_getAssignmentOpcode(
+            waitui_ast_assignment_getOperator(assignment));
+    const waitui_vm_local *local = NULL;
+    unsigned int index           = 0;
+    unsigned int reg             = 0;
+
+    if (!waitui_vm_compiler_compileExpression(
+                this, waitui_ast_assignment_getValue(assignment), target)) {
+        return 0;
+    }
+
+    local = waitui_vm_compiler_findLocal(this, name);
+    if (local) {
+        index = local->reg;
+        if (opcode == WAITUI_VM_OP_COUNT) {
+            return waitui_vm_compiler_emit(
+                    this, WAITUI_VM_ABC(WAITUI_VM_OP_MOVE, index, target, 0));
+        }
+        return waitui_vm_compiler_forceLocal(this, local) &&
+               waitui_vm_compiler_emit(
+                       this, WAITUI_VM_ABC(opcode, index, index, target)) &&
+               waitui_vm_compiler_emit(this, WAITUI_VM_ABC(WAITUI_VM_OP_MOVE,
+                                                           target, index, 0));
+    }
+
+    if (!waitui_vm_compiler_findField(this, name, &index)) {
+        return waitui_vm_compiler_error(this, "unknown identifier '%.*s'",
+                                        STR_FMT(name));
+    }
+
+    if (opcode != WAITUI_VM_OP_COUNT) {
+        if (!waitui_vm_compiler_allocRegister(this, &reg) ||
+            !waitui_vm_compiler_emit(this, WAITUI_VM_ABC(WAITUI_VM_OP_GETFIELD,
+                                                         reg, 0, index)) ||
+            !waitui_vm_compiler_emit(
+                    this, WAITUI_VM_ABC(opcode, target, reg, target))) {
+            return 0;
+        }
+    }
+
+    return waitui_vm_compiler_emit(
+            this, WAITUI_VM_ABC(WAITUI_VM_OP_SETFIELD, 0, index, target));
+}
+
+/**
+ * @brief Compile the cast into a check of the type at runtime.
+ */
+static int waitui_vm_compiler_compileCast(waitui_vm_compiler *this,
+                                          waitui_ast_cast *cast,
+                                          unsigned int target) {
+    const str *name = &waitui_ast_cast_getType(cast)->identifier;
+    waitui_vm_value_type type = WAITUI_VM_VALUE_TYPE_NULL;
+    waitui_vm_class *class    = NULL;
+
+    if (!waitui_vm_compiler_compileExpression(
+                this, waitui_ast_cast_getObject(cast), target)) {
+        return 0;
+    }
+
+    if (waitui_vm_getValueType(name, &type)) {
+        return waitui_vm_compiler_emit(
+                this, WAITUI_VM_ABC(WAITUI_VM_OP_CHECKTYPE, target, type, 0));
+    }
+
+    class = waitui_vm_compiler_findClass(this, name);
+    if (!class) {
+        return waitui_vm_compiler_error(this, "unknown type '%.*s'",
+                                        STR_FMT(name));
+    }
+    if (class->index > WAITUI_VM_MAX_BX) {
+        return waitui_vm_compiler_error(this, "program has too many classes");
+    }
+
+    return waitui_vm_compiler_emit(
+            this, WAITUI_VM_ABX(WAITUI_VM_OP_CHECKCLASS, target, class->index));
+}
+
+/**
+ * @brief Compile the let, the bindings live in registers above the target.
+ */
+static int waitui_vm_compiler_compileLet(waitui_vm_compiler *this,
+                                         waitui_ast_let *let,
+                                         unsigned int target) {
+    waitui_ast_initialization_vector *initializations =
+            waitui_ast_let_getInitializations(let);
+    unsigned long int localCount = this->localCount;
+
+    WAITUI_VECTOR_FOREACH(waitui_ast_initialization, initialization,
+                          initializations) {
+        waitui_ast_expression *value =
+                waitui_ast_initialization_getValue(initialization);
+        unsigned int reg = 0;
+
+        if (!waitui_vm_compiler_allocRegister(this, &reg)) { return 0; }
+
+        if (value) {
+            if (!waitui_vm_compiler_compileExpression(this, value, reg)) {
+                return 0;
+            }
+        } else if (!waitui_vm_compiler_emit(this,
+                                            WAITUI_VM_ABC(WAITUI_VM_OP_LOADNULL,
+                                                          reg, 0, 0))) {
+            return 0;
+        }
+
+        waitui_vm_compiler_addLocal(
+                this,
+                &waitui_ast_initialization_getIdentifier(initialization)
+                         ->identifier,
+                reg, false);
+    }
+
+    if (!waitui_vm_compiler_compileExpression(this, waitui_ast_let_getBody(let),
+                                              target)) {
+        return 0;
+    }
+
+    this->localCount = localCount;
+
+    return 1;
+}
+
+/**
+ * @brief Compile the block, its value is the value of the last expression.
+ */
+static int waitui_vm_compiler_compileBlock(waitui_vm_compiler *this,
+                                           waitui_ast_block *block,
+                                           unsigned int target) {
+    waitui_ast_expression_vector *expressions =
+            waitui_ast_block_getExpressions(block);
+
+    if (waitui_ast_expression_vector_getLength(expressions) == 0) {
+        return waitui_vm_compiler_emit(
+                this, WAITUI_VM_ABC(WAITUI_VM_OP_LOADNULL, target, 0, 0));
+    }
+
+    WAITUI_VECTOR_FOREACH(waitui_ast_expression, expression, expressions) {
+        if (!waitui_vm_compiler_compileExpression(this, expression, target)) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Compile the creation of an object and the call of its initializer.
+ */
+static int waitui_vm_compiler_compileConstructorCall(
+        waitui_vm_compiler *this, waitui_ast_constructor_call *constructorCall,
+        unsigned int target) {
+    const str *name = &waitui_ast_constructor_call_getName(constructorCall)
+                               ->identifier;
+    waitui_vm_class *class = waitui_vm_compiler_findClass(this, name);
+    unsigned int base      = 0;
+
+    if (!class) {
+        return waitui_vm_compiler_error(this, "unknown class '%.*s'",
+                                        STR_FMT(name));
+    }
+    if (class->index > WAITUI_VM_MAX_BX) {
+        return waitui_vm_compiler_error(this, "program has too many classes");
+    }
+
+    return waitui_vm_compiler_getCallBase(this, target, &base) &&
+           waitui_vm_compiler_emit(this, WAITUI_VM_ABX(WAITUI_VM_OP_NEW, base,
+                                                       class->index)) &&
+           waitui_vm_compiler_compileArgs(
+                   this, waitui_ast_constructor_call_getArgs(constructorCall),
+                   class->parameterCount, NULL, 0) &&
+           waitui_vm_compiler_emitCall(
+                   this, WAITUI_VM_OP_CALLSTATIC, base, class->parameterCount,
+                   class->initializer - this->program->functions, target);
+}
+
+/**
+ * @brief Compile the call of a function dispatched on the class of the object.
+ */
+static int
+waitui_vm_compiler_compileFunctionCall(waitui_vm_compiler *this,
+                                       waitui_ast_function_call *functionCall,
+                                       unsigned int target) {
+    const str *name = &waitui_ast_function_call_getFunctionName(functionCall)
+                               ->identifier;
+    waitui_ast_expression_vector *args =
+            waitui_ast_function_call_getArgs(functionCall);
+    unsigned long int argCount = waitui_ast_expression_vector_getLength(args);
+    waitui_vm_selector *selector = NULL;
+    unsigned int base            = 0;
+
+    selector = waitui_vm_selector_hashtable_lookup(this->selectorNames, *name);
+    if (!selector) {
+        return waitui_vm_compiler_error(this, "unknown function '%.*s'",
+                                        STR_FMT(name));
+    }
+
+    return waitui_vm_compiler_getCallBase(this, target, &base) &&
+           waitui_vm_compiler_compileExpression(
+                   this, waitui_ast_function_call_getObject(functionCall),
+                   base) &&
+           waitui_vm_compiler_compileArgs(this, args, argCount,
+                                          selector->lazyParameters,
+                                          selector->lazyCount) &&
+           waitui_vm_compiler_emitCall(this, WAITUI_VM_OP_CALL, base, argCount,
+                                       selector->index, target);
+}
+
+/**
+ * @brief Compile the call of a function of the super class, it is resolved
+ *        while compiling.
+ */
+static int waitui_vm_compiler_compileSuperFunctionCall(
+        waitui_vm_compiler *this,
+        waitui_ast_super_function_call *superFunctionCall,
+        unsigned int target) {
+    const waitui_vm_class *superClass = this->function->class->superClass;
+    const str *name =
+            &waitui_ast_super_function_call_getFunctionName(superFunctionCall)
+                     ->identifier;
+    const waitui_vm_function *function = NULL;
+    waitui_vm_selector *selector       = NULL;
+    unsigned int base                  = 0;
+
+    if (!superClass) {
+        return waitui_vm_compiler_error(this, "class has no super class");
+    }
+
+    selector = waitui_vm_selector_hashtable_lookup(this->selectorNames, *name);
+    if (selector) { function = superClass->methods[selector->index]; }
+    if (!function) {
+        return waitui_vm_compiler_error(this, "unknown super function '%.*s'",
+                                        STR_FMT(name));
+    }
+
+    return waitui_vm_compiler_getCallBase(this, target, &base) &&
+           waitui_vm_compiler_emit(
+                   this, WAITUI_VM_ABC(WAITUI_VM_OP_MOVE, base, 0, 0)) &&
+           waitui_vm_compiler_compileArgs(
+                   this,
+                   waitui_ast_super_function_call_getArgs(superFunctionCall),
+                   function->parameterCount, function->lazyParameters,
+                   function->lazyParameters ? function->parameterCount : 0) &&
+           waitui_vm_compiler_emitCall(this, WAITUI_VM_OP_CALLSTATIC, base,
+                                       function->parameterCount,
+                                       function - this->program->functions,
+                                       target);
+}
+
+/**
+ * @brief Compile the binary expression, && and || short circuit.
+ */
+static int waitui_vm_compiler_compileBinaryExpression(
+        waitui_vm_compiler *this, waitui_ast_binary_expression *expression,
+        unsigned int target) {
+    waitui_ast_binary_operator binaryOperator =
+            waitui_ast_binary_expression_getOperator(expression);
+    waitui_vm_opcode opcode = waitui_vm_getBinaryOpcode(binaryOperator);
+    unsigned long int jump  = 0;
+    unsigned int left       = 0;
+    unsigned int right      = 0;
+
+    if (opcode != WAITUI_VM_OP_COUNT) {
+        return waitui_vm_compiler_compileFirstOperand(
+                       this, waitui_ast_binary_expression_getLeft(expression),
+                       target, &left) &&
+               waitui_vm_compiler_compileOperand(
+                       this, waitui_ast_binary_expression_getRight(expression),
+                       &right) &&
+               waitui_vm_compiler_emit(
+                       this, WAITUI_VM_ABC(opcode, target, left, right));
+    }
+
+    if (binaryOperator != WAITUI_AST_BINARY_OPERATOR_DOUBLE_AND &&
+        binaryOperator != WAITUI_AST_BINARY_OPERATOR_DOUBLE_PIPE) {
+        return waitui_vm_compiler_error(this, "unknown binary operator");
+    }
+
+    return waitui_vm_compiler_compileExpression(
+                   this, waitui_ast_binary_expression_getLeft(expression),
+                   target) &&
+           waitui_vm_compiler_emitJump(
+                   this,
+                   binaryOperator == WAITUI_AST_BINARY_OPERATOR_DOUBLE_AND
+                           ? WAITUI_VM_OP_JMPIFNOT
+                           : WAITUI_VM_OP_JMPIF,
+                   target, &jump) &&
+           waitui_vm_compiler_compileExpression(
+                   this, waitui_ast_binary_expression_getRight(expression),
+                   target) &&
+           waitui_vm_compiler_patchJump(this, jump, this->codeLength);
+}
+
+/**
+ * @brief Compile the unary expression, ++ and -- update the variable.
+ */
+static int waitui_vm_compiler_compileUnaryExpression(
+        waitui_vm_compiler *this, waitui_ast_unary_expression *expression,
+        unsigned int target) {
+    waitui_ast_expression *operand =
+            waitui_ast_unary_expression_getExpression(expression);
+    waitui_vm_opcode opcode      = WAITUI_VM_OP_ADD;
+    const str *name              = NULL;
+    const waitui_vm_local *local = NULL;
+    unsigned int index           = 0;
+    unsigned int reg             = 0;
+
+    switch (waitui_ast_unary_expression_getOperator(expression)) {
+        case WAITUI_AST_UNARY_OPERATOR_MINUS:
+            return waitui_vm_compiler_compileFirstOperand(this, operand,
+                                                          target, &reg) &&
+                   waitui_vm_compiler_emit(this,
+                                           WAITUI_VM_ABC(WAITUI_VM_OP_NEG,
+                                                         target, reg, 0));
+        case WAITUI_AST_UNARY_OPERATOR_NOT:
+            return waitui_vm_compiler_compileFirstOperand(this, operand,
+                                                          target, &reg) &&
+                   waitui_vm_compiler_emit(this,
+                                           WAITUI_VM_ABC(WAITUI_VM_OP_NOT,
+                                                         target, reg, 0));
+        case WAITUI_AST_UNARY_OPERATOR_DOUBLE_MINUS:
+            opcode = WAITUI_VM_OP_SUB;
+            break;
+        case WAITUI_AST_UNARY_OPERATOR_DOUBLE_PLUS:
+            break;
+        default:
+            return waitui_vm_compiler_error(this, "unknown unary operator");
+    }
+
+    if (waitui_ast_expression_getExpressionType(operand) !=
+        WAITUI_AST_EXPRESSION_TYPE_REFERENCE) {
+        return waitui_vm_compiler_error(this, "operand of ++ and -- has to be "
+                                              "a variable");
+    }
+    name = &waitui_ast_reference_getValue((waitui_ast_reference *) operand)
+                    ->identifier;
+
+    if (!waitui_vm_compiler_allocRegister(this, &reg) ||
+        !waitui_vm_compiler_emit(
+                this, WAITUI_VM_ASBX(WAITUI_VM_OP_LOADINT, reg, 1))) {
+        return 0;
+    }
+
+    local = waitui_vm_compiler_findLocal(this, name);
+    if (local) {
+        index = local->reg;
+        return waitui_vm_compiler_forceLocal(this, local) &&
+               waitui_vm_compiler_emit(
+                       this, WAITUI_VM_ABC(opcode, index, index, reg)) &&
+               waitui_vm_compiler_emit(this, WAITUI_VM_ABC(WAITUI_VM_OP_MOVE,
+                                                           target, index, 0));
+    }
+
+    if (!waitui_vm_compiler_findField(this, name, &index)) {
+        return waitui_vm_compiler_error(this, "unknown identifier '%.*s'",
+                                        STR_FMT(name));
+    }
+
+    return waitui_vm_compiler_emit(this, WAITUI_VM_ABC(WAITUI_VM_OP_GETFIELD,
+                                                       target, 0, index)) &&
+           waitui_vm_compiler_emit(
+                   this, WAITUI_VM_ABC(opcode, target, target, reg)) &&
+           waitui_vm_compiler_emit(this, WAITUI_VM_ABC(WAITUI_VM_OP_SETFIELD, 0,
+                                                       index, target));
+}
+
+/**
+ * @brief Compile the if else, a missing else branch has the value null.
+ */
+static int waitui_vm_compiler_compileIfElse(waitui_vm_compiler *this,
+                                            waitui_ast_if_else *ifElse,
+                                            unsigned int target) {
+    waitui_ast_expression *elseBranch =
+            waitui_ast_if_else_getElseBranch(ifElse);
+    unsigned int mark          = this->nextRegister;
+    unsigned long int elseJump = 0;
+    unsigned long int endJump  = 0;
+    unsigned int condition     = 0;
+
+    if (!waitui_vm_compiler_compileOperand(
+                this, waitui_ast_if_else_getCondition(ifElse), &condition) ||
+        !waitui_vm_compiler_emitJump(this, WAITUI_VM_OP_JMPIFNOT, condition,
+                                     &elseJump)) {
+        return 0;
+    }
+    this->nextRegister = mark;
+
+    if (!waitui_vm_compiler_compileExpression(
+                this, waitui_ast_if_else_getThenBranch(ifElse), target) ||
+        !waitui_vm_compiler_emitJump(this, WAITUI_VM_OP_JMP, 0, &endJump) ||
+        !waitui_vm_compiler_patchJump(this, elseJump, this->codeLength)) {
+        return 0;
+    }
+
+    if (elseBranch) {
+        if (!waitui_vm_compiler_compileExpression(this, elseBranch, target)) {
+            return 0;
+        }
+    } else if (!waitui_vm_compiler_emit(this,
+                                        WAITUI_VM_ABC(WAITUI_VM_OP_LOADNULL,
+                                                      target, 0, 0))) {
+        return 0;
+    }
+
+    return waitui_vm_compiler_patchJump(this, endJump, this->codeLength);
+}
+
+/**
+ * @brief Compile the while, its value is null.
+ */
+static int waitui_vm_compiler_compileWhile(waitui_vm_compiler *this,
+                                           waitui_ast_while *whileExpression,
+                                           unsigned int target) {
+    unsigned long int start    = this->codeLength;
+    unsigned int mark          = this->nextRegister;
+    unsigned long int exitJump = 0;
+    unsigned long int loopJump = 0;
+    unsigned int condition     = 0;
+
+    if (!waitui_vm_compiler_compileOperand(
+                this, waitui_ast_while_getCondition(whileExpression),
+                &condition) ||
+        !waitui_vm_compiler_emitJump(this, WAITUI_VM_OP_JMPIFNOT, condition,
+                                     &exitJump)) {
+        return 0;
+    }
+    this->nextRegister = mark;
+
+    return waitui_vm_compiler_compileExpression(
+                   this, waitui_ast_while_getBody(whileExpression), target) &&
+           waitui_vm_compiler_emitJump(this, WAITUI_VM_OP_JMP, 0, &loopJump) &&
+           waitui_vm_compiler_patchJump(this, loopJump, start) &&
+           waitui_vm_compiler_patchJump(this, exitJump, this->codeLength) &&
+           waitui_vm_compiler_emit(
+                   this, WAITUI_VM_ABC(WAITUI_VM_OP_LOADNULL, target, 0, 0));
+}
+
+/**
+ * @brief Compile the literal into a load of its value.
+ */
+static int waitui_vm_compiler_compileLiteral(waitui_vm_compiler *this,
+                                             waitui_ast_expression *expression,
+                                             unsigned int target) {
+    waitui_vm_value value = {0};
+    int result            = 0;
+
+    switch (waitui_ast_expression_getExpressionType(expression)) {
+        case WAITUI_AST_EXPRESSION_TYPE_INTEGER_LITERAL:
+            result = waitui_vm_compiler_parseInteger(
+                    this,
+                    waitui_ast_integer_literal_getValue(
+                            (waitui_ast_integer_literal *) expression),
+                    &value);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_DECIMAL_LITERAL:
+            result = waitui_vm_compiler_parseDecimal(
+                    this,
+                    waitui_ast_decimal_literal_getValue(
+                            (waitui_ast_decimal_literal *) expression),
+                    &value);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_STRING_LITERAL:
+            result = waitui_vm_compiler_parseString(
+                    this,
+                    waitui_ast_string_literal_getValue(
+                            (waitui_ast_string_literal *) expression),
+                    &value);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_BOOLEAN_LITERAL:
+            return waitui_vm_compiler_emit(
+                    this, WAITUI_VM_ABC(WAITUI_VM_OP_LOADBOOL, target,
+                                        waitui_ast_boolean_literal_getValue(
+                                                (waitui_ast_boolean_literal *)
+                                                        expression),
+                                        0));
+        case WAITUI_AST_EXPRESSION_TYPE_NULL_LITERAL:
+            return waitui_vm_compiler_emit(
+                    this, WAITUI_VM_ABC(WAITUI_VM_OP_LOADNULL, target, 0, 0));
+        case WAITUI_AST_EXPRESSION_TYPE_THIS_LITERAL:
+            return waitui_vm_compiler_emit(
+                    this, WAITUI_VM_ABC(WAITUI_VM_OP_MOVE, target, 0, 0));
+        default:
+            return waitui_vm_compiler_error(this, "unsupported expression");
+    }
+
+    return result && waitui_vm_compiler_loadConstant(this, value, target);
+}
+
+/**
+ * @brief Compile the expression, its value goes to the target.
+ * @param[in,out] this The compiler
+ * @param[in] expression The expression to compile
+ * @param[in] target The register for the value of the expression
+ * @retval 1 Ok
+ * @retval 0 Compilation failed
+ * @note All registers allocated for the expression are released again. A
+ *       lazy expression is compiled in place, its value is used right where
+ *       it stands.
+ */
+static int
+waitui_vm_compiler_compileExpression(waitui_vm_compiler *this,
+                                     waitui_ast_expression *expression,
+                                     unsigned int target) {
+    unsigned int mark = this->nextRegister;
+    int result        = 0;
+
+    if (!expression) {
+        return waitui_vm_compiler_emit(
+                this, WAITUI_VM_ABC(WAITUI_VM_OP_LOADNULL, target, 0, 0));
+    }
+
+    if (this->depth == WAITUI_VM_MAX_DEPTH) {
+        return waitui_vm_compiler_error(this, "expression is nested too "
+                                              "deeply");
+    }
+    this->depth++;
+
+    switch (waitui_ast_expression_getExpressionType(expression)) {
+        case WAITUI_AST_EXPRESSION_TYPE_ASSIGNMENT:
+            result = waitui_vm_compiler_compileAssignment(
+                    this, (waitui_ast_assignment *) expression, target);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_REFERENCE:
+            result = waitui_vm_compiler_compileReference(
+                    this, (waitui_ast_reference *) expression, target);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_CAST:
+            result = waitui_vm_compiler_compileCast(
+                    this, (waitui_ast_cast *) expression, target);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_LET:
+            result = waitui_vm_compiler_compileLet(
+                    this, (waitui_ast_let *) expression, target);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_BLOCK:
+            result = waitui_vm_compiler_compileBlock(
+                    this, (waitui_ast_block *) expression, target);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_CONSTRUCTOR_CALL:
+            result = waitui_vm_compiler_compileConstructorCall(
+                    this, (waitui_ast_constructor_call *) expression, target);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_FUNCTION_CALL:
+            result = waitui_vm_compiler_compileFunctionCall(
+                    this, (waitui_ast_function_call *) expression, target);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_SUPER_FUNCTION_CALL:
+            result = waitui_vm_compiler_compileSuperFunctionCall(
+                    this, (waitui_ast_super_function_call *) expression,
+                    target);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_BINARY_EXPRESSION:
+            result = waitui_vm_compiler_compileBinaryExpression(
+                    this, (waitui_ast_binary_expression *) expression, target);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_UNARY_EXPRESSION:
+            result = waitui_vm_compiler_compileUnaryExpression(
+                    this, (waitui_ast_unary_expression *) expression, target);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_IF_ELSE:
+            result = waitui_vm_compiler_compileIfElse(
+                    this, (waitui_ast_if_else *) expression, target);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_WHILE:
+            result = waitui_vm_compiler_compileWhile(
+                    this, (waitui_ast_while *) expression, target);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_LAZY_EXPRESSION:
+            result = waitui_vm_compiler_compileExpression(
+                    this,
+                    waitui_ast_lazy_expression_getExpression(
+                            (waitui_ast_lazy_expression *) expression),
+                    target);
+            break;
+        case WAITUI_AST_EXPRESSION_TYPE_NATIVE_EXPRESSION:
+            result = waitui_vm_compiler_error(this, "native is only allowed "
+                                                    "as the body of a "
+                                                    "function");
+            break;
+        default:
+            result = waitui_vm_compiler_compileLiteral(this, expression,
+                                                       target);
+            break;
+    }
+
+    this->depth--;
+    this->nextRegister = mark;
+
+    return result;
+}
+
+/**
+ * @brief Start compiling the function, the parameters become the first locals.
+ * @param[in,out] this The compiler
+ * @param[in,out] function The function to compile
+ * @param[in] parameters The parameters of the function
+ * @retval 1 Ok
+ * @retval 0 The function has too many parameters
+ */
+static int
+waitui_vm_compiler_beginFunction(waitui_vm_compiler *this,
+                                 waitui_vm_function *function,
+                                 waitui_ast_formal_vector *parameters) {
+    unsigned long int reg = 1;
+
+    this->function        = function;
+    this->codeLength      = 0;
+    this->localCount      = 0;
+    this->nextRegister    = 1;
+    function->registerCount = 1;
+
+    if (function->parameterCount >= WAITUI_VM_MAX_REGISTERS) {
+        return waitui_vm_compiler_error(this, "function has too many "
+                                              "parameters");
+    }
+
+    WAITUI_VECTOR_FOREACH(waitui_ast_formal, parameter, parameters) {
+        waitui_vm_compiler_addLocal(
+                this, &waitui_ast_formal_getIdentifier(parameter)->identifier,
+                reg, function->lazyParameters &&
+                             function->lazyParameters[reg - 1]);
+        reg++;
+    }
+    this->nextRegister      = reg;
+    function->registerCount = reg;
+
+    return 1;
+}
+
+/**
+ * @brief Finish compiling the function by moving its code into the program.
+ * @param[in,out] this The compiler
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ */
+static int waitui_vm_compiler_endFunction(waitui_vm_compiler *this) {
+    waitui_vm_function *function = this->function;
+    waitui_vm_instruction *code  = NULL;
+
+    code = waitui_arena_alloc(this->program->arena,
+                              this->codeLength * sizeof(*code));
+    if (!code) {
+        return waitui_vm_compiler_error(this, "could not allocate memory");
+    }
+    memcpy(code, this->code, this->codeLength * sizeof(*code));
+
+    function->code       = code;
+    function->codeLength = this->codeLength;
+    this->function       = NULL;
+
+    return 1;
+}
+
+/**
+ * @brief Force the arguments the function takes strictly but other functions
+ *        with the same name take lazily, those may arrive as thunks.
+ * @param[in,out] this The compiler
+ * @param[in] function The function being compiled
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ */
+static int waitui_vm_compiler_forceArgs(waitui_vm_compiler *this,
+                                        const waitui_vm_function *function) {
+    const waitui_vm_selector *selector =
+            waitui_vm_selector_hashtable_lookup(this->selectorNames,
+                                                function->name);
+
+    for (unsigned long int i = 0;
+         i < selector->lazyCount && i < function->parameterCount; ++i) {
+        if (!selector->lazyParameters[i] ||
+            (function->lazyParameters && function->lazyParameters[i])) {
+            continue;
+        }
+        if (!waitui_vm_compiler_emit(
+                    this, WAITUI_VM_ABC(WAITUI_VM_OP_FORCE, i + 1, 0, 0))) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Bind the native function to its C function and call it.
+ * @param[in,out] this The compiler
+ * @param[in,out] function The native function being compiled
+ * @retval 1 Ok
+ * @retval 0 The function is not bound or memory allocation failed
+ */
+static int waitui_vm_compiler_compileNative(waitui_vm_compiler *this,
+                                            waitui_vm_function *function) {
+    const waitui_vm_native *native = waitui_vm_natives_lookup(
+            this->natives, function->class->name, function->name);
+
+    if (!native) {
+        return waitui_vm_compiler_error(this, "unknown native function "
+                                              "'%.*s.%.*s'",
+                                        STR_FMT(&function->class->name),
+                                        STR_FMT(&function->name));
+    }
+    if (native->parameterCount != function->parameterCount) {
+        return waitui_vm_compiler_error(this, "native function '%.*s' takes "
+                                              "%lu arguments",
+                                        STR_FMT(&native->name),
+                                        native->parameterCount);
+    }
+    function->native = native->function;
+
+    return waitui_vm_compiler_emit(
+                   this, WAITUI_VM_ABC(WAITUI_VM_OP_NATIVE, 0, 0, 0)) &&
+           waitui_vm_compiler_emit(
+                   this, WAITUI_VM_ABC(WAITUI_VM_OP_RETURN, 0, 0, 0));
+}
+
+/**
+ * @brief Compile the function of a class.
+ * @param[in,out] this The compiler
+ * @param[in,out] function The function to compile
+ * @param[in] astFunction The function to compile from
+ * @retval 1 Ok
+ * @retval 0 Compilation failed
+ */
+static int
+waitui_vm_compiler_compileFunction(waitui_vm_compiler *this,
+                                   waitui_vm_function *function,
+                                   waitui_ast_function *astFunction) {
+    waitui_ast_expression *body = waitui_ast_function_getBody(astFunction);
+    unsigned int target         = 0;
+
+    if (body && waitui_ast_expression_getExpressionType(body) ==
+                        WAITUI_AST_EXPRESSION_TYPE_NATIVE_EXPRESSION) {
+        return waitui_vm_compiler_beginFunction(
+                       this, function,
+                       waitui_ast_function_getParameters(astFunction)) &&
+               waitui_vm_compiler_forceArgs(this, function) &&
+               waitui_vm_compiler_compileNative(this, function) &&
+               waitui_vm_compiler_endFunction(this);
+    }
+
+    return waitui_vm_compiler_beginFunction(
+                   this, function,
+                   waitui_ast_function_getParameters(astFunction)) &&
+           waitui_vm_compiler_forceArgs(this, function) &&
+           waitui_vm_compiler_allocRegister(this, &target) &&
+           waitui_vm_compiler_compileExpression(this, body, target) &&
+           waitui_vm_compiler_emit(
+                   this, WAITUI_VM_ABC(WAITUI_VM_OP_RETURN, target, 0, 0)) &&
+           waitui_vm_compiler_endFunction(this);
+}
+
+/**
+ * @brief Compile the initializer of a class.
+ * @param[in,out] this The compiler
+ * @param[in,out] function The initializer to compile
+ * @retval 1 Ok
+ * @retval 0 Compilation failed
+ * @note The initializer calls the initializer of the super class, stores the
+ *       parameters in their fields and evaluates the values of the
+ *       properties in order, it returns this. As the parameters are stored
+ *       right away, lazy parameters of a class are evaluated eagerly.
+ */
+static int waitui_vm_compiler_compileInitializer(waitui_vm_compiler *this,
+                                                 waitui_vm_function *function) {
+    const waitui_vm_class *class = function->class;
+    waitui_ast_class *astClass   = this->astClasses[class->index];
+    unsigned long int field = class->superClass ? class->superClass->fieldCount
+                                                : 0;
+    unsigned int reg        = 0;
+
+    if (!waitui_vm_compiler_beginFunction(
+                this, function, waitui_ast_class_getParameters(astClass))) {
+        return 0;
+    }
+
+    if (class->superClass) {
+        const waitui_vm_function *initializer = class->superClass->initializer;
+        waitui_ast_expression_vector *args =
+                waitui_ast_class_getSuperClassArgs(astClass);
+
+        if (!waitui_vm_compiler_allocRegister(this, &reg) ||
+            !waitui_vm_compiler_emit(
+                    this, WAITUI_VM_ABC(WAITUI_VM_OP_MOVE, reg, 0, 0)) ||
+            !waitui_vm_compiler_compileArgs(
+                    this, args, initializer->parameterCount, NULL, 0) ||
+            !waitui_vm_compiler_emitCall(this, WAITUI_VM_OP_CALLSTATIC, reg,
+                                         initializer->parameterCount,
+                                         initializer - this->program->functions,
+                                         reg)) {
+            return 0;
+        }
+        this->nextRegister = reg;
+    }
+
+    for (unsigned long int i = 0; i < class->parameterCount; ++i) {
+        if (!waitui_vm_compiler_emit(
+                    this, WAITUI_VM_ABC(WAITUI_VM_OP_SETFIELD, 0, field++,
+                                        i + 1))) {
+            return 0;
+        }
+    }
+
+    WAITUI_VECTOR_FOREACH(waitui_ast_property, property,
+                          waitui_ast_class_getProperties(astClass)) {
+        waitui_ast_expression *value = waitui_ast_property_getValue(property);
+
+        if (value) {
+            if (!waitui_vm_compiler_allocRegister(this, &reg) ||
+                !waitui_vm_compiler_compileExpression(this, value, reg) ||
+                !waitui_vm_compiler_emit(
+                        this,
+                        WAITUI_VM_ABC(WAITUI_VM_OP_SETFIELD, 0, field, reg))) {
+                return 0;
+            }
+            this->nextRegister = reg;
+        }
+        field++;
+    }
+
+    return waitui_vm_compiler_emit(
+                   this, WAITUI_VM_ABC(WAITUI_VM_OP_RETURN, 0, 0, 0)) &&
+           waitui_vm_compiler_endFunction(this);
+}
+
+/**
+ * @brief Collect the classes of the module.
+ * @param[in] module The AST of the module to collect the classes of
+ * @param[in,out] args The compiler
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ */
+static int waitui_vm_compiler_collectClasses(waitui_ast *module, void *args) {
+    waitui_vm_compiler *this = args;
+
+    WAITUI_VECTOR_FOREACH(
+            waitui_ast_namespace, namespace,
+            waitui_ast_program_getNamespaces(waitui_ast_getProgram(module))) {
+        WAITUI_VECTOR_FOREACH(waitui_ast_class, class,
+                              waitui_ast_namespace_getClasses(namespace)) {
+            if (this->astClassCount == this->astClassCapacity) {
+                unsigned long int capacity = this->astClassCapacity * 2;
+                waitui_ast_class **classes = NULL;
+
+                if (!capacity) { capacity = WAITUI_VM_INITIAL_CAPACITY; }
+
+                classes = realloc(this->astClasses,
+                                  capacity * sizeof(*classes));
+                if (!classes) { return 0; }
+
+                this->astClasses       = classes;
+                this->astClassCapacity = capacity;
+            }
+
+            this->astClasses[this->astClassCount++] = class;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Create the classes, selectors and functions of the program.
+ * @param[in,out] this The compiler
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed or a class is defined twice
+ */
+static int waitui_vm_compiler_createClasses(waitui_vm_compiler *this) {
+    waitui_vm_program *program       = this->program;
+    unsigned long int functionCount  = this->astClassCount;
+
+    for (unsigned long int i = 0; i < this->astClassCount; ++i) {
+        functionCount += waitui_ast_function_vector_getLength(
+                waitui_ast_class_getFunctions(this->astClasses[i]));
+    }
+
+    program->classes   = waitui_arena_alloc(
+            program->arena,
+            (this->astClassCount + 1) * sizeof(*program->classes));
+    program->functions = waitui_arena_alloc(
+            program->arena, (functionCount + 1) * sizeof(*program->functions));
+    program->selectors = waitui_arena_alloc(
+            program->arena, (functionCount + 1) * sizeof(*program->selectors));
+    this->astFunctions = calloc(functionCount + 1, sizeof(*this->astFunctions));
+    this->layoutStates =
+            calloc(this->astClassCount + 1, sizeof(*this->layoutStates));
+    if (!program->classes || !program->functions || !program->selectors ||
+        !this->astFunctions || !this->layoutStates) {
+        return waitui_vm_compiler_error(this, "could not allocate memory");
+    }
+    program->classCount = this->astClassCount;
+
+    for (unsigned long int i = 0; i < this->astClassCount; ++i) {
+        waitui_vm_class *class = &program->classes[i];
+
+        if (!waitui_arena_copyStr(
+                    program->arena, &class->name,
+                    &waitui_ast_class_getName(this->astClasses[i])
+                             ->identifier)) {
+            return waitui_vm_compiler_error(this, "could not allocate memory");
+        }
+        class->index = i;
+
+        if (waitui_vm_class_hashtable_has(this->classNames, class->name)) {
+            return waitui_vm_compiler_error(this, "class '%.*s' is defined "
+                                                  "more than once",
+                                            STR_FMT(&class->name));
+        }
+        if (!waitui_vm_class_hashtable_insert(this->classNames, class->name,
+                                              class)) {
+            return waitui_vm_compiler_error(this, "could not allocate memory");
+        }
+
+        WAITUI_VECTOR_FOREACH(
+                waitui_ast_function, function,
+                waitui_ast_class_getFunctions(this->astClasses[i])) {
+            const str *name =
+                    &waitui_ast_function_getFunctionName(function)->identifier;
+            waitui_vm_selector *selector = NULL;
+
+            if (waitui_vm_selector_hashtable_has(this->selectorNames, *name)) {
+                continue;
+            }
+
+            selector = waitui_arena_alloc(program->arena, sizeof(*selector));
+            if (!selector ||
+                !waitui_arena_copyStr(
+                        program->arena,
+                        &program->selectors[program->selectorCount], name)) {
+                return waitui_vm_compiler_error(this,
+                                                "could not allocate memory");
+            }
+            selector->index = program->selectorCount++;
+
+            if (!waitui_vm_selector_hashtable_insert(
+                        this->selectorNames,
+                        program->selectors[selector->index], selector)) {
+                return waitui_vm_compiler_error(this,
+                                                "could not allocate memory");
+            }
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Return whether evaluating the expression reads the variable with the
+ *        name before it evaluates anything else.
+ * @param[in] expression The expression to check
+ * @param[in] name The name of the variable
+ * @return true if the variable is read first
+ * @note A native function reads all of its arguments before it is called.
+ */
+static bool waitui_vm_isReadFirst(waitui_ast_expression *expression,
+                                  const str *name) {
+    while (expression) {
+        switch (waitui_ast_expression_getExpressionType(expression)) {
+            case WAITUI_AST_EXPRESSION_TYPE_REFERENCE:
+                return STR_EQUALS(&waitui_ast_reference_getValue(
+                                           (waitui_ast_reference *) expression)
+                                           ->identifier,
+                                  name);
+            case WAITUI_AST_EXPRESSION_TYPE_ASSIGNMENT:
+                expression = waitui_ast_assignment_getValue(
+                        (waitui_ast_assignment *) expression);
+                break;
+            case WAITUI_AST_EXPRESSION_TYPE_CAST:
+                expression = waitui_ast_cast_getObject(
+                        (waitui_ast_cast *) expression);
+                break;
+            case WAITUI_AST_EXPRESSION_TYPE_LET: {
+                waitui_ast_initialization_vector *initializations =
+                        waitui_ast_let_getInitializations(
+                                (waitui_ast_let *) expression);
+
+                if (waitui_ast_initialization_vector_getLength(
+                            initializations) == 0) {
+                    return false;
+                }
+                expression = waitui_ast_initialization_getValue(
+                        waitui_ast_initialization_vector_get(initializations,
+                                                             0));
+                break;
+            }
+            case WAITUI_AST_EXPRESSION_TYPE_BLOCK: {
+                waitui_ast_expression_vector *expressions =
+                        waitui_ast_block_getExpressions(
+                                (waitui_ast_block *) expression);
+
+                if (waitui_ast_expression_vector_getLength(expressions) == 0) {
+                    return false;
+                }
+                expression = waitui_ast_expression_vector_get(expressions, 0);
+                break;
+            }
+            case WAITUI_AST_EXPRESSION_TYPE_FUNCTION_CALL:
+                expression = waitui_ast_function_call_getObject(
+                        (waitui_ast_function_call *) expression);
+                break;
+            case WAITUI_AST_EXPRESSION_TYPE_BINARY_EXPRESSION:
+                expression = waitui_ast_binary_expression_getLeft(
+                        (waitui_ast_binary_expression *) expression);
+                break;
+            case WAITUI_AST_EXPRESSION_TYPE_UNARY_EXPRESSION:
+                expression = waitui_ast_unary_expression_getExpression(
+                        (waitui_ast_unary_expression *) expression);
+                break;
+            case WAITUI_AST_EXPRESSION_TYPE_IF_ELSE:
+                expression = waitui_ast_if_else_getCondition(
+                        (waitui_ast_if_else *) expression);
+                break;
+            case WAITUI_AST_EXPRESSION_TYPE_WHILE:
+                expression = waitui_ast_while_getCondition(
+                        (waitui_ast_while *) expression);
+                break;
+            case WAITUI_AST_EXPRESSION_TYPE_LAZY_EXPRESSION:
+                expression = waitui_ast_lazy_expression_getExpression(
+                        (waitui_ast_lazy_expression *) expression);
+                break;
+            case WAITUI_AST_EXPRESSION_TYPE_NATIVE_EXPRESSION:
+                return true;
+            default:
+                return false;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Set which parameters the function takes as thunks and add them to
+ *        the lazy parameters of its selector.
+ * @param[in,out] this The compiler
+ * @param[in,out] function The function of the class
+ * @param[in,out] selector The selector of the function
+ * @param[in] astFunction The function to take the parameters from
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed
+ * @note A lazy parameter the body reads before anything else is taken
+ *       strictly, its thunk would be forced right away. Its argument is then
+ *       evaluated at the call in order with the others, before the strict
+ *       arguments after it instead of after all of them, so the side effects
+ *       of the arguments happen in another order than with a thunk.
+ */
+static int
+waitui_vm_compiler_setLazyParameters(waitui_vm_compiler *this,
+                                     waitui_vm_function *function,
+                                     waitui_vm_selector *selector,
+                                     waitui_ast_function *astFunction) {
+    waitui_ast_expression *body = waitui_ast_function_getBody(astFunction);
+    unsigned long int count     = function->parameterCount;
+    bool *lazyParameters        = NULL;
+    unsigned long int i         = 0;
+
+    WAITUI_VECTOR_FOREACH(waitui_ast_formal, parameter,
+                          waitui_ast_function_getParameters(astFunction)) {
+        if (waitui_ast_formal_isLazy(parameter) &&
+            !waitui_vm_isReadFirst(
+                    body,
+                    &waitui_ast_formal_getIdentifier(parameter)->identifier)) {
+            if (!lazyParameters) {
+                lazyParameters = waitui_arena_alloc(
+                        this->program->arena, count * sizeof(*lazyParameters));
+                if (!lazyParameters) {
+                    return waitui_vm_compiler_error(
+                            this, "could not allocate memory");
+                }
+            }
+            lazyParameters[i] = true;
+        }
+        i++;
+    }
+    if (!lazyParameters) { return 1; }
+    function->lazyParameters = lazyParameters;
+
+    if (selector->lazyCount < count) {
+        bool *selectorParameters = waitui_arena_alloc(
+                this->program->arena, count * sizeof(*selectorParameters));
+
+        if (!selectorParameters) {
+            return waitui_vm_compiler_error(this, "could not allocate memory");
+        }
+        if (selector->lazyCount) {
+            memcpy(selectorParameters, selector->lazyParameters,
+                   selector->lazyCount * sizeof(*selectorParameters));
+        }
+        selector->lazyParameters = selectorParameters;
+        selector->lazyCount      = count;
+    }
+    for (i = 0; i < count; ++i) {
+        selector->lazyParameters[i] |= lazyParameters[i];
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Lay out the fields and methods of the class after its super class.
+ * @param[in,out] this The compiler
+ * @param[in,out] class The class to lay out
+ * @retval 1 Ok
+ * @retval 0 Memory allocation failed or the super class is unknown or cyclic
+ */
+static int waitui_vm_compiler_layoutClass(waitui_vm_compiler *this,
+                                          waitui_vm_class *class) {
+    waitui_vm_program *program     = this->program;
+    waitui_ast_class *astClass     = this->astClasses[class->index];
+    symbol *superClassName         = waitui_ast_class_getSuperClass(astClass);
+    waitui_ast_formal_vector *parameters =
+            waitui_ast_class_getParameters(astClass);
+    waitui_ast_property_vector *properties =
+            waitui_ast_class_getProperties(astClass);
+    waitui_vm_function *initializer = NULL;
+    waitui_vm_class *superClass     = NULL;
+    unsigned long int field         = 0;
+
+    if (this->layoutStates[class->index] == WAITUI_VM_LAYOUT_STATE_DONE) {
+        return 1;
+    }
+    if (this->layoutStates[class->index] == WAITUI_VM_LAYOUT_STATE_ACTIVE) {
+        return waitui_vm_compiler_error(this, "class '%.*s' inherits from "
+                                              "itself",
+                                        STR_FMT(&class->name));
+    }
+    this->layoutStates[class->index] = WAITUI_VM_LAYOUT_STATE_ACTIVE;
+
+    if (superClassName) {
+        superClass = waitui_vm_compiler_findClass(this,
+                                                  &superClassName->identifier);
+        if (!superClass) {
+            return waitui_vm_compiler_error(
+                    this, "unknown super class '%.*s' of class '%.*s'",
+                    STR_FMT(&superClassName->identifier),
+                    STR_FMT(&class->name));
+        }
+        if (!waitui_vm_compiler_layoutClass(this, superClass)) { return 0; }
+        class->superClass = superClass;
+        field             = superClass->fieldCount;
+    }
+
+    class->parameterCount = waitui_ast_formal_vector_getLength(parameters);
+    class->fieldCount     = field + class->parameterCount +
+                        waitui_ast_property_vector_getLength(properties);
+    if (class->fieldCount > WAITUI_VM_MAX_A + 1) {
+        return waitui_vm_compiler_error(this, "class '%.*s' has more than %d "
+                                              "fields",
+                                        STR_FMT(&class->name),
+                                        WAITUI_VM_MAX_A + 1);
+    }
+
+    class->fieldNames = waitui_arena_alloc(
+            program->arena, (class->fieldCount + 1) * sizeof(str));
+    class->methods    = waitui_arena_alloc(
+            program->arena,
+            (program->selectorCount + 1) * sizeof(*class->methods));
+    if (!class->fieldNames || !class->methods) {
+        return waitui_vm_compiler_error(this, "could not allocate memory");
+    }
+    if (superClass) {
+        memcpy(class->fieldNames, superClass->fieldNames,
+               field * sizeof(str));
+        memcpy(class->methods, superClass->methods,
+               program->selectorCount * sizeof(*class->methods));
+    }
+
+    WAITUI_VECTOR_FOREACH(waitui_ast_formal, parameter, parameters) {
+        if (!waitui_arena_copyStr(
+                    program->arena, &class->fieldNames[field++],
+                    &waitui_ast_formal_getIdentifier(parameter)->identifier)) {
+            return waitui_vm_compiler_error(this, "could not allocate memory");
+        }
+    }
+    WAITUI_VECTOR_FOREACH(waitui_ast_property, property, properties) {
+        if (!waitui_arena_copyStr(
+                    program->arena, &class->fieldNames[field++],
+                    &waitui_ast_property_getName(property)->identifier)) {
+            return waitui_vm_compiler_error(this, "could not allocate memory");
+        }
+    }
+
+    initializer                 = &program->functions[this->nextFunction++];
+    initializer->name           = class->name;
+    initializer->class          = class;
+    initializer->parameterCount = class->parameterCount;
+    class->initializer          = initializer;
+
+    WAITUI_VECTOR_FOREACH(waitui_ast_function, astFunction,
+                          waitui_ast_class_getFunctions(astClass)) {
+        const str *name =
+                &waitui_ast_function_getFunctionName(astFunction)->identifier;
+        waitui_vm_selector *selector = waitui_vm_selector_hashtable_lookup(
+                this->selectorNames, *name);
+        waitui_vm_function *function = NULL;
+
+        if (waitui_ast_function_isAbstract(astFunction)) { continue; }
+
+        function                 = &program->functions[this->nextFunction];
+        function->name           = program->selectors[selector->index];
+        function->class          = class;
+        function->parameterCount = waitui_ast_formal_vector_getLength(
+                waitui_ast_function_getParameters(astFunction));
+        class->methods[selector->index] = function;
+
+        if (!waitui_vm_compiler_setLazyParameters(this, function, selector,
+                                                  astFunction)) {
+            return 0;
+        }
+
+        this->astFunctions[this->nextFunction++] = astFunction;
+    }
+
+    this->layoutStates[class->index] = WAITUI_VM_LAYOUT_STATE_DONE;
+
+    return 1;
+}
+
+/**
+ * @brief Destroy the compiler but not the program.
+ * @param[in,out] this The compiler to destroy
+ */
+static void waitui_vm_compiler_destroy(waitui_vm_compiler *this) {
+    waitui_vm_class_hashtable_destroy(&this->classNames);
+    waitui_vm_selector_hashtable_destroy(&this->selectorNames);
+    free(this->astClasses);
+    free(this->layoutStates);
+    free(this->astFunctions);
+    free(this->code);
+}
+
+
+// -----------------------------------------------------------------------------
+//  Public functions
+// -----------------------------------------------------------------------------
+
+waitui_vm_program *waitui_vm_program_compile(waitui_ast *ast,
+                                             const waitui_vm_natives *natives,
+                                             FILE *diagnostics) {
+    waitui_vm_compiler compiler = {0};
+    waitui_vm_program *program  = NULL;
+    int result                  = 0;
+
+    if (!ast) { return NULL; }
+
+    program = calloc(1, sizeof(*program));
+    if (!program) { return NULL; }
+
+    program->arena         = waitui_arena_new();
+    compiler.program       = program;
+    compiler.natives       = natives;
+    compiler.diagnostics   = diagnostics ? diagnostics : stderr;
+    compiler.classNames    = waitui_vm_class_hashtable_new(64);
+    compiler.selectorNames = waitui_vm_selector_hashtable_new(64);
+    if (!program->arena || !compiler.classNames || !compiler.selectorNames) {
+        waitui_vm_compiler_error(&compiler, "could not allocate memory");
+        goto done;
+    }
+
+    // every module is collected once, even if it is imported many times
+    if (!waitui_ast_forEachModule(ast, waitui_vm_compiler_collectClasses,
+                                  &compiler)) {
+        waitui_vm_compiler_error(&compiler, "could not allocate memory");
+        goto done;
+    }
+    if (!waitui_vm_compiler_createClasses(&compiler)) { goto done; }
+
+    for (unsigned long int i = 0; i < program->classCount; ++i) {
+        if (!waitui_vm_compiler_layoutClass(&compiler, &program->classes[i])) {
+            goto done;
+        }
+    }
+    program->functionCount = compiler.nextFunction;
+
+    for (unsigned long int i = 0; i < program->functionCount; ++i) {
+        waitui_vm_function *function = &program->functions[i];
+
+        if (compiler.astFunctions[i]) {
+            result = waitui_vm_compiler_compileFunction(
+                    &compiler, function, compiler.astFunctions[i]);
+        } else {
+            result = waitui_vm_compiler_compileInitializer(&compiler,
+                                                           function);
+        }
+        if (!result) { goto done; }
+    }
+
+done:
+    waitui_vm_compiler_destroy(&compiler);
+    if (!result) { waitui_vm_program_destroy(&program); }
+
+    return program;
+}
+
+void waitui_vm_program_destroy(waitui_vm_program **this) {
+    if (!this || !(*this)) { return; }
+
+    waitui_arena_destroy(&(*this)->arena);
+    free((*this)->thunks);
+    free((*this)->constants);
+    free(*this);
+    *this = NULL;
+}
+
+const waitui_vm_class *
+waitui_vm_program_getClass(const waitui_vm_program *this, str name) {
+    if (!this) { return NULL; }
+
+    for (unsigned long int i = 0; i < this->classCount; ++i) {
+        if (STR_EQUALS(&this->classes[i].name, &name)) {
+            return &this->classes[i];
+        }
+    }
+    return NULL;
+}
+
+int waitui_vm_program_getSelector(const waitui_vm_program *this, str name,
+                                  unsigned long int *selector) {
+    if (!this || !selector) { return 0; }
+
+    for (unsigned long int i = 0; i < this->selectorCount; ++i) {
+        if (STR_EQUALS(&this->selectors[i], &name)) {
+            *selector = i;
+            return 1;
+        }
+    }
+    return 0;
+}
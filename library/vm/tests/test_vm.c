@@ -0,0 +1,351 @@
+/**
+ * @file test_vm.c
+ * @author rick
+ * @date 17.10.26
+ * @brief Test for the VM implementation
+ */
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <cmocka.h>
+
+#include "waitui/vm.h"
+
+#include <waitui/log.h>
+#include <waitui/parser.h>
+#include <waitui/vm_natives.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct output {
+    char *data;
+    size_t size;
+} output;
+
+static const char source[] =
+        "namespace org.test\n"
+        "\n"
+        "class Base {\n"
+        "    public func value(): Int = 1\n"
+        "    public func name(): String = \"base\"\n"
+        "    public func describe(): String = this.name() ~ \"!\"\n"
+        "}\n"
+        "\n"
+        "class Main extends Base {\n"
+        "    var count: Int = 0\n"
+        "\n"
+        "    overwrite public func value(): Int = super.value() + 10\n"
+        "    overwrite public func name(): String = \"main\"\n"
+        "    public func dispatch(): String = this.describe()\n"
+        "    public func base(): String = new Base().describe()\n"
+        "    public func fact(n: Int): Int =\n"
+        "        if (n <= 1) 1 else n * this.fact(n - 1)\n"
+        "    public func calls(): Int = this.fact(10) + this.value()\n"
+        "\n"
+        "    public func fail(): Boolean = 1 / 0 == 0\n"
+        "    public func and(): Boolean = false && this.fail()\n"
+        "    public func or(): Boolean = true || this.fail()\n"
+        "    public func both(): Boolean = true && !false\n"
+        "    public func either(): Boolean = false || this.fail()\n"
+        "\n"
+        "    public func ifThen(): Int = if (1 < 2) 1 else 2\n"
+        "    public func ifElse(): Int = if (1 < 2 && false) 1 else 2\n"
+        "    public func ifNoElse(): Int = if (false) 1\n"
+        "    public func loop(): Int = let i: Int = 0, sum: Int = 0 in {\n"
+        "        while (i < 10) {\n"
+        "            sum += i\n"
+        "            ++i\n"
+        "        }\n"
+        "        sum\n"
+        "    }\n"
+        "    public func loopValue(): Int = while (count < 3) ++count\n"
+        "\n"
+        "    public func min(): Int = -9223372036854775807 - 1\n"
+        "    public func minDiv(): Int = this.min() / -1\n"
+        "    public func minMod(): Int = this.min() % -1\n"
+        "    public func wrap(): Int = 9223372036854775807 + 1\n"
+        "    public func div(): Int = -7 / 2\n"
+        "    public func mod(): Int = -7 % 2\n"
+        "    public func decimalDiv(): Decimal = 7 / 2.0\n"
+        "    public func divZero(): Int = 1 / 0\n"
+        "    public func modZero(): Int = 1 % 0\n"
+        "\n"
+        "    public func tick(): Int = native;\n"
+        "    public func pick(take: Boolean, lazy x: Int): Int =\n"
+        "        if (take) x + x else 0\n"
+        "    public func first(lazy x: Int, y: Int): Int = x * 100 + y\n"
+        "    public func forcedOnce(): Int = this.pick(true, this.tick())\n"
+        "    public func neverForced(): Int = this.pick(false, this.tick())\n"
+        "    public func readFirst(): Int =\n"
+        "        this.first(this.tick(), this.tick())\n"
+        "    public func captured(): Int = let a: Int = 1 in {\n"
+        "        this.pick(true, a += 1) * 10 + a\n"
+        "    }\n"
+        "}\n";
+
+static waitui_ast *ast = NULL;
+
+static waitui_vm_program *program = NULL;
+
+static waitui_vm *vm = NULL;
+
+static int64_t tickCount = 0;
+
+/**
+ * The native function Main.tick, count how often it is called.
+ */
+static int native_tick(waitui_vm *tickVm, waitui_vm_value *registers) {
+    (void) tickVm; /* unused */
+
+    registers[0].type       = WAITUI_VM_VALUE_TYPE_INTEGER;
+    registers[0].as.integer = ++tickCount;
+
+    return 1;
+}
+
+static int setup(void **state) {
+    str sourceFileName         = STR_STATIC_INIT("test_vm.wai");
+    str sourceText             = STR_NULL_INIT;
+    str workDirectory          = STR_STATIC_INIT("/tmp");
+    str tickName               = STR_STATIC_INIT("Main.tick");
+    waitui_vm_natives *natives = NULL;
+    parser *parser             = NULL;
+
+    (void) state; /* unused */
+
+    waitui_log_setQuiet(true);
+
+    sourceText.s   = (char *) source;
+    sourceText.len = sizeof(source) - 1;
+
+    parser = parser_new_from_source(sourceFileName, sourceText, workDirectory,
+                                    0);
+    if (!parser) { return -1; }
+    if (parser_parse(parser)) { ast = parser_get_ast(parser); }
+    parser_destroy(&parser);
+    if (!ast) { return -1; }
+
+    natives = waitui_vm_natives_new();
+    if (!natives) { return -1; }
+    if (waitui_vm_natives_register(natives, tickName, 0, native_tick)) {
+        program = waitui_vm_program_compile(ast, natives, stderr);
+    }
+    waitui_vm_natives_destroy(&natives);
+    if (!program) { return -1; }
+
+    // the strings and objects of the results live in the heap of the VM
+    vm = waitui_vm_new(program);
+
+    return vm ? 0 : -1;
+}
+
+static int teardown(void **state) {
+    (void) state; /* unused */
+
+    waitui_vm_destroy(&vm);
+    waitui_vm_program_destroy(&program);
+    ast_destroy(&ast);
+
+    return 0;
+}
+
+/**
+ * Run the function of the class Main and return whether it succeeded, the
+ * errors are written to the diagnostics.
+ */
+static int run(const char *functionName, waitui_vm_value *result,
+               output *diagnostics) {
+    str className       = STR_STATIC_INIT("Main");
+    str functionNameStr = STR_NULL_INIT;
+    FILE *file          = NULL;
+    int success         = 0;
+
+    functionNameStr.s   = (char *) functionName;
+    functionNameStr.len = strlen(functionName);
+
+    *diagnostics = (output){0};
+    file         = open_memstream(&diagnostics->data, &diagnostics->size);
+    assert_non_null(file);
+
+    success = waitui_vm_run(vm, className, functionNameStr, result, file);
+    fclose(file);
+
+    return success;
+}
+
+static int64_t run_integer(const char *functionName) {
+    waitui_vm_value result = {0};
+    output diagnostics     = {0};
+
+    assert_true(run(functionName, &result, &diagnostics));
+    assert_int_equal(diagnostics.size, 0);
+    free(diagnostics.data);
+    assert_int_equal(result.type, WAITUI_VM_VALUE_TYPE_INTEGER);
+
+    return result.as.integer;
+}
+
+static bool run_boolean(const char *functionName) {
+    waitui_vm_value result = {0};
+    output diagnostics     = {0};
+
+    assert_true(run(functionName, &result, &diagnostics));
+    assert_int_equal(diagnostics.size, 0);
+    free(diagnostics.data);
+    assert_int_equal(result.type, WAITUI_VM_VALUE_TYPE_BOOLEAN);
+
+    return result.as.boolean;
+}
+
+static void assert_run_string(const char *functionName, const char *expected) {
+    waitui_vm_value result = {0};
+    output diagnostics     = {0};
+
+    assert_true(run(functionName, &result, &diagnostics));
+    assert_int_equal(diagnostics.size, 0);
+    free(diagnostics.data);
+    assert_int_equal(result.type, WAITUI_VM_VALUE_TYPE_STRING);
+    assert_int_equal(result.as.string->len, strlen(expected));
+    assert_memory_equal(result.as.string->s, expected, strlen(expected));
+}
+
+static void assert_run_fails(const char *functionName, const char *error) {
+    waitui_vm_value result = {0};
+    output diagnostics     = {0};
+
+    assert_false(run(functionName, &result, &diagnostics));
+    assert_non_null(diagnostics.data);
+    assert_non_null(strstr(diagnostics.data, error));
+    free(diagnostics.data);
+}
+
+static void test_vm_calls(void **state) {
+    (void) state; /* unused */
+
+    assert_int_equal(run_integer("calls"), 3628800 + 11);
+    assert_run_fails("fact", "has parameters");
+    assert_run_fails("missing", "unknown function 'missing'");
+}
+
+static void test_vm_dispatch(void **state) {
+    (void) state; /* unused */
+
+    // the function of the super class calls the overwritten one
+    assert_run_string("dispatch", "main!");
+    assert_run_string("base", "base!");
+}
+
+static void test_vm_super_call(void **state) {
+    (void) state; /* unused */
+
+    assert_int_equal(run_integer("value"), 11);
+}
+
+static void test_vm_short_circuit(void **state) {
+    (void) state; /* unused */
+
+    // the right operand would fail if it was evaluated
+    assert_false(run_boolean("and"));
+    assert_true(run_boolean("or"));
+    assert_true(run_boolean("both"));
+    assert_run_fails("either", "ERROR: Main.fail: division by zero");
+}
+
+static void test_vm_if_and_while(void **state) {
+    (void) state; /* unused */
+
+    waitui_vm_value result = {0};
+    output diagnostics     = {0};
+
+    assert_int_equal(run_integer("ifThen"), 1);
+    assert_int_equal(run_integer("ifElse"), 2);
+    assert_int_equal(run_integer("loop"), 45);
+
+    // without an else branch and as a while the value is null
+    result.type = WAITUI_VM_VALUE_TYPE_INTEGER;
+    assert_true(run("ifNoElse", &result, &diagnostics));
+    assert_int_equal(result.type, WAITUI_VM_VALUE_TYPE_NULL);
+    free(diagnostics.data);
+
+    result.type = WAITUI_VM_VALUE_TYPE_INTEGER;
+    assert_true(run("loopValue", &result, &diagnostics));
+    assert_int_equal(result.type, WAITUI_VM_VALUE_TYPE_NULL);
+    free(diagnostics.data);
+}
+
+static void test_vm_arithmetic(void **state) {
+    (void) state; /* unused */
+
+    waitui_vm_value result = {0};
+    output diagnostics     = {0};
+
+    assert_true(run_integer("min") == INT64_MIN);
+    assert_true(run_integer("minDiv") == INT64_MIN);
+    assert_int_equal(run_integer("minMod"), 0);
+    assert_true(run_integer("wrap") == INT64_MIN);
+    assert_int_equal(run_integer("div"), -3);
+    assert_int_equal(run_integer("mod"), -1);
+
+    assert_true(run("decimalDiv", &result, &diagnostics));
+    assert_int_equal(result.type, WAITUI_VM_VALUE_TYPE_DECIMAL);
+    assert_true(result.as.decimal == 3.5);
+    free(diagnostics.data);
+
+    assert_run_fails("divZero", "ERROR: Main.divZero: division by zero");
+    assert_run_fails("modZero", "ERROR: Main.modZero: division by zero");
+}
+
+static void test_vm_thunk_forced_once(void **state) {
+    (void) state; /* unused */
+
+    // both reads of the lazy parameter give the value of the one evaluation
+    tickCount = 0;
+    assert_int_equal(run_integer("forcedOnce"), 2);
+    assert_int_equal(tickCount, 1);
+}
+
+static void test_vm_thunk_never_forced(void **state) {
+    (void) state; /* unused */
+
+    tickCount = 0;
+    assert_int_equal(run_integer("neverForced"), 0);
+    assert_int_equal(tickCount, 0);
+}
+
+static void test_vm_lazy_read_first(void **state) {
+    (void) state; /* unused */
+
+    // the lazy parameter is read first, so it is evaluated before y
+    tickCount = 0;
+    assert_int_equal(run_integer("readFirst"), 102);
+    assert_int_equal(tickCount, 2);
+}
+
+static void test_vm_thunk_captured_copy(void **state) {
+    (void) state; /* unused */
+
+    // the thunk assigns to its copy of a, the local of the caller keeps 1
+    assert_int_equal(run_integer("captured"), 41);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+            cmocka_unit_test(test_vm_calls),
+            cmocka_unit_test(test_vm_dispatch),
+            cmocka_unit_test(test_vm_super_call),
+            cmocka_unit_test(test_vm_short_circuit),
+            cmocka_unit_test(test_vm_if_and_while),
+            cmocka_unit_test(test_vm_arithmetic),
+            cmocka_unit_test(test_vm_thunk_forced_once),
+            cmocka_unit_test(test_vm_thunk_never_forced),
+            cmocka_unit_test(test_vm_lazy_read_first),
+            cmocka_unit_test(test_vm_thunk_captured_copy),
+    };
+
+    return cmocka_run_group_tests(tests, setup, teardown);
+}